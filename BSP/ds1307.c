@@ -9,358 +9,187 @@
 #include <stdint.h>
 #include <string.h>
 
-I2C_Handle_t rtcHandle;
-
-static void RTC_DS1307_I2C_PinConfig(void);
-static void RTC_DS1307_I2C_Config(void);
-static void RTC_DS1307_write(uint8_t data, uint8_t addr);
-static uint8_t RTC_DS1307_read(uint8_t addr);
-static uint8_t bintoBCD(uint8_t bin);
-static uint8_t BCDtobin(uint8_t BCD);
+static uint8_t RTC_DS1307_Init(RTC_Handle_t *pRTCHandle);
+static uint8_t RTC_DS1307_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+static uint8_t RTC_DS1307_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+static uint8_t RTC_DS1307_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate);
+static uint8_t RTC_DS1307_ReadNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len);
+static uint8_t RTC_DS1307_WriteNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len);
 
 /*
- * Helper functions
+ * DS1307 backend. No alarm, no temperature sensor
  */
-static void RTC_DS1307_I2C_PinConfig()
-{
-	GPIO_Handle_t sda, scl;
-	memset(&sda,0,sizeof(sda));
-	memset(&scl,0,sizeof(scl));
-
-	sda.pGPIOx = RTC_DS1307_I2C_PORT;
-	sda.GPIO_PinConfig.GPIO_PinNumber = RTC_DS1307_I2C_SDA;
-	sda.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
-	sda.GPIO_PinConfig.GPIO_PinAltFunMode = GPIO_ALTFN_AF4;
-	sda.GPIO_PinConfig.GPIO_PinPuPdControl = RTC_Ds1307_I2C_PUPD;
-	sda.GPIO_PinConfig.GPIO_PinSpeed = RTC_DS1307_I2C_PIN_SPEED;
-	sda.GPIO_PinConfig.GPIO_PinOPType = GPIO_OUT_TYPE_OD;
-
-	GPIO_Init(&sda);
-
-	scl.pGPIOx = RTC_DS1307_I2C_PORT;
-	scl.GPIO_PinConfig.GPIO_PinNumber = RTC_DS1307_I2C_SCL;
-	scl.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
-	scl.GPIO_PinConfig.GPIO_PinAltFunMode = GPIO_ALTFN_AF4;
-	scl.GPIO_PinConfig.GPIO_PinSpeed = RTC_DS1307_I2C_PIN_SPEED;
-	scl.GPIO_PinConfig.GPIO_PinOPType = GPIO_OUT_TYPE_OD;
-	scl.GPIO_PinConfig.GPIO_PinPuPdControl = RTC_Ds1307_I2C_PUPD;
-
-	GPIO_Init(&scl);
-}
-
-static void RTC_DS1307_I2C_Config()
-{
-	rtcHandle.pI2Cx = RTC_DS1307_I2C;
-	rtcHandle.I2C_Config.I2C_ACKControl = I2C_ACKCTRL_ACK_EN;
-	rtcHandle.I2C_Config.I2C_DeviceAddress = RTC_DS1307_SLAVE_ADDR;
-	rtcHandle.I2C_Config.I2C_SCLSpeed = RTC_DS1307_I2C_SPEED;
-
-	I2C_Init(&rtcHandle);
-}
-
-/*
- * Initialize the RTC module
- */
-/*********************************************************************
- * @fn      		  - RTC_DS1307_Init
- *
- * @brief             -
- *
- * @param[in]         -
- *
- * @return            - if it returns 1 -> init failed (as CH bit is 1)
- * 					  -	if it returns 0 -> init succeess (as CH bit is 0)
- *
- * @Note              -  none
-
- *********************************************************************/
-uint8_t RTC_DS1307_Init(void)
+const RTC_Ops_t RTC_DS1307_Ops =
 {
-	// 1. Iniitialize the GPIO pins for I2C
-	RTC_DS1307_I2C_PinConfig();
-
-	// 2. Initialize the I2C pins
-	RTC_DS1307_I2C_Config();
+	.Type				= RTC_TYPE_DS1307,
+	.SlaveAddr			= RTC_DS1307_SLAVE_ADDR,
+	.NVRAMSize			= RTC_DS1307_RAM_SIZE,
+	.NumAlarms			= 0,
+	.NumRegs			= RTC_DS1307_RAM_START + RTC_DS1307_RAM_SIZE,
+	.Volatile			= {0x0000007F, 0},				/* 00h-06h time and calendar */
+	.pfnInit			= RTC_DS1307_Init,
+	.pfnGetDateTime		= RTC_DS1307_GetDateTime,
+	.pfnSetDateTime		= RTC_DS1307_SetDateTime,
+	.pfnSetAlarm		= NULL,
+	.pfnCheckAlarm		= NULL,
+	.pfnSetSquareWave	= RTC_DS1307_SetSquareWave,
+	.pfnReadNVRAM		= RTC_DS1307_ReadNVRAM,
+	.pfnWriteNVRAM		= RTC_DS1307_WriteNVRAM,
+	.pfnGetTemperature	= NULL,
+};
 
-	// 3. Enable the I2C peripheral
-	I2C_PeripheralControl(RTC_DS1307_I2C, ENABLE);
-
-	// 4. By default, the CH pin is set to 1. To start the clock, we should make CH = 0
-	RTC_DS1307_write(0x00,RTC_DS1307_REG_SECONDS);
-
-	// 5. Read back clock halt bit to confirm if it is really set to 0
-	uint8_t clockState = RTC_DS1307_read(RTC_DS1307_REG_SECONDS);
-
-	return ((clockState >> 7) & 0x1);
-
-}
-
-/*
- * set and get Time
- */
 /*********************************************************************
- * @fn      		  - RTC_DS1307_setTime
+ * @fn      		  - RTC_DS1307_EncodeHours
  *
- * @brief             -
+ * @brief             - Encodes the hours of a time in the 02h register layout
  *
- * @param[in]         -
+ * @param[in]         - time in any of the three time formats
  *
- * @return            -  none
+ * @return            -  register value
  *
- * @Note              -  none
+ * @Note              -  bit 6 selects 12 hour mode, bit 5 is then PM
 
  *********************************************************************/
-void RTC_DS1307_setTime(RTC_Handle_time_t *timeHandle)
+uint8_t RTC_DS1307_EncodeHours(RTC_Handle_time_t *pTime)
 {
-	// Set the seconds
-	uint8_t secondBCD = bintoBCD(timeHandle->seconds);
-
-	// set the minutes
-	uint8_t minuteBCD = bintoBCD(timeHandle->minutes);
+	uint8_t temp;
 
-	// set the hours
-	uint8_t hourBCD = bintoBCD(timeHandle->hours);
-	uint8_t temp = 0;
-
-	RTC_DS1307_write(secondBCD & 0x7F, RTC_DS1307_REG_SECONDS);
-
-	RTC_DS1307_write(minuteBCD, RTC_DS1307_REG_MINUTES);
-
-	if(timeHandle->timeFormat == RTC_DS1307_TIME_FORMAT_24HRS)
+	if(pTime->timeFormat == RTC_TIME_FORMAT_24HRS)
 	{
-		temp = 0 << 6; // resetting the bit 6 to make is 24 hour
-		temp |= ((hourBCD/10) << 4);
-		temp |= hourBCD%10;
+		temp = RTC_BintoBCD(pTime->hours);
 	}
 	else
 	{
-		temp = 1 << 6; // setting the bit 6 to make is 12 hour
-		if(timeHandle->timeFormat == RTC_DS1307_TIME_FORMAT_12HRS_PM) // setting/resetting the 5th bit based on AM PM
-		{
-			temp |= 1 << 5;
-		}
-		else
-		{
-			temp &= ~(1 << 5);
-		}
-		temp |= ((hourBCD/10) << 4);
-		temp |= (hourBCD%10);
+		temp = (1 << RTC_DS1307_REG_HOURS_12_24) | RTC_BintoBCD(pTime->hours);
+		if(pTime->timeFormat == RTC_TIME_FORMAT_12HRS_PM)
+			temp |= (1 << RTC_DS1307_REG_HOURS_AMPM_10HOUR);
 	}
-	RTC_DS1307_write(temp,RTC_DS1307_REG_HOURS);
+
+	return temp;
 }
 
 /*********************************************************************
- * @fn      		  - RTC_DS1307_getTime
+ * @fn      		  - RTC_DS1307_DecodeHours
  *
- * @brief             -
+ * @brief             - Decodes the 02h register into hours and time format
  *
- * @param[in]         -
+ * @param[in]         - register value
+ * @param[out]        - time (hours and timeFormat are written)
  *
  * @return            -  none
  *
  * @Note              -  none
 
  *********************************************************************/
-void RTC_DS1307_getTime(RTC_Handle_time_t *timeHandle)
+void RTC_DS1307_DecodeHours(uint8_t value, RTC_Handle_time_t *pTime)
 {
-	uint8_t value;
-
-	// fetch seconds data
-	value = RTC_DS1307_read(RTC_DS1307_REG_SECONDS);
-	// clear the CH bit as it is not relevant to us when we fetch the seconds value
-	value &= ~(1 << RTC_DS1307_REG_SECONDS_CH);
-
-	timeHandle->seconds = BCDtobin(value);
-
-	// fetch minutes data
-	value = RTC_DS1307_read(RTC_DS1307_REG_MINUTES);
-	timeHandle->minutes = BCDtobin(value);
-
-	//fetch hours data
-	value = RTC_DS1307_read(RTC_DS1307_REG_HOURS);
-	// check if 6th bit is set.
-	if(value & (1 << 6)) // if bit 6 is set, then its 12 hour clock
+	if(value & (1 << RTC_DS1307_REG_HOURS_12_24))
 	{
-		if(value  & (1 << 5)) // if bit 5 is set, then it is PM
-		{
-			timeHandle->timeFormat = RTC_DS1307_TIME_FORMAT_12HRS_PM;
-		}
-		else
-		{
-			timeHandle->timeFormat = RTC_DS1307_TIME_FORMAT_12HRS_AM;
-		}
+		pTime->timeFormat = (value & (1 << RTC_DS1307_REG_HOURS_AMPM_10HOUR)) ?
+				RTC_TIME_FORMAT_12HRS_PM : RTC_TIME_FORMAT_12HRS_AM;
 		// get rid of bit 6 and bit 5 and fetch the hours data
 		value &= ~(0x3 << RTC_DS1307_REG_HOURS_AMPM_10HOUR);
 	}
 	else
 	{
-		timeHandle->timeFormat = RTC_DS1307_TIME_FORMAT_24HRS;
-		// get rid of bit 6 and fetch the hours data
+		pTime->timeFormat = RTC_TIME_FORMAT_24HRS;
 		value &= ~(1 << RTC_DS1307_REG_HOURS_12_24);
 	}
-	timeHandle->hours = BCDtobin(value);
+
+	pTime->hours = RTC_BCDtoBin(value);
 }
 
 /*
- * set and get Full Date
+ * Backend operations (called through RTC_DS1307_Ops)
  */
-/*********************************************************************
- * @fn      		  - RTC_DS1307_setFullDate
- *
- * @brief             -
- *
- * @param[in]         -
- *
- * @return            -  none
- *
- * @Note              -  none
-
- *********************************************************************/
-void RTC_DS1307_setFullDate(RTC_Handle_date_t *dateHandle)
-{
-	RTC_DS1307_write(dateHandle->date, RTC_DS1307_REG_DATE);
-
-	RTC_DS1307_write(dateHandle->month, RTC_DS1307_REG_MONTH);
-
-	RTC_DS1307_write(dateHandle->year, RTC_DS1307_REG_YEAR);
-
-	RTC_DS1307_write(dateHandle->day, RTC_DS1307_REG_DAY);
-}
-
-/*********************************************************************
- * @fn      		  - RTC_DS1307_getFullDate
- *
- * @brief             -
- *
- * @param[in]         -
- *
- * @return            -  none
- *
- * @Note              -  none
-
- *********************************************************************/
-void RTC_DS1307_getFullDate(RTC_Handle_date_t *dateHandle)
+static uint8_t RTC_DS1307_Init(RTC_Handle_t *pRTCHandle)
 {
 	uint8_t value;
 
-	// Fetch the day
-	value = RTC_DS1307_read(RTC_DS1307_REG_DAY);
-	dateHandle->day = value;
-
-	// fetch the date
-	value = RTC_DS1307_read(RTC_DS1307_REG_DATE);
-	dateHandle->date = BCDtobin(value);
+	pRTCHandle->Control = RTC_DS1307_SQW_OFF;
 
-	// fetch the month
-	value = RTC_DS1307_read(RTC_DS1307_REG_MONTH);
-	dateHandle->month = BCDtobin(value);
+	// 1. A running oscillator (CH = 0) kept the time on battery, nothing to write
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS1307_REG_SECONDS, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+	if(!(value & (1 << RTC_DS1307_REG_SECONDS_CH)))
+		return RTC_OK;
 
-	// fetch the date
-	value = RTC_DS1307_read(RTC_DS1307_REG_YEAR);
-	dateHandle->year = BCDtobin(value);
+	// 2. CH is set on first power (or after the clock was halted). Start the clock, keep the seconds
+	pRTCHandle->TimeLost = 1;
+	value &= ~(1 << RTC_DS1307_REG_SECONDS_CH);
+	if(RTC_WriteRegs(pRTCHandle, RTC_DS1307_REG_SECONDS, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
 
+	// 3. Read back clock halt bit to confirm if it is really set to 0
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS1307_REG_SECONDS, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
 
+	return (value & (1 << RTC_DS1307_REG_SECONDS_CH)) ? RTC_ERR_NODEV : RTC_OK;
 }
 
-/*********************************************************************
- * @fn      		  - RTC_DS1307_read
- *
- * @brief             -
- *
- * @param[in]         -
- *
- * @return            -  none
- *
- * @Note              -  none
-
- *********************************************************************/
-uint8_t RTC_DS1307_read(uint8_t addr)
+static uint8_t RTC_DS1307_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
 {
-	/* slave will start sending the data from where an address pointer is pointing to
-	 * Therefore, we should first put initialize a pointer to the position from which we want to read (before we perform the read)
-	 */
+	uint8_t regs[7];
 
-	uint8_t data;
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS1307_REG_SECONDS, regs, sizeof(regs)) != RTC_OK)
+		return RTC_ERR_BUS;
 
-	// 1. Data write to set the pointer to the address from which we want to read
-	I2C_MasterSendData(&rtcHandle, &addr, 1, RTC_DS1307_SLAVE_ADDR, 0);
+	// the CH bit is not relevant to us when we fetch the seconds value
+	pTime->seconds = RTC_BCDtoBin(regs[0] & ~(1 << RTC_DS1307_REG_SECONDS_CH));
+	pTime->minutes = RTC_BCDtoBin(regs[1]);
+	RTC_DS1307_DecodeHours(regs[2], pTime);
 
-	// 2. Now we read from the data in the address held in addr and store in the variable data
-	I2C_MasterReceiveData(&rtcHandle, &data, 1, RTC_DS1307_SLAVE_ADDR, 0);
+	pDate->day = regs[3];
+	pDate->date = RTC_BCDtoBin(regs[4]);
+	pDate->month = RTC_BCDtoBin(regs[5]);
+	pDate->year = RTC_BCDtoBin(regs[6]);
 
-	return data;
+	return RTC_OK;
 }
 
-/*********************************************************************
- * @fn      		  - RTC_DS1307_write
- *
- * @brief             -
- *
- * @param[in]         -
- *
- * @return            -  none
- *
- * @Note              -  none
-
- *********************************************************************/
-void RTC_DS1307_write(uint8_t data, uint8_t addr)
+static uint8_t RTC_DS1307_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
 {
-	uint8_t tx[2];
-	tx[0] = addr;
-	tx[1] = data;
-
-	I2C_MasterSendData(&rtcHandle, tx, 2, RTC_DS1307_SLAVE_ADDR, 0);
+	uint8_t regs[7];
+
+	// CH = 0 keeps the oscillator running
+	regs[0] = RTC_BintoBCD(pTime->seconds) & 0x7F;
+	regs[1] = RTC_BintoBCD(pTime->minutes);
+	regs[2] = RTC_DS1307_EncodeHours(pTime);
+	regs[3] = pDate->day;
+	regs[4] = RTC_BintoBCD(pDate->date);
+	regs[5] = RTC_BintoBCD(pDate->month);
+	regs[6] = RTC_BintoBCD(pDate->year);
+
+	return RTC_WriteRegs(pRTCHandle, RTC_DS1307_REG_SECONDS, regs, sizeof(regs));
 }
 
-/*
- * Covert Decimal to BCD and vice versa
- */
-/*********************************************************************
- * @fn      		  - BCDtobin
- *
- * @brief             - This function converts BCD value to binary
- *
- * @param[in]         -
- *
- * @return            -  none
- *
- * @Note              -  none
-
- *********************************************************************/
-static uint8_t BCDtobin(uint8_t BCD)
+static uint8_t RTC_DS1307_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate)
 {
-	uint8_t A0,A1;
+	uint8_t control;
 
-	A1 = (uint8_t)((BCD >> 4)*10);
-	A0 = (BCD & (uint8_t)0x0F);
-	return (A1+A0);
-}
-
-/*********************************************************************
- * @fn      		  - bintoBCD
- *
- * @brief             - This function converts Binary to BCD
- *
- * @param[in]         -
- *
- * @return            -  none
- *
- * @Note              -  none
+	switch(Rate)
+	{
+	case RTC_SQW_OFF:		control = RTC_DS1307_SQW_OFF;		break;
+	case RTC_SQW_1HZ:		control = RTC_DS1307_SQW_1HZ;		break;
+	case RTC_SQW_4096HZ:	control = RTC_DS1307_SQW_4096HZ;	break;
+	case RTC_SQW_8192HZ:	control = RTC_DS1307_SQW_8192HZ;	break;
+	case RTC_SQW_32768HZ:	control = RTC_DS1307_SQW_32768HZ;	break;
+	default:				return RTC_ERR_NOTSUP;
+	}
 
- *********************************************************************/
-static uint8_t bintoBCD(uint8_t bin)
-{
-	uint8_t bcd;
-	uint8_t A0,A1;
+	if(RTC_WriteRegs(pRTCHandle, RTC_DS1307_REG_CONTROL, &control, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+	pRTCHandle->Control = control;
 
-	bcd = bin;
-	if(bin > 9)
-	{
-		A1 = bin/10; // gives the digit in tens place
-		A0 = bin%10; // gives the digit in ones place
+	return RTC_OK;
+}
 
-		bcd = (A1 << 4) | A0; //shift the tens digit by 4 digits and add the ones digit if the first 4 bits
-	}
+static uint8_t RTC_DS1307_ReadNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len)
+{
+	return RTC_ReadRegs(pRTCHandle, RTC_DS1307_RAM_START + Offset, pBuf, Len);
+}
 
-	return bcd;
+static uint8_t RTC_DS1307_WriteNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len)
+{
+	return RTC_WriteRegs(pRTCHandle, RTC_DS1307_RAM_START + Offset, pBuf, Len);
 }
@@ -20,6 +20,8 @@
  * 	- RAM registers are located in address locations 08h to 3Fh
  * 	- Contents of the time and calendar registers are in BCD Format
  * 	- When CH (Clock Halt) bit is set to 1, oscillator is disabled. When reset to 0, oscillator is enabled
+ * 	- CH is set on first application of power. Init only clears it (keeping the seconds) when it is set
+ * 	  and then reports the time as lost, a clock running on battery is not written at all
  * 	- On first application of power, date and time are reset to 01/01/00 01 00:00:00 (MM/DD/YY DOW HH:MM:SS) (DOW -> Day of Week)
  * 	- Bit 6 of hours register is defined as the 12 hour or 24 hour mode select bit. When HIGH->12 hour mode select.
  * 	- In 12 hour mode, bit 5 is the AM/PM bit with Logic HIGH being PM
@@ -29,6 +31,10 @@
  * 		- Slave Receiver mode (write mode for Master)
  * 		- Slave Transmitter mode (read mode for Master)
  * 	- DS1307 SLAVE ADDRESS = 0b1101000 => 0x68
+ * 	- This file is the DS1307 backend of the RTC interface (rtc.h). The application uses the RTC_xxx APIs,
+ * 	  RTC_Init() selects this backend when 0x68 answers and 12h behaves like RAM
+ * 	- Time and date are read and written as one 7 byte burst from 00h, the DS1307 latches all of them at
+ * 	  the START condition, so a burst can not tear across a seconds update
  */
 
 /************************************************************************************
@@ -95,21 +101,7 @@
 #ifndef DS1307_H_
 #define DS1307_H_
 
-#include "stm32f407xx.h"
-
-/*
- * Application Configuration
- * I2C peripheral - I2C1
- * I2C1 SCL - PB6
- * I2C1 CDA - PB7
- */
-#define RTC_DS1307_I2C				I2C1
-#define RTC_DS1307_I2C_SPEED		I2C_SCL_SPEED_SM_KHZ
-#define RTC_DS1307_I2C_PORT			GPIOB
-#define RTC_DS1307_I2C_SCL			GPIO_PIN_6
-#define RTC_DS1307_I2C_SDA			GPIO_PIN_7
-#define RTC_DS1307_I2C_PIN_SPEED	GPIO_OUT_SPEED_LOW
-#define RTC_Ds1307_I2C_PUPD			GPIO_PUPD_PULLUP
+#include "rtc.h"
 
 /*
  * RTC Module Slave Address
@@ -128,35 +120,8 @@
 #define RTC_DS1307_REG_YEAR			0x06
 #define RTC_DS1307_REG_CONTROL		0x07
 #define RTC_DS1307_RAM_START		0x08
-
-/*
- * Day macros
- */
-#define SUNDAY		1
-#define MONDAY		2
-#define TUESDAY		3
-#define WEDNESDAY	4
-#define THURSDAY	5
-#define FRIDAY		6
-#define SATURDAY	7
-
-/*
- * Data Structure to handle the information
- */
-
-typedef struct{
-	uint8_t seconds;
-	uint8_t minutes;
-	uint8_t hours;
-	uint8_t timeFormat;
-}RTC_Handle_time_t;
-
-typedef struct{
-	uint8_t date;
-	uint8_t month;
-	uint8_t year;
-	uint8_t day;
-}RTC_Handle_date_t;
+#define RTC_DS1307_RAM_SIZE			56
+#define RTC_DS1307_PROBE_NVRAM		(0x12 - RTC_DS1307_RAM_START)		/* NVRAM byte the RTC_Init probe writes and restores */
 
 /*
  * RTC_DS1307_REG_SECONDS Macros
@@ -211,45 +176,19 @@ typedef struct{
 #define RTC_DS1307_REG_CONTROLOUT				7
 
 /*
- * Time format options
- */
-#define RTC_DS1307_TIME_FORMAT_12HRS_AM			0
-#define RTC_DS1307_TIME_FORMAT_12HRS_PM			1
-#define RTC_DS1307_TIME_FORMAT_24HRS			2
-
-/*
- * API protocols
- */
-
-/*
- * Mini Notes
- * We need the following functionalities from the RTC module
- * 1. set the Seconds
- * 2. set the Minutes
- * 3. set the Hours
- * 4. Or we can have an API which can collectively set HH:MM:SS (set Time)
- * 5. set Date
- * 6. set Month
- * 7. set Year
- * 8. Or we can have an API which can collectively set DD-MM-YY (set Dates)
- */
-
-/*
- * Initialize the RTC module
- */
-uint8_t RTC_DS1307_Init(void);
-
-/*
- * set and get Time
+ * Square wave output options (written as is to the control register)
  */
-void RTC_DS1307_setTime(RTC_Handle_time_t *timeHandle);
-void RTC_DS1307_getTime(RTC_Handle_time_t *timeHandle);
+#define RTC_DS1307_SQW_OFF						0x00
+#define RTC_DS1307_SQW_1HZ						0x10
+#define RTC_DS1307_SQW_4096HZ					0x11
+#define RTC_DS1307_SQW_8192HZ					0x12
+#define RTC_DS1307_SQW_32768HZ					0x13
 
 /*
- * set and get Full Date
+ * Hours register encoding, shared with the DS3231 (same layout at 02h)
  */
-void RTC_DS1307_setFullDate(RTC_Handle_date_t *dateHandle);
-void RTC_DS1307_getFullDate(RTC_Handle_date_t *dateHandle);
+uint8_t RTC_DS1307_EncodeHours(RTC_Handle_time_t *pTime);
+void RTC_DS1307_DecodeHours(uint8_t value, RTC_Handle_time_t *pTime);
 
 
 #endif /* DS1307_H_ */
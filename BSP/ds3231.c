@@ -0,0 +1,180 @@
+/*
+ * ds3231.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "ds3231.h"
+#include "ds1307.h"
+
+static uint8_t RTC_DS3231_Init(RTC_Handle_t *pRTCHandle);
+static uint8_t RTC_DS3231_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+static uint8_t RTC_DS3231_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+static uint8_t RTC_DS3231_SetAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm);
+static uint8_t RTC_DS3231_CheckAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx);
+static uint8_t RTC_DS3231_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate);
+static uint8_t RTC_DS3231_GetTemperature(RTC_Handle_t *pRTCHandle, int16_t *pQuarterDegC);
+
+/*
+ * DS3231 backend. Two alarms, temperature sensor, no NVRAM
+ */
+const RTC_Ops_t RTC_DS3231_Ops =
+{
+	.Type				= RTC_TYPE_DS3231,
+	.SlaveAddr			= RTC_DS3231_SLAVE_ADDR,
+	.NVRAMSize			= 0,
+	.NumAlarms			= 2,
+	.NumRegs			= RTC_DS3231_REG_TEMP_LSB + 1,
+	.Volatile			= {0x0006807F, 0},				/* 00h-06h time and calendar, 0Fh status, 11h-12h temperature */
+	.pfnInit			= RTC_DS3231_Init,
+	.pfnGetDateTime		= RTC_DS3231_GetDateTime,
+	.pfnSetDateTime		= RTC_DS3231_SetDateTime,
+	.pfnSetAlarm		= RTC_DS3231_SetAlarm,
+	.pfnCheckAlarm		= RTC_DS3231_CheckAlarm,
+	.pfnSetSquareWave	= RTC_DS3231_SetSquareWave,
+	.pfnReadNVRAM		= NULL,
+	.pfnWriteNVRAM		= NULL,
+	.pfnGetTemperature	= RTC_DS3231_GetTemperature,
+};
+
+/*
+ * Backend operations (called through RTC_DS3231_Ops)
+ */
+static uint8_t RTC_DS3231_Init(RTC_Handle_t *pRTCHandle)
+{
+	uint8_t value;
+
+	// OSF is set when the oscillator stopped (first power, battery loss), the time is not valid
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_STATUS, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+	pRTCHandle->TimeLost = (value >> RTC_DS3231_REG_STATUS_OSF) & 1;
+
+	// 1. Start the oscillator (EOSC = 0 runs it on battery too)
+	if((RTC_UpdateReg(pRTCHandle, RTC_DS3231_REG_CONTROL, (1 << RTC_DS3231_REG_CONTROL_EOSC), 0) != RTC_OK) ||
+	   (RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_CONTROL, &pRTCHandle->Control, 1) != RTC_OK))
+		return RTC_ERR_BUS;
+
+	// 2. Clear the oscillator stop flag
+	if(RTC_UpdateReg(pRTCHandle, RTC_DS3231_REG_STATUS, (1 << RTC_DS3231_REG_STATUS_OSF), 0) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	// 3. Read back the flag to confirm the oscillator is running
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_STATUS, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	return (value & (1 << RTC_DS3231_REG_STATUS_OSF)) ? RTC_ERR_NODEV : RTC_OK;
+}
+
+static uint8_t RTC_DS3231_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	uint8_t regs[7];
+
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_SECONDS, regs, sizeof(regs)) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	pTime->seconds = RTC_BCDtoBin(regs[0] & 0x7F);
+	pTime->minutes = RTC_BCDtoBin(regs[1] & 0x7F);
+	RTC_DS1307_DecodeHours(regs[2], pTime);
+
+	pDate->day = regs[3] & 0x07;
+	pDate->date = RTC_BCDtoBin(regs[4] & 0x3F);
+	pDate->month = RTC_BCDtoBin(regs[5] & ~(1 << RTC_DS3231_REG_MONTH_CENTURY));
+	pDate->year = RTC_BCDtoBin(regs[6]);
+
+	return RTC_OK;
+}
+
+static uint8_t RTC_DS3231_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	uint8_t regs[7];
+
+	regs[0] = RTC_BintoBCD(pTime->seconds);
+	regs[1] = RTC_BintoBCD(pTime->minutes);
+	regs[2] = RTC_DS1307_EncodeHours(pTime);
+	regs[3] = pDate->day;
+	regs[4] = RTC_BintoBCD(pDate->date);
+	regs[5] = RTC_BintoBCD(pDate->month);
+	regs[6] = RTC_BintoBCD(pDate->year);
+
+	return RTC_WriteRegs(pRTCHandle, RTC_DS3231_REG_SECONDS, regs, sizeof(regs));
+}
+
+static uint8_t RTC_DS3231_SetAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm)
+{
+	uint8_t regs[4];
+	uint8_t len = 0;
+	RTC_Handle_time_t time;
+
+	if((pAlarm->seconds > 59) || (pAlarm->minutes > 59) || (pAlarm->hours > 23) || (pAlarm->date > 31))
+		return RTC_ERR_PARAM;
+
+	// alarm 2 has no seconds register, it matches at 00 seconds
+	if(AlarmIdx == 0)
+		regs[len++] = RTC_BintoBCD(pAlarm->seconds);
+	else if(pAlarm->seconds != 0)
+		return RTC_ERR_PARAM;
+
+	time.hours = pAlarm->hours;
+	time.timeFormat = RTC_TIME_FORMAT_24HRS;
+
+	regs[len++] = RTC_BintoBCD(pAlarm->minutes);
+	regs[len++] = RTC_DS1307_EncodeHours(&time);
+	// DY/DT = 0 -> match the date. AxM4 = 1 -> date is ignored (once per day)
+	regs[len++] = pAlarm->date ? RTC_BintoBCD(pAlarm->date) : (1 << RTC_DS3231_REG_ALARM_AxMx);
+
+	if(RTC_WriteRegs(pRTCHandle, (AlarmIdx == 0) ? RTC_DS3231_REG_ALARM1 : RTC_DS3231_REG_ALARM2, regs, len) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	// clear a flag left over from the previous alarm
+	return RTC_UpdateReg(pRTCHandle, RTC_DS3231_REG_STATUS, (1 << (RTC_DS3231_REG_STATUS_A1F + AlarmIdx)), 0);
+}
+
+static uint8_t RTC_DS3231_CheckAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx)
+{
+	uint8_t status;
+	uint8_t flag = 1 << (RTC_DS3231_REG_STATUS_A1F + AlarmIdx);
+
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_STATUS, &status, 1) != RTC_OK)
+		return 0;
+	if(!(status & flag))
+		return 0;
+
+	// not cleared -> reported again at the next check
+	status &= ~flag;
+	return (RTC_WriteRegs(pRTCHandle, RTC_DS3231_REG_STATUS, &status, 1) == RTC_OK);
+}
+
+static uint8_t RTC_DS3231_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate)
+{
+	uint8_t control = 0;
+
+	switch(Rate)
+	{
+	// INTCN = 1 turns the square wave off (INT/SQW idles high)
+	case RTC_SQW_OFF:		control |= (1 << RTC_DS3231_REG_CONTROL_INTCN);	break;
+	case RTC_SQW_1HZ:		control |= (0 << RTC_DS3231_REG_CONTROL_RS);		break;
+	case RTC_SQW_1024HZ:	control |= (1 << RTC_DS3231_REG_CONTROL_RS);		break;
+	case RTC_SQW_4096HZ:	control |= (2 << RTC_DS3231_REG_CONTROL_RS);		break;
+	case RTC_SQW_8192HZ:	control |= (3 << RTC_DS3231_REG_CONTROL_RS);		break;
+	default:				return RTC_ERR_NOTSUP;
+	}
+
+	if(RTC_UpdateReg(pRTCHandle, RTC_DS3231_REG_CONTROL, (0x3 << RTC_DS3231_REG_CONTROL_RS) | (1 << RTC_DS3231_REG_CONTROL_INTCN), control) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	return RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_CONTROL, &pRTCHandle->Control, 1);
+}
+
+static uint8_t RTC_DS3231_GetTemperature(RTC_Handle_t *pRTCHandle, int16_t *pQuarterDegC)
+{
+	uint8_t regs[2];
+
+	if(RTC_ReadRegs(pRTCHandle, RTC_DS3231_REG_TEMP_MSB, regs, sizeof(regs)) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	// MSB is the signed integer part, the top two bits of the LSB are the quarters
+	*pQuarterDegC = (int16_t)(((int8_t)regs[0] * 4) | (regs[1] >> 6));
+
+	return RTC_OK;
+}
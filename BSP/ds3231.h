@@ -0,0 +1,95 @@
+/*
+ * ds3231.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- DS3231 backend of the RTC interface (rtc.h). RTC_Init() selects it when 0x68 answers and 12h does
+ * 	  not behave like RAM (12h is the read only temperature LSB, bits 5:0 always read 0)
+ * 	- Time and calendar registers 00h to 06h have the DS1307 layout (BCD, same hours register). Bit 7 of
+ * 	  the month register is the century bit, it is ignored (year range 2000-2099)
+ * 	- The oscillator is started by clearing EOSC (control) and the OSF flag (status). OSF set at init
+ * 	  reports the time as lost
+ * 	- INT/SQW is either the square wave (INTCN = 0) or the alarm interrupt (INTCN = 1). The interface keeps
+ * 	  the square wave, alarms are polled through their flags (A1F/A2F are set regardless of A1IE/A2IE)
+ * 	- Alarm 1 matches seconds, minutes, hours (and date). Alarm 2 has no seconds register, it matches at
+ * 	  00 seconds, so RTC_Alarm_t.seconds must be 0
+ * 	- 32768Hz is on the separate 32kHz pin, so RTC_SQW_32768HZ is not supported on INT/SQW
+ * 	- The temperature is a 10 bit two's complement value in 0.25C steps, updated every 64 seconds
+ * 	- No NVRAM
+ */
+
+/*
+ * Register map
+ * ADDRESS	BIT7	BIT6	BIT5	BIT4	BIT3	BIT2	BIT1	BIT0	Function
+ * 00h-06h	same as the DS1307, 05h bit 7 is the century bit				Time and calendar
+ * 07h		A1M1	<----10 Seconds---->	<---------Seconds---------->	Alarm 1 seconds
+ * 08h		A1M2	<----10 Minutes---->	<---------Minutes---------->	Alarm 1 minutes
+ * 09h		A1M3	12/24	AM/PM	10hour	<----------Hour------------>	Alarm 1 hours
+ * 0Ah		A1M4	DY/DT	<-10 Date-->	<----------Date------------>	Alarm 1 day/date
+ * 0Bh-0Dh	same as 08h-0Ah with A2M2-A2M4									Alarm 2
+ * 0Eh		EOSC	BBSQW	CONV	RS2		RS1		INTCN	A2IE	A1IE	Control
+ * 0Fh		OSF		0		0		0		EN32kHz	BSY		A2F		A1F		Status
+ * 10h		Aging offset													Aging
+ * 11h		<--------------Temperature (integer part)------------------>	MSB of temperature
+ * 12h		<-Fraction->	0		0		0		0		0		0		LSB of temperature
+ */
+
+#ifndef DS3231_H_
+#define DS3231_H_
+
+#include "rtc.h"
+
+/*
+ * RTC Module Slave Address
+ */
+#define RTC_DS3231_SLAVE_ADDR		0x68
+
+/*
+ * Address macros
+ */
+#define RTC_DS3231_REG_SECONDS		0x00
+#define RTC_DS3231_REG_MONTH		0x05
+#define RTC_DS3231_REG_ALARM1		0x07
+#define RTC_DS3231_REG_ALARM2		0x0B
+#define RTC_DS3231_REG_CONTROL		0x0E
+#define RTC_DS3231_REG_STATUS		0x0F
+#define RTC_DS3231_REG_AGING		0x10
+#define RTC_DS3231_REG_TEMP_MSB		0x11
+#define RTC_DS3231_REG_TEMP_LSB		0x12
+
+/*
+ * RTC_DS3231_REG_MONTH Macros
+ */
+#define RTC_DS3231_REG_MONTH_CENTURY			7
+
+/*
+ * Alarm register Macros
+ */
+#define RTC_DS3231_REG_ALARM_AxMx				7
+#define RTC_DS3231_REG_ALARM_DYDT				6
+
+/*
+ * RTC_DS3231_REG_CONTROL Macros
+ */
+#define RTC_DS3231_REG_CONTROL_A1IE				0
+#define RTC_DS3231_REG_CONTROL_A2IE				1
+#define RTC_DS3231_REG_CONTROL_INTCN			2
+#define RTC_DS3231_REG_CONTROL_RS				3
+#define RTC_DS3231_REG_CONTROL_CONV				5
+#define RTC_DS3231_REG_CONTROL_BBSQW			6
+#define RTC_DS3231_REG_CONTROL_EOSC				7
+
+/*
+ * RTC_DS3231_REG_STATUS Macros
+ */
+#define RTC_DS3231_REG_STATUS_A1F				0
+#define RTC_DS3231_REG_STATUS_A2F				1
+#define RTC_DS3231_REG_STATUS_BSY				2
+#define RTC_DS3231_REG_STATUS_EN32KHZ			3
+#define RTC_DS3231_REG_STATUS_OSF				7
+
+#endif /* DS3231_H_ */
@@ -0,0 +1,160 @@
+/*
+ * pcf8563.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "pcf8563.h"
+
+static uint8_t RTC_PCF8563_Init(RTC_Handle_t *pRTCHandle);
+static uint8_t RTC_PCF8563_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+static uint8_t RTC_PCF8563_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+static uint8_t RTC_PCF8563_SetAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm);
+static uint8_t RTC_PCF8563_CheckAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx);
+static uint8_t RTC_PCF8563_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate);
+
+/*
+ * PCF8563 backend. One alarm, no NVRAM, no temperature sensor
+ */
+const RTC_Ops_t RTC_PCF8563_Ops =
+{
+	.Type				= RTC_TYPE_PCF8563,
+	.SlaveAddr			= RTC_PCF8563_SLAVE_ADDR,
+	.NVRAMSize			= 0,
+	.NumAlarms			= 1,
+	.NumRegs			= 0x10,
+	.Volatile			= {0x000081FE, 0},				/* 01h flags, 02h-08h time and calendar, 0Fh timer */
+	.pfnInit			= RTC_PCF8563_Init,
+	.pfnGetDateTime		= RTC_PCF8563_GetDateTime,
+	.pfnSetDateTime		= RTC_PCF8563_SetDateTime,
+	.pfnSetAlarm		= RTC_PCF8563_SetAlarm,
+	.pfnCheckAlarm		= RTC_PCF8563_CheckAlarm,
+	.pfnSetSquareWave	= RTC_PCF8563_SetSquareWave,
+	.pfnReadNVRAM		= NULL,
+	.pfnWriteNVRAM		= NULL,
+	.pfnGetTemperature	= NULL,
+};
+
+/*
+ * Backend operations (called through RTC_PCF8563_Ops)
+ */
+static uint8_t RTC_PCF8563_Init(RTC_Handle_t *pRTCHandle)
+{
+	uint8_t value;
+
+	// VL stays set till the time is written again
+	if(RTC_ReadRegs(pRTCHandle, RTC_PCF8563_REG_SECONDS, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+	pRTCHandle->TimeLost = (value >> RTC_PCF8563_REG_SECONDS_VL) & 1;
+
+	// STOP = 0 starts the clock, the test modes stay off
+	value = 0x00;
+	if(RTC_WriteRegs(pRTCHandle, RTC_PCF8563_REG_CONTROL1, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	// CLKOUT is on after power up, start with it off like the DS parts
+	if(RTC_WriteRegs(pRTCHandle, RTC_PCF8563_REG_CLKOUT, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+	pRTCHandle->Control = value;
+
+	if(RTC_ReadRegs(pRTCHandle, RTC_PCF8563_REG_CONTROL1, &value, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	return (value & (1 << RTC_PCF8563_REG_CONTROL1_STOP)) ? RTC_ERR_NODEV : RTC_OK;
+}
+
+static uint8_t RTC_PCF8563_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	uint8_t regs[7];
+
+	if(RTC_ReadRegs(pRTCHandle, RTC_PCF8563_REG_SECONDS, regs, sizeof(regs)) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	pTime->seconds = RTC_BCDtoBin(regs[0] & 0x7F);
+	pTime->minutes = RTC_BCDtoBin(regs[1] & 0x7F);
+	pTime->hours = RTC_BCDtoBin(regs[2] & 0x3F);
+	pTime->timeFormat = RTC_TIME_FORMAT_24HRS;
+
+	pDate->date = RTC_BCDtoBin(regs[3] & 0x3F);
+	pDate->day = (regs[4] & 0x07) + SUNDAY;
+	pDate->month = RTC_BCDtoBin(regs[5] & 0x1F);
+	pDate->year = RTC_BCDtoBin(regs[6]);
+
+	return RTC_OK;
+}
+
+static uint8_t RTC_PCF8563_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	uint8_t regs[7];
+
+	// VL = 0 marks the time as valid again
+	regs[0] = RTC_BintoBCD(pTime->seconds);
+	regs[1] = RTC_BintoBCD(pTime->minutes);
+	regs[2] = RTC_BintoBCD(RTC_To24Hours(pTime));
+	regs[3] = RTC_BintoBCD(pDate->date);
+	regs[4] = (pDate->day - SUNDAY) & 0x07;
+	regs[5] = RTC_BintoBCD(pDate->month);
+	regs[6] = RTC_BintoBCD(pDate->year);
+
+	return RTC_WriteRegs(pRTCHandle, RTC_PCF8563_REG_SECONDS, regs, sizeof(regs));
+}
+
+static uint8_t RTC_PCF8563_SetAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm)
+{
+	uint8_t regs[4];
+
+	(void)AlarmIdx;
+
+	// minute resolution only
+	if((pAlarm->seconds != 0) || (pAlarm->minutes > 59) || (pAlarm->hours > 23) || (pAlarm->date > 31))
+		return RTC_ERR_PARAM;
+
+	regs[0] = RTC_BintoBCD(pAlarm->minutes);
+	regs[1] = RTC_BintoBCD(pAlarm->hours);
+	regs[2] = pAlarm->date ? RTC_BintoBCD(pAlarm->date) : (1 << RTC_PCF8563_REG_ALARM_AE);
+	// weekday is never part of the match
+	regs[3] = (1 << RTC_PCF8563_REG_ALARM_AE);
+
+	if(RTC_WriteRegs(pRTCHandle, RTC_PCF8563_REG_ALARM, regs, sizeof(regs)) != RTC_OK)
+		return RTC_ERR_BUS;
+
+	// clear a flag left over from the previous alarm
+	return RTC_UpdateReg(pRTCHandle, RTC_PCF8563_REG_CONTROL2, (1 << RTC_PCF8563_REG_CONTROL2_AF), 0);
+}
+
+static uint8_t RTC_PCF8563_CheckAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx)
+{
+	uint8_t control2;
+
+	(void)AlarmIdx;
+
+	if(RTC_ReadRegs(pRTCHandle, RTC_PCF8563_REG_CONTROL2, &control2, 1) != RTC_OK)
+		return 0;
+	if(!(control2 & (1 << RTC_PCF8563_REG_CONTROL2_AF)))
+		return 0;
+
+	// AF is cleared by writing 0, TF is kept by writing 1 (writing 1 to a flag has no effect)
+	control2 = (control2 & ~(1 << RTC_PCF8563_REG_CONTROL2_AF)) | (1 << RTC_PCF8563_REG_CONTROL2_TF);
+	return (RTC_WriteRegs(pRTCHandle, RTC_PCF8563_REG_CONTROL2, &control2, 1) == RTC_OK);
+}
+
+static uint8_t RTC_PCF8563_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate)
+{
+	uint8_t clkout;
+
+	switch(Rate)
+	{
+	case RTC_SQW_OFF:		clkout = 0;	break;
+	case RTC_SQW_1HZ:		clkout = (1 << RTC_PCF8563_REG_CLKOUT_FE) | (RTC_PCF8563_CLKOUT_1HZ << RTC_PCF8563_REG_CLKOUT_FD);		break;
+	case RTC_SQW_1024HZ:	clkout = (1 << RTC_PCF8563_REG_CLKOUT_FE) | (RTC_PCF8563_CLKOUT_1024HZ << RTC_PCF8563_REG_CLKOUT_FD);	break;
+	case RTC_SQW_32768HZ:	clkout = (1 << RTC_PCF8563_REG_CLKOUT_FE) | (RTC_PCF8563_CLKOUT_32768HZ << RTC_PCF8563_REG_CLKOUT_FD);	break;
+	default:				return RTC_ERR_NOTSUP;
+	}
+
+	if(RTC_WriteRegs(pRTCHandle, RTC_PCF8563_REG_CLKOUT, &clkout, 1) != RTC_OK)
+		return RTC_ERR_BUS;
+	pRTCHandle->Control = clkout;
+
+	return RTC_OK;
+}
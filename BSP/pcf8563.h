@@ -0,0 +1,101 @@
+/*
+ * pcf8563.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- PCF8563 backend of the RTC interface (rtc.h). RTC_Init() selects it when 0x51 answers
+ * 	- Time and calendar registers 02h to 08h are BCD, 24 hour only. Times in 12 hour format are converted
+ * 	  on write, reads always return RTC_TIME_FORMAT_24HRS
+ * 	- The weekday register counts 0-6, the interface counts 1-7 (SUNDAY = 1)
+ * 	- The oscillator runs when STOP (control 1) is 0. VL (bit 7 of 02h) is set after a supply loss,
+ * 	  it is cleared by the next time write. VL set at init reports the time as lost
+ * 	- One alarm with minute resolution (it matches at 00 seconds, so RTC_Alarm_t.seconds must be 0).
+ * 	  Every field has its own AE bit, AE = 1 leaves the field out of the match
+ * 	- CLKOUT can output 32768, 1024, 32 and 1Hz. It is open drain, like SQW on the DS parts
+ * 	- No NVRAM, no temperature sensor
+ */
+
+/*
+ * Register map
+ * ADDRESS	BIT7	BIT6	BIT5	BIT4	BIT3	BIT2	BIT1	BIT0	Function
+ * 00h		TEST1	0		STOP	0		TESTC	0		0		0		Control 1
+ * 01h		0		0		0		TI/TP	AF		TF		AIE		TIE		Control 2
+ * 02h		VL		<----10 Seconds---->	<---------Seconds---------->	Seconds
+ * 03h		x		<----10 Minutes---->	<---------Minutes---------->	Minutes
+ * 04h		x		x		<-10 Hour-->	<----------Hours----------->	Hours (00-23)
+ * 05h		x		x		<-10 Day--->	<-----------Days----------->	Days (01-31)
+ * 06h		x		x		x		x		x		<----Weekday------->	Weekdays (0-6)
+ * 07h		C		x		x		10Mnth	<----------Month----------->	Century/Months
+ * 08h		<--------10 Year----------->	<-----------Year----------->	Years
+ * 09h-0Ch	AE		<------------same as 03h-06h------------------->	Minute/Hour/Day/Weekday alarm
+ * 0Dh		FE		x		x		x		x		x		FD1		FD0		CLKOUT control
+ * 0Eh-0Fh																	Timer
+ */
+
+#ifndef PCF8563_H_
+#define PCF8563_H_
+
+#include "rtc.h"
+
+/*
+ * RTC Module Slave Address
+ */
+#define RTC_PCF8563_SLAVE_ADDR		0x51
+
+/*
+ * Address macros
+ */
+#define RTC_PCF8563_REG_CONTROL1	0x00
+#define RTC_PCF8563_REG_CONTROL2	0x01
+#define RTC_PCF8563_REG_SECONDS		0x02
+#define RTC_PCF8563_REG_MONTHS		0x07
+#define RTC_PCF8563_REG_ALARM		0x09
+#define RTC_PCF8563_REG_CLKOUT		0x0D
+
+/*
+ * RTC_PCF8563_REG_CONTROL1 Macros
+ */
+#define RTC_PCF8563_REG_CONTROL1_STOP			5
+
+/*
+ * RTC_PCF8563_REG_CONTROL2 Macros
+ */
+#define RTC_PCF8563_REG_CONTROL2_TIE			0
+#define RTC_PCF8563_REG_CONTROL2_AIE			1
+#define RTC_PCF8563_REG_CONTROL2_TF				2
+#define RTC_PCF8563_REG_CONTROL2_AF				3
+
+/*
+ * RTC_PCF8563_REG_SECONDS Macros
+ */
+#define RTC_PCF8563_REG_SECONDS_VL				7
+
+/*
+ * RTC_PCF8563_REG_MONTHS Macros
+ */
+#define RTC_PCF8563_REG_MONTHS_C				7
+
+/*
+ * Alarm register Macros
+ */
+#define RTC_PCF8563_REG_ALARM_AE				7
+
+/*
+ * RTC_PCF8563_REG_CLKOUT Macros
+ */
+#define RTC_PCF8563_REG_CLKOUT_FD				0
+#define RTC_PCF8563_REG_CLKOUT_FE				7
+
+/*
+ * CLKOUT frequencies (FD)
+ */
+#define RTC_PCF8563_CLKOUT_32768HZ				0
+#define RTC_PCF8563_CLKOUT_1024HZ				1
+#define RTC_PCF8563_CLKOUT_32HZ					2
+#define RTC_PCF8563_CLKOUT_1HZ					3
+
+#endif /* PCF8563_H_ */
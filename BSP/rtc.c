@@ -0,0 +1,693 @@
+/*
+ * rtc.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "rtc.h"
+#include <string.h>
+
+#define RTC_MAX_BURST					16
+#define RTC_PROBE_REG					0x12		/* DS1307 RAM, DS3231 temperature LSB (bits 5:0 read 0) */
+
+static void RTC_I2C_PinConfig(RTC_Handle_t *pRTCHandle);
+static void RTC_I2C_Config(RTC_Handle_t *pRTCHandle);
+static const RTC_Ops_t* RTC_Probe(RTC_Handle_t *pRTCHandle);
+static void RTC_RegMapConfig(RTC_Handle_t *pRTCHandle);
+static uint8_t RTC_BusRead(void *pCtx, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+static uint8_t RTC_BusWrite(void *pCtx, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+
+/*
+ * Helper functions
+ */
+static void RTC_I2C_PinConfig(RTC_Handle_t *pRTCHandle)
+{
+	GPIO_Handle_t sda, scl;
+	memset(&sda,0,sizeof(sda));
+	memset(&scl,0,sizeof(scl));
+
+	sda.pGPIOx = pRTCHandle->RTC_Config.pSDAPort;
+	sda.GPIO_PinConfig.GPIO_PinNumber = pRTCHandle->RTC_Config.SDAPin;
+	sda.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	sda.GPIO_PinConfig.GPIO_PinAltFunMode = RTC_I2C_ALTFN;
+	sda.GPIO_PinConfig.GPIO_PinPuPdControl = RTC_I2C_PUPD;
+	sda.GPIO_PinConfig.GPIO_PinSpeed = RTC_I2C_PIN_SPEED;
+	sda.GPIO_PinConfig.GPIO_PinOPType = GPIO_OUT_TYPE_OD;
+
+	GPIO_Init(&sda);
+
+	scl.pGPIOx = pRTCHandle->RTC_Config.pSCLPort;
+	scl.GPIO_PinConfig.GPIO_PinNumber = pRTCHandle->RTC_Config.SCLPin;
+	scl.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	scl.GPIO_PinConfig.GPIO_PinAltFunMode = RTC_I2C_ALTFN;
+	scl.GPIO_PinConfig.GPIO_PinSpeed = RTC_I2C_PIN_SPEED;
+	scl.GPIO_PinConfig.GPIO_PinOPType = GPIO_OUT_TYPE_OD;
+	scl.GPIO_PinConfig.GPIO_PinPuPdControl = RTC_I2C_PUPD;
+
+	GPIO_Init(&scl);
+}
+
+static void RTC_I2C_Config(RTC_Handle_t *pRTCHandle)
+{
+	I2C_Handle_t *pI2CHandle = &pRTCHandle->I2C_Handle;
+
+	memset(pI2CHandle,0,sizeof(*pI2CHandle));
+
+	pI2CHandle->pI2Cx = pRTCHandle->RTC_Config.pI2Cx;
+	pI2CHandle->I2C_Config.I2C_ACKControl = I2C_ACKCTRL_ACK_EN;
+	pI2CHandle->I2C_Config.I2C_SCLSpeed = pRTCHandle->RTC_Config.I2C_SCLSpeed;
+
+	I2C_Init(pI2CHandle);
+}
+
+static uint8_t RTC_BusRead(void *pCtx, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	RTC_Handle_t *pRTCHandle = (RTC_Handle_t*)pCtx;
+	uint8_t addr = pRTCHandle->pOps ? pRTCHandle->pOps->SlaveAddr : RTC_DS1307_Ops.SlaveAddr;
+
+	// the register pointer is set with a write, then the part streams the registers
+	if(I2C_MasterSendData(&pRTCHandle->I2C_Handle, &Reg, 1, addr, I2C_NO_SR) != I2C_OK)
+		return RTC_ERR_BUS;
+	if(I2C_MasterReceiveData(&pRTCHandle->I2C_Handle, pBuf, Len, addr, I2C_NO_SR) != I2C_OK)
+		return RTC_ERR_BUS;
+
+	return RTC_OK;
+}
+
+static uint8_t RTC_BusWrite(void *pCtx, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	RTC_Handle_t *pRTCHandle = (RTC_Handle_t*)pCtx;
+	uint8_t addr = pRTCHandle->pOps ? pRTCHandle->pOps->SlaveAddr : RTC_DS1307_Ops.SlaveAddr;
+	uint8_t tx[RTC_MAX_BURST + 1];
+	uint8_t chunk;
+
+	while(Len)
+	{
+		chunk = (Len > RTC_MAX_BURST) ? RTC_MAX_BURST : Len;
+
+		tx[0] = Reg;
+		memcpy(&tx[1], pBuf, chunk);
+		if(I2C_MasterSendData(&pRTCHandle->I2C_Handle, tx, chunk + 1, addr, I2C_NO_SR) != I2C_OK)
+			return RTC_ERR_BUS;
+
+		Reg += chunk;
+		pBuf += chunk;
+		Len -= chunk;
+	}
+
+	return RTC_OK;
+}
+
+static void RTC_RegMapConfig(RTC_Handle_t *pRTCHandle)
+{
+	RegMap_Config_t *pConfig = &pRTCHandle->RegMap.RegMap_Config;
+
+	// write through, the parts are battery backed and the MCU may lose power at any time
+	pConfig->NumRegs = pRTCHandle->pOps->NumRegs;
+	pConfig->CacheMode = REGMAP_CACHE_WRITETHROUGH;
+	pConfig->MaxBurst = RTC_MAX_BURST;
+	memcpy(pConfig->Volatile, pRTCHandle->pOps->Volatile, sizeof(pConfig->Volatile));
+	pConfig->pfnRead = RTC_BusRead;
+	pConfig->pfnWrite = RTC_BusWrite;
+	pConfig->pCtx = pRTCHandle;
+
+	RegMap_Init(&pRTCHandle->RegMap);
+}
+
+static const RTC_Ops_t* RTC_Probe(RTC_Handle_t *pRTCHandle)
+{
+	uint8_t saved, test, readBack;
+
+	if(I2C_MasterProbe(&pRTCHandle->I2C_Handle, RTC_PCF8563_Ops.SlaveAddr))
+		return &RTC_PCF8563_Ops;
+
+	// DS1307 and DS3231 share 0x68
+	if(!I2C_MasterProbe(&pRTCHandle->I2C_Handle, RTC_DS1307_Ops.SlaveAddr))
+		return NULL;
+
+	// 12h is RAM on the DS1307 and the read only temperature LSB on the DS3231, whose bits 5:0 always read 0
+	// a part which answers its address but fails the transfers is not used
+	if(RTC_ReadRegs(pRTCHandle, RTC_PROBE_REG, &saved, 1) != RTC_OK)
+		return NULL;
+	test = saved ^ 0x3F;
+	if((RTC_WriteRegs(pRTCHandle, RTC_PROBE_REG, &test, 1) != RTC_OK) ||
+	   (RTC_ReadRegs(pRTCHandle, RTC_PROBE_REG, &readBack, 1) != RTC_OK))
+		return NULL;
+
+	if(readBack == test)
+	{
+		// restore the RAM byte
+		RTC_WriteRegs(pRTCHandle, RTC_PROBE_REG, &saved, 1);
+		return &RTC_DS1307_Ops;
+	}
+
+	return &RTC_DS3231_Ops;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_Init
+ *
+ * @brief             - Initializes the bus, finds the RTC part and initializes it
+ *
+ * @param[in]         - RTC handle with RTC_Config filled in
+ *
+ * @return            -  RTC_OK, RTC_ERR_NODEV if nothing answers or the part does not start, RTC_ERR_BUS
+ *
+ * @Note              -  a part which kept running is not written, see RTC_IsTimeLost()
+
+ *********************************************************************/
+uint8_t RTC_Init(RTC_Handle_t *pRTCHandle)
+{
+	pRTCHandle->pOps = NULL;
+	pRTCHandle->Control = 0;
+	pRTCHandle->TimeLost = 0;
+
+	// 1. Initialize the GPIO pins for I2C
+	RTC_I2C_PinConfig(pRTCHandle);
+
+	// 2. Initialize the I2C peripheral and enable it
+	RTC_I2C_Config(pRTCHandle);
+	I2C_PeripheralControl(pRTCHandle->RTC_Config.pI2Cx, ENABLE);
+
+	// 3. Find out which part is on the bus
+	pRTCHandle->pOps = RTC_Probe(pRTCHandle);
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+
+	// 4. Register cache of the part
+	RTC_RegMapConfig(pRTCHandle);
+
+	// 5. Part specific init (start the oscillator if it is halted, find out whether the time was lost)
+	return pRTCHandle->pOps->pfnInit(pRTCHandle);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_GetType
+ *
+ * @brief             - Returns the part found by RTC_Init
+ *
+ * @param[in]         - RTC handle
+ *
+ * @return            -  @RTC_TYPE
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_GetType(RTC_Handle_t *pRTCHandle)
+{
+	return pRTCHandle->pOps ? pRTCHandle->pOps->Type : RTC_TYPE_NONE;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_IsTimeLost
+ *
+ * @brief             - Tells whether the part lost the time before RTC_Init
+ *
+ * @param[in]         - RTC handle
+ *
+ * @return            -  1 if the time has to be set, 0 if the part kept running
+ *
+ * @Note              -  stays set after RTC_SetDateTime, it describes the boot
+
+ *********************************************************************/
+uint8_t RTC_IsTimeLost(RTC_Handle_t *pRTCHandle)
+{
+	return pRTCHandle->TimeLost;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_GetDateTime
+ *
+ * @brief             - Reads time and date in one burst
+ *
+ * @param[in]         - RTC handle
+ * @param[out]        - time
+ * @param[out]        - date
+ *
+ * @return            -  RTC_OK or RTC_ERR_xxx
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+
+	return pRTCHandle->pOps->pfnGetDateTime(pRTCHandle, pTime, pDate);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_SetDateTime
+ *
+ * @brief             - Writes time and date in one burst
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - time
+ * @param[in]         - date
+ *
+ * @return            -  RTC_OK or RTC_ERR_xxx
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+
+	return pRTCHandle->pOps->pfnSetDateTime(pRTCHandle, pTime, pDate);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_SetAlarm
+ *
+ * @brief             - Programs an alarm of the part and clears its flag
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - alarm index, 0 to NumAlarms-1
+ * @param[in]         - alarm
+ *
+ * @return            -  RTC_OK or RTC_ERR_xxx
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_SetAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+	if(pRTCHandle->pOps->pfnSetAlarm == NULL)
+		return RTC_ERR_NOTSUP;
+	if(AlarmIdx >= pRTCHandle->pOps->NumAlarms)
+		return RTC_ERR_PARAM;
+
+	return pRTCHandle->pOps->pfnSetAlarm(pRTCHandle, AlarmIdx, pAlarm);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_CheckAlarm
+ *
+ * @brief             - Checks and clears the flag of an alarm
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - alarm index
+ *
+ * @return            -  1 if the alarm fired since the last check, 0 otherwise
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_CheckAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx)
+{
+	if((pRTCHandle->pOps == NULL) || (pRTCHandle->pOps->pfnCheckAlarm == NULL))
+		return 0;
+	if(AlarmIdx >= pRTCHandle->pOps->NumAlarms)
+		return 0;
+
+	return pRTCHandle->pOps->pfnCheckAlarm(pRTCHandle, AlarmIdx);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_SetSquareWave
+ *
+ * @brief             - Configures the square wave / clock output of the part
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - @RTC_SQW
+ *
+ * @return            -  RTC_OK, RTC_ERR_NOTSUP if the part can not output this rate, RTC_ERR_BUS
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+
+	return pRTCHandle->pOps->pfnSetSquareWave(pRTCHandle, Rate);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_ReadNVRAM
+ *
+ * @brief             - Reads the battery backed RAM of the part
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - offset in the NVRAM
+ * @param[out]        - buffer
+ * @param[in]         - number of bytes
+ *
+ * @return            -  RTC_OK or RTC_ERR_xxx
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_ReadNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+	if(pRTCHandle->pOps->pfnReadNVRAM == NULL)
+		return RTC_ERR_NOTSUP;
+	if((uint16_t)Offset + Len > pRTCHandle->pOps->NVRAMSize)
+		return RTC_ERR_PARAM;
+
+	return pRTCHandle->pOps->pfnReadNVRAM(pRTCHandle, Offset, pBuf, Len);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_WriteNVRAM
+ *
+ * @brief             - Writes the battery backed RAM of the part
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - offset in the NVRAM
+ * @param[in]         - data
+ * @param[in]         - number of bytes
+ *
+ * @return            -  RTC_OK or RTC_ERR_xxx
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_WriteNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+	if(pRTCHandle->pOps->pfnWriteNVRAM == NULL)
+		return RTC_ERR_NOTSUP;
+	if((uint16_t)Offset + Len > pRTCHandle->pOps->NVRAMSize)
+		return RTC_ERR_PARAM;
+
+	return pRTCHandle->pOps->pfnWriteNVRAM(pRTCHandle, Offset, pBuf, Len);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_GetTemperature
+ *
+ * @brief             - Reads the die temperature of the part
+ *
+ * @param[in]         - RTC handle
+ * @param[out]        - temperature in 0.25 degC steps
+ *
+ * @return            -  RTC_OK or RTC_ERR_xxx
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_GetTemperature(RTC_Handle_t *pRTCHandle, int16_t *pQuarterDegC)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_ERR_NODEV;
+	if(pRTCHandle->pOps->pfnGetTemperature == NULL)
+		return RTC_ERR_NOTSUP;
+
+	return pRTCHandle->pOps->pfnGetTemperature(pRTCHandle, pQuarterDegC);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_SQWPinConfig
+ *
+ * @brief             - Configures the MCU pin wired to the square wave output as a falling edge
+ * 						EXTI interrupt and enables it in the NVIC
+ *
+ * @param[in]         -  RTC handle. Does nothing if pSQWPort is NULL
+ *
+ * @return            -  none
+ *
+ * @Note              -  the output is open drain on all parts, so the internal pull up is used.
+ * 						 The application implements the EXTI IRQ handler
+
+ *********************************************************************/
+void RTC_SQWPinConfig(RTC_Handle_t *pRTCHandle)
+{
+	GPIO_Handle_t sqw;
+	memset(&sqw,0,sizeof(sqw));
+
+	if(pRTCHandle->RTC_Config.pSQWPort == NULL)
+		return;
+
+	sqw.pGPIOx = pRTCHandle->RTC_Config.pSQWPort;
+	sqw.GPIO_PinConfig.GPIO_PinNumber = pRTCHandle->RTC_Config.SQWPin;
+	sqw.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_IT_FT;
+	sqw.GPIO_PinConfig.GPIO_PinPuPdControl = GPIO_PUPD_PULLUP;
+
+	GPIO_Init(&sqw);
+
+	GPIO_IRQITConfig(pRTCHandle->RTC_Config.SQWIRQ, ENABLE);
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_toEpoch
+ *
+ * @brief             - Converts a time and date to the number of
+ * 						seconds elapsed since 01/01/00 00:00:00
+ *
+ * @param[in]         - time in any of the three time formats
+ * @param[in]         - date (year range is 2000-2099)
+ *
+ * @return            -  seconds since 01/01/00 00:00:00
+ *
+ * @Note              -  every year divisible by 4 is a leap year in this range
+
+ *********************************************************************/
+uint32_t RTC_toEpoch(RTC_Handle_time_t *timeHandle, RTC_Handle_date_t *dateHandle)
+{
+	static const uint16_t daysBeforeMonth[12] = {0,31,59,90,120,151,181,212,243,273,304,334};
+	uint32_t days;
+	uint8_t hours = RTC_To24Hours(timeHandle);
+
+	// (year + 3)/4 is the number of leap years before this year
+	days = (uint32_t)dateHandle->year * 365 + ((dateHandle->year + 3) / 4);
+	days += daysBeforeMonth[(dateHandle->month - 1) % 12];
+	if(((dateHandle->year % 4) == 0) && (dateHandle->month > 2))
+		days++;
+	days += dateHandle->date - 1;
+
+	return (((days * 24) + hours) * 60 + timeHandle->minutes) * 60 + timeHandle->seconds;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_fromEpoch
+ *
+ * @brief             - Converts seconds elapsed since 01/01/00 00:00:00 to a time and date
+ *
+ * @param[in]         - seconds since 01/01/00 00:00:00
+ * @param[out]        - time, always RTC_TIME_FORMAT_24HRS
+ * @param[out]        - date, day of the week included
+ *
+ * @return            -  none
+ *
+ * @Note              -  inverse of RTC_toEpoch for the years 2000-2099
+
+ *********************************************************************/
+void RTC_fromEpoch(uint32_t Epoch, RTC_Handle_time_t *timeHandle, RTC_Handle_date_t *dateHandle)
+{
+	uint32_t days = Epoch / 86400;
+	uint32_t secs = Epoch % 86400;
+	uint32_t year, dayOfYear;
+	uint8_t month = 1, dim;
+
+	timeHandle->seconds = secs % 60;
+	timeHandle->minutes = (secs / 60) % 60;
+	timeHandle->hours = secs / 3600;
+	timeHandle->timeFormat = RTC_TIME_FORMAT_24HRS;
+
+	// 01/01/00 was a Saturday
+	dateHandle->day = ((days + SATURDAY - 1) % 7) + 1;
+
+	// 4 year cycles of 1461 days, the first year of each cycle is the leap year
+	year = (days / 1461) * 4;
+	dayOfYear = days % 1461;
+	if(dayOfYear >= 366)
+	{
+		dayOfYear -= 366;
+		year += 1 + dayOfYear / 365;
+		dayOfYear %= 365;
+	}
+
+	while(dayOfYear >= (dim = RTC_DaysInMonth(month, year)))
+	{
+		dayOfYear -= dim;
+		month++;
+	}
+
+	dateHandle->year = year;
+	dateHandle->month = month;
+	dateHandle->date = dayOfYear + 1;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_DaysInMonth
+ *
+ * @brief             - Returns the number of days of a month
+ *
+ * @param[in]         - month, 1 to 12
+ * @param[in]         - year, 0 to 99 (2000-2099)
+ *
+ * @return            -  28 to 31
+ *
+ * @Note              -  every year divisible by 4 is a leap year in this range
+
+ *********************************************************************/
+uint8_t RTC_DaysInMonth(uint8_t month, uint8_t year)
+{
+	static const uint8_t daysInMonth[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
+
+	if((month == 2) && ((year % 4) == 0))
+		return 29;
+
+	return daysInMonth[(month - 1) % 12];
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_ReadRegs
+ *
+ * @brief             - Burst read of consecutive registers
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - first register
+ * @param[out]        - buffer
+ * @param[in]         - number of registers
+ *
+ * @return            -  RTC_OK, RTC_ERR_BUS
+ *
+ * @Note              -  goes through the register cache once a backend is selected
+
+ *********************************************************************/
+uint8_t RTC_ReadRegs(RTC_Handle_t *pRTCHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_BusRead(pRTCHandle, Reg, pBuf, Len);
+
+	return (RegMap_Read(&pRTCHandle->RegMap, Reg, pBuf, Len) == REGMAP_OK) ? RTC_OK : RTC_ERR_BUS;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_WriteRegs
+ *
+ * @brief             - Burst write of consecutive registers
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - first register
+ * @param[in]         - data
+ * @param[in]         - number of registers
+ *
+ * @return            -  RTC_OK, RTC_ERR_BUS
+ *
+ * @Note              -  goes through the register cache once a backend is selected
+
+ *********************************************************************/
+uint8_t RTC_WriteRegs(RTC_Handle_t *pRTCHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	if(pRTCHandle->pOps == NULL)
+		return RTC_BusWrite(pRTCHandle, Reg, pBuf, Len);
+
+	return (RegMap_Write(&pRTCHandle->RegMap, Reg, pBuf, Len) == REGMAP_OK) ? RTC_OK : RTC_ERR_BUS;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_UpdateReg
+ *
+ * @brief             - Read-modify-write of the bits in Mask of one register
+ *
+ * @param[in]         - RTC handle
+ * @param[in]         - register
+ * @param[in]         - bits to change
+ * @param[in]         - new value of those bits
+ *
+ * @return            -  RTC_OK, RTC_ERR_BUS
+ *
+ * @Note              -  no bus read for cached registers, no write if nothing changes
+
+ *********************************************************************/
+uint8_t RTC_UpdateReg(RTC_Handle_t *pRTCHandle, uint8_t Reg, uint8_t Mask, uint8_t Value)
+{
+	return (RegMap_UpdateBits(&pRTCHandle->RegMap, Reg, Mask, Value) == REGMAP_OK) ? RTC_OK : RTC_ERR_BUS;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_BCDtoBin
+ *
+ * @brief             - This function converts BCD value to binary
+ *
+ * @param[in]         - BCD value
+ *
+ * @return            -  binary value
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_BCDtoBin(uint8_t BCD)
+{
+	return (uint8_t)(((BCD >> 4) * 10) + (BCD & 0x0F));
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_BintoBCD
+ *
+ * @brief             - This function converts Binary to BCD
+ *
+ * @param[in]         - binary value, 0 to 99
+ *
+ * @return            -  BCD value
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RTC_BintoBCD(uint8_t bin)
+{
+	return (uint8_t)(((bin / 10) << 4) | (bin % 10));
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_To24Hours
+ *
+ * @brief             - Returns the hours of a time as 0 to 23
+ *
+ * @param[in]         - time in any of the three time formats
+ *
+ * @return            -  hours
+ *
+ * @Note              -  12AM -> 0, 12PM -> 12
+
+ *********************************************************************/
+uint8_t RTC_To24Hours(RTC_Handle_time_t *pTime)
+{
+	uint8_t hours = pTime->hours;
+
+	if(pTime->timeFormat != RTC_TIME_FORMAT_24HRS)
+	{
+		hours %= 12;
+		if(pTime->timeFormat == RTC_TIME_FORMAT_12HRS_PM)
+			hours += 12;
+	}
+
+	return hours;
+}
+
+/*********************************************************************
+ * @fn      		  - RTC_From24Hours
+ *
+ * @brief             - Converts a 24 hour time to another time format
+ *
+ * @param[in/out]     - time, 24 hour format on entry
+ * @param[in]         - @RTC_TIME_FORMAT
+ *
+ * @return            -  none
+ *
+ * @Note              -  0 -> 12AM, 12 -> 12PM
+
+ *********************************************************************/
+void RTC_From24Hours(RTC_Handle_time_t *pTime, uint8_t TimeFormat)
+{
+	if(TimeFormat == RTC_TIME_FORMAT_24HRS)
+		return;
+
+	pTime->timeFormat = (pTime->hours >= 12) ? RTC_TIME_FORMAT_12HRS_PM : RTC_TIME_FORMAT_12HRS_AM;
+	pTime->hours %= 12;
+	if(pTime->hours == 0)
+		pTime->hours = 12;
+}
@@ -0,0 +1,243 @@
+/*
+ * rtc.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Device independent RTC interface. The application only uses the RTC_xxx APIs, the part on the board
+ * 	  is found at RTC_Init() by probing the I2C bus
+ * 		- 0x51 answers					-> PCF8563
+ * 		- 0x68 answers, RAM at 12h		-> DS1307 (12h is battery backed RAM)
+ * 		- 0x68 answers, no RAM at 12h	-> DS3231 (12h is the read only temperature LSB)
+ * 	- Every backend implements RTC_Ops_t with its own register layout. Date and time are always read and
+ * 	  written as one burst, so the fields can not tear across a seconds update
+ * 	- RTC_Init() does not touch the time of a part which kept running. RTC_IsTimeLost() tells whether the
+ * 	  part lost power or was halted before (DS1307 CH, DS3231 OSF, PCF8563 VL), the time has to be set then
+ * 	- Features a part does not have return RTC_ERR_NOTSUP. A NACK or timeout on the bus returns RTC_ERR_BUS,
+ * 	  a failed read is not cached (RTC_CheckAlarm() reports no alarm then)
+ * 		- DS1307	56 bytes NVRAM, SQW 1/4096/8192/32768Hz, no alarm, no temperature
+ * 		- DS3231	2 alarms (alarm 1 with seconds), SQW 1/1024/4096/8192Hz, temperature (0.25C)
+ * 		- PCF8563	1 alarm (minutes resolution), CLKOUT 1/1024/32768Hz
+ * 	- Alarms set the flag of the part only. The INT/SQW pin keeps the square wave, so RTC_CheckAlarm()
+ * 	  is polled (the 1Hz tick is the natural place)
+ * 	- Hours in RTC_Handle_time_t follow timeFormat. The PCF8563 is 24 hour only, times are converted
+ * 	- After the probe, register access goes through a write through register cache (regmap.h). Every
+ * 	  backend lists its volatile registers (time, flags, temperature). Control, alarm and NVRAM registers
+ * 	  are read from the device once, unchanged writes and read-modify-writes of them cost no bus transfer
+ * 	- The probe writes 12h and restores it on a DS1307 (NVRAM offset RTC_DS1307_PROBE_NVRAM). A reset in
+ * 	  between leaves that byte changed, keep CRC protected blocks out of it
+ */
+
+#ifndef RTC_H_
+#define RTC_H_
+
+#include "stm32f407xx.h"
+#include "regmap.h"
+
+/*
+ * Board defaults for the RTC (used to fill RTC_Config_t)
+ * I2C peripheral - I2C1
+ * I2C1 SCL - PB6
+ * I2C1 SDA - PB7
+ * SQW/INT/CLKOUT (open drain) - PB5. The falling edge of the 1Hz output marks the seconds update
+ */
+#define RTC_BOARD_I2C					I2C1
+#define RTC_BOARD_I2C_SPEED				I2C_SCL_SPEED_SM_KHZ
+#define RTC_BOARD_SCL_PORT				GPIOB
+#define RTC_BOARD_SCL_PIN				GPIO_PIN_6
+#define RTC_BOARD_SDA_PORT				GPIOB
+#define RTC_BOARD_SDA_PIN				GPIO_PIN_7
+#define RTC_BOARD_SQW_PORT				GPIOB
+#define RTC_BOARD_SQW_PIN				GPIO_PIN_5
+#define RTC_BOARD_SQW_IRQ				IRQ_EXTI9_5
+
+/*
+ * I2C pin settings. Every I2C pin of the F407 (I2C1/2/3) is on alternate function 4
+ */
+#define RTC_I2C_PIN_SPEED				GPIO_OUT_SPEED_LOW
+#define RTC_I2C_PUPD					GPIO_PUPD_PULLUP
+#define RTC_I2C_ALTFN					GPIO_ALTFN_AF4
+
+/*
+ * Day macros
+ */
+#define SUNDAY		1
+#define MONDAY		2
+#define TUESDAY		3
+#define WEDNESDAY	4
+#define THURSDAY	5
+#define FRIDAY		6
+#define SATURDAY	7
+
+/*
+ * Time format options
+ */
+#define RTC_TIME_FORMAT_12HRS_AM		0
+#define RTC_TIME_FORMAT_12HRS_PM		1
+#define RTC_TIME_FORMAT_24HRS			2
+
+/*
+ * Data Structure to handle the information
+ */
+typedef struct{
+	uint8_t seconds;
+	uint8_t minutes;
+	uint8_t hours;
+	uint8_t timeFormat;
+}RTC_Handle_time_t;
+
+typedef struct{
+	uint8_t date;
+	uint8_t month;
+	uint8_t year;
+	uint8_t day;
+}RTC_Handle_date_t;
+
+/*
+ * Alarm. Fires when seconds, minutes and hours (24 hour) match, and the date too if date is not 0
+ */
+typedef struct{
+	uint8_t seconds;
+	uint8_t minutes;
+	uint8_t hours;
+	uint8_t date;						/* 0 -> every day */
+}RTC_Alarm_t;
+
+/*
+ * @RTC_TYPE
+ */
+#define RTC_TYPE_NONE					0
+#define RTC_TYPE_DS1307					1
+#define RTC_TYPE_DS3231					2
+#define RTC_TYPE_PCF8563				3
+
+/*
+ * @RTC_SQW. Square wave / clock output rates
+ */
+#define RTC_SQW_OFF						0
+#define RTC_SQW_1HZ						1
+#define RTC_SQW_1024HZ					2
+#define RTC_SQW_4096HZ					3
+#define RTC_SQW_8192HZ					4
+#define RTC_SQW_32768HZ					5
+
+/*
+ * Return values
+ */
+#define RTC_OK							0
+#define RTC_ERR_NOTSUP					1
+#define RTC_ERR_PARAM					2
+#define RTC_ERR_NODEV					3
+#define RTC_ERR_BUS						4			/* NACK or timeout on the I2C bus */
+
+/*
+ * Configuration structure for one RTC
+ */
+typedef struct
+{
+	I2C_RegDef_t	*pI2Cx;					/* I2C1, I2C2 or I2C3 */
+	uint32_t		I2C_SCLSpeed;
+	GPIO_RegDef_t	*pSCLPort;
+	uint8_t			SCLPin;
+	GPIO_RegDef_t	*pSDAPort;				/* I2C3 has SCL and SDA on different ports (PA8 / PC9) */
+	uint8_t			SDAPin;
+	GPIO_RegDef_t	*pSQWPort;				/* NULL -> SQW/INT/CLKOUT is not wired */
+	uint8_t			SQWPin;
+	uint8_t			SQWIRQ;
+}RTC_Config_t;
+
+struct RTC_Handle;
+
+/*
+ * Operations implemented by every backend
+ */
+typedef struct
+{
+	uint8_t		Type;						/* @RTC_TYPE */
+	uint8_t		SlaveAddr;
+	uint8_t		NVRAMSize;					/* bytes, 0 -> no NVRAM */
+	uint8_t		NumAlarms;
+	uint8_t		NumRegs;					/* Registers described for the register cache */
+	uint32_t	Volatile[REGMAP_MAP_WORDS];	/* Bit n set -> register n changes on its own (never cached) */
+	uint8_t		(*pfnInit)(struct RTC_Handle *pRTCHandle);
+	uint8_t		(*pfnGetDateTime)(struct RTC_Handle *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+	uint8_t		(*pfnSetDateTime)(struct RTC_Handle *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+	uint8_t		(*pfnSetAlarm)(struct RTC_Handle *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm);
+	uint8_t		(*pfnCheckAlarm)(struct RTC_Handle *pRTCHandle, uint8_t AlarmIdx);
+	uint8_t		(*pfnSetSquareWave)(struct RTC_Handle *pRTCHandle, uint8_t Rate);
+	uint8_t		(*pfnReadNVRAM)(struct RTC_Handle *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len);
+	uint8_t		(*pfnWriteNVRAM)(struct RTC_Handle *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len);
+	uint8_t		(*pfnGetTemperature)(struct RTC_Handle *pRTCHandle, int16_t *pQuarterDegC);
+}RTC_Ops_t;
+
+/*
+ * Handle structure for one RTC
+ */
+typedef struct RTC_Handle
+{
+	RTC_Config_t		RTC_Config;
+	I2C_Handle_t		I2C_Handle;			/* To store the bus handle of this instance */
+	const RTC_Ops_t		*pOps;				/* To store the backend found by RTC_Init */
+	RegMap_Handle_t		RegMap;				/* To store the register cache of the part */
+	uint8_t				Control;			/* To store the last value written to the control register */
+	uint8_t				TimeLost;			/* To store whether the time was lost before RTC_Init (set by the backend) */
+}RTC_Handle_t;
+
+/*
+ * Backends
+ */
+extern const RTC_Ops_t RTC_DS1307_Ops;
+extern const RTC_Ops_t RTC_DS3231_Ops;
+extern const RTC_Ops_t RTC_PCF8563_Ops;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init (bus, probe, backend init)
+ */
+uint8_t RTC_Init(RTC_Handle_t *pRTCHandle);
+uint8_t RTC_GetType(RTC_Handle_t *pRTCHandle);
+uint8_t RTC_IsTimeLost(RTC_Handle_t *pRTCHandle);
+
+/*
+ * Device operations
+ */
+uint8_t RTC_GetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+uint8_t RTC_SetDateTime(RTC_Handle_t *pRTCHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+uint8_t RTC_SetAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx, RTC_Alarm_t *pAlarm);
+uint8_t RTC_CheckAlarm(RTC_Handle_t *pRTCHandle, uint8_t AlarmIdx);
+uint8_t RTC_SetSquareWave(RTC_Handle_t *pRTCHandle, uint8_t Rate);
+uint8_t RTC_ReadNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len);
+uint8_t RTC_WriteNVRAM(RTC_Handle_t *pRTCHandle, uint8_t Offset, uint8_t *pBuf, uint8_t Len);
+uint8_t RTC_GetTemperature(RTC_Handle_t *pRTCHandle, int16_t *pQuarterDegC);
+
+/*
+ * MCU pin which receives the square wave
+ */
+void RTC_SQWPinConfig(RTC_Handle_t *pRTCHandle);
+
+/*
+ * Convert time and date to and from seconds elapsed since 01/01/00 00:00:00
+ */
+uint32_t RTC_toEpoch(RTC_Handle_time_t *timeHandle, RTC_Handle_date_t *dateHandle);
+void RTC_fromEpoch(uint32_t Epoch, RTC_Handle_time_t *timeHandle, RTC_Handle_date_t *dateHandle);
+uint8_t RTC_DaysInMonth(uint8_t month, uint8_t year);
+
+/*
+ * Helpers for the backends
+ */
+uint8_t RTC_ReadRegs(RTC_Handle_t *pRTCHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+uint8_t RTC_WriteRegs(RTC_Handle_t *pRTCHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+uint8_t RTC_UpdateReg(RTC_Handle_t *pRTCHandle, uint8_t Reg, uint8_t Mask, uint8_t Value);
+uint8_t RTC_BCDtoBin(uint8_t BCD);
+uint8_t RTC_BintoBCD(uint8_t bin);
+uint8_t RTC_To24Hours(RTC_Handle_time_t *pTime);
+void RTC_From24Hours(RTC_Handle_time_t *pTime, uint8_t TimeFormat);
+
+#endif /* RTC_H_ */
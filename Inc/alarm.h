@@ -0,0 +1,127 @@
+/*
+ * alarm.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Software alarms for RTCs without (enough) alarm registers. Times are RTC epoch seconds
+ * 	  (seconds since 01/01/00 00:00:00, see RTC_toEpoch)
+ * 	- Alarm types
+ * 		- Once		fires at Due
+ * 		- Daily		fires every day at TimeOfDay
+ * 		- Weekly	fires at TimeOfDay on the days set in DayMask (bit 0 = SUNDAY ... bit 6 = SATURDAY)
+ * 		- Custom	pfnNext returns the next expiry after a given second (cron schedules, see cron.h)
+ * 	- Pending alarms are kept in a binary min heap keyed by Due. Add and cancel are O(log n), the next
+ * 	  alarm is always at the top. The heap is an array of pointers supplied by the caller, so its size
+ * 	  is only limited by RAM. Alarms are owned by the caller and must stay valid while they are pending
+ * 	- Only the next due alarm is armed, on one scheduler timer (sched.h). The scheduler is ticked by the
+ * 	  RTC square wave, so one tick is one RTC second and nothing is polled over I2C while waiting
+ * 	- The engine does not read the RTC while running. The current time is the RTC time of the last
+ * 	  resync plus the scheduler ticks since. Call Alarm_Resync() whenever the RTC time is set, or read it
+ * 	  back after ticks may have been lost (SQW off, ...)
+ * 		- Forward jump: every alarm which became due fires once, repeating ones are then rescheduled
+ * 		  after the new time
+ * 		- Backward jump: repeating alarms are recomputed from the new time, one shot alarms keep Due
+ * 	- Alarm tasks run in thread context (scheduler task). A repeating alarm is already rescheduled when
+ * 	  its task runs, so the task may cancel or change it
+ */
+
+#ifndef ALARM_H_
+#define ALARM_H_
+
+#include "stm32f407xx.h"
+#include "sched.h"
+
+#define ALARM_SECONDS_PER_DAY			86400UL
+#define ALARM_NEVER						0xFFFFFFFFUL		/* pfnNext: no further expiry */
+#define ALARM_NOT_QUEUED				0xFFFFFFFFUL
+
+/*
+ * @ALARM_TYPE
+ */
+#define ALARM_TYPE_ONCE					0
+#define ALARM_TYPE_DAILY				1
+#define ALARM_TYPE_WEEKLY				2
+#define ALARM_TYPE_CUSTOM				3
+
+/*
+ * Return values
+ */
+#define ALARM_OK						0
+#define ALARM_ERR_FULL					1
+#define ALARM_ERR_PARAM					2
+
+/*
+ * Alarm. Owned by the caller, filled in by one of the Alarm_Setxxx APIs
+ */
+typedef struct Alarm
+{
+	uint32_t			Due;				/* Epoch second of the next expiry */
+	uint32_t			HeapIdx;			/* Position in the heap. ALARM_NOT_QUEUED -> not pending */
+	uint8_t				Type;				/* @ALARM_TYPE */
+	uint8_t				DayMask;			/* Weekly: bit (day - SUNDAY) per day */
+	uint32_t			TimeOfDay;			/* Daily/Weekly: seconds after midnight */
+	uint32_t			(*pfnNext)(void *pSpec, uint32_t After);	/* Custom: first expiry after After */
+	void				*pSpec;				/* Custom: argument of pfnNext */
+	Sched_Task_t		pfnTask;
+	void				*pArg;
+}Alarm_t;
+
+/*
+ * Configuration structure for the alarm engine
+ */
+typedef struct
+{
+	Sched_Handle_t		*pSched;			/* Scheduler ticked once per RTC second */
+	Alarm_t				**ppHeap;			/* Heap storage, Capacity pointers */
+	uint32_t			Capacity;
+}Alarm_Config_t;
+
+/*
+ * Handle structure for the alarm engine
+ */
+typedef struct
+{
+	Alarm_Config_t		Alarm_Config;
+	uint32_t			Count;				/* To store the number of pending alarms */
+	uint32_t			EpochBase;			/* To store the RTC epoch second of the last resync */
+	uint32_t			TickBase;			/* To store the scheduler tick of the last resync */
+	Sched_Timer_t		Timer;
+}Alarm_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init and time keeping
+ */
+void Alarm_Init(Alarm_Handle_t *pAlarmHandle, uint32_t Now);
+void Alarm_Resync(Alarm_Handle_t *pAlarmHandle, uint32_t Now);
+uint32_t Alarm_GetNow(Alarm_Handle_t *pAlarmHandle);
+
+/*
+ * Describe an alarm
+ */
+void Alarm_SetOnce(Alarm_t *pAlarm, uint32_t Due, Sched_Task_t pfnTask, void *pArg);
+void Alarm_SetDaily(Alarm_t *pAlarm, uint32_t TimeOfDay, Sched_Task_t pfnTask, void *pArg);
+void Alarm_SetWeekly(Alarm_t *pAlarm, uint8_t DayMask, uint32_t TimeOfDay, Sched_Task_t pfnTask, void *pArg);
+void Alarm_SetCustom(Alarm_t *pAlarm, uint32_t (*pfnNext)(void *pSpec, uint32_t After), void *pSpec, Sched_Task_t pfnTask, void *pArg);
+
+/*
+ * Pending alarms (thread context only)
+ */
+uint8_t Alarm_Add(Alarm_Handle_t *pAlarmHandle, Alarm_t *pAlarm);
+void Alarm_Cancel(Alarm_Handle_t *pAlarmHandle, Alarm_t *pAlarm);
+Alarm_t* Alarm_PeekNext(Alarm_Handle_t *pAlarmHandle);
+
+/*
+ * Calendar helper
+ */
+uint8_t Alarm_DayOfWeek(uint32_t Epoch);
+
+#endif /* ALARM_H_ */
@@ -0,0 +1,40 @@
+/*
+ * crc.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- CRC-32 shared by the modules which protect data (telemetry frames, flash log records, NVRAM
+ * 	  settings). Poly 0x04C11DB7, init 0xFFFFFFFF, no reflection, no final xor, over little endian words
+ * 	  as the CRC unit of the MCU computes it (stm32f407xx_crc.h). 1-3 bytes at the end count as one word
+ * 	  with the missing upper bytes 0
+ * 	- Crc_CRC32() uses the CRC unit on the target, fed one word per write by the CPU. Host builds and a
+ * 	  CRC unit which is busy with a DMA (CRC_DMAStart) fall back to Crc_CRC32Soft(), which gives the same
+ * 	  result (256 entry table, one lookup per byte)
+ * 	- Call Crc_Init() once at boot, before that Crc_CRC32() also uses the software CRC
+ * 	- The CRC unit is not reentrant, call Crc_CRC32() from thread context only. Crc_CRC32Soft() can be
+ * 	  called from anywhere
+ * 	- Large buffers can be streamed into the CRC unit with DMA (CRC_DMAStart / CRC_DMAPoll), the CPU is
+ * 	  free meanwhile
+ */
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include "stm32f407xx.h"
+
+#define CRC32_INIT						0xFFFFFFFFUL
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Crc_Init(void);
+uint32_t Crc_CRC32(const void *pData, uint32_t Len);
+uint32_t Crc_CRC32Soft(const void *pData, uint32_t Len);
+
+#endif /* CRC_H_ */
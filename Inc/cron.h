@@ -0,0 +1,73 @@
+/*
+ * cron.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Cron schedules ("*\/5 8-18 * * MON-FRI") compiled once into one bitmask per field
+ * 		- minute	0-59	bit n = minute n (64 bit)
+ * 		- hour		0-23	bit n = hour n
+ * 		- day		1-31	bit n = day n
+ * 		- month		1-12	bit n = month n, names JAN-DEC
+ * 		- weekday	0-7		bit 0 = Sunday ... bit 6 = Saturday, 7 is Sunday too, names SUN-SAT
+ * 	- Field syntax: "*", "a", "a-b", "*\/n", "a-b/n", "a/n" (a to the end of the range), comma separated lists.
+ * 	  "@hourly", "@daily", "@weekly", "@monthly" and "@yearly" are accepted as whole expressions
+ * 	- Like Vixie cron, when both day and weekday are restricted a time matches if either matches.
+ * 	  A field starting with "*" counts as unrestricted
+ * 	- Cron_Match() checks a time and date in a few ANDs, no parsing or loops
+ * 	- Cron_Next() finds the next matching minute without stepping minute by minute. Month, day, hour
+ * 	  and minute are each advanced to the next set bit of their mask (count trailing zeros), the days of
+ * 	  a month are one 32 bit mask built from the day and weekday masks. The cost is bounded by the number
+ * 	  of months skipped, an expression which never matches ("0 0 30 2 *") gives up at the end of 2099
+ * 	- Cron_SetAlarm() plugs an expression into the alarm engine (alarm.h) as a custom alarm
+ */
+
+#ifndef CRON_H_
+#define CRON_H_
+
+#include "stm32f407xx.h"
+#include "rtc.h"
+#include "alarm.h"
+
+#define CRON_NEVER						ALARM_NEVER
+
+/*
+ * Return values
+ */
+#define CRON_OK							0
+#define CRON_ERR_SYNTAX					1
+#define CRON_ERR_RANGE					2
+
+/*
+ * Compiled expression
+ */
+typedef struct
+{
+	uint64_t		Minutes;
+	uint32_t		Hours;
+	uint32_t		Days;
+	uint16_t		Months;
+	uint8_t			Weekdays;
+	uint8_t			DayStar;			/* 1 -> day field was "*" */
+	uint8_t			WeekdayStar;		/* 1 -> weekday field was "*" */
+}Cron_Expr_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+uint8_t Cron_Parse(Cron_Expr_t *pExpr, const char *pStr);
+uint8_t Cron_Match(Cron_Expr_t *pExpr, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+uint32_t Cron_Next(Cron_Expr_t *pExpr, uint32_t After);
+
+/*
+ * Alarm engine glue
+ */
+uint32_t Cron_NextAlarm(void *pSpec, uint32_t After);
+void Cron_SetAlarm(Alarm_t *pAlarm, Cron_Expr_t *pExpr, Sched_Task_t pfnTask, void *pArg);
+
+#endif /* CRON_H_ */
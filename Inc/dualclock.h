@@ -0,0 +1,93 @@
+/*
+ * dualclock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Runs the on-chip RTC (stm32f407xx_irtc.h) next to the external RTC (rtc.h). The application reads
+ * 	  the time from the internal one, a few APB1 reads and no I2C transfer. The external RTC is the
+ * 	  reference and is only read every CheckPeriod calls of DualClock_Poll() to cross-check the two
+ * 	- A check reads both clocks and stores Diff = internal - external in seconds. More than Tolerance
+ * 	  seconds apart flags the clocks as diverged (a stopped or drifting crystal, a lost battery). The
+ * 	  module only flags, the application decides to DualClock_Resync() or to report it. The two reads
+ * 	  are not at the same instant, so a Tolerance below 1 gives false alarms
+ * 	- DualClock_Init() repairs what it can at boot
+ * 		- external time lost, internal running		external restored from the internal one
+ * 		- internal time lost or out of Tolerance	internal set from the external one
+ * 		- both lost									DUALCLOCK_ERR_LOST, set the time with DualClock_SetDateTime()
+ * 	- Setting the internal RTC restarts its prescalers, its seconds then roll over at the time of the
+ * 	  write. Resync right after an SQW edge to keep both clocks in phase within the I2C read time
+ * 	- Times are converted through the RTC epoch (RTC_toEpoch, seconds since 01/01/00 00:00:00). The
+ * 	  internal RTC always runs 24h, DualClock_GetDateTime() returns TimeFormat
+ */
+
+#ifndef DUALCLOCK_H_
+#define DUALCLOCK_H_
+
+#include "stm32f407xx.h"
+#include "rtc.h"
+
+#define DUALCLOCK_DEFAULT_TOLERANCE		2			/* Seconds */
+
+/*
+ * Return values
+ */
+#define DUALCLOCK_OK					0
+#define DUALCLOCK_ERR_BUS				1			/* External RTC not readable / writable */
+#define DUALCLOCK_ERR_IRTC				2			/* Internal RTC did not take the time */
+#define DUALCLOCK_ERR_LOST				3			/* Both clocks lost the time */
+
+/*
+ * Configuration structure for the dual clock
+ */
+typedef struct
+{
+	RTC_Handle_t		*pRTCHandle;		/* External RTC, the reference */
+	IRTC_Handle_t		*pIRTCHandle;		/* Internal RTC, initialised (IRTC_Init) */
+	uint32_t			CheckPeriod;		/* DualClock_Poll() calls per cross-check, 0 -> never */
+	uint32_t			Tolerance;			/* Seconds, 0 -> DUALCLOCK_DEFAULT_TOLERANCE */
+	uint8_t				TimeFormat;			/* @RTC_TIME_FORMAT of DualClock_GetDateTime() and of the external RTC */
+}DualClock_Config_t;
+
+/*
+ * Handle structure for the dual clock
+ */
+typedef struct
+{
+	DualClock_Config_t	DualClock_Config;
+	int32_t				Diff;				/* To store internal - external at the last check, seconds */
+	uint8_t				Diverged;			/* To store if the last check was out of tolerance */
+	uint32_t			Checks;				/* To store the number of cross-checks */
+	uint32_t			Divergences;		/* To store the number of checks out of tolerance */
+	uint32_t			BusErrors;			/* To store the number of failed external reads */
+	uint32_t			Countdown;			/* To store the Poll calls till the next check */
+}DualClock_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init and set
+ */
+uint8_t DualClock_Init(DualClock_Handle_t *pDcHandle);
+uint8_t DualClock_SetDateTime(DualClock_Handle_t *pDcHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+uint8_t DualClock_Resync(DualClock_Handle_t *pDcHandle);
+
+/*
+ * Reads, internal RTC only
+ */
+void DualClock_GetDateTime(DualClock_Handle_t *pDcHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate);
+uint32_t DualClock_GetEpoch(DualClock_Handle_t *pDcHandle);
+
+/*
+ * Cross-check
+ */
+uint8_t DualClock_Poll(DualClock_Handle_t *pDcHandle, uint32_t *pExtEpoch);
+uint8_t DualClock_IsDiverged(DualClock_Handle_t *pDcHandle);
+
+#endif /* DUALCLOCK_H_ */
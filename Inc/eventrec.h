@@ -0,0 +1,166 @@
+/*
+ * eventrec.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Records edges on external GPIO lines (EXTI) with microsecond timestamps (timestamp.h)
+ * 	- The ISR only latches the timer count, the level and the line into a preallocated ring
+ * 	  (EventRec_Event_t, 8 bytes, RingBuf_PutWords). Converting the count to RTC time is left to EventRec_Drain(), so an
+ * 	  event costs about 30 cycles on top of the ISR entry. The ring has to be drained within 2^31 timer
+ * 	  ticks (134s at 16MHz), see Timestamp_FromCount()
+ * 	- All lines of a recorder share one NVIC priority, so the EXTI ISRs never preempt each other and
+ * 	  the ring stays single producer / single consumer (ringbuf.h)
+ * 	- A full ring drops the new event and counts it. The drain reports the number of drops since the
+ * 	  last drain to the sink along with the events
+ * 	- Level is the pin level after the edge. On single edge lines (GPIO_MODE_IT_RT / _FT) it comes from
+ * 	  the trigger and is always right. Dual edge lines (GPIO_MODE_IT_RFT) read the pin in the ISR: the
+ * 	  EXTI does not latch which edge it saw, so for pulses shorter than the ISR latency both edges are
+ * 	  recorded with the same level. The count of events is still right
+ * 	- The application ISRs for the EXTI lines in use call EventRec_IRQHandling(). EXTI9_5 and EXTI15_10
+ * 	  are shared, the RTC SQW line (PB5) is handled by its own code in the same ISR
+ * 	- Sinks (thread context)
+ * 		- EventRec_SinkTelemetry	TLM_REC_EVENTS records on a telemetry stream (UART or ITM)
+ * 		- EventRec_SinkNVRAM		the last events in a region of the RTC NVRAM, survives a reset
+ * 		- EventRec_SinkFlashLog		one flash log record per event (flashlog.h), months of history
+ * 	- NVRAM region layout
+ * 		|Next slot|Dropped|Slot0|Slot1|.....|		Dropped saturates at 255
+ * 		Slot		|Seconds (4 bytes LSB first)|Micros (3 bytes LSB first)|Line|	Line as in TLM_REC_EVENTS
+ * 	- Flash log records, timestamp = Seconds
+ * 		EVENTREC_FLASHLOG_EVENT		|Micros (3 bytes LSB first)|Line|
+ * 		EVENTREC_FLASHLOG_DROPPED	|Dropped (4 bytes LSB first)|
+ */
+
+#ifndef EVENTREC_H_
+#define EVENTREC_H_
+
+#include "stm32f407xx.h"
+#include "ringbuf.h"
+#include "timestamp.h"
+#include "telemetry.h"
+#include "rtc.h"
+#include "flashlog.h"
+
+#define EVENTREC_BATCH					TLM_EVENTS_MAX		/* Events per sink call */
+#define EVENTREC_NO_OF_LINES			16
+#define EVENTREC_NVRAM_HEADER			2
+#define EVENTREC_NVRAM_SLOT				8
+
+/*
+ * Flash log record types
+ */
+#define EVENTREC_FLASHLOG_EVENT			0x01
+#define EVENTREC_FLASHLOG_DROPPED		0x02
+
+/*
+ * Return values
+ */
+#define EVENTREC_OK						0
+#define EVENTREC_ERR_SIZE				1
+#define EVENTREC_ERR_PARAM				2
+
+/*
+ * Raw event, written by the ISR
+ */
+typedef struct
+{
+	uint32_t		Count;				/* Timer count (Timestamp_GetCount) */
+	uint8_t			Line;				/* EXTI line = pin number */
+	uint8_t			Level;				/* Pin level after the edge */
+	uint16_t		Reserved;
+}EventRec_Event_t;
+
+/*
+ * Event as passed to the sinks
+ */
+typedef struct
+{
+	Timestamp_t		Stamp;
+	uint8_t			Line;
+	uint8_t			Level;
+}EventRec_Record_t;
+
+/*
+ * Line to record
+ */
+typedef struct
+{
+	GPIO_RegDef_t	*pGPIOx;
+	uint8_t			Pin;				/* @GPIO_PINS, one port per pin number */
+	uint8_t			Trigger;			/* GPIO_MODE_IT_FT, GPIO_MODE_IT_RT or GPIO_MODE_IT_RFT */
+	uint8_t			PuPd;				/* GPIO_PUPD_NONE, GPIO_PUPD_PULLUP or GPIO_PUPD_PULLDOWN */
+}EventRec_Line_t;
+
+/*
+ * Sink for drained events. Dropped is the number of events lost since the previous call
+ */
+typedef void (*EventRec_Sink_t)(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped);
+
+/*
+ * NVRAM sink context
+ */
+typedef struct
+{
+	RTC_Handle_t	*pRTCHandle;
+	uint8_t			Offset;				/* Start of the region in the RTC NVRAM */
+	uint8_t			Len;				/* Size of the region, header + at least one slot */
+}EventRec_NVRAMLog_t;
+
+/*
+ * Configuration structure for the event recorder
+ */
+typedef struct
+{
+	Timestamp_Handle_t		*pTsHandle;
+	EventRec_Event_t		*pStorage;			/* Ring storage */
+	uint32_t				Size;				/* Number of events, power of two */
+	const EventRec_Line_t	*pLines;
+	uint8_t					NoOfLines;
+	uint8_t					IRQPriority;		/* NVIC priority of the EXTI ISRs */
+	EventRec_Sink_t			pfnSink;
+	void					*pSinkCtx;			/* Telemetry_Handle_t*, EventRec_NVRAMLog_t* or FlashLog_Handle_t* for the built in sinks */
+}EventRec_Config_t;
+
+/*
+ * Handle structure for the event recorder
+ */
+typedef struct
+{
+	EventRec_Config_t	EventRec_Config;
+	RingBuf_t			Ring;
+	TIM_RegDef_t		*pTIMx;							/* To store the timestamp timer, saves a load in the ISR */
+	GPIO_RegDef_t		*pPort[EVENTREC_NO_OF_LINES];	/* To store the port of each recorded line */
+	uint32_t			LineMask;						/* To store the recorded EXTI lines */
+	uint32_t			RisingEdges;					/* To store the lines triggered on the rising edge only */
+	uint32_t			BothEdges;						/* To store the lines triggered on both edges */
+	__vo uint32_t		Dropped;						/* To store the number of events dropped (ISR) */
+	uint32_t			DroppedReported;				/* To store the drops already passed to the sink */
+}EventRec_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init and ISR
+ */
+uint8_t EventRec_Init(EventRec_Handle_t *pEvHandle);
+__RAMFUNC void EventRec_IRQHandling(EventRec_Handle_t *pEvHandle);
+
+/*
+ * Thread context
+ */
+uint32_t EventRec_Drain(EventRec_Handle_t *pEvHandle, uint32_t MaxEvents);
+
+/*
+ * Sinks
+ */
+void EventRec_SinkTelemetry(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped);
+void EventRec_SinkNVRAM(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped);
+void EventRec_SinkFlashLog(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped);
+
+#endif /* EVENTREC_H_ */
@@ -0,0 +1,120 @@
+/*
+ * flashlog.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Append only log of timestamped records in two internal flash sectors (stm32f407xx_flash.h). The
+ * 	  sectors must be kept out of the image, the linker script stops FLASH before sector 10
+ * 	- The sectors are used in turns. When the active sector is full the other one is erased and takes
+ * 	  over, so the log always holds the records of the full sector before plus the active one. Every
+ * 	  sector is erased once per two fills, the erase count is Seq / 2 (10k cycles per sector)
+ * 	- Sector layout
+ * 		|Magic|Seq|~Seq|Record|Record|.....|0xFF...|		Seq counts up on every rotation
+ * 	- Record layout, all 32 bit words, programmed in order
+ * 		|0xA5|Type|Len (2 bytes)|Timestamp|Payload (padded with 0xFF)|Commit|
+ * 		Commit		CRC-32 (crc.h) over the header, timestamp and payload words
+ * 	- Recovery (FlashLog_Init)
+ * 		- the active sector is the one with a valid header and the higher Seq. The other one is kept
+ * 		  as the older half if its Seq is one less, a rotation cut short leaves it without a header
+ * 		- the write address is behind the last programmed word of the active sector, words are never
+ * 		  programmed twice. A record cut short has a bad commit word. Reading resyncs on the next word
+ * 		  after any bad record, the next boot appends right behind the words it managed to program
+ * 	- RAM index: the write address and the last record are kept in the handle, so appending and
+ * 	  reading the newest record do not scan the flash. Only Init and the iterator read through it
+ * 	- Records are read in place, FlashLog_Record_t points into the flash
+ * 	- Erasing a 128KB sector takes 1-2s. Flash reads stall meanwhile, including code and the vector
+ * 	  table, so interrupts are held off. A rotation costs about one RTC second (SQW tick) once per
+ * 	  sector fill. Append from thread context only
+ * 	- Capacity: a record takes 12 bytes + the payload rounded up to words. With a 4 byte payload a
+ * 	  128KB sector holds 8191 records
+ */
+
+#ifndef FLASHLOG_H_
+#define FLASHLOG_H_
+
+#include "stm32f407xx.h"
+
+#define FLASHLOG_MAGIC					0x474F4C46UL		/* "FLOG" */
+#define FLASHLOG_MARKER					0xA5
+#define FLASHLOG_MAX_PAYLOAD			252
+#define FLASHLOG_ERASED					0xFFFFFFFFUL
+
+#define FLASHLOG_SECTOR_HEADER			12					/* Bytes */
+#define FLASHLOG_RECORD_OVERHEAD		12					/* Header, timestamp and commit words */
+
+/*
+ * Return values
+ */
+#define FLASHLOG_OK						0
+#define FLASHLOG_ERR_PARAM				1
+#define FLASHLOG_ERR_FLASH				2
+#define FLASHLOG_ERR_EMPTY				3					/* No records / end of the log */
+
+/*
+ * Record as read back
+ */
+typedef struct
+{
+	uint8_t			Type;
+	uint16_t		Len;
+	uint32_t		Timestamp;			/* RTC epoch second */
+	const uint8_t	*pData;				/* Payload in flash */
+}FlashLog_Record_t;
+
+/*
+ * Iterator, oldest to newest
+ */
+typedef struct
+{
+	uint32_t		Addr;				/* Next word to parse */
+	uint8_t			Half;				/* 0 older sector, 1 active sector */
+}FlashLog_Cursor_t;
+
+/*
+ * Configuration structure for the flash log
+ */
+typedef struct
+{
+	uint8_t			Sector[2];			/* Flash sectors, both outside the image and of the same size */
+	uint8_t			VoltageRange;		/* @FLASH_VOLTAGE_RANGE */
+}FlashLog_Config_t;
+
+/*
+ * Handle structure for the flash log
+ */
+typedef struct
+{
+	FlashLog_Config_t	FlashLog_Config;
+	uint8_t				Active;				/* To store the index of the active sector in Sector[] */
+	uint8_t				OldValid;			/* To store whether the other sector holds older records */
+	uint32_t			Seq;				/* To store the sequence number of the active sector */
+	uint32_t			WriteAddr;			/* To store the next free word of the active sector */
+	uint32_t			LastAddr;			/* To store the newest valid record, 0 if none */
+	uint32_t			OldEnd;				/* To store the end of the programmed part of the older sector */
+	uint32_t			Records[2];			/* To store the number of valid records, older and active sector */
+	uint32_t			Skipped;			/* To store the number of bad records / words skipped at Init */
+}FlashLog_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init and append
+ */
+uint8_t FlashLog_Init(FlashLog_Handle_t *pLogHandle);
+uint8_t FlashLog_Append(FlashLog_Handle_t *pLogHandle, uint8_t Type, uint32_t Timestamp, const void *pData, uint16_t Len);
+
+/*
+ * Read back
+ */
+uint8_t FlashLog_GetLast(FlashLog_Handle_t *pLogHandle, FlashLog_Record_t *pRecord);
+uint8_t FlashLog_First(FlashLog_Handle_t *pLogHandle, FlashLog_Cursor_t *pCursor, FlashLog_Record_t *pRecord);
+uint8_t FlashLog_Next(FlashLog_Handle_t *pLogHandle, FlashLog_Cursor_t *pCursor, FlashLog_Record_t *pRecord);
+
+#endif /* FLASHLOG_H_ */
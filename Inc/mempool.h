@@ -0,0 +1,96 @@
+/*
+ * mempool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Deterministic replacement for the newlib heap. Memory is a set of statically sized pools of
+ * 	  fixed size blocks (size classes). There is no _sbrk growth and no fragmentation between classes
+ * 	- Alloc and free are O(1) free list operations inside a short PRIMASK critical section, so they may
+ * 	  be called from ISRs (though posting to a ring buffer is the better choice there)
+ * 	- A request is served by the smallest class that fits. If that class is exhausted the next larger
+ * 	  class is tried, and Exhausted of the best fit class is counted
+ * 	- Free checks the pointer against the block grid and an allocation map, a misaligned pointer or a
+ * 	  double free is counted in BadFrees and ignored instead of corrupting the free list
+ * 	- Mempool_Init() is called from startup. Alloc also runs it (inside its critical section) when the
+ * 	  application did not
+ * 	- sysmem.c routes malloc/free/calloc/realloc (and the newlib _r variants) to this module
+ * 	- MEMPOOL_IN_CCMRAM places the arena in the 64KB CCM RAM. CCM is not reachable by DMA, so only
+ * 	  enable it when no allocated buffer is handed to a DMA stream
+ */
+
+#ifndef MEMPOOL_H_
+#define MEMPOOL_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Size classes. Sizes must be multiples of 8 and in ascending order
+ */
+#define MEMPOOL_NUM_CLASSES				6
+
+#define MEMPOOL_CLASS0_SIZE				16
+#define MEMPOOL_CLASS0_COUNT			16
+#define MEMPOOL_CLASS1_SIZE				32
+#define MEMPOOL_CLASS1_COUNT			16
+#define MEMPOOL_CLASS2_SIZE				64
+#define MEMPOOL_CLASS2_COUNT			8
+#define MEMPOOL_CLASS3_SIZE				128
+#define MEMPOOL_CLASS3_COUNT			4
+#define MEMPOOL_CLASS4_SIZE				256
+#define MEMPOOL_CLASS4_COUNT			2
+#define MEMPOOL_CLASS5_SIZE				1024				/* newlib stdio buffer (BUFSIZ) */
+#define MEMPOOL_CLASS5_COUNT			1
+
+#define MEMPOOL_ARENA_SIZE				((MEMPOOL_CLASS0_SIZE * MEMPOOL_CLASS0_COUNT) + \
+										 (MEMPOOL_CLASS1_SIZE * MEMPOOL_CLASS1_COUNT) + \
+										 (MEMPOOL_CLASS2_SIZE * MEMPOOL_CLASS2_COUNT) + \
+										 (MEMPOOL_CLASS3_SIZE * MEMPOOL_CLASS3_COUNT) + \
+										 (MEMPOOL_CLASS4_SIZE * MEMPOOL_CLASS4_COUNT) + \
+										 (MEMPOOL_CLASS5_SIZE * MEMPOOL_CLASS5_COUNT))
+
+#define MEMPOOL_NUM_BLOCKS				(MEMPOOL_CLASS0_COUNT + MEMPOOL_CLASS1_COUNT + MEMPOOL_CLASS2_COUNT + \
+										 MEMPOOL_CLASS3_COUNT + MEMPOOL_CLASS4_COUNT + MEMPOOL_CLASS5_COUNT)
+
+#define MEMPOOL_IN_CCMRAM				0
+
+/*
+ * One size class
+ */
+typedef struct
+{
+	uint8_t			*pStart;			/* To store the first block */
+	uint8_t			*pEnd;				/* To store the end of the last block */
+	void			*pFree;				/* Free list. The first word of a free block points to the next one */
+	uint32_t		BlockSize;
+	uint32_t		NumBlocks;
+	uint32_t		FirstBlock;			/* To store the arena wide index of the first block (allocation map) */
+	uint32_t		InUse;				/* To store the number of blocks allocated now */
+	uint32_t		HighWater;			/* To store the maximum of InUse */
+	uint32_t		Allocs;				/* To store the number of successful allocations */
+	uint32_t		Exhausted;			/* To store the number of requests which found this class empty */
+	uint32_t		BadFrees;			/* To store the number of frees rejected (not a block start, not allocated) */
+}Mempool_Pool_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Mempool_Init(void);
+void* Mempool_Alloc(uint32_t Size);
+void Mempool_Free(void *pBlock);
+uint32_t Mempool_BlockSize(void *pBlock);
+
+/*
+ * Statistics
+ */
+const Mempool_Pool_t* Mempool_GetPool(uint8_t ClassIdx);
+uint32_t Mempool_GetFailures(void);
+uint32_t Mempool_GetBytesInUse(void);
+uint32_t Mempool_GetBytesHighWater(void);
+
+#endif /* MEMPOOL_H_ */
@@ -0,0 +1,84 @@
+/*
+ * power.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- The application does its work (display refresh) and then calls Power_Idle(), which puts the
+ * 	  core into Sleep or STOP until a wake source interrupt arrives
+ * 	- Wake sources
+ * 		- RTC SQW 1Hz falling edge on EXTI (works in Sleep and STOP)
+ * 		- UART. In Sleep the RXNE interrupt wakes the core. In STOP the USART clock is off, so the
+ * 		  RX pin has to be configured as a falling edge EXTI line as well. The first byte is lost in STOP
+ * 	- The wake source ISRs call Power_NotifyWake(). Power_Idle() never sleeps while a wake is pending,
+ * 	  so an event which arrives between the last check and the WFI is not missed
+ * 	- After STOP the system clock is HSI. Power_Idle() re-enables HSE/PLL and switches SYSCLK back
+ * 	- Time accounting
+ * 		- Run time is measured with the DWT cycle counter (it only counts while the core runs)
+ * 		- Every SQW wake closes a one second window: idle time = 1s - run time in that window.
+ * 		  The idle time is booked to the deepest mode entered in that window
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Power modes
+ * @POWER_MODE
+ */
+#define POWER_MODE_RUN					0
+#define POWER_MODE_SLEEP				1
+#define POWER_MODE_STOP					2
+#define POWER_NO_OF_MODES				3
+
+/*
+ * Wake sources (bit positions of the value returned by Power_Idle)
+ * @POWER_WAKE
+ */
+#define POWER_WAKE_SQW					0
+#define POWER_WAKE_UART					1
+#define POWER_WAKE_OTHER				2
+#define POWER_NO_OF_WAKE_SRC			3
+
+/*
+ * Configuration structure for the power manager
+ */
+typedef struct
+{
+	uint32_t	CoreClockHz;			/* HCLK, used to convert cycles to time */
+	uint8_t		IdleMode;				/* POWER_MODE_SLEEP or POWER_MODE_STOP */
+	uint8_t		LowPowerRegulator;		/* ENABLE -> regulator in low power mode during STOP (slower wake up) */
+}Power_Config_t;
+
+/*
+ * Handle structure for the power manager
+ */
+typedef struct
+{
+	Power_Config_t	Power_Config;
+	__vo uint8_t	PendingWake;						/* Bit mask of @POWER_WAKE, set from ISRs */
+	uint8_t			DeepestMode;						/* Deepest mode entered in the current second */
+	uint32_t		WakeStamp;							/* DWT_CYCCNT when the core last woke up */
+	uint32_t		RunCycles;							/* Run cycles in the current second */
+	uint32_t		Seconds;							/* SQW seconds accounted so far */
+	uint32_t		Entries[POWER_NO_OF_MODES];			/* Number of times each mode was entered */
+	uint32_t		Wakeups[POWER_NO_OF_WAKE_SRC];		/* Number of wake ups per source */
+	uint64_t		Cycles[POWER_NO_OF_MODES];			/* Time spent in each mode, in core cycles */
+}Power_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Power_Init(Power_Handle_t *pPowerHandle);
+uint8_t Power_Idle(Power_Handle_t *pPowerHandle);
+__RAMFUNC void Power_NotifyWake(Power_Handle_t *pPowerHandle, uint8_t WakeSource);
+uint32_t Power_GetResidencyMs(Power_Handle_t *pPowerHandle, uint8_t Mode);
+
+#endif /* POWER_H_ */
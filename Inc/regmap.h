@@ -0,0 +1,102 @@
+/*
+ * regmap.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Register map cache for small register based devices (I2C RTCs, sensors). The device driver
+ * 	  describes its registers once, then reads and writes through RegMap_xxx instead of the bus
+ * 		- Volatile registers (time, flags, ADC results) always go to the bus
+ * 		- Every other register is cacheable. After the first bus read or any write, reads are served
+ * 		  from the cache without a bus transfer
+ * 	- Cache modes
+ * 		- Write through: a write goes to the bus straight away. Cacheable registers whose value does
+ * 		  not change are not written at all
+ * 		- Write back: writes to cacheable registers only update the cache and mark them dirty.
+ * 		  RegMap_Sync() writes them out, contiguous dirty registers as one burst
+ * 	- Reads and writes of a span are split into runs, each run is one bus burst of at most MaxBurst
+ * 	  registers. Cached registers inside a read span are taken from the cache
+ * 	- RegMap_UpdateBits() is a read-modify-write. For a cached register the read costs no bus transfer,
+ * 	  and nothing is written if the value does not change
+ * 	- The bus is reached through pfnRead/pfnWrite with an opaque context, so the cache works for any bus.
+ * 	  Registers at or above NumRegs are treated as volatile
+ * 	- pfnRead/pfnWrite return 0 when the transfer went through. A failed read fills nothing in the cache,
+ * 	  a failed write forgets the registers it covered (the device holds an unknown value), a failed
+ * 	  RegMap_Sync() keeps them dirty. The APIs return REGMAP_ERR_BUS then
+ * 	- RegMap_Invalidate() forgets the cache (after a device reset or power loss). Dirty data is lost
+ * 	- Statistics (REGMAP_STATS = 1): Hits (registers read from the cache), BusReads and BusWrites (bursts)
+ */
+
+#ifndef REGMAP_H_
+#define REGMAP_H_
+
+#include "stm32f407xx.h"
+
+#define REGMAP_STATS					1
+#define REGMAP_MAX_REGS					64
+#define REGMAP_MAP_WORDS				(REGMAP_MAX_REGS / 32)
+
+/*
+ * @REGMAP_CACHE
+ */
+#define REGMAP_CACHE_WRITETHROUGH		0
+#define REGMAP_CACHE_WRITEBACK			1
+
+/*
+ * Return values
+ */
+#define REGMAP_OK						0
+#define REGMAP_ERR_BUS					1
+
+/*
+ * Configuration structure for one register map
+ */
+typedef struct
+{
+	uint8_t			NumRegs;					/* Registers 0 to NumRegs-1 are described, at most REGMAP_MAX_REGS */
+	uint8_t			CacheMode;					/* @REGMAP_CACHE */
+	uint8_t			MaxBurst;					/* Registers per bus transfer */
+	uint32_t		Volatile[REGMAP_MAP_WORDS];	/* Bit n set -> register n is never cached */
+	uint8_t			(*pfnRead)(void *pCtx, uint8_t Reg, uint8_t *pBuf, uint8_t Len);	/* 0 -> OK */
+	uint8_t			(*pfnWrite)(void *pCtx, uint8_t Reg, uint8_t *pBuf, uint8_t Len);	/* 0 -> OK */
+	void			*pCtx;						/* Passed to pfnRead/pfnWrite */
+}RegMap_Config_t;
+
+/*
+ * Handle structure for one register map
+ */
+typedef struct
+{
+	RegMap_Config_t	RegMap_Config;
+	uint8_t			Cache[REGMAP_MAX_REGS];		/* To store the register values */
+	uint32_t		Valid[REGMAP_MAP_WORDS];	/* To store which cache entries hold the device value */
+	uint32_t		Dirty[REGMAP_MAP_WORDS];	/* To store which cache entries are not written yet (write back) */
+	uint32_t		Hits;
+	uint32_t		BusReads;
+	uint32_t		BusWrites;
+}RegMap_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void RegMap_Init(RegMap_Handle_t *pRegMapHandle);
+
+/*
+ * Register access
+ */
+uint8_t RegMap_Read(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+uint8_t RegMap_Write(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+uint8_t RegMap_UpdateBits(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t Mask, uint8_t Value);
+
+/*
+ * Cache control
+ */
+uint8_t RegMap_Sync(RegMap_Handle_t *pRegMapHandle);
+void RegMap_Invalidate(RegMap_Handle_t *pRegMapHandle);
+
+#endif /* REGMAP_H_ */
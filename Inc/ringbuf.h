@@ -0,0 +1,111 @@
+/*
+ * ringbuf.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Ring buffers for ISR <-> thread data paths. Sizes are in elements and must be a power of two,
+ * 	  so wrapping is a mask instead of a division
+ * 	- RingBuf_t is single producer / single consumer (SPSC)
+ * 		- Head is only written by the producer, Tail only by the consumer. No locks, no interrupt masking
+ * 		- Indices run freely and wrap at 2^32. Used = Head - Tail
+ * 		- Reserve/Commit give the producer a contiguous span to fill in place (DMA destination).
+ * 		  Span/Release do the same for the consumer (DMA source). A span never crosses the end of
+ * 		  the storage, so a wrapped region takes two spans
+ * 		- RingBuf_PutWords puts one 8 byte element with two word stores. It runs from RAM and is
+ * 		  meant for ISRs recording fixed size events (eventrec.h)
+ * 	- RingBufMPSC_t is multi producer / single consumer
+ * 		- Any number of ISRs (of any priority) and threads may put at the same time
+ * 		- Every slot has a sequence number. Producers claim a slot with compare and swap on EnqPos
+ * 		  (LDREX/STREX on Cortex M4) and publish it by writing its sequence number. A preempted producer
+ * 		  never blocks another one, the consumer just sees the queue as empty up to the unpublished slot
+ * 		- Element at a time only (no spans)
+ * 	- Statistics (RINGBUF_STATS = 1)
+ * 		- HighWater is the maximum number of elements ever used. It is approximate for MPSC
+ * 		  (concurrent producers may race on the update)
+ * 		- Overflows counts elements rejected because the buffer was full
+ */
+
+#ifndef RINGBUF_H_
+#define RINGBUF_H_
+
+#include "stm32f407xx.h"
+
+#define RINGBUF_STATS					1
+
+/*
+ * Return values
+ */
+#define RINGBUF_OK						0
+#define RINGBUF_ERR_SIZE				1
+#define RINGBUF_ERR_FULL				2
+
+/*
+ * Single producer / single consumer ring buffer
+ */
+typedef struct
+{
+	uint8_t			*pBuf;			/* Storage, Size * ElemSize bytes */
+	uint32_t		Size;			/* Number of elements, power of two */
+	uint32_t		ElemSize;		/* Size of one element in bytes */
+	__vo uint32_t	Head;			/* Next element to write (producer) */
+	__vo uint32_t	Tail;			/* Next element to read (consumer) */
+	__vo uint32_t	HighWater;
+	__vo uint32_t	Overflows;
+}RingBuf_t;
+
+/*
+ * Multi producer / single consumer ring buffer
+ */
+typedef struct
+{
+	uint8_t			*pBuf;			/* Storage, Size * ElemSize bytes */
+	__vo uint32_t	*pSeq;			/* Sequence number per slot, Size words */
+	uint32_t		Size;
+	uint32_t		ElemSize;
+	__vo uint32_t	EnqPos;			/* Next slot to claim (producers) */
+	uint32_t		DeqPos;			/* Next slot to read (consumer) */
+	__vo uint32_t	HighWater;
+	__vo uint32_t	Overflows;
+}RingBufMPSC_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * SPSC
+ */
+uint8_t  RingBuf_Init(RingBuf_t *pRing, void *pStorage, uint32_t Size, uint32_t ElemSize);
+uint32_t RingBuf_Put(RingBuf_t *pRing, const void *pData, uint32_t Count);
+uint32_t RingBuf_Get(RingBuf_t *pRing, void *pData, uint32_t Count);
+uint32_t RingBuf_Used(RingBuf_t *pRing);
+uint32_t RingBuf_Free(RingBuf_t *pRing);
+void	 RingBuf_Flush(RingBuf_t *pRing);
+
+/*
+ * SPSC zero copy
+ */
+void*	 RingBuf_Reserve(RingBuf_t *pRing, uint32_t *pCount);
+void	 RingBuf_Commit(RingBuf_t *pRing, uint32_t Count);
+void*	 RingBuf_Span(RingBuf_t *pRing, uint32_t *pCount);
+void	 RingBuf_Release(RingBuf_t *pRing, uint32_t Count);
+
+/*
+ * SPSC fixed size (ISR)
+ */
+__RAMFUNC uint8_t RingBuf_PutWords(RingBuf_t *pRing, uint32_t Word0, uint32_t Word1);
+
+/*
+ * MPSC
+ */
+uint8_t  RingBufMPSC_Init(RingBufMPSC_t *pRing, void *pStorage, __vo uint32_t *pSeqStorage, uint32_t Size, uint32_t ElemSize);
+uint8_t  RingBufMPSC_Put(RingBufMPSC_t *pRing, const void *pElem);
+uint8_t  RingBufMPSC_Get(RingBufMPSC_t *pRing, void *pElem);
+uint8_t  RingBufMPSC_IsEmpty(RingBufMPSC_t *pRing);
+
+#endif /* RINGBUF_H_ */
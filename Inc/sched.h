@@ -0,0 +1,106 @@
+/*
+ * sched.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Cooperative run to completion scheduler. Tasks are plain functions which run in thread
+ * 	  context and return. Nothing is preempted except by ISRs
+ * 	- ISRs post tasks with Sched_Post(). The queue is a RingBufMPSC_t (see ringbuf.h), so nested
+ * 	  ISRs of different priority may post at the same time without masking interrupts
+ * 	- Timers live in a hierarchical timer wheel
+ * 		- SCHED_WHEEL_LEVELS levels of SCHED_WHEEL_SLOTS slots. Level n slots are 64^n ticks wide
+ * 		- Insert and cancel are O(1) (intrusive doubly linked lists, timers are owned by the caller)
+ * 		- A tick only touches one level 0 slot. Every 64 ticks one slot of the next level is
+ * 		  cascaded down, so each timer is moved at most SCHED_WHEEL_LEVELS-1 times in its life
+ * 		- Delays beyond 2^24 ticks are parked in the last level and re-cascaded until due
+ * 	- The tick source is up to the application. Sched_Tick() is ISR safe (SysTick, SQW EXTI, ...)
+ * 	- When there is no work Sched_Run() calls the idle hook with interrupts masked. The hook must
+ * 	  WFI without unmasking first (Power_Idle does this), otherwise a post can be missed
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include "stm32f407xx.h"
+#include "ringbuf.h"
+
+/*
+ * Sizing. SCHED_QUEUE_SIZE must be a power of two
+ */
+#define SCHED_QUEUE_SIZE				32
+#define SCHED_WHEEL_BITS				6
+#define SCHED_WHEEL_SLOTS				(1 << SCHED_WHEEL_BITS)
+#define SCHED_WHEEL_LEVELS				4
+#define SCHED_MAX_DELAY					((1UL << (SCHED_WHEEL_BITS * SCHED_WHEEL_LEVELS)) - 1)
+
+/*
+ * Return values
+ */
+#define SCHED_OK						0
+#define SCHED_ERR_FULL					1
+
+typedef void (*Sched_Task_t)(void *pArg);
+
+/*
+ * Timer. Owned by the caller, must be zero initialized before the first start and stay valid while it is active
+ */
+typedef struct Sched_Timer
+{
+	struct Sched_Timer	*pNext;
+	struct Sched_Timer	**ppPrev;			/* Address of the pointer which points to this timer. NULL -> not active */
+	uint32_t			Expires;			/* Absolute tick */
+	uint32_t			Period;				/* 0 -> one shot */
+	Sched_Task_t		pfnTask;
+	void				*pArg;
+}Sched_Timer_t;
+
+typedef struct
+{
+	Sched_Task_t		pfnTask;
+	void				*pArg;
+}Sched_Event_t;
+
+/*
+ * Handle structure for the scheduler
+ */
+typedef struct
+{
+	RingBufMPSC_t		Queue;										/* Queue.Overflows counts the posts lost to a full queue */
+	Sched_Event_t		QueueBuf[SCHED_QUEUE_SIZE];
+	__vo uint32_t		QueueSeq[SCHED_QUEUE_SIZE];
+	__vo uint32_t		PendingTicks;								/* To store ticks not processed yet */
+	uint32_t			Now;										/* To store the next tick to be processed */
+	Sched_Timer_t		*Wheel[SCHED_WHEEL_LEVELS][SCHED_WHEEL_SLOTS];
+	void				(*pfnIdle)(void);							/* Called with interrupts masked. NULL -> WFI */
+}Sched_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init and main loop
+ */
+void Sched_Init(Sched_Handle_t *pSchedHandle);
+uint8_t Sched_RunOnce(Sched_Handle_t *pSchedHandle);
+void Sched_Run(Sched_Handle_t *pSchedHandle);
+
+/*
+ * ISR safe
+ */
+uint8_t Sched_Post(Sched_Handle_t *pSchedHandle, Sched_Task_t pfnTask, void *pArg);
+__RAMFUNC void Sched_Tick(Sched_Handle_t *pSchedHandle);
+
+/*
+ * Timers (thread context only)
+ */
+void Sched_TimerStart(Sched_Handle_t *pSchedHandle, Sched_Timer_t *pTimer, uint32_t Delay, uint32_t Period, Sched_Task_t pfnTask, void *pArg);
+void Sched_TimerCancel(Sched_Timer_t *pTimer);
+uint8_t Sched_TimerIsActive(Sched_Timer_t *pTimer);
+
+#endif /* SCHED_H_ */
@@ -0,0 +1,99 @@
+/*
+ * settings.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Persistent application settings in a block of the RTC NVRAM (DS1307: 56 bytes, battery backed).
+ * 	  A warm boot restores them from there. Whether the clock has to be set again comes from the RTC
+ * 	  itself (RTC_IsTimeLost)
+ * 	- Block layout, multi byte fields LSB first
+ * 		|Magic|Version|Len|Payload (Len bytes)|CRC32 (4 bytes)|		CRC-32 (crc.h) over Magic to Payload
+ * 		Payload		|Timezone (2)|Time format|Drift PPB (4)|Display flags|Refresh seconds|
+ * 	- Fields are only ever appended to the payload. A block with a shorter payload (older firmware)
+ * 	  loads the fields it has, the rest keep their defaults. Version changes only for layout changes
+ * 	  which are not compatible, a block of another version is ignored
+ * 	- Settings_Load() reads the whole block in one burst. On any error the defaults are loaded and
+ * 	  the error is returned, so the caller knows to do a cold boot
+ * 	- Settings_Save() goes through the write through register cache of the RTC (regmap.h), bytes
+ * 	  which did not change are not written
+ */
+
+#ifndef SETTINGS_H_
+#define SETTINGS_H_
+
+#include "stm32f407xx.h"
+#include "rtc.h"
+
+#define SETTINGS_MAGIC					0xC5
+#define SETTINGS_VERSION				2			/* 2: CRC-32 instead of CRC16 */
+#define SETTINGS_HEADER_LEN				3
+#define SETTINGS_PAYLOAD_LEN			9
+#define SETTINGS_CRC_LEN				4
+#define SETTINGS_BLOCK_LEN				(SETTINGS_HEADER_LEN + SETTINGS_PAYLOAD_LEN + SETTINGS_CRC_LEN)
+
+/*
+ * @SETTINGS_DISPLAY
+ */
+#define SETTINGS_DISPLAY_DATE			(1 << 0)
+#define SETTINGS_DISPLAY_WEEKDAY		(1 << 1)
+
+/*
+ * Defaults (cold boot)
+ */
+#define SETTINGS_DEFAULT_TIMEZONE		0
+#define SETTINGS_DEFAULT_TIME_FORMAT	RTC_TIME_FORMAT_12HRS_PM
+#define SETTINGS_DEFAULT_DISPLAY		(SETTINGS_DISPLAY_DATE | SETTINGS_DISPLAY_WEEKDAY)
+#define SETTINGS_DEFAULT_REFRESH		1
+
+/*
+ * Return values
+ */
+#define SETTINGS_OK						0
+#define SETTINGS_ERR_BUS				1			/* NVRAM not readable / writable */
+#define SETTINGS_ERR_MAGIC				2			/* No block (fresh NVRAM) or other version */
+#define SETTINGS_ERR_CRC				3
+
+/*
+ * Settings
+ */
+typedef struct
+{
+	int16_t			TimezoneMin;		/* Local time offset from UTC in minutes, the RTC keeps local time */
+	uint8_t			TimeFormat;			/* @RTC_TIME_FORMAT used when the clock is set */
+	int32_t			DriftPPB;			/* RTC crystal error, positive if the RTC runs fast */
+	uint8_t			DisplayFlags;		/* @SETTINGS_DISPLAY */
+	uint8_t			RefreshSeconds;		/* Display refresh period */
+}Settings_t;
+
+/*
+ * Configuration structure for the settings store
+ */
+typedef struct
+{
+	RTC_Handle_t	*pRTCHandle;
+	uint8_t			Offset;				/* Start of the block in the RTC NVRAM */
+}Settings_Config_t;
+
+/*
+ * Handle structure for the settings store
+ */
+typedef struct
+{
+	Settings_Config_t	Settings_Config;
+	Settings_t			Settings;			/* To store the current settings */
+}Settings_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Settings_Default(Settings_t *pSettings);
+uint8_t Settings_Load(Settings_Handle_t *pSetHandle);
+uint8_t Settings_Save(Settings_Handle_t *pSetHandle);
+
+#endif /* SETTINGS_H_ */
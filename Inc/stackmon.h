@@ -0,0 +1,73 @@
+/*
+ * stackmon.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Stack high-water mark by paint and scan
+ * 		- Reset_Handler paints the MSP stack [_sstack, _estack) with STACKMON_PAINT before anything runs
+ * 		- StackMon_Scan() checks a few words per call (idle time) from the bottom of the stack upwards.
+ * 		  The first word which is not paint is the deepest point the stack has reached. Since the mark
+ * 		  only moves down, a scan pass only covers the words below the current mark
+ * 	- An MPU region of STACKMON_GUARD_SIZE bytes below the stack is made no access, so an overflow
+ * 	  faults (HardFault) instead of silently corrupting the CCM data below it
+ * 	- The heap high-water mark comes from the fixed-block pools (mempool.c)
+ * 	- The stack bounds are passed in StackMon_Config, so the same code runs against any memory map.
+ * 	  Use StackMon_Paint() for stacks which are not painted by the startup code
+ */
+
+#ifndef STACKMON_H_
+#define STACKMON_H_
+
+#include "stm32f407xx.h"
+
+#define STACKMON_PAINT					0xC5C5C5C5UL		/* Must match Reset_Handler */
+#define STACKMON_GUARD_SIZE				32					/* Power of two, at least 32 */
+#define STACKMON_GUARD_REGION			7					/* Highest priority MPU region */
+
+/*
+ * Linker script symbols of the MSP stack
+ */
+extern uint32_t _sstack;
+extern uint32_t _estack;
+
+/*
+ * Configuration structure for the stack monitor
+ */
+typedef struct
+{
+	uint32_t		*pBottom;			/* Lowest word of the stack */
+	uint32_t		*pTop;				/* One past the highest word of the stack */
+	uint8_t			Guard;				/* ENABLE -> arm the MPU guard below pBottom */
+}StackMon_Config_t;
+
+/*
+ * Handle structure for the stack monitor
+ */
+typedef struct
+{
+	StackMon_Config_t	StackMon_Config;
+	uint32_t			*pMark;			/* To store the deepest word found in use */
+	uint32_t			*pScan;			/* To store the next word to check */
+}StackMon_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void StackMon_Init(StackMon_Handle_t *pStackMonHandle);
+void StackMon_Paint(StackMon_Handle_t *pStackMonHandle);
+uint8_t StackMon_Scan(StackMon_Handle_t *pStackMonHandle, uint32_t MaxWords);
+
+/*
+ * Reporting
+ */
+uint32_t StackMon_GetSize(StackMon_Handle_t *pStackMonHandle);
+uint32_t StackMon_GetHighWater(StackMon_Handle_t *pStackMonHandle);
+uint32_t StackMon_GetHeapHighWater(void);
+
+#endif /* STACKMON_H_ */
@@ -0,0 +1,126 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Binary replacement for the printf based logging. Every record is sent as one frame
+ * 	- Frame before encoding
+ * 		|Type|Seq|Payload ....|CRC32 (4 bytes LSB first)|
+ * 		- Seq is incremented on every frame so the collector can detect lost frames
+ * 		- CRC32 is the CRC-32 of crc.h (poly 0x04C11DB7, init 0xFFFFFFFF, little endian words, last word
+ * 		  zero padded) over Type, Seq and Payload
+ * 	- The frame is COBS encoded and terminated with 0x00. 0x00 never occurs inside an encoded frame,
+ * 	  so the collector can resynchronize on the next 0x00 after a corrupted byte
+ * 	- All integers in the payload are unsigned LEB128 varints (7 bits per byte, LSB group first)
+ * 	- Timestamps are seconds since 01/01/00 00:00:00 (see RTC_toEpoch)
+ * 		- The first timestamp and every TLM_TIMESTAMP_ABS_INTERVAL-th one after it are absolute
+ * 		- The rest are zigzag encoded deltas from the previous timestamp (1 byte for deltas up to +-63s)
+ *
+ * Payload layout for each record type
+ * 	TLM_REC_TIMESTAMP	|Flags|Varint timestamp or zigzag delta|		Flags bit0 -> absolute
+ * 	TLM_REC_I2C_ERRORS	|Bus|Varint BERR|ARLO|AF|OVR|TIMEOUT|			Bus -> 1,2,3 for I2C1,I2C2,I2C3
+ * 	TLM_REC_HISTOGRAM	|Id|NoOfBins|Varint Bin0|Bin1|.....|
+ * 	TLM_REC_EVENTS		|Varint Dropped|Varint Seconds|NoOfEvents|Event0|Event1|.....|
+ * 		Event			|Line|Varint seconds after Seconds|Varint Micros|		Line bit7 -> pin level after the edge
+ * 		Dropped is the number of events lost since the previous TLM_REC_EVENTS record (see eventrec.h)
+ * 	- The frame is built in the handle, not on the stack of the caller (two ~100 byte buffers at the
+ * 	  bottom of the deepest call chains). A sink may hand Frame to a DMA stream, so the firmware places
+ * 	  the handle with __DMA_RAM
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Record types
+ */
+#define TLM_REC_TIMESTAMP				0x01
+#define TLM_REC_I2C_ERRORS				0x02
+#define TLM_REC_HISTOGRAM				0x03
+#define TLM_REC_EVENTS					0x04
+
+/*
+ * TLM_REC_TIMESTAMP flags
+ */
+#define TLM_TIMESTAMP_FLAG_ABS			(1 << 0)
+
+/*
+ * TLM_REC_EVENTS line byte flags
+ */
+#define TLM_EVENT_LEVEL					(1 << 7)
+
+/*
+ * Sizing
+ */
+#define TLM_MAX_PAYLOAD					96
+#define TLM_HIST_MAX_BINS				16
+#define TLM_TIMESTAMP_ABS_INTERVAL		16
+#define TLM_EVENTS_MAX					9
+#define TLM_MAX_RAW_FRAME				(TLM_MAX_PAYLOAD + 6)
+#define TLM_MAX_ENCODED_FRAME			(TLM_MAX_RAW_FRAME + (TLM_MAX_RAW_FRAME / 254) + 2)
+
+/*
+ * Return values
+ */
+#define TLM_OK							0
+#define TLM_ERR_TOO_LONG				1
+
+/*
+ * Sink which receives every complete encoded frame (including the 0x00 delimiter)
+ */
+typedef void (*Telemetry_Sink_t)(void *pCtx, const uint8_t *pData, uint32_t len);
+
+/*
+ * Handle structure for a telemetry stream
+ */
+typedef struct
+{
+	Telemetry_Sink_t	pfnSink;			/* Frame sink (Telemetry_SinkITM, Telemetry_SinkUSART or application) */
+	void				*pSinkCtx;			/* Passed as is to the sink. USART_Handle_t* for Telemetry_SinkUSART */
+	uint32_t			LastTimestamp;		/* To store the previous timestamp for delta encoding */
+	uint8_t				TimestampCount;		/* To store timestamps sent since the last absolute one */
+	uint8_t				Seq;				/* To store the sequence number of the next frame */
+	uint32_t			FramesSent;			/* To store the number of frames sent */
+	uint32_t			BytesSent;			/* To store the number of encoded bytes sent */
+	uint8_t				Raw[TLM_MAX_RAW_FRAME];			/* To store the frame being built */
+	uint8_t				Frame[TLM_MAX_ENCODED_FRAME];	/* To store the encoded frame handed to the sink */
+}Telemetry_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init
+ */
+void Telemetry_Init(Telemetry_Handle_t *pTlmHandle, Telemetry_Sink_t pfnSink, void *pSinkCtx);
+
+/*
+ * Records
+ */
+uint8_t Telemetry_PutTimestamp(Telemetry_Handle_t *pTlmHandle, uint32_t timestamp);
+uint8_t Telemetry_PutI2CErrors(Telemetry_Handle_t *pTlmHandle, I2C_Handle_t *pI2CHandle);
+uint8_t Telemetry_PutHistogram(Telemetry_Handle_t *pTlmHandle, uint8_t id, const uint32_t *pBins, uint8_t noOfBins);
+uint8_t Telemetry_PutRecord(Telemetry_Handle_t *pTlmHandle, uint8_t type, const uint8_t *pPayload, uint32_t len);
+
+/*
+ * Encoding helpers
+ */
+uint32_t Telemetry_PutVarint(uint8_t *pBuf, uint32_t value);
+uint32_t Telemetry_COBSEncode(const uint8_t *pIn, uint32_t len, uint8_t *pOut);
+uint32_t Telemetry_CRC32(const uint8_t *pData, uint32_t len);
+
+/*
+ * Sinks
+ */
+void Telemetry_SinkITM(void *pCtx, const uint8_t *pData, uint32_t len);
+void Telemetry_SinkUSART(void *pCtx, const uint8_t *pData, uint32_t len);
+
+#endif /* TELEMETRY_H_ */
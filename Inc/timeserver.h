@@ -0,0 +1,102 @@
+/*
+ * timeserver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Makes the board an I2C slave answering like a DS1307 (address 0x68), so other boards read the
+ * 	  disciplined time (timesync.h, trim.h) with their plain DS1307 driver
+ * 	- Register map as the DS1307
+ * 		0x00 - 0x06		seconds .. year, BCD, 24h, CH = 0. Read only, writes are counted in RejectedWrites
+ * 		0x07			control, kept but no square wave is output
+ * 		0x08 - 0x3F		56 bytes RAM, read / write (not battery backed)
+ * 	  A write sets the register pointer with its first byte, a read continues from the pointer. The
+ * 	  pointer auto-increments and wraps from 0x3F to 0x00
+ * 	- Everything runs in the I2C event / error ISR (I2C_EV_IRQHandling, I2C_ER_IRQHandling) through
+ * 	  the driver callback, the application routes I2C_ApplicationEventCallback() to TimeServer_EventHandling().
+ * 	  The SCL clock is stretched while the ISR is pending
+ * 	- Like the DS1307 the time is latched at the start of a transfer (address match), a burst read never
+ * 	  sees a rollover between its registers
+ * 	- TimeServer_Publish() (thread, once per second) encodes the registers of the current second and
+ * 	  of the next one and remembers the timestamp timer time where the current second started. The ISR
+ * 	  picks the set with Timestamp_Get(), so the served seconds roll over on the software clock boundary
+ * 	  and not at the publish. Published state lives in two slots and a generation counter as in
+ * 	  timestamp.h: the ISR never waits for the thread and never sees a half written slot
+ * 	- The seconds read 0x80 (clock halted) until the first publish
+ * 	- A master read is ended with a NACK. If the ISR had loaded the next byte into DR already (TXE
+ * 	  clear after the DR write and still clear at the NACK), that byte was never sent and the pointer is
+ * 	  moved back. An ISR late enough to see the NACK with the STOP, TXE cleared by it, had loaded nothing
+ * 	  ahead and leaves the pointer alone, as does a TXE after the NACK. The driver counts these NACKs in
+ * 	  ErrCount[I2C_ERRCNT_AF]
+ */
+
+#ifndef TIMESERVER_H_
+#define TIMESERVER_H_
+
+#include "stm32f407xx.h"
+#include "timestamp.h"
+
+#define TIMESERVER_DEFAULT_ADDRESS		0x68		/* DS1307 */
+#define TIMESERVER_NO_OF_REGS			64
+#define TIMESERVER_NO_OF_TIME_REGS		7
+#define TIMESERVER_REG_CONTROL			0x07
+#define TIMESERVER_REG_SECONDS_CH		7			/* Clock halt bit of the seconds register */
+
+/*
+ * Published time, written by TimeServer_Publish only
+ */
+typedef struct
+{
+	int64_t			PivotUs;			/* Timestamp time the current second started at, microseconds */
+	uint8_t			Regs[2][TIMESERVER_NO_OF_TIME_REGS];	/* Registers 0x00 - 0x06 of that second and the next */
+}TimeServer_Slot_t;
+
+/*
+ * Configuration structure for the time server
+ */
+typedef struct
+{
+	I2C_RegDef_t		*pI2Cx;				/* Free I2C peripheral, not the one of the RTC */
+	GPIO_RegDef_t		*pSCLPort;
+	uint8_t				SCLPin;
+	GPIO_RegDef_t		*pSDAPort;
+	uint8_t				SDAPin;
+	uint8_t				Address;			/* 7 bit, 0 -> TIMESERVER_DEFAULT_ADDRESS */
+	uint8_t				EVIRQNumber;
+	uint8_t				ERIRQNumber;
+	uint8_t				IRQPriority;
+	Timestamp_Handle_t	*pTsHandle;
+}TimeServer_Config_t;
+
+/*
+ * Handle structure for the time server
+ */
+typedef struct
+{
+	TimeServer_Config_t	TimeServer_Config;
+	I2C_Handle_t		I2CHandle;
+	TimeServer_Slot_t	Slot[2];			/* To store the published time, Slot[Gen & 1] is current */
+	__vo uint32_t		Gen;				/* To store the number of publishes */
+	uint8_t				Regs[TIMESERVER_NO_OF_REGS];	/* To store the register map, time latched per transfer (ISR) */
+	uint8_t				Pointer;			/* To store the register pointer (ISR) */
+	uint8_t				PointerNext;		/* To store if the next byte received sets the pointer (ISR) */
+	uint8_t				Preloaded;			/* To store if a byte was loaded after the one on the bus (ISR) */
+	uint8_t				Nacked;				/* To store if the master ended the read transfer (ISR) */
+	uint32_t			Reads;				/* To store the number of read transfers (ISR) */
+	uint32_t			Writes;				/* To store the number of write transfers (ISR) */
+	uint32_t			RejectedWrites;		/* To store the number of bytes written to the time registers (ISR) */
+}TimeServer_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void TimeServer_Init(TimeServer_Handle_t *pServerHandle);
+void TimeServer_Publish(TimeServer_Handle_t *pServerHandle, const Timestamp_t *pNow);
+__RAMFUNC void TimeServer_EventHandling(TimeServer_Handle_t *pServerHandle, uint8_t AppEv);
+
+#endif /* TIMESERVER_H_ */
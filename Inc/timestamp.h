@@ -0,0 +1,100 @@
+/*
+ * timestamp.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Microsecond timestamps from the RTC seconds and a free running 32 bit timer (TIM2 or TIM5)
+ * 		- The SQW ISR calls Timestamp_Edge() first thing, which latches the timer count of the edge
+ * 		- A stamp is the RTC second of the last edge plus the timer ticks since that edge, converted
+ * 		  to microseconds with the measured length of an RTC second
+ * 	- The length of a second in timer ticks is measured on every edge and low pass filtered
+ * 	  (TIMESTAMP_FILTER_SHIFT), so the MCU clock error against the RTC crystal (HSI is only +-1%) is
+ * 	  corrected continuously. Edges more than 1/TIMESTAMP_TOLERANCE_DIV off the nominal second (missed
+ * 	  edges, timer stopped) only re-latch the phase and are counted in Rejected
+ * 	- Timestamp_Get() does no I2C traffic: a few loads, one timer read and one 32x32 multiply. It can be
+ * 	  called from any context. The edge ISR publishes its state in one of two slots and then bumps Gen,
+ * 	  a reader retries if Gen changed under it, so a reader which preempts the edge ISR still sees the
+ * 	  previous, consistent slot (no spinning like a plain seqlock would)
+ * 	- A stamp taken after an edge but before its ISR ran would read as >= 1s past the previous edge.
+ * 	  Up to TIMESTAMP_LATE_US past the second it is held at 999999us so stamps never go backwards,
+ * 	  beyond that (edges missed) it carries into the seconds
+ * 	- The timer does not count in STOP mode. Use Sleep as the idle mode when stamps are needed
+ * 	- ISR latency between the edge and the latch shows up as jitter of the phase (a few us at 16MHz)
+ * 	- Call Timestamp_Sync() with the RTC time read right after an edge (from a scheduler task) to set
+ * 	  the seconds, and again whenever the RTC time is set
+ * 	- ISRs on a tight budget can latch the raw timer count (Timestamp_GetCount) and convert it later
+ * 	  with Timestamp_FromCount(), as long as that is within +-2^31 timer ticks of the last edge
+ * 	  (134s at 16MHz)
+ */
+
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+#include "stm32f407xx.h"
+
+#define TIMESTAMP_FILTER_SHIFT			3			/* Period filter time constant, 2^n seconds */
+#define TIMESTAMP_TOLERANCE_DIV			50			/* Accept edges within +-2% of the nominal second */
+#define TIMESTAMP_LATE_US				2000		/* Late edge window, see notes */
+
+#define Timestamp_GetCount(pTsHandle)	((pTsHandle)->Timestamp_Config.pTIMx->CNT)
+
+/*
+ * Timestamp, RTC epoch second (see RTC_toEpoch) and microseconds into it
+ */
+typedef struct
+{
+	uint32_t		Seconds;
+	uint32_t		Micros;
+}Timestamp_t;
+
+/*
+ * State of the last edge, written by the edge ISR only
+ */
+typedef struct
+{
+	uint32_t		Edge;				/* Edge count */
+	uint32_t		Stamp;				/* Timer count at the edge */
+	uint32_t		Scale;				/* Microseconds per timer tick, Q32 */
+}Timestamp_Edge_t;
+
+/*
+ * Configuration structure for the timestamp service
+ */
+typedef struct
+{
+	TIM_RegDef_t	*pTIMx;				/* TIM2 or TIM5 (32 bit counters) */
+	uint32_t		TimerClockHz;		/* Nominal timer clock, at least 2MHz */
+}Timestamp_Config_t;
+
+/*
+ * Handle structure for the timestamp service
+ */
+typedef struct
+{
+	Timestamp_Config_t	Timestamp_Config;
+	Timestamp_Edge_t	Slot[2];			/* To store the published edge state, Slot[Gen & 1] is current */
+	__vo uint32_t		Gen;				/* To store the number of publishes */
+	__vo uint32_t		Offset;				/* To store the RTC epoch second of edge 0 */
+	uint64_t			PeriodQ8;			/* To store the filtered second length in timer ticks, Q8 */
+	uint32_t			Edges;				/* To store the number of edges seen */
+	uint32_t			Rejected;			/* To store the number of edges outside the tolerance */
+}Timestamp_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Timestamp_Init(Timestamp_Handle_t *pTsHandle);
+__RAMFUNC void Timestamp_Edge(Timestamp_Handle_t *pTsHandle);
+void Timestamp_Sync(Timestamp_Handle_t *pTsHandle, uint32_t Epoch);
+__RAMFUNC void Timestamp_Get(Timestamp_Handle_t *pTsHandle, Timestamp_t *pStamp);
+void Timestamp_FromCount(Timestamp_Handle_t *pTsHandle, uint32_t Count, Timestamp_t *pStamp);
+void Timestamp_GetEdge(Timestamp_Handle_t *pTsHandle, uint32_t *pEdge, uint32_t *pStamp);
+int32_t Timestamp_GetDriftPPB(Timestamp_Handle_t *pTsHandle);
+
+#endif /* TIMESTAMP_H_ */
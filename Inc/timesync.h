@@ -0,0 +1,155 @@
+/*
+ * timesync.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Sets the clock from a host over a USART (tools/timesync/ts_server.c is the host side)
+ * 	- Exchange, the device asks and the host answers (four timestamps as in NTP)
+ * 		T1	device, request sent			T2	host, request received
+ * 		T3	host, reply sent				T4	device, reply received (latched in the RX ISR)
+ * 		offset = ((T2 - T1) + (T3 - T4)) / 2		delay = (T4 - T1) - (T3 - T2)
+ * 	  T1 and T4 come from the software clock (below) with microsecond resolution. Request and reply have
+ * 	  the same length, so the time on the wire cancels out of the offset. Of TIMESYNC_BURST exchanges the
+ * 	  one with the smallest delay is used (queueing on the host side only ever adds delay). Exchanges
+ * 	  with a delay above MaxDelayUs are dropped
+ * 	- Frames use the telemetry framing (telemetry.h): |Type|Seq|Payload|CRC32|, COBS encoded, 0x00 delimited.
+ * 	  Times are |Seconds (4)|Micros (4)|, LSB first, seconds since 01/01/00 00:00:00 (RTC_toEpoch)
+ * 		TIMESYNC_MSG_REQUEST	|T1|Padding (16 bytes 0)|
+ * 		TIMESYNC_MSG_REPLY		|T1 echoed|T2|T3|
+ * 	- Software clock = timestamp service (RTC seconds + timer, timestamp.h) + correction. An offset
+ * 	  forward of StepThresholdUs or more is stepped, anything else is slewed at SlewPPM, so the clock
+ * 	  never jumps backwards. TimeSync_Get() also holds the last value it returned when the RTC time below
+ * 	  it moves back (trim steps), the time it returns is monotonic. The one exception is an offset more
+ * 	  than TIMESYNC_MAX_SLEW_US back (a clock set wrong, not drift), it is stepped
+ * 	- Once the correction is in, the DS1307 is written with a single burst at a second boundary of the
+ * 	  software clock, WriteLeadUs before it (time on the bus until the seconds register is written,
+ * 	  which restarts the DS1307 divider). The busy wait for the boundary takes up to one second. After
+ * 	  the next SQW edge the timestamp service is resynced and the correction drops back to 0.
+ * 	  Corrections below TIMESYNC_COMMIT_MIN_US stay in the software clock
+ * 	- The offset is only as symmetric as the host. USB serial adapters buffer received bytes for
+ * 	  several ms (FTDI latency timer), set them to low latency on the host
+ * 	- The application USART ISR calls TimeSync_IRQHandling(). Only RXNE is used, the requests are sent
+ * 	  blocking from TimeSync_Poll()
+ * 	- TimeSync_Poll() runs once per SQW tick (scheduler task), one exchange per call. Thread context
+ */
+
+#ifndef TIMESYNC_H_
+#define TIMESYNC_H_
+
+#include "stm32f407xx.h"
+#include "rtc.h"
+#include "timestamp.h"
+
+/*
+ * Message types, next to the TLM_REC types on the same link
+ */
+#define TIMESYNC_MSG_REQUEST			0x10
+#define TIMESYNC_MSG_REPLY				0x11
+
+#define TIMESYNC_TIME_LEN				8
+#define TIMESYNC_PAYLOAD_LEN			(3 * TIMESYNC_TIME_LEN)
+#define TIMESYNC_RAW_FRAME				(2 + TIMESYNC_PAYLOAD_LEN + 4)
+#define TIMESYNC_MAX_FRAME				(TIMESYNC_RAW_FRAME + 2)		/* Encoded, without the delimiter */
+
+#define TIMESYNC_BURST					4			/* Exchanges per sync */
+#define TIMESYNC_REPLY_TIMEOUT			2			/* Polls */
+#define TIMESYNC_DEFAULT_STEP_US		500000
+#define TIMESYNC_DEFAULT_SLEW_PPM		20000		/* 20ms per second, 1s is slewed in 50s */
+#define TIMESYNC_DEFAULT_MAX_DELAY_US	50000
+#define TIMESYNC_DEFAULT_WRITE_LEAD_US	300			/* Address, register and seconds byte at 100kHz */
+#define TIMESYNC_MAX_SLEW_US			60000000LL	/* Offsets further back are stepped */
+#define TIMESYNC_COMMIT_MIN_US			2000		/* Smaller corrections stay in the software clock */
+
+/*
+ * @TIMESYNC_EVENT, returned by TimeSync_Poll
+ */
+#define TIMESYNC_EV_SYNCED				(1 << 0)	/* Offset measured and applied */
+#define TIMESYNC_EV_COMMITTED			(1 << 1)	/* RTC written, resync whatever counts RTC seconds */
+
+/*
+ * @TIMESYNC_STATE
+ */
+#define TIMESYNC_STATE_IDLE				0			/* No burst running */
+#define TIMESYNC_STATE_SEND				1			/* Burst running, next request at the next poll */
+#define TIMESYNC_STATE_WAIT_REPLY		2
+
+/*
+ * Configuration structure for the time sync client
+ */
+typedef struct
+{
+	USART_Handle_t		*pUSARTHandle;		/* Initialised 8 bit USART, TX and RX */
+	uint8_t				IRQNumber;			/* IRQ of the USART */
+	uint8_t				IRQPriority;
+	Timestamp_Handle_t	*pTsHandle;
+	RTC_Handle_t		*pRTCHandle;
+	uint8_t				TimeFormat;			/* @RTC_TIME_FORMAT the RTC is written in */
+	uint32_t			SyncPeriod;			/* Polls between syncs, 0 -> only TimeSync_Start() */
+	uint32_t			StepThresholdUs;	/* 0 -> TIMESYNC_DEFAULT_STEP_US */
+	uint32_t			SlewPPM;			/* 0 -> TIMESYNC_DEFAULT_SLEW_PPM */
+	uint32_t			MaxDelayUs;			/* 0 -> TIMESYNC_DEFAULT_MAX_DELAY_US */
+	uint32_t			WriteLeadUs;		/* 0 -> TIMESYNC_DEFAULT_WRITE_LEAD_US */
+}TimeSync_Config_t;
+
+/*
+ * Handle structure for the time sync client
+ */
+typedef struct
+{
+	TimeSync_Config_t	TimeSync_Config;
+	uint8_t				RxBuf[TIMESYNC_MAX_FRAME];	/* To store the frame being received (ISR) */
+	__vo uint32_t		RxLen;				/* To store the bytes in RxBuf (ISR) */
+	__vo uint8_t		RxReady;			/* To store if RxBuf holds a complete frame (ISR) */
+	uint8_t				RxDiscard;			/* To store if the frame is dropped till the next delimiter (ISR) */
+	__vo uint32_t		RxEndCount;			/* To store the timer count at the frame delimiter (ISR) */
+	uint8_t				State;				/* To store the @TIMESYNC_STATE */
+	uint8_t				Seq;				/* To store the sequence number of the last request */
+	uint8_t				Exchanges;			/* To store the exchanges started in this burst */
+	uint8_t				Timer;				/* To store the polls left for the reply */
+	uint32_t			Countdown;			/* To store the polls till the next sync */
+	int64_t				T1;					/* To store the software time of the last request */
+	int64_t				BestDelayUs;		/* To store the smallest delay of this burst */
+	int64_t				BestOffsetUs;		/* To store the offset of that exchange */
+	uint8_t				Samples;			/* To store the usable exchanges of this burst */
+	int64_t				CorrUs;				/* To store the correction applied to the timestamp service */
+	int64_t				SlewUs;				/* To store the correction being slewed in */
+	int64_t				SlewStartUs;		/* To store the timestamp time the slew started at */
+	uint8_t				Slewing;			/* To store if a slew is running */
+	uint8_t				CommitDue;			/* To store if the RTC has to be written (correction complete) */
+	uint8_t				CommitPending;		/* To store if the RTC was written and the next edge is awaited */
+	uint32_t			CommitEdge;			/* To store the edge count at the write */
+	uint32_t			CommitEpoch;		/* To store the second written */
+	int64_t				LastUs;				/* To store the last time returned, monotonic */
+	int64_t				LastOffsetUs;		/* To store the offset of the last sync */
+	int64_t				LastDelayUs;		/* To store the delay of the last sync */
+	uint32_t			Syncs;				/* To store the number of syncs applied */
+	uint32_t			Steps;				/* To store the number of offsets stepped instead of slewed */
+	uint32_t			Timeouts;			/* To store the number of exchanges without a reply */
+	uint32_t			BusErrors;			/* To store the number of failed RTC writes */
+	uint32_t			BadFrames;			/* To store the number of frames with a bad CRC, length or sequence */
+	uint32_t			Overruns;			/* To store the number of frames lost because RxBuf was full (ISR) */
+}TimeSync_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init and ISR
+ */
+void TimeSync_Init(TimeSync_Handle_t *pSyncHandle);
+__RAMFUNC void TimeSync_IRQHandling(TimeSync_Handle_t *pSyncHandle);
+
+/*
+ * Thread context
+ */
+void TimeSync_Start(TimeSync_Handle_t *pSyncHandle);
+uint8_t TimeSync_Poll(TimeSync_Handle_t *pSyncHandle);
+void TimeSync_Get(TimeSync_Handle_t *pSyncHandle, Timestamp_t *pStamp);
+
+#endif /* TIMESYNC_H_ */
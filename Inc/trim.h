@@ -0,0 +1,105 @@
+/*
+ * trim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Software trim for RTCs without a trim register (DS1307). Measures the RTC crystal error against the
+ * 	  timestamp timer (timestamp.h) and steps the RTC time by one second whenever the error adds up to
+ * 	  half a second
+ * 	- The measurement is only as good as the timer clock. Clock the timer from the HSE crystal, against
+ * 	  HSI (+-1%) the fit never gets inside TRIM_MAX_PPB and nothing is applied
+ * 	- Measurement: Trim_Poll() takes the edge count and the timer stamp of the last SQW edge
+ * 	  (Timestamp_GetEdge). Every WindowSeconds edges it adds one point to a least-squares line fit
+ * 		x = RTC seconds (edges), y = timer ticks - x * ReferenceHz
+ * 	  The slope is the deviation of the RTC second from the nominal one in timer ticks. Over a window of
+ * 	  64s the ISR jitter of the edges is a few ppb of the window
+ * 	- The fit is recursive with exponential forgetting (memory 2^TRIM_FORGET_SHIFT points, 8.5 min with
+ * 	  the default window), so it follows the crystal over temperature. The slope of a line fit weights
+ * 	  the oldest points most, a memory of an hour still lagged a 20C change by ppm two hours later
+ * 	  (tools/trim). It keeps the weighted means and the centered sums relative to the newest point,
+ * 	  every sum stays bounded and fits 64 bit integers
+ * 	- Intervals which can not be measured (missed edges, timer stopped, an RTC step moving the edge
+ * 	  phase) are bridged with the current slope instead of restarting the fit
+ * 	- The estimate counts as converged after TRIM_MIN_POINTS points when two in a row agree within
+ * 	  TRIM_STABLE_PPB. From then on the applied drift follows the fit. Until then InitialPPB (the value
+ * 	  kept in the settings NVRAM, settings.h) is applied
+ * 	- Correction: the applied drift times the RTC seconds since the last step is how far the RTC is
+ * 	  ahead. At +-TRIM_STEP_THRESHOLD_NS Trim_Poll() reads the time, moves it by one second and writes
+ * 	  it back, right after an edge so the write does not race a rollover. Writing the seconds restarts
+ * 	  the DS1307 divider, the phase moves by the write latency (~1ms). The caller resyncs everything
+ * 	  which counts RTC seconds (Timestamp_Sync, Alarm_Resync, DualClock_Resync)
+ * 	- After the time was set from a reference (timesync.h) Trim_NotifyTimeSet() restarts the error count
+ * 	- Thread context, call once per SQW tick or at least every 2^32 timer ticks (268s at 16MHz)
+ */
+
+#ifndef TRIM_H_
+#define TRIM_H_
+
+#include "stm32f407xx.h"
+#include "rtc.h"
+#include "timestamp.h"
+
+#define TRIM_DEFAULT_WINDOW				64			/* RTC seconds per fit point */
+#define TRIM_FORGET_SHIFT				3			/* Forgetting factor 1 - 2^-n per point */
+#define TRIM_MIN_POINTS					8
+#define TRIM_STABLE_PPB					20			/* Two estimates in a row this close -> converged */
+#define TRIM_MAX_PPB					500000		/* Larger estimates are not applied (reference is not a crystal) */
+#define TRIM_STEP_THRESHOLD_NS			500000000LL
+#define TRIM_TOLERANCE_DIV				50			/* Intervals more than 2% off the nominal are bridged */
+
+/*
+ * Configuration structure for the trim engine
+ */
+typedef struct
+{
+	Timestamp_Handle_t	*pTsHandle;			/* Timer measuring the SQW edges */
+	RTC_Handle_t		*pRTCHandle;		/* RTC to step */
+	uint32_t			ReferenceHz;		/* Timer clock, from a crystal */
+	uint32_t			WindowSeconds;		/* 0 -> TRIM_DEFAULT_WINDOW */
+	uint8_t				Measure;			/* ENABLE: fit the drift, DISABLE: only apply InitialPPB */
+	int32_t				InitialPPB;			/* Drift applied until the fit converges, positive if the RTC runs fast */
+}Trim_Config_t;
+
+/*
+ * Handle structure for the trim engine
+ */
+typedef struct
+{
+	Trim_Config_t		Trim_Config;
+	uint32_t			LastEdge;			/* To store the edge count at the last poll */
+	uint32_t			LastStamp;			/* To store the timer stamp of that edge */
+	int64_t				X;					/* To store the RTC seconds since the last fit point */
+	int64_t				Y;					/* To store the tick deviation since the last fit point */
+	uint8_t				Bridge;				/* To store if the next interval is bridged */
+	int64_t				SumW;				/* To store the fit weight, Q8 */
+	int64_t				MeanX;				/* To store the weighted mean of x, newest point = 0, Q8 seconds */
+	int64_t				MeanY;				/* To store the weighted mean of y, newest point = 0, Q8 ticks */
+	int64_t				Cxx;				/* To store the centered sum of x*x */
+	int64_t				Cxy;				/* To store the centered sum of x*y */
+	int64_t				SlopeQ8;			/* To store the fitted tick deviation per RTC second, Q8 */
+	uint32_t			Points;				/* To store the number of fit points */
+	uint32_t			Bridged;			/* To store the number of bridged intervals */
+	int32_t				FitPPB;				/* To store the last fitted drift */
+	uint8_t				Converged;			/* To store if the fit is applied */
+	int32_t				DriftPPB;			/* To store the drift applied */
+	int64_t				AheadNs;			/* To store how far the RTC is ahead since the last step */
+	uint32_t			Steps;				/* To store the number of one second steps */
+	uint32_t			BusErrors;			/* To store the number of failed steps */
+}Trim_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Trim_Init(Trim_Handle_t *pTrimHandle);
+int8_t Trim_Poll(Trim_Handle_t *pTrimHandle);
+void Trim_NotifyTimeSet(Trim_Handle_t *pTrimHandle);
+int32_t Trim_GetDriftPPB(Trim_Handle_t *pTrimHandle);
+uint8_t Trim_IsConverged(Trim_Handle_t *pTrimHandle);
+
+#endif /* TRIM_H_ */
@@ -0,0 +1,78 @@
+/*
+ * xprintf.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Small formatted output engine in place of the newlib printf family. No heap, no FILE, no
+ * 	  reentrancy structure, no floating point. The output is collected in a XPRINTF_CHUNK byte buffer
+ * 	  on the stack and handed to a sink in pieces, so a line of any length needs no memory
+ * 	- Conversions: %d %i %u %x %X %o %c %s %p %%, flags - 0 + space #, width and precision (also *),
+ * 	  length modifiers hh h l ll z. 64 bit values only take the 64 bit division when they do not fit
+ * 	  32 bits. Floating point conversions print '?' (the argument is skipped)
+ * 	- Fixed point: XPRINTF_FIXED() expands to the three arguments of "%s%lu.%0Nlu" (sign, integer
+ * 	  part, fraction), N being the digits of Scale. Value has to fit a long
+ * 		XPrintf("drift %s%lu.%03lu ppm\n", XPRINTF_FIXED(ppb, 1000));
+ * 	- The functions carry the printf format attribute, gcc checks every format string against its
+ * 	  arguments at compile time (-Wformat)
+ * 	- Sinks get the text in pieces of up to XPRINTF_CHUNK bytes
+ * 		XPrintf_SinkITM		ITM stimulus port 0 (SWO), the default
+ * 		XPrintf_SinkRingBuf	RingBuf_t of 1 byte elements (ringbuf.h), drained by a UART TX ISR. Bytes
+ * 							which do not fit are dropped and counted in the ring's Overflows
+ * 	  XPrintf_Buffer() formats into memory like snprintf
+ * 	- XPrintf() and XPrintf_Write() go to the sink set with XPrintf_SetSink(). The _write syscall
+ * 	  (syscalls.c) goes there too, output of the C library ends up in the same place
+ * 	- Reentrant as far as the sink is, the engine keeps no state
+ */
+
+#ifndef XPRINTF_H_
+#define XPRINTF_H_
+
+#include "stm32f407xx.h"
+#include <stdarg.h>
+
+#define XPRINTF_CHUNK					32
+
+#define XPRINTF_FORMAT(fmtIdx, argIdx)	__attribute__((format(printf, fmtIdx, argIdx)))
+
+/*
+ * Fixed point arguments for "%s%lu.%0Nlu", Value is a signed long in units of 1/Scale
+ */
+#define XPRINTF_FIXED(Value, Scale)		((Value) < 0) ? "-" : "", \
+										(((Value) < 0) ? (0UL - (unsigned long)(Value)) : (unsigned long)(Value)) / (Scale), \
+										(((Value) < 0) ? (0UL - (unsigned long)(Value)) : (unsigned long)(Value)) % (Scale)
+
+/*
+ * Output sink, gets the formatted text in pieces
+ */
+typedef void (*XPrintf_Sink_t)(void *pCtx, const char *pData, uint32_t Len);
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Default sink
+ */
+void XPrintf_SetSink(XPrintf_Sink_t pfnSink, void *pSinkCtx);
+int XPrintf(const char *pFmt, ...) XPRINTF_FORMAT(1, 2);
+int XPrintf_Write(const char *pData, uint32_t Len);
+
+/*
+ * Explicit sink / buffer
+ */
+int XPrintf_To(XPrintf_Sink_t pfnSink, void *pSinkCtx, const char *pFmt, ...) XPRINTF_FORMAT(3, 4);
+int XPrintf_VFormat(XPrintf_Sink_t pfnSink, void *pSinkCtx, const char *pFmt, va_list Args) XPRINTF_FORMAT(3, 0);
+int XPrintf_Buffer(char *pBuf, uint32_t Size, const char *pFmt, ...) XPRINTF_FORMAT(3, 4);
+
+/*
+ * Sinks
+ */
+void XPrintf_SinkITM(void *pCtx, const char *pData, uint32_t Len);
+void XPrintf_SinkRingBuf(void *pCtx, const char *pData, uint32_t Len);
+
+#endif /* XPRINTF_H_ */
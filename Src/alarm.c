@@ -0,0 +1,453 @@
+/*
+ * alarm.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "alarm.h"
+#include "rtc.h"
+
+#define ALARM_EPOCH_DAY_OF_WEEK			7		/* 01/01/00 was a Saturday */
+
+static void Alarm_HeapSwap(Alarm_t **ppHeap, uint32_t a, uint32_t b);
+static void Alarm_SiftUp(Alarm_Handle_t *pAlarmHandle, uint32_t idx);
+static void Alarm_SiftDown(Alarm_Handle_t *pAlarmHandle, uint32_t idx);
+static void Alarm_HeapRemove(Alarm_Handle_t *pAlarmHandle, uint32_t idx);
+static uint32_t Alarm_NextDue(Alarm_t *pAlarm, uint32_t After);
+static void Alarm_Arm(Alarm_Handle_t *pAlarmHandle);
+static void Alarm_RunDue(void *pArg);
+
+/*
+ * Helper functions
+ */
+static void Alarm_HeapSwap(Alarm_t **ppHeap, uint32_t a, uint32_t b)
+{
+	Alarm_t *pTemp = ppHeap[a];
+
+	ppHeap[a] = ppHeap[b];
+	ppHeap[b] = pTemp;
+	ppHeap[a]->HeapIdx = a;
+	ppHeap[b]->HeapIdx = b;
+}
+
+static void Alarm_SiftUp(Alarm_Handle_t *pAlarmHandle, uint32_t idx)
+{
+	Alarm_t **ppHeap = pAlarmHandle->Alarm_Config.ppHeap;
+	uint32_t parent;
+
+	while(idx > 0)
+	{
+		parent = (idx - 1) / 2;
+		if(ppHeap[parent]->Due <= ppHeap[idx]->Due)
+			break;
+
+		Alarm_HeapSwap(ppHeap, parent, idx);
+		idx = parent;
+	}
+}
+
+static void Alarm_SiftDown(Alarm_Handle_t *pAlarmHandle, uint32_t idx)
+{
+	Alarm_t **ppHeap = pAlarmHandle->Alarm_Config.ppHeap;
+	uint32_t count = pAlarmHandle->Count;
+	uint32_t child, smallest;
+
+	while(1)
+	{
+		smallest = idx;
+		child = 2 * idx + 1;
+
+		if((child < count) && (ppHeap[child]->Due < ppHeap[smallest]->Due))
+			smallest = child;
+		if((child + 1 < count) && (ppHeap[child + 1]->Due < ppHeap[smallest]->Due))
+			smallest = child + 1;
+
+		if(smallest == idx)
+			break;
+
+		Alarm_HeapSwap(ppHeap, idx, smallest);
+		idx = smallest;
+	}
+}
+
+static void Alarm_HeapRemove(Alarm_Handle_t *pAlarmHandle, uint32_t idx)
+{
+	Alarm_t **ppHeap = pAlarmHandle->Alarm_Config.ppHeap;
+	uint32_t last = --pAlarmHandle->Count;
+
+	ppHeap[idx]->HeapIdx = ALARM_NOT_QUEUED;
+
+	if(idx != last)
+	{
+		// move the last entry into the hole, then restore the order in whichever direction it breaks
+		ppHeap[idx] = ppHeap[last];
+		ppHeap[idx]->HeapIdx = idx;
+		if((idx > 0) && (ppHeap[(idx - 1) / 2]->Due > ppHeap[idx]->Due))
+			Alarm_SiftUp(pAlarmHandle, idx);
+		else
+			Alarm_SiftDown(pAlarmHandle, idx);
+	}
+}
+
+static uint32_t Alarm_NextDue(Alarm_t *pAlarm, uint32_t After)
+{
+	uint32_t day, due;
+
+	switch(pAlarm->Type)
+	{
+	case ALARM_TYPE_DAILY:
+		due = (After / ALARM_SECONDS_PER_DAY) * ALARM_SECONDS_PER_DAY + pAlarm->TimeOfDay;
+		if(due <= After)
+			due += ALARM_SECONDS_PER_DAY;
+		return due;
+
+	case ALARM_TYPE_WEEKLY:
+		day = After / ALARM_SECONDS_PER_DAY;
+		// today (if TimeOfDay is still ahead) and the next 7 days cover every DayMask
+		for(uint32_t i = 0; i <= 7; i++, day++)
+		{
+			due = day * ALARM_SECONDS_PER_DAY + pAlarm->TimeOfDay;
+			if((due > After) && (pAlarm->DayMask & (1 << (Alarm_DayOfWeek(due) - SUNDAY))))
+				return due;
+		}
+		return ALARM_NEVER;
+
+	case ALARM_TYPE_CUSTOM:
+		return pAlarm->pfnNext(pAlarm->pSpec, After);
+
+	default:
+		return ALARM_NEVER;
+	}
+}
+
+static void Alarm_Arm(Alarm_Handle_t *pAlarmHandle)
+{
+	Alarm_t *pNext = Alarm_PeekNext(pAlarmHandle);
+	uint32_t now = Alarm_GetNow(pAlarmHandle);
+
+	Sched_TimerCancel(&pAlarmHandle->Timer);
+
+	if(pNext == NULL)
+		return;
+
+	if(pNext->Due <= now)
+	{
+		// already due (resync or an alarm added in the past), run it without waiting for a tick
+		if(Sched_Post(pAlarmHandle->Alarm_Config.pSched, Alarm_RunDue, pAlarmHandle) == SCHED_OK)
+			return;
+	}
+
+	// one scheduler tick per RTC second
+	Sched_TimerStart(pAlarmHandle->Alarm_Config.pSched, &pAlarmHandle->Timer, (pNext->Due > now) ? pNext->Due - now : 1, 0, Alarm_RunDue, pAlarmHandle);
+}
+
+/*
+ * Timer and posted task. Runs every alarm due at the current time, then arms the timer for the next one
+ */
+static void Alarm_RunDue(void *pArg)
+{
+	Alarm_Handle_t *pAlarmHandle = (Alarm_Handle_t*)pArg;
+	uint32_t now = Alarm_GetNow(pAlarmHandle);
+	Alarm_t *pAlarm;
+
+	while(((pAlarm = Alarm_PeekNext(pAlarmHandle)) != NULL) && (pAlarm->Due <= now))
+	{
+		Alarm_HeapRemove(pAlarmHandle, 0);
+
+		// reschedule first, so the task sees a consistent heap and may cancel the alarm
+		if(pAlarm->Type != ALARM_TYPE_ONCE)
+		{
+			pAlarm->Due = Alarm_NextDue(pAlarm, now);
+			if(pAlarm->Due != ALARM_NEVER)
+				Alarm_Add(pAlarmHandle, pAlarm);
+		}
+
+		pAlarm->pfnTask(pAlarm->pArg);
+	}
+
+	Alarm_Arm(pAlarmHandle);
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_Init
+ *
+ * @brief             - Initializes the alarm engine with no pending alarms
+ *
+ * @param[in]         - alarm handle with Alarm_Config filled in
+ * @param[in]         - current RTC epoch second
+ *
+ * @return            -  none
+ *
+ * @Note              -  the scheduler must be initialized
+
+ *********************************************************************/
+void Alarm_Init(Alarm_Handle_t *pAlarmHandle, uint32_t Now)
+{
+	pAlarmHandle->Count = 0;
+	pAlarmHandle->EpochBase = Now;
+	pAlarmHandle->TickBase = pAlarmHandle->Alarm_Config.pSched->Now;
+	pAlarmHandle->Timer.ppPrev = NULL;
+	pAlarmHandle->Timer.pNext = NULL;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_Resync
+ *
+ * @brief             - Sets the time of the engine from the RTC and rearms it
+ *
+ * @param[in]         - alarm handle
+ * @param[in]         - current RTC epoch second
+ *
+ * @return            -  none
+ *
+ * @Note              -  alarms which became due are run from the scheduler, not from this call
+
+ *********************************************************************/
+void Alarm_Resync(Alarm_Handle_t *pAlarmHandle, uint32_t Now)
+{
+	Alarm_t **ppHeap = pAlarmHandle->Alarm_Config.ppHeap;
+
+	if(Now < Alarm_GetNow(pAlarmHandle))
+	{
+		// time went back. Repeating alarms would otherwise skip everything up to their old Due
+		for(uint32_t i = 0; i < pAlarmHandle->Count; i++)
+		{
+			if(ppHeap[i]->Type != ALARM_TYPE_ONCE)
+				ppHeap[i]->Due = Alarm_NextDue(ppHeap[i], Now);
+		}
+
+		// rebuild the heap bottom up, O(n)
+		for(uint32_t i = pAlarmHandle->Count / 2; i-- > 0; )
+			Alarm_SiftDown(pAlarmHandle, i);
+	}
+
+	pAlarmHandle->EpochBase = Now;
+	pAlarmHandle->TickBase = pAlarmHandle->Alarm_Config.pSched->Now;
+
+	Alarm_Arm(pAlarmHandle);
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_GetNow
+ *
+ * @brief             - Returns the current RTC time as seen by the engine
+ *
+ * @param[in]         - alarm handle
+ *
+ * @return            -  RTC epoch second
+ *
+ * @Note              -  time of the last resync plus the scheduler ticks processed since
+
+ *********************************************************************/
+uint32_t Alarm_GetNow(Alarm_Handle_t *pAlarmHandle)
+{
+	return pAlarmHandle->EpochBase + (pAlarmHandle->Alarm_Config.pSched->Now - pAlarmHandle->TickBase);
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_SetOnce
+ *
+ * @brief             - Describes a one shot alarm
+ *
+ * @param[in]         - alarm (not pending)
+ * @param[in]         - RTC epoch second to fire at
+ * @param[in]         - task called on expiry
+ * @param[in]         - task argument
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Alarm_SetOnce(Alarm_t *pAlarm, uint32_t Due, Sched_Task_t pfnTask, void *pArg)
+{
+	pAlarm->Type = ALARM_TYPE_ONCE;
+	pAlarm->Due = Due;
+	pAlarm->HeapIdx = ALARM_NOT_QUEUED;
+	pAlarm->pfnTask = pfnTask;
+	pAlarm->pArg = pArg;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_SetDaily
+ *
+ * @brief             - Describes an alarm which fires every day
+ *
+ * @param[in]         - alarm (not pending)
+ * @param[in]         - seconds after midnight, less than ALARM_SECONDS_PER_DAY
+ * @param[in]         - task called on expiry
+ * @param[in]         - task argument
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Alarm_SetDaily(Alarm_t *pAlarm, uint32_t TimeOfDay, Sched_Task_t pfnTask, void *pArg)
+{
+	pAlarm->Type = ALARM_TYPE_DAILY;
+	pAlarm->Due = 0;
+	pAlarm->TimeOfDay = TimeOfDay;
+	pAlarm->HeapIdx = ALARM_NOT_QUEUED;
+	pAlarm->pfnTask = pfnTask;
+	pAlarm->pArg = pArg;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_SetWeekly
+ *
+ * @brief             - Describes an alarm which fires on some days of the week
+ *
+ * @param[in]         - alarm (not pending)
+ * @param[in]         - bit (day - SUNDAY) set for every day to fire on
+ * @param[in]         - seconds after midnight, less than ALARM_SECONDS_PER_DAY
+ * @param[in]         - task called on expiry
+ * @param[in]         - task argument
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Alarm_SetWeekly(Alarm_t *pAlarm, uint8_t DayMask, uint32_t TimeOfDay, Sched_Task_t pfnTask, void *pArg)
+{
+	pAlarm->Type = ALARM_TYPE_WEEKLY;
+	pAlarm->Due = 0;
+	pAlarm->DayMask = DayMask;
+	pAlarm->TimeOfDay = TimeOfDay;
+	pAlarm->HeapIdx = ALARM_NOT_QUEUED;
+	pAlarm->pfnTask = pfnTask;
+	pAlarm->pArg = pArg;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_SetCustom
+ *
+ * @brief             - Describes an alarm whose expiries come from a function
+ *
+ * @param[in]         - alarm (not pending)
+ * @param[in]         - returns the first expiry after a given second, ALARM_NEVER if there is none
+ * @param[in]         - argument of pfnNext
+ * @param[in]         - task called on expiry
+ * @param[in]         - task argument
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Alarm_SetCustom(Alarm_t *pAlarm, uint32_t (*pfnNext)(void *pSpec, uint32_t After), void *pSpec, Sched_Task_t pfnTask, void *pArg)
+{
+	pAlarm->Type = ALARM_TYPE_CUSTOM;
+	pAlarm->Due = 0;
+	pAlarm->pfnNext = pfnNext;
+	pAlarm->pSpec = pSpec;
+	pAlarm->HeapIdx = ALARM_NOT_QUEUED;
+	pAlarm->pfnTask = pfnTask;
+	pAlarm->pArg = pArg;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_Add
+ *
+ * @brief             - Makes an alarm pending
+ *
+ * @param[in]         - alarm handle
+ * @param[in]         - alarm described by one of the Alarm_Setxxx APIs
+ *
+ * @return            -  ALARM_OK, ALARM_ERR_FULL, ALARM_ERR_PARAM if a repeating alarm never fires
+ *
+ * @Note              -  O(log n). Repeating alarms get their first expiry after the current time.
+ * 						 Adding a pending alarm again moves it
+
+ *********************************************************************/
+uint8_t Alarm_Add(Alarm_Handle_t *pAlarmHandle, Alarm_t *pAlarm)
+{
+	uint32_t idx;
+
+	if(pAlarm->HeapIdx != ALARM_NOT_QUEUED)
+		Alarm_Cancel(pAlarmHandle, pAlarm);
+
+	if(pAlarmHandle->Count >= pAlarmHandle->Alarm_Config.Capacity)
+		return ALARM_ERR_FULL;
+
+	// a new repeating alarm has Due = 0. Alarm_RunDue has already computed Due for a rescheduled one
+	if((pAlarm->Type != ALARM_TYPE_ONCE) && (pAlarm->Due <= Alarm_GetNow(pAlarmHandle)))
+	{
+		pAlarm->Due = Alarm_NextDue(pAlarm, Alarm_GetNow(pAlarmHandle));
+		if(pAlarm->Due == ALARM_NEVER)
+			return ALARM_ERR_PARAM;
+	}
+
+	idx = pAlarmHandle->Count++;
+	pAlarmHandle->Alarm_Config.ppHeap[idx] = pAlarm;
+	pAlarm->HeapIdx = idx;
+	Alarm_SiftUp(pAlarmHandle, idx);
+
+	// the timer only has to move if this is the new earliest alarm
+	if(pAlarm->HeapIdx == 0)
+		Alarm_Arm(pAlarmHandle);
+
+	return ALARM_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_Cancel
+ *
+ * @brief             - Removes a pending alarm
+ *
+ * @param[in]         - alarm handle
+ * @param[in]         - alarm. Nothing happens if it is not pending
+ *
+ * @return            -  none
+ *
+ * @Note              -  O(log n)
+
+ *********************************************************************/
+void Alarm_Cancel(Alarm_Handle_t *pAlarmHandle, Alarm_t *pAlarm)
+{
+	uint32_t idx = pAlarm->HeapIdx;
+
+	if((idx == ALARM_NOT_QUEUED) || (idx >= pAlarmHandle->Count) || (pAlarmHandle->Alarm_Config.ppHeap[idx] != pAlarm))
+		return;
+
+	Alarm_HeapRemove(pAlarmHandle, idx);
+
+	if(idx == 0)
+		Alarm_Arm(pAlarmHandle);
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_PeekNext
+ *
+ * @brief             - Returns the pending alarm which expires first
+ *
+ * @param[in]         - alarm handle
+ *
+ * @return            -  alarm, NULL if none is pending
+ *
+ * @Note              -  O(1)
+
+ *********************************************************************/
+Alarm_t* Alarm_PeekNext(Alarm_Handle_t *pAlarmHandle)
+{
+	return pAlarmHandle->Count ? pAlarmHandle->Alarm_Config.ppHeap[0] : NULL;
+}
+
+/*********************************************************************
+ * @fn      		  - Alarm_DayOfWeek
+ *
+ * @brief             - Returns the day of the week of an RTC epoch second
+ *
+ * @param[in]         - RTC epoch second
+ *
+ * @return            -  SUNDAY to SATURDAY (1 to 7), same numbering as RTC_Handle_date_t.day
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Alarm_DayOfWeek(uint32_t Epoch)
+{
+	return (uint8_t)((((Epoch / ALARM_SECONDS_PER_DAY) + ALARM_EPOCH_DAY_OF_WEEK - 1) % 7) + 1);
+}
@@ -0,0 +1,423 @@
+/*
+ * cron.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "cron.h"
+#include <string.h>
+
+#define CRON_EVERY_7TH_DAY				0x20408102ULL	/* Days 1, 8, 15, 22 and 29 */
+#define CRON_LAST_YEAR					99				/* 2099, end of the RTC year range */
+
+static const char *const cronMonthNames[] = {"JAN","FEB","MAR","APR","MAY","JUN","JUL","AUG","SEP","OCT","NOV","DEC", NULL};
+static const char *const cronWeekdayNames[] = {"SUN","MON","TUE","WED","THU","FRI","SAT", NULL};
+
+static uint8_t Cron_ParseValue(const char **ppStr, const char *const *pNames, uint8_t NameBase, uint8_t *pValue);
+static uint8_t Cron_ParseField(const char **ppStr, uint8_t Min, uint8_t Max, const char *const *pNames, uint64_t *pMask, uint8_t *pStar);
+static uint8_t Cron_NextBit32(uint32_t Mask, uint8_t From);
+static uint8_t Cron_NextBit64(uint64_t Mask, uint8_t From);
+static uint32_t Cron_DayMask(Cron_Expr_t *pExpr, uint8_t Month, uint8_t Year);
+
+/*
+ * Helper functions
+ */
+static uint8_t Cron_ParseValue(const char **ppStr, const char *const *pNames, uint8_t NameBase, uint8_t *pValue)
+{
+	const char *p = *ppStr;
+	uint32_t value = 0;
+
+	if((*p >= '0') && (*p <= '9'))
+	{
+		while((*p >= '0') && (*p <= '9'))
+		{
+			value = value * 10 + (*p++ - '0');
+			if(value > 255)
+				return CRON_ERR_RANGE;
+		}
+		*pValue = (uint8_t)value;
+		*ppStr = p;
+		return CRON_OK;
+	}
+
+	// three letter names, case insensitive
+	for(uint8_t i = 0; pNames && pNames[i]; i++)
+	{
+		uint8_t k;
+		for(k = 0; k < 3; k++)
+		{
+			char c = p[k];
+			if((c >= 'a') && (c <= 'z'))
+				c -= 'a' - 'A';
+			if(c != pNames[i][k])
+				break;
+		}
+		if(k == 3)
+		{
+			*pValue = NameBase + i;
+			*ppStr = p + 3;
+			return CRON_OK;
+		}
+	}
+
+	return CRON_ERR_SYNTAX;
+}
+
+static uint8_t Cron_ParseField(const char **ppStr, uint8_t Min, uint8_t Max, const char *const *pNames, uint64_t *pMask, uint8_t *pStar)
+{
+	const char *p = *ppStr;
+	uint8_t first, last, step, status;
+
+	*pMask = 0;
+	*pStar = (*p == '*');
+
+	while(1)
+	{
+		step = 1;
+
+		if(*p == '*')
+		{
+			first = Min;
+			last = Max;
+			p++;
+		}
+		else
+		{
+			if((status = Cron_ParseValue(&p, pNames, Min, &first)) != CRON_OK)
+				return status;
+			last = first;
+
+			if(*p == '-')
+			{
+				p++;
+				if((status = Cron_ParseValue(&p, pNames, Min, &last)) != CRON_OK)
+					return status;
+			}
+			else if(*p == '/')
+			{
+				// "a/n" runs from a to the end of the range
+				last = Max;
+			}
+		}
+
+		if(*p == '/')
+		{
+			p++;
+			if((status = Cron_ParseValue(&p, NULL, 0, &step)) != CRON_OK)
+				return status;
+			if(step == 0)
+				return CRON_ERR_RANGE;
+		}
+
+		if((first < Min) || (last > Max) || (first > last))
+			return CRON_ERR_RANGE;
+
+		for(uint32_t v = first; v <= last; v += step)
+			*pMask |= (1ULL << v);
+
+		if(*p != ',')
+			break;
+		p++;
+	}
+
+	// a field ends at a blank or at the end of the expression
+	if((*p != ' ') && (*p != '\t') && (*p != '\0'))
+		return CRON_ERR_SYNTAX;
+
+	*ppStr = p;
+
+	return CRON_OK;
+}
+
+static uint8_t Cron_NextBit32(uint32_t Mask, uint8_t From)
+{
+	if(From >= 32)
+		return 0xFF;
+
+	Mask &= (0xFFFFFFFFUL << From);
+
+	return Mask ? (uint8_t)__builtin_ctz(Mask) : 0xFF;
+}
+
+static uint8_t Cron_NextBit64(uint64_t Mask, uint8_t From)
+{
+	if(From >= 64)
+		return 0xFF;
+
+	Mask &= (~0ULL << From);
+
+	return Mask ? (uint8_t)__builtin_ctzll(Mask) : 0xFF;
+}
+
+/*
+ * Days of a month which match the day and weekday fields, bit n = day n
+ */
+static uint32_t Cron_DayMask(Cron_Expr_t *pExpr, uint8_t Month, uint8_t Year)
+{
+	RTC_Handle_time_t midnight = {0, 0, 0, RTC_TIME_FORMAT_24HRS};
+	RTC_Handle_date_t first = {1, Month, Year, 0};
+	uint8_t dim = RTC_DaysInMonth(Month, Year);
+	uint64_t weekdayDays = 0;
+	uint8_t firstWeekday, firstDay;
+	uint32_t days;
+
+	// weekday of the 1st, 0 = Sunday. 01/01/00 was a Saturday
+	firstWeekday = ((RTC_toEpoch(&midnight, &first) / 86400) + 6) % 7;
+
+	for(uint8_t wd = 0; wd < 7; wd++)
+	{
+		if(pExpr->Weekdays & (1 << wd))
+		{
+			firstDay = 1 + ((wd + 7 - firstWeekday) % 7);
+			weekdayDays |= (CRON_EVERY_7TH_DAY << (firstDay - 1));
+		}
+	}
+
+	if(pExpr->DayStar || pExpr->WeekdayStar)
+		days = pExpr->Days & (uint32_t)weekdayDays;
+	else
+		days = pExpr->Days | (uint32_t)weekdayDays;
+
+	// days 1 to dim only
+	return days & (uint32_t)((1ULL << (dim + 1)) - 2);
+}
+
+/*********************************************************************
+ * @fn      		  - Cron_Parse
+ *
+ * @brief             - Compiles a five field cron expression into bitmasks
+ *
+ * @param[out]        - compiled expression
+ * @param[in]         - "minute hour day month weekday" or an @ macro
+ *
+ * @return            -  CRON_OK, CRON_ERR_SYNTAX or CRON_ERR_RANGE
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Cron_Parse(Cron_Expr_t *pExpr, const char *pStr)
+{
+	static const struct { const char *pName; const char *pExpr; } macros[] =
+	{
+		{"@yearly",  "0 0 1 1 *"},
+		{"@monthly", "0 0 1 * *"},
+		{"@weekly",  "0 0 * * 0"},
+		{"@daily",   "0 0 * * *"},
+		{"@hourly",  "0 * * * *"},
+	};
+	uint64_t mask;
+	uint8_t star, status;
+
+	while((*pStr == ' ') || (*pStr == '\t'))
+		pStr++;
+
+	if(*pStr == '@')
+	{
+		for(uint8_t i = 0; i < sizeof(macros) / sizeof(macros[0]); i++)
+		{
+			if(strcmp(pStr, macros[i].pName) == 0)
+				return Cron_Parse(pExpr, macros[i].pExpr);
+		}
+		return CRON_ERR_SYNTAX;
+	}
+
+	const struct { uint8_t Min, Max; const char *const *pNames; } fields[5] =
+	{
+		{0, 59, NULL},
+		{0, 23, NULL},
+		{1, 31, NULL},
+		{1, 12, cronMonthNames},
+		{0, 7, cronWeekdayNames},
+	};
+
+	for(uint8_t f = 0; f < 5; f++)
+	{
+		while((*pStr == ' ') || (*pStr == '\t'))
+			pStr++;
+
+		if((status = Cron_ParseField(&pStr, fields[f].Min, fields[f].Max, fields[f].pNames, &mask, &star)) != CRON_OK)
+			return status;
+
+		switch(f)
+		{
+		case 0: pExpr->Minutes = mask;						break;
+		case 1: pExpr->Hours = (uint32_t)mask;				break;
+		case 2: pExpr->Days = (uint32_t)mask;	pExpr->DayStar = star;	break;
+		case 3: pExpr->Months = (uint16_t)mask;				break;
+		default:
+			// 7 is Sunday too
+			pExpr->Weekdays = (uint8_t)((mask | (mask >> 7)) & 0x7F);
+			pExpr->WeekdayStar = star;
+			break;
+		}
+	}
+
+	while((*pStr == ' ') || (*pStr == '\t'))
+		pStr++;
+
+	return (*pStr == '\0') ? CRON_OK : CRON_ERR_SYNTAX;
+}
+
+/*********************************************************************
+ * @fn      		  - Cron_Match
+ *
+ * @brief             - Checks if a time and date match an expression
+ *
+ * @param[in]         - compiled expression
+ * @param[in]         - time in any of the three time formats (seconds are ignored)
+ * @param[in]         - date
+ *
+ * @return            -  1 on a match, 0 otherwise
+ *
+ * @Note              -  O(1)
+
+ *********************************************************************/
+uint8_t Cron_Match(Cron_Expr_t *pExpr, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	uint8_t dayMatch = (pExpr->Days >> pDate->date) & 1;
+	uint8_t weekdayMatch = (pExpr->Weekdays >> (pDate->day - SUNDAY)) & 1;
+
+	if(!((pExpr->Minutes >> pTime->minutes) & 1) ||
+	   !((pExpr->Hours >> RTC_To24Hours(pTime)) & 1) ||
+	   !((pExpr->Months >> pDate->month) & 1))
+		return 0;
+
+	if(pExpr->DayStar || pExpr->WeekdayStar)
+		return dayMatch & weekdayMatch;
+
+	return dayMatch | weekdayMatch;
+}
+
+/*********************************************************************
+ * @fn      		  - Cron_Next
+ *
+ * @brief             - Returns the first matching minute after a given second
+ *
+ * @param[in]         - compiled expression
+ * @param[in]         - RTC epoch second
+ *
+ * @return            -  RTC epoch second (seconds = 0), CRON_NEVER if nothing matches up to 2099
+ *
+ * @Note              -  skips to the next set bit of every field, at most one pass per month skipped
+
+ *********************************************************************/
+uint32_t Cron_Next(Cron_Expr_t *pExpr, uint32_t After)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	uint8_t year, month, day, hour, minute, next;
+
+	// start at the minute after After
+	RTC_fromEpoch(After - (After % 60) + 60, &time, &date);
+	year = date.year;
+	month = date.month;
+	day = date.date;
+	hour = time.hours;
+	minute = time.minutes;
+
+	while(year <= CRON_LAST_YEAR)
+	{
+		next = Cron_NextBit32(pExpr->Months, month);
+		if(next > 12)
+		{
+			year++;
+			month = 1; day = 1; hour = 0; minute = 0;
+			continue;
+		}
+		if(next != month)
+		{
+			month = next;
+			day = 1; hour = 0; minute = 0;
+		}
+
+		next = Cron_NextBit32(Cron_DayMask(pExpr, month, year), day);
+		if(next == 0xFF)
+		{
+			if(++month > 12)
+			{
+				year++;
+				month = 1;
+			}
+			day = 1; hour = 0; minute = 0;
+			continue;
+		}
+		if(next != day)
+		{
+			day = next;
+			hour = 0; minute = 0;
+		}
+
+		next = Cron_NextBit32(pExpr->Hours, hour);
+		if(next > 23)
+		{
+			// past the end of the month the day mask has no bit left
+			day++;
+			hour = 0; minute = 0;
+			continue;
+		}
+		if(next != hour)
+		{
+			hour = next;
+			minute = 0;
+		}
+
+		next = Cron_NextBit64(pExpr->Minutes, minute);
+		if(next > 59)
+		{
+			hour++;
+			minute = 0;
+			continue;
+		}
+
+		time.seconds = 0;
+		time.minutes = next;
+		time.hours = hour;
+		time.timeFormat = RTC_TIME_FORMAT_24HRS;
+		date.date = day;
+		date.month = month;
+		date.year = year;
+
+		return RTC_toEpoch(&time, &date);
+	}
+
+	return CRON_NEVER;
+}
+
+/*********************************************************************
+ * @fn      		  - Cron_NextAlarm
+ *
+ * @brief             - pfnNext of a cron alarm (see Alarm_SetCustom)
+ *
+ * @param[in]         - compiled expression (Cron_Expr_t)
+ * @param[in]         - RTC epoch second
+ *
+ * @return            -  next expiry, ALARM_NEVER if there is none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t Cron_NextAlarm(void *pSpec, uint32_t After)
+{
+	return Cron_Next((Cron_Expr_t*)pSpec, After);
+}
+
+/*********************************************************************
+ * @fn      		  - Cron_SetAlarm
+ *
+ * @brief             - Describes an alarm which fires on every match of a cron expression
+ *
+ * @param[in]         - alarm (not pending)
+ * @param[in]         - compiled expression, must stay valid while the alarm is pending
+ * @param[in]         - task called on expiry
+ * @param[in]         - task argument
+ *
+ * @return            -  none
+ *
+ * @Note              -  add it with Alarm_Add()
+
+ *********************************************************************/
+void Cron_SetAlarm(Alarm_t *pAlarm, Cron_Expr_t *pExpr, Sched_Task_t pfnTask, void *pArg)
+{
+	Alarm_SetCustom(pAlarm, Cron_NextAlarm, pExpr, pfnTask, pArg);
+}
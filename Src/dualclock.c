@@ -0,0 +1,279 @@
+/*
+ * dualclock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "dualclock.h"
+
+static uint32_t DualClock_ReadInternal(DualClock_Handle_t *pDcHandle);
+static uint8_t DualClock_WriteInternal(DualClock_Handle_t *pDcHandle, uint32_t Epoch);
+static uint8_t DualClock_ReadExternal(DualClock_Handle_t *pDcHandle, uint32_t *pEpoch);
+static void DualClock_Compare(DualClock_Handle_t *pDcHandle, uint32_t ExtEpoch);
+
+/*
+ * Helper functions
+ */
+static uint32_t DualClock_ReadInternal(DualClock_Handle_t *pDcHandle)
+{
+	IRTC_DateTime_t dateTime;
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	IRTC_GetDateTime(pDcHandle->DualClock_Config.pIRTCHandle, &dateTime);
+
+	time.seconds = dateTime.Seconds;
+	time.minutes = dateTime.Minutes;
+	time.hours = dateTime.Hours;
+	time.timeFormat = RTC_TIME_FORMAT_24HRS;
+	date.date = dateTime.Date;
+	date.month = dateTime.Month;
+	date.year = dateTime.Year;
+	date.day = (dateTime.WeekDay == 7) ? SUNDAY : dateTime.WeekDay + 1;
+
+	return RTC_toEpoch(&time, &date);
+}
+
+static uint8_t DualClock_WriteInternal(DualClock_Handle_t *pDcHandle, uint32_t Epoch)
+{
+	IRTC_DateTime_t dateTime;
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_fromEpoch(Epoch, &time, &date);
+
+	dateTime.Seconds = time.seconds;
+	dateTime.Minutes = time.minutes;
+	dateTime.Hours = time.hours;
+	dateTime.Date = date.date;
+	dateTime.Month = date.month;
+	dateTime.Year = date.year;
+	// the hardware counts weekdays from Monday, the BSP from Sunday
+	dateTime.WeekDay = (date.day == SUNDAY) ? 7 : date.day - 1;
+
+	if(IRTC_SetDateTime(pDcHandle->DualClock_Config.pIRTCHandle, &dateTime) != IRTC_OK)
+		return DUALCLOCK_ERR_IRTC;
+
+	return DUALCLOCK_OK;
+}
+
+static uint8_t DualClock_ReadExternal(DualClock_Handle_t *pDcHandle, uint32_t *pEpoch)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	if(RTC_GetDateTime(pDcHandle->DualClock_Config.pRTCHandle, &time, &date) != RTC_OK)
+	{
+		pDcHandle->BusErrors++;
+		return DUALCLOCK_ERR_BUS;
+	}
+
+	*pEpoch = RTC_toEpoch(&time, &date);
+
+	return DUALCLOCK_OK;
+}
+
+static void DualClock_Compare(DualClock_Handle_t *pDcHandle, uint32_t ExtEpoch)
+{
+	int32_t diff = (int32_t)(DualClock_ReadInternal(pDcHandle) - ExtEpoch);
+	uint32_t absDiff = (diff < 0) ? (uint32_t)-diff : (uint32_t)diff;
+
+	pDcHandle->Diff = diff;
+	pDcHandle->Diverged = (absDiff > pDcHandle->DualClock_Config.Tolerance);
+	pDcHandle->Checks++;
+	if(pDcHandle->Diverged)
+		pDcHandle->Divergences++;
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_Init
+ *
+ * @brief             - Cross-checks both clocks once and repairs the one which lost the time
+ *
+ * @param[in]         - dual clock handle with DualClock_Config filled in, both RTCs initialised
+ *
+ * @return            -  DUALCLOCK_OK or DUALCLOCK_ERR_xxx
+ *
+ * @Note              -  the first DualClock_Poll() after init does a check
+
+ *********************************************************************/
+uint8_t DualClock_Init(DualClock_Handle_t *pDcHandle)
+{
+	DualClock_Config_t *pConfig = &pDcHandle->DualClock_Config;
+	uint8_t extLost = RTC_IsTimeLost(pConfig->pRTCHandle);
+	uint8_t intLost = IRTC_IsTimeLost(pConfig->pIRTCHandle);
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	uint32_t extEpoch;
+
+	pDcHandle->Diff = 0;
+	pDcHandle->Diverged = 0;
+	pDcHandle->Checks = 0;
+	pDcHandle->Divergences = 0;
+	pDcHandle->BusErrors = 0;
+	pDcHandle->Countdown = 1;
+	if(pConfig->Tolerance == 0)
+		pConfig->Tolerance = DUALCLOCK_DEFAULT_TOLERANCE;
+
+	if(extLost && intLost)
+		return DUALCLOCK_ERR_LOST;
+
+	// 1. The internal RTC kept the time (VBAT), put it back into the external one
+	if(extLost)
+	{
+		DualClock_GetDateTime(pDcHandle, &time, &date);
+		if(RTC_SetDateTime(pConfig->pRTCHandle, &time, &date) != RTC_OK)
+			return DUALCLOCK_ERR_BUS;
+		return DUALCLOCK_OK;
+	}
+
+	// 2. The external RTC is the reference
+	if(DualClock_ReadExternal(pDcHandle, &extEpoch) != DUALCLOCK_OK)
+		return DUALCLOCK_ERR_BUS;
+
+	if(!intLost)
+	{
+		DualClock_Compare(pDcHandle, extEpoch);
+		if(!pDcHandle->Diverged)
+			return DUALCLOCK_OK;
+	}
+
+	return DualClock_WriteInternal(pDcHandle, extEpoch);
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_SetDateTime
+ *
+ * @brief             - Sets both clocks
+ *
+ * @param[in]         - dual clock handle
+ * @param[in]         - time in any of the three time formats
+ * @param[in]         - date
+ *
+ * @return            -  DUALCLOCK_OK or DUALCLOCK_ERR_xxx
+ *
+ * @Note              -  the external RTC is written as given, use TimeFormat to keep both views the same
+
+ *********************************************************************/
+uint8_t DualClock_SetDateTime(DualClock_Handle_t *pDcHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	if(RTC_SetDateTime(pDcHandle->DualClock_Config.pRTCHandle, pTime, pDate) != RTC_OK)
+		return DUALCLOCK_ERR_BUS;
+
+	pDcHandle->Diverged = 0;
+
+	return DualClock_WriteInternal(pDcHandle, RTC_toEpoch(pTime, pDate));
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_Resync
+ *
+ * @brief             - Sets the internal RTC from the external one
+ *
+ * @param[in]         - dual clock handle
+ *
+ * @return            -  DUALCLOCK_OK or DUALCLOCK_ERR_xxx
+ *
+ * @Note              -  call right after an SQW edge, the internal seconds then roll over in phase
+ * 						 with the external ones
+
+ *********************************************************************/
+uint8_t DualClock_Resync(DualClock_Handle_t *pDcHandle)
+{
+	uint32_t extEpoch;
+
+	if(DualClock_ReadExternal(pDcHandle, &extEpoch) != DUALCLOCK_OK)
+		return DUALCLOCK_ERR_BUS;
+
+	pDcHandle->Diff = 0;
+	pDcHandle->Diverged = 0;
+
+	return DualClock_WriteInternal(pDcHandle, extEpoch);
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_GetDateTime
+ *
+ * @brief             - Reads the time and date from the internal RTC
+ *
+ * @param[in]         - dual clock handle
+ * @param[out]        - time in TimeFormat
+ * @param[out]        - date
+ *
+ * @return            -  none
+ *
+ * @Note              -  no bus traffic
+
+ *********************************************************************/
+void DualClock_GetDateTime(DualClock_Handle_t *pDcHandle, RTC_Handle_time_t *pTime, RTC_Handle_date_t *pDate)
+{
+	RTC_fromEpoch(DualClock_ReadInternal(pDcHandle), pTime, pDate);
+	RTC_From24Hours(pTime, pDcHandle->DualClock_Config.TimeFormat);
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_GetEpoch
+ *
+ * @brief             - Reads the internal RTC as an epoch second
+ *
+ * @param[in]         - dual clock handle
+ *
+ * @return            -  seconds since 01/01/00 00:00:00
+ *
+ * @Note              -  no bus traffic
+
+ *********************************************************************/
+uint32_t DualClock_GetEpoch(DualClock_Handle_t *pDcHandle)
+{
+	return DualClock_ReadInternal(pDcHandle);
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_Poll
+ *
+ * @brief             - Cross-checks the clocks every CheckPeriod calls
+ *
+ * @param[in]         - dual clock handle
+ * @param[out]        - external RTC epoch, when it was read
+ *
+ * @return            -  1 if the external RTC was read, 0 otherwise
+ *
+ * @Note              -  call once per SQW tick, the external time read is then the time of the
+ * 						 last edge (Timestamp_Sync)
+
+ *********************************************************************/
+uint8_t DualClock_Poll(DualClock_Handle_t *pDcHandle, uint32_t *pExtEpoch)
+{
+	uint32_t extEpoch;
+
+	if((pDcHandle->DualClock_Config.CheckPeriod == 0) || (--pDcHandle->Countdown != 0))
+		return 0;
+
+	pDcHandle->Countdown = pDcHandle->DualClock_Config.CheckPeriod;
+
+	if(DualClock_ReadExternal(pDcHandle, &extEpoch) != DUALCLOCK_OK)
+		return 0;
+
+	DualClock_Compare(pDcHandle, extEpoch);
+	*pExtEpoch = extEpoch;
+
+	return 1;
+}
+
+/*********************************************************************
+ * @fn      		  - DualClock_IsDiverged
+ *
+ * @brief             - Tells if the last check found the clocks out of tolerance
+ *
+ * @param[in]         - dual clock handle
+ *
+ * @return            -  1 if diverged, 0 otherwise
+ *
+ * @Note              -  Diff holds the offset in seconds
+
+ *********************************************************************/
+uint8_t DualClock_IsDiverged(DualClock_Handle_t *pDcHandle)
+{
+	return pDcHandle->Diverged;
+}
@@ -0,0 +1,324 @@
+/*
+ * eventrec.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "eventrec.h"
+#include <string.h>
+
+static uint8_t EventRec_LineToIRQ(uint8_t Line);
+
+/*
+ * Helper functions
+ */
+static uint8_t EventRec_LineToIRQ(uint8_t Line)
+{
+	if(Line <= 4)
+		return IRQ_EXTI0 + Line;
+	if(Line <= 9)
+		return IRQ_EXTI9_5;
+	return IRQ_EXTI15_10;
+}
+
+/*********************************************************************
+ * @fn      		  - EventRec_Init
+ *
+ * @brief             - Configures the lines as EXTI inputs and starts recording
+ *
+ * @param[in]         - event recorder handle with EventRec_Config filled in
+ *
+ * @return            -  EVENTREC_OK, EVENTREC_ERR_SIZE (ring size) or EVENTREC_ERR_PARAM (line
+ * 						 out of range or used twice, trigger not an EXTI edge mode)
+ *
+ * @Note              -  the timestamp service has to be initialized first
+
+ *********************************************************************/
+uint8_t EventRec_Init(EventRec_Handle_t *pEvHandle)
+{
+	EventRec_Config_t config = pEvHandle->EventRec_Config;
+	GPIO_Handle_t gpio;
+	uint8_t irqDone[3] = {0};
+
+	memset(pEvHandle, 0, sizeof(*pEvHandle));
+	pEvHandle->EventRec_Config = config;
+
+	if(RingBuf_Init(&pEvHandle->Ring, config.pStorage, config.Size, sizeof(EventRec_Event_t)) != RINGBUF_OK)
+		return EVENTREC_ERR_SIZE;
+
+	pEvHandle->pTIMx = config.pTsHandle->Timestamp_Config.pTIMx;
+
+	// 1. An EXTI line takes one port, check all lines before touching any of them
+	for(uint8_t i = 0; i < config.NoOfLines; i++)
+	{
+		uint8_t line = config.pLines[i].Pin;
+
+		if((line >= EVENTREC_NO_OF_LINES) || (pEvHandle->LineMask & (1 << line)))
+			return EVENTREC_ERR_PARAM;
+
+		if(config.pLines[i].Trigger == GPIO_MODE_IT_RT)
+			pEvHandle->RisingEdges |= (1 << line);
+		else if(config.pLines[i].Trigger == GPIO_MODE_IT_RFT)
+			pEvHandle->BothEdges |= (1 << line);
+		else if(config.pLines[i].Trigger != GPIO_MODE_IT_FT)
+			return EVENTREC_ERR_PARAM;
+
+		pEvHandle->LineMask |= (1 << line);
+		pEvHandle->pPort[line] = config.pLines[i].pGPIOx;
+	}
+
+	// 2. Pins and EXTI (trigger, port selection, IMR)
+	for(uint8_t i = 0; i < config.NoOfLines; i++)
+	{
+		memset(&gpio, 0, sizeof(gpio));
+		gpio.pGPIOx = config.pLines[i].pGPIOx;
+		gpio.GPIO_PinConfig.GPIO_PinNumber = config.pLines[i].Pin;
+		gpio.GPIO_PinConfig.GPIO_PinMode = config.pLines[i].Trigger;
+		gpio.GPIO_PinConfig.GPIO_PinPuPdControl = config.pLines[i].PuPd;
+		GPIO_Init(&gpio);
+	}
+
+	// 3. NVIC, one priority for every EXTI ISR in use. Shared ISRs are configured once
+	for(uint8_t i = 0; i < config.NoOfLines; i++)
+	{
+		uint8_t line = config.pLines[i].Pin;
+		uint8_t irq = EventRec_LineToIRQ(line);
+		uint8_t *pDone = (line <= 4) ? NULL : &irqDone[(line <= 9) ? 1 : 2];
+
+		if(pDone && *pDone)
+			continue;
+		if(pDone)
+			*pDone = 1;
+
+		GPIO_IRQPriorityConfig(irq, config.IRQPriority);
+		GPIO_IRQITConfig(irq, ENABLE);
+	}
+
+	return EVENTREC_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - EventRec_IRQHandling
+ *
+ * @brief             - Records every pending recorder line and clears its EXTI pending bit
+ *
+ * @param[in]         - event recorder handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  call from the EXTI ISRs. Lines which are not recorded are left pending
+ * 						 for the rest of the ISR. All pending lines of one call share the timer count
+
+ *********************************************************************/
+__RAMFUNC void EventRec_IRQHandling(EventRec_Handle_t *pEvHandle)
+{
+	uint32_t count = pEvHandle->pTIMx->CNT;
+	uint32_t pending = EXTI->PR & pEvHandle->LineMask;
+	uint32_t line, level;
+
+	while(pending)
+	{
+		line = __builtin_ctz(pending);
+		pending &= pending - 1;
+
+		// PR is write 1 to clear, writing only this bit leaves the other lines pending
+		EXTI->PR = (1 << line);
+
+		// a single edge trigger gives the level, only dual edge lines need the pin
+		if(pEvHandle->BothEdges & (1 << line))
+			level = (pEvHandle->pPort[line]->IDR >> line) & 1;
+		else
+			level = (pEvHandle->RisingEdges >> line) & 1;
+
+		// second word of EventRec_Event_t: Line, Level, Reserved (little endian)
+		if(RingBuf_PutWords(&pEvHandle->Ring, count, line | (level << 8)) != RINGBUF_OK)
+			pEvHandle->Dropped++;
+	}
+}
+
+/*********************************************************************
+ * @fn      		  - EventRec_Drain
+ *
+ * @brief             - Converts recorded events to timestamps and passes them to the sink
+ *
+ * @param[in]         - event recorder handle
+ * @param[in]         - maximum number of events to drain
+ *
+ * @return            -  number of events drained
+ *
+ * @Note              -  thread context. The sink gets at most EVENTREC_BATCH events per call. It is
+ * 						 also called without events when only drops are pending
+
+ *********************************************************************/
+uint32_t EventRec_Drain(EventRec_Handle_t *pEvHandle, uint32_t MaxEvents)
+{
+	EventRec_Config_t *pConfig = &pEvHandle->EventRec_Config;
+	EventRec_Record_t records[EVENTREC_BATCH];
+	uint32_t drained = 0, n, dropped;
+	EventRec_Event_t *pEvents;
+
+	do
+	{
+		pEvents = (EventRec_Event_t*)RingBuf_Span(&pEvHandle->Ring, &n);
+		if(n > EVENTREC_BATCH)
+			n = EVENTREC_BATCH;
+		if(n > MaxEvents - drained)
+			n = MaxEvents - drained;
+
+		for(uint32_t i = 0; i < n; i++)
+		{
+			Timestamp_FromCount(pConfig->pTsHandle, pEvents[i].Count, &records[i].Stamp);
+			records[i].Line = pEvents[i].Line;
+			records[i].Level = pEvents[i].Level;
+		}
+		RingBuf_Release(&pEvHandle->Ring, n);
+
+		dropped = pEvHandle->Dropped - pEvHandle->DroppedReported;
+		pEvHandle->DroppedReported += dropped;
+
+		if((n || dropped) && pConfig->pfnSink)
+			pConfig->pfnSink(pConfig->pSinkCtx, records, n, dropped);
+
+		drained += n;
+	}while(n && (drained < MaxEvents));
+
+	return drained;
+}
+
+/*********************************************************************
+ * @fn      		  - EventRec_SinkTelemetry
+ *
+ * @brief             - Sends events as one TLM_REC_EVENTS record
+ *
+ * @param[in]         - Telemetry_Handle_t*
+ * @param[in]         - events
+ * @param[in]         - number of events, at most TLM_EVENTS_MAX
+ * @param[in]         - events dropped since the previous call
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void EventRec_SinkTelemetry(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped)
+{
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	uint32_t len = 0;
+	uint32_t base = Count ? pRecords[0].Stamp.Seconds : 0;
+
+	if(Count > TLM_EVENTS_MAX)
+		Count = TLM_EVENTS_MAX;
+
+	len += Telemetry_PutVarint(&payload[len], Dropped);
+	len += Telemetry_PutVarint(&payload[len], base);
+	payload[len++] = (uint8_t)Count;
+
+	for(uint32_t i = 0; i < Count; i++)
+	{
+		payload[len++] = pRecords[i].Line | (pRecords[i].Level ? TLM_EVENT_LEVEL : 0);
+		len += Telemetry_PutVarint(&payload[len], pRecords[i].Stamp.Seconds - base);
+		len += Telemetry_PutVarint(&payload[len], pRecords[i].Stamp.Micros);
+	}
+
+	Telemetry_PutRecord((Telemetry_Handle_t*)pCtx, TLM_REC_EVENTS, payload, len);
+}
+
+/*********************************************************************
+ * @fn      		  - EventRec_SinkNVRAM
+ *
+ * @brief             - Keeps the last events in a region of the RTC NVRAM
+ *
+ * @param[in]         - EventRec_NVRAMLog_t*
+ * @param[in]         - events
+ * @param[in]         - number of events
+ * @param[in]         - events dropped since the previous call
+ *
+ * @return            -  none
+ *
+ * @Note              -  the oldest slot is overwritten. A header with an out of range slot
+ * 						 (fresh NVRAM) starts over at slot 0
+
+ *********************************************************************/
+void EventRec_SinkNVRAM(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped)
+{
+	EventRec_NVRAMLog_t *pLog = (EventRec_NVRAMLog_t*)pCtx;
+	uint8_t header[EVENTREC_NVRAM_HEADER];
+	uint8_t slot[EVENTREC_NVRAM_SLOT];
+	uint8_t slots;
+
+	if(pLog->Len < EVENTREC_NVRAM_HEADER + EVENTREC_NVRAM_SLOT)
+		return;
+	slots = (pLog->Len - EVENTREC_NVRAM_HEADER) / EVENTREC_NVRAM_SLOT;
+
+	if(RTC_ReadNVRAM(pLog->pRTCHandle, pLog->Offset, header, sizeof(header)) != RTC_OK)
+		return;
+
+	if(header[0] >= slots)
+		header[0] = 0;
+	header[1] = (header[1] + Dropped > 0xFF) ? 0xFF : (header[1] + Dropped);
+
+	for(uint32_t i = 0; i < Count; i++)
+	{
+		uint32_t seconds = pRecords[i].Stamp.Seconds;
+		uint32_t micros = pRecords[i].Stamp.Micros;
+
+		slot[0] = (uint8_t)seconds;
+		slot[1] = (uint8_t)(seconds >> 8);
+		slot[2] = (uint8_t)(seconds >> 16);
+		slot[3] = (uint8_t)(seconds >> 24);
+		slot[4] = (uint8_t)micros;
+		slot[5] = (uint8_t)(micros >> 8);
+		slot[6] = (uint8_t)(micros >> 16);
+		slot[7] = pRecords[i].Line | (pRecords[i].Level ? TLM_EVENT_LEVEL : 0);
+
+		RTC_WriteNVRAM(pLog->pRTCHandle, pLog->Offset + EVENTREC_NVRAM_HEADER + (header[0] * EVENTREC_NVRAM_SLOT), slot, sizeof(slot));
+
+		if(++header[0] >= slots)
+			header[0] = 0;
+	}
+
+	RTC_WriteNVRAM(pLog->pRTCHandle, pLog->Offset, header, sizeof(header));
+}
+
+/*********************************************************************
+ * @fn      		  - EventRec_SinkFlashLog
+ *
+ * @brief             - Appends every event to the flash log
+ *
+ * @param[in]         - FlashLog_Handle_t*
+ * @param[in]         - events
+ * @param[in]         - number of events
+ * @param[in]         - events dropped since the previous call
+ *
+ * @return            -  none
+ *
+ * @Note              -  drops get a record of their own, stamped with the first event of the
+ * 						 batch (0 without events). A rotation erases a sector, see flashlog.h
+
+ *********************************************************************/
+void EventRec_SinkFlashLog(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped)
+{
+	FlashLog_Handle_t *pLog = (FlashLog_Handle_t*)pCtx;
+	uint8_t payload[4];
+
+	if(Dropped)
+	{
+		payload[0] = (uint8_t)Dropped;
+		payload[1] = (uint8_t)(Dropped >> 8);
+		payload[2] = (uint8_t)(Dropped >> 16);
+		payload[3] = (uint8_t)(Dropped >> 24);
+		FlashLog_Append(pLog, EVENTREC_FLASHLOG_DROPPED, Count ? pRecords[0].Stamp.Seconds : 0, payload, sizeof(payload));
+	}
+
+	for(uint32_t i = 0; i < Count; i++)
+	{
+		uint32_t micros = pRecords[i].Stamp.Micros;
+
+		payload[0] = (uint8_t)micros;
+		payload[1] = (uint8_t)(micros >> 8);
+		payload[2] = (uint8_t)(micros >> 16);
+		payload[3] = pRecords[i].Line | (pRecords[i].Level ? TLM_EVENT_LEVEL : 0);
+		FlashLog_Append(pLog, EVENTREC_FLASHLOG_EVENT, pRecords[i].Stamp.Seconds, payload, sizeof(payload));
+	}
+}
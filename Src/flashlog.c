@@ -0,0 +1,350 @@
+/*
+ * flashlog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "flashlog.h"
+#include "crc.h"
+#include <string.h>
+
+#define FLASHLOG_WORD(Addr)				(*(const uint32_t*)(uintptr_t)(Addr))
+#define FLASHLOG_SPAN(Len)				(FLASHLOG_RECORD_OVERHEAD + (((uint32_t)(Len) + 3) & ~3UL))
+
+static uint32_t FlashLog_Base(FlashLog_Handle_t *pLogHandle, uint8_t Index);
+static uint32_t FlashLog_End(FlashLog_Handle_t *pLogHandle, uint8_t Index);
+static uint8_t FlashLog_ReadHeader(FlashLog_Handle_t *pLogHandle, uint8_t Index, uint32_t *pSeq);
+static uint8_t FlashLog_Format(FlashLog_Handle_t *pLogHandle, uint8_t Index, uint32_t Seq);
+static uint32_t FlashLog_UsedEnd(uint32_t Start, uint32_t End);
+static uint8_t FlashLog_Parse(uint32_t Addr, uint32_t End, uint32_t *pNext);
+static uint32_t FlashLog_Scan(FlashLog_Handle_t *pLogHandle, uint32_t Start, uint32_t End, uint32_t *pLastAddr);
+static void FlashLog_Fill(uint32_t Addr, FlashLog_Record_t *pRecord);
+
+/*
+ * Helper functions
+ */
+static uint32_t FlashLog_Base(FlashLog_Handle_t *pLogHandle, uint8_t Index)
+{
+	return FLASH_GetSectorAddr(pLogHandle->FlashLog_Config.Sector[Index]);
+}
+
+static uint32_t FlashLog_End(FlashLog_Handle_t *pLogHandle, uint8_t Index)
+{
+	uint8_t sector = pLogHandle->FlashLog_Config.Sector[Index];
+
+	return FLASH_GetSectorAddr(sector) + FLASH_GetSectorSize(sector);
+}
+
+static uint8_t FlashLog_ReadHeader(FlashLog_Handle_t *pLogHandle, uint8_t Index, uint32_t *pSeq)
+{
+	uint32_t base = FlashLog_Base(pLogHandle, Index);
+
+	*pSeq = FLASHLOG_WORD(base + 4);
+
+	return (FLASHLOG_WORD(base) == FLASHLOG_MAGIC) && (FLASHLOG_WORD(base + 8) == ~*pSeq);
+}
+
+static uint8_t FlashLog_Format(FlashLog_Handle_t *pLogHandle, uint8_t Index, uint32_t Seq)
+{
+	uint8_t range = pLogHandle->FlashLog_Config.VoltageRange;
+	uint32_t header[3] = {FLASHLOG_MAGIC, Seq, ~Seq};
+	uint8_t status;
+
+	FLASH_Unlock();
+	status = FLASH_EraseSector(pLogHandle->FlashLog_Config.Sector[Index], range);
+	if(status == FLASH_OK)
+		status = FLASH_Program(FlashLog_Base(pLogHandle, Index), header, sizeof(header), range);
+	FLASH_Lock();
+
+	return (status == FLASH_OK) ? FLASHLOG_OK : FLASHLOG_ERR_FLASH;
+}
+
+static uint32_t FlashLog_UsedEnd(uint32_t Start, uint32_t End)
+{
+	// everything behind the last programmed word is erased, cut short or not
+	while((End > Start) && (FLASHLOG_WORD(End - 4) == FLASHLOG_ERASED))
+		End -= 4;
+
+	return End;
+}
+
+static uint8_t FlashLog_Parse(uint32_t Addr, uint32_t End, uint32_t *pNext)
+{
+	uint32_t header = FLASHLOG_WORD(Addr);
+	uint32_t len = header & 0xFFFF;
+	uint32_t span = FLASHLOG_SPAN(len);
+
+	// 1. A bad first word gives no length to skip, resync on the next word
+	if(((header >> 24) != FLASHLOG_MARKER) || (len > FLASHLOG_MAX_PAYLOAD) || (span > End - Addr))
+	{
+		*pNext = Addr + 4;
+		return 0;
+	}
+
+	// 2. A record cut short (or damaged) fails the commit word. Its length can not be trusted either,
+	//    records appended after it at the next boot may start inside its span
+	if(FLASHLOG_WORD(Addr + span - 4) != Crc_CRC32((const void*)(uintptr_t)Addr, span - 4))
+	{
+		*pNext = Addr + 4;
+		return 0;
+	}
+
+	*pNext = Addr + span;
+	return 1;
+}
+
+static uint32_t FlashLog_Scan(FlashLog_Handle_t *pLogHandle, uint32_t Start, uint32_t End, uint32_t *pLastAddr)
+{
+	uint32_t addr = Start, next, records = 0;
+
+	while(addr < End)
+	{
+		if(FlashLog_Parse(addr, End, &next))
+		{
+			*pLastAddr = addr;
+			records++;
+		}
+		else
+		{
+			pLogHandle->Skipped++;
+		}
+		addr = next;
+	}
+
+	return records;
+}
+
+static void FlashLog_Fill(uint32_t Addr, FlashLog_Record_t *pRecord)
+{
+	uint32_t header = FLASHLOG_WORD(Addr);
+
+	pRecord->Type = (uint8_t)(header >> 16);
+	pRecord->Len = (uint16_t)header;
+	pRecord->Timestamp = FLASHLOG_WORD(Addr + 4);
+	pRecord->pData = (const uint8_t*)(uintptr_t)(Addr + 8);
+}
+
+/*********************************************************************
+ * @fn      		  - FlashLog_Init
+ *
+ * @brief             - Recovers the log from the flash, formats it if neither sector is valid
+ *
+ * @param[in]         - flash log handle with FlashLog_Config filled in
+ *
+ * @return            -  FLASHLOG_OK, FLASHLOG_ERR_PARAM (bad sectors) or FLASHLOG_ERR_FLASH
+ *
+ * @Note              -  reads both sectors once. Formatting erases a sector, see the notes
+ * 						 in flashlog.h
+
+ *********************************************************************/
+uint8_t FlashLog_Init(FlashLog_Handle_t *pLogHandle)
+{
+	FlashLog_Config_t config = pLogHandle->FlashLog_Config;
+	uint32_t seq[2], lastAddr = 0, start;
+	uint8_t valid[2], other;
+
+	memset(pLogHandle, 0, sizeof(*pLogHandle));
+	pLogHandle->FlashLog_Config = config;
+
+	if((config.Sector[0] >= FLASH_NO_OF_SECTORS) || (config.Sector[1] >= FLASH_NO_OF_SECTORS) ||
+	   (config.Sector[0] == config.Sector[1]) || (FLASH_GetSectorSize(config.Sector[0]) != FLASH_GetSectorSize(config.Sector[1])))
+		return FLASHLOG_ERR_PARAM;
+
+	// 1. Active sector: valid header, newer sequence number
+	valid[0] = FlashLog_ReadHeader(pLogHandle, 0, &seq[0]);
+	valid[1] = FlashLog_ReadHeader(pLogHandle, 1, &seq[1]);
+
+	if(valid[0] && valid[1])
+		pLogHandle->Active = ((int32_t)(seq[1] - seq[0]) > 0) ? 1 : 0;
+	else if(valid[0] || valid[1])
+		pLogHandle->Active = valid[1] ? 1 : 0;
+	else
+	{
+		// new or damaged log
+		if(FlashLog_Format(pLogHandle, 0, 1) != FLASHLOG_OK)
+			return FLASHLOG_ERR_FLASH;
+		valid[0] = 1;
+		seq[0] = 1;
+		pLogHandle->Active = 0;
+	}
+	pLogHandle->Seq = seq[pLogHandle->Active];
+	other = pLogHandle->Active ^ 1;
+
+	// 2. Older half, only if it is the sector rotated out last
+	if(valid[other] && (seq[other] == pLogHandle->Seq - 1))
+	{
+		start = FlashLog_Base(pLogHandle, other) + FLASHLOG_SECTOR_HEADER;
+		pLogHandle->OldValid = 1;
+		pLogHandle->OldEnd = FlashLog_UsedEnd(start, FlashLog_End(pLogHandle, other));
+		pLogHandle->Records[0] = FlashLog_Scan(pLogHandle, start, pLogHandle->OldEnd, &lastAddr);
+	}
+
+	// 3. Active half, appending resumes behind the last programmed word
+	start = FlashLog_Base(pLogHandle, pLogHandle->Active) + FLASHLOG_SECTOR_HEADER;
+	pLogHandle->WriteAddr = FlashLog_UsedEnd(start, FlashLog_End(pLogHandle, pLogHandle->Active));
+	pLogHandle->Records[1] = FlashLog_Scan(pLogHandle, start, pLogHandle->WriteAddr, &lastAddr);
+	pLogHandle->LastAddr = lastAddr;
+
+	return FLASHLOG_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - FlashLog_Append
+ *
+ * @brief             - Appends a record, rotates to the other sector when the active one is full
+ *
+ * @param[in]         - flash log handle
+ * @param[in]         - record type, application defined
+ * @param[in]         - timestamp, RTC epoch second
+ * @param[in]         - payload
+ * @param[in]         - payload length, at most FLASHLOG_MAX_PAYLOAD
+ *
+ * @return            -  FLASHLOG_OK, FLASHLOG_ERR_PARAM or FLASHLOG_ERR_FLASH
+ *
+ * @Note              -  thread context. A rotation erases a sector and drops the records in it.
+ * 						 A record which failed to program is not used again, its words are skipped
+
+ *********************************************************************/
+uint8_t FlashLog_Append(FlashLog_Handle_t *pLogHandle, uint8_t Type, uint32_t Timestamp, const void *pData, uint16_t Len)
+{
+	uint32_t record[(FLASHLOG_RECORD_OVERHEAD + FLASHLOG_MAX_PAYLOAD) / 4];
+	uint32_t span = FLASHLOG_SPAN(Len);
+	uint32_t addr;
+	uint8_t status;
+
+	if((Len > FLASHLOG_MAX_PAYLOAD) || (Len && !pData))
+		return FLASHLOG_ERR_PARAM;
+
+	// 1. Rotate, the older sector is erased and takes over
+	if(span > FlashLog_End(pLogHandle, pLogHandle->Active) - pLogHandle->WriteAddr)
+	{
+		uint8_t next = pLogHandle->Active ^ 1;
+
+		if(FlashLog_Format(pLogHandle, next, pLogHandle->Seq + 1) != FLASHLOG_OK)
+			return FLASHLOG_ERR_FLASH;
+
+		pLogHandle->OldValid = 1;
+		pLogHandle->OldEnd = pLogHandle->WriteAddr;
+		pLogHandle->Records[0] = pLogHandle->Records[1];
+		pLogHandle->Records[1] = 0;
+		pLogHandle->Active = next;
+		pLogHandle->Seq++;
+		pLogHandle->WriteAddr = FlashLog_Base(pLogHandle, next) + FLASHLOG_SECTOR_HEADER;
+	}
+
+	// 2. Build the record, the commit word goes last
+	memset(record, 0xFF, span);
+	record[0] = ((uint32_t)FLASHLOG_MARKER << 24) | ((uint32_t)Type << 16) | Len;
+	record[1] = Timestamp;
+	if(Len)
+		memcpy(&record[2], pData, Len);
+	record[(span / 4) - 1] = Crc_CRC32(record, span - 4);
+
+	// 3. Program, the words are used up even if programming failed
+	addr = pLogHandle->WriteAddr;
+	pLogHandle->WriteAddr += span;
+
+	FLASH_Unlock();
+	status = FLASH_Program(addr, record, span, pLogHandle->FlashLog_Config.VoltageRange);
+	FLASH_Lock();
+
+	if(status != FLASH_OK)
+		return FLASHLOG_ERR_FLASH;
+
+	pLogHandle->LastAddr = addr;
+	pLogHandle->Records[1]++;
+
+	return FLASHLOG_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - FlashLog_GetLast
+ *
+ * @brief             - Returns the newest record
+ *
+ * @param[in]         - flash log handle
+ * @param[out]        - record
+ *
+ * @return            -  FLASHLOG_OK or FLASHLOG_ERR_EMPTY
+ *
+ * @Note              -  O(1), from the RAM index
+
+ *********************************************************************/
+uint8_t FlashLog_GetLast(FlashLog_Handle_t *pLogHandle, FlashLog_Record_t *pRecord)
+{
+	if(!pLogHandle->LastAddr)
+		return FLASHLOG_ERR_EMPTY;
+
+	FlashLog_Fill(pLogHandle->LastAddr, pRecord);
+
+	return FLASHLOG_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - FlashLog_First
+ *
+ * @brief             - Starts iterating the log and returns the oldest record
+ *
+ * @param[in]         - flash log handle
+ * @param[out]        - cursor
+ * @param[out]        - record
+ *
+ * @return            -  FLASHLOG_OK or FLASHLOG_ERR_EMPTY
+ *
+ * @Note              -  a rotation invalidates the cursor
+
+ *********************************************************************/
+uint8_t FlashLog_First(FlashLog_Handle_t *pLogHandle, FlashLog_Cursor_t *pCursor, FlashLog_Record_t *pRecord)
+{
+	uint8_t half = pLogHandle->OldValid ? 0 : 1;
+	uint8_t index = half ? pLogHandle->Active : (pLogHandle->Active ^ 1);
+
+	pCursor->Half = half;
+	pCursor->Addr = FlashLog_Base(pLogHandle, index) + FLASHLOG_SECTOR_HEADER;
+
+	return FlashLog_Next(pLogHandle, pCursor, pRecord);
+}
+
+/*********************************************************************
+ * @fn      		  - FlashLog_Next
+ *
+ * @brief             - Returns the next record, oldest to newest
+ *
+ * @param[in]         - flash log handle
+ * @param[in/out]     - cursor from FlashLog_First
+ * @param[out]        - record
+ *
+ * @return            -  FLASHLOG_OK or FLASHLOG_ERR_EMPTY at the end of the log
+ *
+ * @Note              -  bad records are skipped
+
+ *********************************************************************/
+uint8_t FlashLog_Next(FlashLog_Handle_t *pLogHandle, FlashLog_Cursor_t *pCursor, FlashLog_Record_t *pRecord)
+{
+	uint32_t end, addr, next;
+
+	while(1)
+	{
+		end = pCursor->Half ? pLogHandle->WriteAddr : pLogHandle->OldEnd;
+
+		while(pCursor->Addr < end)
+		{
+			addr = pCursor->Addr;
+			if(FlashLog_Parse(addr, end, &next))
+			{
+				pCursor->Addr = next;
+				FlashLog_Fill(addr, pRecord);
+				return FLASHLOG_OK;
+			}
+			pCursor->Addr = next;
+		}
+
+		if(pCursor->Half)
+			return FLASHLOG_ERR_EMPTY;
+
+		// older sector done, go on with the active one
+		pCursor->Half = 1;
+		pCursor->Addr = FlashLog_Base(pLogHandle, pLogHandle->Active) + FLASHLOG_SECTOR_HEADER;
+	}
+}
@@ -17,8 +17,45 @@
  */
 
 #include <stdint.h>
-#include "ds1307.h"
-#include <stdio.h>
+#include "rtc.h"
+#include "power.h"
+#include "sched.h"
+#include "alarm.h"
+#include "timestamp.h"
+#include "eventrec.h"
+#include "flashlog.h"
+#include "settings.h"
+#include "dualclock.h"
+#include "trim.h"
+#include "timesync.h"
+#include "timeserver.h"
+#include "crc.h"
+#include "stackmon.h"
+#include "mempool.h"
+#include "xprintf.h"
+#include "telemetry.h"
+
+#define HSI_CLOCK_HZ				16000000	// fallback when the crystal does not start, the PLL is not used
+#define HSE_CLOCK_HZ				8000000		// board crystal, reference for the RTC drift measurement
+#define HSE_STARTUP_POLLS			100000
+#define STACK_SCAN_WORDS			32			// stack words checked per idle call
+#define APP_MAX_ALARMS				64			// pending software alarms
+#define APP_EVENT_RING_SIZE			64			// recorded edges between two drains
+#define APP_SETTINGS_NVRAM_OFFSET	11			// settings block, behind the byte the RTC_Init probe writes (rtc.h)
+#define APP_EVENT_NVRAM_OFFSET		30			// last 26 bytes of the DS1307 NVRAM, 3 event slots
+#define APP_EVENT_NVRAM_LEN			26
+#define APP_FLASHLOG_SECTOR_A		10			// last two 128KB sectors, kept out of the image by the linker script
+#define APP_FLASHLOG_SECTOR_B		11
+#define APP_CLOCK_CHECK_PERIOD		60			// display refreshes between two reads of the DS1307
+#define APP_TRIM_SAVE_PPB			200			// fitted drift change written back to the settings (17ms/day)
+#define APP_SYNC_PERIOD				3600		// SQW ticks between two syncs with the host
+#define APP_SYNC_TX_PIN				GPIO_PIN_2	// USART2 on PA2 / PA3, AF7
+#define APP_SYNC_RX_PIN				GPIO_PIN_3
+#define APP_SERVER_SCL_PIN			GPIO_PIN_10	// DS1307 compatible slave on I2C2, PB10 / PB11
+#define APP_SERVER_SDA_PIN			GPIO_PIN_11
+#define APP_TELEMETRY_PERIOD		10			// SQW ticks between two telemetry snapshots
+#define APP_HIST_RESIDENCY			0			// telemetry histogram ids: ms per @POWER_MODE, wake ups per @POWER_WAKE
+#define APP_HIST_WAKEUPS			1
 
 char* get_day_of_week(uint8_t i);
 
@@ -28,50 +65,391 @@ char* time_to_string(RTC_Handle_time_t *time);
 
 char* date_to_string(RTC_Handle_date_t *date);
 
+void display_refresh(void *pArg);
+
+void time_sync(void *pArg);
+
+void telemetry_send(void *pArg);
+
+void sync_usart_init(void);
+
+void app_idle(void);
+
+void app_event_sink(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped);
+
+Power_Handle_t powerHandle __CCMRAM_BSS;
+Sched_Handle_t schedHandle __CCMRAM_BSS;
+Sched_Timer_t displayTimer __CCMRAM_BSS;
+Sched_Timer_t syncTimer __CCMRAM_BSS;
+Sched_Timer_t telemetryTimer __CCMRAM_BSS;
+StackMon_Handle_t stackMonHandle __CCMRAM_BSS;
+Alarm_Handle_t alarmHandle __CCMRAM_BSS;
+Alarm_t *alarmHeap[APP_MAX_ALARMS] __CCMRAM_BSS;
+Timestamp_Handle_t tsHandle __CCMRAM_BSS;
+EventRec_Handle_t eventHandle __CCMRAM_BSS;
+EventRec_Event_t eventRing[APP_EVENT_RING_SIZE] __CCMRAM_BSS;
+EventRec_NVRAMLog_t eventLog;
+FlashLog_Handle_t flashLogHandle;
+Settings_Handle_t settingsHandle;
+IRTC_Handle_t irtcHandle;
+DualClock_Handle_t dualClockHandle;
+Trim_Handle_t trimHandle;
+USART_Handle_t syncUSART;
+TimeSync_Handle_t syncHandle;
+TimeServer_Handle_t serverHandle;
+Telemetry_Handle_t tlmHandle __DMA_RAM;
+uint32_t coreClockHz = HSI_CLOCK_HZ;
+const EventRec_Line_t eventLines[] =
+{
+	{GPIOA, GPIO_PIN_0, GPIO_MODE_IT_RFT, GPIO_PUPD_NONE},		// user button, both edges
+};
+RTC_Handle_t rtcHandle;
 
 int main(void)
 {
 	RTC_Handle_time_t time;
 	RTC_Handle_date_t date;
 
-	printf("RTC Test\n");
+	// the MSP stack was painted by Reset_Handler
+	stackMonHandle.StackMon_Config.pBottom = &_sstack;
+	stackMonHandle.StackMon_Config.pTop = &_estack;
+	stackMonHandle.StackMon_Config.Guard = ENABLE;
+	StackMon_Init(&stackMonHandle);
+
+	// pools before the first ISR or C library call can allocate
+	Mempool_Init();
+
+	// HSE before any peripheral is set up, the baud rates follow PCLK1
+	if(RCC_SetSysClkHSE(HSE_STARTUP_POLLS) == 0)
+		coreClockHz = HSE_CLOCK_HZ;
+
+	// CRC unit for the settings, flash log and telemetry checks
+	Crc_Init();
+
+	XPrintf("RTC Test\n");
 
-	if(RTC_DS1307_Init())
+	// binary records on SWO next to the text, USART2 carries the time sync
+	Telemetry_Init(&tlmHandle, Telemetry_SinkITM, NULL);
+
+	rtcHandle.RTC_Config.pI2Cx = RTC_BOARD_I2C;
+	rtcHandle.RTC_Config.I2C_SCLSpeed = RTC_BOARD_I2C_SPEED;
+	rtcHandle.RTC_Config.pSCLPort = RTC_BOARD_SCL_PORT;
+	rtcHandle.RTC_Config.SCLPin = RTC_BOARD_SCL_PIN;
+	rtcHandle.RTC_Config.pSDAPort = RTC_BOARD_SDA_PORT;
+	rtcHandle.RTC_Config.SDAPin = RTC_BOARD_SDA_PIN;
+	rtcHandle.RTC_Config.pSQWPort = RTC_BOARD_SQW_PORT;
+	rtcHandle.RTC_Config.SQWPin = RTC_BOARD_SQW_PIN;
+	rtcHandle.RTC_Config.SQWIRQ = RTC_BOARD_SQW_IRQ;
+
+	if(RTC_Init(&rtcHandle))
 	{
-		printf("RTC init failed\n");
+		XPrintf("RTC init failed\n");
 		while(1);
 	}
 
-	date.day = THURSDAY;
-	date.date = 21;
-	date.month = 11;
-	date.year = 24;
+	// warm boot: valid settings in the NVRAM, defaults are written back otherwise
+	settingsHandle.Settings_Config.pRTCHandle = &rtcHandle;
+	settingsHandle.Settings_Config.Offset = APP_SETTINGS_NVRAM_OFFSET;
+	if(Settings_Load(&settingsHandle) != SETTINGS_OK)
+		Settings_Save(&settingsHandle);
+
+	// on-chip RTC as the second clock, LSI if no 32.768kHz crystal is fitted (the cross-check then resyncs it)
+	irtcHandle.IRTC_Config.ClockSource = IRTC_CLOCK_LSE;
+	if(IRTC_Init(&irtcHandle) != IRTC_OK)
+	{
+		irtcHandle.IRTC_Config.ClockSource = IRTC_CLOCK_LSI;
+		if(IRTC_Init(&irtcHandle) != IRTC_OK)
+		{
+			XPrintf("IRTC init failed\n");
+			while(1);
+		}
+	}
+
+	// one RTC running on battery restores the other. Both lost: a placeholder until the host syncs
+	dualClockHandle.DualClock_Config.pRTCHandle = &rtcHandle;
+	dualClockHandle.DualClock_Config.pIRTCHandle = &irtcHandle;
+	dualClockHandle.DualClock_Config.CheckPeriod = APP_CLOCK_CHECK_PERIOD;
+	dualClockHandle.DualClock_Config.Tolerance = DUALCLOCK_DEFAULT_TOLERANCE;
+	dualClockHandle.DualClock_Config.TimeFormat = settingsHandle.Settings.TimeFormat;
+	if(DualClock_Init(&dualClockHandle) == DUALCLOCK_ERR_LOST)
+	{
+		date.day = THURSDAY;
+		date.date = 21;
+		date.month = 11;
+		date.year = 24;
+
+		time.timeFormat = settingsHandle.Settings.TimeFormat;
+		time.hours = 11;
+		time.minutes = 13;
+		time.seconds = 0;
+
+		DualClock_SetDateTime(&dualClockHandle, &time, &date);
+	}
+	DualClock_GetDateTime(&dualClockHandle, &time, &date);
+
+	// TIM2 runs at the APB1 timer clock, phase within the RTC second for timestamps
+	tsHandle.Timestamp_Config.pTIMx = TIM2;
+	tsHandle.Timestamp_Config.TimerClockHz = coreClockHz;
+	Timestamp_Init(&tsHandle);
+
+	// DS1307 drift, measured against TIM2 when it runs from the crystal, the last fit is kept in the settings
+	trimHandle.Trim_Config.pTsHandle = &tsHandle;
+	trimHandle.Trim_Config.pRTCHandle = &rtcHandle;
+	trimHandle.Trim_Config.ReferenceHz = coreClockHz;
+	trimHandle.Trim_Config.WindowSeconds = TRIM_DEFAULT_WINDOW;
+	trimHandle.Trim_Config.Measure = (coreClockHz == HSE_CLOCK_HZ) ? ENABLE : DISABLE;
+	trimHandle.Trim_Config.InitialPPB = settingsHandle.Settings.DriftPPB;
+	Trim_Init(&trimHandle);
+
+	// time from the host over USART2 (tools/timesync), slewed in and then written to the DS1307
+	sync_usart_init();
+	syncHandle.TimeSync_Config.pUSARTHandle = &syncUSART;
+	syncHandle.TimeSync_Config.IRQNumber = IRQ_USART2;
+	syncHandle.TimeSync_Config.IRQPriority = 2;
+	syncHandle.TimeSync_Config.pTsHandle = &tsHandle;
+	syncHandle.TimeSync_Config.pRTCHandle = &rtcHandle;
+	syncHandle.TimeSync_Config.TimeFormat = settingsHandle.Settings.TimeFormat;
+	syncHandle.TimeSync_Config.SyncPeriod = APP_SYNC_PERIOD;
+	TimeSync_Init(&syncHandle);
+
+	// other boards read the synced time from us as if we were their DS1307
+	serverHandle.TimeServer_Config.pI2Cx = I2C2;
+	serverHandle.TimeServer_Config.pSCLPort = GPIOB;
+	serverHandle.TimeServer_Config.SCLPin = APP_SERVER_SCL_PIN;
+	serverHandle.TimeServer_Config.pSDAPort = GPIOB;
+	serverHandle.TimeServer_Config.SDAPin = APP_SERVER_SDA_PIN;
+	serverHandle.TimeServer_Config.Address = TIMESERVER_DEFAULT_ADDRESS;
+	serverHandle.TimeServer_Config.EVIRQNumber = IRQ_I2C2_EV;
+	serverHandle.TimeServer_Config.ERIRQNumber = IRQ_I2C2_ER;
+	serverHandle.TimeServer_Config.IRQPriority = 2;
+	serverHandle.TimeServer_Config.pTsHandle = &tsHandle;
+	TimeServer_Init(&serverHandle);
+
+	// edges on the event lines are kept in the RTC NVRAM (last few) and the flash log (history)
+	flashLogHandle.FlashLog_Config.Sector[0] = APP_FLASHLOG_SECTOR_A;
+	flashLogHandle.FlashLog_Config.Sector[1] = APP_FLASHLOG_SECTOR_B;
+	flashLogHandle.FlashLog_Config.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+	FlashLog_Init(&flashLogHandle);
+
+	eventLog.pRTCHandle = &rtcHandle;
+	eventLog.Offset = APP_EVENT_NVRAM_OFFSET;
+	eventLog.Len = APP_EVENT_NVRAM_LEN;
+	eventHandle.EventRec_Config.pTsHandle = &tsHandle;
+	eventHandle.EventRec_Config.pStorage = eventRing;
+	eventHandle.EventRec_Config.Size = APP_EVENT_RING_SIZE;
+	eventHandle.EventRec_Config.pLines = eventLines;
+	eventHandle.EventRec_Config.NoOfLines = sizeof(eventLines) / sizeof(eventLines[0]);
+	eventHandle.EventRec_Config.IRQPriority = 1;
+	eventHandle.EventRec_Config.pfnSink = app_event_sink;
+	eventHandle.EventRec_Config.pSinkCtx = NULL;
+	EventRec_Init(&eventHandle);
+
+	// 1Hz square wave on SQW wakes the core up once per second
+	RTC_SetSquareWave(&rtcHandle, RTC_SQW_1HZ);
+	RTC_SQWPinConfig(&rtcHandle);
+
+	powerHandle.Power_Config.CoreClockHz = coreClockHz;
+	// not STOP, TIM2 has to keep counting between SQW edges
+	powerHandle.Power_Config.IdleMode = POWER_MODE_SLEEP;
+	powerHandle.Power_Config.LowPowerRegulator = ENABLE;
+	Power_Init(&powerHandle);
+
+	// one scheduler tick per SQW second
+	Sched_Init(&schedHandle);
+	schedHandle.pfnIdle = app_idle;
+	Sched_TimerStart(&schedHandle, &displayTimer, 1, settingsHandle.Settings.RefreshSeconds, display_refresh, NULL);
+	Sched_TimerStart(&schedHandle, &syncTimer, 1, 1, time_sync, NULL);
+	Sched_TimerStart(&schedHandle, &telemetryTimer, APP_TELEMETRY_PERIOD, APP_TELEMETRY_PERIOD, telemetry_send, NULL);
+
+	// software alarms count SQW ticks from the RTC time at boot
+	alarmHandle.Alarm_Config.pSched = &schedHandle;
+	alarmHandle.Alarm_Config.ppHeap = alarmHeap;
+	alarmHandle.Alarm_Config.Capacity = APP_MAX_ALARMS;
+	Alarm_Init(&alarmHandle, RTC_toEpoch(&time, &date));
+
+	Sched_Run(&schedHandle);
+
+	return 0;
+}
+
+void sync_usart_init(void)
+{
+	GPIO_Handle_t pin;
+
+	pin.pGPIOx = GPIOA;
+	pin.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	pin.GPIO_PinConfig.GPIO_PinAltFunMode = GPIO_ALTFN_AF7;
+	pin.GPIO_PinConfig.GPIO_PinOPType = GPIO_OUT_TYPE_PP;
+	pin.GPIO_PinConfig.GPIO_PinPuPdControl = GPIO_PUPD_PULLUP;
+	pin.GPIO_PinConfig.GPIO_PinSpeed = GPIO_OUT_SPEED_HIGH;
+	pin.GPIO_PinConfig.GPIO_PinNumber = APP_SYNC_TX_PIN;
+	GPIO_Init(&pin);
+	pin.GPIO_PinConfig.GPIO_PinNumber = APP_SYNC_RX_PIN;
+	GPIO_Init(&pin);
+
+	syncUSART.pUSARTx = USART2;
+	syncUSART.USART_Config.USART_Mode = USART_MODE_TXRX;
+	syncUSART.USART_Config.USART_Baud = USART_STD_BAUD_115200;
+	syncUSART.USART_Config.USART_NoOfStopBits = USART_STOPBITS_1;
+	syncUSART.USART_Config.USART_WordLength = USART_WORDLEN_8BITS;
+	syncUSART.USART_Config.USART_ParityControl = USART_PARITY_DISABLE;
+	syncUSART.USART_Config.USART_HWFlowControl = USART_HW_FLOW_CTRL_NONE;
+	USART_PeriClockControl(USART2, ENABLE);
+	USART_Init(&syncUSART);
+	USART_PeripheralControl(USART2, ENABLE);
+}
+
+void time_sync(void *pArg)
+{
+	Timestamp_t now;
+	uint8_t events;
+	(void)pArg;
+
+	events = TimeSync_Poll(&syncHandle);
+
+	TimeSync_Get(&syncHandle, &now);
+	TimeServer_Publish(&serverHandle, &now);
+
+	if(events & TIMESYNC_EV_SYNCED)
+		XPrintf("Time sync: offset %ld s %ld us, delay %ld us\n", (long)(syncHandle.LastOffsetUs / 1000000),
+			   (long)(syncHandle.LastOffsetUs % 1000000), (long)syncHandle.LastDelayUs);
+
+	// the DS1307 took the time, everything counting its seconds follows
+	if(events & TIMESYNC_EV_COMMITTED)
+	{
+		DualClock_Resync(&dualClockHandle);
+		Alarm_Resync(&alarmHandle, DualClock_GetEpoch(&dualClockHandle));
+		Trim_NotifyTimeSet(&trimHandle);
+	}
+}
+
+void telemetry_send(void *pArg)
+{
+	Timestamp_t now;
+	uint32_t bins[POWER_NO_OF_MODES];
+	(void)pArg;
 
-	time.timeFormat = RTC_DS1307_TIME_FORMAT_12HRS_PM;
-	time.hours = 11;
-	time.minutes = 13;
-	time.seconds = 0;
+	TimeSync_Get(&syncHandle, &now);
+	Telemetry_PutTimestamp(&tlmHandle, now.Seconds);
 
-	RTC_DS1307_setTime(&time);
-	RTC_DS1307_setFullDate(&date);
+	// bus errors of the DS1307 bus and of the time server
+	Telemetry_PutI2CErrors(&tlmHandle, &rtcHandle.I2C_Handle);
+	Telemetry_PutI2CErrors(&tlmHandle, &serverHandle.I2CHandle);
 
+	for(uint8_t i = 0; i < POWER_NO_OF_MODES; i++)
+		bins[i] = Power_GetResidencyMs(&powerHandle, i);
+	Telemetry_PutHistogram(&tlmHandle, APP_HIST_RESIDENCY, bins, POWER_NO_OF_MODES);
+	Telemetry_PutHistogram(&tlmHandle, APP_HIST_WAKEUPS, powerHandle.Wakeups, POWER_NO_OF_WAKE_SRC);
+}
 
-	RTC_DS1307_getTime(&time);
-	RTC_DS1307_getFullDate(&date);
+void display_refresh(void *pArg)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	Timestamp_t now;
+	uint32_t extEpoch;
+	int32_t driftPPB;
+	(void)pArg;
+
+	// software trim of the DS1307, a step moves everything counting RTC seconds along
+	if(Trim_Poll(&trimHandle) != 0)
+	{
+		DualClock_Resync(&dualClockHandle);
+		Timestamp_Sync(&tsHandle, DualClock_GetEpoch(&dualClockHandle));
+		Alarm_Resync(&alarmHandle, DualClock_GetEpoch(&dualClockHandle));
+	}
+
+	driftPPB = Trim_GetDriftPPB(&trimHandle);
+	if(Trim_IsConverged(&trimHandle) &&
+	   ((driftPPB - settingsHandle.Settings.DriftPPB >= APP_TRIM_SAVE_PPB) || (settingsHandle.Settings.DriftPPB - driftPPB >= APP_TRIM_SAVE_PPB)))
+	{
+		settingsHandle.Settings.DriftPPB = driftPPB;
+		Settings_Save(&settingsHandle);
+	}
+
+	// software clock, no I2C. Monotonic, a sync slews it instead of moving it back
+	TimeSync_Get(&syncHandle, &now);
+	RTC_fromEpoch(now.Seconds, &time, &date);
+	RTC_From24Hours(&time, settingsHandle.Settings.TimeFormat);
+
+	// the DS1307 is only read for the cross-check, not while it runs in a phase the timestamps do not know yet
+	if(!syncHandle.CommitPending && DualClock_Poll(&dualClockHandle, &extEpoch))
+	{
+		// runs right after the SQW tick, so this is the time of the last edge
+		Timestamp_Sync(&tsHandle, extEpoch);
+		if(DualClock_IsDiverged(&dualClockHandle))
+		{
+			XPrintf("Clocks %ld s apart, resync\n", (long)dualClockHandle.Diff);
+			DualClock_Resync(&dualClockHandle);
+		}
+	}
+	EventRec_Drain(&eventHandle, APP_EVENT_RING_SIZE);
 
 	char *ampm;
-	if(time.timeFormat != RTC_DS1307_TIME_FORMAT_24HRS)
+	if(time.timeFormat != RTC_TIME_FORMAT_24HRS)
 	{
 		ampm = (time.timeFormat) ? "PM" : "AM";
-		printf("Current Time: %s %s",time_to_string(&time),ampm);
+		XPrintf("Current Time: %s %s\n",time_to_string(&time),ampm);
 	}else
 	{
-		printf("Current Time: %s\n",time_to_string(&time));
+		XPrintf("Current Time: %s\n",time_to_string(&time));
 	}
 
-	printf("Current Date: %s <%s> \n",date_to_string(&date),get_day_of_week(date.day));
+	if(settingsHandle.Settings.DisplayFlags & SETTINGS_DISPLAY_WEEKDAY)
+		XPrintf("Current Date: %s <%s> \n",date_to_string(&date),get_day_of_week(date.day));
+	else if(settingsHandle.Settings.DisplayFlags & SETTINGS_DISPLAY_DATE)
+		XPrintf("Current Date: %s\n",date_to_string(&date));
+}
 
-	return 0;
+void app_event_sink(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped)
+{
+	(void)pCtx;
+
+	EventRec_SinkNVRAM(&eventLog, pRecords, Count, Dropped);
+	EventRec_SinkFlashLog(&flashLogHandle, pRecords, Count, Dropped);
+	EventRec_SinkTelemetry(&tlmHandle, pRecords, Count, Dropped);
+}
+
+void app_idle(void)
+{
+	// called by the scheduler with interrupts masked, sleeps till the next interrupt
+	StackMon_Scan(&stackMonHandle, STACK_SCAN_WORDS);
+	Power_Idle(&powerHandle);
+}
+
+__RAMFUNC void EXTI9_5_IRQHandler(void)
+{
+	Timestamp_Edge(&tsHandle);
+	GPIO_IRQHandling(RTC_BOARD_SQW_PIN);
+	Power_NotifyWake(&powerHandle, POWER_WAKE_SQW);
+	Sched_Tick(&schedHandle);
+}
+
+__RAMFUNC void EXTI0_IRQHandler(void)
+{
+	EventRec_IRQHandling(&eventHandle);
+}
+
+__RAMFUNC void I2C2_EV_IRQHandler(void)
+{
+	I2C_EV_IRQHandling(&serverHandle.I2CHandle);
+}
+
+__RAMFUNC void I2C2_ER_IRQHandler(void)
+{
+	I2C_ER_IRQHandling(&serverHandle.I2CHandle);
+}
+
+__RAMFUNC void I2C_ApplicationEventCallback(I2C_Handle_t *pI2CHandle, uint8_t AppEv)
+{
+	if(pI2CHandle == &serverHandle.I2CHandle)
+		TimeServer_EventHandling(&serverHandle, AppEv);
+}
+
+__RAMFUNC void USART2_IRQHandler(void)
+{
+	TimeSync_IRQHandling(&syncHandle);
+	Power_NotifyWake(&powerHandle, POWER_WAKE_UART);
 }
 
 char* get_day_of_week(uint8_t i)
@@ -0,0 +1,306 @@
+/*
+ * mempool.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "mempool.h"
+#include <stddef.h>
+
+#if MEMPOOL_IN_CCMRAM
+#define MEMPOOL_ARENA_ATTR				__CCMRAM_BSS __attribute__((aligned(8)))
+#else
+#define MEMPOOL_ARENA_ATTR				__attribute__((aligned(8)))
+#endif
+
+static const uint32_t Mempool_ClassSize[MEMPOOL_NUM_CLASSES] = {
+	MEMPOOL_CLASS0_SIZE, MEMPOOL_CLASS1_SIZE, MEMPOOL_CLASS2_SIZE,
+	MEMPOOL_CLASS3_SIZE, MEMPOOL_CLASS4_SIZE, MEMPOOL_CLASS5_SIZE
+};
+
+static const uint32_t Mempool_ClassCount[MEMPOOL_NUM_CLASSES] = {
+	MEMPOOL_CLASS0_COUNT, MEMPOOL_CLASS1_COUNT, MEMPOOL_CLASS2_COUNT,
+	MEMPOOL_CLASS3_COUNT, MEMPOOL_CLASS4_COUNT, MEMPOOL_CLASS5_COUNT
+};
+
+static uint8_t Mempool_Arena[MEMPOOL_ARENA_SIZE] MEMPOOL_ARENA_ATTR;
+static Mempool_Pool_t Mempool_Pools[MEMPOOL_NUM_CLASSES];
+static uint32_t Mempool_Failures;
+static uint32_t Mempool_BytesInUse;
+static uint32_t Mempool_BytesHighWater;
+static uint32_t Mempool_AllocMap[(MEMPOOL_NUM_BLOCKS + 31) / 32];
+static uint8_t Mempool_Initialized;
+
+static Mempool_Pool_t* Mempool_FindPool(void *pBlock);
+static void Mempool_Build(void);
+
+/*
+ * Helper functions
+ */
+static Mempool_Pool_t* Mempool_FindPool(void *pBlock)
+{
+	uint8_t *p = (uint8_t*)pBlock;
+
+	for(uint8_t i = 0; i < MEMPOOL_NUM_CLASSES; i++)
+	{
+		if(p >= Mempool_Pools[i].pStart && p < Mempool_Pools[i].pEnd)
+			return &Mempool_Pools[i];
+	}
+
+	return NULL;
+}
+
+static void Mempool_Build(void)
+{
+	uint8_t *p = Mempool_Arena;
+	uint32_t block = 0;
+
+	if(Mempool_Initialized)
+		return;
+
+	for(uint8_t i = 0; i < MEMPOOL_NUM_CLASSES; i++)
+	{
+		Mempool_Pool_t *pPool = &Mempool_Pools[i];
+
+		pPool->pStart = p;
+		pPool->BlockSize = Mempool_ClassSize[i];
+		pPool->NumBlocks = Mempool_ClassCount[i];
+		pPool->FirstBlock = block;
+		pPool->pFree = NULL;
+
+		// link the blocks back to front so the list starts at the lowest address
+		for(uint32_t j = pPool->NumBlocks; j > 0; j--)
+		{
+			void **pBlock = (void**)(p + ((j - 1) * pPool->BlockSize));
+			*pBlock = pPool->pFree;
+			pPool->pFree = pBlock;
+		}
+
+		p += pPool->BlockSize * pPool->NumBlocks;
+		block += pPool->NumBlocks;
+		pPool->pEnd = p;
+	}
+
+	Mempool_Initialized = 1;
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_Init
+ *
+ * @brief             - Carves the arena into the size classes and builds the free lists
+ *
+ * @param[in]         - none
+ *
+ * @return            -  none
+ *
+ * @Note              -  called from startup, else on the first allocation. Calling it again does
+ * 						 nothing. ISR safe
+
+ *********************************************************************/
+void Mempool_Init(void)
+{
+	uint32_t primask = __GET_PRIMASK();
+
+	// an ISR allocating meanwhile must not see half built free lists
+	__DISABLE_IRQ();
+	Mempool_Build();
+	__SET_PRIMASK(primask);
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_Alloc
+ *
+ * @brief             - Allocates a block of at least Size bytes
+ *
+ * @param[in]         - size in bytes
+ *
+ * @return            -  8 byte aligned block, NULL if nothing fits
+ *
+ * @Note              -  ISR safe
+
+ *********************************************************************/
+void* Mempool_Alloc(uint32_t Size)
+{
+	void **pBlock = NULL;
+	uint8_t bestFit = 1;
+	uint32_t primask, idx;
+
+	if(Size == 0)
+		Size = 1;
+
+	primask = __GET_PRIMASK();
+	__DISABLE_IRQ();
+
+	Mempool_Build();
+
+	for(uint8_t i = 0; i < MEMPOOL_NUM_CLASSES; i++)
+	{
+		Mempool_Pool_t *pPool = &Mempool_Pools[i];
+
+		if(Size > pPool->BlockSize)
+			continue;
+
+		if(pPool->pFree == NULL)
+		{
+			if(bestFit)
+				pPool->Exhausted++;
+			bestFit = 0;
+			continue;
+		}
+
+		pBlock = (void**)pPool->pFree;
+		pPool->pFree = *pBlock;
+		idx = pPool->FirstBlock + ((uint8_t*)pBlock - pPool->pStart) / pPool->BlockSize;
+		Mempool_AllocMap[idx / 32] |= (1UL << (idx % 32));
+		pPool->Allocs++;
+		if(++pPool->InUse > pPool->HighWater)
+			pPool->HighWater = pPool->InUse;
+
+		Mempool_BytesInUse += pPool->BlockSize;
+		if(Mempool_BytesInUse > Mempool_BytesHighWater)
+			Mempool_BytesHighWater = Mempool_BytesInUse;
+		break;
+	}
+
+	if(pBlock == NULL)
+		Mempool_Failures++;
+
+	__SET_PRIMASK(primask);
+
+	return pBlock;
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_Free
+ *
+ * @brief             - Returns a block to its size class
+ *
+ * @param[in]         - block returned by Mempool_Alloc. NULL is ignored
+ *
+ * @return            -  none
+ *
+ * @Note              -  ISR safe. Pointers outside the arena are ignored, misaligned ones and
+ * 						 double frees are counted in BadFrees and ignored
+
+ *********************************************************************/
+void Mempool_Free(void *pBlock)
+{
+	Mempool_Pool_t *pPool = Mempool_FindPool(pBlock);
+	uint32_t primask, offset, idx;
+
+	if(pPool == NULL)
+		return;
+
+	offset = (uint32_t)((uint8_t*)pBlock - pPool->pStart);
+	idx = pPool->FirstBlock + offset / pPool->BlockSize;
+
+	primask = __GET_PRIMASK();
+	__DISABLE_IRQ();
+
+	// inside a block or not allocated (double free): linking it would corrupt the free list
+	if((offset % pPool->BlockSize) || !(Mempool_AllocMap[idx / 32] & (1UL << (idx % 32))))
+	{
+		pPool->BadFrees++;
+		__SET_PRIMASK(primask);
+		return;
+	}
+	Mempool_AllocMap[idx / 32] &= ~(1UL << (idx % 32));
+
+	*(void**)pBlock = pPool->pFree;
+	pPool->pFree = pBlock;
+	pPool->InUse--;
+	Mempool_BytesInUse -= pPool->BlockSize;
+
+	__SET_PRIMASK(primask);
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_BlockSize
+ *
+ * @brief             - Returns the usable size of an allocated block
+ *
+ * @param[in]         - block
+ *
+ * @return            -  size in bytes, 0 if the pointer is not from the pool
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t Mempool_BlockSize(void *pBlock)
+{
+	Mempool_Pool_t *pPool = Mempool_FindPool(pBlock);
+
+	return pPool ? pPool->BlockSize : 0;
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_GetPool
+ *
+ * @brief             - Returns the state and counters of a size class
+ *
+ * @param[in]         - class index, 0 to MEMPOOL_NUM_CLASSES-1
+ *
+ * @return            -  size class, NULL for an invalid index
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+const Mempool_Pool_t* Mempool_GetPool(uint8_t ClassIdx)
+{
+	if(ClassIdx >= MEMPOOL_NUM_CLASSES)
+		return NULL;
+
+	return &Mempool_Pools[ClassIdx];
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_GetFailures
+ *
+ * @brief             - Returns the number of allocations which returned NULL
+ *
+ * @param[in]         - none
+ *
+ * @return            -  count
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t Mempool_GetFailures(void)
+{
+	return Mempool_Failures;
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_GetBytesInUse
+ *
+ * @brief             - Returns the bytes allocated now (whole blocks)
+ *
+ * @param[in]         - none
+ *
+ * @return            -  bytes
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t Mempool_GetBytesInUse(void)
+{
+	return Mempool_BytesInUse;
+}
+
+/*********************************************************************
+ * @fn      		  - Mempool_GetBytesHighWater
+ *
+ * @brief             - Returns the maximum of the bytes allocated at the same time (whole blocks)
+ *
+ * @param[in]         - none
+ *
+ * @return            -  bytes
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t Mempool_GetBytesHighWater(void)
+{
+	return Mempool_BytesHighWater;
+}
@@ -0,0 +1,202 @@
+/*
+ * power.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "power.h"
+#include <string.h>
+
+static void Power_RestoreClocks(uint32_t savedCR, uint32_t savedCFGR);
+static void Power_CloseSecond(Power_Handle_t *pPowerHandle);
+
+/*
+ * Helper functions
+ */
+static void Power_RestoreClocks(uint32_t savedCR, uint32_t savedCFGR)
+{
+	uint32_t sw = (savedCFGR >> RCC_CFGR_SW) & 0x3;
+
+	// 1. STOP switches off HSE and PLL. Turn them back on if they were on before
+	if(savedCR & (1 << RCC_CR_HSEON))
+	{
+		RCC->CR |= (1 << RCC_CR_HSEON);
+		while(!(RCC->CR & (1 << RCC_CR_HSERDY)));
+	}
+	if(savedCR & (1 << RCC_CR_PLLON))
+	{
+		RCC->CR |= (1 << RCC_CR_PLLON);
+		while(!(RCC->CR & (1 << RCC_CR_PLLRDY)));
+	}
+
+	// 2. Switch SYSCLK back to the old source and wait till the switch is done
+	RCC->CFGR = (RCC->CFGR & ~(0x3 << RCC_CFGR_SW)) | (sw << RCC_CFGR_SW);
+	while(((RCC->CFGR >> RCC_CFGR_SWS) & 0x3) != sw);
+}
+
+static void Power_CloseSecond(Power_Handle_t *pPowerHandle)
+{
+	uint32_t second = pPowerHandle->Power_Config.CoreClockHz;
+	uint32_t run = pPowerHandle->RunCycles;
+
+	if(run > second)
+		run = second;
+
+	pPowerHandle->Cycles[POWER_MODE_RUN] += run;
+	pPowerHandle->Cycles[pPowerHandle->DeepestMode] += (second - run);
+
+	pPowerHandle->RunCycles = 0;
+	pPowerHandle->DeepestMode = POWER_MODE_RUN;
+	pPowerHandle->Seconds++;
+}
+
+/*********************************************************************
+ * @fn      		  - Power_Init
+ *
+ * @brief             - Initializes the power manager and starts the DWT cycle counter
+ *
+ * @param[in]         - power handle with Power_Config filled in
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Power_Init(Power_Handle_t *pPowerHandle)
+{
+	Power_Config_t config = pPowerHandle->Power_Config;
+
+	memset(pPowerHandle, 0, sizeof(*pPowerHandle));
+	pPowerHandle->Power_Config = config;
+
+	// 1. PWR registers are needed for STOP configuration
+	PWR_CLK_EN();
+
+	// 2. start the cycle counter
+	*CORE_DEMCR |= (1 << CORE_DEMCR_TRCENA);
+	*DWT_CTRL |= (1 << DWT_CTRL_CYCCNTENA);
+
+	pPowerHandle->WakeStamp = *DWT_CYCCNT;
+}
+
+/*********************************************************************
+ * @fn      		  - Power_Idle
+ *
+ * @brief             - Enters the configured low power mode until a wake source
+ * 						calls Power_NotifyWake
+ *
+ * @param[in]         - power handle
+ *
+ * @return            -  bit mask of @POWER_WAKE. 0 if the core was woken by an interrupt
+ * 						 which is not a wake source
+ *
+ * @Note              -  interrupts are masked (PRIMASK) around the WFI. A pending interrupt
+ * 						 still wakes the core, but its ISR only runs after the clocks are restored
+
+ *********************************************************************/
+uint8_t Power_Idle(Power_Handle_t *pPowerHandle)
+{
+	uint8_t mode = pPowerHandle->Power_Config.IdleMode;
+	uint32_t savedCR = 0, savedCFGR = 0;
+	uint8_t wake;
+
+	__DISABLE_IRQ();
+
+	// 1. book the run time since the last wake up
+	pPowerHandle->RunCycles += *DWT_CYCCNT - pPowerHandle->WakeStamp;
+
+	// 2. only sleep if no wake event arrived while we were running
+	if(pPowerHandle->PendingWake == 0)
+	{
+		pPowerHandle->Entries[mode]++;
+		if(mode > pPowerHandle->DeepestMode)
+			pPowerHandle->DeepestMode = mode;
+
+		if(mode == POWER_MODE_STOP)
+		{
+			savedCR = RCC->CR;
+			savedCFGR = RCC->CFGR;
+
+			// STOP (not standby) with the regulator as configured
+			PWR->CR &= ~(1 << PWR_CR_PDDS);
+			if(pPowerHandle->Power_Config.LowPowerRegulator == ENABLE)
+				PWR->CR |= (1 << PWR_CR_LPDS);
+			else
+				PWR->CR &= ~(1 << PWR_CR_LPDS);
+
+			*SCB_SCR |= (1 << SCB_SCR_SLEEPDEEP);
+		}
+		else
+		{
+			*SCB_SCR &= ~(1 << SCB_SCR_SLEEPDEEP);
+		}
+
+		__WFI();
+
+		if(mode == POWER_MODE_STOP)
+		{
+			*SCB_SCR &= ~(1 << SCB_SCR_SLEEPDEEP);
+			Power_RestoreClocks(savedCR, savedCFGR);
+		}
+	}
+
+	pPowerHandle->WakeStamp = *DWT_CYCCNT;
+
+	// 3. let the pending ISRs run. The wake source ISRs set PendingWake
+	__ENABLE_IRQ();
+
+	__DISABLE_IRQ();
+	wake = pPowerHandle->PendingWake;
+	pPowerHandle->PendingWake = 0;
+	__ENABLE_IRQ();
+
+	// 4. wake source bookkeeping
+	for(uint8_t i = 0; i < POWER_NO_OF_WAKE_SRC; i++)
+	{
+		if(wake & (1 << i))
+			pPowerHandle->Wakeups[i]++;
+	}
+
+	if(wake & (1 << POWER_WAKE_SQW))
+		Power_CloseSecond(pPowerHandle);
+
+	return wake;
+}
+
+/*********************************************************************
+ * @fn      		  - Power_NotifyWake
+ *
+ * @brief             - Marks a wake event. Called from the wake source ISRs
+ *
+ * @param[in]         - power handle
+ * @param[in]         - wake source (@POWER_WAKE)
+ *
+ * @return            -  none
+ *
+ * @Note              -  only called from ISR context, any priority
+
+ *********************************************************************/
+__RAMFUNC void Power_NotifyWake(Power_Handle_t *pPowerHandle, uint8_t WakeSource)
+{
+	// wake ISRs nest (EXTI, USART, I2C at different priorities), a plain |= could lose a bit
+	__atomic_fetch_or(&pPowerHandle->PendingWake, (uint8_t)(1 << WakeSource), __ATOMIC_RELAXED);
+}
+
+/*********************************************************************
+ * @fn      		  - Power_GetResidencyMs
+ *
+ * @brief             - Returns the time spent in a mode
+ *
+ * @param[in]         - power handle
+ * @param[in]         - mode (@POWER_MODE)
+ *
+ * @return            -  time in milliseconds
+ *
+ * @Note              -  only complete SQW seconds are accounted
+
+ *********************************************************************/
+uint32_t Power_GetResidencyMs(Power_Handle_t *pPowerHandle, uint8_t Mode)
+{
+	return (uint32_t)(pPowerHandle->Cycles[Mode] / (pPowerHandle->Power_Config.CoreClockHz / 1000));
+}
@@ -0,0 +1,333 @@
+/*
+ * regmap.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "regmap.h"
+#include <string.h>
+
+static uint8_t RegMap_TestBit(const uint32_t *pMap, uint8_t Reg);
+static uint8_t RegMap_IsCacheable(RegMap_Handle_t *pRegMapHandle, uint8_t Reg);
+static uint8_t RegMap_IsCached(RegMap_Handle_t *pRegMapHandle, uint8_t Reg);
+static uint8_t RegMap_CacheWrite(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t Value);
+static void RegMap_Forget(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t Len);
+static uint8_t RegMap_BusRead(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+static uint8_t RegMap_BusWrite(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len);
+
+/*
+ * Helper functions
+ */
+static uint8_t RegMap_TestBit(const uint32_t *pMap, uint8_t Reg)
+{
+	return (pMap[Reg / 32] >> (Reg % 32)) & 1;
+}
+
+static uint8_t RegMap_IsCacheable(RegMap_Handle_t *pRegMapHandle, uint8_t Reg)
+{
+	if(Reg >= pRegMapHandle->RegMap_Config.NumRegs)
+		return 0;
+
+	return !RegMap_TestBit(pRegMapHandle->RegMap_Config.Volatile, Reg);
+}
+
+static uint8_t RegMap_IsCached(RegMap_Handle_t *pRegMapHandle, uint8_t Reg)
+{
+	return RegMap_IsCacheable(pRegMapHandle, Reg) && RegMap_TestBit(pRegMapHandle->Valid, Reg);
+}
+
+/*
+ * Updates the cache for one written register. Returns 1 if the register has to go to the bus now
+ */
+static uint8_t RegMap_CacheWrite(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t Value)
+{
+	uint8_t changed;
+
+	if(!RegMap_IsCacheable(pRegMapHandle, Reg))
+		return 1;
+
+	changed = !RegMap_TestBit(pRegMapHandle->Valid, Reg) || (pRegMapHandle->Cache[Reg] != Value);
+
+	pRegMapHandle->Cache[Reg] = Value;
+	pRegMapHandle->Valid[Reg / 32] |= (1UL << (Reg % 32));
+
+	if(pRegMapHandle->RegMap_Config.CacheMode == REGMAP_CACHE_WRITEBACK)
+	{
+		if(changed)
+			pRegMapHandle->Dirty[Reg / 32] |= (1UL << (Reg % 32));
+		return 0;
+	}
+
+	return changed;
+}
+
+/*
+ * The device value of these registers is not known any more (failed write)
+ */
+static void RegMap_Forget(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t Len)
+{
+	for(uint8_t i = 0; i < Len; i++)
+	{
+		uint8_t r = Reg + i;
+		pRegMapHandle->Valid[r / 32] &= ~(1UL << (r % 32));
+	}
+}
+
+static uint8_t RegMap_BusRead(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	uint8_t chunk;
+
+	while(Len)
+	{
+		chunk = (Len > pRegMapHandle->RegMap_Config.MaxBurst) ? pRegMapHandle->RegMap_Config.MaxBurst : Len;
+
+#if REGMAP_STATS
+		pRegMapHandle->BusReads++;
+#endif
+		if(pRegMapHandle->RegMap_Config.pfnRead(pRegMapHandle->RegMap_Config.pCtx, Reg, pBuf, chunk) != 0)
+			return REGMAP_ERR_BUS;
+
+		Reg += chunk;
+		pBuf += chunk;
+		Len -= chunk;
+	}
+
+	return REGMAP_OK;
+}
+
+static uint8_t RegMap_BusWrite(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	uint8_t chunk;
+
+	while(Len)
+	{
+		chunk = (Len > pRegMapHandle->RegMap_Config.MaxBurst) ? pRegMapHandle->RegMap_Config.MaxBurst : Len;
+
+#if REGMAP_STATS
+		pRegMapHandle->BusWrites++;
+#endif
+		if(pRegMapHandle->RegMap_Config.pfnWrite(pRegMapHandle->RegMap_Config.pCtx, Reg, pBuf, chunk) != 0)
+			return REGMAP_ERR_BUS;
+
+		Reg += chunk;
+		pBuf += chunk;
+		Len -= chunk;
+	}
+
+	return REGMAP_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RegMap_Init
+ *
+ * @brief             - Initializes a register map with an empty cache
+ *
+ * @param[in]         - register map handle with RegMap_Config filled in
+ *
+ * @return            -  none
+ *
+ * @Note              -  NumRegs is limited to REGMAP_MAX_REGS, MaxBurst = 0 means no limit
+
+ *********************************************************************/
+void RegMap_Init(RegMap_Handle_t *pRegMapHandle)
+{
+	if(pRegMapHandle->RegMap_Config.NumRegs > REGMAP_MAX_REGS)
+		pRegMapHandle->RegMap_Config.NumRegs = REGMAP_MAX_REGS;
+	if(pRegMapHandle->RegMap_Config.MaxBurst == 0)
+		pRegMapHandle->RegMap_Config.MaxBurst = 0xFF;
+
+	memset(pRegMapHandle->Cache, 0, sizeof(pRegMapHandle->Cache));
+	memset(pRegMapHandle->Valid, 0, sizeof(pRegMapHandle->Valid));
+	memset(pRegMapHandle->Dirty, 0, sizeof(pRegMapHandle->Dirty));
+
+	pRegMapHandle->Hits = 0;
+	pRegMapHandle->BusReads = 0;
+	pRegMapHandle->BusWrites = 0;
+}
+
+/*********************************************************************
+ * @fn      		  - RegMap_Read
+ *
+ * @brief             - Reads consecutive registers, cached ones from the cache
+ *
+ * @param[in]         - register map handle
+ * @param[in]         - first register
+ * @param[out]        - buffer
+ * @param[in]         - number of registers
+ *
+ * @return            -  REGMAP_OK, REGMAP_ERR_BUS (the buffer is incomplete then)
+ *
+ * @Note              -  every run of registers which are not cached is one bus burst. Only what
+ * 						 was read without error goes into the cache
+
+ *********************************************************************/
+uint8_t RegMap_Read(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	uint8_t i = 0, start;
+
+	while(i < Len)
+	{
+		if(RegMap_IsCached(pRegMapHandle, Reg + i))
+		{
+			pBuf[i] = pRegMapHandle->Cache[(uint8_t)(Reg + i)];
+#if REGMAP_STATS
+			pRegMapHandle->Hits++;
+#endif
+			i++;
+			continue;
+		}
+
+		start = i;
+		while((i < Len) && !RegMap_IsCached(pRegMapHandle, Reg + i))
+			i++;
+
+		if(RegMap_BusRead(pRegMapHandle, Reg + start, &pBuf[start], i - start) != REGMAP_OK)
+			return REGMAP_ERR_BUS;
+
+		// fill the cache with what was read
+		for(uint8_t k = start; k < i; k++)
+		{
+			uint8_t r = Reg + k;
+			if(RegMap_IsCacheable(pRegMapHandle, r))
+			{
+				pRegMapHandle->Cache[r] = pBuf[k];
+				pRegMapHandle->Valid[r / 32] |= (1UL << (r % 32));
+			}
+		}
+	}
+
+	return REGMAP_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RegMap_Write
+ *
+ * @brief             - Writes consecutive registers
+ *
+ * @param[in]         - register map handle
+ * @param[in]         - first register
+ * @param[in]         - data
+ * @param[in]         - number of registers
+ *
+ * @return            -  REGMAP_OK, REGMAP_ERR_BUS
+ *
+ * @Note              -  only registers which have to reach the bus now are written, every
+ * 						 contiguous run of them as one burst. A failed run is dropped from the cache,
+ * 						 the runs after it are not written
+
+ *********************************************************************/
+uint8_t RegMap_Write(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t *pBuf, uint8_t Len)
+{
+	uint8_t i, start = Len;
+
+	for(i = 0; i <= Len; i++)
+	{
+		if((i < Len) && RegMap_CacheWrite(pRegMapHandle, Reg + i, pBuf[i]))
+		{
+			if(start == Len)
+				start = i;
+		}
+		else if(start != Len)
+		{
+			if(RegMap_BusWrite(pRegMapHandle, Reg + start, &pBuf[start], i - start) != REGMAP_OK)
+			{
+				RegMap_Forget(pRegMapHandle, Reg + start, i - start);
+				return REGMAP_ERR_BUS;
+			}
+			start = Len;
+		}
+	}
+
+	return REGMAP_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RegMap_UpdateBits
+ *
+ * @brief             - Read-modify-write of the bits in Mask of one register
+ *
+ * @param[in]         - register map handle
+ * @param[in]         - register
+ * @param[in]         - bits to change
+ * @param[in]         - new value of those bits
+ *
+ * @return            -  REGMAP_OK, REGMAP_ERR_BUS (nothing is written when the read fails)
+ *
+ * @Note              -  a cached register costs no bus read. Nothing is written if the value does not change
+
+ *********************************************************************/
+uint8_t RegMap_UpdateBits(RegMap_Handle_t *pRegMapHandle, uint8_t Reg, uint8_t Mask, uint8_t Value)
+{
+	uint8_t old, new;
+
+	if(RegMap_Read(pRegMapHandle, Reg, &old, 1) != REGMAP_OK)
+		return REGMAP_ERR_BUS;
+
+	new = (old & ~Mask) | (Value & Mask);
+	if(new == old)
+		return REGMAP_OK;
+
+	return RegMap_Write(pRegMapHandle, Reg, &new, 1);
+}
+
+/*********************************************************************
+ * @fn      		  - RegMap_Sync
+ *
+ * @brief             - Writes all dirty registers to the device
+ *
+ * @param[in]         - register map handle
+ *
+ * @return            -  REGMAP_OK, REGMAP_ERR_BUS (the failed run stays dirty)
+ *
+ * @Note              -  contiguous dirty registers go out as one burst. Nothing to do in write through mode
+
+ *********************************************************************/
+uint8_t RegMap_Sync(RegMap_Handle_t *pRegMapHandle)
+{
+	uint8_t numRegs = pRegMapHandle->RegMap_Config.NumRegs;
+	uint8_t r = 0, start;
+
+	while(r < numRegs)
+	{
+		if(!RegMap_TestBit(pRegMapHandle->Dirty, r))
+		{
+			r++;
+			continue;
+		}
+
+		start = r;
+		while((r < numRegs) && RegMap_TestBit(pRegMapHandle->Dirty, r))
+		{
+			pRegMapHandle->Dirty[r / 32] &= ~(1UL << (r % 32));
+			r++;
+		}
+
+		if(RegMap_BusWrite(pRegMapHandle, start, &pRegMapHandle->Cache[start], r - start) != REGMAP_OK)
+		{
+			for(uint8_t k = start; k < r; k++)
+				pRegMapHandle->Dirty[k / 32] |= (1UL << (k % 32));
+			return REGMAP_ERR_BUS;
+		}
+	}
+
+	return REGMAP_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RegMap_Invalidate
+ *
+ * @brief             - Forgets the cached values
+ *
+ * @param[in]         - register map handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  dirty registers are dropped, call RegMap_Sync() first to keep them
+
+ *********************************************************************/
+void RegMap_Invalidate(RegMap_Handle_t *pRegMapHandle)
+{
+	memset(pRegMapHandle->Valid, 0, sizeof(pRegMapHandle->Valid));
+	memset(pRegMapHandle->Dirty, 0, sizeof(pRegMapHandle->Dirty));
+}
@@ -0,0 +1,462 @@
+/*
+ * ringbuf.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "ringbuf.h"
+#include <string.h>
+
+static uint8_t RingBuf_IsPowerOfTwo(uint32_t value);
+__RAMFUNC static void RingBuf_UpdateHighWater(__vo uint32_t *pHighWater, uint32_t used);
+
+/*
+ * Helper functions
+ */
+static uint8_t RingBuf_IsPowerOfTwo(uint32_t value)
+{
+	return (value != 0) && ((value & (value - 1)) == 0);
+}
+
+__RAMFUNC static void RingBuf_UpdateHighWater(__vo uint32_t *pHighWater, uint32_t used)
+{
+#if RINGBUF_STATS
+	if(used > *pHighWater)
+		*pHighWater = used;
+#else
+	(void)pHighWater;
+	(void)used;
+#endif
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Init
+ *
+ * @brief             - Initializes an SPSC ring buffer on caller provided storage
+ *
+ * @param[in]         - ring buffer
+ * @param[in]         - storage, Size * ElemSize bytes
+ * @param[in]         - number of elements, power of two
+ * @param[in]         - element size in bytes
+ *
+ * @return            -  RINGBUF_OK or RINGBUF_ERR_SIZE
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RingBuf_Init(RingBuf_t *pRing, void *pStorage, uint32_t Size, uint32_t ElemSize)
+{
+	if(!RingBuf_IsPowerOfTwo(Size) || ElemSize == 0)
+		return RINGBUF_ERR_SIZE;
+
+	memset(pRing, 0, sizeof(*pRing));
+	pRing->pBuf = (uint8_t*)pStorage;
+	pRing->Size = Size;
+	pRing->ElemSize = ElemSize;
+
+	return RINGBUF_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Used
+ *
+ * @brief             - Number of elements waiting to be read
+ *
+ * @param[in]         - ring buffer
+ *
+ * @return            -  elements
+ *
+ * @Note              -  safe from both sides
+
+ *********************************************************************/
+uint32_t RingBuf_Used(RingBuf_t *pRing)
+{
+	return __atomic_load_n(&pRing->Head, __ATOMIC_ACQUIRE) - __atomic_load_n(&pRing->Tail, __ATOMIC_ACQUIRE);
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Free
+ *
+ * @brief             - Number of elements which can be written
+ *
+ * @param[in]         - ring buffer
+ *
+ * @return            -  elements
+ *
+ * @Note              -  safe from both sides
+
+ *********************************************************************/
+uint32_t RingBuf_Free(RingBuf_t *pRing)
+{
+	return pRing->Size - RingBuf_Used(pRing);
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Flush
+ *
+ * @brief             - Drops every element waiting to be read
+ *
+ * @param[in]         - ring buffer
+ *
+ * @return            -  none
+ *
+ * @Note              -  consumer side only
+
+ *********************************************************************/
+void RingBuf_Flush(RingBuf_t *pRing)
+{
+	__atomic_store_n(&pRing->Tail, __atomic_load_n(&pRing->Head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Reserve
+ *
+ * @brief             - Returns the contiguous free span at the write position
+ *
+ * @param[in]         - ring buffer
+ * @param[out]        - number of elements available in the span
+ *
+ * @return            -  pointer to the span (valid even when *pCount is 0)
+ *
+ * @Note              -  producer side only. Fill the span and call RingBuf_Commit
+
+ *********************************************************************/
+void* RingBuf_Reserve(RingBuf_t *pRing, uint32_t *pCount)
+{
+	uint32_t head = pRing->Head;
+	uint32_t tail = __atomic_load_n(&pRing->Tail, __ATOMIC_ACQUIRE);
+	uint32_t idx = head & (pRing->Size - 1);
+	uint32_t free = pRing->Size - (head - tail);
+	uint32_t toEnd = pRing->Size - idx;
+
+	*pCount = (free < toEnd) ? free : toEnd;
+
+	return &pRing->pBuf[idx * pRing->ElemSize];
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Commit
+ *
+ * @brief             - Publishes elements written into a reserved span
+ *
+ * @param[in]         - ring buffer
+ * @param[in]         - number of elements written, at most the reserved count
+ *
+ * @return            -  none
+ *
+ * @Note              -  producer side only
+
+ *********************************************************************/
+void RingBuf_Commit(RingBuf_t *pRing, uint32_t Count)
+{
+	uint32_t head = pRing->Head + Count;
+
+	// release: the element data must be visible before the new head
+	__atomic_store_n(&pRing->Head, head, __ATOMIC_RELEASE);
+
+	RingBuf_UpdateHighWater(&pRing->HighWater, head - __atomic_load_n(&pRing->Tail, __ATOMIC_RELAXED));
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Span
+ *
+ * @brief             - Returns the contiguous filled span at the read position
+ *
+ * @param[in]         - ring buffer
+ * @param[out]        - number of elements in the span
+ *
+ * @return            -  pointer to the span
+ *
+ * @Note              -  consumer side only. Call RingBuf_Release when done with it
+
+ *********************************************************************/
+void* RingBuf_Span(RingBuf_t *pRing, uint32_t *pCount)
+{
+	uint32_t tail = pRing->Tail;
+	uint32_t head = __atomic_load_n(&pRing->Head, __ATOMIC_ACQUIRE);
+	uint32_t idx = tail & (pRing->Size - 1);
+	uint32_t used = head - tail;
+	uint32_t toEnd = pRing->Size - idx;
+
+	*pCount = (used < toEnd) ? used : toEnd;
+
+	return &pRing->pBuf[idx * pRing->ElemSize];
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Release
+ *
+ * @brief             - Frees elements read from a span
+ *
+ * @param[in]         - ring buffer
+ * @param[in]         - number of elements consumed
+ *
+ * @return            -  none
+ *
+ * @Note              -  consumer side only
+
+ *********************************************************************/
+void RingBuf_Release(RingBuf_t *pRing, uint32_t Count)
+{
+	__atomic_store_n(&pRing->Tail, pRing->Tail + Count, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Put
+ *
+ * @brief             - Copies elements into the ring buffer
+ *
+ * @param[in]         - ring buffer
+ * @param[in]         - elements
+ * @param[in]         - number of elements
+ *
+ * @return            -  number of elements written. Less than Count if the buffer is full
+ *
+ * @Note              -  producer side only
+
+ *********************************************************************/
+uint32_t RingBuf_Put(RingBuf_t *pRing, const void *pData, uint32_t Count)
+{
+	const uint8_t *pSrc = (const uint8_t*)pData;
+	uint32_t written = 0;
+	uint32_t span;
+	uint8_t *pDst;
+
+	// at most two spans (before and after the wrap)
+	while(written < Count)
+	{
+		pDst = RingBuf_Reserve(pRing, &span);
+		if(span == 0)
+			break;
+		if(span > Count - written)
+			span = Count - written;
+
+		memcpy(pDst, pSrc, span * pRing->ElemSize);
+		RingBuf_Commit(pRing, span);
+
+		pSrc += span * pRing->ElemSize;
+		written += span;
+	}
+
+#if RINGBUF_STATS
+	if(written < Count)
+		pRing->Overflows += Count - written;
+#endif
+
+	return written;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_Get
+ *
+ * @brief             - Copies elements out of the ring buffer
+ *
+ * @param[in]         - ring buffer
+ * @param[out]        - destination
+ * @param[in]         - maximum number of elements
+ *
+ * @return            -  number of elements read
+ *
+ * @Note              -  consumer side only
+
+ *********************************************************************/
+uint32_t RingBuf_Get(RingBuf_t *pRing, void *pData, uint32_t Count)
+{
+	uint8_t *pDst = (uint8_t*)pData;
+	uint32_t read = 0;
+	uint32_t span;
+	uint8_t *pSrc;
+
+	while(read < Count)
+	{
+		pSrc = RingBuf_Span(pRing, &span);
+		if(span == 0)
+			break;
+		if(span > Count - read)
+			span = Count - read;
+
+		memcpy(pDst, pSrc, span * pRing->ElemSize);
+		RingBuf_Release(pRing, span);
+
+		pDst += span * pRing->ElemSize;
+		read += span;
+	}
+
+	return read;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBuf_PutWords
+ *
+ * @brief             - Puts one 8 byte element, given as its two words
+ *
+ * @param[in]         - ring buffer with ElemSize 8 on word aligned storage
+ * @param[in]         - first word of the element
+ * @param[in]         - second word of the element
+ *
+ * @return            -  RINGBUF_OK or RINGBUF_ERR_FULL
+ *
+ * @Note              -  producer side only. Two word stores and no copy loop, for ISRs which
+ * 						 record fixed size events
+
+ *********************************************************************/
+__RAMFUNC uint8_t RingBuf_PutWords(RingBuf_t *pRing, uint32_t Word0, uint32_t Word1)
+{
+	uint32_t head = pRing->Head;
+	uint32_t used = head - __atomic_load_n(&pRing->Tail, __ATOMIC_ACQUIRE);
+	uint32_t *pElem;
+
+	if(used >= pRing->Size)
+	{
+#if RINGBUF_STATS
+		pRing->Overflows++;
+#endif
+		return RINGBUF_ERR_FULL;
+	}
+
+	pElem = (uint32_t*)&pRing->pBuf[(head & (pRing->Size - 1)) * 8];
+	pElem[0] = Word0;
+	pElem[1] = Word1;
+
+	// release: the element must be visible before the new head
+	__atomic_store_n(&pRing->Head, head + 1, __ATOMIC_RELEASE);
+	RingBuf_UpdateHighWater(&pRing->HighWater, used + 1);
+
+	return RINGBUF_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBufMPSC_Init
+ *
+ * @brief             - Initializes an MPSC ring buffer on caller provided storage
+ *
+ * @param[in]         - ring buffer
+ * @param[in]         - element storage, Size * ElemSize bytes
+ * @param[in]         - sequence storage, Size words
+ * @param[in]         - number of elements, power of two
+ * @param[in]         - element size in bytes
+ *
+ * @return            -  RINGBUF_OK or RINGBUF_ERR_SIZE
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t RingBufMPSC_Init(RingBufMPSC_t *pRing, void *pStorage, __vo uint32_t *pSeqStorage, uint32_t Size, uint32_t ElemSize)
+{
+	if(!RingBuf_IsPowerOfTwo(Size) || ElemSize == 0)
+		return RINGBUF_ERR_SIZE;
+
+	memset(pRing, 0, sizeof(*pRing));
+	pRing->pBuf = (uint8_t*)pStorage;
+	pRing->pSeq = pSeqStorage;
+	pRing->Size = Size;
+	pRing->ElemSize = ElemSize;
+
+	// slot i is free for the producer which claims position i
+	for(uint32_t i = 0; i < Size; i++)
+		pSeqStorage[i] = i;
+
+	return RINGBUF_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBufMPSC_Put
+ *
+ * @brief             - Copies one element into the ring buffer
+ *
+ * @param[in]         - ring buffer
+ * @param[in]         - element
+ *
+ * @return            -  RINGBUF_OK or RINGBUF_ERR_FULL
+ *
+ * @Note              -  lock-free, callable from any ISR priority and from threads
+
+ *********************************************************************/
+uint8_t RingBufMPSC_Put(RingBufMPSC_t *pRing, const void *pElem)
+{
+	uint32_t pos = __atomic_load_n(&pRing->EnqPos, __ATOMIC_RELAXED);
+	uint32_t idx;
+
+	while(1)
+	{
+		idx = pos & (pRing->Size - 1);
+		int32_t diff = (int32_t)(__atomic_load_n(&pRing->pSeq[idx], __ATOMIC_ACQUIRE) - pos);
+
+		if(diff == 0)
+		{
+			// slot is free for this lap. Claim it
+			if(__atomic_compare_exchange_n(&pRing->EnqPos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		}
+		else if(diff < 0)
+		{
+#if RINGBUF_STATS
+			__atomic_fetch_add(&pRing->Overflows, 1, __ATOMIC_RELAXED);
+#endif
+			return RINGBUF_ERR_FULL;
+		}
+		else
+		{
+			// another producer claimed it first
+			pos = __atomic_load_n(&pRing->EnqPos, __ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(&pRing->pBuf[idx * pRing->ElemSize], pElem, pRing->ElemSize);
+	__atomic_store_n(&pRing->pSeq[idx], pos + 1, __ATOMIC_RELEASE);
+
+	RingBuf_UpdateHighWater(&pRing->HighWater, pos + 1 - pRing->DeqPos);
+
+	return RINGBUF_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBufMPSC_Get
+ *
+ * @brief             - Copies one element out of the ring buffer
+ *
+ * @param[in]         - ring buffer
+ * @param[out]        - element
+ *
+ * @return            -  1 if an element was read, 0 if the buffer is empty
+ *
+ * @Note              -  consumer side only
+
+ *********************************************************************/
+uint8_t RingBufMPSC_Get(RingBufMPSC_t *pRing, void *pElem)
+{
+	uint32_t pos = pRing->DeqPos;
+	uint32_t idx = pos & (pRing->Size - 1);
+
+	// slot not published yet -> empty (or a preempted producer is still writing it)
+	if((int32_t)(__atomic_load_n(&pRing->pSeq[idx], __ATOMIC_ACQUIRE) - (pos + 1)) < 0)
+		return 0;
+
+	memcpy(pElem, &pRing->pBuf[idx * pRing->ElemSize], pRing->ElemSize);
+	pRing->DeqPos = pos + 1;
+
+	// hand the slot back to the producers for the next lap
+	__atomic_store_n(&pRing->pSeq[idx], pos + pRing->Size, __ATOMIC_RELEASE);
+
+	return 1;
+}
+
+/*********************************************************************
+ * @fn      		  - RingBufMPSC_IsEmpty
+ *
+ * @brief             - Returns 1 if there is no published element to read
+ *
+ * @param[in]         - ring buffer
+ *
+ * @return            -  1 or 0
+ *
+ * @Note              -  consumer side only
+
+ *********************************************************************/
+uint8_t RingBufMPSC_IsEmpty(RingBufMPSC_t *pRing)
+{
+	uint32_t pos = pRing->DeqPos;
+
+	return ((int32_t)(__atomic_load_n(&pRing->pSeq[pos & (pRing->Size - 1)], __ATOMIC_ACQUIRE) - (pos + 1)) < 0);
+}
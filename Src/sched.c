@@ -0,0 +1,319 @@
+/*
+ * sched.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "sched.h"
+#include <string.h>
+
+#define SCHED_WHEEL_MASK				(SCHED_WHEEL_SLOTS - 1)
+
+static void Sched_TimerInsert(Sched_Handle_t *pSchedHandle, Sched_Timer_t *pTimer);
+static void Sched_TimerUnlink(Sched_Timer_t *pTimer);
+static void Sched_Cascade(Sched_Handle_t *pSchedHandle, uint8_t level, uint32_t idx);
+static void Sched_ProcessTick(Sched_Handle_t *pSchedHandle);
+static uint8_t Sched_HasWork(Sched_Handle_t *pSchedHandle);
+
+/*
+ * Helper functions
+ */
+static void Sched_TimerInsert(Sched_Handle_t *pSchedHandle, Sched_Timer_t *pTimer)
+{
+	uint32_t expires = pTimer->Expires;
+	int32_t delta = (int32_t)(expires - pSchedHandle->Now);
+	Sched_Timer_t **ppSlot;
+	uint8_t level = 0;
+
+	if(delta < 0)
+	{
+		// already due, fire on the next tick
+		ppSlot = &pSchedHandle->Wheel[0][pSchedHandle->Now & SCHED_WHEEL_MASK];
+	}
+	else
+	{
+		if((uint32_t)delta > SCHED_MAX_DELAY)
+		{
+			// park it in the last level, it is re-cascaded until it is in range
+			expires = pSchedHandle->Now + SCHED_MAX_DELAY;
+			delta = SCHED_MAX_DELAY;
+		}
+
+		while((level < (SCHED_WHEEL_LEVELS - 1)) && ((uint32_t)delta >= (1UL << (SCHED_WHEEL_BITS * (level + 1)))))
+			level++;
+
+		ppSlot = &pSchedHandle->Wheel[level][(expires >> (SCHED_WHEEL_BITS * level)) & SCHED_WHEEL_MASK];
+	}
+
+	pTimer->pNext = *ppSlot;
+	if(*ppSlot)
+		(*ppSlot)->ppPrev = &pTimer->pNext;
+	*ppSlot = pTimer;
+	pTimer->ppPrev = ppSlot;
+}
+
+static void Sched_TimerUnlink(Sched_Timer_t *pTimer)
+{
+	*pTimer->ppPrev = pTimer->pNext;
+	if(pTimer->pNext)
+		pTimer->pNext->ppPrev = pTimer->ppPrev;
+	pTimer->pNext = NULL;
+	pTimer->ppPrev = NULL;
+}
+
+static void Sched_Cascade(Sched_Handle_t *pSchedHandle, uint8_t level, uint32_t idx)
+{
+	Sched_Timer_t *pTimer = pSchedHandle->Wheel[level][idx];
+	Sched_Timer_t *pNext;
+
+	pSchedHandle->Wheel[level][idx] = NULL;
+
+	// every timer of this slot is due within the span of the level below
+	while(pTimer)
+	{
+		pNext = pTimer->pNext;
+		Sched_TimerInsert(pSchedHandle, pTimer);
+		pTimer = pNext;
+	}
+}
+
+static void Sched_ProcessTick(Sched_Handle_t *pSchedHandle)
+{
+	uint32_t idx = pSchedHandle->Now & SCHED_WHEEL_MASK;
+	Sched_Timer_t *pPending;
+	Sched_Timer_t *pTimer;
+
+	// 1. level 0 wrapped around. Pull the next slot of the upper levels down
+	if(idx == 0)
+	{
+		for(uint8_t level = 1; level < SCHED_WHEEL_LEVELS; level++)
+		{
+			uint32_t levelIdx = (pSchedHandle->Now >> (SCHED_WHEEL_BITS * level)) & SCHED_WHEEL_MASK;
+
+			Sched_Cascade(pSchedHandle, level, levelIdx);
+			if(levelIdx != 0)
+				break;
+		}
+	}
+
+	pSchedHandle->Now++;
+
+	// 2. move the expired slot to a local list so callbacks may start/cancel any timer
+	pPending = pSchedHandle->Wheel[0][idx];
+	pSchedHandle->Wheel[0][idx] = NULL;
+	if(pPending)
+		pPending->ppPrev = &pPending;
+
+	// 3. fire
+	while((pTimer = pPending) != NULL)
+	{
+		Sched_TimerUnlink(pTimer);
+		if(pTimer->Period)
+		{
+			pTimer->Expires += pTimer->Period;
+			Sched_TimerInsert(pSchedHandle, pTimer);
+		}
+		pTimer->pfnTask(pTimer->pArg);
+	}
+}
+
+static uint8_t Sched_HasWork(Sched_Handle_t *pSchedHandle)
+{
+	if(pSchedHandle->PendingTicks)
+		return 1;
+
+	return !RingBufMPSC_IsEmpty(&pSchedHandle->Queue);
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_Init
+ *
+ * @brief             - Initializes the scheduler
+ *
+ * @param[in]         - scheduler handle. pfnIdle may be set after this call
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Sched_Init(Sched_Handle_t *pSchedHandle)
+{
+	memset(pSchedHandle, 0, sizeof(*pSchedHandle));
+
+	RingBufMPSC_Init(&pSchedHandle->Queue, pSchedHandle->QueueBuf, pSchedHandle->QueueSeq, SCHED_QUEUE_SIZE, sizeof(Sched_Event_t));
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_Post
+ *
+ * @brief             - Queues a task to run in thread context
+ *
+ * @param[in]         - scheduler handle
+ * @param[in]         - task
+ * @param[in]         - task argument
+ *
+ * @return            -  SCHED_OK or SCHED_ERR_FULL
+ *
+ * @Note              -  ISR safe, lock-free, callable from any priority
+
+ *********************************************************************/
+uint8_t Sched_Post(Sched_Handle_t *pSchedHandle, Sched_Task_t pfnTask, void *pArg)
+{
+	Sched_Event_t event = { pfnTask, pArg };
+
+	if(RingBufMPSC_Put(&pSchedHandle->Queue, &event) != RINGBUF_OK)
+		return SCHED_ERR_FULL;
+
+	return SCHED_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_Tick
+ *
+ * @brief             - Advances the timer wheel time base by one tick
+ *
+ * @param[in]         - scheduler handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  ISR safe. The wheel itself is advanced in Sched_RunOnce
+
+ *********************************************************************/
+__RAMFUNC void Sched_Tick(Sched_Handle_t *pSchedHandle)
+{
+	__atomic_fetch_add(&pSchedHandle->PendingTicks, 1, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_RunOnce
+ *
+ * @brief             - Processes the pending ticks and runs every queued task
+ *
+ * @param[in]         - scheduler handle
+ *
+ * @return            -  1 if any work was done, 0 otherwise
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Sched_RunOnce(Sched_Handle_t *pSchedHandle)
+{
+	uint32_t ticks = __atomic_exchange_n(&pSchedHandle->PendingTicks, 0, __ATOMIC_ACQ_REL);
+	uint8_t worked = 0;
+	Sched_Event_t event;
+
+	while(ticks--)
+	{
+		Sched_ProcessTick(pSchedHandle);
+		worked = 1;
+	}
+
+	while(RingBufMPSC_Get(&pSchedHandle->Queue, &event))
+	{
+		event.pfnTask(event.pArg);
+		worked = 1;
+	}
+
+	return worked;
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_Run
+ *
+ * @brief             - Scheduler main loop. Never returns
+ *
+ * @param[in]         - scheduler handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  the idle hook is called with interrupts masked
+
+ *********************************************************************/
+void Sched_Run(Sched_Handle_t *pSchedHandle)
+{
+	while(1)
+	{
+		if(Sched_RunOnce(pSchedHandle))
+			continue;
+
+		__DISABLE_IRQ();
+		if(!Sched_HasWork(pSchedHandle))
+		{
+			if(pSchedHandle->pfnIdle)
+				pSchedHandle->pfnIdle();
+			else
+				__WFI();
+		}
+		__ENABLE_IRQ();
+	}
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_TimerStart
+ *
+ * @brief             - Starts (or restarts) a timer
+ *
+ * @param[in]         - scheduler handle
+ * @param[in]         - timer
+ * @param[in]         - ticks till the first expiry. 0 is treated as 1
+ * @param[in]         - ticks between expiries, 0 for a one shot timer
+ * @param[in]         - task called on expiry (thread context)
+ * @param[in]         - task argument
+ *
+ * @return            -  none
+ *
+ * @Note              -  O(1)
+
+ *********************************************************************/
+void Sched_TimerStart(Sched_Handle_t *pSchedHandle, Sched_Timer_t *pTimer, uint32_t Delay, uint32_t Period, Sched_Task_t pfnTask, void *pArg)
+{
+	if(pTimer->ppPrev)
+		Sched_TimerUnlink(pTimer);
+
+	if(Delay == 0)
+		Delay = 1;
+
+	pTimer->Expires = pSchedHandle->Now + Delay - 1;
+	pTimer->Period = Period;
+	pTimer->pfnTask = pfnTask;
+	pTimer->pArg = pArg;
+
+	Sched_TimerInsert(pSchedHandle, pTimer);
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_TimerCancel
+ *
+ * @brief             - Stops a timer. Does nothing if it is not active
+ *
+ * @param[in]         - timer
+ *
+ * @return            -  none
+ *
+ * @Note              -  O(1)
+
+ *********************************************************************/
+void Sched_TimerCancel(Sched_Timer_t *pTimer)
+{
+	if(pTimer->ppPrev)
+		Sched_TimerUnlink(pTimer);
+}
+
+/*********************************************************************
+ * @fn      		  - Sched_TimerIsActive
+ *
+ * @brief             - Returns 1 if the timer is waiting to expire
+ *
+ * @param[in]         - timer
+ *
+ * @return            -  1 or 0
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Sched_TimerIsActive(Sched_Timer_t *pTimer)
+{
+	return (pTimer->ppPrev != NULL);
+}
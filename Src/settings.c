@@ -0,0 +1,148 @@
+/*
+ * settings.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "settings.h"
+#include "crc.h"
+
+static void Settings_Encode(const Settings_t *pSettings, uint8_t *pPayload);
+static void Settings_Decode(const uint8_t *pPayload, Settings_t *pSettings);
+
+/*
+ * Helper functions
+ */
+static void Settings_Encode(const Settings_t *pSettings, uint8_t *pPayload)
+{
+	uint32_t drift = (uint32_t)pSettings->DriftPPB;
+
+	pPayload[0] = (uint8_t)pSettings->TimezoneMin;
+	pPayload[1] = (uint8_t)((uint16_t)pSettings->TimezoneMin >> 8);
+	pPayload[2] = pSettings->TimeFormat;
+	pPayload[3] = (uint8_t)drift;
+	pPayload[4] = (uint8_t)(drift >> 8);
+	pPayload[5] = (uint8_t)(drift >> 16);
+	pPayload[6] = (uint8_t)(drift >> 24);
+	pPayload[7] = pSettings->DisplayFlags;
+	pPayload[8] = pSettings->RefreshSeconds;
+}
+
+static void Settings_Decode(const uint8_t *pPayload, Settings_t *pSettings)
+{
+	pSettings->TimezoneMin = (int16_t)(pPayload[0] | (pPayload[1] << 8));
+	pSettings->TimeFormat = pPayload[2];
+	pSettings->DriftPPB = (int32_t)((uint32_t)pPayload[3] | ((uint32_t)pPayload[4] << 8) |
+									((uint32_t)pPayload[5] << 16) | ((uint32_t)pPayload[6] << 24));
+	pSettings->DisplayFlags = pPayload[7];
+	pSettings->RefreshSeconds = pPayload[8];
+
+	// a 0 period would stop the display timer
+	if(pSettings->RefreshSeconds == 0)
+		pSettings->RefreshSeconds = SETTINGS_DEFAULT_REFRESH;
+}
+
+/*********************************************************************
+ * @fn      		  - Settings_Default
+ *
+ * @brief             - Fills in the default settings
+ *
+ * @param[out]        - settings
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Settings_Default(Settings_t *pSettings)
+{
+	pSettings->TimezoneMin = SETTINGS_DEFAULT_TIMEZONE;
+	pSettings->TimeFormat = SETTINGS_DEFAULT_TIME_FORMAT;
+	pSettings->DriftPPB = 0;
+	pSettings->DisplayFlags = SETTINGS_DEFAULT_DISPLAY;
+	pSettings->RefreshSeconds = SETTINGS_DEFAULT_REFRESH;
+}
+
+/*********************************************************************
+ * @fn      		  - Settings_Load
+ *
+ * @brief             - Reads the settings block from the RTC NVRAM
+ *
+ * @param[in]         - settings handle with Settings_Config filled in
+ *
+ * @return            -  SETTINGS_OK or SETTINGS_ERR_xxx. The defaults are loaded on errors
+ *
+ * @Note              -  one burst read of SETTINGS_BLOCK_LEN bytes
+
+ *********************************************************************/
+uint8_t Settings_Load(Settings_Handle_t *pSetHandle)
+{
+	Settings_Config_t *pConfig = &pSetHandle->Settings_Config;
+	uint8_t block[SETTINGS_BLOCK_LEN];
+	uint8_t payload[SETTINGS_PAYLOAD_LEN];
+	uint8_t *pCrc;
+	uint8_t len;
+	uint32_t crc;
+
+	// 1. Defaults, also the values of fields the stored block does not have
+	Settings_Default(&pSetHandle->Settings);
+	Settings_Encode(&pSetHandle->Settings, payload);
+
+	if(RTC_ReadNVRAM(pConfig->pRTCHandle, pConfig->Offset, block, sizeof(block)) != RTC_OK)
+		return SETTINGS_ERR_BUS;
+
+	// 2. Header. A longer payload (newer firmware) can not fit the read and is refused too
+	len = block[2];
+	if((block[0] != SETTINGS_MAGIC) || (block[1] != SETTINGS_VERSION) || (len > SETTINGS_PAYLOAD_LEN))
+		return SETTINGS_ERR_MAGIC;
+
+	crc = Crc_CRC32(block, SETTINGS_HEADER_LEN + len);
+	pCrc = &block[SETTINGS_HEADER_LEN + len];
+	if(crc != ((uint32_t)pCrc[0] | ((uint32_t)pCrc[1] << 8) | ((uint32_t)pCrc[2] << 16) | ((uint32_t)pCrc[3] << 24)))
+		return SETTINGS_ERR_CRC;
+
+	// 3. Stored fields over the defaults
+	for(uint8_t i = 0; i < len; i++)
+		payload[i] = block[SETTINGS_HEADER_LEN + i];
+	Settings_Decode(payload, &pSetHandle->Settings);
+
+	return SETTINGS_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - Settings_Save
+ *
+ * @brief             - Writes the current settings to the RTC NVRAM
+ *
+ * @param[in]         - settings handle
+ *
+ * @return            -  SETTINGS_OK or SETTINGS_ERR_BUS
+ *
+ * @Note              -  one burst. A reset in the middle leaves a block with a bad CRC, the next
+ * 						 boot falls back to the defaults
+
+ *********************************************************************/
+uint8_t Settings_Save(Settings_Handle_t *pSetHandle)
+{
+	Settings_Config_t *pConfig = &pSetHandle->Settings_Config;
+	uint8_t block[SETTINGS_BLOCK_LEN];
+	uint8_t *pCrc = &block[SETTINGS_HEADER_LEN + SETTINGS_PAYLOAD_LEN];
+	uint32_t crc;
+
+	block[0] = SETTINGS_MAGIC;
+	block[1] = SETTINGS_VERSION;
+	block[2] = SETTINGS_PAYLOAD_LEN;
+	Settings_Encode(&pSetHandle->Settings, &block[SETTINGS_HEADER_LEN]);
+
+	crc = Crc_CRC32(block, SETTINGS_HEADER_LEN + SETTINGS_PAYLOAD_LEN);
+	pCrc[0] = (uint8_t)crc;
+	pCrc[1] = (uint8_t)(crc >> 8);
+	pCrc[2] = (uint8_t)(crc >> 16);
+	pCrc[3] = (uint8_t)(crc >> 24);
+
+	if(RTC_WriteNVRAM(pConfig->pRTCHandle, pConfig->Offset, block, sizeof(block)) != RTC_OK)
+		return SETTINGS_ERR_BUS;
+
+	return SETTINGS_OK;
+}
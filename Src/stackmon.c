@@ -0,0 +1,169 @@
+/*
+ * stackmon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "stackmon.h"
+#include "mempool.h"
+
+static void StackMon_ArmGuard(uint32_t *pBottom);
+
+/*
+ * Helper functions
+ */
+static void StackMon_ArmGuard(uint32_t *pBottom)
+{
+	// the region must be aligned to its size and end at or below the stack bottom
+	uint32_t base = ((uint32_t)(uintptr_t)pBottom - STACKMON_GUARD_SIZE) & ~(uint32_t)(STACKMON_GUARD_SIZE - 1);
+	uint32_t sizeField = 0;
+
+	while((2UL << sizeField) < STACKMON_GUARD_SIZE)
+		sizeField++;
+
+	*MPU_RNR = STACKMON_GUARD_REGION;
+	*MPU_RBAR = base;
+	// no access (AP = 0), never execute
+	*MPU_RASR = (1 << MPU_RASR_XN) | (sizeField << MPU_RASR_SIZE) | (1 << MPU_RASR_ENABLE);
+
+	// the default memory map stays in place for everything else
+	*MPU_CTRL = (1 << MPU_CTRL_PRIVDEFENA) | (1 << MPU_CTRL_ENABLE);
+	__DSB();
+	__ISB();
+}
+
+/*********************************************************************
+ * @fn      		  - StackMon_Init
+ *
+ * @brief             - Initializes the stack monitor and arms the MPU guard
+ *
+ * @param[in]         - stack monitor handle with StackMon_Config filled in
+ *
+ * @return            -  none
+ *
+ * @Note              -  the stack must already be painted (Reset_Handler or StackMon_Paint)
+
+ *********************************************************************/
+void StackMon_Init(StackMon_Handle_t *pStackMonHandle)
+{
+	pStackMonHandle->pMark = pStackMonHandle->StackMon_Config.pTop;
+	pStackMonHandle->pScan = pStackMonHandle->StackMon_Config.pBottom;
+
+	if(pStackMonHandle->StackMon_Config.Guard == ENABLE)
+		StackMon_ArmGuard(pStackMonHandle->StackMon_Config.pBottom);
+}
+
+/*********************************************************************
+ * @fn      		  - StackMon_Paint
+ *
+ * @brief             - Fills the unused part of the stack with STACKMON_PAINT
+ *
+ * @param[in]         - stack monitor handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  only for a stack which is not in use (or not the current one)
+
+ *********************************************************************/
+void StackMon_Paint(StackMon_Handle_t *pStackMonHandle)
+{
+	for(uint32_t *p = pStackMonHandle->StackMon_Config.pBottom; p < pStackMonHandle->StackMon_Config.pTop; p++)
+		*p = STACKMON_PAINT;
+
+	pStackMonHandle->pMark = pStackMonHandle->StackMon_Config.pTop;
+	pStackMonHandle->pScan = pStackMonHandle->StackMon_Config.pBottom;
+}
+
+/*********************************************************************
+ * @fn      		  - StackMon_Scan
+ *
+ * @brief             - Checks up to MaxWords words of the stack for the high-water mark
+ *
+ * @param[in]         - stack monitor handle
+ * @param[in]         - maximum number of words to check in this call
+ *
+ * @return            -  1 when a scan pass completed, 0 otherwise
+ *
+ * @Note              -  meant for idle time. A pass is at most (stack size - high-water) / 4 words
+
+ *********************************************************************/
+uint8_t StackMon_Scan(StackMon_Handle_t *pStackMonHandle, uint32_t MaxWords)
+{
+	uint32_t *pScan = pStackMonHandle->pScan;
+
+	while(MaxWords--)
+	{
+		if(pScan >= pStackMonHandle->pMark)
+		{
+			// nothing below the mark was touched since the last pass
+			pStackMonHandle->pScan = pStackMonHandle->StackMon_Config.pBottom;
+			return 1;
+		}
+
+		if(*pScan != STACKMON_PAINT)
+		{
+			// new deepest point. Next pass only has to look below it
+			pStackMonHandle->pMark = pScan;
+			pStackMonHandle->pScan = pStackMonHandle->StackMon_Config.pBottom;
+			return 1;
+		}
+
+		pScan++;
+	}
+
+	pStackMonHandle->pScan = pScan;
+
+	return 0;
+}
+
+/*********************************************************************
+ * @fn      		  - StackMon_GetSize
+ *
+ * @brief             - Returns the size of the stack
+ *
+ * @param[in]         - stack monitor handle
+ *
+ * @return            -  bytes
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t StackMon_GetSize(StackMon_Handle_t *pStackMonHandle)
+{
+	return (uint32_t)((pStackMonHandle->StackMon_Config.pTop - pStackMonHandle->StackMon_Config.pBottom) * sizeof(uint32_t));
+}
+
+/*********************************************************************
+ * @fn      		  - StackMon_GetHighWater
+ *
+ * @brief             - Returns the maximum stack depth found so far
+ *
+ * @param[in]         - stack monitor handle
+ *
+ * @return            -  bytes. Equal to the stack size if the paint is gone completely
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t StackMon_GetHighWater(StackMon_Handle_t *pStackMonHandle)
+{
+	return (uint32_t)((pStackMonHandle->StackMon_Config.pTop - pStackMonHandle->pMark) * sizeof(uint32_t));
+}
+
+/*********************************************************************
+ * @fn      		  - StackMon_GetHeapHighWater
+ *
+ * @brief             - Returns the heap high-water mark
+ *
+ * @param[in]         - none
+ *
+ * @return            -  bytes (whole pool blocks)
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t StackMon_GetHeapHighWater(void)
+{
+	return Mempool_GetBytesHighWater();
+}
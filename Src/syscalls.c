@@ -29,6 +29,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "xprintf.h"
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -112,14 +113,9 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
   (void)file;
-  int DataIdx;
 
-  for (DataIdx = 0; DataIdx < len; DataIdx++)
-  {
-    //__io_putchar(*ptr++);
-	  ITM_SendChar(*ptr++);
-  }
-  return len;
+  // same sink as XPrintf(), see xprintf.h
+  return XPrintf_Write(ptr, (uint32_t)len);
 }
 
 int _close(int file)
@@ -23,6 +23,11 @@
 /* Includes */
 #include <errno.h>
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "mempool.h"
+
+struct _reent;
 
 /**
  * Pointer to the current high watermark of the heap usage
@@ -35,17 +40,17 @@ static uint8_t *__sbrk_heap_end = NULL;
  *
  * @verbatim
  * ############################################################################
- * #  .data  #  .bss  #       newlib heap       #          MSP stack          #
- * #         #        #                         # Reserved by _Min_Stack_Size #
+ * #  .data  #  .bss  #                    newlib heap                        #
  * ############################################################################
- * ^-- RAM start      ^-- _end                             _estack, RAM end --^
+ * ^-- RAM start      ^-- _end                                   _eram, RAM end --^
  * @endverbatim
  *
  * This implementation starts allocating at the '_end' linker symbol
- * The '_Min_Stack_Size' linker symbol reserves a memory for the MSP stack
- * The implementation considers '_estack' linker symbol to be RAM end
- * NOTE: If the MSP stack, at any point during execution, grows larger than the
- * reserved size, please increase the '_Min_Stack_Size'.
+ * The implementation considers '_eram' linker symbol to be RAM end
+ * NOTE: The MSP stack lives in CCM-RAM (see the linker script), so the heap
+ * may grow up to the end of RAM.
+ * NOTE: malloc and friends are served by the fixed-block pools (mempool.c),
+ * see below. _sbrk is only kept for library code calling it directly.
  *
  * @param incr Memory size
  * @return Pointer to allocated memory
@@ -53,10 +58,8 @@ static uint8_t *__sbrk_heap_end = NULL;
 void *_sbrk(ptrdiff_t incr)
 {
   extern uint8_t _end; /* Symbol defined in the linker script */
-  extern uint8_t _estack; /* Symbol defined in the linker script */
-  extern uint32_t _Min_Stack_Size; /* Symbol defined in the linker script */
-  const uint32_t stack_limit = (uint32_t)&_estack - (uint32_t)&_Min_Stack_Size;
-  const uint8_t *max_heap = (uint8_t *)stack_limit;
+  extern uint8_t _eram; /* Symbol defined in the linker script */
+  const uint8_t *max_heap = &_eram;
   uint8_t *prev_heap_end;
 
   /* Initialize heap end at first call */
@@ -65,7 +68,7 @@ void *_sbrk(ptrdiff_t incr)
     __sbrk_heap_end = &_end;
   }
 
-  /* Protect heap from growing into the reserved MSP stack */
+  /* Protect heap from growing past the end of RAM */
   if (__sbrk_heap_end + incr > max_heap)
   {
     errno = ENOMEM;
@@ -77,3 +80,110 @@ void *_sbrk(ptrdiff_t incr)
 
   return (void *)prev_heap_end;
 }
+
+/**
+ * @brief malloc shim. Routes the C library allocations (printf buffers,
+ *        strdup, ...) to the fixed-block pools instead of the _sbrk heap.
+ *        Both the plain and the reentrant newlib entry points are provided,
+ *        so the newlib allocator is never linked in.
+ */
+void *malloc(size_t size)
+{
+  void *ptr = Mempool_Alloc(size);
+
+  if (ptr == NULL)
+  {
+    errno = ENOMEM;
+  }
+
+  return ptr;
+}
+
+void free(void *ptr)
+{
+  Mempool_Free(ptr);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+  size_t total = nmemb * size;
+  void *ptr;
+
+  if ((size != 0) && ((total / size) != nmemb))
+  {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  ptr = malloc(total);
+  if (ptr != NULL)
+  {
+    memset(ptr, 0, total);
+  }
+
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+  uint32_t old_size;
+  void *new_ptr;
+
+  if (ptr == NULL)
+  {
+    return malloc(size);
+  }
+
+  if (size == 0)
+  {
+    Mempool_Free(ptr);
+    return NULL;
+  }
+
+  /* Not from the pool, nothing known to copy */
+  old_size = Mempool_BlockSize(ptr);
+  if (old_size == 0)
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  /* Still fits in the current block */
+  if (size <= old_size)
+  {
+    return ptr;
+  }
+
+  new_ptr = malloc(size);
+  if (new_ptr != NULL)
+  {
+    memcpy(new_ptr, ptr, old_size);
+    Mempool_Free(ptr);
+  }
+
+  return new_ptr;
+}
+
+void *_malloc_r(struct _reent *r, size_t size)
+{
+  (void)r;
+  return malloc(size);
+}
+
+void _free_r(struct _reent *r, void *ptr)
+{
+  (void)r;
+  free(ptr);
+}
+
+void *_calloc_r(struct _reent *r, size_t nmemb, size_t size)
+{
+  (void)r;
+  return calloc(nmemb, size);
+}
+
+void *_realloc_r(struct _reent *r, void *ptr, size_t size)
+{
+  (void)r;
+  return realloc(ptr, size);
+}
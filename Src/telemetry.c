@@ -0,0 +1,325 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "telemetry.h"
+#include "crc.h"
+#include <string.h>
+
+void ITM_SendChar(uint8_t ch);
+
+static uint32_t Telemetry_PutZigzag(uint8_t *pBuf, int32_t value);
+
+static uint32_t Telemetry_PutZigzag(uint8_t *pBuf, int32_t value)
+{
+	// map signed to unsigned so small negative deltas stay small: 0,-1,1,-2 -> 0,1,2,3
+	return Telemetry_PutVarint(pBuf, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_Init
+ *
+ * @brief             - Initializes a telemetry stream
+ *
+ * @param[in]         - telemetry handle
+ * @param[in]         - sink which receives the encoded frames
+ * @param[in]         - sink context
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Telemetry_Init(Telemetry_Handle_t *pTlmHandle, Telemetry_Sink_t pfnSink, void *pSinkCtx)
+{
+	memset(pTlmHandle, 0, sizeof(*pTlmHandle));
+	pTlmHandle->pfnSink = pfnSink;
+	pTlmHandle->pSinkCtx = pSinkCtx;
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_PutRecord
+ *
+ * @brief             - Frames, CRCs and COBS encodes one record and hands it to the sink
+ *
+ * @param[in]         - telemetry handle
+ * @param[in]         - record type (@TLM_REC)
+ * @param[in]         - raw payload
+ * @param[in]         - payload length
+ *
+ * @return            -  TLM_OK or TLM_ERR_TOO_LONG
+ *
+ * @Note              -  the frame is built in the handle, no heap is used. Thread context, the CRC
+ * 						 unit is not reentrant (crc.h)
+
+ *********************************************************************/
+uint8_t Telemetry_PutRecord(Telemetry_Handle_t *pTlmHandle, uint8_t type, const uint8_t *pPayload, uint32_t len)
+{
+	uint8_t *raw = pTlmHandle->Raw;
+	uint8_t *encoded = pTlmHandle->Frame;
+	uint32_t rawLen, encodedLen;
+	uint32_t crc;
+
+	if(len > TLM_MAX_PAYLOAD)
+		return TLM_ERR_TOO_LONG;
+
+	// 1. header
+	raw[0] = type;
+	raw[1] = pTlmHandle->Seq++;
+	memcpy(&raw[2], pPayload, len);
+	rawLen = len + 2;
+
+	// 2. CRC over header and payload, little endian
+	crc = Telemetry_CRC32(raw, rawLen);
+	raw[rawLen++] = (uint8_t)(crc & 0xFF);
+	raw[rawLen++] = (uint8_t)(crc >> 8);
+	raw[rawLen++] = (uint8_t)(crc >> 16);
+	raw[rawLen++] = (uint8_t)(crc >> 24);
+
+	// 3. COBS encode and terminate with the frame delimiter
+	encodedLen = Telemetry_COBSEncode(raw, rawLen, encoded);
+	encoded[encodedLen++] = 0x00;
+
+	pTlmHandle->FramesSent++;
+	pTlmHandle->BytesSent += encodedLen;
+
+	if(pTlmHandle->pfnSink)
+		pTlmHandle->pfnSink(pTlmHandle->pSinkCtx, encoded, encodedLen);
+
+	return TLM_OK;
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_PutTimestamp
+ *
+ * @brief             - Sends an RTC timestamp, delta encoded against the previous one
+ *
+ * @param[in]         - telemetry handle
+ * @param[in]         - seconds since 01/01/00 00:00:00
+ *
+ * @return            -  TLM_OK or TLM_ERR_TOO_LONG
+ *
+ * @Note              -  an absolute timestamp is sent periodically so that a collector
+ * 						 which lost a frame can recover
+
+ *********************************************************************/
+uint8_t Telemetry_PutTimestamp(Telemetry_Handle_t *pTlmHandle, uint32_t timestamp)
+{
+	uint8_t payload[1 + 5];
+	uint32_t len = 1;
+
+	if(pTlmHandle->TimestampCount == 0)
+	{
+		payload[0] = TLM_TIMESTAMP_FLAG_ABS;
+		len += Telemetry_PutVarint(&payload[len], timestamp);
+	}
+	else
+	{
+		payload[0] = 0;
+		len += Telemetry_PutZigzag(&payload[len], (int32_t)(timestamp - pTlmHandle->LastTimestamp));
+	}
+
+	pTlmHandle->LastTimestamp = timestamp;
+	if(++pTlmHandle->TimestampCount >= TLM_TIMESTAMP_ABS_INTERVAL)
+		pTlmHandle->TimestampCount = 0;
+
+	return Telemetry_PutRecord(pTlmHandle, TLM_REC_TIMESTAMP, payload, len);
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_PutI2CErrors
+ *
+ * @brief             - Sends the error counters of an I2C handle
+ *
+ * @param[in]         - telemetry handle
+ * @param[in]         - I2C handle whose ErrCount[] is sent
+ *
+ * @return            -  TLM_OK or TLM_ERR_TOO_LONG
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Telemetry_PutI2CErrors(Telemetry_Handle_t *pTlmHandle, I2C_Handle_t *pI2CHandle)
+{
+	uint8_t payload[1 + (5 * I2C_ERRCNT_NUM)];
+	uint32_t len = 0;
+
+	if(pI2CHandle->pI2Cx == I2C1)
+		payload[len++] = 1;
+	else if(pI2CHandle->pI2Cx == I2C2)
+		payload[len++] = 2;
+	else if(pI2CHandle->pI2Cx == I2C3)
+		payload[len++] = 3;
+	else
+		payload[len++] = 0;
+
+	for(uint32_t i = 0; i < I2C_ERRCNT_NUM; i++)
+		len += Telemetry_PutVarint(&payload[len], pI2CHandle->ErrCount[i]);
+
+	return Telemetry_PutRecord(pTlmHandle, TLM_REC_I2C_ERRORS, payload, len);
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_PutHistogram
+ *
+ * @brief             - Sends a histogram (for example a profiling histogram)
+ *
+ * @param[in]         - telemetry handle
+ * @param[in]         - application defined histogram id
+ * @param[in]         - bin counters
+ * @param[in]         - number of bins, at most TLM_HIST_MAX_BINS
+ *
+ * @return            -  TLM_OK or TLM_ERR_TOO_LONG
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Telemetry_PutHistogram(Telemetry_Handle_t *pTlmHandle, uint8_t id, const uint32_t *pBins, uint8_t noOfBins)
+{
+	uint8_t payload[2 + (5 * TLM_HIST_MAX_BINS)];
+	uint32_t len = 0;
+
+	if(noOfBins > TLM_HIST_MAX_BINS)
+		return TLM_ERR_TOO_LONG;
+
+	payload[len++] = id;
+	payload[len++] = noOfBins;
+	for(uint8_t i = 0; i < noOfBins; i++)
+		len += Telemetry_PutVarint(&payload[len], pBins[i]);
+
+	return Telemetry_PutRecord(pTlmHandle, TLM_REC_HISTOGRAM, payload, len);
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_PutVarint
+ *
+ * @brief             - Writes an unsigned LEB128 varint
+ *
+ * @param[in]         - output buffer, at least 5 bytes
+ * @param[in]         - value
+ *
+ * @return            -  number of bytes written (1 to 5)
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint32_t Telemetry_PutVarint(uint8_t *pBuf, uint32_t value)
+{
+	uint32_t len = 0;
+
+	while(value >= 0x80)
+	{
+		pBuf[len++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	pBuf[len++] = (uint8_t)value;
+
+	return len;
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_COBSEncode
+ *
+ * @brief             - Consistent Overhead Byte Stuffing. Removes every 0x00 from the data
+ *
+ * @param[in]         - input
+ * @param[in]         - input length
+ * @param[in]         - output, at least len + (len/254) + 1 bytes
+ *
+ * @return            -  encoded length (without the 0x00 delimiter)
+ *
+ * @Note              -  every zero byte is replaced by the distance to the next zero byte
+
+ *********************************************************************/
+uint32_t Telemetry_COBSEncode(const uint8_t *pIn, uint32_t len, uint8_t *pOut)
+{
+	uint32_t codeIdx = 0;
+	uint32_t writeIdx = 1;
+	uint8_t code = 1;
+
+	for(uint32_t readIdx = 0; readIdx < len; readIdx++)
+	{
+		if(pIn[readIdx] == 0)
+		{
+			pOut[codeIdx] = code;
+			codeIdx = writeIdx++;
+			code = 1;
+		}
+		else
+		{
+			pOut[writeIdx++] = pIn[readIdx];
+			if(++code == 0xFF)
+			{
+				// maximum block length reached, start a new block without an implied zero
+				pOut[codeIdx] = code;
+				codeIdx = writeIdx++;
+				code = 1;
+			}
+		}
+	}
+	pOut[codeIdx] = code;
+
+	return writeIdx;
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_CRC32
+ *
+ * @brief             - Frame CRC-32
+ *
+ * @param[in]         - data
+ * @param[in]         - length
+ *
+ * @return            -  CRC
+ *
+ * @Note              -  see crc.h
+
+ *********************************************************************/
+uint32_t Telemetry_CRC32(const uint8_t *pData, uint32_t len)
+{
+	return Crc_CRC32(pData, len);
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_SinkITM
+ *
+ * @brief             - Sends the frame over ITM stimulus port 0
+ *
+ * @param[in]         - unused
+ * @param[in]         - frame
+ * @param[in]         - frame length
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Telemetry_SinkITM(void *pCtx, const uint8_t *pData, uint32_t len)
+{
+	(void)pCtx;
+
+	while(len--)
+		ITM_SendChar(*pData++);
+}
+
+/*********************************************************************
+ * @fn      		  - Telemetry_SinkUSART
+ *
+ * @brief             - Sends the frame over a USART
+ *
+ * @param[in]         - USART_Handle_t* of an initialized 8 bit USART
+ * @param[in]         - frame
+ * @param[in]         - frame length
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void Telemetry_SinkUSART(void *pCtx, const uint8_t *pData, uint32_t len)
+{
+	USART_SendData((USART_Handle_t*)pCtx, (uint8_t*)pData, len);
+}
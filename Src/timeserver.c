@@ -0,0 +1,232 @@
+/*
+ * timeserver.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "timeserver.h"
+#include "rtc.h"
+#include <string.h>
+
+#define TIMESERVER_US_PER_SECOND		1000000LL
+
+static void TimeServer_PinConfig(GPIO_RegDef_t *pGPIOx, uint8_t Pin);
+static void TimeServer_Encode(uint32_t Epoch, uint8_t *pRegs);
+static void TimeServer_Latch(TimeServer_Handle_t *pServerHandle);
+
+/*
+ * Helper functions
+ */
+static void TimeServer_PinConfig(GPIO_RegDef_t *pGPIOx, uint8_t Pin)
+{
+	GPIO_Handle_t pin;
+
+	memset(&pin, 0, sizeof(pin));
+	pin.pGPIOx = pGPIOx;
+	pin.GPIO_PinConfig.GPIO_PinNumber = Pin;
+	pin.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	pin.GPIO_PinConfig.GPIO_PinAltFunMode = GPIO_ALTFN_AF4;
+	pin.GPIO_PinConfig.GPIO_PinOPType = GPIO_OUT_TYPE_OD;
+	pin.GPIO_PinConfig.GPIO_PinPuPdControl = GPIO_PUPD_PULLUP;
+	pin.GPIO_PinConfig.GPIO_PinSpeed = GPIO_OUT_SPEED_LOW;
+
+	GPIO_Init(&pin);
+}
+
+static void TimeServer_Encode(uint32_t Epoch, uint8_t *pRegs)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_fromEpoch(Epoch, &time, &date);
+
+	// DS1307 layout, CH = 0 and bit 6 of the hours = 0 (24h)
+	pRegs[0] = RTC_BintoBCD(time.seconds);
+	pRegs[1] = RTC_BintoBCD(time.minutes);
+	pRegs[2] = RTC_BintoBCD(time.hours);
+	pRegs[3] = date.day;
+	pRegs[4] = RTC_BintoBCD(date.date);
+	pRegs[5] = RTC_BintoBCD(date.month);
+	pRegs[6] = RTC_BintoBCD(date.year);
+}
+
+__RAMFUNC static void TimeServer_Latch(TimeServer_Handle_t *pServerHandle)
+{
+	const TimeServer_Slot_t *pSlot;
+	const uint8_t *pRegs;
+	Timestamp_t now;
+	uint32_t gen;
+	int64_t elapsed;
+
+	if(pServerHandle->Gen == 0)
+		return;
+
+	Timestamp_Get(pServerHandle->TimeServer_Config.pTsHandle, &now);
+
+	// the publisher is thread context, it never runs while this ISR does. The check covers a
+	// higher priority ISR reading in between
+	do
+	{
+		gen = __atomic_load_n(&pServerHandle->Gen, __ATOMIC_ACQUIRE);
+		pSlot = &pServerHandle->Slot[gen & 1];
+		elapsed = ((int64_t)now.Seconds * TIMESERVER_US_PER_SECOND + now.Micros) - pSlot->PivotUs;
+		pRegs = pSlot->Regs[(elapsed >= TIMESERVER_US_PER_SECOND) ? 1 : 0];
+		// byte loop, memcpy would be a call into flash
+		for(uint8_t i = 0; i < TIMESERVER_NO_OF_TIME_REGS; i++)
+			pServerHandle->Regs[i] = pRegs[i];
+	}while(__atomic_load_n(&pServerHandle->Gen, __ATOMIC_ACQUIRE) != gen);
+}
+
+/*********************************************************************
+ * @fn      		  - TimeServer_Init
+ *
+ * @brief             - Sets up the I2C peripheral as a DS1307 compatible slave
+ *
+ * @param[in]         - time server handle with TimeServer_Config filled in
+ *
+ * @return            -  none
+ *
+ * @Note              -  answers from here on, the time reads as halted until TimeServer_Publish()
+
+ *********************************************************************/
+void TimeServer_Init(TimeServer_Handle_t *pServerHandle)
+{
+	TimeServer_Config_t config = pServerHandle->TimeServer_Config;
+	I2C_Handle_t *pI2CHandle = &pServerHandle->I2CHandle;
+
+	memset(pServerHandle, 0, sizeof(*pServerHandle));
+	if(config.Address == 0)
+		config.Address = TIMESERVER_DEFAULT_ADDRESS;
+	pServerHandle->TimeServer_Config = config;
+	pServerHandle->Regs[0] = (1 << TIMESERVER_REG_SECONDS_CH);
+
+	TimeServer_PinConfig(config.pSCLPort, config.SCLPin);
+	TimeServer_PinConfig(config.pSDAPort, config.SDAPin);
+
+	// the slave follows the master clock, the speed only sets the timing registers
+	pI2CHandle->pI2Cx = config.pI2Cx;
+	pI2CHandle->I2C_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	pI2CHandle->I2C_Config.I2C_DeviceAddress = config.Address;
+	pI2CHandle->I2C_Config.I2C_ACKControl = I2C_ACKCTRL_ACK_EN;
+	I2C_ClockControl(config.pI2Cx, ENABLE);
+	I2C_Init(pI2CHandle);
+
+	REG_SET_BIT(config.pI2Cx->CR2, I2C_CR2_ITEVTEN);
+	REG_SET_BIT(config.pI2Cx->CR2, I2C_CR2_ITBUFEN);
+	REG_SET_BIT(config.pI2Cx->CR2, I2C_CR2_ITERREN);
+	I2C_IRQPriorityConfig(config.EVIRQNumber, config.IRQPriority);
+	I2C_IRQPriorityConfig(config.ERIRQNumber, config.IRQPriority);
+	I2C_IRQInterruptConfig(config.EVIRQNumber, ENABLE);
+	I2C_IRQInterruptConfig(config.ERIRQNumber, ENABLE);
+}
+
+/*********************************************************************
+ * @fn      		  - TimeServer_Publish
+ *
+ * @brief             - Publishes the time served from now on
+ *
+ * @param[in]         - time server handle
+ * @param[in]         - current time (TimeSync_Get), taken right before the call
+ *
+ * @return            -  none
+ *
+ * @Note              -  thread context, once per second. A late publish keeps serving the next
+ * 						 second, never an older one
+
+ *********************************************************************/
+void TimeServer_Publish(TimeServer_Handle_t *pServerHandle, const Timestamp_t *pNow)
+{
+	TimeServer_Slot_t *pSlot = &pServerHandle->Slot[(pServerHandle->Gen + 1) & 1];
+	Timestamp_t base;
+
+	// the second of pNow started Micros ago on the timestamp timer
+	Timestamp_Get(pServerHandle->TimeServer_Config.pTsHandle, &base);
+	pSlot->PivotUs = (int64_t)base.Seconds * TIMESERVER_US_PER_SECOND + base.Micros - pNow->Micros;
+
+	TimeServer_Encode(pNow->Seconds, pSlot->Regs[0]);
+	TimeServer_Encode(pNow->Seconds + 1, pSlot->Regs[1]);
+
+	__atomic_store_n(&pServerHandle->Gen, pServerHandle->Gen + 1, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+ * @fn      		  - TimeServer_EventHandling
+ *
+ * @brief             - Serves the register map, called for the driver events of the server I2C
+ *
+ * @param[in]         - time server handle
+ * @param[in]         - driver event, @I2C application event macros
+ *
+ * @return            -  none
+ *
+ * @Note              -  ISR context, from I2C_ApplicationEventCallback()
+
+ *********************************************************************/
+__RAMFUNC void TimeServer_EventHandling(TimeServer_Handle_t *pServerHandle, uint8_t AppEv)
+{
+	I2C_RegDef_t *pI2Cx = pServerHandle->I2CHandle.pI2Cx;
+	uint8_t data;
+
+	switch(AppEv)
+	{
+	case I2C_EV_ADDR_MATCH:
+		// like the DS1307, the time is latched at the start of every transfer
+		TimeServer_Latch(pServerHandle);
+		pServerHandle->Preloaded = 0;
+		pServerHandle->Nacked = 0;
+		if(pI2Cx->SR2 & (1 << I2C_SR2_TRA))
+		{
+			pServerHandle->Reads++;
+		}
+		else
+		{
+			pServerHandle->PointerNext = 1;
+			pServerHandle->Writes++;
+		}
+		break;
+
+	case I2C_EV_DATA_REQ:
+		// after the NACK the byte only clears TXE, it is never sent
+		I2C_SlaveSendData(pI2Cx, pServerHandle->Regs[pServerHandle->Pointer]);
+		if(pServerHandle->Nacked)
+			break;
+		pServerHandle->Pointer = (pServerHandle->Pointer + 1) % TIMESERVER_NO_OF_REGS;
+		// TXE still set -> the byte went straight to the shift register, clear -> it waits in DR
+		pServerHandle->Preloaded = !(pI2Cx->SR1 & (1 << I2C_SR1_TxE));
+		break;
+
+	case I2C_EV_DATA_RCV:
+		data = I2C_SlaveReceiveData(pI2Cx);
+		if(pServerHandle->PointerNext)
+		{
+			pServerHandle->Pointer = data % TIMESERVER_NO_OF_REGS;
+			pServerHandle->PointerNext = 0;
+			break;
+		}
+
+		// the time comes from the host sync, downstream boards can not set it
+		if(pServerHandle->Pointer >= TIMESERVER_REG_CONTROL)
+			pServerHandle->Regs[pServerHandle->Pointer] = data;
+		else
+			pServerHandle->RejectedWrites++;
+		pServerHandle->Pointer = (pServerHandle->Pointer + 1) % TIMESERVER_NO_OF_REGS;
+		break;
+
+	case I2C_ERROR_AF:
+		// NACK of the last byte read. Only a byte still waiting in DR was loaded after it and stays unsent,
+		// TXE set means it went on the bus before the NACK
+		if(pServerHandle->Preloaded && !(pI2Cx->SR1 & (1 << I2C_SR1_TxE)))
+			pServerHandle->Pointer = (pServerHandle->Pointer + TIMESERVER_NO_OF_REGS - 1) % TIMESERVER_NO_OF_REGS;
+		pServerHandle->Preloaded = 0;
+		pServerHandle->Nacked = 1;
+		break;
+
+	case I2C_EV_STOP:
+		pServerHandle->PointerNext = 0;
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,274 @@
+/*
+ * timestamp.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "timestamp.h"
+#include <string.h>
+
+#define TIMESTAMP_US_PER_SECOND			1000000UL
+
+__RAMFUNC static uint32_t Timestamp_Scale(uint64_t PeriodQ8);
+
+/*
+ * Helper functions
+ */
+__RAMFUNC static uint32_t Timestamp_Scale(uint64_t PeriodQ8)
+{
+	// us per tick in Q32 = 10^6 * 2^32 / period = 10^6 * 2^40 / PeriodQ8. Shift and subtract instead of
+	// the libgcc 64 bit division, which runs from flash. The quotient fits 32 bits for timer clocks > 1MHz
+	uint64_t rem = (uint64_t)TIMESTAMP_US_PER_SECOND << 40;
+	uint32_t scale = 0;
+
+	for(int8_t bit = 31; bit >= 0; bit--)
+	{
+		if((rem >> bit) >= PeriodQ8)
+		{
+			rem -= PeriodQ8 << bit;
+			scale |= (1UL << bit);
+		}
+	}
+
+	return scale;
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_Init
+ *
+ * @brief             - Starts the timer free running at the timer clock
+ *
+ * @param[in]         - timestamp handle with Timestamp_Config filled in
+ *
+ * @return            -  none
+ *
+ * @Note              -  stamps count from the call until the first Timestamp_Sync()
+
+ *********************************************************************/
+void Timestamp_Init(Timestamp_Handle_t *pTsHandle)
+{
+	Timestamp_Config_t config = pTsHandle->Timestamp_Config;
+	TIM_RegDef_t *pTIMx = config.pTIMx;
+
+	memset(pTsHandle, 0, sizeof(*pTsHandle));
+	pTsHandle->Timestamp_Config = config;
+
+	// 1. Enable the peripheral clock
+	if(pTIMx == TIM2)
+		TIM2_CLK_EN();
+	else if(pTIMx == TIM5)
+		TIM5_CLK_EN();
+
+	// 2. No prescaler, full 32 bit range. UG loads PSC and ARR, URS keeps it from setting the update flag
+	pTIMx->CR1 = (1 << TIM_CR1_URS);
+	pTIMx->PSC = 0;
+	pTIMx->ARR = 0xFFFFFFFF;
+	pTIMx->EGR = (1 << TIM_EGR_UG);
+	pTIMx->CR1 |= (1 << TIM_CR1_CEN);
+
+	// 3. Start from the nominal second
+	pTsHandle->PeriodQ8 = (uint64_t)config.TimerClockHz << 8;
+	pTsHandle->Slot[0].Stamp = pTIMx->CNT;
+	pTsHandle->Slot[0].Scale = Timestamp_Scale(pTsHandle->PeriodQ8);
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_Edge
+ *
+ * @brief             - Latches the timer on an RTC second edge and updates the second length
+ *
+ * @param[in]         - timestamp handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  call first thing in the SQW ISR, the latency ends up in the stamps
+
+ *********************************************************************/
+__RAMFUNC void Timestamp_Edge(Timestamp_Handle_t *pTsHandle)
+{
+	uint32_t now = pTsHandle->Timestamp_Config.pTIMx->CNT;
+	uint32_t gen = pTsHandle->Gen;
+	Timestamp_Edge_t *pLast = &pTsHandle->Slot[gen & 1];
+	Timestamp_Edge_t *pNext = &pTsHandle->Slot[(gen + 1) & 1];
+	uint32_t nominal = pTsHandle->Timestamp_Config.TimerClockHz;
+	uint32_t delta = now - pLast->Stamp;
+
+	pNext->Scale = pLast->Scale;
+
+	// the time from Init to the first edge is not a whole second
+	if(pTsHandle->Edges != 0)
+	{
+		if((delta > nominal - (nominal / TIMESTAMP_TOLERANCE_DIV)) && (delta < nominal + (nominal / TIMESTAMP_TOLERANCE_DIV)))
+		{
+			pTsHandle->PeriodQ8 += ((int64_t)((uint64_t)delta << 8) - (int64_t)pTsHandle->PeriodQ8) >> TIMESTAMP_FILTER_SHIFT;
+			pNext->Scale = Timestamp_Scale(pTsHandle->PeriodQ8);
+		}
+		else
+		{
+			pTsHandle->Rejected++;
+		}
+	}
+
+	pNext->Edge = pLast->Edge + 1;
+	pNext->Stamp = now;
+	pTsHandle->Edges++;
+
+	// publish, readers pick up the new slot from here on
+	__atomic_store_n(&pTsHandle->Gen, gen + 1, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_Sync
+ *
+ * @brief             - Sets the RTC time of the last edge
+ *
+ * @param[in]         - timestamp handle
+ * @param[in]         - RTC epoch second, read after the last edge
+ *
+ * @return            -  none
+ *
+ * @Note              -  thread context, before the next edge
+
+ *********************************************************************/
+void Timestamp_Sync(Timestamp_Handle_t *pTsHandle, uint32_t Epoch)
+{
+	uint32_t gen = __atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE);
+
+	pTsHandle->Offset = Epoch - pTsHandle->Slot[gen & 1].Edge;
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_Get
+ *
+ * @brief             - Returns the current time with microsecond resolution
+ *
+ * @param[in]         - timestamp handle
+ * @param[out]        - timestamp
+ *
+ * @return            -  none
+ *
+ * @Note              -  any context, no bus traffic
+
+ *********************************************************************/
+__RAMFUNC void Timestamp_Get(Timestamp_Handle_t *pTsHandle, Timestamp_t *pStamp)
+{
+	Timestamp_Edge_t edge;
+	uint32_t gen, now, micros, seconds;
+
+	do
+	{
+		gen = __atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE);
+		edge = pTsHandle->Slot[gen & 1];
+		now = pTsHandle->Timestamp_Config.pTIMx->CNT;
+	}while(__atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE) != gen);
+
+	micros = (uint32_t)(((uint64_t)(now - edge.Stamp) * edge.Scale) >> 32);
+	seconds = pTsHandle->Offset + edge.Edge;
+
+	if(micros >= TIMESTAMP_US_PER_SECOND)
+	{
+		if(micros < TIMESTAMP_US_PER_SECOND + TIMESTAMP_LATE_US)
+		{
+			// the edge ISR has not run yet
+			micros = TIMESTAMP_US_PER_SECOND - 1;
+		}
+		else
+		{
+			seconds += micros / TIMESTAMP_US_PER_SECOND;
+			micros %= TIMESTAMP_US_PER_SECOND;
+		}
+	}
+
+	pStamp->Seconds = seconds;
+	pStamp->Micros = micros;
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_FromCount
+ *
+ * @brief             - Converts a timer count latched earlier to a timestamp
+ *
+ * @param[in]         - timestamp handle
+ * @param[in]         - timer count (Timestamp_GetCount)
+ * @param[out]        - timestamp
+ *
+ * @return            -  none
+ *
+ * @Note              -  the count must be within +-2^31 ticks of the last edge
+
+ *********************************************************************/
+void Timestamp_FromCount(Timestamp_Handle_t *pTsHandle, uint32_t Count, Timestamp_t *pStamp)
+{
+	Timestamp_Edge_t edge;
+	uint32_t gen;
+	int64_t micros;
+	int32_t seconds;
+
+	do
+	{
+		gen = __atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE);
+		edge = pTsHandle->Slot[gen & 1];
+	}while(__atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE) != gen);
+
+	// signed, counts latched before the last edge give negative offsets
+	micros = ((int64_t)(int32_t)(Count - edge.Stamp) * edge.Scale) >> 32;
+	seconds = (int32_t)(micros / (int64_t)TIMESTAMP_US_PER_SECOND);
+	micros -= (int64_t)seconds * TIMESTAMP_US_PER_SECOND;
+	if(micros < 0)
+	{
+		micros += TIMESTAMP_US_PER_SECOND;
+		seconds--;
+	}
+
+	pStamp->Seconds = pTsHandle->Offset + edge.Edge + seconds;
+	pStamp->Micros = (uint32_t)micros;
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_GetEdge
+ *
+ * @brief             - Returns the count and timer stamp of the last edge
+ *
+ * @param[in]         - timestamp handle
+ * @param[out]        - edge count
+ * @param[out]        - timer count at the edge
+ *
+ * @return            -  none
+ *
+ * @Note              -  raw edge timing for long term measurements (trim.h)
+
+ *********************************************************************/
+void Timestamp_GetEdge(Timestamp_Handle_t *pTsHandle, uint32_t *pEdge, uint32_t *pStamp)
+{
+	Timestamp_Edge_t edge;
+	uint32_t gen;
+
+	do
+	{
+		gen = __atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE);
+		edge = pTsHandle->Slot[gen & 1];
+	}while(__atomic_load_n(&pTsHandle->Gen, __ATOMIC_ACQUIRE) != gen);
+
+	*pEdge = edge.Edge;
+	*pStamp = edge.Stamp;
+}
+
+/*********************************************************************
+ * @fn      		  - Timestamp_GetDriftPPB
+ *
+ * @brief             - Returns the timer clock error against the RTC
+ *
+ * @param[in]         - timestamp handle
+ *
+ * @return            -  parts per billion, positive if the timer clock is fast
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+int32_t Timestamp_GetDriftPPB(Timestamp_Handle_t *pTsHandle)
+{
+	int64_t nominalQ8 = (int64_t)pTsHandle->Timestamp_Config.TimerClockHz << 8;
+
+	return (int32_t)((((int64_t)pTsHandle->PeriodQ8 - nominalQ8) * 1000000000LL) / nominalQ8);
+}
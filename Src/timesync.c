@@ -0,0 +1,491 @@
+/*
+ * timesync.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "timesync.h"
+#include "telemetry.h"
+#include <string.h>
+
+#define TIMESYNC_US_PER_SECOND			1000000LL
+
+static int64_t TimeSync_BaseUs(TimeSync_Handle_t *pSyncHandle);
+static int64_t TimeSync_SlewedUs(TimeSync_Handle_t *pSyncHandle, int64_t BaseUs);
+static int64_t TimeSync_SoftUs(TimeSync_Handle_t *pSyncHandle, int64_t BaseUs);
+static void TimeSync_PutTime(uint8_t *pBuf, int64_t Us);
+static int64_t TimeSync_GetTime(const uint8_t *pBuf);
+static int32_t TimeSync_COBSDecode(const uint8_t *pIn, uint32_t len, uint8_t *pOut, uint32_t maxLen);
+static void TimeSync_SendRequest(TimeSync_Handle_t *pSyncHandle);
+static uint8_t TimeSync_HandleReply(TimeSync_Handle_t *pSyncHandle);
+static uint8_t TimeSync_EndExchange(TimeSync_Handle_t *pSyncHandle);
+static void TimeSync_Apply(TimeSync_Handle_t *pSyncHandle, int64_t OffsetUs);
+static void TimeSync_Commit(TimeSync_Handle_t *pSyncHandle);
+static int64_t TimeSync_Abs(int64_t Value);
+
+/*
+ * Helper functions
+ */
+static int64_t TimeSync_BaseUs(TimeSync_Handle_t *pSyncHandle)
+{
+	Timestamp_t stamp;
+
+	Timestamp_Get(pSyncHandle->TimeSync_Config.pTsHandle, &stamp);
+
+	return (int64_t)stamp.Seconds * TIMESYNC_US_PER_SECOND + stamp.Micros;
+}
+
+static int64_t TimeSync_SlewedUs(TimeSync_Handle_t *pSyncHandle, int64_t BaseUs)
+{
+	int64_t elapsed, slewed;
+
+	if(!pSyncHandle->Slewing)
+		return 0;
+
+	elapsed = BaseUs - pSyncHandle->SlewStartUs;
+	if(elapsed <= 0)
+		return 0;
+
+	slewed = (elapsed * pSyncHandle->TimeSync_Config.SlewPPM) / TIMESYNC_US_PER_SECOND;
+	if(slewed >= TimeSync_Abs(pSyncHandle->SlewUs))
+		return pSyncHandle->SlewUs;
+
+	return (pSyncHandle->SlewUs < 0) ? -slewed : slewed;
+}
+
+static int64_t TimeSync_SoftUs(TimeSync_Handle_t *pSyncHandle, int64_t BaseUs)
+{
+	return BaseUs + pSyncHandle->CorrUs + TimeSync_SlewedUs(pSyncHandle, BaseUs);
+}
+
+static void TimeSync_PutTime(uint8_t *pBuf, int64_t Us)
+{
+	uint32_t seconds = (uint32_t)(Us / TIMESYNC_US_PER_SECOND);
+	uint32_t micros = (uint32_t)(Us % TIMESYNC_US_PER_SECOND);
+
+	for(uint8_t i = 0; i < 4; i++)
+	{
+		pBuf[i] = (uint8_t)(seconds >> (8 * i));
+		pBuf[4 + i] = (uint8_t)(micros >> (8 * i));
+	}
+}
+
+static int64_t TimeSync_GetTime(const uint8_t *pBuf)
+{
+	uint32_t seconds = 0, micros = 0;
+
+	for(uint8_t i = 0; i < 4; i++)
+	{
+		seconds |= (uint32_t)pBuf[i] << (8 * i);
+		micros |= (uint32_t)pBuf[4 + i] << (8 * i);
+	}
+
+	return (int64_t)seconds * TIMESYNC_US_PER_SECOND + micros;
+}
+
+/*
+ * returns decoded length, or -1 if the encoding is invalid or does not fit
+ */
+static int32_t TimeSync_COBSDecode(const uint8_t *pIn, uint32_t len, uint8_t *pOut, uint32_t maxLen)
+{
+	uint32_t readIdx = 0, writeIdx = 0;
+
+	while(readIdx < len)
+	{
+		uint8_t code = pIn[readIdx++];
+
+		if((code == 0) || ((readIdx + code - 1) > len) || ((writeIdx + code) > maxLen + 1))
+			return -1;
+
+		for(uint8_t i = 1; i < code; i++)
+			pOut[writeIdx++] = pIn[readIdx++];
+
+		if((code != 0xFF) && (readIdx < len))
+		{
+			if(writeIdx >= maxLen)
+				return -1;
+			pOut[writeIdx++] = 0;
+		}
+	}
+	return (int32_t)writeIdx;
+}
+
+static void TimeSync_SendRequest(TimeSync_Handle_t *pSyncHandle)
+{
+	uint8_t raw[TIMESYNC_RAW_FRAME];
+	uint8_t encoded[TIMESYNC_MAX_FRAME + 1];
+	uint32_t encodedLen, crc;
+
+	// 1. Same length as the reply, the time on the wire is the same both ways
+	memset(raw, 0, sizeof(raw));
+	raw[0] = TIMESYNC_MSG_REQUEST;
+	raw[1] = ++pSyncHandle->Seq;
+	TimeSync_PutTime(&raw[2], TimeSync_SoftUs(pSyncHandle, TimeSync_BaseUs(pSyncHandle)));
+
+	crc = Telemetry_CRC32(raw, 2 + TIMESYNC_PAYLOAD_LEN);
+	for(uint8_t i = 0; i < 4; i++)
+		raw[2 + TIMESYNC_PAYLOAD_LEN + i] = (uint8_t)(crc >> (8 * i));
+
+	encodedLen = Telemetry_COBSEncode(raw, sizeof(raw), encoded);
+	encoded[encodedLen++] = 0x00;
+
+	// 2. T1 as the first byte goes out, the T1 in the frame is only echoed back
+	pSyncHandle->T1 = TimeSync_SoftUs(pSyncHandle, TimeSync_BaseUs(pSyncHandle));
+	USART_SendData(pSyncHandle->TimeSync_Config.pUSARTHandle, encoded, encodedLen);
+
+	pSyncHandle->Exchanges++;
+	pSyncHandle->Timer = TIMESYNC_REPLY_TIMEOUT;
+	pSyncHandle->State = TIMESYNC_STATE_WAIT_REPLY;
+}
+
+static uint8_t TimeSync_HandleReply(TimeSync_Handle_t *pSyncHandle)
+{
+	uint8_t raw[TIMESYNC_RAW_FRAME];
+	Timestamp_t stamp;
+	int64_t t2, t3, t4, delay;
+	int32_t rawLen;
+	uint32_t crc;
+
+	rawLen = TimeSync_COBSDecode(pSyncHandle->RxBuf, pSyncHandle->RxLen, raw, sizeof(raw));
+	Timestamp_FromCount(pSyncHandle->TimeSync_Config.pTsHandle, pSyncHandle->RxEndCount, &stamp);
+
+	// the ISR only fills the buffer again once it is released
+	pSyncHandle->RxLen = 0;
+	pSyncHandle->RxReady = 0;
+
+	if(rawLen != TIMESYNC_RAW_FRAME)
+	{
+		pSyncHandle->BadFrames++;
+		return 0;
+	}
+
+	crc = (uint32_t)raw[rawLen - 4] | ((uint32_t)raw[rawLen - 3] << 8) |
+		  ((uint32_t)raw[rawLen - 2] << 16) | ((uint32_t)raw[rawLen - 1] << 24);
+
+	// a late reply to an earlier request fails the sequence check
+	if((crc != Telemetry_CRC32(raw, rawLen - 4)) || (pSyncHandle->State != TIMESYNC_STATE_WAIT_REPLY) ||
+	   (raw[0] != TIMESYNC_MSG_REPLY) || (raw[1] != pSyncHandle->Seq))
+	{
+		pSyncHandle->BadFrames++;
+		return 0;
+	}
+
+	t2 = TimeSync_GetTime(&raw[2 + TIMESYNC_TIME_LEN]);
+	t3 = TimeSync_GetTime(&raw[2 + 2 * TIMESYNC_TIME_LEN]);
+	t4 = TimeSync_SoftUs(pSyncHandle, (int64_t)stamp.Seconds * TIMESYNC_US_PER_SECOND + stamp.Micros);
+
+	// host queueing only ever adds delay, the fastest exchange of the burst is the most symmetric
+	delay = (t4 - pSyncHandle->T1) - (t3 - t2);
+	if((delay >= 0) && (delay <= (int64_t)pSyncHandle->TimeSync_Config.MaxDelayUs))
+	{
+		pSyncHandle->Samples++;
+		if(delay < pSyncHandle->BestDelayUs)
+		{
+			pSyncHandle->BestDelayUs = delay;
+			pSyncHandle->BestOffsetUs = ((t2 - pSyncHandle->T1) + (t3 - t4)) / 2;
+		}
+	}
+
+	return TimeSync_EndExchange(pSyncHandle);
+}
+
+static uint8_t TimeSync_EndExchange(TimeSync_Handle_t *pSyncHandle)
+{
+	if(pSyncHandle->Exchanges < TIMESYNC_BURST)
+	{
+		pSyncHandle->State = TIMESYNC_STATE_SEND;
+		return 0;
+	}
+
+	pSyncHandle->State = TIMESYNC_STATE_IDLE;
+	pSyncHandle->Countdown = pSyncHandle->TimeSync_Config.SyncPeriod;
+	if(pSyncHandle->Samples == 0)
+		return 0;
+
+	TimeSync_Apply(pSyncHandle, pSyncHandle->BestOffsetUs);
+	pSyncHandle->LastOffsetUs = pSyncHandle->BestOffsetUs;
+	pSyncHandle->LastDelayUs = pSyncHandle->BestDelayUs;
+	pSyncHandle->Syncs++;
+
+	return TIMESYNC_EV_SYNCED;
+}
+
+static void TimeSync_Apply(TimeSync_Handle_t *pSyncHandle, int64_t OffsetUs)
+{
+	int64_t base = TimeSync_BaseUs(pSyncHandle);
+
+	// 1. What was slewed so far is kept, the offset was measured against the clock as it runs now
+	pSyncHandle->CorrUs += TimeSync_SlewedUs(pSyncHandle, base);
+	pSyncHandle->Slewing = 0;
+
+	// 2. Forward and large: step. Backwards or small: slew, the clock never runs back. Far back is a
+	//    wrong clock rather than drift, slewing it out would take days
+	if((OffsetUs >= (int64_t)pSyncHandle->TimeSync_Config.StepThresholdUs) || (OffsetUs <= -TIMESYNC_MAX_SLEW_US))
+	{
+		pSyncHandle->CorrUs += OffsetUs;
+		pSyncHandle->Steps++;
+		if(OffsetUs < 0)
+			pSyncHandle->LastUs = 0;
+	}
+	else if(OffsetUs != 0)
+	{
+		pSyncHandle->SlewUs = OffsetUs;
+		pSyncHandle->SlewStartUs = base;
+		pSyncHandle->Slewing = 1;
+		return;
+	}
+
+	pSyncHandle->CommitDue = (TimeSync_Abs(pSyncHandle->CorrUs) >= TIMESYNC_COMMIT_MIN_US);
+}
+
+static void TimeSync_Commit(TimeSync_Handle_t *pSyncHandle)
+{
+	TimeSync_Config_t *pConfig = &pSyncHandle->TimeSync_Config;
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	uint32_t epoch, edge, stamp;
+	int64_t target;
+
+	// 1. Next whole second of the software clock far enough ahead to be written in time
+	epoch = (uint32_t)((TimeSync_SoftUs(pSyncHandle, TimeSync_BaseUs(pSyncHandle)) + pConfig->WriteLeadUs) / TIMESYNC_US_PER_SECOND) + 1;
+	target = (int64_t)epoch * TIMESYNC_US_PER_SECOND - pConfig->WriteLeadUs;
+	RTC_fromEpoch(epoch, &time, &date);
+	RTC_From24Hours(&time, pConfig->TimeFormat);
+
+	// 2. Wait for it and write the whole time in one burst, the seconds register restarts the divider
+	while(TimeSync_SoftUs(pSyncHandle, TimeSync_BaseUs(pSyncHandle)) < target);
+
+	if(RTC_SetDateTime(pConfig->pRTCHandle, &time, &date) != RTC_OK)
+	{
+		// try again at the next poll
+		pSyncHandle->BusErrors++;
+		return;
+	}
+
+	// 3. Edges up to here had the old phase, the next one is the first of epoch + 1
+	Timestamp_GetEdge(pConfig->pTsHandle, &edge, &stamp);
+	pSyncHandle->CommitEdge = edge;
+	pSyncHandle->CommitEpoch = epoch;
+	pSyncHandle->CommitDue = 0;
+	pSyncHandle->CommitPending = 1;
+}
+
+static int64_t TimeSync_Abs(int64_t Value)
+{
+	return (Value < 0) ? -Value : Value;
+}
+
+/*********************************************************************
+ * @fn      		  - TimeSync_Init
+ *
+ * @brief             - Starts the time sync client and enables the USART receive interrupt
+ *
+ * @param[in]         - time sync handle with TimeSync_Config filled in, timestamp service running
+ *
+ * @return            -  none
+ *
+ * @Note              -  the USART has to be initialised and enabled (USART_PeripheralControl)
+
+ *********************************************************************/
+void TimeSync_Init(TimeSync_Handle_t *pSyncHandle)
+{
+	TimeSync_Config_t config = pSyncHandle->TimeSync_Config;
+
+	memset(pSyncHandle, 0, sizeof(*pSyncHandle));
+	if(config.StepThresholdUs == 0)
+		config.StepThresholdUs = TIMESYNC_DEFAULT_STEP_US;
+	if(config.SlewPPM == 0)
+		config.SlewPPM = TIMESYNC_DEFAULT_SLEW_PPM;
+	if(config.MaxDelayUs == 0)
+		config.MaxDelayUs = TIMESYNC_DEFAULT_MAX_DELAY_US;
+	if(config.WriteLeadUs == 0)
+		config.WriteLeadUs = TIMESYNC_DEFAULT_WRITE_LEAD_US;
+	pSyncHandle->TimeSync_Config = config;
+
+	pSyncHandle->State = TIMESYNC_STATE_IDLE;
+	// first sync at the first poll
+	pSyncHandle->Countdown = (config.SyncPeriod != 0) ? 1 : 0;
+
+	config.pUSARTHandle->pUSARTx->CR1 |= (1 << USART_CR1_RXNEIE);
+	USART_IRQPriorityConfig(config.IRQNumber, config.IRQPriority);
+	USART_IRQInterruptConfig(config.IRQNumber, ENABLE);
+}
+
+/*********************************************************************
+ * @fn      		  - TimeSync_IRQHandling
+ *
+ * @brief             - Collects the received frame and latches the timer count at its end
+ *
+ * @param[in]         - time sync handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  call from the USART ISR. One frame is buffered, frames arriving before
+ * 						 TimeSync_Poll() took it are dropped and counted in Overruns
+
+ *********************************************************************/
+__RAMFUNC void TimeSync_IRQHandling(TimeSync_Handle_t *pSyncHandle)
+{
+	// first thing, T4 is the timer count at the delimiter
+	uint32_t count = Timestamp_GetCount(pSyncHandle->TimeSync_Config.pTsHandle);
+	USART_RegDef_t *pUSARTx = pSyncHandle->TimeSync_Config.pUSARTHandle->pUSARTx;
+	uint32_t sr = pUSARTx->SR;
+	uint8_t byte;
+
+	if(!(sr & ((1 << USART_SR_RXNE) | (1 << USART_SR_ORE))))
+		return;
+
+	// reading DR after SR clears RXNE and ORE
+	byte = (uint8_t)pUSARTx->DR;
+	if(sr & (1 << USART_SR_ORE))
+		pSyncHandle->RxDiscard = 1;
+
+	if(byte != 0x00)
+	{
+		if(pSyncHandle->RxReady || (pSyncHandle->RxLen >= TIMESYNC_MAX_FRAME))
+			pSyncHandle->RxDiscard = 1;
+		else if(!pSyncHandle->RxDiscard)
+			pSyncHandle->RxBuf[pSyncHandle->RxLen++] = byte;
+		return;
+	}
+
+	if(pSyncHandle->RxDiscard)
+	{
+		pSyncHandle->Overruns++;
+		pSyncHandle->RxDiscard = 0;
+		if(!pSyncHandle->RxReady)
+			pSyncHandle->RxLen = 0;
+	}
+	else if(pSyncHandle->RxReady)
+	{
+		pSyncHandle->Overruns++;
+	}
+	else if(pSyncHandle->RxLen != 0)
+	{
+		pSyncHandle->RxEndCount = count;
+		pSyncHandle->RxReady = 1;
+	}
+}
+
+/*********************************************************************
+ * @fn      		  - TimeSync_Start
+ *
+ * @brief             - Starts a sync at the next poll
+ *
+ * @param[in]         - time sync handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  a burst already running is finished first
+
+ *********************************************************************/
+void TimeSync_Start(TimeSync_Handle_t *pSyncHandle)
+{
+	if(pSyncHandle->State == TIMESYNC_STATE_IDLE)
+		pSyncHandle->Countdown = 1;
+}
+
+/*********************************************************************
+ * @fn      		  - TimeSync_Poll
+ *
+ * @brief             - Runs the exchanges, the end of a slew and the RTC write
+ *
+ * @param[in]         - time sync handle
+ *
+ * @return            -  bit mask of @TIMESYNC_EVENT
+ *
+ * @Note              -  right after an SQW edge (scheduler task). An RTC write busy waits for the
+ * 						 second boundary, up to one second. On TIMESYNC_EV_COMMITTED resync whatever
+ * 						 counts RTC seconds (Alarm_Resync, DualClock_Resync)
+
+ *********************************************************************/
+uint8_t TimeSync_Poll(TimeSync_Handle_t *pSyncHandle)
+{
+	TimeSync_Config_t *pConfig = &pSyncHandle->TimeSync_Config;
+	uint32_t edge, stamp;
+	uint8_t events = 0;
+
+	// 1. First edge after the RTC write, the timestamp service takes over the correction
+	if(pSyncHandle->CommitPending)
+	{
+		Timestamp_GetEdge(pConfig->pTsHandle, &edge, &stamp);
+		if(edge == pSyncHandle->CommitEdge)
+			return 0;
+
+		Timestamp_Sync(pConfig->pTsHandle, pSyncHandle->CommitEpoch + (edge - pSyncHandle->CommitEdge));
+		pSyncHandle->CorrUs = 0;
+		pSyncHandle->CommitPending = 0;
+		events |= TIMESYNC_EV_COMMITTED;
+	}
+
+	// 2. Slew done, the correction is complete
+	if(pSyncHandle->Slewing &&
+	   (TimeSync_SlewedUs(pSyncHandle, TimeSync_BaseUs(pSyncHandle)) == pSyncHandle->SlewUs))
+	{
+		pSyncHandle->CorrUs += pSyncHandle->SlewUs;
+		pSyncHandle->Slewing = 0;
+		pSyncHandle->CommitDue = (TimeSync_Abs(pSyncHandle->CorrUs) >= TIMESYNC_COMMIT_MIN_US);
+	}
+
+	// 3. Exchanges, a reply has to be taken even when nothing waits for it
+	if(pSyncHandle->RxReady)
+		events |= TimeSync_HandleReply(pSyncHandle);
+
+	if(pSyncHandle->State == TIMESYNC_STATE_WAIT_REPLY)
+	{
+		if(--pSyncHandle->Timer != 0)
+			return events;
+
+		pSyncHandle->Timeouts++;
+		events |= TimeSync_EndExchange(pSyncHandle);
+	}
+
+	// 4. RTC write between bursts, an exchange across it would see the edge phase move
+	if(pSyncHandle->State == TIMESYNC_STATE_IDLE)
+	{
+		if(pSyncHandle->CommitDue && !(events & TIMESYNC_EV_COMMITTED))
+		{
+			TimeSync_Commit(pSyncHandle);
+			return events;
+		}
+
+		if((pSyncHandle->Countdown == 0) || (--pSyncHandle->Countdown != 0) || pSyncHandle->CommitPending)
+			return events;
+
+		pSyncHandle->Exchanges = 0;
+		pSyncHandle->Samples = 0;
+		pSyncHandle->BestDelayUs = INT64_MAX;
+		pSyncHandle->State = TIMESYNC_STATE_SEND;
+	}
+
+	if(pSyncHandle->State == TIMESYNC_STATE_SEND)
+		TimeSync_SendRequest(pSyncHandle);
+
+	return events;
+}
+
+/*********************************************************************
+ * @fn      		  - TimeSync_Get
+ *
+ * @brief             - Reads the software clock
+ *
+ * @param[in]         - time sync handle
+ * @param[out]        - timestamp
+ *
+ * @return            -  none
+ *
+ * @Note              -  never smaller than the value returned before. Thread context
+
+ *********************************************************************/
+void TimeSync_Get(TimeSync_Handle_t *pSyncHandle, Timestamp_t *pStamp)
+{
+	int64_t now = TimeSync_SoftUs(pSyncHandle, TimeSync_BaseUs(pSyncHandle));
+
+	if(now < pSyncHandle->LastUs)
+		now = pSyncHandle->LastUs;
+	pSyncHandle->LastUs = now;
+
+	pStamp->Seconds = (uint32_t)(now / TIMESYNC_US_PER_SECOND);
+	pStamp->Micros = (uint32_t)(now % TIMESYNC_US_PER_SECOND);
+}
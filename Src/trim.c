@@ -0,0 +1,244 @@
+/*
+ * trim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "trim.h"
+#include <string.h>
+
+#define TRIM_NS_PER_SECOND				1000000000LL
+#define TRIM_WEIGHT_ONE					256			/* Weight of a point, Q8 */
+
+static void Trim_AddPoint(Trim_Handle_t *pTrimHandle);
+static uint8_t Trim_Step(Trim_Handle_t *pTrimHandle, int8_t Seconds);
+static int32_t Trim_Abs(int32_t Value);
+
+/*
+ * Helper functions
+ */
+static void Trim_AddPoint(Trim_Handle_t *pTrimHandle)
+{
+	uint32_t referenceHz = pTrimHandle->Trim_Config.ReferenceHz;
+	int64_t ex, ey, w;
+	int32_t prevPPB = pTrimHandle->FitPPB;
+
+	// 1. Move the origin to the new point, the means become relative to it
+	pTrimHandle->MeanX -= pTrimHandle->X << 8;
+	pTrimHandle->MeanY -= pTrimHandle->Y << 8;
+	pTrimHandle->X = 0;
+	pTrimHandle->Y = 0;
+
+	// 2. Forget
+	pTrimHandle->SumW -= pTrimHandle->SumW >> TRIM_FORGET_SHIFT;
+	pTrimHandle->Cxx -= pTrimHandle->Cxx >> TRIM_FORGET_SHIFT;
+	pTrimHandle->Cxy -= pTrimHandle->Cxy >> TRIM_FORGET_SHIFT;
+
+	// 3. Add (0, 0), weighted incremental update of the means and the centered sums
+	ex = -pTrimHandle->MeanX;
+	ey = -pTrimHandle->MeanY;
+	w = pTrimHandle->SumW;
+	pTrimHandle->SumW += TRIM_WEIGHT_ONE;
+	pTrimHandle->MeanX += (ex * TRIM_WEIGHT_ONE) / pTrimHandle->SumW;
+	pTrimHandle->MeanY += (ey * TRIM_WEIGHT_ONE) / pTrimHandle->SumW;
+	pTrimHandle->Cxx += ((ex * ex) >> 16) * w / pTrimHandle->SumW;
+	pTrimHandle->Cxy += ((ex * ey) >> 16) * w / pTrimHandle->SumW;
+	pTrimHandle->Points++;
+
+	if((pTrimHandle->Points < 2) || (pTrimHandle->Cxx <= 0))
+		return;
+
+	// 4. Slope in ticks per RTC second. A long RTC second (positive slope) is a slow RTC
+	pTrimHandle->SlopeQ8 = (pTrimHandle->Cxy << 8) / pTrimHandle->Cxx;
+	pTrimHandle->FitPPB = (int32_t)(-(pTrimHandle->SlopeQ8 * TRIM_NS_PER_SECOND) /
+									(((int64_t)referenceHz << 8) + pTrimHandle->SlopeQ8));
+
+	if(Trim_Abs(pTrimHandle->FitPPB) > TRIM_MAX_PPB)
+		return;
+
+	if((pTrimHandle->Points >= TRIM_MIN_POINTS) && (Trim_Abs(pTrimHandle->FitPPB - prevPPB) <= TRIM_STABLE_PPB))
+		pTrimHandle->Converged = 1;
+
+	if(pTrimHandle->Converged)
+		pTrimHandle->DriftPPB = pTrimHandle->FitPPB;
+}
+
+static uint8_t Trim_Step(Trim_Handle_t *pTrimHandle, int8_t Seconds)
+{
+	RTC_Handle_t *pRTCHandle = pTrimHandle->Trim_Config.pRTCHandle;
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	uint8_t timeFormat;
+	uint8_t ret;
+
+	ret = RTC_GetDateTime(pRTCHandle, &time, &date);
+	if(ret != RTC_OK)
+		return ret;
+
+	// keep the format the RTC runs in
+	timeFormat = time.timeFormat;
+	RTC_fromEpoch(RTC_toEpoch(&time, &date) + Seconds, &time, &date);
+	RTC_From24Hours(&time, timeFormat);
+
+	return RTC_SetDateTime(pRTCHandle, &time, &date);
+}
+
+static int32_t Trim_Abs(int32_t Value)
+{
+	return (Value < 0) ? -Value : Value;
+}
+
+/*********************************************************************
+ * @fn      		  - Trim_Init
+ *
+ * @brief             - Starts the drift measurement and the correction
+ *
+ * @param[in]         - trim handle with Trim_Config filled in, timestamp service running
+ *
+ * @return            -  none
+ *
+ * @Note              -  InitialPPB is applied from here on
+
+ *********************************************************************/
+void Trim_Init(Trim_Handle_t *pTrimHandle)
+{
+	Trim_Config_t config = pTrimHandle->Trim_Config;
+
+	memset(pTrimHandle, 0, sizeof(*pTrimHandle));
+	if(config.WindowSeconds == 0)
+		config.WindowSeconds = TRIM_DEFAULT_WINDOW;
+	pTrimHandle->Trim_Config = config;
+
+	pTrimHandle->DriftPPB = config.InitialPPB;
+
+	// the edge state may still be the one of Timestamp_Init, not a real edge
+	Timestamp_GetEdge(config.pTsHandle, &pTrimHandle->LastEdge, &pTrimHandle->LastStamp);
+	pTrimHandle->Bridge = 1;
+}
+
+/*********************************************************************
+ * @fn      		  - Trim_Poll
+ *
+ * @brief             - Measures the edges since the last call and steps the RTC when due
+ *
+ * @param[in]         - trim handle
+ *
+ * @return            -  seconds the RTC time was moved by, -1, 0 or 1
+ *
+ * @Note              -  right after an SQW edge (scheduler task). Resync whatever counts RTC
+ * 						 seconds when the return value is not 0
+
+ *********************************************************************/
+int8_t Trim_Poll(Trim_Handle_t *pTrimHandle)
+{
+	Trim_Config_t *pConfig = &pTrimHandle->Trim_Config;
+	uint32_t edge, stamp, edges, ticks;
+	int64_t nominal, dev;
+	int8_t step = 0;
+
+	Timestamp_GetEdge(pConfig->pTsHandle, &edge, &stamp);
+	edges = edge - pTrimHandle->LastEdge;
+	if(edges == 0)
+		return 0;
+
+	ticks = stamp - pTrimHandle->LastStamp;
+	pTrimHandle->LastEdge = edge;
+	pTrimHandle->LastStamp = stamp;
+
+	// 1. Measure, an interval far off the nominal length is bridged with the fitted slope
+	if(pConfig->Measure == ENABLE)
+	{
+		nominal = (int64_t)edges * pConfig->ReferenceHz;
+		dev = (int64_t)ticks - nominal;
+		if(pTrimHandle->Bridge || (dev > nominal / TRIM_TOLERANCE_DIV) || (-dev > nominal / TRIM_TOLERANCE_DIV))
+		{
+			dev = ((int64_t)edges * pTrimHandle->SlopeQ8) >> 8;
+			pTrimHandle->Bridge = 0;
+			pTrimHandle->Bridged++;
+		}
+
+		pTrimHandle->X += edges;
+		pTrimHandle->Y += dev;
+		if(pTrimHandle->X >= pConfig->WindowSeconds)
+			Trim_AddPoint(pTrimHandle);
+	}
+
+	// 2. Correct, one second at a time
+	pTrimHandle->AheadNs += (int64_t)pTrimHandle->DriftPPB * edges;
+	if(pTrimHandle->AheadNs >= TRIM_STEP_THRESHOLD_NS)
+		step = -1;
+	else if(pTrimHandle->AheadNs <= -TRIM_STEP_THRESHOLD_NS)
+		step = 1;
+
+	if(step != 0)
+	{
+		if(Trim_Step(pTrimHandle, step) != RTC_OK)
+		{
+			// try again after the next edge
+			pTrimHandle->BusErrors++;
+			return 0;
+		}
+
+		pTrimHandle->AheadNs += step * TRIM_NS_PER_SECOND;
+		pTrimHandle->Steps++;
+		// the write restarted the RTC divider, the next interval is off by the write latency
+		pTrimHandle->Bridge = 1;
+	}
+
+	return step;
+}
+
+/*********************************************************************
+ * @fn      		  - Trim_NotifyTimeSet
+ *
+ * @brief             - Tells the trim engine the RTC time was set from a reference
+ *
+ * @param[in]         - trim handle
+ *
+ * @return            -  none
+ *
+ * @Note              -  right after the first edge of the new time. The error counted so far was
+ * 						 corrected by the write, the fit itself is kept
+
+ *********************************************************************/
+void Trim_NotifyTimeSet(Trim_Handle_t *pTrimHandle)
+{
+	pTrimHandle->AheadNs = 0;
+	// the write moved the edge phase
+	pTrimHandle->Bridge = 1;
+}
+
+/*********************************************************************
+ * @fn      		  - Trim_GetDriftPPB
+ *
+ * @brief             - Returns the drift being applied
+ *
+ * @param[in]         - trim handle
+ *
+ * @return            -  parts per billion, positive if the RTC runs fast
+ *
+ * @Note              -  InitialPPB until the fit converged
+
+ *********************************************************************/
+int32_t Trim_GetDriftPPB(Trim_Handle_t *pTrimHandle)
+{
+	return pTrimHandle->DriftPPB;
+}
+
+/*********************************************************************
+ * @fn      		  - Trim_IsConverged
+ *
+ * @brief             - Tells if the fitted drift is applied
+ *
+ * @param[in]         - trim handle
+ *
+ * @return            -  1 if converged, 0 otherwise
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+uint8_t Trim_IsConverged(Trim_Handle_t *pTrimHandle)
+{
+	return pTrimHandle->Converged;
+}
@@ -0,0 +1,544 @@
+/*
+ * xprintf.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "xprintf.h"
+#include "ringbuf.h"
+
+#define XPRINTF_FLAG_LEFT				(1 << 0)
+#define XPRINTF_FLAG_ZERO				(1 << 1)
+#define XPRINTF_FLAG_PLUS				(1 << 2)
+#define XPRINTF_FLAG_SPACE				(1 << 3)
+#define XPRINTF_FLAG_ALT				(1 << 4)
+#define XPRINTF_FLAG_UPPER				(1 << 5)
+
+#define XPRINTF_LEN_INT					0
+#define XPRINTF_LEN_CHAR				1
+#define XPRINTF_LEN_SHORT				2
+#define XPRINTF_LEN_LONG				3
+#define XPRINTF_LEN_LLONG				4
+#define XPRINTF_LEN_SIZE				5
+
+void ITM_SendChar(uint8_t ch);
+
+/*
+ * Output state of one call, on the caller's stack
+ */
+typedef struct
+{
+	XPrintf_Sink_t		pfnSink;
+	void				*pSinkCtx;
+	char				Chunk[XPRINTF_CHUNK];
+	uint32_t			ChunkLen;
+	int					Count;
+}XPrintf_Out_t;
+
+/*
+ * Buffer sink state of XPrintf_Buffer
+ */
+typedef struct
+{
+	char				*pBuf;
+	uint32_t			Size;
+	uint32_t			Len;
+}XPrintf_Buffer_t;
+
+static XPrintf_Sink_t sinkFn = XPrintf_SinkITM;
+static void *sinkCtx;
+
+static void XPrintf_Flush(XPrintf_Out_t *pOut);
+static void XPrintf_Putc(XPrintf_Out_t *pOut, char c);
+static void XPrintf_Pad(XPrintf_Out_t *pOut, char c, int Count);
+static void XPrintf_PutString(XPrintf_Out_t *pOut, const char *pStr, int Precision, int Width, uint8_t Flags);
+static void XPrintf_PutNumber(XPrintf_Out_t *pOut, uint64_t Value, uint8_t Negative, uint8_t Base,
+							  int Precision, int Width, uint8_t Flags);
+static void XPrintf_SinkBuffer(void *pCtx, const char *pData, uint32_t Len);
+
+/*
+ * Helper functions
+ */
+static void XPrintf_Flush(XPrintf_Out_t *pOut)
+{
+	if(pOut->ChunkLen && pOut->pfnSink)
+		pOut->pfnSink(pOut->pSinkCtx, pOut->Chunk, pOut->ChunkLen);
+	pOut->ChunkLen = 0;
+}
+
+static void XPrintf_Putc(XPrintf_Out_t *pOut, char c)
+{
+	pOut->Chunk[pOut->ChunkLen++] = c;
+	pOut->Count++;
+	if(pOut->ChunkLen == XPRINTF_CHUNK)
+		XPrintf_Flush(pOut);
+}
+
+static void XPrintf_Pad(XPrintf_Out_t *pOut, char c, int Count)
+{
+	while(Count-- > 0)
+		XPrintf_Putc(pOut, c);
+}
+
+static void XPrintf_PutString(XPrintf_Out_t *pOut, const char *pStr, int Precision, int Width, uint8_t Flags)
+{
+	int len = 0;
+
+	if(pStr == NULL)
+		pStr = "(null)";
+
+	// precision limits the characters read, the string need not be terminated then
+	while(((Precision < 0) || (len < Precision)) && pStr[len])
+		len++;
+
+	if(!(Flags & XPRINTF_FLAG_LEFT))
+		XPrintf_Pad(pOut, ' ', Width - len);
+	for(int i = 0; i < len; i++)
+		XPrintf_Putc(pOut, pStr[i]);
+	if(Flags & XPRINTF_FLAG_LEFT)
+		XPrintf_Pad(pOut, ' ', Width - len);
+}
+
+static void XPrintf_PutNumber(XPrintf_Out_t *pOut, uint64_t Value, uint8_t Negative, uint8_t Base,
+							  int Precision, int Width, uint8_t Flags)
+{
+	const char *pDigits = (Flags & XPRINTF_FLAG_UPPER) ? "0123456789ABCDEF" : "0123456789abcdef";
+	char digits[24];
+	char prefix[3];
+	int noOfDigits = 0, prefixLen = 0, zeros, pad;
+
+	// 1. Digits, least significant first. The 64 bit division only for values which need it
+	if(Value >> 32)
+	{
+		while(Value >> 32)
+		{
+			digits[noOfDigits++] = pDigits[Value % Base];
+			Value /= Base;
+		}
+	}
+	for(uint32_t value32 = (uint32_t)Value; value32 != 0; value32 /= Base)
+		digits[noOfDigits++] = pDigits[value32 % Base];
+
+	// a precision of 0 prints nothing for 0, otherwise 0 is one digit
+	if((noOfDigits == 0) && (Precision != 0))
+		digits[noOfDigits++] = '0';
+
+	// 2. Sign and base prefix
+	if(Negative)
+		prefix[prefixLen++] = '-';
+	else if(Flags & XPRINTF_FLAG_PLUS)
+		prefix[prefixLen++] = '+';
+	else if(Flags & XPRINTF_FLAG_SPACE)
+		prefix[prefixLen++] = ' ';
+
+	if((Flags & XPRINTF_FLAG_ALT) && (Base == 16) && (noOfDigits != 0) && (digits[noOfDigits - 1] != '0'))
+	{
+		prefix[prefixLen++] = '0';
+		prefix[prefixLen++] = (Flags & XPRINTF_FLAG_UPPER) ? 'X' : 'x';
+	}
+	else if((Flags & XPRINTF_FLAG_ALT) && (Base == 8) && (Precision <= noOfDigits) &&
+			((noOfDigits == 0) || (digits[noOfDigits - 1] != '0')))
+	{
+		prefix[prefixLen++] = '0';
+	}
+
+	// 3. Leading zeros from the precision, or from the width with the 0 flag
+	zeros = (Precision > noOfDigits) ? Precision - noOfDigits : 0;
+	pad = Width - prefixLen - zeros - noOfDigits;
+	if((Flags & XPRINTF_FLAG_ZERO) && !(Flags & XPRINTF_FLAG_LEFT) && (Precision < 0) && (pad > 0))
+	{
+		zeros += pad;
+		pad = 0;
+	}
+
+	if(!(Flags & XPRINTF_FLAG_LEFT))
+		XPrintf_Pad(pOut, ' ', pad);
+	for(int i = 0; i < prefixLen; i++)
+		XPrintf_Putc(pOut, prefix[i]);
+	XPrintf_Pad(pOut, '0', zeros);
+	while(noOfDigits)
+		XPrintf_Putc(pOut, digits[--noOfDigits]);
+	if(Flags & XPRINTF_FLAG_LEFT)
+		XPrintf_Pad(pOut, ' ', pad);
+}
+
+static void XPrintf_SinkBuffer(void *pCtx, const char *pData, uint32_t Len)
+{
+	XPrintf_Buffer_t *pBuffer = (XPrintf_Buffer_t*)pCtx;
+
+	// one byte stays free for the terminator, the rest is counted but dropped
+	while(Len--)
+	{
+		if(pBuffer->Len + 1 < pBuffer->Size)
+			pBuffer->pBuf[pBuffer->Len++] = *pData;
+		pData++;
+	}
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_SetSink
+ *
+ * @brief             - Selects where XPrintf() and XPrintf_Write() output goes
+ *
+ * @param[in]         - sink, NULL discards the output
+ * @param[in]         - sink context
+ *
+ * @return            -  none
+ *
+ * @Note              -  XPrintf_SinkITM until set
+
+ *********************************************************************/
+void XPrintf_SetSink(XPrintf_Sink_t pfnSink, void *pSinkCtx)
+{
+	sinkFn = pfnSink;
+	sinkCtx = pSinkCtx;
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf
+ *
+ * @brief             - Formats to the default sink
+ *
+ * @param[in]         - printf format
+ * @param[in]         - arguments
+ *
+ * @return            -  number of characters
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+int XPrintf(const char *pFmt, ...)
+{
+	va_list args;
+	int count;
+
+	va_start(args, pFmt);
+	count = XPrintf_VFormat(sinkFn, sinkCtx, pFmt, args);
+	va_end(args);
+
+	return count;
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_Write
+ *
+ * @brief             - Sends raw text to the default sink
+ *
+ * @param[in]         - text
+ * @param[in]         - length
+ *
+ * @return            -  length
+ *
+ * @Note              -  the _write syscall
+
+ *********************************************************************/
+int XPrintf_Write(const char *pData, uint32_t Len)
+{
+	if(sinkFn)
+		sinkFn(sinkCtx, pData, Len);
+
+	return (int)Len;
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_To
+ *
+ * @brief             - Formats to the given sink
+ *
+ * @param[in]         - sink
+ * @param[in]         - sink context
+ * @param[in]         - printf format
+ * @param[in]         - arguments
+ *
+ * @return            -  number of characters
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+int XPrintf_To(XPrintf_Sink_t pfnSink, void *pSinkCtx, const char *pFmt, ...)
+{
+	va_list args;
+	int count;
+
+	va_start(args, pFmt);
+	count = XPrintf_VFormat(pfnSink, pSinkCtx, pFmt, args);
+	va_end(args);
+
+	return count;
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_VFormat
+ *
+ * @brief             - The format engine
+ *
+ * @param[in]         - sink
+ * @param[in]         - sink context
+ * @param[in]         - printf format
+ * @param[in]         - arguments
+ *
+ * @return            -  number of characters
+ *
+ * @Note              -  see the notes in xprintf.h for the supported conversions
+
+ *********************************************************************/
+int XPrintf_VFormat(XPrintf_Sink_t pfnSink, void *pSinkCtx, const char *pFmt, va_list Args)
+{
+	XPrintf_Out_t out;
+	uint8_t flags, length, base;
+	int width, precision;
+	uint64_t value;
+	int64_t sValue;
+	char c;
+
+	out.pfnSink = pfnSink;
+	out.pSinkCtx = pSinkCtx;
+	out.ChunkLen = 0;
+	out.Count = 0;
+
+	while((c = *pFmt++) != '\0')
+	{
+		if(c != '%')
+		{
+			XPrintf_Putc(&out, c);
+			continue;
+		}
+
+		// 1. Flags
+		flags = 0;
+		for(;; pFmt++)
+		{
+			if(*pFmt == '-')		flags |= XPRINTF_FLAG_LEFT;
+			else if(*pFmt == '0')	flags |= XPRINTF_FLAG_ZERO;
+			else if(*pFmt == '+')	flags |= XPRINTF_FLAG_PLUS;
+			else if(*pFmt == ' ')	flags |= XPRINTF_FLAG_SPACE;
+			else if(*pFmt == '#')	flags |= XPRINTF_FLAG_ALT;
+			else					break;
+		}
+
+		// 2. Width and precision, a negative * width is the - flag
+		width = 0;
+		if(*pFmt == '*')
+		{
+			width = va_arg(Args, int);
+			if(width < 0)
+			{
+				flags |= XPRINTF_FLAG_LEFT;
+				width = -width;
+			}
+			pFmt++;
+		}
+		while((*pFmt >= '0') && (*pFmt <= '9'))
+			width = width * 10 + (*pFmt++ - '0');
+
+		precision = -1;
+		if(*pFmt == '.')
+		{
+			pFmt++;
+			precision = 0;
+			if(*pFmt == '*')
+			{
+				precision = va_arg(Args, int);
+				pFmt++;
+			}
+			while((*pFmt >= '0') && (*pFmt <= '9'))
+				precision = precision * 10 + (*pFmt++ - '0');
+		}
+
+		// 3. Length
+		length = XPRINTF_LEN_INT;
+		if(*pFmt == 'h')
+		{
+			length = XPRINTF_LEN_SHORT;
+			if(*++pFmt == 'h')
+			{
+				length = XPRINTF_LEN_CHAR;
+				pFmt++;
+			}
+		}
+		else if(*pFmt == 'l')
+		{
+			length = XPRINTF_LEN_LONG;
+			if(*++pFmt == 'l')
+			{
+				length = XPRINTF_LEN_LLONG;
+				pFmt++;
+			}
+		}
+		else if(*pFmt == 'z')
+		{
+			length = XPRINTF_LEN_SIZE;
+			pFmt++;
+		}
+
+		// 4. Conversion
+		c = *pFmt++;
+		base = 10;
+		switch(c)
+		{
+		case 'd':
+		case 'i':
+			switch(length)
+			{
+			case XPRINTF_LEN_CHAR:	sValue = (signed char)va_arg(Args, int);	break;
+			case XPRINTF_LEN_SHORT:	sValue = (short)va_arg(Args, int);			break;
+			case XPRINTF_LEN_LONG:	sValue = va_arg(Args, long);				break;
+			case XPRINTF_LEN_LLONG:	sValue = va_arg(Args, long long);			break;
+			case XPRINTF_LEN_SIZE:	sValue = (int64_t)va_arg(Args, size_t);		break;
+			default:				sValue = va_arg(Args, int);					break;
+			}
+			// negate unsigned, the most negative value has no positive counterpart
+			value = (sValue < 0) ? (0 - (uint64_t)sValue) : (uint64_t)sValue;
+			XPrintf_PutNumber(&out, value, (sValue < 0), 10, precision, width, flags);
+			break;
+
+		case 'X':
+			flags |= XPRINTF_FLAG_UPPER;
+			/* fall through */
+		case 'x':
+			base = 16;
+			/* fall through */
+		case 'o':
+			if(c == 'o')
+				base = 8;
+			/* fall through */
+		case 'u':
+			switch(length)
+			{
+			case XPRINTF_LEN_CHAR:	value = (unsigned char)va_arg(Args, unsigned int);	break;
+			case XPRINTF_LEN_SHORT:	value = (unsigned short)va_arg(Args, unsigned int);	break;
+			case XPRINTF_LEN_LONG:	value = va_arg(Args, unsigned long);				break;
+			case XPRINTF_LEN_LLONG:	value = va_arg(Args, unsigned long long);			break;
+			case XPRINTF_LEN_SIZE:	value = va_arg(Args, size_t);						break;
+			default:				value = va_arg(Args, unsigned int);					break;
+			}
+			XPrintf_PutNumber(&out, value, 0, base, precision, width, flags & ~(XPRINTF_FLAG_PLUS | XPRINTF_FLAG_SPACE));
+			break;
+
+		case 'p':
+			value = (uintptr_t)va_arg(Args, void*);
+			XPrintf_PutNumber(&out, value, 0, 16, precision, width, XPRINTF_FLAG_ALT | (flags & XPRINTF_FLAG_LEFT));
+			break;
+
+		case 'c':
+			if(!(flags & XPRINTF_FLAG_LEFT))
+				XPrintf_Pad(&out, ' ', width - 1);
+			XPrintf_Putc(&out, (char)va_arg(Args, int));
+			if(flags & XPRINTF_FLAG_LEFT)
+				XPrintf_Pad(&out, ' ', width - 1);
+			break;
+
+		case 's':
+			XPrintf_PutString(&out, va_arg(Args, const char*), precision, width, flags);
+			break;
+
+		case '%':
+			XPrintf_Putc(&out, '%');
+			break;
+
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			// no floating point, the argument is skipped so the rest still lines up
+			(void)va_arg(Args, double);
+			XPrintf_Putc(&out, '?');
+			break;
+
+		case '\0':
+			// format ends inside a conversion
+			pFmt--;
+			break;
+
+		default:
+			XPrintf_Putc(&out, '%');
+			XPrintf_Putc(&out, c);
+			break;
+		}
+	}
+
+	XPrintf_Flush(&out);
+
+	return out.Count;
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_Buffer
+ *
+ * @brief             - Formats into memory
+ *
+ * @param[out]        - buffer
+ * @param[in]         - buffer size, including the terminator
+ * @param[in]         - printf format
+ * @param[in]         - arguments
+ *
+ * @return            -  length of the full text, the buffer holds at most Size - 1 of it
+ *
+ * @Note              -  always terminated when Size is not 0, as snprintf
+
+ *********************************************************************/
+int XPrintf_Buffer(char *pBuf, uint32_t Size, const char *pFmt, ...)
+{
+	XPrintf_Buffer_t buffer;
+	va_list args;
+	int count;
+
+	buffer.pBuf = pBuf;
+	buffer.Size = Size;
+	buffer.Len = 0;
+
+	va_start(args, pFmt);
+	count = XPrintf_VFormat(XPrintf_SinkBuffer, &buffer, pFmt, args);
+	va_end(args);
+
+	if(Size)
+		pBuf[buffer.Len] = '\0';
+
+	return count;
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_SinkITM
+ *
+ * @brief             - Sends the text over ITM stimulus port 0
+ *
+ * @param[in]         - unused
+ * @param[in]         - text
+ * @param[in]         - length
+ *
+ * @return            -  none
+ *
+ * @Note              -  none
+
+ *********************************************************************/
+void XPrintf_SinkITM(void *pCtx, const char *pData, uint32_t Len)
+{
+	(void)pCtx;
+
+	while(Len--)
+		ITM_SendChar((uint8_t)*pData++);
+}
+
+/*********************************************************************
+ * @fn      		  - XPrintf_SinkRingBuf
+ *
+ * @brief             - Queues the text in a ring buffer
+ *
+ * @param[in]         - RingBuf_t* with 1 byte elements
+ * @param[in]         - text
+ * @param[in]         - length
+ *
+ * @return            -  none
+ *
+ * @Note              -  never blocks, what does not fit is dropped
+
+ *********************************************************************/
+void XPrintf_SinkRingBuf(void *pCtx, const char *pData, uint32_t Len)
+{
+	RingBuf_Put((RingBuf_t*)pCtx, pData, Len);
+}
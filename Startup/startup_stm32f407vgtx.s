@@ -41,6 +41,19 @@ defined in linker script */
 .word _sbss
 /* end address for the .bss section. defined in linker script */
 .word _ebss
+/* start address for the initialization values of the .ccmram section.
+defined in linker script */
+.word _siccmram
+/* start address for the .ccmram section. defined in linker script */
+.word _sccmram
+/* end address for the .ccmram section. defined in linker script */
+.word _eccmram
+/* start address for the .ccmbss section. defined in linker script */
+.word _sccmbss
+/* end address for the .ccmbss section. defined in linker script */
+.word _eccmbss
+/* lowest address of the stack. defined in linker script */
+.word _sstack
 
 /**
  * @brief  This is the code that gets called when the processor first
@@ -57,6 +70,20 @@ defined in linker script */
 Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
+
+/* Paint the stack for the high-water scan (stackmon.c) */
+  ldr r2, =_sstack
+  ldr r3, =0xC5C5C5C5
+  b LoopPaintStack
+
+PaintStack:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopPaintStack:
+  cmp r2, r0
+  bcc PaintStack
+
 /* Call the clock system initialization function.*/
   bl  SystemInit
 
@@ -91,6 +118,37 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the ccmram segment initializers to CCM-RAM */
+  ldr r0, =_sccmram
+  ldr r1, =_eccmram
+  ldr r2, =_siccmram
+  movs r3, #0
+  b LoopCopyCcmInit
+
+CopyCcmInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyCcmInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyCcmInit
+
+/* Zero fill the ccmbss segment. */
+  ldr r2, =_sccmbss
+  ldr r4, =_eccmbss
+  movs r3, #0
+  b LoopFillZeroCcmbss
+
+FillZeroCcmbss:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroCcmbss:
+  cmp r2, r4
+  bcc FillZeroCcmbss
+
 /* Call static constructors */
   bl __libc_init_array
 /* Call the application's entry point.*/
@@ -154,7 +154,7 @@ void USART_SetBaudRate(USART_RegDef_t *pUSARTx, uint32_t BaudRate);
  */
 void USART_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi);
 void USART_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
-void USART_IRQHandling(USART_Handle_t *pHandle);
+__RAMFUNC void USART_IRQHandling(USART_Handle_t *pHandle);
 
 /*
  * Other Peripheral Control APIs
@@ -168,6 +168,6 @@ uint32_t RCC_GetPCLK2Value(void);
 /*
  * Application callback
  */
-void USART_ApplicationEventCallback(USART_Handle_t *pUSARTHandle,uint8_t AppEv);
+__RAMFUNC void USART_ApplicationEventCallback(USART_Handle_t *pUSARTHandle,uint8_t AppEv);
 
 #endif /* INC_STM32F407X_USART_H_ */
@@ -83,6 +83,92 @@
 
 #define NVIC_STIR						((__vo uint32_t*)0xE000EF00)
 
+/*
+ * ARM Cortex Mx Processor intrinsics (no-ops when the drivers are compiled for the host)
+ */
+#if defined(__arm__)
+#define __DISABLE_IRQ()					__asm volatile ("cpsid i" ::: "memory")
+#define __ENABLE_IRQ()					__asm volatile ("cpsie i" ::: "memory")
+#define __WFI()							__asm volatile ("dsb\n\twfi\n\tisb" ::: "memory")
+#define __GET_PRIMASK()					({ uint32_t __primask; __asm volatile ("mrs %0, primask" : "=r" (__primask)); __primask; })
+#define __SET_PRIMASK(x)				__asm volatile ("msr primask, %0" :: "r" (x) : "memory")
+#define __DSB()							__asm volatile ("dsb" ::: "memory")
+#define __ISB()							__asm volatile ("isb" ::: "memory")
+#else
+#define __DISABLE_IRQ()					do{}while(0)
+#define __ENABLE_IRQ()					do{}while(0)
+#define __WFI()							do{}while(0)
+#define __GET_PRIMASK()					(0UL)
+#define __SET_PRIMASK(x)				((void)(x))
+#define __DSB()							do{}while(0)
+#define __ISB()							do{}while(0)
+#endif
+
+/*
+ * Memory placement (see the linker script)
+ * 	__CCMRAM		initialized data in CCM RAM, copied from flash by the startup code
+ * 	__CCMRAM_BSS	zero initialized data in CCM RAM. Stacks, scheduler, statistics, CPU only buffers
+ * 	__DMA_RAM		buffers read or written by a DMA stream. Placed first in .bss, the link fails if they leave SRAM1
+ */
+#define __CCMRAM						__attribute__((section(".ccmram")))
+#define __CCMRAM_BSS					__attribute__((section(".bss.ccmram")))
+#define __DMA_RAM						__attribute__((section(".bss.dmaram")))
+
+#define IS_DMA_ADDR(addr)				(((uintptr_t)(addr) - CCMRAM_BASEADDR) >= CCMRAM_SIZE)
+
+/*
+ * Execute from RAM
+ * 	__RAMFUNC places a function in .RamFunc. The linker script puts it in .data, so Reset_Handler copies
+ * 	it from flash to SRAM1 with the initialized data and it runs without flash wait states.
+ * 	CCM RAM is on the D-bus only and can not hold code. long_call lets flash code reach it without veneers,
+ * 	so the attribute goes on the prototype in the header too, not only on the definition
+ * 	Everything an ISR path calls is tagged as well (driver helpers, Timestamp_Get, the application event
+ * 	callbacks through their prototypes). A call from RAM into flash would get a veneer and the flash wait
+ * 	states back. No libgcc or libc calls on these paths: Timestamp_Scale divides by shift and subtract,
+ * 	TimeServer_Latch copies with a loop. Application callback overrides must include the driver header
+ */
+#if defined(__arm__)
+#define __RAMFUNC						__attribute__((section(".RamFunc"), noinline, long_call))
+#else
+#define __RAMFUNC
+#endif
+
+/*
+ * ARM Cortex Mx Processor Memory Protection Unit (MPU) register addresses and bit positions
+ */
+#define MPU_CTRL						((__vo uint32_t*)0xE000ED94)
+#define MPU_RNR							((__vo uint32_t*)0xE000ED98)
+#define MPU_RBAR						((__vo uint32_t*)0xE000ED9C)
+#define MPU_RASR						((__vo uint32_t*)0xE000EDA0)
+
+#define MPU_NO_OF_REGIONS				8
+
+#define MPU_CTRL_ENABLE					0
+#define MPU_CTRL_HFNMIENA				1
+#define MPU_CTRL_PRIVDEFENA				2
+
+#define MPU_RASR_ENABLE					0
+#define MPU_RASR_SIZE					1				/* region size is 2^(SIZE+1) bytes */
+#define MPU_RASR_AP						24
+#define MPU_RASR_XN						28
+
+/*
+ * ARM Cortex Mx Processor System Control Register (SCR) details
+ */
+#define SCB_SCR							((__vo uint32_t*)0xE000ED10)
+#define SCB_SCR_SLEEPONEXIT				1
+#define SCB_SCR_SLEEPDEEP				2
+#define SCB_SCR_SEVONPEND				4
+
+/*
+ * ARM Cortex Mx Processor DWT cycle counter details
+ */
+#define CORE_DEMCR						((__vo uint32_t*)0xE000EDFC)
+#define CORE_DEMCR_TRCENA				24
+#define DWT_CTRL						((__vo uint32_t*)0xE0001000)
+#define DWT_CTRL_CYCCNTENA				0
+#define DWT_CYCCNT						((__vo uint32_t*)0xE0001004)
+
 /*
  * Define base addresses of Flash and SRAM memories
  */
@@ -93,6 +179,8 @@
 #define SRAM_SIZE						((128)*(1024))					/*Base address of the flash memory*/
 #define SRAM1_BASEADDR					SRAM_BASEADDR					/*Base address of the flash memory*/
 #define SRAM2_BASEADDR					0x2001C000UL					/*Base address of the flash memory*/
+#define CCMRAM_BASEADDR					0x10000000UL					/*Base address of the CCM RAM (core only, no DMA)*/
+#define CCMRAM_SIZE						(64 * 1024)
 #define ROM_BASEADDR					0x1FFF0000UL					/*Base address of the flash memory*/
 #define ROM_SIZE						((ROM_BASEADDR) + (30 * 1024))	/*Base address of the flash memory*/
 
@@ -365,109 +453,304 @@ typedef struct
 
 #define SYSCFG							((SYSCFG_RegDef_t*)SYSCFG_BASEADDR)
 
+/*
+ * PWR peripheral register structure
+ */
+typedef struct
+{
+	__vo uint32_t CR;							/*Power control register, address offset: 0x00*/
+	__vo uint32_t CSR;							/*Power control/status register, address offset: 0x04*/
+}PWR_RegDef_t;
+
+#define PWR								((PWR_RegDef_t*)PWR_BASEADDR)
+
+/*
+ * Flash interface register structure
+ */
+typedef struct
+{
+	__vo uint32_t ACR;							/*Access control register, address offset: 0x00*/
+	__vo uint32_t KEYR;							/*Key register, address offset: 0x04*/
+	__vo uint32_t OPTKEYR;						/*Option key register, address offset: 0x08*/
+	__vo uint32_t SR;							/*Status register, address offset: 0x0C*/
+	__vo uint32_t CR;							/*Control register, address offset: 0x10*/
+	__vo uint32_t OPTCR;						/*Option control register, address offset: 0x14*/
+}FLASH_RegDef_t;
+
+#define FLASH							((FLASH_RegDef_t*)FLASHINTERFACE_BASEADDR)
+
+/*
+ * General purpose timer (TIM2 to TIM5) register structure
+ */
+typedef struct
+{
+	__vo uint32_t CR1;							/*Control register 1, address offset: 0x00*/
+	__vo uint32_t CR2;							/*Control register 2, address offset: 0x04*/
+	__vo uint32_t SMCR;							/*Slave mode control register, address offset: 0x08*/
+	__vo uint32_t DIER;							/*DMA/interrupt enable register, address offset: 0x0C*/
+	__vo uint32_t SR;							/*Status register, address offset: 0x10*/
+	__vo uint32_t EGR;							/*Event generation register, address offset: 0x14*/
+	__vo uint32_t CCMR1;						/*Capture/compare mode register 1, address offset: 0x18*/
+	__vo uint32_t CCMR2;						/*Capture/compare mode register 2, address offset: 0x1C*/
+	__vo uint32_t CCER;							/*Capture/compare enable register, address offset: 0x20*/
+	__vo uint32_t CNT;							/*Counter, address offset: 0x24*/
+	__vo uint32_t PSC;							/*Prescaler, address offset: 0x28*/
+	__vo uint32_t ARR;							/*Auto-reload register, address offset: 0x2C*/
+	uint32_t RESERVED1;
+	__vo uint32_t CCR[4];						/*Capture/compare registers 1-4, address offset: 0x34*/
+	uint32_t RESERVED2;
+	__vo uint32_t DCR;							/*DMA control register, address offset: 0x48*/
+	__vo uint32_t DMAR;							/*DMA address for full transfer, address offset: 0x4C*/
+	__vo uint32_t OR;							/*Option register (TIM2, TIM5 only), address offset: 0x50*/
+}TIM_RegDef_t;
+
+#define TIM2							((TIM_RegDef_t*)TIM2_BASEADDR)
+#define TIM3							((TIM_RegDef_t*)TIM3_BASEADDR)
+#define TIM4							((TIM_RegDef_t*)TIM4_BASEADDR)
+#define TIM5							((TIM_RegDef_t*)TIM5_BASEADDR)
+
+/*
+ * CRC calculation unit register structure
+ */
+typedef struct
+{
+	__vo uint32_t DR;							/*Data register, address offset: 0x00*/
+	__vo uint32_t IDR;							/*Independent data register (8 bit), address offset: 0x04*/
+	__vo uint32_t CR;							/*Control register, address offset: 0x08*/
+}CRC_RegDef_t;
+
+#define CRC								((CRC_RegDef_t*)CRC_BASEADDR)
+
+/*
+ * DMA stream register structure
+ */
+typedef struct
+{
+	__vo uint32_t CR;							/*Stream configuration register, address offset: 0x10 + 0x18 * stream*/
+	__vo uint32_t NDTR;							/*Number of data register, address offset: 0x14 + 0x18 * stream*/
+	__vo uint32_t PAR;							/*Peripheral address register, address offset: 0x18 + 0x18 * stream*/
+	__vo uint32_t M0AR;							/*Memory 0 address register, address offset: 0x1C + 0x18 * stream*/
+	__vo uint32_t M1AR;							/*Memory 1 address register, address offset: 0x20 + 0x18 * stream*/
+	__vo uint32_t FCR;							/*FIFO control register, address offset: 0x24 + 0x18 * stream*/
+}DMA_Stream_RegDef_t;
+
+/*
+ * DMA controller register structure
+ */
+typedef struct
+{
+	__vo uint32_t LISR;							/*Low interrupt status register (streams 0-3), address offset: 0x00*/
+	__vo uint32_t HISR;							/*High interrupt status register (streams 4-7), address offset: 0x04*/
+	__vo uint32_t LIFCR;						/*Low interrupt flag clear register, address offset: 0x08*/
+	__vo uint32_t HIFCR;						/*High interrupt flag clear register, address offset: 0x0C*/
+	DMA_Stream_RegDef_t Stream[8];
+}DMA_RegDef_t;
+
+#define DMA1							((DMA_RegDef_t*)DMA1_BASEADDR)
+#define DMA2							((DMA_RegDef_t*)DMA2_BASEADDR)
+
+/*
+ * Internal RTC and backup register structure (IRTC, the RTC_ prefix belongs to the external RTC in BSP)
+ */
+typedef struct
+{
+	__vo uint32_t TR;							/*Time register, address offset: 0x00*/
+	__vo uint32_t DR;							/*Date register, address offset: 0x04*/
+	__vo uint32_t CR;							/*Control register, address offset: 0x08*/
+	__vo uint32_t ISR;							/*Initialization and status register, address offset: 0x0C*/
+	__vo uint32_t PRER;							/*Prescaler register, address offset: 0x10*/
+	__vo uint32_t WUTR;							/*Wakeup timer register, address offset: 0x14*/
+	__vo uint32_t CALIBR;						/*Coarse calibration register, address offset: 0x18*/
+	__vo uint32_t ALRMAR;						/*Alarm A register, address offset: 0x1C*/
+	__vo uint32_t ALRMBR;						/*Alarm B register, address offset: 0x20*/
+	__vo uint32_t WPR;							/*Write protection register, address offset: 0x24*/
+	__vo uint32_t SSR;							/*Sub second register, address offset: 0x28*/
+	__vo uint32_t SHIFTR;						/*Shift control register, address offset: 0x2C*/
+	__vo uint32_t TSTR;							/*Time stamp time register, address offset: 0x30*/
+	__vo uint32_t TSDR;							/*Time stamp date register, address offset: 0x34*/
+	__vo uint32_t TSSSR;						/*Time stamp sub second register, address offset: 0x38*/
+	__vo uint32_t CALR;							/*Smooth calibration register, address offset: 0x3C*/
+	__vo uint32_t TAFCR;						/*Tamper and alternate function register, address offset: 0x40*/
+	__vo uint32_t ALRMASSR;						/*Alarm A sub second register, address offset: 0x44*/
+	__vo uint32_t ALRMBSSR;						/*Alarm B sub second register, address offset: 0x48*/
+	uint32_t RESERVED1;
+	__vo uint32_t BKPR[20];						/*Backup registers 0-19, address offset: 0x50*/
+}IRTC_RegDef_t;
+
+#define IRTC							((IRTC_RegDef_t*)RTC_BKP_BASEADDR)
+
+/*
+ * Bit-band access to single bits of peripheral registers
+ * 	Every bit of the peripheral region (PERIPH_BASEADDR, 1 MB) has a word alias at
+ * 	BITBAND_PERIPH_BASEADDR + offset * 32 + bit * 4. A store to the alias changes that one bit in a
+ * 	single bus transaction, so thread and ISR code can change different bits of a shared control register
+ * 	(CR1 START vs ACK, CR2 interrupt enables, RCC enables) without masking interrupts. With a constant
+ * 	register and bit the alias is a constant too
+ * 	Not for rc_w0 status flags (I2C SR1, USART SR): the bus reads the word and writes the other flags back.
+ * 	Clear those with a plain store of the inverted mask, SR1 = ~(1 << flag)
+ * 	REG_TOGGLE_BIT reads the alias and stores its inverse: the store still changes only that bit, but
+ * 	two contexts toggling the same bit can race
+ * 	On the host the registers are plain memory and the macros map to atomic or / and / xor
+ */
+#define BITBAND_PERIPH_BASEADDR			0x42000000UL
+
+#if defined(__arm__)
+#define BITBAND_PERIPH(pReg, Bit)		((__vo uint32_t*)(BITBAND_PERIPH_BASEADDR + \
+											(((uint32_t)(pReg) - PERIPH_BASEADDR) * 32U) + ((uint32_t)(Bit) * 4U)))
+#define REG_SET_BIT(Reg, Bit)			(*BITBAND_PERIPH(&(Reg), (Bit)) = 1U)
+#define REG_CLR_BIT(Reg, Bit)			(*BITBAND_PERIPH(&(Reg), (Bit)) = 0U)
+#define REG_TOGGLE_BIT(Reg, Bit)		(*BITBAND_PERIPH(&(Reg), (Bit)) ^= 1U)
+#define REG_READ_BIT(Reg, Bit)			(*BITBAND_PERIPH(&(Reg), (Bit)))
+#else
+#define REG_SET_BIT(Reg, Bit)			((void)__atomic_fetch_or(&(Reg), (uint32_t)(1UL << (Bit)), __ATOMIC_SEQ_CST))
+#define REG_CLR_BIT(Reg, Bit)			((void)__atomic_fetch_and(&(Reg), ~(uint32_t)(1UL << (Bit)), __ATOMIC_SEQ_CST))
+#define REG_TOGGLE_BIT(Reg, Bit)		((void)__atomic_fetch_xor(&(Reg), (uint32_t)(1UL << (Bit)), __ATOMIC_SEQ_CST))
+#define REG_READ_BIT(Reg, Bit)			(((Reg) >> (Bit)) & 1U)
+#endif
+
 /*
  * Enable clock macros for GPIOx peripherals
  */
-#define GPIOA_CLK_EN()					(RCC->AHB1ENR |= (1<<0))
-#define GPIOB_CLK_EN()					(RCC->AHB1ENR |= (1<<1))
-#define GPIOC_CLK_EN()					(RCC->AHB1ENR |= (1<<2))
-#define GPIOD_CLK_EN()					(RCC->AHB1ENR |= (1<<3))
-#define GPIOE_CLK_EN()					(RCC->AHB1ENR |= (1<<4))
-#define GPIOF_CLK_EN()					(RCC->AHB1ENR |= (1<<5))
-#define GPIOG_CLK_EN()					(RCC->AHB1ENR |= (1<<6))
-#define GPIOH_CLK_EN()					(RCC->AHB1ENR |= (1<<7))
-#define GPIOI_CLK_EN()					(RCC->AHB1ENR |= (1<<8))
+#define GPIOA_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 0)
+#define GPIOB_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 1)
+#define GPIOC_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 2)
+#define GPIOD_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 3)
+#define GPIOE_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 4)
+#define GPIOF_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 5)
+#define GPIOG_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 6)
+#define GPIOH_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 7)
+#define GPIOI_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 8)
 
 /*
  * Enable clock macros for I2Cx peripherals
  */
-#define I2C1_CLK_EN()					(RCC->APB1ENR |= (1<<21))
-#define I2C2_CLK_EN()					(RCC->APB1ENR |= (1<<22))
-#define I2C3_CLK_EN()					(RCC->APB1ENR |= (1<<23))
+#define I2C1_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 21)
+#define I2C2_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 22)
+#define I2C3_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 23)
 
 /*
  * Enable clock macros for SPIx peripherals
  */
-#define SPI1_CLK_EN()					(RCC->APB2ENR |= (1<<12))
-#define SPI2_CLK_EN()					(RCC->APB1ENR |= (1<<14))
-#define SPI3_CLK_EN()					(RCC->APB1ENR |= (1<<15))
-#define SPI4_CLK_EN()					(RCC->APB2ENR |= (1<<13))
-#define SPI5_CLK_EN()					(RCC->APB2ENR |= (1<<20))
-#define SPI6_CLK_EN()					(RCC->APB2ENR |= (1<<21))
+#define SPI1_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 12)
+#define SPI2_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 14)
+#define SPI3_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 15)
+#define SPI4_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 13)
+#define SPI5_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 20)
+#define SPI6_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 21)
 
 /*
  * Enable clock macros for USARTx peripherals
  */
-#define USART1_CLK_EN()					(RCC->APB2ENR |= (1<<4))
-#define USART2_CLK_EN()					(RCC->APB1ENR |= (1<<17))
-#define USART3_CLK_EN()					(RCC->APB1ENR |= (1<<18))
-#define USART6_CLK_EN()					(RCC->APB2ENR |= (1<<5))
+#define USART1_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 4)
+#define USART2_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 17)
+#define USART3_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 18)
+#define USART6_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 5)
 
 
 /*
  * Enable clock macros for UARTx peripherals
  */
-#define UART4_CLK_EN()					(RCC->APB1ENR |= (1<<19))
-#define UART5_CLK_EN()					(RCC->APB1ENR |= (1<<20))
-#define UART7_CLK_EN()					(RCC->APB1ENR |= (1<<30))
-#define UART8_CLK_EN()					(RCC->APB1ENR |= (1<<31))
+#define UART4_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 19)
+#define UART5_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 20)
+#define UART7_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 30)
+#define UART8_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 31)
 
 /*
  * Enable clock macros for SYSCFG peripherals
  */
-#define SYSCFG_CLK_EN()					(RCC->APB2ENR |= (1<<14))
+#define SYSCFG_CLK_EN()					REG_SET_BIT(RCC->APB2ENR, 14)
+
+/*
+ * Enable clock macros for PWR peripheral
+ */
+#define PWR_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 28)
+
+/*
+ * Enable clock macros for TIMx peripherals
+ */
+#define TIM2_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 0)
+#define TIM3_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 1)
+#define TIM4_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 2)
+#define TIM5_CLK_EN()					REG_SET_BIT(RCC->APB1ENR, 3)
+
+/*
+ * Enable clock macros for CRC and DMA
+ */
+#define CRC_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 12)
+#define DMA1_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 21)
+#define DMA2_CLK_EN()					REG_SET_BIT(RCC->AHB1ENR, 22)
 
 /*
  * Disable clock macros for GPIOx peripherals
  */
-#define GPIOA_CLK_DI()					(RCC->AHB1ENR &= ~(1<<0))
-#define GPIOB_CLK_DI()					(RCC->AHB1ENR &= ~(1<<1))
-#define GPIOC_CLK_DI()					(RCC->AHB1ENR &= ~(1<<2))
-#define GPIOD_CLK_DI()					(RCC->AHB1ENR &= ~(1<<3))
-#define GPIOE_CLK_DI()					(RCC->AHB1ENR &= ~(1<<4))
-#define GPIOF_CLK_DI()					(RCC->AHB1ENR &= ~(1<<5))
-#define GPIOG_CLK_DI()					(RCC->AHB1ENR &= ~(1<<6))
-#define GPIOH_CLK_DI()					(RCC->AHB1ENR &= ~(1<<7))
-#define GPIOI_CLK_DI()					(RCC->AHB1ENR &= ~(1<<8))
+#define GPIOA_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 0)
+#define GPIOB_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 1)
+#define GPIOC_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 2)
+#define GPIOD_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 3)
+#define GPIOE_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 4)
+#define GPIOF_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 5)
+#define GPIOG_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 6)
+#define GPIOH_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 7)
+#define GPIOI_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 8)
 
 /*
  * Disable clock macros for I2Cx peripherals
  */
-#define I2C1_CLK_DI()					(RCC->APB1ENR &= ~(1<<21))
-#define I2C2_CLK_DI()					(RCC->APB1ENR &= ~(1<<22))
-#define I2C3_CLK_DI()					(RCC->APB1ENR &= ~(1<<23))
+#define I2C1_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 21)
+#define I2C2_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 22)
+#define I2C3_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 23)
 
 /*
  * Disable clock macros for SPIx peripherals
  */
-#define SPI1_CLK_DI()					(RCC->APB2ENR &= ~(1<<12))
-#define SPI2_CLK_DI()					(RCC->APB1ENR &= ~(1<<14))
-#define SPI3_CLK_DI()					(RCC->APB1ENR &= ~(1<<15))
-#define SPI4_CLK_DI()					(RCC->APB2ENR &= ~(1<<13))
-#define SPI5_CLK_DI()					(RCC->APB2ENR &= ~(1<<20))
-#define SPI6_CLK_DI()					(RCC->APB2ENR &= ~(1<<21))
+#define SPI1_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 12)
+#define SPI2_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 14)
+#define SPI3_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 15)
+#define SPI4_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 13)
+#define SPI5_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 20)
+#define SPI6_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 21)
 
 /*
  * Disable clock macros for USARTx peripherals
  */
-#define USART1_CLK_DI()					(RCC->APB2ENR &= ~(1<<4))
-#define USART2_CLK_DI()					(RCC->APB1ENR &= ~(1<<17))
-#define USART3_CLK_DI()					(RCC->APB1ENR &= ~(1<<18))
-#define USART6_CLK_DI()					(RCC->APB2ENR &= ~(1<<5))
+#define USART1_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 4)
+#define USART2_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 17)
+#define USART3_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 18)
+#define USART6_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 5)
 
 
 /*
  * Disable clock macros for UARTx peripherals
  */
-#define UART4_CLK_DI()					(RCC->APB1ENR &= ~(1<<19))
-#define UART5_CLK_DI()					(RCC->APB1ENR &= ~(1<<20))
-#define UART7_CLK_DI()					(RCC->APB1ENR &= ~(1<<30))
-#define UART8_CLK_DI()					(RCC->APB1ENR &= ~(1<<31))
+#define UART4_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 19)
+#define UART5_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 20)
+#define UART7_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 30)
+#define UART8_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 31)
 
 /*
  * Disable clock macros for SYSCFG peripherals
  */
-#define SYSCFG_CLK_DI()					(RCC->APB2ENR &= ~(1<<14))
+#define SYSCFG_CLK_DI()					REG_CLR_BIT(RCC->APB2ENR, 14)
+
+/*
+ * Disable clock macros for PWR peripheral
+ */
+#define PWR_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 28)
+
+/*
+ * Disable clock macros for TIMx peripherals
+ */
+#define TIM2_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 0)
+#define TIM3_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 1)
+#define TIM4_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 2)
+#define TIM5_CLK_DI()					REG_CLR_BIT(RCC->APB1ENR, 3)
+
+/*
+ * Disable clock macros for CRC and DMA
+ */
+#define CRC_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 12)
+#define DMA1_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 21)
+#define DMA2_CLK_DI()					REG_CLR_BIT(RCC->AHB1ENR, 22)
 
 /*
  * IRQ Number Macros
@@ -750,6 +1033,177 @@ typedef struct
 #define USART_GTPR_PSC					0
 #define USART_GTPR_GT					8
 
+/*
+ * RCC CR bit position definitions
+ */
+#define RCC_CR_HSION					0
+#define RCC_CR_HSIRDY					1
+#define RCC_CR_HSEON					16
+#define RCC_CR_HSERDY					17
+#define RCC_CR_PLLON					24
+#define RCC_CR_PLLRDY					25
+
+/*
+ * RCC CFGR bit position definitions
+ */
+#define RCC_CFGR_SW						0
+#define RCC_CFGR_SWS					2
+
+/*
+ * RCC BDCR bit position definitions
+ */
+#define RCC_BDCR_LSEON					0
+#define RCC_BDCR_LSERDY					1
+#define RCC_BDCR_LSEBYP					2
+#define RCC_BDCR_RTCSEL					8
+#define RCC_BDCR_RTCEN					15
+#define RCC_BDCR_BDRST					16
+
+/*
+ * RCC CSR bit position definitions
+ */
+#define RCC_CSR_LSION					0
+#define RCC_CSR_LSIRDY					1
+
+/*
+ * PWR CR bit position definitions
+ */
+#define PWR_CR_LPDS						0
+#define PWR_CR_PDDS						1
+#define PWR_CR_CWUF						2
+#define PWR_CR_CSBF						3
+#define PWR_CR_DBP						8
+#define PWR_CR_FPDS						9
+#define PWR_CR_VOS						14
+
+/*
+ * FLASH ACR bit position definitions
+ */
+#define FLASH_ACR_LATENCY				0
+#define FLASH_ACR_PRFTEN				8
+#define FLASH_ACR_ICEN					9
+#define FLASH_ACR_DCEN					10
+#define FLASH_ACR_ICRST					11
+#define FLASH_ACR_DCRST					12
+
+/*
+ * FLASH SR bit position definitions
+ */
+#define FLASH_SR_EOP					0
+#define FLASH_SR_OPERR					1
+#define FLASH_SR_WRPERR					4
+#define FLASH_SR_PGAERR					5
+#define FLASH_SR_PGPERR					6
+#define FLASH_SR_PGSERR					7
+#define FLASH_SR_BSY					16
+
+/*
+ * FLASH CR bit position definitions
+ */
+#define FLASH_CR_PG						0
+#define FLASH_CR_SER					1
+#define FLASH_CR_MER					2
+#define FLASH_CR_SNB					3
+#define FLASH_CR_PSIZE					8
+#define FLASH_CR_STRT					16
+#define FLASH_CR_EOPIE					24
+#define FLASH_CR_ERRIE					25
+#define FLASH_CR_LOCK					31
+
+/*
+ * TIM CR1 and EGR bit position definitions
+ */
+#define TIM_CR1_CEN						0
+#define TIM_CR1_URS						2
+#define TIM_EGR_UG						0
+
+/*
+ * CRC CR bit position definitions
+ */
+#define CRC_CR_RESET					0
+
+/*
+ * DMA SxCR bit position definitions
+ */
+#define DMA_SXCR_EN						0
+#define DMA_SXCR_DMEIE					1
+#define DMA_SXCR_TEIE					2
+#define DMA_SXCR_HTIE					3
+#define DMA_SXCR_TCIE					4
+#define DMA_SXCR_PFCTRL					5
+#define DMA_SXCR_DIR					6
+#define DMA_SXCR_CIRC					8
+#define DMA_SXCR_PINC					9
+#define DMA_SXCR_MINC					10
+#define DMA_SXCR_PSIZE					11
+#define DMA_SXCR_MSIZE					13
+#define DMA_SXCR_PINCOS					15
+#define DMA_SXCR_PL						16
+#define DMA_SXCR_DBM					18
+#define DMA_SXCR_CT						19
+#define DMA_SXCR_PBURST					21
+#define DMA_SXCR_MBURST					23
+#define DMA_SXCR_CHSEL					25
+
+/*
+ * DMA SxFCR bit position definitions
+ */
+#define DMA_SXFCR_FTH					0
+#define DMA_SXFCR_DMDIS					2
+
+/*
+ * DMA LISR/HISR flags of a stream, shifted by the stream offset (0, 6, 16, 22)
+ */
+#define DMA_ISR_FEIF					0
+#define DMA_ISR_DMEIF					2
+#define DMA_ISR_TEIF					3
+#define DMA_ISR_HTIF					4
+#define DMA_ISR_TCIF					5
+
+/*
+ * IRTC TR and DR bit position definitions (BCD fields, tens then units)
+ */
+#define IRTC_TR_SU						0
+#define IRTC_TR_ST						4
+#define IRTC_TR_MNU						8
+#define IRTC_TR_MNT						12
+#define IRTC_TR_HU						16
+#define IRTC_TR_HT						20
+#define IRTC_TR_PM						22
+#define IRTC_DR_DU						0
+#define IRTC_DR_DT						4
+#define IRTC_DR_MU						8
+#define IRTC_DR_MT						12
+#define IRTC_DR_WDU						13
+#define IRTC_DR_YU						16
+#define IRTC_DR_YT						20
+
+/*
+ * IRTC CR bit position definitions
+ */
+#define IRTC_CR_WUCKSEL					0
+#define IRTC_CR_BYPSHAD					5
+#define IRTC_CR_FMT						6
+#define IRTC_CR_WUTE					10
+#define IRTC_CR_WUTIE					14
+
+/*
+ * IRTC ISR bit position definitions
+ */
+#define IRTC_ISR_ALRAWF					0
+#define IRTC_ISR_WUTWF					2
+#define IRTC_ISR_INITS					4
+#define IRTC_ISR_RSF					5
+#define IRTC_ISR_INITF					6
+#define IRTC_ISR_INIT					7
+#define IRTC_ISR_WUTF					10
+
+/*
+ * IRTC PRER bit position definitions
+ */
+#define IRTC_PRER_PREDIV_S				0
+#define IRTC_PRER_PREDIV_A				16
+
 /*
  * Generic functions
  */
@@ -768,5 +1222,8 @@ typedef struct
 #include "stm32f407xx_i2c.h"
 #include "stm32f407x_usart.h"
 #include "stm32f407xx_RCC.h"
+#include "stm32f407xx_flash.h"
+#include "stm32f407xx_crc.h"
+#include "stm32f407xx_irtc.h"
 
 #endif /* INC_STM32F407XX_H_ */
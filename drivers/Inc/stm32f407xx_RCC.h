@@ -19,5 +19,8 @@ uint32_t RCC_GetPCLK2Value(void);
 
 uint32_t  RCC_GetPLLOutputClock(void);
 
+//Switches SYSCLK to the HSE crystal (8MHz on the board), returns 0 on success and 1 if HSE did not start
+uint8_t RCC_SetSysClkHSE(uint32_t Timeout);
+
 
 #endif /* INC_STM32F407XX_RCC_H_ */
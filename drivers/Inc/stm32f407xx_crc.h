@@ -0,0 +1,64 @@
+/*
+ * stm32f407xx_crc.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- The CRC unit computes CRC-32 (poly 0x04C11DB7) over 32 bit words, bit 31 first. Init 0xFFFFFFFF,
+ * 	  no reflection, no final xor, the initial value can not be changed on the F407. A word takes
+ * 	  4 AHB cycles
+ * 	- Byte buffers are fed as little endian words, i.e. the same word a 32 bit load returns. 1-3 bytes
+ * 	  left at the end are fed as one word with the missing upper bytes 0. Crc_CRC32Soft() (crc.h)
+ * 	  gives the same result on the host
+ * 	- DMA: DMA2 memory to memory (only DMA2 can do it) streams a buffer into DR while the CPU carries on.
+ * 	  The source must be DMA reachable (not CCM RAM), word aligned, at most CRC_DMA_MAX_WORDS words.
+ * 	  The stream is polled, no interrupt
+ * 	- The unit has one state. Thread context only, and nothing else may use it while a DMA runs
+ */
+
+#ifndef INC_STM32F407XX_CRC_H_
+#define INC_STM32F407XX_CRC_H_
+
+#include "stm32f407xx.h"
+
+#define CRC_DMA_CONTROLLER				DMA2
+#define CRC_DMA_STREAM					0
+#define CRC_DMA_ISR_SHIFT				0			/* Flag offset of stream 0 in LISR */
+#define CRC_DMA_MAX_WORDS				0xFFFF
+
+/*
+ * Return values
+ */
+#define CRC_OK							0
+#define CRC_BUSY						1			/* DMA still running */
+#define CRC_ERR_PARAM					2
+#define CRC_ERR_DMA						3
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this driver
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Peripheral clock setup
+ */
+void CRC_PeriClockControl(uint8_t EnorDi);
+
+/*
+ * CPU feeding
+ */
+void CRC_Reset(void);
+uint32_t CRC_Accumulate(const void *pData, uint32_t Len);
+uint32_t CRC_Calculate(const void *pData, uint32_t Len);
+
+/*
+ * DMA streaming
+ */
+uint8_t CRC_DMAStart(const void *pData, uint32_t Len);
+uint8_t CRC_DMAPoll(uint32_t *pCrc);
+uint8_t CRC_DMAIsBusy(void);
+
+#endif /* INC_STM32F407XX_CRC_H_ */
@@ -0,0 +1,81 @@
+/*
+ * stm32f407xx_flash.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#ifndef INC_STM32F407XX_FLASH_H_
+#define INC_STM32F407XX_FLASH_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Sector layout of the 1MB part (single bank)
+ * 	Sector 0-3		16KB	0x08000000 - 0x0800FFFF
+ * 	Sector 4		64KB	0x08010000 - 0x0801FFFF
+ * 	Sector 5-11		128KB	0x08020000 - 0x080FFFFF
+ */
+#define FLASH_NO_OF_SECTORS				12
+#define FLASH_END_ADDR					(FLASH_BASEADDR + 0x100000UL)
+
+/*
+ * Supply voltage range, selects the program/erase parallelism (RM0090 3.6.2)
+ * @FLASH_VOLTAGE_RANGE
+ */
+#define FLASH_VOLTAGE_RANGE_1			0		/* 1.8V - 2.1V			x8 */
+#define FLASH_VOLTAGE_RANGE_2			1		/* 2.1V - 2.7V			x16 */
+#define FLASH_VOLTAGE_RANGE_3			2		/* 2.7V - 3.6V			x32 */
+#define FLASH_VOLTAGE_RANGE_4			3		/* 2.7V - 3.6V + Vpp	x64 */
+
+/*
+ * CR PSIZE values
+ */
+#define FLASH_PSIZE_X8					0
+#define FLASH_PSIZE_X16					1
+#define FLASH_PSIZE_X32					2
+#define FLASH_PSIZE_X64					3
+
+/*
+ * Unlock keys
+ */
+#define FLASH_KEY1						0x45670123UL
+#define FLASH_KEY2						0xCDEF89ABUL
+
+/*
+ * Return values
+ */
+#define FLASH_OK						0
+#define FLASH_ERR_PARAM					1			/* Bad sector, address or alignment */
+#define FLASH_ERR_WRP					2			/* Write protected */
+#define FLASH_ERR_PROG					3			/* Alignment, parallelism or sequence error */
+#define FLASH_ERR_OP					4			/* Operation error */
+
+#define FLASH_SR_ERRORS					((1 << FLASH_SR_OPERR) | (1 << FLASH_SR_WRPERR) | (1 << FLASH_SR_PGAERR) |\
+										 (1 << FLASH_SR_PGPERR) | (1 << FLASH_SR_PGSERR))
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this driver
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Lock
+ */
+void FLASH_Unlock(void);
+void FLASH_Lock(void);
+
+/*
+ * Erase and program
+ */
+uint8_t FLASH_EraseSector(uint8_t Sector, uint8_t VoltageRange);
+uint8_t FLASH_Program(uint32_t Address, const void *pData, uint32_t Len, uint8_t VoltageRange);
+
+/*
+ * Sector geometry
+ */
+uint8_t FLASH_GetSector(uint32_t Address);
+uint32_t FLASH_GetSectorAddr(uint8_t Sector);
+uint32_t FLASH_GetSectorSize(uint8_t Sector);
+
+#endif /* INC_STM32F407XX_FLASH_H_ */
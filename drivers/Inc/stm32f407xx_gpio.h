@@ -144,7 +144,7 @@ void GPIO_TogglePinOutput(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber);
  */
 void GPIO_IRQPriorityConfig(uint8_t IRQNumber, uint8_t IRQPriority);
 void GPIO_IRQITConfig(uint8_t IRQNumber, uint8_t EnorDi);
-void GPIO_IRQHandling(uint8_t PinNumber);
+__RAMFUNC void GPIO_IRQHandling(uint8_t PinNumber);
 
 
 #endif /* STM32F407XX_GPIO_H_ */
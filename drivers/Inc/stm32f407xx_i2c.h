@@ -21,6 +21,17 @@ typedef struct
 	uint16_t	I2C_FMDutyCycle;
 }I2C_Config_t;
 
+/*
+ * I2C error counter indexes
+ * @I2C_ERRCNT
+ */
+#define I2C_ERRCNT_BERR			0
+#define I2C_ERRCNT_ARLO			1
+#define I2C_ERRCNT_AF			2
+#define I2C_ERRCNT_OVR			3
+#define I2C_ERRCNT_TIMEOUT		4
+#define I2C_ERRCNT_NUM			5
+
 typedef struct
 {
 	I2C_Config_t 	I2C_Config;
@@ -33,11 +44,29 @@ typedef struct
 	uint8_t			DevAddr;		/* To store the slave/device address*/
 	uint32_t 		RxSize;			/* To store the Rx size*/
 	uint8_t			Sr;				/*To store repeated start value*/
+	uint32_t		ErrCount[I2C_ERRCNT_NUM];	/* To store the error counters, indexed by @I2C_ERRCNT */
 }I2C_Handle_t ;
 
 #define I2C_NO_SR			 	RESET
 #define I2C_SR					SET
 
+/*
+ * Number of SR1 polls before I2C_MasterProbe gives up waiting for ADDR or AF
+ */
+#define I2C_PROBE_TIMEOUT		10000
+
+/*
+ * Number of SR1 polls the blocking master APIs wait for one flag (SB, ADDR, TxE, BTF, RxNE)
+ */
+#define I2C_MASTER_TIMEOUT		10000
+
+/*
+ * Return values of the blocking master APIs
+ */
+#define I2C_OK					0
+#define I2C_ERR_NACK			1		/* The slave did not acknowledge its address or a byte */
+#define I2C_ERR_TIMEOUT			2		/* A flag did not come in I2C_MASTER_TIMEOUT polls */
+
 /*
  * I2C Application states
  */
@@ -84,6 +113,7 @@ typedef struct
 #define I2C_ERROR_TIMEOUT		7
 #define I2C_EV_DATA_REQ			8
 #define I2C_EV_DATA_RCV			9
+#define I2C_EV_ADDR_MATCH		10		/* Slave: own address received, transfer starts */
 
 
 /**************************************************************************************************************************************
@@ -116,8 +146,9 @@ void I2C_Deinit(I2C_RegDef_t *pI2Cx);
  * I2C Data receive and Send
  */
 
-void I2C_MasterSendData(I2C_Handle_t *pI2CHandle, uint8_t *TxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr);
-void I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr);
+uint8_t I2C_MasterSendData(I2C_Handle_t *pI2CHandle, uint8_t *TxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr);
+uint8_t I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr);
+uint8_t I2C_MasterProbe(I2C_Handle_t *pI2CHandle, uint8_t SlaveAddr);
 
 /*
  * I2C Data receive and Send with Interrupt Functionality
@@ -130,22 +161,22 @@ uint8_t I2C_MasterReceiveDataIT(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uin
  */
 void I2C_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi);
 void I2C_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
-void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle);
-void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle);
-void I2C_CloseSendData(I2C_Handle_t *pI2CHandle);
-void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle);
+__RAMFUNC void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle);
+__RAMFUNC void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle);
+__RAMFUNC void I2C_CloseSendData(I2C_Handle_t *pI2CHandle);
+__RAMFUNC void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle);
 
 /*
  * Slave Data send and Receive
  */
-void I2C_SlaveSendData(I2C_RegDef_t *pI2Cx, uint8_t data);
-uint8_t I2C_SlaveReceiveData(I2C_RegDef_t *pI2Cx);
+__RAMFUNC void I2C_SlaveSendData(I2C_RegDef_t *pI2Cx, uint8_t data);
+__RAMFUNC uint8_t I2C_SlaveReceiveData(I2C_RegDef_t *pI2Cx);
 
 
 /*
  * Application callback
  */
-void I2C_ApplicationEventCallback(I2C_Handle_t *pI2CHandle, uint8_t AppEv);
+__RAMFUNC void I2C_ApplicationEventCallback(I2C_Handle_t *pI2CHandle, uint8_t AppEv);
 
 
 
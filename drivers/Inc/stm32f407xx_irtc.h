@@ -0,0 +1,133 @@
+/*
+ * stm32f407xx_irtc.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Notes
+ * 	- Driver for the on-chip RTC and the backup registers. Prefix IRTC_, RTC_ is the external RTC (BSP/rtc.h)
+ * 	- Clock: LSE (32.768kHz crystal) or LSI (~32kHz RC, drifts by percents, only good for the wakeup timer).
+ * 	  With the default prescalers both give ck_spre = 1Hz
+ * 	- The RTC lives in the backup domain. Writes need two locks opened, in this order
+ * 		1. PWR_CR DBP		backup domain write access (RCC_BDCR, RTC, backup registers)
+ * 		2. RTC_WPR keys		0xCA then 0x53, any other value locks the RTC registers again
+ * 	  DBP stays set after IRTC_Init(), the wakeup flag has to be cleared from the ISR. Every RTC register write
+ * 	  sequence opens the key lock and closes it again before returning. The backup registers and the
+ * 	  ISR flags are not behind the key lock
+ * 	- The calendar keeps running over a reset and on VBAT. IRTC_Init() leaves a running calendar untouched
+ * 	  (INITS set) and only starts the clock on a cold backup domain, where IRTC_IsTimeLost() reports 1 until
+ * 	  the first IRTC_SetDateTime(). Changing the clock source needs a backup domain reset, which clears the
+ * 	  calendar and the backup registers. It is only done once the new clock runs: asking for LSE on a
+ * 	  board without the crystal returns IRTC_ERR_CLOCK and leaves the calendar running from LSI alone
+ * 	- Reads go through the shadow registers (BYPSHAD = 0). They are copied from the calendar every 2 RTCCLK
+ * 	  cycles, RSF marks a valid copy. Reading TR locks DR until DR is read, so read TR first
+ * 	- IRTC_DateTime_t is always 24h, WeekDay is 1 = Monday to 7 = Sunday as in the hardware. Year is 0-99,
+ * 	  2000 based
+ * 	- Wakeup timer: ck_spre based, 1s to 65536s. Raises EXTI line 22 (rising edge) and IRQ_RTC_WKUP. The
+ * 	  application RTC_WKUP_IRQHandler calls IRTC_IRQHandling()
+ */
+
+#ifndef INC_STM32F407XX_IRTC_H_
+#define INC_STM32F407XX_IRTC_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * @IRTC_CLOCK
+ */
+#define IRTC_CLOCK_LSE					1			/* RTCSEL values */
+#define IRTC_CLOCK_LSI					2
+
+/*
+ * Prescalers for ck_spre = 1Hz, RTCCLK / ((PREDIV_A + 1) * (PREDIV_S + 1))
+ */
+#define IRTC_LSE_PREDIV_A				127
+#define IRTC_LSE_PREDIV_S				255
+#define IRTC_LSI_PREDIV_A				127
+#define IRTC_LSI_PREDIV_S				249
+
+#define IRTC_WPR_KEY1					0xCA
+#define IRTC_WPR_KEY2					0x53
+#define IRTC_WPR_LOCK					0xFF
+#define IRTC_WUCKSEL_CK_SPRE			4
+#define IRTC_EXTI_LINE					22
+#define IRTC_NO_OF_BKP					20
+#define IRTC_WAKEUP_MAX					65536
+
+#define IRTC_LSE_TIMEOUT				4000000		/* Polls, a crystal may take 2s to start */
+#define IRTC_TIMEOUT					100000		/* Polls, INITF/RSF/WUTWF take a few RTCCLK cycles */
+
+/*
+ * Return values
+ */
+#define IRTC_OK							0
+#define IRTC_ERR_CLOCK					1			/* LSE/LSI did not start */
+#define IRTC_ERR_TIMEOUT				2			/* INITF, RSF or WUTWF never set */
+#define IRTC_ERR_PARAM					3
+
+/*
+ * Date and time, 24h
+ */
+typedef struct
+{
+	uint8_t		Seconds;
+	uint8_t		Minutes;
+	uint8_t		Hours;
+	uint8_t		WeekDay;			/* 1 = Monday to 7 = Sunday */
+	uint8_t		Date;
+	uint8_t		Month;
+	uint8_t		Year;				/* 0-99 */
+}IRTC_DateTime_t;
+
+/*
+ * Configuration structure for the internal RTC
+ */
+typedef struct
+{
+	uint8_t		ClockSource;		/* @IRTC_CLOCK */
+	uint8_t		WakeupIRQPriority;	/* NVIC priority of RTC_WKUP */
+}IRTC_Config_t;
+
+/*
+ * Handle structure for the internal RTC
+ */
+typedef struct
+{
+	IRTC_Config_t	IRTC_Config;
+	uint8_t			TimeLost;		/* To store if the calendar was not running at init */
+	__vo uint32_t	Wakeups;		/* To store the number of wakeup timer events (ISR) */
+}IRTC_Handle_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this driver
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+/*
+ * Init
+ */
+uint8_t IRTC_Init(IRTC_Handle_t *pIRTCHandle);
+uint8_t IRTC_IsTimeLost(IRTC_Handle_t *pIRTCHandle);
+
+/*
+ * Calendar
+ */
+uint8_t IRTC_GetDateTime(IRTC_Handle_t *pIRTCHandle, IRTC_DateTime_t *pDateTime);
+uint8_t IRTC_SetDateTime(IRTC_Handle_t *pIRTCHandle, const IRTC_DateTime_t *pDateTime);
+uint8_t IRTC_WaitForSynchro(void);
+
+/*
+ * Wakeup timer
+ */
+uint8_t IRTC_SetWakeup(IRTC_Handle_t *pIRTCHandle, uint32_t Seconds);
+__RAMFUNC void IRTC_IRQHandling(IRTC_Handle_t *pIRTCHandle);
+
+/*
+ * Backup registers
+ */
+uint32_t IRTC_ReadBackup(uint8_t Index);
+void IRTC_WriteBackup(uint8_t Index, uint32_t Value);
+
+#endif /* INC_STM32F407XX_IRTC_H_ */
@@ -13,11 +13,12 @@ static void I2C_ExecuteAddressPhaseRead(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr);
 static void I2C_ClearADDRFlag(I2C_Handle_t *pI2CHandl);
 static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *pI2CHandle);
 static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *pI2CHandle);
+static uint8_t I2C_MasterWaitFlag(I2C_Handle_t *pI2CHandle, uint32_t Flag);
 
-void I2C_ManageAcking(I2C_RegDef_t *pI2Cx, uint8_t EnOrDi);
+__RAMFUNC void I2C_ManageAcking(I2C_RegDef_t *pI2Cx, uint8_t EnOrDi);
 
 
-static void I2C_ExecuteAddressPhaseWrite(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
+__RAMFUNC static void I2C_ExecuteAddressPhaseWrite(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
 {
 	SlaveAddr = SlaveAddr << 1;
 	SlaveAddr &= ~(1);
@@ -25,7 +26,7 @@ static void I2C_ExecuteAddressPhaseWrite(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
 
 }
 
-static void I2C_ExecuteAddressPhaseRead(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
+__RAMFUNC static void I2C_ExecuteAddressPhaseRead(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
 {
 	SlaveAddr = SlaveAddr << 1;
 	SlaveAddr |= 1;
@@ -46,19 +47,19 @@ static void I2C_ExecuteAddressPhaseRead(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
  * @Note			-
  *
  *************************************************************************************************/
-void I2C_ManageAcking(I2C_RegDef_t *pI2Cx, uint8_t EnOrDi)
+__RAMFUNC void I2C_ManageAcking(I2C_RegDef_t *pI2Cx, uint8_t EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		pI2Cx->CR1 |= (1 << I2C_CR1_ACK);
+		REG_SET_BIT(pI2Cx->CR1, I2C_CR1_ACK);
 	}
 	else if(EnOrDi == DISABLE)
 	{
-		pI2Cx->CR1 |= (1 << I2C_CR1_ACK);
+		REG_CLR_BIT(pI2Cx->CR1, I2C_CR1_ACK);
 	}
 }
 
-static void I2C_ClearADDRFlag(I2C_Handle_t *pI2CHandle)
+__RAMFUNC static void I2C_ClearADDRFlag(I2C_Handle_t *pI2CHandle)
 {
 	uint32_t dummyRead;
 	// check if device is master mode or slave mode
@@ -98,6 +99,35 @@ static void I2C_ClearADDRFlag(I2C_Handle_t *pI2CHandle)
 
 }
 
+/*
+ * Blocking master: polls SR1 till Flag is set. AF (NACK) or I2C_MASTER_TIMEOUT polls end the wait,
+ * the error is counted and the bus released. AF is checked first, a NACKed byte sets TxE too
+ */
+static uint8_t I2C_MasterWaitFlag(I2C_Handle_t *pI2CHandle, uint32_t Flag)
+{
+	uint32_t timeout = I2C_MASTER_TIMEOUT;
+	uint32_t sr1;
+
+	while(timeout--)
+	{
+		sr1 = pI2CHandle->pI2Cx->SR1;
+		if(sr1 & (1 << I2C_SR1_AF))
+		{
+			pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_AF);
+			pI2CHandle->ErrCount[I2C_ERRCNT_AF]++;
+			REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
+			return I2C_ERR_NACK;
+		}
+		if(sr1 & Flag)
+			return I2C_OK;
+	}
+
+	pI2CHandle->ErrCount[I2C_ERRCNT_TIMEOUT]++;
+	REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
+
+	return I2C_ERR_TIMEOUT;
+}
+
 /*
  * Enable/Disable I2C Peripheral
  */
@@ -119,11 +149,11 @@ void I2C_PeripheralControl(I2C_RegDef_t *pI2Cx, uint8_t EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		pI2Cx->CR1 |= (1 << I2C_CR1_PE);
+		REG_SET_BIT(pI2Cx->CR1, I2C_CR1_PE);
 	}
 	else if(EnOrDi == DISABLE)
 	{
-		pI2Cx->CR1 |= (1 << I2C_CR1_PE);
+		REG_CLR_BIT(pI2Cx->CR1, I2C_CR1_PE);
 	}
 }
 
@@ -281,18 +311,18 @@ void I2C_Deinit(I2C_RegDef_t *pI2Cx)
 {
 	if(pI2Cx == I2C1)
 	{
-		RCC->APB1RSTR |= (1 << 21);
-		RCC->APB1RSTR &= ~(1 << 21);
+		REG_SET_BIT(RCC->APB1RSTR, 21);
+		REG_CLR_BIT(RCC->APB1RSTR, 21);
 	}
 	else if(pI2Cx == I2C2)
 	{
-		RCC->APB1RSTR |= (1 << 22);
-		RCC->APB1RSTR &= ~(1 << 22);
+		REG_SET_BIT(RCC->APB1RSTR, 22);
+		REG_CLR_BIT(RCC->APB1RSTR, 22);
 	}
 	else if(pI2Cx == I2C3)
 	{
-		RCC->APB1RSTR |= (1 << 23);
-		RCC->APB1RSTR &= ~(1 << 23);
+		REG_SET_BIT(RCC->APB1RSTR, 23);
+		REG_CLR_BIT(RCC->APB1RSTR, 23);
 	}
 }
 
@@ -326,116 +356,129 @@ uint8_t I2C_GetFlagStatus(I2C_RegDef_t *pI2Cx , uint32_t FlagName)
 /*************************************************************************************************
  * @fn				- I2C_MasterSendData
  *
- * @brief			-
+ * @brief			- Blocking write of len bytes to a slave
  *
- * @param[in]		-
- * @param[in]		-
- * @param[in[		-
+ * @param[in]		- I2C handle
+ * @param[in]		- transmit buffer
+ * @param[in]		- number of bytes
+ * @param[in]		- 7 bit slave address
+ * @param[in]		- I2C_SR to keep the bus (repeated start), I2C_NO_SR to send STOP
  *
- * @return			-
+ * @return			- I2C_OK, I2C_ERR_NACK or I2C_ERR_TIMEOUT
  *
- * @Note			-
+ * @Note			- on an error the bus is released with STOP
  *
  *************************************************************************************************/
-void I2C_MasterSendData(I2C_Handle_t *pI2CHandle, uint8_t *TxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr)
+uint8_t I2C_MasterSendData(I2C_Handle_t *pI2CHandle, uint8_t *TxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr)
 {
+	uint8_t status;
+
 	// 1. Generate the start condition
-	pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_START);
+	REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_START);
 
 	// 2. Check if the start bit is set and then Read the SR1 register to clear the start bit
-	while(!(I2C_GetFlagStatus(pI2CHandle->pI2Cx,I2C_SR1_SB)));
-	//uint32_t temp = pI2CHandle->pI2Cx->SR1;
+	status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_SB));
+	if(status != I2C_OK)
+		return status;
 
 	// 3. Send the address of slave with transmission byte (0)
 	SlaveAddr = SlaveAddr << 1;
 	SlaveAddr &= ~(1);
 	pI2CHandle->pI2Cx->DR = SlaveAddr;
 
-	// 4. ADDR bit is set if it receives an ACK
-	if(I2C_GetFlagStatus(pI2CHandle->pI2Cx,(1 << I2C_SR1_ADDR)))
-	{
-		// The ADDR bit is set which means that the master received an ack. Now we should reset this ADDR bit
-		// read SR1 and SR2 to clear this bit
-		I2C_ClearADDRFlag(pI2CHandle);
-	}
+	// 4. ADDR bit is set when the slave sends the ACK (AF when it does not). Read SR1 and SR2 to clear it
+	status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_ADDR));
+	if(status != I2C_OK)
+		return status;
+	I2C_ClearADDRFlag(pI2CHandle);
 
-	// 5. Send data till len becomes zero. We don't have to check for ack every time as it is handled by the hardware
+	// 5. Send data till len becomes zero. A byte the slave does not acknowledge sets AF
 	while(len)
 	{
 		// wait till Txe is 1 indicating that DR is empty and ready to be filled with data
-		while(!(I2C_GetFlagStatus(pI2CHandle->pI2Cx,(1 << I2C_SR1_TxE))))
-		{
-			pI2CHandle->pI2Cx->DR = *TxBuffer;
-			TxBuffer++;
-			len--;
-		}
+		status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_TxE));
+		if(status != I2C_OK)
+			return status;
+		pI2CHandle->pI2Cx->DR = *TxBuffer;
+		TxBuffer++;
+		len--;
 	}
 
 	// 6. Close the communication
 	// 6.1 wait for Txe = 1 and BTF = 1 before generating the stop condition
-	while(!(I2C_GetFlagStatus(pI2CHandle->pI2Cx,(1 << I2C_SR1_TxE))));
-	while(!(I2C_GetFlagStatus(pI2CHandle->pI2Cx,(1 << I2C_SR1_BTF))));
+	status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_TxE));
+	if(status == I2C_OK)
+		status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_BTF));
+	if(status != I2C_OK)
+		return status;
 
 	// 6.2 Generate the stop condition (if repeated start isn't enabled)
 	if(Sr == I2C_NO_SR)
-		pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_STOP);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
+
+	return I2C_OK;
 }
 
 /*************************************************************************************************
  * @fn				- I2C_MasterReceiveData
  *
- * @brief			-
+ * @brief			- Blocking read of len bytes from a slave
  *
- * @param[in]		-
- * @param[in]		-
- * @param[in[		-
+ * @param[in]		- I2C handle
+ * @param[out]		- receive buffer
+ * @param[in]		- number of bytes
+ * @param[in]		- 7 bit slave address
+ * @param[in]		- I2C_SR to keep the bus (repeated start), I2C_NO_SR to send STOP
  *
- * @return			-
+ * @return			- I2C_OK, I2C_ERR_NACK or I2C_ERR_TIMEOUT
  *
- * @Note			-
+ * @Note			- on an error the bus is released with STOP and the buffer is incomplete
  *
  *************************************************************************************************/
-
-/*
- * I2C send and receive data
- */
-
-void I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr)
+uint8_t I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uint8_t len, uint8_t SlaveAddr, uint8_t Sr)
 {
 	uint32_t temp;
+	uint8_t status;
+
 	// 1. Initiate the start condition
-	pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_START);
+	REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_START);
 
 	// 2. Confirm if the start bit is set
-	while(!(I2C_GetFlagStatus(pI2CHandle->pI2Cx,I2C_SR1_SB)));
+	status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_SB));
+	if(status != I2C_OK)
+		return status;
 
 	// 3. Send Address bit
 	SlaveAddr = SlaveAddr << 1;
 	SlaveAddr |= 1;
 	pI2CHandle->pI2Cx->DR = SlaveAddr;
 
-	// 4. check if the ADDR flag is set. Wait until its set
-	while(!(I2C_GetFlagStatus(pI2CHandle->pI2Cx,(1 << I2C_SR1_ADDR))));
+	// 4. check if the ADDR flag is set. Wait until its set (AF if the slave is not there)
+	status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_ADDR));
+	if(status != I2C_OK)
+		return status;
 
 	// 5. Send data. If len = 1 or if len > 1
 	if(len == 1)
 	{
 		// a. Disable ack
-		pI2CHandle->pI2Cx->CR1 &= ~(1 << I2C_CR1_ACK);
+		REG_CLR_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_ACK);
 
 		// c. clear addr bit. Read SR1 followed by SR2
 		I2C_ClearADDRFlag(pI2CHandle);
 
 		// d. wait till RXNE is set
-		while(!I2C_GetFlagStatus(pI2CHandle->pI2Cx, (1 << I2C_SR1_RxNE)));
-
-		// b. send stop condition if repeated start is disabled
-		if(Sr == I2C_NO_SR)
-			pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_STOP);
+		status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_RxNE));
+		if(status == I2C_OK)
+		{
+			// b. send stop condition if repeated start is disabled
+			if(Sr == I2C_NO_SR)
+				REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
 
-		// e. Read the data from the data register
-		*RxBuffer = pI2CHandle->pI2Cx->DR;
-		RxBuffer++;
+			// e. Read the data from the data register
+			*RxBuffer = pI2CHandle->pI2Cx->DR;
+			RxBuffer++;
+		}
 		len--;
 	}
 	if(len > 1 )
@@ -449,17 +492,19 @@ void I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uint8_t
 		while(len > 0)
 		{
 			// d. wait till RXNE becomes 1
-			while(!I2C_GetFlagStatus(pI2CHandle->pI2Cx, (1 << I2C_SR1_RxNE)));
+			status = I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_RxNE));
+			if(status != I2C_OK)
+				break;
 
 			if(len == 2)
 			{
 				// c. when len == 2,
 				// c.1 clear ACK
-				pI2CHandle->pI2Cx->CR1 &= ~(1 << I2C_CR1_ACK);
+				REG_CLR_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_ACK);
 
 				// c.2 set STOP condition if repeated start is disabled
 				if(Sr == I2C_NO_SR)
-					pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_STOP);
+					REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
 			}
 
 			*RxBuffer = pI2CHandle->pI2Cx->DR;
@@ -472,8 +517,61 @@ void I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uint8_t
 
 	// 7. Renable acking
 	if(pI2CHandle->I2C_Config.I2C_ACKControl == I2C_ACKCTRL_ACK_EN)
-		pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_ACK);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_ACK);
+
+	return status;
+}
+
+/*************************************************************************************************
+ * @fn				- I2C_MasterProbe
+ *
+ * @brief			- Checks if a slave acknowledges its address
+ *
+ * @param[in]		- I2C handle
+ * @param[in]		- 7 bit slave address
+ *
+ * @return			- 1 if the slave sent an ACK, 0 otherwise
+ *
+ * @Note			- A missing slave or a bus which never gives SB does not hang.
+ * 					  Only START, address and STOP are sent
+ *
+ *************************************************************************************************/
+uint8_t I2C_MasterProbe(I2C_Handle_t *pI2CHandle, uint8_t SlaveAddr)
+{
+	uint32_t timeout = I2C_PROBE_TIMEOUT;
+	uint32_t dummyRead;
+	uint8_t ack = 0;
+
+	// 1. Generate the start condition and wait for it
+	REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_START);
+	if(I2C_MasterWaitFlag(pI2CHandle, (1 << I2C_SR1_SB)) != I2C_OK)
+		return 0;
+
+	// 2. Send the address with the write bit
+	I2C_ExecuteAddressPhaseWrite(pI2CHandle->pI2Cx, SlaveAddr);
+
+	// 3. ADDR -> ACK, AF -> NACK. SR1 is read directly, SR2 shares bit positions (BUSY, MSL)
+	while(timeout--)
+	{
+		if(pI2CHandle->pI2Cx->SR1 & (1 << I2C_SR1_ADDR))
+		{
+			dummyRead = pI2CHandle->pI2Cx->SR1;
+			dummyRead = pI2CHandle->pI2Cx->SR2;
+			(void)dummyRead;
+			ack = 1;
+			break;
+		}
+		if(pI2CHandle->pI2Cx->SR1 & (1 << I2C_SR1_AF))
+		{
+			pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_AF);
+			break;
+		}
+	}
 
+	// 4. Release the bus
+	REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
+
+	return ack;
 }
 
 /*************************************************************************************************
@@ -503,17 +601,17 @@ uint8_t I2C_MasterSendDataIT(I2C_Handle_t *pI2CHandle, uint8_t *TxBuffer, uint8_
 		pI2CHandle->Sr = Sr;
 
 		//Implement code to Generate START Condition
-		pI2CHandle->pI2Cx->CR1 |= ( 1 << I2C_CR1_START);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_START);
 
 		//Implement the code to enable ITBUFEN Control Bit
-		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITBUFEN);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITBUFEN);
 
 		//Implement the code to enable ITEVFEN Control Bit
-		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITEVTEN);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITEVTEN);
 
 
 		//Implement the code to enable ITERREN Control Bit
-		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITERREN);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITERREN);
 	}
 	return busystate;
 }
@@ -546,17 +644,17 @@ uint8_t I2C_MasterReceiveDataIT(I2C_Handle_t *pI2CHandle, uint8_t *RxBuffer, uin
 		pI2CHandle->Sr = Sr;
 
 		//Implement code to Generate START Condition
-		pI2CHandle->pI2Cx->CR1 |= ( 1 << I2C_CR1_START);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_START);
 
 		//Implement the code to enable ITBUFEN Control Bit
-		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITBUFEN);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITBUFEN);
 
 		//Implement the code to enable ITEVFEN Control Bit
-		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITEVTEN);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITEVTEN);
 
 
 		//Implement the code to enable ITERREN Control Bit
-		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITERREN);
+		REG_SET_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITERREN);
 
 	}
 
@@ -586,15 +684,15 @@ void I2C_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi)
 		if(IRQNumber <= 31)
 		{
 			// program ISER1
-			*NVIC_ISER0 |= (1<<IRQNumber);
+			*NVIC_ISER0 = (1 << IRQNumber);
 		}
 		else if (IRQNumber >= 32 && IRQNumber <=63)
 		{
-			*NVIC_ISER1 |= (1<<(IRQNumber%32));
+			*NVIC_ISER1 = (1 << (IRQNumber%32));
 		}
 		else if (IRQNumber >= 64 && IRQNumber <= 96)
 		{
-			*NVIC_ISER2 |= (1<<(IRQNumber%64));
+			*NVIC_ISER2 = (1 << (IRQNumber%64));
 		}
 	}
 	else
@@ -602,15 +700,15 @@ void I2C_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi)
 		if(IRQNumber <= 31)
 		{
 			// program ISER1
-			*NVIC_ICER0 |= (1<<IRQNumber);
+			*NVIC_ICER0 = (1 << IRQNumber);
 		}
 		else if (IRQNumber >= 32 && IRQNumber <=63)
 		{
-			*NVIC_ICER1 |= (1<<(IRQNumber%32));
+			*NVIC_ICER1 = (1 << (IRQNumber%32));
 		}
 		else if (IRQNumber >= 64 && IRQNumber <= 96)
 		{
-			*NVIC_ICER2 |= (1<<(IRQNumber%64));
+			*NVIC_ICER2 = (1 << (IRQNumber%64));
 		}
 	}
 
@@ -640,7 +738,7 @@ void I2C_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
 	*(NVIC_IPR_BASEADDR + (iprx))	|= (IRQPriority << shift_amount);
 }
 
-static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *pI2CHandle)
+__RAMFUNC static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *pI2CHandle)
 {
 	if(pI2CHandle->TxLen > 0)
 	{
@@ -655,7 +753,7 @@ static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *pI2CHandle)
 	}
 }
 
-static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *pI2CHandle)
+__RAMFUNC static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *pI2CHandle)
 {
 	if(pI2CHandle->TxRxState == I2C_BUSY_IN_RX)
 	{
@@ -685,7 +783,7 @@ static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *pI2CHandle)
 			// close the i2c data reception and notify the application
 			// 1. generate the stop condition
 			if(pI2CHandle->Sr == I2C_NO_SR)
-				pI2CHandle->pI2Cx->CR1 |= (1 << I2C_CR1_STOP);
+				REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
 
 			// 2. close the i2c rx
 			I2C_CloseReceiveData(pI2CHandle);
@@ -695,24 +793,24 @@ static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *pI2CHandle)
 		}
 	}
 }
-void I2C_CloseSendData(I2C_Handle_t *pI2CHandle)
+__RAMFUNC void I2C_CloseSendData(I2C_Handle_t *pI2CHandle)
 {
 	// disbale ITBUFEN Control Bit
-	pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITBUFEN);
+	REG_CLR_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITBUFEN);
 
-	pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITEVTEN);
+	REG_CLR_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITEVTEN);
 
 	pI2CHandle->TxRxState = I2C_READY;
 	pI2CHandle->pTxBuffer = NULL;
 	pI2CHandle->TxLen = 0;
 }
 
-void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle)
+__RAMFUNC void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle)
 {
 	// disbale ITBUFEN Control Bit
-	pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITBUFEN);
+	REG_CLR_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITBUFEN);
 
-	pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITEVTEN);
+	REG_CLR_BIT(pI2CHandle->pI2Cx->CR2, I2C_CR2_ITEVTEN);
 
 	pI2CHandle->TxRxState = I2C_READY;
 	pI2CHandle->pRxBuffer = NULL;
@@ -736,7 +834,7 @@ void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle)
  * @Note			-
  *
  *************************************************************************************************/
-void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
+__RAMFUNC void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 {
 	//Interrupt handling for both master and slave mode of a device
 
@@ -744,7 +842,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 
 	temp1 = pI2CHandle->pI2Cx->CR2 & ( 1 << I2C_CR2_ITEVTEN);
 	temp2 = pI2CHandle->pI2Cx->CR2 & ( 1 << I2C_CR2_ITBUFEN);
-	temp3 = pI2CHandle->pI2Cx->SR1 * ( 1 << I2C_SR1_SB);
+	temp3 = pI2CHandle->pI2Cx->SR1 & ( 1 << I2C_SR1_SB);
 
 	//1. Handle For interrupt generated by SB event
 	//	Note : SB flag is only applicable in Master mode
@@ -765,7 +863,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 		}
 	}
 
-	temp3 = pI2CHandle->pI2Cx->SR1 * ( 1 << I2C_SR1_ADDR);
+	temp3 = pI2CHandle->pI2Cx->SR1 & ( 1 << I2C_SR1_ADDR);
 	//2. Handle For interrupt generated by ADDR event
 	//Note : When master mode : Address is sent
 	//		 When Slave mode   : Address matched with own address
@@ -773,9 +871,13 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 	{
 		// ADDR flag is set
 		I2C_ClearADDRFlag(pI2CHandle);
+
+		// slave: a transfer starts, TRA in SR2 tells its direction
+		if(!(pI2CHandle->pI2Cx->SR2 & ( 1 << I2C_SR2_MSL)))
+			I2C_ApplicationEventCallback(pI2CHandle, I2C_EV_ADDR_MATCH);
 	}
 
-	temp3 = pI2CHandle->pI2Cx->SR1 * ( 1 << I2C_SR1_BTF);
+	temp3 = pI2CHandle->pI2Cx->SR1 & ( 1 << I2C_SR1_BTF);
 	//3. Handle For interrupt generated by BTF(Byte Transfer Finished) event
 	if(temp1 && temp3)
 	{
@@ -791,7 +893,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 				{
 					//1. close the transmission
 					if(pI2CHandle->Sr == I2C_NO_SR)
-						pI2CHandle->pI2Cx->CR1 |= ( 1 << I2C_CR1_STOP);
+						REG_SET_BIT(pI2CHandle->pI2Cx->CR1, I2C_CR1_STOP);
 
 					//2. Reset all the member elements of the handle structure
 					I2C_CloseSendData(pI2CHandle);
@@ -822,7 +924,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 		I2C_ApplicationEventCallback(pI2CHandle, I2C_EV_STOP);
 	}
 
-	temp3 = pI2CHandle->pI2Cx->SR1 * ( 1 << I2C_SR1_TxE);
+	temp3 = pI2CHandle->pI2Cx->SR1 & ( 1 << I2C_SR1_TxE);
 	//5. Handle For interrupt generated by TXE event
 	if(temp1 && temp2 && temp3)
 	{
@@ -843,7 +945,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 		}
 	}
 
-	temp3 = pI2CHandle->pI2Cx->SR1 * ( 1 << I2C_SR1_RxNE);
+	temp3 = pI2CHandle->pI2Cx->SR1 & ( 1 << I2C_SR1_RxNE);
 	//6. Handle For interrupt generated by RXNE event
 	if(temp1 && temp2 && temp3)
 	{
@@ -856,8 +958,8 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 		}
 		else
 		{
-			// for slave
-			if(pI2CHandle->pI2Cx->SR2 & ( 1 << I2C_SR2_TRA))
+			// for slave, in receiver mode
+			if(!(pI2CHandle->pI2Cx->SR2 & ( 1 << I2C_SR2_TRA)))
 				I2C_ApplicationEventCallback(pI2CHandle, I2C_EV_DATA_RCV);
 		}
 
@@ -878,7 +980,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
  * @Note			-
  *
  *************************************************************************************************/
-void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
+__RAMFUNC void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 {
 	uint32_t temp1,temp2;
 
@@ -893,7 +995,9 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 		//This is Bus error
 
 		//Implement the code to clear the buss error flag
-		pI2CHandle->pI2Cx->SR1 &= ~( 1 << I2C_SR1_BERR);
+		pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_BERR);
+
+		pI2CHandle->ErrCount[I2C_ERRCNT_BERR]++;
 
 		//Implement the code to notify the application about the error
 		I2C_ApplicationEventCallback(pI2CHandle,I2C_ERROR_BERR);
@@ -906,7 +1010,9 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 		//This is arbitration lost error
 
 		//Implement the code to clear the arbitration lost error flag
-		pI2CHandle->pI2Cx->SR1 &= ~( 1 << I2C_SR1_ARLO);
+		pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_ARLO);
+
+		pI2CHandle->ErrCount[I2C_ERRCNT_ARLO]++;
 
 		//Implement the code to notify the application about the error
 		I2C_ApplicationEventCallback(pI2CHandle,I2C_ERROR_ARLO);
@@ -920,7 +1026,9 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 		//This is ACK failure error
 
 		//Implement the code to clear the ACK failure error flag
-		pI2CHandle->pI2Cx->SR1 &= ~( 1 << I2C_SR1_AF);
+		pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_AF);
+
+		pI2CHandle->ErrCount[I2C_ERRCNT_AF]++;
 
 		//Implement the code to notify the application about the error
 		I2C_ApplicationEventCallback(pI2CHandle,I2C_ERROR_AF);
@@ -933,7 +1041,9 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 		//This is Overrun/underrun
 
 		//Implement the code to clear the Overrun/underrun error flag
-		pI2CHandle->pI2Cx->SR1 &= ~( 1 << I2C_SR1_OVR);
+		pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_OVR);
+
+		pI2CHandle->ErrCount[I2C_ERRCNT_OVR]++;
 
 		//Implement the code to notify the application about the error
 		I2C_ApplicationEventCallback(pI2CHandle,I2C_ERROR_OVR);
@@ -946,7 +1056,9 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 		//This is Time out error
 
 		//Implement the code to clear the Time out error flag
-		pI2CHandle->pI2Cx->SR1 &= ~( 1 << I2C_SR1_TIMEOUT);
+		pI2CHandle->pI2Cx->SR1 = ~(1 << I2C_SR1_TIMEOUT);
+
+		pI2CHandle->ErrCount[I2C_ERRCNT_TIMEOUT]++;
 
 		//Implement the code to notify the application about the error
 		I2C_ApplicationEventCallback(pI2CHandle,I2C_ERROR_TIMEOUT);
@@ -968,7 +1080,7 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
  * @Note			-
  *
  *************************************************************************************************/
-void I2C_SlaveSendData(I2C_RegDef_t *pI2Cx, uint8_t data)
+__RAMFUNC void I2C_SlaveSendData(I2C_RegDef_t *pI2Cx, uint8_t data)
 {
 	pI2Cx->DR = data;
 }
@@ -987,7 +1099,14 @@ void I2C_SlaveSendData(I2C_RegDef_t *pI2Cx, uint8_t data)
  * @Note			-
  *
  *************************************************************************************************/
-uint8_t I2C_SlaveReceiveData(I2C_RegDef_t *pI2Cx)
+__RAMFUNC uint8_t I2C_SlaveReceiveData(I2C_RegDef_t *pI2Cx)
 {
 	return (uint8_t)pI2Cx->DR;
 }
+
+__weak __RAMFUNC void I2C_ApplicationEventCallback(I2C_Handle_t *pI2CHandle, uint8_t AppEv)
+{
+	// weak implementation so that can use it
+	(void)pI2CHandle;
+	(void)AppEv;
+}
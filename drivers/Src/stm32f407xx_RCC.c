@@ -120,3 +120,34 @@ uint32_t  RCC_GetPLLOutputClock()
 
 	return 0;
 }
+
+
+/*********************************************************************
+ * @fn      		  - RCC_SetSysClkHSE
+ *
+ * @brief             - Switches SYSCLK from HSI to the HSE crystal
+ *
+ * @param[in]         - number of polls to wait for HSERDY
+ *
+ * @return            - 0 on success, 1 if HSE did not start (SYSCLK stays on HSI)
+ *
+ * @Note              - no wait states are needed up to 30MHz, the prescalers are left alone
+
+ */
+uint8_t RCC_SetSysClkHSE(uint32_t Timeout)
+{
+	RCC->CR |= (1 << RCC_CR_HSEON);
+	while(!(RCC->CR & (1 << RCC_CR_HSERDY)))
+	{
+		if(--Timeout == 0)
+		{
+			RCC->CR &= ~(1 << RCC_CR_HSEON);
+			return 1;
+		}
+	}
+
+	RCC->CFGR = (RCC->CFGR & ~(0x3 << RCC_CFGR_SW)) | (1 << RCC_CFGR_SW);
+	while(((RCC->CFGR >> RCC_CFGR_SWS) & 0x3) != 1);
+
+	return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * stm32f407xx_crc.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "stm32f407xx_crc.h"
+#include <string.h>
+
+#define CRC_DMA_FLAGS					((1 << DMA_ISR_FEIF) | (1 << DMA_ISR_DMEIF) | (1 << DMA_ISR_TEIF) |\
+										 (1 << DMA_ISR_HTIF) | (1 << DMA_ISR_TCIF))
+#define CRC_DMA_ERRORS					((1 << DMA_ISR_FEIF) | (1 << DMA_ISR_DMEIF) | (1 << DMA_ISR_TEIF))
+
+static __vo uint8_t crcDMABusy;
+
+/*************************************************************************************************
+ * @fn				- CRC_PeriClockControl
+ *
+ * @brief			- Enables or disables the clock of the CRC unit
+ *
+ * @param[in]		- ENABLE or DISABLE
+ *
+ * @return			- none
+ *
+ * @Note			- ENABLE also enables DMA2 for CRC_DMAStart(), DISABLE leaves DMA2 alone
+ *
+ *************************************************************************************************/
+void CRC_PeriClockControl(uint8_t EnorDi)
+{
+	if(EnorDi == ENABLE)
+	{
+		CRC_CLK_EN();
+		DMA2_CLK_EN();
+	}
+	else
+	{
+		CRC_CLK_DI();
+	}
+}
+
+/*************************************************************************************************
+ * @fn				- CRC_Reset
+ *
+ * @brief			- Sets DR back to 0xFFFFFFFF
+ *
+ * @return			- none
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+void CRC_Reset(void)
+{
+	CRC->CR = (1 << CRC_CR_RESET);
+}
+
+/*************************************************************************************************
+ * @fn				- CRC_Accumulate
+ *
+ * @brief			- Feeds a buffer into the CRC unit, one word per write
+ *
+ * @param[in]		- data, any alignment
+ * @param[in]		- length in bytes
+ *
+ * @return			- CRC so far
+ *
+ * @Note			- 1-3 bytes at the end are fed as a zero padded word, so only the last call of a
+ * 					  sequence may have a length which is not a multiple of 4
+ *
+ *************************************************************************************************/
+uint32_t CRC_Accumulate(const void *pData, uint32_t Len)
+{
+	const uint8_t *pByte = (const uint8_t*)pData;
+
+	// memcpy compiles to one (unaligned) LDR on the M4. One word variable per block: with a single
+	// one GCC 12 -O2 stores the last full word to DR twice
+	for(; Len >= 4; Len -= 4, pByte += 4)
+	{
+		uint32_t word;
+
+		memcpy(&word, pByte, 4);
+		CRC->DR = word;
+	}
+
+	if(Len)
+	{
+		uint32_t word = 0;
+
+		memcpy(&word, pByte, Len);
+		CRC->DR = word;
+	}
+
+	return CRC->DR;
+}
+
+/*************************************************************************************************
+ * @fn				- CRC_Calculate
+ *
+ * @brief			- CRC of a buffer
+ *
+ * @param[in]		- data, any alignment
+ * @param[in]		- length in bytes
+ *
+ * @return			- CRC
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint32_t CRC_Calculate(const void *pData, uint32_t Len)
+{
+	CRC_Reset();
+
+	return CRC_Accumulate(pData, Len);
+}
+
+/*************************************************************************************************
+ * @fn				- CRC_DMAStart
+ *
+ * @brief			- Resets the CRC unit and starts streaming a buffer into it with DMA2
+ *
+ * @param[in]		- data, word aligned and DMA reachable
+ * @param[in]		- length in bytes, multiple of 4, at most 4 * CRC_DMA_MAX_WORDS
+ *
+ * @return			- CRC_OK, CRC_BUSY or CRC_ERR_PARAM
+ *
+ * @Note			- poll CRC_DMAPoll() for the result
+ *
+ *************************************************************************************************/
+uint8_t CRC_DMAStart(const void *pData, uint32_t Len)
+{
+	DMA_Stream_RegDef_t *pStream = &CRC_DMA_CONTROLLER->Stream[CRC_DMA_STREAM];
+
+	if(crcDMABusy)
+		return CRC_BUSY;
+	if((Len == 0) || (Len & 3) || ((uintptr_t)pData & 3) || ((Len / 4) > CRC_DMA_MAX_WORDS) || !IS_DMA_ADDR(pData))
+		return CRC_ERR_PARAM;
+
+	// 1. Stream off, stale flags cleared
+	pStream->CR &= ~(1 << DMA_SXCR_EN);
+	while(pStream->CR & (1 << DMA_SXCR_EN));
+	CRC_DMA_CONTROLLER->LIFCR = (CRC_DMA_FLAGS << CRC_DMA_ISR_SHIFT);
+
+	CRC_Reset();
+
+	// 2. Memory to memory: PAR is the source (incremented), M0AR the destination (DR, fixed). Words
+	pStream->PAR = (uint32_t)(uintptr_t)pData;
+	pStream->M0AR = (uint32_t)(uintptr_t)&CRC->DR;
+	pStream->NDTR = Len / 4;
+
+	// 3. M2M does not work in direct mode, the FIFO is used
+	pStream->FCR = (1 << DMA_SXFCR_DMDIS) | (3 << DMA_SXFCR_FTH);
+	pStream->CR = (2 << DMA_SXCR_DIR) | (1 << DMA_SXCR_PINC) | (2 << DMA_SXCR_PSIZE) | (2 << DMA_SXCR_MSIZE);
+
+	crcDMABusy = 1;
+	pStream->CR |= (1 << DMA_SXCR_EN);
+
+	return CRC_OK;
+}
+
+/*************************************************************************************************
+ * @fn				- CRC_DMAPoll
+ *
+ * @brief			- Checks whether the DMA started by CRC_DMAStart() is done
+ *
+ * @param[out]		- CRC, written when CRC_OK is returned
+ *
+ * @return			- CRC_OK, CRC_BUSY, CRC_ERR_DMA or CRC_ERR_PARAM (no DMA started)
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint8_t CRC_DMAPoll(uint32_t *pCrc)
+{
+	uint32_t flags;
+
+	if(!crcDMABusy)
+		return CRC_ERR_PARAM;
+
+	flags = (CRC_DMA_CONTROLLER->LISR >> CRC_DMA_ISR_SHIFT) & CRC_DMA_FLAGS;
+
+	if(flags & CRC_DMA_ERRORS)
+	{
+		CRC_DMA_CONTROLLER->Stream[CRC_DMA_STREAM].CR &= ~(1 << DMA_SXCR_EN);
+		CRC_DMA_CONTROLLER->LIFCR = (CRC_DMA_FLAGS << CRC_DMA_ISR_SHIFT);
+		crcDMABusy = 0;
+		return CRC_ERR_DMA;
+	}
+
+	if(!(flags & (1 << DMA_ISR_TCIF)))
+		return CRC_BUSY;
+
+	CRC_DMA_CONTROLLER->LIFCR = (CRC_DMA_FLAGS << CRC_DMA_ISR_SHIFT);
+	crcDMABusy = 0;
+	*pCrc = CRC->DR;
+
+	return CRC_OK;
+}
+
+/*************************************************************************************************
+ * @fn				- CRC_DMAIsBusy
+ *
+ * @brief			- Tells whether a DMA owns the CRC unit
+ *
+ * @return			- 1 while a DMA runs or its result was not polled yet
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint8_t CRC_DMAIsBusy(void)
+{
+	return crcDMABusy;
+}
@@ -0,0 +1,244 @@
+/*
+ * stm32f407xx_flash.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "stm32f407xx_flash.h"
+
+static uint8_t FLASH_WaitDone(void);
+static void FLASH_FlushDataCache(void);
+
+/*
+ * Helper functions
+ */
+static uint8_t FLASH_WaitDone(void)
+{
+	uint32_t sr;
+
+	while(FLASH->SR & (1 << FLASH_SR_BSY));
+
+	// EOP and the error flags are cleared by writing 1
+	sr = FLASH->SR;
+	FLASH->SR = sr & (FLASH_SR_ERRORS | (1 << FLASH_SR_EOP));
+
+	if(sr & (1 << FLASH_SR_WRPERR))
+		return FLASH_ERR_WRP;
+	if(sr & ((1 << FLASH_SR_PGAERR) | (1 << FLASH_SR_PGPERR) | (1 << FLASH_SR_PGSERR)))
+		return FLASH_ERR_PROG;
+	if(sr & (1 << FLASH_SR_OPERR))
+		return FLASH_ERR_OP;
+
+	return FLASH_OK;
+}
+
+static void FLASH_FlushDataCache(void)
+{
+	// the data cache may still hold the old contents of an erased sector. Reset only works with DCEN = 0
+	if(FLASH->ACR & (1 << FLASH_ACR_DCEN))
+	{
+		FLASH->ACR &= ~(1 << FLASH_ACR_DCEN);
+		FLASH->ACR |= (1 << FLASH_ACR_DCRST);
+		FLASH->ACR &= ~(1 << FLASH_ACR_DCRST);
+		FLASH->ACR |= (1 << FLASH_ACR_DCEN);
+	}
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_Unlock
+ *
+ * @brief			- Unlocks the flash control register
+ *
+ * @return			- none
+ *
+ * @Note			- A wrong key sequence locks CR till the next reset
+ *
+ *************************************************************************************************/
+void FLASH_Unlock(void)
+{
+	if(FLASH->CR & (1UL << FLASH_CR_LOCK))
+	{
+		FLASH->KEYR = FLASH_KEY1;
+		FLASH->KEYR = FLASH_KEY2;
+	}
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_Lock
+ *
+ * @brief			- Locks the flash control register
+ *
+ * @return			- none
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+void FLASH_Lock(void)
+{
+	FLASH->CR |= (1UL << FLASH_CR_LOCK);
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_EraseSector
+ *
+ * @brief			- Erases one sector (all bits to 1)
+ *
+ * @param[in]		- sector number, 0 to FLASH_NO_OF_SECTORS - 1
+ * @param[in]		- @FLASH_VOLTAGE_RANGE, sets the erase parallelism
+ *
+ * @return			- FLASH_OK or FLASH_ERR_xxx
+ *
+ * @Note			- Blocking. Flash reads (code, vector table) stall while the sector is erased,
+ * 					  up to 2s for a 128KB sector at x32. The flash must be unlocked
+ *
+ *************************************************************************************************/
+uint8_t FLASH_EraseSector(uint8_t Sector, uint8_t VoltageRange)
+{
+	uint8_t status;
+
+	if((Sector >= FLASH_NO_OF_SECTORS) || (VoltageRange > FLASH_VOLTAGE_RANGE_4))
+		return FLASH_ERR_PARAM;
+
+	// 1. Wait for a previous operation to finish
+	while(FLASH->SR & (1 << FLASH_SR_BSY));
+
+	// 2. Sector erase, sector number and parallelism (PSIZE follows the voltage range)
+	FLASH->CR &= ~((0x3 << FLASH_CR_PSIZE) | (0xF << FLASH_CR_SNB) | (1 << FLASH_CR_PG));
+	FLASH->CR |= (VoltageRange << FLASH_CR_PSIZE) | (Sector << FLASH_CR_SNB) | (1 << FLASH_CR_SER);
+
+	// 3. Start and wait
+	FLASH->CR |= (1 << FLASH_CR_STRT);
+	status = FLASH_WaitDone();
+
+	FLASH->CR &= ~((1 << FLASH_CR_SER) | (0xF << FLASH_CR_SNB));
+	FLASH_FlushDataCache();
+
+	return status;
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_Program
+ *
+ * @brief			- Programs data into erased flash
+ *
+ * @param[in]		- flash address, aligned to the program unit
+ * @param[in]		- data
+ * @param[in]		- length in bytes, multiple of the program unit
+ * @param[in]		- @FLASH_VOLTAGE_RANGE
+ *
+ * @return			- FLASH_OK or FLASH_ERR_xxx. Stops at the first failing unit
+ *
+ * @Note			- The program unit is 1, 2 or 4 bytes for voltage range 1, 2 or 3. Range 4 programs
+ * 					  words too (x64 only pays off for erase). Bits can only go from 1 to 0, program
+ * 					  erased locations only. The flash must be unlocked
+ *
+ *************************************************************************************************/
+uint8_t FLASH_Program(uint32_t Address, const void *pData, uint32_t Len, uint8_t VoltageRange)
+{
+	uint8_t psize = (VoltageRange >= FLASH_VOLTAGE_RANGE_3) ? FLASH_PSIZE_X32 : VoltageRange;
+	uint32_t unit = 1UL << psize;
+	const uint8_t *pByte = (const uint8_t*)pData;
+	uint8_t status = FLASH_OK;
+
+	if((VoltageRange > FLASH_VOLTAGE_RANGE_4) || (Address & (unit - 1)) || (Len & (unit - 1)) ||
+	   (Address < FLASH_BASEADDR) || (Address + Len > FLASH_END_ADDR))
+		return FLASH_ERR_PARAM;
+
+	while(FLASH->SR & (1 << FLASH_SR_BSY));
+
+	FLASH->CR &= ~((0x3 << FLASH_CR_PSIZE) | (1 << FLASH_CR_SER));
+	FLASH->CR |= (psize << FLASH_CR_PSIZE) | (1 << FLASH_CR_PG);
+
+	for(uint32_t i = 0; (i < Len) && (status == FLASH_OK); i += unit)
+	{
+		// one access of the program size per unit, the source may be unaligned
+		if(psize == FLASH_PSIZE_X32)
+			*(__vo uint32_t*)(uintptr_t)(Address + i) = (uint32_t)pByte[i] | ((uint32_t)pByte[i + 1] << 8) |
+														((uint32_t)pByte[i + 2] << 16) | ((uint32_t)pByte[i + 3] << 24);
+		else if(psize == FLASH_PSIZE_X16)
+			*(__vo uint16_t*)(uintptr_t)(Address + i) = (uint16_t)(pByte[i] | (pByte[i + 1] << 8));
+		else
+			*(__vo uint8_t*)(uintptr_t)(Address + i) = pByte[i];
+
+		status = FLASH_WaitDone();
+	}
+
+	FLASH->CR &= ~(1 << FLASH_CR_PG);
+
+	return status;
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_GetSector
+ *
+ * @brief			- Returns the sector holding an address
+ *
+ * @param[in]		- flash address
+ *
+ * @return			- sector number, 0xFF if the address is not in the flash
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint8_t FLASH_GetSector(uint32_t Address)
+{
+	uint32_t offset = Address - FLASH_BASEADDR;
+
+	if((Address < FLASH_BASEADDR) || (Address >= FLASH_END_ADDR))
+		return 0xFF;
+	if(offset < 0x10000)
+		return offset / 0x4000;
+	if(offset < 0x20000)
+		return 4;
+
+	return 5 + ((offset - 0x20000) / 0x20000);
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_GetSectorAddr
+ *
+ * @brief			- Returns the start address of a sector
+ *
+ * @param[in]		- sector number
+ *
+ * @return			- address, 0 for a bad sector number
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint32_t FLASH_GetSectorAddr(uint8_t Sector)
+{
+	if(Sector >= FLASH_NO_OF_SECTORS)
+		return 0;
+	if(Sector < 4)
+		return FLASH_BASEADDR + (Sector * 0x4000UL);
+	if(Sector == 4)
+		return FLASH_BASEADDR + 0x10000UL;
+
+	return FLASH_BASEADDR + 0x20000UL + ((Sector - 5) * 0x20000UL);
+}
+
+/*************************************************************************************************
+ * @fn				- FLASH_GetSectorSize
+ *
+ * @brief			- Returns the size of a sector
+ *
+ * @param[in]		- sector number
+ *
+ * @return			- size in bytes, 0 for a bad sector number
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint32_t FLASH_GetSectorSize(uint8_t Sector)
+{
+	if(Sector >= FLASH_NO_OF_SECTORS)
+		return 0;
+	if(Sector < 4)
+		return 0x4000UL;
+	if(Sector == 4)
+		return 0x10000UL;
+
+	return 0x20000UL;
+}
@@ -146,21 +146,21 @@ void GPIO_Init(GPIO_Handle_t *pGPIOHandle)
 		{
 			// 1. Configure the FTSR
 			// first we clear the corresponding RTSR bit so that we only have FTSR
-			EXTI->RTSR &= ~(1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
-			EXTI->FTSR |= (1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
+			REG_CLR_BIT(EXTI->RTSR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
+			REG_SET_BIT(EXTI->FTSR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
 		}
 		else if(pGPIOHandle->GPIO_PinConfig.GPIO_PinMode == GPIO_MODE_IT_RT)
 		{
 			// 1. Configure the RTSR
 			// first we clear the corresponding FTSR bit so that we only have RTSR
-			EXTI->FTSR &= ~(1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
-			EXTI->RTSR |= (1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
+			REG_CLR_BIT(EXTI->FTSR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
+			REG_SET_BIT(EXTI->RTSR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
 		}
 		else if(pGPIOHandle->GPIO_PinConfig.GPIO_PinMode == GPIO_MODE_IT_RFT)
 		{
 			// 1. Configure both FTSR and RTSR
-			EXTI->FTSR |= (1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
-			EXTI->RTSR |= (1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
+			REG_SET_BIT(EXTI->FTSR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
+			REG_SET_BIT(EXTI->RTSR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
 		}
 
 		// 2. configure the GPIO port selection in SYSCFG_EXTICR
@@ -168,10 +168,11 @@ void GPIO_Init(GPIO_Handle_t *pGPIOHandle)
 		temp = (pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber/4);
 		uint8_t portcode = GPIO_BASEADDR_TO_CODE(pGPIOHandle->pGPIOx);
 		SYSCFG_CLK_EN();
-		SYSCFG->EXTICR[temp] |= (portcode << (4*(pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber)%4));
+		SYSCFG->EXTICR[temp] &= ~(0xF << (4*(pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber%4)));
+		SYSCFG->EXTICR[temp] |= (portcode << (4*(pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber%4)));
 
 		// 3. Enable the EXTI interrupt delivery using IMR
-		EXTI->IMR |= 1 << pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber;
+		REG_SET_BIT(EXTI->IMR, pGPIOHandle->GPIO_PinConfig.GPIO_PinNumber);
 
 	}
 
@@ -228,48 +229,48 @@ void GPIO_DeInit(GPIO_RegDef_t *pGPIOx)
 {
 	if(pGPIOx == GPIOA)
 	{
-		RCC->AHB1RSTR |= (1 << 0);
-		RCC->AHB1RSTR &= ~(1 << 0);
+		REG_SET_BIT(RCC->AHB1RSTR, 0);
+		REG_CLR_BIT(RCC->AHB1RSTR, 0);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 1);
-		RCC->AHB1RSTR &= ~(1 << 1);
+		REG_SET_BIT(RCC->AHB1RSTR, 1);
+		REG_CLR_BIT(RCC->AHB1RSTR, 1);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 2);
-		RCC->AHB1RSTR &= ~(1 << 2);
+		REG_SET_BIT(RCC->AHB1RSTR, 2);
+		REG_CLR_BIT(RCC->AHB1RSTR, 2);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 3);
-		RCC->AHB1RSTR &= ~(1 << 3);
+		REG_SET_BIT(RCC->AHB1RSTR, 3);
+		REG_CLR_BIT(RCC->AHB1RSTR, 3);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 4);
-		RCC->AHB1RSTR &= ~(1 << 4);
+		REG_SET_BIT(RCC->AHB1RSTR, 4);
+		REG_CLR_BIT(RCC->AHB1RSTR, 4);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 5);
-		RCC->AHB1RSTR &= ~(1 << 5);
+		REG_SET_BIT(RCC->AHB1RSTR, 5);
+		REG_CLR_BIT(RCC->AHB1RSTR, 5);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 6);
-		RCC->AHB1RSTR &= ~(1 << 6);
+		REG_SET_BIT(RCC->AHB1RSTR, 6);
+		REG_CLR_BIT(RCC->AHB1RSTR, 6);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 7);
-		RCC->AHB1RSTR &= ~(1 << 7);
+		REG_SET_BIT(RCC->AHB1RSTR, 7);
+		REG_CLR_BIT(RCC->AHB1RSTR, 7);
 	}
 	else if(pGPIOx == GPIOB)
 	{
-		RCC->AHB1RSTR |= (1 << 8);
-		RCC->AHB1RSTR &= ~(1 << 8);
+		REG_SET_BIT(RCC->AHB1RSTR, 8);
+		REG_CLR_BIT(RCC->AHB1RSTR, 8);
 	}
 }
 
@@ -334,15 +335,14 @@ uint16_t GPIO_ReadPort(GPIO_RegDef_t *pGPIOx)
  *************************************************************************************************/
 void GPIO_WritePin(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber, uint8_t value)
 {
-	if(value == GPIO_PIN_RESET)
+	// BSRR sets (low half) or resets (high half) the pin in one store, other pins are not touched
+	if(value == GPIO_PIN_SET)
 	{
-		// write 1 to the output data register at the bit filed corresponding to the pin number
-		pGPIOx->ODR |= (1 << PinNumber);
+		pGPIOx->BSSR = (1 << PinNumber);
 	}
 	else
 	{
-		// write 0
-		pGPIOx->ODR &= ~(1<<PinNumber);
+		pGPIOx->BSSR = (1 << (PinNumber + 16));
 	}
 }
 
@@ -368,20 +368,22 @@ void GPIO_WritePort(GPIO_RegDef_t *pGPIOx, uint16_t value)
 /*************************************************************************************************
  * @fn				- GPIO_TogglePinOutput
  *
- * @brief			-
+ * @brief			- Inverts the output level of a pin
  *
- * @param[in]		-
- * @param[in]		-
+ * @param[in]		- Base address of the GPIO port
+ * @param[in]		- Pin number
  * @param[in[		-
  *
- * @return			-
+ * @return			- none
  *
- * @Note			-
+ * @Note			- One store to the bit-band alias of the ODR bit, other pins changed meanwhile (thread
+ * 					  or ISR) are never written back. Toggling the same pin from thread and ISR code
+ * 					  still races (read then store): keep a pin's toggles in one context
  *
  *************************************************************************************************/
 void GPIO_TogglePinOutput(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber)
 {
-	pGPIOx->ODR ^= (1<<PinNumber);
+	REG_TOGGLE_BIT(pGPIOx->ODR, PinNumber);
 }
 
 /*
@@ -433,15 +435,15 @@ void GPIO_IRQITConfig(uint8_t IRQNumber, uint8_t EnorDi)
 		if(IRQNumber <= 31)
 		{
 			// program ISER1
-			*NVIC_ISER0 |= (1<<IRQNumber);
+			*NVIC_ISER0 = (1 << IRQNumber);
 		}
 		else if (IRQNumber >= 32 && IRQNumber <=63)
 		{
-			*NVIC_ISER1 |= (1<<(IRQNumber%32));
+			*NVIC_ISER1 = (1 << (IRQNumber%32));
 		}
 		else if (IRQNumber >= 64 && IRQNumber <= 96)
 		{
-			*NVIC_ISER2 |= (1<<(IRQNumber%64));
+			*NVIC_ISER2 = (1 << (IRQNumber%64));
 		}
 	}
 	else
@@ -449,15 +451,15 @@ void GPIO_IRQITConfig(uint8_t IRQNumber, uint8_t EnorDi)
 		if(IRQNumber <= 31)
 		{
 			// program ISER1
-			*NVIC_ICER0 |= (1<<IRQNumber);
+			*NVIC_ICER0 = (1 << IRQNumber);
 		}
 		else if (IRQNumber >= 32 && IRQNumber <=63)
 		{
-			*NVIC_ICER1 |= (1<<(IRQNumber%32));
+			*NVIC_ICER1 = (1 << (IRQNumber%32));
 		}
 		else if (IRQNumber >= 64 && IRQNumber <= 96)
 		{
-			*NVIC_ICER2 |= (1<<(IRQNumber%64));
+			*NVIC_ICER2 = (1 << (IRQNumber%64));
 		}
 	}
 }
@@ -476,13 +478,14 @@ void GPIO_IRQITConfig(uint8_t IRQNumber, uint8_t EnorDi)
  * @Note			-
  *
  *************************************************************************************************/
-void GPIO_IRQHandling(uint8_t PinNumber)
+__RAMFUNC void GPIO_IRQHandling(uint8_t PinNumber)
 {
 	// clear the EXTI PR register corresponding to the pin number
 	if(EXTI->PR & (1<<PinNumber))
 	{
-		// the interrupt is pended so we clear the register bit
-		EXTI->PR |= (1 << PinNumber);
+		// the interrupt is pended so we clear the register bit. PR is write 1 to clear, a read modify
+		// write would clear the other pending lines too
+		EXTI->PR = (1 << PinNumber);
 	}
 }
 
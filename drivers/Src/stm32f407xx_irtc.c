@@ -0,0 +1,437 @@
+/*
+ * stm32f407xx_irtc.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "stm32f407xx_irtc.h"
+
+/*
+ * ISR flags are rc_w0 and INIT is rw. Writing 1 to a flag leaves it alone, so a write with all other bits
+ * set clears one flag without a read-modify-write race against the hardware
+ */
+#define IRTC_ISR_CLEAR(bit)				(IRTC->ISR = ~((1U << (bit)) | (1U << IRTC_ISR_INIT)))
+
+static uint8_t IRTC_StartClock(uint8_t ClockSource);
+static uint8_t IRTC_EnterInit(void);
+static void IRTC_ExitInit(void);
+static uint8_t IRTC_ToBCD(uint8_t Value);
+static uint8_t IRTC_FromBCD(uint8_t Value);
+
+/*
+ * Helper functions
+ */
+static uint8_t IRTC_StartClock(uint8_t ClockSource)
+{
+	uint32_t timeout = IRTC_LSE_TIMEOUT;
+
+	if(ClockSource == IRTC_CLOCK_LSE)
+	{
+		RCC->BDCR |= (1 << RCC_BDCR_LSEON);
+		while(!(RCC->BDCR & (1 << RCC_BDCR_LSERDY)))
+		{
+			if(--timeout == 0)
+			{
+				// no crystal, the oscillator is switched off again
+				RCC->BDCR &= ~(1 << RCC_BDCR_LSEON);
+				return IRTC_ERR_CLOCK;
+			}
+		}
+	}
+	else
+	{
+		RCC->CSR |= (1 << RCC_CSR_LSION);
+		while(!(RCC->CSR & (1 << RCC_CSR_LSIRDY)))
+		{
+			if(--timeout == 0)
+				return IRTC_ERR_CLOCK;
+		}
+	}
+
+	return IRTC_OK;
+}
+
+static uint8_t IRTC_EnterInit(void)
+{
+	uint32_t timeout = IRTC_TIMEOUT;
+
+	if(IRTC->ISR & (1 << IRTC_ISR_INITF))
+		return IRTC_OK;
+
+	// sets INIT, the flags ignore the 1s
+	IRTC->ISR = 0xFFFFFFFF;
+	while(!(IRTC->ISR & (1 << IRTC_ISR_INITF)))
+	{
+		if(--timeout == 0)
+		{
+			IRTC_ExitInit();
+			return IRTC_ERR_TIMEOUT;
+		}
+	}
+
+	return IRTC_OK;
+}
+
+static void IRTC_ExitInit(void)
+{
+	IRTC->ISR = ~(1U << IRTC_ISR_INIT);
+}
+
+static uint8_t IRTC_ToBCD(uint8_t Value)
+{
+	return (uint8_t)(((Value / 10) << 4) | (Value % 10));
+}
+
+static uint8_t IRTC_FromBCD(uint8_t Value)
+{
+	return (uint8_t)(((Value >> 4) * 10) + (Value & 0x0F));
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_Init
+ *
+ * @brief			- Enables backup domain access and starts the RTC clock and calendar
+ *
+ * @param[in]		- IRTC handle with IRTC_Config filled in
+ *
+ * @return			- IRTC_OK, IRTC_ERR_CLOCK or IRTC_ERR_TIMEOUT
+ *
+ * @Note			- a calendar that is already running from the configured clock is left untouched. The
+ * 					  backup domain is only reset once the new clock runs
+ *
+ *************************************************************************************************/
+uint8_t IRTC_Init(IRTC_Handle_t *pIRTCHandle)
+{
+	uint8_t clockSource = pIRTCHandle->IRTC_Config.ClockSource;
+	uint32_t rtcSel = (RCC->BDCR >> RCC_BDCR_RTCSEL) & 0x3;
+	uint8_t ret;
+
+	pIRTCHandle->TimeLost = 0;
+	pIRTCHandle->Wakeups = 0;
+
+	if((clockSource != IRTC_CLOCK_LSE) && (clockSource != IRTC_CLOCK_LSI))
+		return IRTC_ERR_PARAM;
+
+	// 1. Backup domain write access
+	PWR_CLK_EN();
+	PWR->CR |= (1 << PWR_CR_DBP);
+
+	// 2. Running calendar, only LSI needs a restart (it is outside the backup domain)
+	if((RCC->BDCR & (1 << RCC_BDCR_RTCEN)) && (rtcSel == clockSource) && (IRTC->ISR & (1 << IRTC_ISR_INITS)))
+	{
+		if(clockSource == IRTC_CLOCK_LSI)
+		{
+			ret = IRTC_StartClock(clockSource);
+			if(ret != IRTC_OK)
+				return ret;
+		}
+		return IRTC_WaitForSynchro();
+	}
+
+	pIRTCHandle->TimeLost = 1;
+
+	// 3. The new clock first, a crystal which is not fitted must not cost the calendar of the other clock
+	ret = IRTC_StartClock(clockSource);
+	if(ret != IRTC_OK)
+		return ret;
+
+	// 4. RTCSEL can only be written once, another source needs a backup domain reset. It stops LSE
+	if((rtcSel != 0) && (rtcSel != clockSource))
+	{
+		RCC->BDCR |= (1 << RCC_BDCR_BDRST);
+		RCC->BDCR &= ~(1 << RCC_BDCR_BDRST);
+
+		ret = IRTC_StartClock(clockSource);
+		if(ret != IRTC_OK)
+			return ret;
+	}
+
+	RCC->BDCR |= ((uint32_t)clockSource << RCC_BDCR_RTCSEL) | (1 << RCC_BDCR_RTCEN);
+
+	// 5. Prescalers and 24h format, in init mode behind the key lock
+	IRTC->WPR = IRTC_WPR_KEY1;
+	IRTC->WPR = IRTC_WPR_KEY2;
+
+	ret = IRTC_EnterInit();
+	if(ret == IRTC_OK)
+	{
+		// two separate writes, synchronous prescaler first
+		if(clockSource == IRTC_CLOCK_LSE)
+		{
+			IRTC->PRER = (IRTC_LSE_PREDIV_S << IRTC_PRER_PREDIV_S);
+			IRTC->PRER |= (IRTC_LSE_PREDIV_A << IRTC_PRER_PREDIV_A);
+		}
+		else
+		{
+			IRTC->PRER = (IRTC_LSI_PREDIV_S << IRTC_PRER_PREDIV_S);
+			IRTC->PRER |= (IRTC_LSI_PREDIV_A << IRTC_PRER_PREDIV_A);
+		}
+		IRTC->CR &= ~((1 << IRTC_CR_FMT) | (1 << IRTC_CR_BYPSHAD));
+		IRTC_ExitInit();
+	}
+
+	IRTC->WPR = IRTC_WPR_LOCK;
+
+	if(ret != IRTC_OK)
+		return ret;
+
+	return IRTC_WaitForSynchro();
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_IsTimeLost
+ *
+ * @brief			- Tells if the calendar was not running at init
+ *
+ * @param[in]		- IRTC handle
+ *
+ * @return			- 1 until the time is set, 0 otherwise
+ *
+ * @Note			- none
+ *
+ *************************************************************************************************/
+uint8_t IRTC_IsTimeLost(IRTC_Handle_t *pIRTCHandle)
+{
+	return pIRTCHandle->TimeLost;
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_GetDateTime
+ *
+ * @brief			- Reads the calendar from the shadow registers
+ *
+ * @param[in]		- IRTC handle
+ * @param[out]		- date and time
+ *
+ * @return			- IRTC_OK
+ *
+ * @Note			- no bus traffic, a few APB1 reads. After a wakeup from Stop call
+ * 					  IRTC_WaitForSynchro() first
+ *
+ *************************************************************************************************/
+uint8_t IRTC_GetDateTime(IRTC_Handle_t *pIRTCHandle, IRTC_DateTime_t *pDateTime)
+{
+	(void)pIRTCHandle;
+
+	// TR locks the shadow DR until DR is read, the pair is consistent
+	uint32_t tr = IRTC->TR;
+	uint32_t dr = IRTC->DR;
+
+	pDateTime->Seconds = IRTC_FromBCD((tr >> IRTC_TR_SU) & 0x7F);
+	pDateTime->Minutes = IRTC_FromBCD((tr >> IRTC_TR_MNU) & 0x7F);
+	pDateTime->Hours = IRTC_FromBCD((tr >> IRTC_TR_HU) & 0x3F);
+	pDateTime->Date = IRTC_FromBCD((dr >> IRTC_DR_DU) & 0x3F);
+	pDateTime->Month = IRTC_FromBCD((dr >> IRTC_DR_MU) & 0x1F);
+	pDateTime->WeekDay = (dr >> IRTC_DR_WDU) & 0x7;
+	pDateTime->Year = IRTC_FromBCD((dr >> IRTC_DR_YU) & 0xFF);
+
+	return IRTC_OK;
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_SetDateTime
+ *
+ * @brief			- Loads a new date and time into the calendar
+ *
+ * @param[in]		- IRTC handle
+ * @param[in]		- date and time, 24h
+ *
+ * @return			- IRTC_OK, IRTC_ERR_PARAM or IRTC_ERR_TIMEOUT
+ *
+ * @Note			- the prescalers restart, the calendar counts the first second from the return
+ * 					  of this function
+ *
+ *************************************************************************************************/
+uint8_t IRTC_SetDateTime(IRTC_Handle_t *pIRTCHandle, const IRTC_DateTime_t *pDateTime)
+{
+	uint32_t tr, dr;
+	uint8_t ret;
+
+	if((pDateTime->Seconds > 59) || (pDateTime->Minutes > 59) || (pDateTime->Hours > 23) ||
+	   (pDateTime->WeekDay < 1) || (pDateTime->WeekDay > 7) || (pDateTime->Date < 1) || (pDateTime->Date > 31) ||
+	   (pDateTime->Month < 1) || (pDateTime->Month > 12) || (pDateTime->Year > 99))
+		return IRTC_ERR_PARAM;
+
+	tr = ((uint32_t)IRTC_ToBCD(pDateTime->Seconds) << IRTC_TR_SU) |
+		 ((uint32_t)IRTC_ToBCD(pDateTime->Minutes) << IRTC_TR_MNU) |
+		 ((uint32_t)IRTC_ToBCD(pDateTime->Hours) << IRTC_TR_HU);
+	dr = ((uint32_t)IRTC_ToBCD(pDateTime->Date) << IRTC_DR_DU) |
+		 ((uint32_t)IRTC_ToBCD(pDateTime->Month) << IRTC_DR_MU) |
+		 ((uint32_t)pDateTime->WeekDay << IRTC_DR_WDU) |
+		 ((uint32_t)IRTC_ToBCD(pDateTime->Year) << IRTC_DR_YU);
+
+	IRTC->WPR = IRTC_WPR_KEY1;
+	IRTC->WPR = IRTC_WPR_KEY2;
+
+	ret = IRTC_EnterInit();
+	if(ret == IRTC_OK)
+	{
+		IRTC->TR = tr;
+		IRTC->DR = dr;
+		IRTC_ExitInit();
+	}
+
+	IRTC->WPR = IRTC_WPR_LOCK;
+
+	if(ret != IRTC_OK)
+		return ret;
+
+	pIRTCHandle->TimeLost = 0;
+
+	// the shadow registers still hold the old time until the next copy
+	return IRTC_WaitForSynchro();
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_WaitForSynchro
+ *
+ * @brief			- Waits for a fresh copy of the calendar in the shadow registers
+ *
+ * @return			- IRTC_OK or IRTC_ERR_TIMEOUT
+ *
+ * @Note			- up to 2 RTCCLK cycles (61us on LSE)
+ *
+ *************************************************************************************************/
+uint8_t IRTC_WaitForSynchro(void)
+{
+	uint32_t timeout = IRTC_TIMEOUT;
+
+	IRTC->WPR = IRTC_WPR_KEY1;
+	IRTC->WPR = IRTC_WPR_KEY2;
+	IRTC_ISR_CLEAR(IRTC_ISR_RSF);
+	IRTC->WPR = IRTC_WPR_LOCK;
+
+	while(!(IRTC->ISR & (1 << IRTC_ISR_RSF)))
+	{
+		if(--timeout == 0)
+			return IRTC_ERR_TIMEOUT;
+	}
+
+	return IRTC_OK;
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_SetWakeup
+ *
+ * @brief			- Starts the periodic wakeup timer
+ *
+ * @param[in]		- IRTC handle
+ * @param[in]		- period in seconds, 1 to IRTC_WAKEUP_MAX, 0 stops the timer
+ *
+ * @return			- IRTC_OK, IRTC_ERR_PARAM or IRTC_ERR_TIMEOUT
+ *
+ * @Note			- enables EXTI line 22 and IRQ_RTC_WKUP
+ *
+ *************************************************************************************************/
+uint8_t IRTC_SetWakeup(IRTC_Handle_t *pIRTCHandle, uint32_t Seconds)
+{
+	uint32_t timeout = IRTC_TIMEOUT;
+
+	if(Seconds > IRTC_WAKEUP_MAX)
+		return IRTC_ERR_PARAM;
+
+	// 1. Stop the timer, WUTR is writable once WUTWF is set
+	IRTC->WPR = IRTC_WPR_KEY1;
+	IRTC->WPR = IRTC_WPR_KEY2;
+	IRTC->CR &= ~((1 << IRTC_CR_WUTE) | (1 << IRTC_CR_WUTIE));
+	IRTC_ISR_CLEAR(IRTC_ISR_WUTF);
+
+	if(Seconds == 0)
+	{
+		IRTC->WPR = IRTC_WPR_LOCK;
+		EXTI->IMR &= ~(1 << IRTC_EXTI_LINE);
+		GPIO_IRQITConfig(IRQ_RTC_WKUP, DISABLE);
+		return IRTC_OK;
+	}
+
+	while(!(IRTC->ISR & (1 << IRTC_ISR_WUTWF)))
+	{
+		if(--timeout == 0)
+		{
+			IRTC->WPR = IRTC_WPR_LOCK;
+			return IRTC_ERR_TIMEOUT;
+		}
+	}
+
+	// 2. ck_spre, the period is WUT + 1 seconds
+	IRTC->WUTR = Seconds - 1;
+	IRTC->CR = (IRTC->CR & ~(0x7 << IRTC_CR_WUCKSEL)) | (IRTC_WUCKSEL_CK_SPRE << IRTC_CR_WUCKSEL) |
+			   (1 << IRTC_CR_WUTE) | (1 << IRTC_CR_WUTIE);
+	IRTC->WPR = IRTC_WPR_LOCK;
+
+	// 3. EXTI line 22 rising edge to the NVIC
+	EXTI->FTSR &= ~(1 << IRTC_EXTI_LINE);
+	EXTI->RTSR |= (1 << IRTC_EXTI_LINE);
+	EXTI->PR = (1 << IRTC_EXTI_LINE);
+	EXTI->IMR |= (1 << IRTC_EXTI_LINE);
+	GPIO_IRQPriorityConfig(IRQ_RTC_WKUP, pIRTCHandle->IRTC_Config.WakeupIRQPriority);
+	GPIO_IRQITConfig(IRQ_RTC_WKUP, ENABLE);
+
+	return IRTC_OK;
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_IRQHandling
+ *
+ * @brief			- Clears the wakeup timer event
+ *
+ * @param[in]		- IRTC handle
+ *
+ * @return			- none
+ *
+ * @Note			- call from RTC_WKUP_IRQHandler, the RTC flag before the EXTI pending bit or
+ * 					  the line triggers again
+ *
+ *************************************************************************************************/
+__RAMFUNC void IRTC_IRQHandling(IRTC_Handle_t *pIRTCHandle)
+{
+	if(IRTC->ISR & (1 << IRTC_ISR_WUTF))
+	{
+		IRTC_ISR_CLEAR(IRTC_ISR_WUTF);
+		pIRTCHandle->Wakeups++;
+	}
+
+	EXTI->PR = (1 << IRTC_EXTI_LINE);
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_ReadBackup
+ *
+ * @brief			- Reads a backup register
+ *
+ * @param[in]		- register 0 to IRTC_NO_OF_BKP - 1
+ *
+ * @return			- value, 0 for an index out of range
+ *
+ * @Note			- the registers survive a reset and run on VBAT, a backup domain reset clears them
+ *
+ *************************************************************************************************/
+uint32_t IRTC_ReadBackup(uint8_t Index)
+{
+	if(Index >= IRTC_NO_OF_BKP)
+		return 0;
+
+	return IRTC->BKPR[Index];
+}
+
+/*************************************************************************************************
+ * @fn				- IRTC_WriteBackup
+ *
+ * @brief			- Writes a backup register
+ *
+ * @param[in]		- register 0 to IRTC_NO_OF_BKP - 1
+ * @param[in]		- value
+ *
+ * @return			- none
+ *
+ * @Note			- needs IRTC_Init() for the DBP bit, an index out of range is ignored
+ *
+ *************************************************************************************************/
+void IRTC_WriteBackup(uint8_t Index, uint32_t Value)
+{
+	if(Index >= IRTC_NO_OF_BKP)
+		return;
+
+	IRTC->BKPR[Index] = Value;
+}
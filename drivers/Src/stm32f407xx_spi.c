@@ -33,11 +33,11 @@ void SPI_SSIConfig(SPI_RegDef_t *pSPIx, uint8_t EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		SPI2->CR1 |= (1 << SPI_CR1_SSI);
+		REG_SET_BIT(pSPIx->CR1, SPI_CR1_SSI);
 	}
 	else
 	{
-		SPI2->CR1 &= ~(1 << SPI_CR1_SSI);
+		REG_CLR_BIT(pSPIx->CR1, SPI_CR1_SSI);
 
 	}
 }
@@ -60,11 +60,11 @@ void SPI_SSOEConfig(SPI_RegDef_t *pSPIx, uint8_t EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		SPI2->CR1 |= (1 << SPI_CR2_SSOE);
+		REG_SET_BIT(pSPIx->CR2, SPI_CR2_SSOE);
 	}
 	else
 	{
-		SPI2->CR1 &= ~(1 << SPI_CR2_SSOE);
+		REG_CLR_BIT(pSPIx->CR2, SPI_CR2_SSOE);
 	}
 }
 
@@ -89,11 +89,11 @@ void SPI_PeripheralControl(SPI_RegDef_t *pSPIx, uint8_t EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		pSPIx->CR1 |= (1 << SPI_CR1_SPE);
+		REG_SET_BIT(pSPIx->CR1, SPI_CR1_SPE);
 	}
 	else if(EnOrDi == DISABLE)
 	{
-		pSPIx->CR1 &= ~(1 << SPI_CR1_SPE);
+		REG_CLR_BIT(pSPIx->CR1, SPI_CR1_SPE);
 	}
 }
 
@@ -237,19 +237,19 @@ void SPI_Deinit(SPI_RegDef_t *pSPIx)
 {
 	if(pSPIx == SPI1)
 	{
-		RCC->APB2RSTR |= (1 << 12);
-		RCC->APB2RSTR &= ~(1 << 12);
+		REG_SET_BIT(RCC->APB2RSTR, 12);
+		REG_CLR_BIT(RCC->APB2RSTR, 12);
 	}
 	else if(pSPIx == SPI2)
 	{
-		RCC->APB1RSTR |= (1 << 14);
-		RCC->APB1RSTR &= ~(1 << 14);
+		REG_SET_BIT(RCC->APB1RSTR, 14);
+		REG_CLR_BIT(RCC->APB1RSTR, 14);
 	}
 	else if(pSPIx == SPI3)
 	{
 
-		RCC->APB1RSTR |= (1 << 15);
-		RCC->APB1RSTR &= ~(1 << 15);
+		REG_SET_BIT(RCC->APB1RSTR, 15);
+		REG_CLR_BIT(RCC->APB1RSTR, 15);
 	}
 }
 
@@ -356,15 +356,15 @@ void SPI_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi)
 		if(IRQNumber <= 31)
 		{
 			// program ISER1
-			*NVIC_ISER0 |= (1<<IRQNumber);
+			*NVIC_ISER0 = (1 << IRQNumber);
 		}
 		else if (IRQNumber >= 32 && IRQNumber <=63)
 		{
-			*NVIC_ISER1 |= (1<<(IRQNumber%32));
+			*NVIC_ISER1 = (1 << (IRQNumber%32));
 		}
 		else if (IRQNumber >= 64 && IRQNumber <= 96)
 		{
-			*NVIC_ISER2 |= (1<<(IRQNumber%64));
+			*NVIC_ISER2 = (1 << (IRQNumber%64));
 		}
 	}
 	else
@@ -372,15 +372,15 @@ void SPI_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi)
 		if(IRQNumber <= 31)
 		{
 			// program ISER1
-			*NVIC_ICER0 |= (1<<IRQNumber);
+			*NVIC_ICER0 = (1 << IRQNumber);
 		}
 		else if (IRQNumber >= 32 && IRQNumber <=63)
 		{
-			*NVIC_ICER1 |= (1<<(IRQNumber%32));
+			*NVIC_ICER1 = (1 << (IRQNumber%32));
 		}
 		else if (IRQNumber >= 64 && IRQNumber <= 96)
 		{
-			*NVIC_ICER2 |= (1<<(IRQNumber%64));
+			*NVIC_ICER2 = (1 << (IRQNumber%64));
 		}
 	}
 }
@@ -423,7 +423,7 @@ void SPI_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
  * @Note			-
  *
  *************************************************************************************************/
-static void SPI_TXE_ITHANDLE(SPI_Handle_t *pSPIHandle)
+__RAMFUNC static void SPI_TXE_ITHANDLE(SPI_Handle_t *pSPIHandle)
 {
 	if((pSPIHandle->pSPIx->CR1 & (1 << SPI_CR1_DFF)) == SPI_DFF_8BIT)
 	{
@@ -448,7 +448,7 @@ static void SPI_TXE_ITHANDLE(SPI_Handle_t *pSPIHandle)
 
 }
 
-static void SPI_RXNE_ITHANDLE(SPI_Handle_t *pSPIHandle)
+__RAMFUNC static void SPI_RXNE_ITHANDLE(SPI_Handle_t *pSPIHandle)
 {
 	if((pSPIHandle->pSPIx->CR1 & (1 << SPI_CR1_DFF)) == SPI_DFF_8BIT)
 	{
@@ -483,7 +483,7 @@ uint8_t SPI_GetFlagStatus(SPI_RegDef_t *pSPIx , uint32_t FlagName)
 	return FLAG_RESET;
 }
 
-static void SPI_OVR_ERR_ITHANDLE(SPI_Handle_t *pSPIHandle)
+__RAMFUNC static void SPI_OVR_ERR_ITHANDLE(SPI_Handle_t *pSPIHandle)
 {
 	uint8_t temp;
 	// 1. clear the OVR flag
@@ -498,7 +498,7 @@ static void SPI_OVR_ERR_ITHANDLE(SPI_Handle_t *pSPIHandle)
 	SPI_ApplicationEventCallback(pSPIHandle, SPI_EVENT_OVR_ERR); // this has to be implemented in the application
 }
 
-void SPI_IRQHandling(SPI_Handle_t *pSPIHandle)
+__RAMFUNC void SPI_IRQHandling(SPI_Handle_t *pSPIHandle)
 {
 	uint8_t temp1, temp2;
 	temp1 = (pSPIHandle->pSPIx->SR  & (1<<SPI_SR_TXE));
@@ -558,7 +558,7 @@ uint8_t SPI_SendDataIT(SPI_Handle_t *pSPIHandle, uint8_t *pTxBuffer, uint32_t le
 		pSPIHandle->TxState = SPI_BUSY_IN_TX;
 
 		// 3. Enable TXIEIE Control bit to get interrupt whenever TXE flag is set in SR
-		pSPIHandle->pSPIx->CR2 |= (1 << SPI_CR2_TXEIE);
+		REG_SET_BIT(pSPIHandle->pSPIx->CR2, SPI_CR2_TXEIE);
 
 		// 4. Data transmission will be handled by the ISR code
 	}
@@ -593,34 +593,36 @@ uint8_t SPI_ReceiveDataIT(SPI_Handle_t *pSPIHandle, uint8_t *pRxBuffer, uint32_t
 		pSPIHandle->RxState = SPI_BUSY_IN_RX;
 
 		// 3. Enable TXIEIE Control bit to get interrupt whenever TXE flag is set in SR
-		pSPIHandle->pSPIx->CR2 |= (1 << SPI_CR2_RXNEIE);
+		REG_SET_BIT(pSPIHandle->pSPIx->CR2, SPI_CR2_RXNEIE);
 
 		// 4. Data transmission will be handled by the ISR code
 	}
 	return state;
 }
 
-void SPI_CloseTransmission(SPI_Handle_t *pSPIHandle)
+__RAMFUNC void SPI_CloseTransmission(SPI_Handle_t *pSPIHandle)
 {
 	// if tx len is zero, close the SPI communication and inform the application that tx is over
 	// 1. disable the TXEIE bit
-	pSPIHandle->pSPIx->CR2 &= ~(1 << SPI_CR2_TXEIE);
+	REG_CLR_BIT(pSPIHandle->pSPIx->CR2, SPI_CR2_TXEIE);
 	// 2. reset the buffers
 	pSPIHandle->pTxBuffer = NULL;
 	pSPIHandle->TxLen = 0;
 	pSPIHandle->TxState = SPI_READY;
 	// 3. inform the application
 }
-void SPI_CloseReception(SPI_Handle_t *pSPIHandle)
+__RAMFUNC void SPI_CloseReception(SPI_Handle_t *pSPIHandle)
 {
-	pSPIHandle->pSPIx->CR2 &= ~(1 << SPI_CR2_RXNEIE);
+	REG_CLR_BIT(pSPIHandle->pSPIx->CR2, SPI_CR2_RXNEIE);
 
 	pSPIHandle->pRxBuffer = NULL;
 	pSPIHandle->RxLen = 0;
 	pSPIHandle->RxState = SPI_READY;
 }
 
-__weak void SPI_ApplicationEventCallback(SPI_Handle_t *pSPIHandle, uint8_t AppEv)
+__weak __RAMFUNC void SPI_ApplicationEventCallback(SPI_Handle_t *pSPIHandle, uint8_t AppEv)
 {
 	// weak implementation so that can use it
+	(void)pSPIHandle;
+	(void)AppEv;
 }
@@ -48,7 +48,7 @@ uint8_t USART_GetFlagStatus(USART_RegDef_t *pUSARTx , uint32_t FlagName)
  *************************************************************************************************/
 void USART_ClearFlag(USART_RegDef_t *pUSARTx , uint32_t FlagName)
 {
-	pUSARTx->SR &= ~(1 << FlagName);
+	pUSARTx->SR = ~(1 << FlagName);
 }
 
 /*
@@ -249,33 +249,33 @@ void USART_DeInit(USART_RegDef_t *pUSARTx)
 {
 	if(pUSARTx == USART1)
 	{
-		RCC->APB2RSTR |= (1 << 4);
-		RCC->APB2RSTR &= ~(1 << 4);
+		REG_SET_BIT(RCC->APB2RSTR, 4);
+		REG_CLR_BIT(RCC->APB2RSTR, 4);
 	}
 	else if(pUSARTx == USART2)
 	{
-		RCC->APB1RSTR |= (1 << 17);
-		RCC->APB1RSTR &= ~(1 << 17);
+		REG_SET_BIT(RCC->APB1RSTR, 17);
+		REG_CLR_BIT(RCC->APB1RSTR, 17);
 	}
 	else if(pUSARTx == USART3)
 	{
-		RCC->APB1RSTR |= (1 << 18);
-		RCC->APB1RSTR &= ~(1 << 18);
+		REG_SET_BIT(RCC->APB1RSTR, 18);
+		REG_CLR_BIT(RCC->APB1RSTR, 18);
 	}
 	if(pUSARTx == UART4)
 	{
-		RCC->APB1RSTR |= (1 << 19);
-		RCC->APB1RSTR &= ~(1 << 19);
+		REG_SET_BIT(RCC->APB1RSTR, 19);
+		REG_CLR_BIT(RCC->APB1RSTR, 19);
 	}
 	else if(pUSARTx == UART5)
 	{
-		RCC->APB1RSTR |= (1 << 20);
-		RCC->APB1RSTR &= ~(1 << 20);
+		REG_SET_BIT(RCC->APB1RSTR, 20);
+		REG_CLR_BIT(RCC->APB1RSTR, 20);
 	}
 	else if(pUSARTx == USART6)
 	{
-		RCC->APB2RSTR |= (1 << 5);
-		RCC->APB2RSTR &= ~(1 << 5);
+		REG_SET_BIT(RCC->APB2RSTR, 5);
+		REG_CLR_BIT(RCC->APB2RSTR, 5);
 	}
 }
 
@@ -451,11 +451,11 @@ uint8_t USART_SendDataIT(USART_Handle_t *pUSARTHandle,uint8_t *pTxBuffer, uint32
 		pUSARTHandle->TxBusyState = USART_BUSY_IN_TX;
 
 		//Implement the code to enable interrupt for TXE
-		pUSARTHandle->pUSARTx->CR1 |= (1 << USART_CR1_TXEIE);
+		REG_SET_BIT(pUSARTHandle->pUSARTx->CR1, USART_CR1_TXEIE);
 
 
 		//Implement the code to enable interrupt for TC
-		pUSARTHandle->pUSARTx->CR1 |= (1 << USART_CR1_TCIE);
+		REG_SET_BIT(pUSARTHandle->pUSARTx->CR1, USART_CR1_TCIE);
 	}
 
 	return txstate;
@@ -488,7 +488,7 @@ uint8_t USART_ReceiveDataIT(USART_Handle_t *pUSARTHandle,uint8_t *pRxBuffer, uin
 		pUSARTHandle->RxBusyState = USART_BUSY_IN_RX;
 
 		//Implement the code to enable interrupt for RXNE
-		pUSARTHandle->pUSARTx->CR1 |= (1 << USART_CR1_RXNEIE);
+		REG_SET_BIT(pUSARTHandle->pUSARTx->CR1, USART_CR1_RXNEIE);
 
 	}
 	return rxstate;
@@ -620,7 +620,7 @@ void USART_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority){}
  * @Note              - Resolve all the TODOs
 
  */
-void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
+__RAMFUNC void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
 {
 
 	uint32_t temp1 , temp2, temp3;
@@ -646,10 +646,10 @@ void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
 			if(! pUSARTHandle->TxLen )
 			{
 				//Implement the code to clear the TC flag
-				pUSARTHandle->pUSARTx->SR &= ~( 1 << USART_SR_TC);
+				pUSARTHandle->pUSARTx->SR = ~(1 << USART_SR_TC);
 
 				//Implement the code to clear the TCIE control bit
-				pUSARTHandle->pUSARTx->CR1 &= ~(1 << USART_CR1_TCIE);
+				REG_CLR_BIT(pUSARTHandle->pUSARTx->CR1, USART_CR1_TCIE);
 
 				//Reset the application state
 				pUSARTHandle->TxBusyState = USART_READY;
@@ -731,7 +731,7 @@ void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
 			{
 				//TxLen is zero
 				//Implement the code to clear the TXEIE bit (disable interrupt for TXE flag )
-				pUSARTHandle->pUSARTx->CR1 &= ~ ( 1 << USART_CR1_TXEIE);
+				REG_CLR_BIT(pUSARTHandle->pUSARTx->CR1, USART_CR1_TXEIE);
 			}
 		}
 	}
@@ -818,7 +818,7 @@ void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
 			if(! pUSARTHandle->RxLen)
 			{
 				//disable the rxne
-				pUSARTHandle->pUSARTx->CR1 &= ~( 1 << USART_CR1_RXNEIE );
+				REG_CLR_BIT(pUSARTHandle->pUSARTx->CR1, USART_CR1_RXNEIE);
 				pUSARTHandle->RxBusyState = USART_READY;
 				USART_ApplicationEventCallback(pUSARTHandle,USART_EVENT_RX_CMPLT);
 			}
@@ -842,7 +842,7 @@ void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
 	if(temp1  && temp2 )
 	{
 		//Implement the code to clear the CTS flag in SR
-		pUSARTHandle->pUSARTx->SR &= ~(1 << USART_SR_CTS);
+		pUSARTHandle->pUSARTx->SR = ~(1 << USART_SR_CTS);
 
 		//this interrupt is because of cts
 		USART_ApplicationEventCallback(pUSARTHandle,USART_EVENT_CTS);
@@ -946,11 +946,11 @@ void USART_PeripheralControl(USART_RegDef_t *pUSARTx, uint8_t EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		pUSARTx->CR1 |= ( 1 << USART_CR1_UE);
+		REG_SET_BIT(pUSARTx->CR1, USART_CR1_UE);
 	}
 	else if(EnOrDi == DISABLE)
 	{
-		pUSARTx->CR1 &= ~( 1 << USART_CR1_UE);
+		REG_CLR_BIT(pUSARTx->CR1, USART_CR1_UE);
 	}
 }
 
@@ -973,7 +973,7 @@ void USART_PeripheralControl(USART_RegDef_t *pUSARTx, uint8_t EnOrDi)
  * @Note			-
  *
  *************************************************************************************************/
-void USART_ApplicationEventCallback(USART_Handle_t *pUSARTHandle,uint8_t AppEv){}
+__RAMFUNC void USART_ApplicationEventCallback(USART_Handle_t *pUSARTHandle,uint8_t AppEv){}
 
 
 
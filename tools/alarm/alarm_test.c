@@ -0,0 +1,280 @@
+/*
+ * alarm_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the software alarm engine (Inc/alarm.h) on the scheduler (Inc/sched.h), fast-forwarded
+ * through a year of RTC seconds
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o alarm_test
+ * 			   alarm_test.c ../sim/sim.c ../../Src/alarm.c ../../Src/cron.c ../../Src/sched.c ../../Src/ringbuf.c
+ * 			   ../../BSP/rtc.c ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	alarm_test
+ *
+ * 	- Year: 01/06/27 to 01/06/28 (Feb 29 included), one scheduler tick per RTC second as from the SQW
+ * 	  ISR. Daily, weekly and cron alarms and AT_ONESHOTS one shot alarms at random seconds, every 8th
+ * 	  of them cancelled before it is due. Every expiry must come on the tick of its Due, and the expiries
+ * 	  of each repeating alarm must be exactly the seconds a brute force scan of the year matches
+ * 	- Resync: a forward jump fires every alarm it skips once, a backward jump recomputes the repeating
+ * 	  alarms from the new time
+ *
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "sim.h"
+#include "alarm.h"
+#include "cron.h"
+
+#define AT_ONESHOTS						4096
+#define AT_REPEATING					7
+#define AT_HEAP_SIZE					(AT_ONESHOTS + AT_REPEATING)
+
+/*
+ * A repeating alarm and the reference it is checked against
+ */
+typedef struct
+{
+	const char		*pName;
+	uint8_t			Type;				/* @ALARM_TYPE, daily, weekly or custom (cron) */
+	uint8_t			DayMask;
+	uint32_t		TimeOfDay;
+	const char		*pCron;
+	Cron_Expr_t		Expr;
+	Alarm_t			Alarm;
+	uint32_t		Fired;
+	uint32_t		Last;
+	uint32_t		Wrong;				/* Expiries at a second the reference does not match */
+}AT_Track_t;
+
+typedef struct
+{
+	Alarm_t			Alarm;
+	uint32_t		Due;
+	uint8_t			Cancelled;
+	uint32_t		Fired;
+	uint32_t		FiredAt;
+}AT_Once_t;
+
+#define AT_DAY(day)						(1 << ((day) - SUNDAY))
+#define AT_WEEKDAYS						(AT_DAY(MONDAY) | AT_DAY(TUESDAY) | AT_DAY(WEDNESDAY) | AT_DAY(THURSDAY) | AT_DAY(FRIDAY))
+
+static AT_Track_t tracks[AT_REPEATING] =
+{
+	{ .pName = "daily 07:30:15",			.Type = ALARM_TYPE_DAILY,	.TimeOfDay = 7 * 3600 + 30 * 60 + 15 },
+	{ .pName = "weekly MON-FRI 08:00",		.Type = ALARM_TYPE_WEEKLY,	.DayMask = AT_WEEKDAYS,
+	  .TimeOfDay = 8 * 3600 },
+	{ .pName = "weekly SAT 23:59:59",		.Type = ALARM_TYPE_WEEKLY,	.DayMask = AT_DAY(SATURDAY),
+	  .TimeOfDay = ALARM_SECONDS_PER_DAY - 1 },
+	{ .pName = "cron */15 8-18 MON-FRI",	.Type = ALARM_TYPE_CUSTOM,	.pCron = "*/15 8-18 * * MON-FRI" },
+	{ .pName = "cron leap day",				.Type = ALARM_TYPE_CUSTOM,	.pCron = "0 0 29 2 *" },
+	{ .pName = "cron monthly",				.Type = ALARM_TYPE_CUSTOM,	.pCron = "30 2 1 * *" },
+	{ .pName = "cron 13th or FRI",			.Type = ALARM_TYPE_CUSTOM,	.pCron = "0 12 13 * FRI" },
+};
+
+static AT_Once_t onces[AT_ONESHOTS];
+static Alarm_t *heap[AT_HEAP_SIZE];
+static Sched_Handle_t sched;
+static Alarm_Handle_t alarms;
+
+static uint32_t AT_Epoch(uint8_t Date, uint8_t Month, uint8_t Year)
+{
+	RTC_Handle_time_t time = { 0, 0, 0, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { Date, Month, Year, 0 };
+
+	return RTC_toEpoch(&time, &date);
+}
+
+/*
+ * reference: does the alarm expire at this second
+ */
+static uint8_t AT_Matches(AT_Track_t *pTrack, uint32_t Epoch)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	switch(pTrack->Type)
+	{
+	case ALARM_TYPE_DAILY:
+		return (Epoch % ALARM_SECONDS_PER_DAY) == pTrack->TimeOfDay;
+
+	case ALARM_TYPE_WEEKLY:
+		if((Epoch % ALARM_SECONDS_PER_DAY) != pTrack->TimeOfDay)
+			return 0;
+		RTC_fromEpoch(Epoch, &time, &date);
+		return (pTrack->DayMask >> (date.day - SUNDAY)) & 1;
+
+	default:
+		if((Epoch % 60) != 0)
+			return 0;
+		RTC_fromEpoch(Epoch, &time, &date);
+		return Cron_Match(&pTrack->Expr, &time, &date);
+	}
+}
+
+static void AT_TrackFired(void *pArg)
+{
+	AT_Track_t *pTrack = (AT_Track_t*)pArg;
+	uint32_t now = Alarm_GetNow(&alarms);
+
+	if(!AT_Matches(pTrack, now) || (pTrack->Fired && (now <= pTrack->Last)))
+		pTrack->Wrong++;
+	pTrack->Fired++;
+	pTrack->Last = now;
+}
+
+static void AT_OnceFired(void *pArg)
+{
+	AT_Once_t *pOnce = (AT_Once_t*)pArg;
+
+	pOnce->Fired++;
+	pOnce->FiredAt = Alarm_GetNow(&alarms);
+}
+
+static void AT_Start(uint32_t Now)
+{
+	Sched_Init(&sched);
+	alarms.Alarm_Config.pSched = &sched;
+	alarms.Alarm_Config.ppHeap = heap;
+	alarms.Alarm_Config.Capacity = AT_HEAP_SIZE;
+	Alarm_Init(&alarms, Now);
+}
+
+static void AT_AddTrack(AT_Track_t *pTrack)
+{
+	pTrack->Fired = 0;
+	pTrack->Wrong = 0;
+
+	switch(pTrack->Type)
+	{
+	case ALARM_TYPE_DAILY:
+		Alarm_SetDaily(&pTrack->Alarm, pTrack->TimeOfDay, AT_TrackFired, pTrack);
+		break;
+	case ALARM_TYPE_WEEKLY:
+		Alarm_SetWeekly(&pTrack->Alarm, pTrack->DayMask, pTrack->TimeOfDay, AT_TrackFired, pTrack);
+		break;
+	default:
+		SIM_CHECK(Cron_Parse(&pTrack->Expr, pTrack->pCron) == CRON_OK);
+		Cron_SetAlarm(&pTrack->Alarm, &pTrack->Expr, AT_TrackFired, pTrack);
+		break;
+	}
+	SIM_CHECK(Alarm_Add(&alarms, &pTrack->Alarm) == ALARM_OK);
+}
+
+/*
+ * one RTC second: the SQW ISR ticks, the main loop runs the scheduler
+ */
+static void AT_Second(void)
+{
+	Sched_Tick(&sched);
+	Sched_RunOnce(&sched);
+}
+
+static void AT_Year(void)
+{
+	uint32_t start = AT_Epoch(1, 6, 27);
+	uint32_t end = AT_Epoch(1, 6, 28);
+	uint32_t seed = 12345, expected, oncesOk = 0, fires = 0;
+	clock_t cpu;
+
+	AT_Start(start);
+	for(uint32_t i = 0; i < AT_REPEATING; i++)
+		AT_AddTrack(&tracks[i]);
+
+	for(uint32_t i = 0; i < AT_ONESHOTS; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		onces[i].Due = start + 1 + (seed >> 8) % (end - start);
+		onces[i].Fired = 0;
+		Alarm_SetOnce(&onces[i].Alarm, onces[i].Due, AT_OnceFired, &onces[i]);
+		SIM_CHECK(Alarm_Add(&alarms, &onces[i].Alarm) == ALARM_OK);
+	}
+	SIM_CHECK(alarms.Count == AT_HEAP_SIZE);
+
+	for(uint32_t i = 0; i < AT_ONESHOTS; i += 8)
+	{
+		onces[i].Cancelled = 1;
+		Alarm_Cancel(&alarms, &onces[i].Alarm);
+	}
+	SIM_CHECK(alarms.Count == AT_HEAP_SIZE - AT_ONESHOTS / 8);
+
+	cpu = clock();
+	for(uint32_t now = start; now < end; now++)
+		AT_Second();
+	cpu = clock() - cpu;
+	SIM_CHECK(Alarm_GetNow(&alarms) == end);
+
+	for(uint32_t i = 0; i < AT_REPEATING; i++)
+	{
+		expected = 0;
+		for(uint32_t epoch = start + 1; epoch <= end; epoch++)
+			expected += AT_Matches(&tracks[i], epoch);
+
+		printf("%-24s %5u expiries (%u expected)\n", tracks[i].pName, tracks[i].Fired, expected);
+		SIM_CHECK(tracks[i].Fired == expected);
+		SIM_CHECK(tracks[i].Wrong == 0);
+		SIM_CHECK(tracks[i].Alarm.HeapIdx != ALARM_NOT_QUEUED);
+		fires += tracks[i].Fired;
+	}
+
+	for(uint32_t i = 0; i < AT_ONESHOTS; i++)
+	{
+		if(onces[i].Cancelled)
+			oncesOk += (onces[i].Fired == 0);
+		else
+			oncesOk += (onces[i].Fired == 1) && (onces[i].FiredAt == onces[i].Due);
+		fires += onces[i].Fired;
+	}
+	SIM_CHECK(oncesOk == AT_ONESHOTS);
+	SIM_CHECK(alarms.Count == AT_REPEATING);
+
+	printf("one year: %u seconds, %u expiries, %.2f s CPU, scheduler queue overflows %u\n",
+		   end - start, fires, (double)cpu / CLOCKS_PER_SEC, sched.Queue.Overflows);
+	SIM_CHECK(sched.Queue.Overflows == 0);
+}
+
+static void AT_Resync(void)
+{
+	uint32_t start = AT_Epoch(1, 3, 28);
+	uint32_t timeOfDay = 7 * 3600 + 30 * 60;
+	uint32_t nextDaily = start + timeOfDay;
+	Alarm_t daily;
+	AT_Once_t dailyRec = { 0 }, once = { 0 };
+
+	AT_Start(start);
+	Alarm_SetDaily(&daily, timeOfDay, AT_OnceFired, &dailyRec);
+	SIM_CHECK(Alarm_Add(&alarms, &daily) == ALARM_OK);
+	Alarm_SetOnce(&once.Alarm, nextDaily + 100, AT_OnceFired, &once);
+	SIM_CHECK(Alarm_Add(&alarms, &once.Alarm) == ALARM_OK);
+
+	// forward 3 days without ticks: both fire once, right away, the daily one moves to the next day
+	Alarm_Resync(&alarms, start + 3 * ALARM_SECONDS_PER_DAY);
+	Sched_RunOnce(&sched);
+	SIM_CHECK(dailyRec.Fired == 1 && once.Fired == 1);
+	SIM_CHECK(once.FiredAt == start + 3 * ALARM_SECONDS_PER_DAY);
+	SIM_CHECK(alarms.Count == 1);
+	SIM_CHECK(daily.Due == nextDaily + 3 * ALARM_SECONDS_PER_DAY);
+
+	// back 2 days: the daily alarm comes due again that day, on time
+	Alarm_Resync(&alarms, start + ALARM_SECONDS_PER_DAY);
+	SIM_CHECK(daily.Due == nextDaily + ALARM_SECONDS_PER_DAY);
+	for(uint32_t i = 0; i < timeOfDay; i++)
+		AT_Second();
+	SIM_CHECK(dailyRec.Fired == 2);
+	SIM_CHECK(dailyRec.FiredAt == nextDaily + ALARM_SECONDS_PER_DAY);
+	SIM_CHECK(daily.Due == nextDaily + 2 * ALARM_SECONDS_PER_DAY);
+}
+
+int main(void)
+{
+	AT_Year();
+	AT_Resync();
+
+	return Sim_Report("alarm");
+}
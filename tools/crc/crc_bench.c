@@ -0,0 +1,273 @@
+/*
+ * crc_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host check and benchmark of the CRC-32 paths (Inc/crc.h, stm32f407xx_crc.h): the CRC unit fed by the
+ * CPU, the unit fed by DMA2 and the table driven Crc_CRC32Soft(), on the simulated CRC unit and DMA2
+ * (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o crc_bench crc_bench.c
+ * 			   ../sim/sim.c ../sim/crc_sim.c ../../Src/crc.c ../../drivers/Src/stm32f407xx_crc.c
+ * Usage:	crc_bench [calls per size]
+ *
+ * 	- Model: Crc_CRC32Soft() against the bitwise model of the unit (Sim_CRCUnit) on CR_SOFT_BUFFERS
+ * 	  random buffers, any length and alignment, and the known value of word 0x12345678
+ * 	- CPU feed: CRC_Calculate() and CRC_Accumulate() in pieces give Crc_CRC32Soft(), one DR write per
+ * 	  word, the last one zero padded
+ * 	- DMA: CRC_DMAStart() / CRC_DMAPoll() give Crc_CRC32Soft(), NDTR words moved. Bad parameters,
+ * 	  busy, polling without a start and a transfer error are reported as such and leave the unit usable
+ * 	- Benchmark: bytes per cycle of the three paths for CR_SIZES. The target columns are the cycle
+ * 	  model below times the words and bytes counted on the simulated unit (168 MHz, code in the ART
+ * 	  cache), not measurements: confirm them with DWT_CYCCNT on the board. The host column is
+ * 	  Crc_CRC32Soft() timed on the host, for the relative cost of the sizes
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "crc_sim.h"
+#include "crc.h"
+#include "stm32f407xx_crc.h"
+
+#define CR_SOFT_BUFFERS					4096
+#define CR_UNIT_BUFFERS					64				/* every DR write traps, keep it short */
+#define CR_MAX_LEN						1024
+#define CR_BUF_ADDR						(SRAM1_BASEADDR + 0x1000)
+#define CR_CCM_ADDR						CCMRAM_BASEADDR
+
+/*
+ * Target cycle model (Cortex-M4 at 168 MHz, RM0090 CRC and DMA timings)
+ * 	CPU feed:	LDR 2, STR to DR 1, loop 2 per word. The unit needs 4 AHB cycles per word, which the
+ * 				loop hides. Reset, call and DR read per call
+ * 	DMA:		the unit's 4 cycles plus a source read and arbitration per word, the CPU is free.
+ * 				CRC_DMAStart() and CRC_DMAPoll() register accesses per call
+ * 	Table:		LDRB, EOR, LSR, LDR from the table, LSL, EOR per byte, the zero pad per word
+ */
+#define CR_CYC_FEED_WORD				5
+#define CR_CYC_FEED_CALL				12
+#define CR_CYC_DMA_WORD					6
+#define CR_CYC_DMA_CALL					60
+#define CR_CYC_SOFT_BYTE				7
+#define CR_CYC_SOFT_WORD				6
+
+static const uint32_t sizes[] = { 16, 64, 256, 1024, 4096 };
+
+static Sim_CRC_t unit;
+static uint32_t seed = 44;
+
+static uint32_t CR_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint64_t CR_Nanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * reference: little endian words, the last one zero padded, through the bitwise model
+ */
+static uint32_t CR_Model(const uint8_t *pData, uint32_t Len)
+{
+	uint32_t crc = CRC32_INIT;
+
+	for(uint32_t i = 0; i < Len; i += 4)
+	{
+		uint32_t word = 0;
+
+		for(uint32_t b = 0; (b < 4) && (i + b < Len); b++)
+			word |= (uint32_t)pData[i + b] << (8 * b);
+		crc = Sim_CRCUnit(crc, word);
+	}
+	return crc;
+}
+
+/*
+ * random bytes in the DMA reachable buffer, returns the firmware address
+ */
+static uint8_t* CR_Fill(uint32_t Len)
+{
+	uint8_t *pShadow = (uint8_t*)Sim_Shadow(CR_BUF_ADDR);
+
+	for(uint32_t i = 0; i < Len + 4; i++)
+		pShadow[i] = (uint8_t)CR_Random();
+	return (uint8_t*)(uintptr_t)CR_BUF_ADDR;
+}
+
+static void CR_Model_Check(void)
+{
+	static uint8_t buf[CR_MAX_LEN + 4];
+	const uint8_t known[4] = { 0x78, 0x56, 0x34, 0x12 };
+	uint32_t bad = 0;
+
+	SIM_CHECK(Sim_CRCUnit(CRC32_INIT, 0x12345678) == 0xDF8A8A2BUL);
+	SIM_CHECK(Crc_CRC32Soft(known, 4) == 0xDF8A8A2BUL);
+	SIM_CHECK(Crc_CRC32Soft(known, 0) == CRC32_INIT);
+	// no Crc_Init(), the host build is the software CRC
+	SIM_CHECK(Crc_CRC32(known, 4) == 0xDF8A8A2BUL);
+
+	for(uint32_t n = 0; n < CR_SOFT_BUFFERS; n++)
+	{
+		uint32_t len = CR_Random() % (CR_MAX_LEN + 1);
+		uint32_t off = CR_Random() % 4;
+
+		for(uint32_t i = 0; i < len + off; i++)
+			buf[i] = (uint8_t)CR_Random();
+		bad += (Crc_CRC32Soft(buf + off, len) != CR_Model(buf + off, len));
+	}
+
+	printf("model:  %u buffers, %u differ from the bitwise model\n", CR_SOFT_BUFFERS, bad);
+	SIM_CHECK(bad == 0);
+}
+
+static void CR_Feed_Check(void)
+{
+	uint32_t bad = 0, words = 0;
+
+	for(uint32_t n = 0; n < CR_UNIT_BUFFERS; n++)
+	{
+		uint32_t len = CR_Random() % (CR_MAX_LEN + 1);
+		uint32_t off = CR_Random() % 4;
+		uint8_t *pBuf = CR_Fill(len + off) + off;
+		uint32_t soft = Crc_CRC32Soft(pBuf, len);
+		uint32_t split = (CR_Random() % (len + 1)) & ~3U;
+
+		unit.Words = 0;
+		bad += (CRC_Calculate(pBuf, len) != soft);
+		SIM_CHECK(unit.Words == (len + 3) / 4);
+		words += unit.Words;
+
+		// in two pieces, the first a multiple of 4
+		CRC_Reset();
+		CRC_Accumulate(pBuf, split);
+		bad += (CRC_Accumulate(pBuf + split, len - split) != soft);
+	}
+
+	printf("feed:   %u buffers, %u words, %u differ from the software CRC\n", CR_UNIT_BUFFERS, words, bad);
+	SIM_CHECK(bad == 0);
+}
+
+static uint8_t CR_DMA(const void *pData, uint32_t Len, uint32_t *pCrc)
+{
+	uint8_t status = CRC_DMAStart(pData, Len);
+
+	if(status != CRC_OK)
+		return status;
+
+	SIM_CHECK(CRC_DMAIsBusy());
+	SIM_CHECK(CRC_DMAStart(pData, Len) == CRC_BUSY);
+	do
+	{
+		status = CRC_DMAPoll(pCrc);
+	}while(status == CRC_BUSY);
+
+	SIM_CHECK(!CRC_DMAIsBusy());
+	return status;
+}
+
+static void CR_DMA_Check(void)
+{
+	uint32_t bad = 0, words = 0, crc;
+	uint8_t *pBuf;
+
+	for(uint32_t n = 0; n < CR_UNIT_BUFFERS; n++)
+	{
+		uint32_t len = (CR_Random() % (CR_MAX_LEN / 4) + 1) * 4;
+
+		pBuf = CR_Fill(len);
+		unit.DMAWords = 0;
+		crc = 0;
+		SIM_CHECK(CR_DMA(pBuf, len, &crc) == CRC_OK);
+		SIM_CHECK(unit.DMAWords == len / 4);
+		bad += (crc != Crc_CRC32Soft(pBuf, len));
+		words += unit.DMAWords;
+	}
+
+	printf("dma:    %u buffers, %u words, %u differ from the software CRC\n", CR_UNIT_BUFFERS, words, bad);
+	SIM_CHECK(bad == 0);
+	SIM_CHECK(unit.ConfigErrors == 0);
+
+	// refused before anything is started
+	pBuf = CR_Fill(64);
+	SIM_CHECK(CRC_DMAPoll(&crc) == CRC_ERR_PARAM);
+	SIM_CHECK(CRC_DMAStart(pBuf, 0) == CRC_ERR_PARAM);
+	SIM_CHECK(CRC_DMAStart(pBuf, 62) == CRC_ERR_PARAM);
+	SIM_CHECK(CRC_DMAStart(pBuf + 2, 60) == CRC_ERR_PARAM);
+	SIM_CHECK(CRC_DMAStart(pBuf, 4 * (CRC_DMA_MAX_WORDS + 1)) == CRC_ERR_PARAM);
+	SIM_CHECK(CRC_DMAStart((const void*)(uintptr_t)CR_CCM_ADDR, 64) == CRC_ERR_PARAM);
+	SIM_CHECK(!CRC_DMAIsBusy() && unit.DMAStarts == CR_UNIT_BUFFERS);
+
+	// a transfer error is reported once, the next transfer works
+	unit.FailDMA = 1;
+	SIM_CHECK(CR_DMA(pBuf, 64, &crc) == CRC_ERR_DMA);
+	SIM_CHECK(CR_DMA(pBuf, 64, &crc) == CRC_OK);
+	SIM_CHECK(crc == Crc_CRC32Soft(pBuf, 64));
+	SIM_CHECK(CRC_Calculate(pBuf, 64) == crc);
+}
+
+static void CR_Bench(uint32_t Calls)
+{
+	static uint8_t buf[4096];
+	__vo uint32_t sink = 0;
+
+	for(uint32_t i = 0; i < sizeof(buf); i++)
+		buf[i] = (uint8_t)CR_Random();
+
+	printf("\n%8s %12s %12s %12s %12s %12s\n", "", "feed", "dma", "dma", "table", "table host");
+	printf("%8s %12s %12s %12s %12s %12s\n", "bytes", "bytes/cyc", "bytes/cyc", "cpu cycles", "bytes/cyc",
+		   "ns");
+	for(uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		uint32_t len = sizes[s];
+		uint32_t feed, dma, soft;
+		uint8_t *pBuf = CR_Fill(len);
+		uint64_t t;
+
+		unit.Words = 0;
+		CRC_Calculate(pBuf, len);
+		feed = CR_CYC_FEED_CALL + unit.Words * CR_CYC_FEED_WORD;
+
+		unit.DMAWords = 0;
+		SIM_CHECK(CR_DMA(pBuf, len, (uint32_t*)&sink) == CRC_OK);
+		dma = CR_CYC_DMA_CALL + unit.DMAWords * CR_CYC_DMA_WORD;
+
+		soft = len * CR_CYC_SOFT_BYTE + ((len + 3) / 4) * CR_CYC_SOFT_WORD;
+
+		t = CR_Nanos();
+		for(uint32_t n = 0; n < Calls; n++)
+			sink += Crc_CRC32Soft(buf, len);
+		t = (CR_Nanos() - t) / Calls;
+
+		printf("%8u %12.3f %12.3f %12u %12.3f %12llu\n", len, (double)len / feed, (double)len / dma,
+			   CR_CYC_DMA_CALL, (double)len / soft, (unsigned long long)t);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 10000;
+
+	Sim_Init();
+	Sim_CRCInit(&unit);
+	CRC_PeriClockControl(ENABLE);
+
+	CR_Model_Check();
+	CR_Feed_Check();
+	CR_DMA_Check();
+	SIM_CHECK(unit.Unclocked == 0);
+	CR_Bench(calls);
+
+	return Sim_Report("crc_bench");
+}
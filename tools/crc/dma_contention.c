@@ -0,0 +1,212 @@
+/*
+ * dma_contention.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host benchmark of the bus contention between a CRC DMA transfer (stm32f407xx_crc.h) and the CPU,
+ * with the CPU data in SRAM1, SRAM2 or CCM RAM, on the simulated CRC unit and DMA2 (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o dma_contention dma_contention.c
+ * 			   ../sim/sim.c ../sim/crc_sim.c ../../Src/crc.c ../../Src/telemetry.c ../../Src/syscalls.c
+ * 			   ../../Src/xprintf.c ../../Src/ringbuf.c ../../drivers/Src/stm32f407xx_crc.c
+ * 			   ../../drivers/Src/stm32f407xx_usart.c ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	dma_contention [calls]
+ *
+ * DMA2 reads its source through the bus matrix, the CPU reaches SRAM1 and SRAM2 the same way (S bus),
+ * CCM RAM only through its own D bus. Two masters on one slave are arbitrated round robin, the loser
+ * waits a cycle
+ * 	- DMA: CRC_DMAStart() streams a __DMA_RAM like buffer in SRAM1 into the unit, the result has to be
+ * 	  Crc_CRC32Soft(). A buffer in CCM RAM is refused (IS_DMA_ADDR)
+ * 	- CPU: the firmware code running next to the transfer, with its data placed in each region.
+ * 	  Every data access to the region is counted on the simulated map (a counting model on the
+ * 	  data, host instructions, so a host memcpy counts less than the Cortex-M4 one)
+ * 		- frame: Telemetry_PutRecord() of a full record, the handle holds the frame (main.c)
+ * 		- crc: Crc_CRC32Soft() of DC_CRC_LEN bytes, the fallback while the unit is busy
+ * 	- Target cycles from the model below (168 MHz, RM0090 bus matrix), not measurements: confirm
+ * 	  them with DWT_CYCCNT on the board. The counted accesses have to match in every region
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "crc_sim.h"
+#include "crc.h"
+#include "telemetry.h"
+#include "stm32f407xx_crc.h"
+
+#define DC_DMA_LEN						1024
+#define DC_CRC_LEN						256
+#define DC_DMA_ADDR						SRAM1_BASEADDR				/* Where __DMA_RAM puts the source */
+#define DC_SRAM1_ADDR					(SRAM1_BASEADDR + 0x4000)
+#define DC_SRAM2_ADDR					SRAM2_BASEADDR
+#define DC_CCM_ADDR						CCMRAM_BASEADDR
+#define DC_DATA_SIZE					0x1000
+
+/*
+ * Contention model
+ * 	The DMA needs DC_CYC_DMA_WORD cycles per word (the unit's 4 plus the read), one of them on its
+ * 	source slave. A CPU access to that slave in that cycle loses the arbitration half of the time and
+ * 	waits one cycle, the DMA the other half. Accesses to other slaves never wait
+ */
+#define DC_CYC_DMA_WORD					6
+#define DC_CYC_ACCESS					2			/* CPU cycles per counted access, code in the ART cache */
+
+typedef struct
+{
+	const char		*pName;
+	uint32_t		Addr;
+	uint8_t			SharesDMASlave;			/* 1 -> same slave as the DMA source */
+}DC_Region_t;
+
+static const DC_Region_t regions[] =
+{
+	{ "SRAM1",	DC_SRAM1_ADDR,	1 },
+	{ "SRAM2",	DC_SRAM2_ADDR,	0 },
+	{ "CCM",	DC_CCM_ADDR,	0 },
+};
+
+static Sim_CRC_t unit;
+static uint32_t accesses;
+static uint32_t seed = 31;
+
+static uint32_t DC_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/*
+ * counting model on the CPU data: plain memory, every access counted once
+ */
+static void DC_Read(void *pCtx, uint32_t Offset)
+{
+	(void)pCtx;
+	(void)Offset;
+	accesses++;
+}
+
+static void DC_Write(void *pCtx, uint32_t Offset, uint32_t OldValue)
+{
+	(void)pCtx;
+	(void)Offset;
+	(void)OldValue;
+	accesses++;
+}
+
+static void DC_Sink(void *pCtx, const uint8_t *pData, uint32_t len)
+{
+	(void)pCtx;
+	(void)pData;
+	(void)len;
+}
+
+static uint32_t DC_DMA(uint32_t Len)
+{
+	uint8_t *pShadow = (uint8_t*)Sim_Shadow(DC_DMA_ADDR);
+	const void *pBuf = (const void*)(uintptr_t)DC_DMA_ADDR;
+	uint32_t crc = 0;
+	uint8_t status;
+
+	for(uint32_t i = 0; i < Len; i++)
+		pShadow[i] = (uint8_t)DC_Random();
+
+	SIM_CHECK(CRC_DMAStart((const void*)(uintptr_t)DC_CCM_ADDR, Len) == CRC_ERR_PARAM);
+
+	unit.DMAWords = 0;
+	SIM_CHECK(CRC_DMAStart(pBuf, Len) == CRC_OK);
+	do
+	{
+		status = CRC_DMAPoll(&crc);
+	}while(status == CRC_BUSY);
+	SIM_CHECK(status == CRC_OK);
+	SIM_CHECK(crc == Crc_CRC32Soft(pShadow, Len));
+	SIM_CHECK(unit.DMAWords == Len / 4);
+
+	return unit.DMAWords;
+}
+
+/*
+ * CPU data accesses per call of the workload with its data at Addr
+ */
+static uint32_t DC_Count(uint8_t Workload, uint32_t Addr, uint32_t Calls)
+{
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	Telemetry_Handle_t *pTlm = (Telemetry_Handle_t*)(uintptr_t)Addr;
+	const uint8_t *pData = (const uint8_t*)(uintptr_t)Addr;
+	uint8_t *pShadow = (uint8_t*)Sim_Shadow(Addr);
+
+	for(uint32_t i = 0; i < sizeof(payload); i++)
+		payload[i] = (uint8_t)DC_Random();
+	for(uint32_t i = 0; i < DC_CRC_LEN; i++)
+		pShadow[i] = (uint8_t)DC_Random();
+	if(Workload == 0)
+		Telemetry_Init(pTlm, DC_Sink, NULL);
+
+	Sim_AddModel(Addr, DC_DATA_SIZE, DC_Read, DC_Write, NULL);
+	accesses = 0;
+	for(uint32_t n = 0; n < Calls; n++)
+	{
+		if(Workload == 0)
+			SIM_CHECK(Telemetry_PutRecord(pTlm, TLM_REC_EVENTS, payload, sizeof(payload)) == TLM_OK);
+		else
+			SIM_CHECK(Crc_CRC32Soft(pData, DC_CRC_LEN) == Crc_CRC32Soft(pShadow, DC_CRC_LEN));
+	}
+	__asm__ volatile("" ::: "memory");
+
+	return accesses / Calls;
+}
+
+static void DC_Bench(uint32_t Calls)
+{
+	static const char *names[] = { "frame", "crc" };
+	uint32_t words, dmaCycles, counted[2][sizeof(regions) / sizeof(regions[0])];
+
+	words = DC_DMA(DC_DMA_LEN);
+	dmaCycles = words * DC_CYC_DMA_WORD;
+	printf("dma:    %u bytes from SRAM1, %u words, %u cycles alone\n\n", DC_DMA_LEN, words, dmaCycles);
+
+	printf("%-6s %-6s %10s %10s %12s %12s\n", "cpu", "data", "accesses", "cycles", "cpu stalls", "dma stalls");
+	for(uint8_t w = 0; w < 2; w++)
+	{
+		for(uint32_t r = 0; r < sizeof(regions) / sizeof(regions[0]); r++)
+		{
+			uint32_t cycles, overlap, collisions;
+
+			Sim_Reset();
+			Sim_CRCInit(&unit);
+			CRC_PeriClockControl(ENABLE);
+			counted[w][r] = DC_Count(w, regions[r].Addr, Calls);
+
+			// accesses while the transfer runs, one in DC_CYC_DMA_WORD hits the DMA's slave cycle
+			cycles = counted[w][r] * DC_CYC_ACCESS;
+			overlap = (cycles < dmaCycles) ? counted[w][r] : dmaCycles / DC_CYC_ACCESS;
+			collisions = regions[r].SharesDMASlave ? overlap / DC_CYC_DMA_WORD : 0;
+
+			printf("%-6s %-6s %10u %10u %12u %12u\n", names[w], regions[r].pName, counted[w][r], cycles,
+				   collisions / 2, collisions - collisions / 2);
+			SIM_CHECK(counted[w][r] > 0);
+			SIM_CHECK(counted[w][r] == counted[w][0]);
+		}
+	}
+	SIM_CHECK(unit.Unclocked == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100;
+
+	Sim_Init();
+	Sim_CRCInit(&unit);
+	CRC_PeriClockControl(ENABLE);
+	if(calls == 0)
+		calls = 100;
+
+	DC_Bench(calls);
+
+	return Sim_Report("dma_contention");
+}
@@ -0,0 +1,149 @@
+/*
+ * cron_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host benchmark of the cron next-fire computation (Inc/cron.h) over pathological expressions
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o cron_bench
+ * 			   cron_bench.c ../sim/sim.c ../../Src/cron.c ../../Src/alarm.c ../../Src/sched.c ../../Src/ringbuf.c
+ * 			   ../../BSP/rtc.c ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	cron_bench [calls per expression]
+ *
+ * For every expression Cron_Next() is timed from CB_STARTS random seconds between 2000 and 2099, and
+ * the worst single call is reported next to the average. The first CB_VERIFY results of each
+ * expression are checked against a minute by minute scan with Cron_Match(): the result matches, and
+ * no minute between the start and the result does. Expressions which never match must return
+ * CRON_NEVER. Host times, for the relative cost of the expressions. Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sim.h"
+#include "cron.h"
+
+#define CB_STARTS						1024
+#define CB_VERIFY						16
+#define CB_SCAN_LIMIT					(5 * 366 * 24 * 60)	/* Minutes scanned before a result is taken on trust */
+#define CB_LAST_EPOCH					3155759999UL		/* 31/12/99 23:59:59 */
+
+typedef struct
+{
+	const char		*pExpr;
+	const char		*pWhy;
+}CB_Case_t;
+
+static const CB_Case_t cases[] =
+{
+	{ "* * * * *",					"every minute, no skipping" },
+	{ "59 23 31 12 *",				"once a year, last minute" },
+	{ "0 0 29 2 *",					"leap day only" },
+	{ "0 0 31 * *",					"31st, skips the short months" },
+	{ "0 0 13 * FRI",				"day OR weekday" },
+	{ "0 0 * * SUN",				"weekday only" },
+	{ "*/7 */5 1-7 * MON",			"first week OR Mondays, stepped" },
+	{ "0 0 29 2 MON",				"leap day OR Monday" },
+	{ "59 23 29 2 *",				"leap day, last minute" },
+	{ "0 0 30 2 *",					"never: Feb 30" },
+	{ "0 0 31 2,4,6,9,11 *",		"never: 31st of short months" },
+};
+
+static uint64_t CB_Nanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint8_t CB_MatchesMinute(Cron_Expr_t *pExpr, uint32_t Epoch)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_fromEpoch(Epoch, &time, &date);
+	return Cron_Match(pExpr, &time, &date);
+}
+
+/*
+ * reference: first matching minute after After, minute by minute. 0 -> none within CB_SCAN_LIMIT
+ */
+static uint32_t CB_Scan(Cron_Expr_t *pExpr, uint32_t After)
+{
+	uint32_t epoch = After - (After % 60) + 60;
+
+	for(uint32_t i = 0; (i < CB_SCAN_LIMIT) && (epoch <= CB_LAST_EPOCH); i++, epoch += 60)
+	{
+		if(CB_MatchesMinute(pExpr, epoch))
+			return epoch;
+	}
+	return 0;
+}
+
+static void CB_Verify(Cron_Expr_t *pExpr, uint32_t After, uint32_t Next)
+{
+	uint32_t ref = CB_Scan(pExpr, After);
+
+	if(Next == CRON_NEVER)
+	{
+		SIM_CHECK(ref == 0);
+		return;
+	}
+
+	SIM_CHECK(Next > After);
+	SIM_CHECK((Next % 60) == 0);
+	SIM_CHECK(CB_MatchesMinute(pExpr, Next));
+	// no earlier match, as far as the scan went
+	SIM_CHECK((ref == Next) || ((ref == 0) && (Next - After > CB_SCAN_LIMIT * 60UL)));
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100;
+	static uint32_t starts[CB_STARTS];
+	Cron_Expr_t expr;
+	uint32_t seed = 2026, next = 0, never;
+	uint64_t t, call, total, worst;
+
+	for(uint32_t i = 0; i < CB_STARTS; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		starts[i] = (uint32_t)(((uint64_t)seed * CB_LAST_EPOCH) >> 32);
+	}
+
+	printf("%-24s %-34s %10s %10s %6s\n", "expression", "", "avg ns", "worst ns", "never");
+	for(uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+	{
+		SIM_CHECK(Cron_Parse(&expr, cases[c].pExpr) == CRON_OK);
+
+		total = 0;
+		worst = 0;
+		never = 0;
+		for(uint32_t i = 0; i < CB_STARTS; i++)
+		{
+			t = CB_Nanos();
+			for(uint32_t n = 0; n < calls; n++)
+				next = Cron_Next(&expr, starts[i]);
+			call = (CB_Nanos() - t) / calls;
+
+			total += call;
+			if(call > worst)
+				worst = call;
+			never += (next == CRON_NEVER);
+
+			if(i < CB_VERIFY)
+				CB_Verify(&expr, starts[i], next);
+		}
+
+		printf("%-24s %-34s %10llu %10llu %6u\n", cases[c].pExpr, cases[c].pWhy,
+			   (unsigned long long)(total / CB_STARTS), (unsigned long long)worst, never);
+	}
+
+	return Sim_Report("cron_bench");
+}
@@ -0,0 +1,270 @@
+/*
+ * eventrec_stress.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host stress test of the event recorder (Inc/eventrec.h) under edge storms, EXTI and TIM2 on the
+ * simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o eventrec_stress
+ * 			   eventrec_stress.c ../sim/sim.c ../../Src/eventrec.c ../../Src/ringbuf.c ../../Src/timestamp.c
+ * 			   ../../Src/telemetry.c ../../Src/flashlog.c ../../Src/crc.c ../../Src/syscalls.c ../../BSP/rtc.c
+ * 			   ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c ../../drivers/Src/stm32f407xx_flash.c
+ * 			   ../../drivers/Src/stm32f407xx_crc.c ../../Src/xprintf.c ../../drivers/Src/stm32f407xx_usart.c
+ * Usage:	eventrec_stress [ISR calls]
+ *
+ * Four lines: rising edge, falling edge and two dual edge lines (one on the shared EXTI15_10). EXTI->PR
+ * is modelled write 1 to clear, so only the lines whose bit the ISR clears are taken off. The timer
+ * runs 16 ticks per microsecond, so every stamp is exact
+ * 	- Storm: every ISR call has a random set of lines pending, the drain runs after a random number
+ * 	  of calls. Every recorded event must come out in order with its line, stamp and level, and recorded
+ * 	  plus dropped must be the number of pending bits the ISR saw
+ * 	- Burst: ES_BURST_CALLS ISR calls with all lines pending and no drain. The ring keeps the first events,
+ * 	  the rest are dropped and reported to the sink once
+ * 	- Short pulses (shorter than the ISR latency): single edge lines still get the right level, dual
+ * 	  edge lines the pin level at the ISR (the documented limitation)
+ *
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "eventrec.h"
+
+#define ES_RING_SIZE					64
+#define ES_LINES						4
+#define ES_BURST_CALLS					(ES_RING_SIZE * 2)
+#define ES_EXPECT_SIZE					1024					/* Power of two, > ES_RING_SIZE */
+#define ES_TICKS_PER_US					16
+
+static const EventRec_Line_t lines[ES_LINES] =
+{
+	{ GPIOA, 0,		GPIO_MODE_IT_RT,	GPIO_PUPD_NONE },
+	{ GPIOB, 3,		GPIO_MODE_IT_FT,	GPIO_PUPD_NONE },
+	{ GPIOC, 7,		GPIO_MODE_IT_RFT,	GPIO_PUPD_NONE },
+	{ GPIOD, 12,	GPIO_MODE_IT_RFT,	GPIO_PUPD_NONE },
+};
+
+static Timestamp_Handle_t ts;
+static EventRec_Handle_t rec;
+static EventRec_Event_t storage[ES_RING_SIZE];
+static uint32_t seed = 7;
+
+/*
+ * events the ISR should have recorded, in order
+ */
+static EventRec_Record_t expect[ES_EXPECT_SIZE];
+static uint32_t expectHead, expectTail;
+static uint32_t startCount, now;
+static uint32_t recorded, dropped, wrong, sinkCalls;
+
+static uint32_t ES_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/*
+ * EXTI model: PR is write 1 to clear, the other registers are plain memory
+ */
+static void ES_EXTIWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	(void)pContext;
+	if(Offset == 0x14)
+		SIM_REG(&EXTI->PR) = OldValue & ~SIM_REG(&EXTI->PR);
+}
+
+static void ES_Sink(void *pCtx, const EventRec_Record_t *pRecords, uint32_t Count, uint32_t Dropped)
+{
+	(void)pCtx;
+	sinkCalls++;
+	dropped += Dropped;
+
+	for(uint32_t i = 0; i < Count; i++, recorded++)
+	{
+		EventRec_Record_t *pExp = &expect[expectTail++ & (ES_EXPECT_SIZE - 1)];
+
+		if((expectTail > expectHead) || (pRecords[i].Line != pExp->Line) || (pRecords[i].Level != pExp->Level) ||
+		   (pRecords[i].Stamp.Seconds != pExp->Stamp.Seconds) || (pRecords[i].Stamp.Micros != pExp->Stamp.Micros))
+			wrong++;
+	}
+}
+
+static uint8_t ES_Pin(uint8_t Idx)
+{
+	return (SIM_REG(&lines[Idx].pGPIOx->IDR) >> lines[Idx].Pin) & 1;
+}
+
+static void ES_SetPin(uint8_t Idx, uint8_t Level)
+{
+	uint32_t mask = 1UL << lines[Idx].Pin;
+
+	SIM_REG(&lines[Idx].pGPIOx->IDR) = Level ? (SIM_REG(&lines[Idx].pGPIOx->IDR) | mask) : (SIM_REG(&lines[Idx].pGPIOx->IDR) & ~mask);
+}
+
+/*
+ * an edge on a line as the EXTI sees it: the pin moves, the pending bit is set if the trigger matches
+ */
+static void ES_Edge(uint8_t Idx)
+{
+	uint8_t level = !ES_Pin(Idx);
+
+	ES_SetPin(Idx, level);
+	if((lines[Idx].Trigger == GPIO_MODE_IT_RFT) || (level == (lines[Idx].Trigger == GPIO_MODE_IT_RT)))
+		SIM_REG(&EXTI->PR) |= (1UL << lines[Idx].Pin);
+}
+
+/*
+ * the EXTI ISR runs now. Lines are taken lowest first, as the handler does, the ones which do not
+ * fit in the ring are dropped. Returns the pending lines
+ */
+static uint32_t ES_ISR(void)
+{
+	uint32_t pending = SIM_REG(&EXTI->PR) & rec.LineMask;
+	uint32_t ticks = now - startCount;
+	uint32_t free = ES_RING_SIZE - RingBuf_Used(&rec.Ring);
+	EventRec_Record_t *pExp;
+
+	for(uint8_t line = 0; free && (line < 16); line++)
+	{
+		if(!(pending & (1UL << line)))
+			continue;
+
+		for(uint8_t i = 0; i < ES_LINES; i++)
+		{
+			if(lines[i].Pin != line)
+				continue;
+			pExp = &expect[expectHead++ & (ES_EXPECT_SIZE - 1)];
+			free--;
+			pExp->Line = line;
+			pExp->Level = (lines[i].Trigger == GPIO_MODE_IT_RFT) ? ES_Pin(i) : (lines[i].Trigger == GPIO_MODE_IT_RT);
+			pExp->Stamp.Seconds = ticks / (ES_TICKS_PER_US * 1000000UL);
+			pExp->Stamp.Micros = (ticks / ES_TICKS_PER_US) % 1000000UL;
+		}
+	}
+
+	TIM2->CNT = now;
+	EventRec_IRQHandling(&rec);
+	SIM_CHECK((SIM_REG(&EXTI->PR) & rec.LineMask) == 0);
+	return pending;
+}
+
+static void ES_Init(void)
+{
+	ts.Timestamp_Config.pTIMx = TIM2;
+	ts.Timestamp_Config.TimerClockHz = ES_TICKS_PER_US * 1000000UL;
+	TIM2->CNT = startCount = now = 0xFFF00000;		// wraps during the run
+	Timestamp_Init(&ts);
+
+	rec.EventRec_Config.pTsHandle = &ts;
+	rec.EventRec_Config.pStorage = storage;
+	rec.EventRec_Config.Size = ES_RING_SIZE;
+	rec.EventRec_Config.pLines = lines;
+	rec.EventRec_Config.NoOfLines = ES_LINES;
+	rec.EventRec_Config.IRQPriority = 2;
+	rec.EventRec_Config.pfnSink = ES_Sink;
+	SIM_CHECK(EventRec_Init(&rec) == EVENTREC_OK);
+	SIM_CHECK(rec.RisingEdges == (1 << 0) && rec.BothEdges == ((1 << 7) | (1 << 12)));
+}
+
+static void ES_Storm(uint32_t Calls)
+{
+	uint32_t seen = 0, pending, drainIn = 0;
+
+	for(uint32_t call = 0; call < Calls; call++)
+	{
+		// 1 to 4 edges land before the ISR gets in, up to ~125us apart
+		for(uint32_t n = 1 + ES_Random() % ES_LINES; n; n--)
+		{
+			ES_Edge(ES_Random() % ES_LINES);
+			now += 1 + ES_Random() % 2000;
+		}
+
+		pending = ES_ISR();
+		seen += __builtin_popcount(pending);
+
+		if(drainIn-- == 0)
+		{
+			EventRec_Drain(&rec, 0xFFFFFFFF);
+			drainIn = ES_Random() % 40;
+		}
+	}
+	EventRec_Drain(&rec, 0xFFFFFFFF);
+
+	printf("storm:  %u ISR calls, %u events, %u recorded, %u dropped, ring high water %u\n",
+		   Calls, seen, recorded, dropped, rec.Ring.HighWater);
+	SIM_CHECK(recorded + dropped == seen);
+	SIM_CHECK(rec.Dropped == dropped && rec.Ring.Overflows == dropped);
+	SIM_CHECK(wrong == 0);
+	SIM_CHECK(RingBuf_Used(&rec.Ring) == 0);
+}
+
+static void ES_Burst(void)
+{
+	uint32_t recordedBefore = recorded, droppedBefore = dropped, callsBefore, seen = 0;
+
+	// every line toggles on every call, the single edge lines are pending every other call
+	for(uint32_t call = 0; call < ES_BURST_CALLS; call++)
+	{
+		for(uint8_t i = 0; i < ES_LINES; i++)
+			ES_Edge(i);
+		now += 100;
+		seen += __builtin_popcount(ES_ISR());
+	}
+	SIM_CHECK(seen == ES_BURST_CALLS * 3);
+	SIM_CHECK(rec.Dropped - droppedBefore == seen - ES_RING_SIZE);
+
+	callsBefore = sinkCalls;
+	EventRec_Drain(&rec, 0xFFFFFFFF);
+	printf("burst:  %u events, %u recorded, %u dropped in %u sink calls\n",
+		   seen, recorded - recordedBefore, dropped - droppedBefore, sinkCalls - callsBefore);
+	SIM_CHECK(recorded - recordedBefore == ES_RING_SIZE);
+	SIM_CHECK(dropped - droppedBefore == seen - ES_RING_SIZE);
+	SIM_CHECK(wrong == 0);
+
+	// the drops are reported once
+	callsBefore = sinkCalls;
+	EventRec_Drain(&rec, 0xFFFFFFFF);
+	SIM_CHECK(sinkCalls == callsBefore);
+}
+
+static void ES_ShortPulses(void)
+{
+	// both edges of a pulse before the ISR runs: one pending bit per line
+	for(uint8_t i = 0; i < ES_LINES; i++)
+	{
+		ES_Edge(i);
+		ES_Edge(i);
+	}
+	now += 100;
+	SIM_CHECK(ES_ISR() == ((1 << 0) | (1 << 3) | (1 << 7) | (1 << 12)));
+	EventRec_Drain(&rec, 0xFFFFFFFF);
+	SIM_CHECK(wrong == 0);
+
+	// rising line: 1, falling line: 0 whatever the pin reads now. Dual edge lines read the pin back
+	SIM_CHECK(expect[(expectHead - 4) & (ES_EXPECT_SIZE - 1)].Level == 1);
+	SIM_CHECK(expect[(expectHead - 3) & (ES_EXPECT_SIZE - 1)].Level == 0);
+	SIM_CHECK(expect[(expectHead - 2) & (ES_EXPECT_SIZE - 1)].Level == ES_Pin(2));
+	SIM_CHECK(expect[(expectHead - 1) & (ES_EXPECT_SIZE - 1)].Level == ES_Pin(3));
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 50000;
+
+	Sim_Init();
+	Sim_AddModel(EXTI_BASEADDR, sizeof(EXTI_RegDef_t), NULL, ES_EXTIWrite, NULL);
+
+	ES_Init();
+	ES_Storm(calls);
+	ES_Burst();
+	ES_ShortPulses();
+
+	return Sim_Report("eventrec_stress");
+}
@@ -0,0 +1,316 @@
+/*
+ * flashlog_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the flash log (Inc/flashlog.h) on the simulated internal flash (tools/sim/flash_sim.h)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o flashlog_test flashlog_test.c
+ * 			   ../sim/sim.c ../sim/flash_sim.c ../../Src/flashlog.c ../../Src/crc.c
+ * 			   ../../drivers/Src/stm32f407xx_flash.c ../../drivers/Src/stm32f407xx_crc.c
+ * Usage:	flashlog_test
+ *
+ * The flash only programs bits from 1 to 0, and every program of a location which was not erased
+ * is counted and must stay 0 throughout
+ * 	- Wear: sectors 10 and 11 as on the board, appended through FT_ROTATIONS rotations. Every record
+ * 	  reads back, a reboot recovers the same log, the erase counts are Seq / 2 per sector and no
+ * 	  other sector is touched
+ * 	- Torn writes: the power fails on a random word of an append or of a rotation (erase, header,
+ * 	  first record), FT_TEARS times on two 16KB sectors to get many rotations. After every reboot the
+ * 	  log holds every record which completed, nothing of the torn one, and appends go on
+ * 	- Programming rules of the model and the driver: locked, 0 -> 1, write protection
+ *
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "flash_sim.h"
+#include "flashlog.h"
+
+#define FT_MAX_RECORDS					65536
+#define FT_ROTATIONS					3
+#define FT_TEARS						128
+#define FT_EPOCH						850000000UL			/* Some time in 2026 */
+
+static Sim_Flash_t flash;
+static FlashLog_Handle_t flog;
+static uint32_t seed = 41;
+
+/*
+ * every record the test appended: the sector sequence number it went to, 0 if it never completed
+ */
+static uint32_t refSeq[FT_MAX_RECORDS];
+static uint8_t refLen[FT_MAX_RECORDS];
+static uint32_t noOfRecords;
+static uint8_t expectOldValid;
+
+static uint32_t FT_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint8_t FT_Byte(uint32_t N, uint32_t i)
+{
+	return (uint8_t)(N * 7 + i);
+}
+
+static void FT_Start(uint8_t Sector0, uint8_t Sector1)
+{
+	Sim_Reset();
+	Sim_FlashInit(&flash);
+
+	flog.FlashLog_Config.Sector[0] = Sector0;
+	flog.FlashLog_Config.Sector[1] = Sector1;
+	flog.FlashLog_Config.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+	SIM_CHECK(FlashLog_Init(&flog) == FLASHLOG_OK);
+	SIM_CHECK(flog.Seq == 1 && flog.LastAddr == 0);
+
+	noOfRecords = 0;
+	expectOldValid = 0;
+}
+
+/*
+ * 1 -> the next append of Len bytes rotates
+ */
+static uint8_t FT_RotationDue(uint32_t Len)
+{
+	uint8_t sector = flog.FlashLog_Config.Sector[flog.Active];
+	uint32_t end = FLASH_GetSectorAddr(sector) + FLASH_GetSectorSize(sector);
+
+	return (FLASHLOG_RECORD_OVERHEAD + ((Len + 3) & ~3UL)) > end - flog.WriteAddr;
+}
+
+/*
+ * appends record N, the power may fail inside (the caller sets FailAfter)
+ */
+static uint8_t FT_Append(uint32_t Len)
+{
+	static uint8_t payload[FLASHLOG_MAX_PAYLOAD];
+	uint32_t n = noOfRecords++;
+	uint8_t status;
+
+	for(uint32_t i = 0; i < Len; i++)
+		payload[i] = FT_Byte(n, i);
+	refLen[n] = (uint8_t)Len;
+	refSeq[n] = 0;
+
+	status = FlashLog_Append(&flog, (uint8_t)(n % 251), FT_EPOCH + n, payload, (uint16_t)Len);
+	if(status == FLASHLOG_OK)
+	{
+		refSeq[n] = flog.Seq;
+		expectOldValid |= (flog.Seq > 1);
+	}
+	return status;
+}
+
+static uint8_t FT_Same(uint32_t N, const FlashLog_Record_t *pRecord)
+{
+	if((pRecord->Type != N % 251) || (pRecord->Len != refLen[N]) || (pRecord->Timestamp != FT_EPOCH + N))
+		return 0;
+	for(uint32_t i = 0; i < pRecord->Len; i++)
+	{
+		if(pRecord->pData[i] != FT_Byte(N, i))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * the log must read back exactly the completed records of the two newest sectors, in order
+ */
+static void FT_Verify(void)
+{
+	uint32_t first = (flog.OldValid ? flog.Seq - 1 : flog.Seq), read = 0, wrong = 0, last = 0;
+	FlashLog_Cursor_t cursor;
+	FlashLog_Record_t record;
+	uint8_t status;
+	uint32_t n = 0;
+
+	SIM_CHECK(flog.OldValid == expectOldValid);
+
+	status = FlashLog_First(&flog, &cursor, &record);
+	for(; status == FLASHLOG_OK; status = FlashLog_Next(&flog, &cursor, &record), read++)
+	{
+		while((n < noOfRecords) && ((refSeq[n] < first) || (refSeq[n] > flog.Seq)))
+			n++;
+		if((n == noOfRecords) || !FT_Same(n, &record))
+			wrong++;
+		last = n++;
+	}
+	while((n < noOfRecords) && ((refSeq[n] < first) || (refSeq[n] > flog.Seq)))
+		n++;
+
+	SIM_CHECK(wrong == 0);
+	SIM_CHECK(n == noOfRecords);
+	SIM_CHECK(read == flog.Records[0] + flog.Records[1]);
+	if(read)
+	{
+		SIM_CHECK(FlashLog_GetLast(&flog, &record) == FLASHLOG_OK);
+		SIM_CHECK(FT_Same(last, &record));
+	}
+
+	SIM_CHECK(flash.Overwrites == 0 && flash.ZeroToOne == 0 && flash.SeqErrors == 0);
+}
+
+static void FT_Wear(void)
+{
+	uint32_t words = 3, seq = 1, writeAddr, lastAddr;
+
+	FT_Start(10, 11);
+	SIM_CHECK(flash.EraseCount[10] == 1);
+
+	while(flog.Seq <= FT_ROTATIONS)
+	{
+		uint32_t len = FT_Random() % 33;
+
+		SIM_CHECK(FT_Append(len) == FLASHLOG_OK);
+		words += (FLASHLOG_RECORD_OVERHEAD + ((len + 3) & ~3UL)) / 4;
+		if(flog.Seq != seq)
+		{
+			words += 3;
+			seq = flog.Seq;
+		}
+		if(noOfRecords == FT_MAX_RECORDS)
+			break;
+	}
+	FT_Verify();
+
+	// a reboot finds the same log
+	writeAddr = flog.WriteAddr;
+	lastAddr = flog.LastAddr;
+	SIM_CHECK(FlashLog_Init(&flog) == FLASHLOG_OK);
+	SIM_CHECK(flog.WriteAddr == writeAddr && flog.LastAddr == lastAddr && flog.Skipped == 0);
+	FT_Verify();
+
+	printf("wear:   %u records, Seq %u, sector 10 erased %u, sector 11 erased %u, %u words programmed\n",
+		   noOfRecords, flog.Seq, flash.EraseCount[10], flash.EraseCount[11],
+		   flash.ProgramCount[10] + flash.ProgramCount[11]);
+	SIM_CHECK(flash.EraseCount[10] == (flog.Seq + 1) / 2 && flash.EraseCount[11] == flog.Seq / 2);
+	SIM_CHECK(flash.ProgramCount[10] + flash.ProgramCount[11] == words);
+	for(uint8_t sector = 0; sector < 10; sector++)
+		SIM_CHECK(flash.EraseCount[sector] == 0 && flash.ProgramCount[sector] == 0);
+}
+
+static void FT_Torn(void)
+{
+	static uint32_t trial, tornAt, ops, seq, len;
+	static uint8_t rotate;
+
+	FT_Start(2, 3);
+
+	for(trial = 0; trial < FT_TEARS && noOfRecords < FT_MAX_RECORDS - 1024; trial++)
+	{
+		// every fourth trial tears a rotation
+		len = FT_Random() % (FLASHLOG_MAX_PAYLOAD + 1);
+		for(uint32_t i = FT_Random() % 16; (i || !(trial & 3)) && !FT_RotationDue(len); i -= (i != 0))
+		{
+			SIM_CHECK(FT_Append(len) == FLASHLOG_OK);
+			len = FT_Random() % (FLASHLOG_MAX_PAYLOAD + 1);
+		}
+
+		// erase and 3 header words, then the record
+		rotate = FT_RotationDue(len);
+		ops = (rotate ? 4 : 0) + (FLASHLOG_RECORD_OVERHEAD + ((len + 3) & ~3UL)) / 4;
+		tornAt = 1 + FT_Random() % ops;
+		seq = flog.Seq;
+
+		if(SIM_POWER_CYCLE() == 0)
+		{
+			flash.FailAfter = tornAt;
+			FT_Append(len);
+			SIM_CHECK(0);		// the power did not fail
+		}
+
+		// reboot
+		Sim_FlashPowerOn(&flash);
+		SIM_CHECK(flash.Tears == trial + 1);
+		if(rotate && ((tornAt < 4) || ((tornAt == 4) && ((~(seq + 1) >> 16) != 0xFFFF))))
+		{
+			// the new sector has no header, the older half went with the erase. A torn ~Seq with
+			// nothing to program in its high half is complete
+			expectOldValid = 0;
+		}
+		else if(rotate)
+		{
+			seq++;
+			expectOldValid = 1;
+		}
+
+		SIM_CHECK(FlashLog_Init(&flog) == FLASHLOG_OK);
+		SIM_CHECK(flog.Seq == seq);
+		FT_Verify();
+	}
+
+	// appends go on behind the torn words
+	for(uint32_t i = 0; i < 64; i++)
+		SIM_CHECK(FT_Append(FT_Random() % 33) == FLASHLOG_OK);
+	FT_Verify();
+
+	printf("torn:   %u power fails, %u records appended, Seq %u, sector 2 erased %u, sector 3 erased %u\n",
+		   flash.Tears, noOfRecords, flog.Seq, flash.EraseCount[2], flash.EraseCount[3]);
+}
+
+static void FT_Rules(void)
+{
+	uint32_t addr = FLASH_GetSectorAddr(9), word = 0x12345678, zero = 0;
+
+	FT_Start(10, 11);
+
+	// locked: nothing is programmed
+	SIM_CHECK(FLASH_Program(addr, &word, 4, FLASH_VOLTAGE_RANGE_3) == FLASH_ERR_PROG);
+	SIM_CHECK(SIM_REG(addr) == FLASHLOG_ERASED && flash.SeqErrors == 1);
+
+	FLASH_Unlock();
+	SIM_CHECK(FLASH_Program(addr, &word, 4, FLASH_VOLTAGE_RANGE_3) == FLASH_OK);
+	SIM_CHECK(SIM_REG(addr) == word);
+
+	// programming again: old AND new, a 0 never becomes 1
+	word = 0xFFFF0000;
+	SIM_CHECK(FLASH_Program(addr, &word, 4, FLASH_VOLTAGE_RANGE_3) == FLASH_OK);
+	SIM_CHECK(SIM_REG(addr) == 0x12340000 && flash.Overwrites == 1 && flash.ZeroToOne == 1);
+	SIM_CHECK(FLASH_Program(addr, &zero, 4, FLASH_VOLTAGE_RANGE_3) == FLASH_OK);
+	SIM_CHECK(SIM_REG(addr) == 0 && flash.Overwrites == 2 && flash.ZeroToOne == 1);
+
+	// byte programming of an erased byte next to programmed ones is fine
+	SIM_CHECK(FLASH_Program(addr + 5, &word, 1, FLASH_VOLTAGE_RANGE_1) == FLASH_OK);
+	SIM_CHECK(SIM_REG(addr + 4) == 0xFFFF00FF && flash.Overwrites == 2);
+
+	// write protection
+	flash.WriteProtect = (1U << 9);
+	SIM_CHECK(FLASH_EraseSector(9, FLASH_VOLTAGE_RANGE_3) == FLASH_ERR_WRP);
+	SIM_CHECK(FLASH_Program(addr + 8, &word, 4, FLASH_VOLTAGE_RANGE_3) == FLASH_ERR_WRP);
+	SIM_CHECK(SIM_REG(addr) == 0 && SIM_REG(addr + 8) == FLASHLOG_ERASED);
+	flash.WriteProtect = 0;
+
+	SIM_CHECK(FLASH_EraseSector(9, FLASH_VOLTAGE_RANGE_3) == FLASH_OK);
+	SIM_CHECK(SIM_REG(addr) == FLASHLOG_ERASED && flash.EraseCount[9] == 1);
+	FLASH_Lock();
+
+	// a wrong key sequence keeps the flash locked till the next power on
+	SIM_REG(addr) = 0;
+	FLASH->KEYR = FLASH_KEY2;
+	FLASH_Unlock();
+	SIM_CHECK(FLASH->CR & (1UL << FLASH_CR_LOCK));
+	FLASH_EraseSector(9, FLASH_VOLTAGE_RANGE_3);
+	SIM_CHECK(SIM_REG(addr) == 0 && flash.EraseCount[9] == 1);
+	Sim_FlashPowerOn(&flash);
+	FLASH_Unlock();
+	SIM_CHECK(!(FLASH->CR & (1UL << FLASH_CR_LOCK)));
+	FLASH_Lock();
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	FT_Wear();
+	FT_Torn();
+	FT_Rules();
+
+	return Sim_Report("flashlog");
+}
@@ -0,0 +1,164 @@
+/*
+ * regbit_stress.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host stress test of the single bit register macros (REG_SET_BIT, REG_CLR_BIT, REG_TOGGLE_BIT in
+ * stm32f407xx.h) and GPIO_TogglePinOutput(), with real threads in place of thread and ISR code, on one
+ * simulated register (GPIOD->ODR, tools/sim)
+ *
+ * Build:	cc -O2 -pthread -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o regbit_stress
+ * 			   regbit_stress.c ../sim/sim.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * Usage:	regbit_stress [rounds per thread]
+ *
+ * Two threads start together on a barrier. Thread 0 owns the even bits of the register, thread 1 the
+ * odd ones, nobody else writes them, and each keeps a copy of its bits. A read-modify-write that is not
+ * a single bit update writes the other thread's bits back stale
+ * 	- Every round a thread changes one of its bits: set (REG_SET_BIT), toggle twice
+ * 	  (GPIO_TogglePinOutput) and clear (REG_CLR_BIT) in turn, so its bits stay set across rounds.
+ * 	  After each change its bits in the register have to match its copy
+ * 	- The register ends as the two copies
+ * 	- The threads yield at random points, so they interleave on a single core too
+ * 	- The same rounds with a plain read and write, a random sched_yield() between them, show the test
+ * 	  catches lost updates: it has to lose some
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "sim.h"
+#include "stm32f407xx.h"
+
+#define GB_THREADS						2
+#define GB_BITS							16			/* ODR width, the pins */
+
+typedef struct
+{
+	uint8_t			Thread;
+	uint8_t			Plain;					/* 1 -> plain read, yield, write for comparison */
+	uint32_t		Seed;					/* To store the thread's random state, the yields */
+	uint32_t		Bits;					/* To store the thread's copy of its bits */
+	uint32_t		Lost;					/* To store the checks that found a bit changed by the other thread */
+}GB_Worker_t;
+
+static pthread_barrier_t start;
+static uint32_t rounds = 1000000;
+
+static uint32_t GB_Random(GB_Worker_t *pWorker)
+{
+	pWorker->Seed = pWorker->Seed * 1103515245 + 12345;
+	return pWorker->Seed >> 8;
+}
+
+/*
+ * one change with plain accesses, a yield leaves the other thread a window between the read and the write
+ */
+static void GB_Plain(GB_Worker_t *pWorker, uint8_t Op, uint8_t Bit)
+{
+	__vo uint32_t *pODR = &GPIOD->ODR;
+	uint32_t value = *pODR;
+
+	if(GB_Random(pWorker) & 1)
+		sched_yield();
+	if(Op == 0)
+		*pODR = value | (1UL << Bit);
+	else if(Op == 3)
+		*pODR = value & ~(1UL << Bit);
+	else
+		*pODR = value ^ (1UL << Bit);
+}
+
+static void* GB_Run(void *pArg)
+{
+	GB_Worker_t *pWorker = (GB_Worker_t*)pArg;
+	const uint32_t mask = 0x5555UL << pWorker->Thread;
+
+	pthread_barrier_wait(&start);
+	for(uint32_t r = 0; r < rounds; r++)
+	{
+		uint8_t bit = (uint8_t)(((r * GB_THREADS) + pWorker->Thread) % GB_BITS);
+		uint8_t op = (uint8_t)((r / (GB_BITS / GB_THREADS)) % 4);
+
+		// random yields, so the threads interleave on a single core too and not in lock step
+		if(GB_Random(pWorker) & 1)
+			sched_yield();
+
+		if(pWorker->Plain)
+			GB_Plain(pWorker, op, bit);
+		else if(op == 0)
+			REG_SET_BIT(GPIOD->ODR, bit);
+		else if(op == 3)
+			REG_CLR_BIT(GPIOD->ODR, bit);
+		else
+			GPIO_TogglePinOutput(GPIOD, bit);
+		pWorker->Bits ^= (1UL << bit);
+
+		// count a loss once and go on from what the register holds
+		if((GPIOD->ODR & mask) != pWorker->Bits)
+		{
+			pWorker->Lost++;
+			pWorker->Bits = GPIOD->ODR & mask;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * lost updates over both threads
+ */
+static uint32_t GB_Stress(uint8_t Plain)
+{
+	pthread_t threads[GB_THREADS];
+	GB_Worker_t workers[GB_THREADS];
+	uint32_t lost = 0;
+
+	GPIOD->ODR = 0;
+	pthread_barrier_init(&start, NULL, GB_THREADS);
+	for(uint8_t t = 0; t < GB_THREADS; t++)
+	{
+		workers[t].Thread = t;
+		workers[t].Plain = Plain;
+		workers[t].Seed = 50 + t;
+		workers[t].Bits = 0;
+		workers[t].Lost = 0;
+		pthread_create(&threads[t], NULL, GB_Run, &workers[t]);
+	}
+	for(uint8_t t = 0; t < GB_THREADS; t++)
+	{
+		pthread_join(threads[t], NULL);
+		lost += workers[t].Lost;
+	}
+	pthread_barrier_destroy(&start);
+	if(!Plain)
+		SIM_CHECK(GPIOD->ODR == (workers[0].Bits | workers[1].Bits));
+
+	return lost;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t lost;
+
+	if(argc > 1)
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	if(rounds == 0)
+		rounds = 1000000;
+
+	Sim_Init();
+
+	lost = GB_Stress(1);
+	printf("plain read / write: %u of %u changes lost\n", lost, rounds * GB_THREADS);
+	SIM_CHECK(lost > 0);
+
+	lost = GB_Stress(0);
+	printf("REG_*_BIT, toggle:  %u of %u changes lost\n", lost, rounds * GB_THREADS);
+	SIM_CHECK(lost == 0);
+
+	return Sim_Report("regbit_stress");
+}
@@ -0,0 +1,201 @@
+/*
+ * irtc_init_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the on-chip RTC init (IRTC_Init, stm32f407xx_irtc.c) and the LSE / LSI fallback of
+ * main.c on a simulated backup domain (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o irtc_init_test irtc_init_test.c
+ * 			   ../sim/sim.c ../sim/irtc_sim.c ../../drivers/Src/stm32f407xx_irtc.c
+ * 			   ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * Usage:	irtc_init_test
+ *
+ * 	- No crystal: the first boot falls back to LSI. IR_REBOOTS MCU resets later the calendar and the
+ * 	  backup registers are still there, the backup domain was never reset and LSE is left off
+ * 	- Crystal: the same on LSE
+ * 	- Crystal fitted later: one backup domain reset, LSE from then on, the time is lost
+ * 	- Crystal failed: the calendar stood still, one backup domain reset, LSI from then on
+ * 	- DBP: with DBP clear (after an MCU reset, before IRTC_Init) backup register and RTC writes are
+ * 	  lost, IRTC_SetDateTime() times out and the calendar keeps its time. Without the RTC_WPR keys
+ * 	  the calendar can not be written either
+ * No boot may lose a write to DBP or to the key lock. Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "irtc_sim.h"
+#include "stm32f407xx_irtc.h"
+
+#define IR_REBOOTS						64
+#define IR_BKP_PATTERN					0xA5C30000UL
+
+static Sim_IRTC_t part;
+static IRTC_Handle_t irtc;
+static const IRTC_DateTime_t setTime = { 56, 34, 12, 1, 19, 10, 26 };
+
+/*
+ * MCU reset and the on-chip RTC part of main.c: LSE, LSI when the crystal does not start
+ */
+static uint8_t IR_Boot(void)
+{
+	Sim_IRTCReset(&part);
+	memset(&irtc, 0, sizeof(irtc));
+
+	irtc.IRTC_Config.ClockSource = IRTC_CLOCK_LSE;
+	if(IRTC_Init(&irtc) == IRTC_OK)
+		return IRTC_OK;
+
+	irtc.IRTC_Config.ClockSource = IRTC_CLOCK_LSI;
+	return IRTC_Init(&irtc);
+}
+
+static uint8_t IR_Source(void)
+{
+	return (SIM_REG(&RCC->BDCR) >> RCC_BDCR_RTCSEL) & 0x3;
+}
+
+static void IR_Set(void)
+{
+	SIM_CHECK(IRTC_SetDateTime(&irtc, &setTime) == IRTC_OK);
+	for(uint8_t i = 0; i < IRTC_NO_OF_BKP; i++)
+		IRTC_WriteBackup(i, IR_BKP_PATTERN | i);
+}
+
+/*
+ * 1 -> the calendar and every backup register hold what IR_Set() wrote
+ */
+static uint8_t IR_Kept(void)
+{
+	IRTC_DateTime_t now;
+
+	IRTC_GetDateTime(&irtc, &now);
+	if(memcmp(&now, &setTime, sizeof(now)) != 0)
+		return 0;
+
+	for(uint8_t i = 0; i < IRTC_NO_OF_BKP; i++)
+	{
+		if(IRTC_ReadBackup(i) != (IR_BKP_PATTERN | i))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * a cold boot on Source, then IR_REBOOTS warm ones
+ */
+static void IR_Reboots(const char *pName, uint8_t Source)
+{
+	uint32_t lost = 0, gone = 0, errors = 0;
+
+	Sim_IRTCPowerOn(&part);
+	SIM_CHECK(IR_Boot() == IRTC_OK);
+	SIM_CHECK(IRTC_IsTimeLost(&irtc) == 1);
+	SIM_CHECK(IR_Source() == Source);
+	IR_Set();
+	SIM_CHECK(IR_Kept());
+
+	part.Resets = 0;
+	for(uint32_t boot = 0; boot < IR_REBOOTS; boot++)
+	{
+		errors += (IR_Boot() != IRTC_OK);
+		lost += IRTC_IsTimeLost(&irtc);
+		gone += !IR_Kept();
+	}
+
+	printf("%-10s %u reboots, %u lost, %u lost the calendar, %u backup domain resets\n", pName, IR_REBOOTS,
+		   lost, gone, part.Resets);
+	SIM_CHECK(errors == 0 && lost == 0 && gone == 0);
+	SIM_CHECK(part.Resets == 0);
+	SIM_CHECK(IR_Source() == Source);
+	SIM_CHECK(Sim_IRTCIsRunning());
+	// a crystal which did not start is not left oscillating
+	SIM_CHECK(!!(SIM_REG(&RCC->BDCR) & (1 << RCC_BDCR_LSEON)) == (Source == IRTC_CLOCK_LSE));
+}
+
+static void IR_SourceChanges(void)
+{
+	// fitted later, on battery: LSE takes over, which needs the reset
+	part.LSEFitted = 0;
+	Sim_IRTCPowerOn(&part);
+	SIM_CHECK(IR_Boot() == IRTC_OK);
+	IR_Set();
+	part.LSEFitted = 1;
+	part.Resets = 0;
+	SIM_CHECK(IR_Boot() == IRTC_OK);
+	printf("fitted:    %u backup domain resets, time lost %u\n", part.Resets, IRTC_IsTimeLost(&irtc));
+	SIM_CHECK(IR_Source() == IRTC_CLOCK_LSE && part.Resets == 1);
+	SIM_CHECK(IRTC_IsTimeLost(&irtc) == 1 && IRTC_ReadBackup(0) == 0);
+
+	// the crystal stops, the calendar with it: LSI takes over
+	IR_Set();
+	part.LSEFitted = 0;
+	SIM_REG(&RCC->BDCR) &= ~(1UL << RCC_BDCR_LSERDY);
+	part.Resets = 0;
+	SIM_CHECK(IR_Boot() == IRTC_OK);
+	printf("failed:    %u backup domain resets, time lost %u\n", part.Resets, IRTC_IsTimeLost(&irtc));
+	SIM_CHECK(IR_Source() == IRTC_CLOCK_LSI && part.Resets == 1);
+	SIM_CHECK(IRTC_IsTimeLost(&irtc) == 1 && Sim_IRTCIsRunning());
+
+	// and stays there
+	IR_Set();
+	part.Resets = 0;
+	SIM_CHECK(IR_Boot() == IRTC_OK && IRTC_IsTimeLost(&irtc) == 0 && IR_Kept() && part.Resets == 0);
+}
+
+static void IR_WriteProtection(void)
+{
+	IRTC_DateTime_t other = setTime;
+	uint32_t dropped;
+
+	Sim_IRTCPowerOn(&part);
+	SIM_CHECK(IR_Boot() == IRTC_OK);
+	IR_Set();
+	SIM_CHECK(part.Dropped == 0 && part.Locked == 0);
+
+	// MCU reset, DBP is clear until IRTC_Init()
+	Sim_IRTCReset(&part);
+	IRTC_WriteBackup(0, 0x12345678);
+	SIM_CHECK(part.Dropped == 1 && IRTC_ReadBackup(0) == IR_BKP_PATTERN);
+
+	other.Hours = 3;
+	SIM_CHECK(IRTC_SetDateTime(&irtc, &other) == IRTC_ERR_TIMEOUT);
+	dropped = part.Dropped;
+	printf("dbp:       %u writes lost with DBP clear\n", dropped);
+	SIM_CHECK(dropped > 1 && IR_Kept());
+
+	// DBP set, no RTC_WPR keys
+	SIM_CHECK(IR_Boot() == IRTC_OK && IRTC_IsTimeLost(&irtc) == 0 && IR_Kept());
+	SIM_CHECK(part.Dropped == dropped);
+	IRTC->TR = 0;
+	IRTC->ISR = 0xFFFFFFFF;
+	// the hooks counted in the signal handler, behind the compiler's back
+	__asm__ volatile("" ::: "memory");
+	SIM_CHECK(part.Locked == 2 && IR_Kept());
+	SIM_CHECK(!(IRTC->ISR & (1 << IRTC_ISR_INITF)));
+
+	// with both locks open again
+	SIM_CHECK(IRTC_SetDateTime(&irtc, &other) == IRTC_OK);
+	IRTC_WriteBackup(0, 0x12345678);
+	SIM_CHECK(IRTC_ReadBackup(0) == 0x12345678 && part.Dropped == dropped && part.Locked == 2);
+}
+
+int main(void)
+{
+	Sim_Init();
+	Sim_IRTCInit(&part, 0);
+
+	IR_Reboots("no crystal", IRTC_CLOCK_LSI);
+	part.LSEFitted = 1;
+	IR_Reboots("crystal", IRTC_CLOCK_LSE);
+	IR_SourceChanges();
+	IR_WriteProtection();
+
+	SIM_CHECK(part.SelRefused == 0);
+
+	return Sim_Report("irtc_init");
+}
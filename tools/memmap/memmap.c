@@ -0,0 +1,109 @@
+/*
+ * memmap.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Reports which memory region every function and variable of the firmware landed in
+ *
+ * Build:	cc -O2 -o memmap memmap.c
+ * Usage:	arm-none-eabi-nm -S -n Debug/RTC_LED_PROJECT.elf | memmap
+ *
+ * Functions in SRAM are the __RAMFUNC ones (copied by Reset_Handler). Code in CCM RAM can not
+ * execute on the F4 and is flagged. Per region totals are printed at the end
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+typedef struct
+{
+	const char	*name;
+	uint32_t	start;
+	uint32_t	size;
+	uint32_t	code;
+	uint32_t	data;
+	uint32_t	functions;
+}Region_t;
+
+static Region_t regions[] = {
+	{ "FLASH", 0x08000000,  768 * 1024, 0, 0, 0 },		/* As the linker script, sectors 10 and 11 hold the flash log */
+	{ "CCM",   0x10000000,   64 * 1024, 0, 0, 0 },
+	{ "SRAM1", 0x20000000,  112 * 1024, 0, 0, 0 },
+	{ "SRAM2", 0x2001C000,   16 * 1024, 0, 0, 0 },
+};
+
+#define NUM_REGIONS		(sizeof(regions) / sizeof(regions[0]))
+
+static Region_t* FindRegion(uint32_t addr)
+{
+	for(size_t i = 0; i < NUM_REGIONS; i++)
+	{
+		if(addr - regions[i].start < regions[i].size)
+			return &regions[i];
+	}
+
+	return NULL;
+}
+
+int main(void)
+{
+	char line[512];
+	char name[256];
+	char type;
+	unsigned int addr, size;
+	int errors = 0;
+
+	printf("%-6s %-10s %6s  %s\n", "region", "address", "size", "function");
+
+	while(fgets(line, sizeof(line), stdin))
+	{
+		Region_t *pRegion;
+		uint8_t isCode;
+
+		// "addr size type name". Symbols without a size (labels, linker symbols) are skipped
+		if(sscanf(line, "%x %x %c %255s", &addr, &size, &type, name) != 4)
+			continue;
+
+		pRegion = FindRegion(addr);
+		if(pRegion == NULL)
+			continue;
+
+		isCode = (tolower((unsigned char)type) == 't');
+		if(isCode)
+		{
+			pRegion->code += size;
+			pRegion->functions++;
+
+			// flash code is the normal case, only list what runs from RAM
+			if(pRegion != &regions[0])
+				printf("%-6s 0x%08x %6u  %s\n", pRegion->name, addr, size, name);
+
+			if(pRegion == &regions[1])
+			{
+				fprintf(stderr, "error: %s is in CCM RAM, which can not execute code\n", name);
+				errors++;
+			}
+		}
+		else
+		{
+			pRegion->data += size;
+		}
+	}
+
+	printf("\n%-6s %10s %10s %10s %10s\n", "region", "functions", "code", "data", "free");
+	for(size_t i = 0; i < NUM_REGIONS; i++)
+	{
+		Region_t *pRegion = &regions[i];
+		uint32_t used = pRegion->code + pRegion->data;
+
+		printf("%-6s %10u %10u %10u %10u\n", pRegion->name, pRegion->functions, pRegion->code,
+				pRegion->data, (used < pRegion->size) ? (pRegion->size - used) : 0);
+	}
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,410 @@
+/*
+ * mempool_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host benchmark of the fixed-block pools (Inc/mempool.h) against a simple _sbrk heap of the same
+ * size, on one mixed-size alloc/free trace (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o mempool_bench mempool_bench.c
+ * 			   ../sim/sim.c ../../Src/mempool.c
+ * Usage:	mempool_bench [operations]
+ *
+ * The trace is what the firmware asks the C library for: mostly small strings and stdio state, a few
+ * line buffers and the odd BUFSIZ stdio buffer, up to MB_MAX_LIVE blocks alive at a time
+ * 	- Pools: Mempool_Alloc() / Mempool_Free()
+ * 	- Heap: first fit free list on an _sbrk break, address ordered, neighbours merged on free, an 8 byte
+ * 	  header per block. What newlib's allocator does in a small arena, without its bins
+ * 	- Every block is filled on alloc and checked on free (no overlap). Both allocators get
+ * 	  MEMPOOL_ARENA_SIZE bytes and the same requests, a failed one only leaves a block less to free
+ * 	- Latency: ns per call without the clock, mean and 99.9th percentile (the worst case on a host is
+ * 	  the OS, not the allocator). Fragmentation: pools waste inside the blocks (block size
+ * 	  against the request), the heap between them (1 - largest free / free below the break, at
+ * 	  every failure and at the end). Failures per allocator
+ * 	- Host times, for the relative cost of the two allocators, not the cycles on the target
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "mempool.h"
+
+#define MB_OPERATIONS					1000000
+#define MB_MAX_LIVE						40
+#define MB_HEADER						8
+#define MB_ALIGN						8
+#define MB_HIST_NS						1024
+
+/*
+ * Heap block. Free blocks are chained in address order, Size includes the header
+ */
+typedef struct MB_Block
+{
+	uint32_t		Size;
+	struct MB_Block	*pNext;
+}MB_Block_t;
+
+typedef struct
+{
+	uint8_t			*pBlock;
+	uint32_t		Size;
+	uint8_t			Fill;
+}MB_Live_t;
+
+/*
+ * Trace entry. Size 0 -> free the live block Pick % live blocks
+ */
+typedef struct
+{
+	uint32_t		Size;
+	uint32_t		Pick;
+}MB_Op_t;
+
+typedef struct
+{
+	const char		*pName;
+	uint64_t		AllocNs;
+	uint64_t		FreeNs;
+	uint32_t		AllocHist[MB_HIST_NS];	/* Calls per ns, the last bin for the slower ones */
+	uint32_t		FreeHist[MB_HIST_NS];
+	uint32_t		Allocs;
+	uint32_t		Frees;
+	uint32_t		Failures;
+	uint32_t		Corrupted;
+	MB_Live_t		Live[MB_MAX_LIVE];
+	uint32_t		NoOfLive;
+}MB_Stats_t;
+
+static uint8_t heapArena[MEMPOOL_ARENA_SIZE] __attribute__((aligned(MB_ALIGN)));
+static uint8_t *pBreak = heapArena;
+static MB_Block_t *pFreeList;
+static uint64_t wasteBytes, blockBytes;
+static double heapFragSum, heapFragWorst;
+static uint32_t heapFragSamples;
+static MB_Op_t *pTrace;
+static uint64_t clockNs;						/* Cost of a MB_Nanos() pair, taken off every call */
+static uint32_t seed = 30;
+
+static uint32_t MB_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint64_t MB_Nanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t MB_Elapsed(uint64_t T0)
+{
+	uint64_t t = MB_Nanos() - T0;
+
+	return (t > clockNs) ? t - clockNs : 0;
+}
+
+static void MB_Book(uint32_t *pHist, uint64_t *pTotal, uint64_t T)
+{
+	*pTotal += T;
+	pHist[(T < MB_HIST_NS) ? T : MB_HIST_NS - 1]++;
+}
+
+static uint32_t MB_Percentile(const uint32_t *pHist, uint32_t Calls, double Fraction)
+{
+	uint32_t sum = 0, ns = 0;
+
+	while((ns < MB_HIST_NS - 1) && (sum + pHist[ns] < Fraction * Calls))
+		sum += pHist[ns++];
+	return ns;
+}
+
+/*
+ * the _sbrk of sysmem.c on a fixed arena
+ */
+static void* MB_Sbrk(uint32_t Incr)
+{
+	uint8_t *pPrev = pBreak;
+
+	if(pBreak + Incr > &heapArena[sizeof(heapArena)])
+		return (void*)-1;
+	pBreak += Incr;
+	return pPrev;
+}
+
+static void* MB_HeapAlloc(uint32_t Size)
+{
+	uint32_t need = (Size + MB_HEADER + MB_ALIGN - 1) & ~(MB_ALIGN - 1);
+	MB_Block_t **ppPrev = &pFreeList;
+	MB_Block_t *pBlock;
+
+	// first fit, split when the rest can hold a block
+	for(pBlock = pFreeList; pBlock; ppPrev = &pBlock->pNext, pBlock = pBlock->pNext)
+	{
+		if(pBlock->Size < need)
+			continue;
+		if(pBlock->Size - need >= MB_HEADER + MB_ALIGN)
+		{
+			MB_Block_t *pRest = (MB_Block_t*)((uint8_t*)pBlock + need);
+
+			pRest->Size = pBlock->Size - need;
+			pRest->pNext = pBlock->pNext;
+			*ppPrev = pRest;
+			pBlock->Size = need;
+		}
+		else
+		{
+			*ppPrev = pBlock->pNext;
+		}
+		return (uint8_t*)pBlock + MB_HEADER;
+	}
+
+	// nothing free fits, grow the break
+	pBlock = (MB_Block_t*)MB_Sbrk(need);
+	if(pBlock == (void*)-1)
+		return NULL;
+	pBlock->Size = need;
+	return (uint8_t*)pBlock + MB_HEADER;
+}
+
+static void MB_HeapFree(void *pPtr)
+{
+	MB_Block_t *pBlock = (MB_Block_t*)((uint8_t*)pPtr - MB_HEADER);
+	MB_Block_t **ppPrev = &pFreeList;
+	MB_Block_t *pPrev = NULL;
+
+	while(*ppPrev && (*ppPrev < pBlock))
+	{
+		pPrev = *ppPrev;
+		ppPrev = &(*ppPrev)->pNext;
+	}
+	pBlock->pNext = *ppPrev;
+	*ppPrev = pBlock;
+
+	// merge with the next and the previous block
+	if(pBlock->pNext && ((uint8_t*)pBlock + pBlock->Size == (uint8_t*)pBlock->pNext))
+	{
+		pBlock->Size += pBlock->pNext->Size;
+		pBlock->pNext = pBlock->pNext->pNext;
+	}
+	if(pPrev && ((uint8_t*)pPrev + pPrev->Size == (uint8_t*)pBlock))
+	{
+		pPrev->Size += pBlock->Size;
+		pPrev->pNext = pBlock->pNext;
+	}
+}
+
+/*
+ * 1 - largest free block / free bytes, the break counted as free
+ */
+static double MB_HeapFragmentation(void)
+{
+	uint32_t top = (uint32_t)(&heapArena[sizeof(heapArena)] - pBreak);
+	uint32_t total = top, largest = top;
+
+	for(MB_Block_t *pBlock = pFreeList; pBlock; pBlock = pBlock->pNext)
+	{
+		total += pBlock->Size;
+		if(pBlock->Size > largest)
+			largest = pBlock->Size;
+	}
+	return total ? 1.0 - (double)largest / total : 0.0;
+}
+
+static void MB_HeapSample(void)
+{
+	double frag = MB_HeapFragmentation();
+
+	heapFragSum += frag;
+	heapFragSamples++;
+	if(frag > heapFragWorst)
+		heapFragWorst = frag;
+}
+
+/*
+ * mostly small strings, some line buffers, now and then a stdio buffer
+ */
+static uint32_t MB_Size(void)
+{
+	uint32_t r = MB_Random() % 100;
+
+	if(r < 55)
+		return 1 + MB_Random() % 16;
+	if(r < 80)
+		return 17 + MB_Random() % 16;
+	if(r < 91)
+		return 33 + MB_Random() % 32;
+	if(r < 97)
+		return 65 + MB_Random() % 64;
+	if(r < 99)
+		return 129 + MB_Random() % 128;
+	return 257 + MB_Random() % 768;
+}
+
+static void MB_Alloc(MB_Stats_t *pStats, uint8_t Pools, uint32_t Size, uint8_t Fill)
+{
+	uint64_t t0 = MB_Nanos();
+	uint8_t *pBlock = Pools ? (uint8_t*)Mempool_Alloc(Size) : (uint8_t*)MB_HeapAlloc(Size);
+	MB_Live_t *pLive;
+
+	MB_Book(pStats->AllocHist, &pStats->AllocNs, MB_Elapsed(t0));
+	pStats->Allocs++;
+
+	if(pBlock == NULL)
+	{
+		pStats->Failures++;
+		if(!Pools)
+			MB_HeapSample();
+		return;
+	}
+
+	pLive = &pStats->Live[pStats->NoOfLive++];
+	pLive->pBlock = pBlock;
+	pLive->Size = Size;
+	pLive->Fill = Fill;
+	memset(pBlock, pLive->Fill, Size);
+
+	if(Pools)
+	{
+		wasteBytes += Mempool_BlockSize(pBlock) - Size;
+		blockBytes += Mempool_BlockSize(pBlock);
+	}
+}
+
+static void MB_Free(MB_Stats_t *pStats, uint8_t Pools, uint32_t Idx)
+{
+	MB_Live_t *pLive = &pStats->Live[Idx];
+	uint64_t t0;
+
+	for(uint32_t i = 0; i < pLive->Size; i++)
+	{
+		if(pLive->pBlock[i] != pLive->Fill)
+		{
+			pStats->Corrupted++;
+			break;
+		}
+	}
+
+	t0 = MB_Nanos();
+	if(Pools)
+		Mempool_Free(pLive->pBlock);
+	else
+		MB_HeapFree(pLive->pBlock);
+	MB_Book(pStats->FreeHist, &pStats->FreeNs, MB_Elapsed(t0));
+	pStats->Frees++;
+
+	*pLive = pStats->Live[--pStats->NoOfLive];
+}
+
+/*
+ * the trace is made once for a perfect allocator, so both allocators see the same requests. A failed
+ * allocation only leaves one block less to free
+ */
+static void MB_Trace(uint32_t Operations)
+{
+	uint32_t live = 0;
+
+	for(uint32_t n = 0; n < Operations; n++)
+	{
+		uint32_t r = MB_Random();
+
+		// allocate while below half the live limit, then as often as free
+		if((live < MB_MAX_LIVE) && ((live < MB_MAX_LIVE / 2) || (r & 1)))
+		{
+			pTrace[n].Size = MB_Size();
+			live++;
+		}
+		else
+		{
+			pTrace[n].Size = 0;
+			live--;
+		}
+		pTrace[n].Pick = r >> 1;
+	}
+}
+
+static void MB_Run(MB_Stats_t *pStats, uint8_t Pools, uint32_t Operations)
+{
+	for(uint32_t n = 0; n < Operations; n++)
+	{
+		if(pTrace[n].Size)
+			MB_Alloc(pStats, Pools, pTrace[n].Size, (uint8_t)pTrace[n].Pick);
+		else if(pStats->NoOfLive)
+			MB_Free(pStats, Pools, pTrace[n].Pick % pStats->NoOfLive);
+	}
+	while(pStats->NoOfLive)
+		MB_Free(pStats, Pools, pStats->NoOfLive - 1);
+}
+
+static void MB_Print(const MB_Stats_t *pStats, double Fragmentation)
+{
+	printf("%-6s %10u %9.1f %9u %9.1f %9u %9u %10.1f%%\n", pStats->pName, pStats->Allocs,
+		   (double)pStats->AllocNs / pStats->Allocs, MB_Percentile(pStats->AllocHist, pStats->Allocs, 0.999),
+		   (double)pStats->FreeNs / pStats->Frees, MB_Percentile(pStats->FreeHist, pStats->Frees, 0.999),
+		   pStats->Failures, 100.0 * Fragmentation);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t operations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : MB_OPERATIONS;
+	static MB_Stats_t pools = { .pName = "pools" }, heap = { .pName = "heap" };
+	double endFrag;
+
+	Sim_Init();
+	Mempool_Init();
+	if(operations == 0)
+		operations = MB_OPERATIONS;
+	pTrace = malloc(operations * sizeof(pTrace[0]));
+	if(pTrace == NULL)
+		return 1;
+
+	// the clock itself, the cheapest of many pairs
+	clockNs = ~0ULL;
+	for(uint32_t i = 0; i < 1000; i++)
+	{
+		uint64_t t0 = MB_Nanos(), t = MB_Nanos() - t0;
+
+		if(t < clockNs)
+			clockNs = t;
+	}
+
+	MB_Trace(operations);
+	MB_Run(&pools, 1, operations);
+	MB_Run(&heap, 0, operations);
+	endFrag = MB_HeapFragmentation();
+
+	printf("%u operations, %u bytes for each allocator, up to %u blocks alive\n\n", operations,
+		   MEMPOOL_ARENA_SIZE, MB_MAX_LIVE);
+	printf("%-6s %10s %9s %9s %9s %9s %9s %11s\n", "", "allocs", "alloc ns", "99.9%", "free ns", "99.9%",
+		   "failures", "fragment");
+	MB_Print(&pools, blockBytes ? (double)wasteBytes / blockBytes : 0.0);
+	MB_Print(&heap, heapFragSamples ? heapFragSum / heapFragSamples : 0.0);
+	printf("\npools: waste inside the blocks, %u bytes at the high water mark\n", Mempool_GetBytesHighWater());
+	printf("heap:  between the blocks at the failures (worst %.1f%%), %.1f%% at the end, break at %u bytes\n",
+		   100.0 * heapFragWorst, 100.0 * endFrag, (uint32_t)(pBreak - heapArena));
+
+	SIM_CHECK(pools.Corrupted == 0);
+	SIM_CHECK(heap.Corrupted == 0);
+	SIM_CHECK(pools.Allocs == heap.Allocs);
+	SIM_CHECK(pools.Failures == Mempool_GetFailures());
+	SIM_CHECK(Mempool_GetBytesInUse() == 0);
+	for(uint8_t c = 0; c < MEMPOOL_NUM_CLASSES; c++)
+	{
+		SIM_CHECK(Mempool_GetPool(c)->InUse == 0);
+		SIM_CHECK(Mempool_GetPool(c)->BadFrees == 0);
+	}
+	// everything freed merges back into one block
+	SIM_CHECK((pFreeList == NULL) || ((pFreeList->pNext == NULL) && ((uint8_t*)pFreeList == heapArena) &&
+									  (pFreeList->Size == (uint32_t)(pBreak - heapArena))));
+
+	free(pTrace);
+	return Sim_Report("mempool");
+}
@@ -0,0 +1,298 @@
+/*
+ * power_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the power manager (Inc/power.h) with the DWT cycle counter, SCB_SCR and RCC modelled on
+ * the simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o power_test power_test.c
+ * 			   ../sim/sim.c ../../Src/power.c
+ * Usage:	power_test [seconds]
+ *
+ * The SCB_SCR write before the WFI is the sleep point: the model counts it, takes the clocks down if
+ * SLEEPDEEP is set (STOP: HSE and PLL off, SYSCLK on HSI) and posts the wake up the test armed, as
+ * the wake source ISR would. Cycles only advance when the test runs code, none pass while asleep
+ * 	- Race: a wake up posted between the IRQ mask and the WFI (on the DWT_CYCCNT read which books the
+ * 	  run time). Power_Idle() must not sleep, and the second still closes with its idle time as run
+ * 	- STOP: the clocks come back as they were before, SYSCLK on the PLL, on HSE and on HSI, with the
+ * 	  regulator in main and in low power mode. STOP, not standby, and SLEEPDEEP cleared after
+ * 	- Residency: random run time per SQW second plus UART wake ups in between. Run and idle cycles
+ * 	  have to be exact per mode, a second with more run cycles than the clock books a full second run
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "power.h"
+
+#define PW_CORE_HZ						16000000UL
+#define PW_SECONDS						1000
+#define PW_NO_WAKE						0xFF
+
+static Power_Handle_t power;
+static uint32_t cycles;						/* Simulated DWT_CYCCNT */
+static uint8_t raceWake = PW_NO_WAKE;		/* Posted on the next DWT_CYCCNT read */
+static uint8_t sleepWake = PW_NO_WAKE;		/* Posted when the core goes to sleep */
+static uint32_t noOfSleeps, noOfStops;
+static uint32_t seed = 27;
+
+static uint32_t PW_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/*
+ * DWT: CYCCNT reads the simulated cycle count. The first read of Power_Idle() is right after the IRQ mask
+ */
+static void PW_DWTRead(void *pCtx, uint32_t Offset)
+{
+	(void)pCtx;
+
+	if(Offset != 0x04)
+		return;
+	SIM_REG(DWT_CYCCNT) = cycles;
+	if(raceWake != PW_NO_WAKE)
+	{
+		Power_NotifyWake(&power, raceWake);
+		raceWake = PW_NO_WAKE;
+	}
+}
+
+/*
+ * SCB_SCR: every write but the one clearing SLEEPDEEP after a STOP is the last access before the WFI
+ */
+static void PW_SCRWrite(void *pCtx, uint32_t Offset, uint32_t OldValue)
+{
+	uint32_t scr = SIM_REG(SCB_SCR);
+
+	(void)pCtx;
+	(void)Offset;
+
+	if(OldValue & (1 << SCB_SCR_SLEEPDEEP))
+		return;
+
+	noOfSleeps++;
+	if(scr & (1 << SCB_SCR_SLEEPDEEP))
+	{
+		// STOP: HSE and PLL off, the core wakes up on HSI
+		noOfStops++;
+		SIM_REG(&RCC->CR) &= ~((1 << RCC_CR_HSEON) | (1 << RCC_CR_HSERDY) | (1 << RCC_CR_PLLON) |
+							   (1 << RCC_CR_PLLRDY));
+		SIM_REG(&RCC->CFGR) &= ~((0x3 << RCC_CFGR_SW) | (0x3 << RCC_CFGR_SWS));
+	}
+	if(sleepWake != PW_NO_WAKE)
+		Power_NotifyWake(&power, sleepWake);
+}
+
+/*
+ * RCC: the oscillators are ready as soon as they are on, the clock switch is immediate
+ */
+static void PW_RCCWrite(void *pCtx, uint32_t Offset, uint32_t OldValue)
+{
+	uint32_t reg;
+
+	(void)pCtx;
+	(void)OldValue;
+
+	if(Offset == 0x00)
+	{
+		reg = SIM_REG(&RCC->CR) & ~((1 << RCC_CR_HSERDY) | (1 << RCC_CR_PLLRDY));
+		if(reg & (1 << RCC_CR_HSEON))
+			reg |= (1 << RCC_CR_HSERDY);
+		if(reg & (1 << RCC_CR_PLLON))
+			reg |= (1 << RCC_CR_PLLRDY);
+		SIM_REG(&RCC->CR) = reg;
+	}
+	else if(Offset == 0x08)
+	{
+		reg = SIM_REG(&RCC->CFGR);
+		reg = (reg & ~(0x3 << RCC_CFGR_SWS)) | (((reg >> RCC_CFGR_SW) & 0x3) << RCC_CFGR_SWS);
+		SIM_REG(&RCC->CFGR) = reg;
+	}
+}
+
+static void PW_Start(uint8_t IdleMode, uint8_t LowPowerRegulator)
+{
+	Sim_Reset();
+	Sim_AddModel(0xE0001000, 0x08, PW_DWTRead, NULL, NULL);
+	Sim_AddModel((uint32_t)(uintptr_t)SCB_SCR, 0x04, NULL, PW_SCRWrite, NULL);
+	Sim_AddModel(RCC_BASEADDR, sizeof(RCC_RegDef_t), NULL, PW_RCCWrite, NULL);
+
+	cycles = PW_Random();
+	raceWake = PW_NO_WAKE;
+	sleepWake = PW_NO_WAKE;
+	noOfSleeps = 0;
+	noOfStops = 0;
+
+	memset(&power, 0, sizeof(power));
+	power.Power_Config.CoreClockHz = PW_CORE_HZ;
+	power.Power_Config.IdleMode = IdleMode;
+	power.Power_Config.LowPowerRegulator = LowPowerRegulator;
+	Power_Init(&power);
+}
+
+/*
+ * runs for Run cycles then idles until the wake up posted at the sleep point
+ */
+static uint8_t PW_Idle(uint32_t Run, uint8_t Wake)
+{
+	uint8_t wake;
+
+	cycles += Run;
+	sleepWake = Wake;
+	wake = Power_Idle(&power);
+	sleepWake = PW_NO_WAKE;
+	__asm__ volatile("" ::: "memory");
+	return wake;
+}
+
+static void PW_Race(void)
+{
+	uint32_t run = PW_CORE_HZ / 4;
+
+	PW_Start(POWER_MODE_SLEEP, DISABLE);
+
+	// the UART ISR fires between the IRQ mask and the WFI: no sleep, the UART wake up is returned
+	raceWake = POWER_WAKE_UART;
+	SIM_CHECK(PW_Idle(run, POWER_WAKE_SQW) == (1 << POWER_WAKE_UART));
+	SIM_CHECK(noOfSleeps == 0);
+	SIM_CHECK(power.Entries[POWER_MODE_SLEEP] == 0);
+	SIM_CHECK(power.Wakeups[POWER_WAKE_UART] == 1);
+	SIM_CHECK(power.PendingWake == 0);
+
+	// the next idle sleeps
+	SIM_CHECK(PW_Idle(run, POWER_WAKE_UART) == (1 << POWER_WAKE_UART));
+	SIM_CHECK(noOfSleeps == 1);
+
+	// SQW in the same window on a second which never slept before: the idle time is run time
+	PW_Start(POWER_MODE_SLEEP, DISABLE);
+	raceWake = POWER_WAKE_SQW;
+	SIM_CHECK(PW_Idle(run, POWER_WAKE_UART) == (1 << POWER_WAKE_SQW));
+	SIM_CHECK(noOfSleeps == 0);
+	SIM_CHECK(power.Seconds == 1);
+	SIM_CHECK(power.Cycles[POWER_MODE_RUN] == PW_CORE_HZ);
+	SIM_CHECK(power.Cycles[POWER_MODE_SLEEP] == 0);
+	SIM_CHECK(power.Cycles[POWER_MODE_STOP] == 0);
+	SIM_CHECK(power.RunCycles == 0);
+}
+
+static void PW_Stop(void)
+{
+	static const struct
+	{
+		const char		*pName;
+		uint32_t		CR;
+		uint8_t			SW;
+	}clocks[] =
+	{
+		{ "PLL",	(1 << RCC_CR_HSION) | (1 << RCC_CR_HSEON) | (1 << RCC_CR_PLLON),	2 },
+		{ "HSE",	(1 << RCC_CR_HSION) | (1 << RCC_CR_HSEON),							1 },
+		{ "HSI",	(1 << RCC_CR_HSION),												0 },
+	};
+
+	for(uint8_t lpds = 0; lpds < 2; lpds++)
+	{
+		for(uint32_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+		{
+			uint32_t cr, cfgr, run = PW_Random() % PW_CORE_HZ;
+
+			PW_Start(POWER_MODE_STOP, lpds ? ENABLE : DISABLE);
+			RCC->CR = clocks[c].CR;
+			RCC->CFGR = (uint32_t)clocks[c].SW << RCC_CFGR_SW;
+			// standby left set by someone else must not stick
+			SIM_REG(&PWR->CR) = (1 << PWR_CR_PDDS) | (lpds ? 0 : (1 << PWR_CR_LPDS));
+			cr = SIM_REG(&RCC->CR);
+			cfgr = SIM_REG(&RCC->CFGR);
+
+			SIM_CHECK(PW_Idle(run, POWER_WAKE_SQW) == (1 << POWER_WAKE_SQW));
+			SIM_CHECK(noOfStops == 1);
+			SIM_CHECK(SIM_REG(&RCC->CR) == cr);
+			SIM_CHECK(SIM_REG(&RCC->CFGR) == cfgr);
+			SIM_CHECK(((SIM_REG(&RCC->CFGR) >> RCC_CFGR_SWS) & 0x3) == clocks[c].SW);
+			SIM_CHECK(!(SIM_REG(SCB_SCR) & (1 << SCB_SCR_SLEEPDEEP)));
+			SIM_CHECK(!(SIM_REG(&PWR->CR) & (1 << PWR_CR_PDDS)));
+			SIM_CHECK(!!(SIM_REG(&PWR->CR) & (1 << PWR_CR_LPDS)) == lpds);
+
+			SIM_CHECK(power.Entries[POWER_MODE_STOP] == 1);
+			SIM_CHECK(power.Cycles[POWER_MODE_RUN] == run);
+			SIM_CHECK(power.Cycles[POWER_MODE_STOP] == PW_CORE_HZ - run);
+			printf("STOP on %s, %s regulator: clocks restored\n", clocks[c].pName, lpds ? "low power" : "main");
+		}
+	}
+}
+
+static void PW_Residency(uint32_t Seconds)
+{
+	uint64_t run = 0, idle = 0;
+	uint32_t uartWakes = 0, clamped = 0;
+
+	PW_Start(POWER_MODE_SLEEP, DISABLE);
+
+	for(uint32_t s = 0; s < Seconds; s++)
+	{
+		uint32_t second = 0;
+
+		// UART wake ups in between, each with its own run time
+		while(PW_Random() % 4 == 0)
+		{
+			uint32_t r = PW_Random() % (PW_CORE_HZ / 8);
+
+			SIM_CHECK(PW_Idle(r, POWER_WAKE_UART) == (1 << POWER_WAKE_UART));
+			second += r;
+			uartWakes++;
+		}
+
+		// now and then a second busy for longer than a second
+		if(PW_Random() % 50 == 0)
+		{
+			second += PW_CORE_HZ + PW_Random() % PW_CORE_HZ;
+			SIM_CHECK(PW_Idle(second, POWER_WAKE_SQW) == (1 << POWER_WAKE_SQW));
+			run += PW_CORE_HZ;
+			clamped++;
+		}
+		else
+		{
+			uint32_t r = PW_Random() % (PW_CORE_HZ / 2);
+
+			SIM_CHECK(PW_Idle(r, POWER_WAKE_SQW) == (1 << POWER_WAKE_SQW));
+			second += r;
+			run += second;
+			idle += PW_CORE_HZ - second;
+		}
+	}
+
+	printf("%u seconds, %u UART wake ups, %u seconds over: run %llu, sleep %llu cycles\n", Seconds,
+		   uartWakes, clamped, (unsigned long long)power.Cycles[POWER_MODE_RUN],
+		   (unsigned long long)power.Cycles[POWER_MODE_SLEEP]);
+	SIM_CHECK(power.Seconds == Seconds);
+	SIM_CHECK(power.Wakeups[POWER_WAKE_SQW] == Seconds);
+	SIM_CHECK(power.Wakeups[POWER_WAKE_UART] == uartWakes);
+	SIM_CHECK(power.Entries[POWER_MODE_SLEEP] == Seconds + uartWakes);
+	SIM_CHECK(noOfSleeps == Seconds + uartWakes);
+	SIM_CHECK(power.Cycles[POWER_MODE_RUN] == run);
+	SIM_CHECK(power.Cycles[POWER_MODE_SLEEP] == idle);
+	SIM_CHECK(power.Cycles[POWER_MODE_STOP] == 0);
+	SIM_CHECK(power.Cycles[POWER_MODE_RUN] + power.Cycles[POWER_MODE_SLEEP] == (uint64_t)Seconds * PW_CORE_HZ);
+	SIM_CHECK(Power_GetResidencyMs(&power, POWER_MODE_RUN) == (uint32_t)(run / (PW_CORE_HZ / 1000)));
+	SIM_CHECK(Power_GetResidencyMs(&power, POWER_MODE_SLEEP) == (uint32_t)(idle / (PW_CORE_HZ / 1000)));
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t seconds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : PW_SECONDS;
+
+	Sim_Init();
+
+	PW_Race();
+	PW_Stop();
+	PW_Residency(seconds);
+
+	return Sim_Report("power");
+}
@@ -0,0 +1,249 @@
+/*
+ * isr_cycles.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host model of the cycles the __RAMFUNC ISRs take from flash and from SRAM: EXTI9_5 (SQW edge) and
+ * I2C2_EV (time server), as main.c routes them, on the simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o isr_cycles
+ * 			   isr_cycles.c ../sim/sim.c ../../Src/timestamp.c ../../Src/power.c ../../Src/sched.c
+ * 			   ../../Src/ringbuf.c ../../Src/timeserver.c ../../BSP/rtc.c ../../BSP/ds1307.c
+ * 			   ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c ../../drivers/Src/stm32f407x_i2c.c
+ * 			   ../../drivers/Src/stm32f407xx_gpio_driver.c ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	isr_cycles
+ *
+ * Each handler runs single stepped (TF) with the registers set up for its event. Every instruction and
+ * every 16 byte code line it touches is counted. The counts are x86-64 ones, close enough to the
+ * Thumb-2 ones to compare the placements, not to replace DWT_CYCCNT on the board
+ * 	- EXTI9_5: Timestamp_Edge(), GPIO_IRQHandling(), Power_NotifyWake(), Sched_Tick()
+ * 	- I2C2_EV: address match, data request (a byte sent), data received, stop
+ * 	- Flash: every line of a cold ISR misses the ART cache and waits IC_FLASH_WS, a warm ISR runs at
+ * 	  full speed. SRAM: no wait states, but code and data share the S bus, every load and store
+ * 	  (IC_LS_PERCENT of the instructions) stalls the next fetch a cycle
+ * Exits 1 on any error
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include "sim.h"
+#include "timestamp.h"
+#include "power.h"
+#include "sched.h"
+#include "timeserver.h"
+#include "rtc.h"
+
+/*
+ * Target model (Cortex-M4 at 168 MHz, 5 wait states, ART accelerator on)
+ */
+#define IC_FLASH_WS						5			/* Per ART line miss */
+#define IC_LS_PERCENT					30			/* Loads and stores in ISR code */
+#define IC_CPI_PERCENT					125			/* Cycles per instruction x100, no memory stalls */
+
+#define IC_TIMER_HZ						16000000UL
+#define IC_MAX_LINES					4096
+#define IC_EFLAGS_TF					0x100
+
+typedef struct
+{
+	const char		*pName;
+	void			(*pfnSetup)(void);
+	void			(*pfnISR)(void);
+}IC_Case_t;
+
+static Timestamp_Handle_t tsHandle;
+static Power_Handle_t powerHandle;
+static Sched_Handle_t schedHandle;
+static TimeServer_Handle_t serverHandle;
+static uint32_t steps, noOfLines;
+static uintptr_t lines[IC_MAX_LINES];
+static uint8_t appEvent;
+
+/*
+ * the handlers as main.c has them
+ */
+static void IC_EXTI9_5(void)
+{
+	Timestamp_Edge(&tsHandle);
+	GPIO_IRQHandling(RTC_BOARD_SQW_PIN);
+	Power_NotifyWake(&powerHandle, POWER_WAKE_SQW);
+	Sched_Tick(&schedHandle);
+}
+
+static void IC_I2C2_EV(void)
+{
+	I2C_EV_IRQHandling(&serverHandle.I2CHandle);
+}
+
+void I2C_ApplicationEventCallback(I2C_Handle_t *pI2CHandle, uint8_t AppEv)
+{
+	appEvent = AppEv;
+	if(pI2CHandle == &serverHandle.I2CHandle)
+		TimeServer_EventHandling(&serverHandle, AppEv);
+}
+
+/*
+ * trap after every instruction: count it and the code line it sits in
+ */
+static void IC_Step(int Sig, siginfo_t *pInfo, void *pUctx)
+{
+	uintptr_t line = (uintptr_t)((ucontext_t*)pUctx)->uc_mcontext.gregs[REG_RIP] >> 4;
+	uint32_t i;
+
+	(void)Sig;
+	(void)pInfo;
+
+	steps++;
+	for(i = 0; (i < noOfLines) && (lines[i] != line); i++);
+	if((i == noOfLines) && (noOfLines < IC_MAX_LINES))
+		lines[noOfLines++] = line;
+}
+
+static void IC_Stepped(void (*pfnISR)(void))
+{
+	struct sigaction sa, old;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = IC_Step;
+	sa.sa_flags = SA_SIGINFO;
+	sigaction(SIGTRAP, &sa, &old);
+
+	steps = 0;
+	noOfLines = 0;
+	__asm__ volatile("pushfq; orq %0, (%%rsp); popfq" :: "i"(IC_EFLAGS_TF) : "memory", "cc");
+	pfnISR();
+	__asm__ volatile("pushfq; andq %0, (%%rsp); popfq" :: "i"(~IC_EFLAGS_TF) : "memory", "cc");
+
+	sigaction(SIGTRAP, &old, NULL);
+}
+
+static void IC_Nothing(void)
+{
+}
+
+/*
+ * SQW edge a second after the last one, the EXTI line pending
+ */
+static void IC_SetupEXTI(void)
+{
+	SIM_REG(&TIM2->CNT) += IC_TIMER_HZ;
+	SIM_REG(&EXTI->PR) = (1 << RTC_BOARD_SQW_PIN);
+}
+
+static void IC_SetupI2C(uint32_t SR1, uint32_t SR2)
+{
+	SIM_REG(&I2C2->CR2) |= (1 << I2C_CR2_ITEVTEN) | (1 << I2C_CR2_ITBUFEN);
+	SIM_REG(&I2C2->SR1) = SR1;
+	SIM_REG(&I2C2->SR2) = SR2;
+	appEvent = 0xFF;
+}
+
+static void IC_SetupAddr(void)
+{
+	IC_SetupI2C((1 << I2C_SR1_ADDR), (1 << I2C_SR2_TRA));
+}
+
+static void IC_SetupDataReq(void)
+{
+	IC_SetupI2C((1 << I2C_SR1_TxE), (1 << I2C_SR2_TRA));
+}
+
+static void IC_SetupDataRcv(void)
+{
+	IC_SetupI2C((1 << I2C_SR1_RxNE), 0);
+	SIM_REG(&I2C2->DR) = TIMESERVER_REG_CONTROL;
+}
+
+static void IC_SetupStop(void)
+{
+	IC_SetupI2C((1 << I2C_SR1_STOPF), 0);
+}
+
+static void IC_Start(void)
+{
+	Timestamp_t now = { 850000000UL, 0 };
+
+	Sim_Reset();
+
+	memset(&tsHandle, 0, sizeof(tsHandle));
+	tsHandle.Timestamp_Config.pTIMx = TIM2;
+	tsHandle.Timestamp_Config.TimerClockHz = IC_TIMER_HZ;
+	Timestamp_Init(&tsHandle);
+	Timestamp_Sync(&tsHandle, now.Seconds);
+
+	memset(&powerHandle, 0, sizeof(powerHandle));
+	Sched_Init(&schedHandle);
+
+	memset(&serverHandle, 0, sizeof(serverHandle));
+	serverHandle.TimeServer_Config.pI2Cx = I2C2;
+	serverHandle.TimeServer_Config.pSCLPort = GPIOB;
+	serverHandle.TimeServer_Config.SCLPin = GPIO_PIN_10;
+	serverHandle.TimeServer_Config.pSDAPort = GPIOB;
+	serverHandle.TimeServer_Config.SDAPin = GPIO_PIN_11;
+	serverHandle.TimeServer_Config.EVIRQNumber = IRQ_I2C2_EV;
+	serverHandle.TimeServer_Config.ERIRQNumber = IRQ_I2C2_ER;
+	serverHandle.TimeServer_Config.pTsHandle = &tsHandle;
+	TimeServer_Init(&serverHandle);
+	TimeServer_Publish(&serverHandle, &now);
+
+	// the first edge only starts the period measurement
+	IC_SetupEXTI();
+	IC_EXTI9_5();
+}
+
+int main(void)
+{
+	static const IC_Case_t cases[] =
+	{
+		{ "EXTI9_5 SQW edge",		IC_SetupEXTI,		IC_EXTI9_5 },
+		{ "I2C2_EV address",		IC_SetupAddr,		IC_I2C2_EV },
+		{ "I2C2_EV data request",	IC_SetupDataReq,	IC_I2C2_EV },
+		{ "I2C2_EV data received",	IC_SetupDataRcv,	IC_I2C2_EV },
+		{ "I2C2_EV stop",			IC_SetupStop,		IC_I2C2_EV },
+	};
+	static const uint8_t events[] = { 0xFF, I2C_EV_ADDR_MATCH, I2C_EV_DATA_REQ, I2C_EV_DATA_RCV, I2C_EV_STOP };
+	uint32_t overhead, overheadLines;
+
+	Sim_Init();
+	IC_Start();
+
+	// the stepping itself: the call and the flag writes around it
+	IC_Stepped(IC_Nothing);
+	overhead = steps;
+	overheadLines = noOfLines;
+
+	printf("%-24s %8s %8s %12s %12s %12s\n", "handler", "insns", "lines", "flash cold", "flash warm", "sram");
+	for(uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+	{
+		uint32_t insns, codeLines, base, cold, sram;
+
+		cases[c].pfnSetup();
+		IC_Stepped(cases[c].pfnISR);
+		insns = steps - overhead;
+		codeLines = noOfLines - overheadLines;
+		base = insns * IC_CPI_PERCENT / 100;
+		cold = base + codeLines * IC_FLASH_WS;
+		sram = base + insns * IC_LS_PERCENT / 100;
+
+		printf("%-24s %8u %8u %12u %12u %12u\n", cases[c].pName, insns, codeLines, cold, base, sram);
+		SIM_CHECK(insns > 0);
+		SIM_CHECK(sram < cold);
+		if(events[c] != 0xFF)
+			SIM_CHECK(appEvent == events[c]);
+	}
+
+	// the handlers did their work
+	SIM_CHECK(schedHandle.PendingTicks == 2);
+	SIM_CHECK(tsHandle.Edges == 2 && tsHandle.Rejected == 0);
+	SIM_CHECK(powerHandle.PendingWake == (1 << POWER_WAKE_SQW));
+	SIM_CHECK(serverHandle.Reads == 1);
+	SIM_CHECK(serverHandle.RejectedWrites == 1);
+
+	return Sim_Report("isr_cycles");
+}
@@ -0,0 +1,210 @@
+/*
+ * rb_stress.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host stress test of the ring buffers (Inc/ringbuf.h) with real threads in place of the ISRs
+ *
+ * Build:	cc -O2 -pthread -iquote ../../Inc -iquote ../../drivers/Inc -o rb_stress rb_stress.c ../../Src/ringbuf.c
+ * Usage:	rb_stress [elements per producer]
+ *
+ * -iquote, not -I: Inc/sched.h would shadow the system <sched.h> pulled in by <pthread.h>
+ *
+ * SPSC: one producer writes an incrementing word stream in random sized Put() and Reserve()/Commit()
+ * chunks, the consumer reads it back with Get() and Span()/Release() and checks every word.
+ * MPSC: RB_PRODUCERS threads put (producer, sequence) pairs, retrying when full. The consumer checks
+ * that every producer's sequence arrives complete and in order. Exits 1 on any error.
+ * Both sides yield when full / empty so the test also runs on a single core
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "ringbuf.h"
+
+#define RB_SPSC_SIZE			256
+#define RB_MPSC_SIZE			64
+#define RB_PRODUCERS			3
+#define RB_MAX_CHUNK			37
+
+typedef struct
+{
+	uint32_t	producer;
+	uint32_t	seq;
+}RB_Elem_t;
+
+static RingBuf_t spsc;
+static uint32_t spscStorage[RB_SPSC_SIZE];
+
+static RingBufMPSC_t mpsc;
+static RB_Elem_t mpscStorage[RB_MPSC_SIZE];
+static __vo uint32_t mpscSeq[RB_MPSC_SIZE];
+
+static uint32_t noOfElems = 1000000;
+
+/*
+ * small per thread generator, rand() is not thread safe
+ */
+static uint32_t RB_Rand(uint32_t *pState)
+{
+	*pState ^= *pState << 13;
+	*pState ^= *pState >> 17;
+	*pState ^= *pState << 5;
+	return *pState;
+}
+
+static void* RB_SPSCProducer(void *pArg)
+{
+	uint32_t rng = 0x12345678, next = 0, chunk[RB_MAX_CHUNK];
+	(void)pArg;
+
+	while(next < noOfElems)
+	{
+		uint32_t n = 1 + RB_Rand(&rng) % RB_MAX_CHUNK;
+		if(n > noOfElems - next)
+			n = noOfElems - next;
+
+		if(RB_Rand(&rng) & 1)
+		{
+			for(uint32_t i = 0; i < n; i++)
+				chunk[i] = next + i;
+			next += RingBuf_Put(&spsc, chunk, n);
+		}
+		else
+		{
+			uint32_t span;
+			uint32_t *pSpan = RingBuf_Reserve(&spsc, &span);
+			if(span > n)
+				span = n;
+			for(uint32_t i = 0; i < span; i++)
+				pSpan[i] = next + i;
+			RingBuf_Commit(&spsc, span);
+			next += span;
+		}
+
+		if(RingBuf_Free(&spsc) == 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static uint32_t RB_SPSCConsumer(void)
+{
+	uint32_t rng = 0x9ABCDEF0, expected = 0, errors = 0, chunk[RB_MAX_CHUNK];
+
+	while(expected < noOfElems)
+	{
+		uint32_t n = 1 + RB_Rand(&rng) % RB_MAX_CHUNK;
+		uint32_t got;
+		uint32_t *pData;
+
+		if(RB_Rand(&rng) & 1)
+		{
+			got = RingBuf_Get(&spsc, chunk, n);
+			pData = chunk;
+		}
+		else
+		{
+			pData = RingBuf_Span(&spsc, &got);
+			if(got > n)
+				got = n;
+		}
+
+		for(uint32_t i = 0; i < got; i++)
+		{
+			if(pData[i] != expected)
+			{
+				if(errors++ < 10)
+					printf("spsc: got %u, expected %u\n", pData[i], expected);
+				expected = pData[i];
+			}
+			expected++;
+		}
+
+		if(pData != chunk)
+			RingBuf_Release(&spsc, got);
+		if(got == 0)
+			sched_yield();
+	}
+	return errors;
+}
+
+static void* RB_MPSCProducer(void *pArg)
+{
+	RB_Elem_t elem;
+
+	elem.producer = (uint32_t)(uintptr_t)pArg;
+	for(elem.seq = 0; elem.seq < noOfElems; elem.seq++)
+	{
+		while(RingBufMPSC_Put(&mpsc, &elem) != RINGBUF_OK)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static uint32_t RB_MPSCConsumer(void)
+{
+	uint32_t next[RB_PRODUCERS] = {0};
+	uint32_t received = 0, errors = 0;
+	RB_Elem_t elem;
+
+	while(received < RB_PRODUCERS * noOfElems)
+	{
+		if(!RingBufMPSC_Get(&mpsc, &elem))
+		{
+			sched_yield();
+			continue;
+		}
+
+		if(elem.producer >= RB_PRODUCERS || elem.seq != next[elem.producer])
+		{
+			if(errors++ < 10)
+				printf("mpsc: producer %u seq %u, expected %u\n", elem.producer, elem.seq,
+					   (elem.producer < RB_PRODUCERS) ? next[elem.producer] : 0);
+			if(elem.producer >= RB_PRODUCERS)
+				continue;
+		}
+		next[elem.producer] = elem.seq + 1;
+		received++;
+	}
+	return errors;
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t producers[RB_PRODUCERS];
+	uint32_t spscErrors, mpscErrors;
+
+	if(argc > 1)
+		noOfElems = (uint32_t)strtoul(argv[1], NULL, 10);
+
+	// SPSC
+	RingBuf_Init(&spsc, spscStorage, RB_SPSC_SIZE, sizeof(uint32_t));
+	pthread_create(&producers[0], NULL, RB_SPSCProducer, NULL);
+	spscErrors = RB_SPSCConsumer();
+	pthread_join(producers[0], NULL);
+	printf("spsc: %u words, %u errors, high water %u/%u\n", noOfElems, spscErrors, spsc.HighWater, RB_SPSC_SIZE);
+
+	// MPSC
+	RingBufMPSC_Init(&mpsc, mpscStorage, mpscSeq, RB_MPSC_SIZE, sizeof(RB_Elem_t));
+	for(uint32_t i = 0; i < RB_PRODUCERS; i++)
+		pthread_create(&producers[i], NULL, RB_MPSCProducer, (void*)(uintptr_t)i);
+	mpscErrors = RB_MPSCConsumer();
+	for(uint32_t i = 0; i < RB_PRODUCERS; i++)
+		pthread_join(producers[i], NULL);
+	printf("mpsc: %u producers x %u elements, %u errors, full retries %u\n", RB_PRODUCERS, noOfElems,
+		   mpscErrors, mpsc.Overflows);
+
+	if(spscErrors || mpscErrors || !RingBufMPSC_IsEmpty(&mpsc) || RingBuf_Used(&spsc))
+	{
+		printf("FAIL\n");
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * rtc_backend_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of every RTC backend (BSP/ds1307.c, ds3231.c, pcf8563.c) against the simulated part it
+ * drives (rtc_sim.h), one part at a time on a simulated I2C1
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o rtc_backend_test
+ * 			   rtc_backend_test.c ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../BSP/rtc.c ../../BSP/ds1307.c
+ * 			   ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c ../../drivers/Src/stm32f407x_i2c.c
+ * 			   ../../drivers/Src/stm32f407xx_gpio_driver.c ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	rtc_backend_test
+ *
+ * Per part: probe and type, first power (time lost, clock started), date and time through the
+ * register layout of the part with the new year rollover, 12 hour mode, alarms fired by the part
+ * and cleared by RTC_CheckAlarm(), square wave register values, NVRAM, temperature, restart on
+ * battery and a stopped oscillator. Features the part does not have must give RTC_ERR_NOTSUP.
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "rtc.h"
+#include "ds1307.h"
+
+/*
+ * what the test expects from one part
+ */
+typedef struct
+{
+	const char	*pName;
+	uint8_t		SimType;
+	uint8_t		Type;						/* @RTC_TYPE */
+	uint8_t		SecReg;						/* seconds register, the calendar follows */
+	uint8_t		SqwReg;						/* control or CLKOUT register */
+	uint8_t		SqwMask;					/* bits of SqwReg set by the rates */
+	uint8_t		Sqw[6];						/* SqwReg per @RTC_SQW, 0xFF -> RTC_ERR_NOTSUP */
+}RT_Part_t;
+
+static const RT_Part_t parts[] =
+{
+	{ "DS1307",  SIM_RTC_DS1307,  RTC_TYPE_DS1307,  0x00, 0x07, 0x93, { 0x00, 0x10, 0xFF, 0x11, 0x12, 0x13 } },
+	{ "DS3231",  SIM_RTC_DS3231,  RTC_TYPE_DS3231,  0x00, 0x0E, 0x1C, { 0x04, 0x00, 0x08, 0x10, 0x18, 0xFF } },
+	{ "PCF8563", SIM_RTC_PCF8563, RTC_TYPE_PCF8563, 0x02, 0x0D, 0x83, { 0x00, 0x83, 0x81, 0xFF, 0xFF, 0x80 } },
+};
+
+static Sim_I2CBus_t bus;
+static Sim_RTC_t part;
+static RTC_Handle_t rtc;
+
+/*
+ * RTC_Init() on a fresh handle, as after an MCU reset
+ */
+static uint8_t RT_Init(void)
+{
+	memset(&rtc, 0, sizeof(rtc));
+	rtc.RTC_Config.pI2Cx = I2C1;
+	rtc.RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	rtc.RTC_Config.pSCLPort = GPIOB;
+	rtc.RTC_Config.SCLPin = GPIO_PIN_6;
+	rtc.RTC_Config.pSDAPort = GPIOB;
+	rtc.RTC_Config.SDAPin = GPIO_PIN_7;
+
+	return RTC_Init(&rtc);
+}
+
+static uint8_t RT_TimeIs(uint8_t Hours, uint8_t Minutes, uint8_t Seconds, uint8_t Format)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_GetDateTime(&rtc, &time, &date);
+
+	return time.hours == Hours && time.minutes == Minutes && time.seconds == Seconds && time.timeFormat == Format;
+}
+
+static uint8_t RT_DateIs(uint8_t Date, uint8_t Month, uint8_t Year, uint8_t Day)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_GetDateTime(&rtc, &time, &date);
+
+	return date.date == Date && date.month == Month && date.year == Year && date.day == Day;
+}
+
+/*
+ * ticks the part one second at a time, returns the seconds till the alarm flag was seen (0 -> never)
+ */
+static uint32_t RT_RunToAlarm(uint8_t AlarmIdx, uint32_t MaxSeconds)
+{
+	for(uint32_t i = 1; i <= MaxSeconds; i++)
+	{
+		Sim_RTCTick(&part, 1);
+		if(RTC_CheckAlarm(&rtc, AlarmIdx))
+			return i;
+	}
+	return 0;
+}
+
+static void RT_Alarms(const RT_Part_t *pPart)
+{
+	RTC_Alarm_t alarm = { 30, 0, 0, 0 };
+	RTC_Handle_time_t time = { 0, 0, 0, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 1, 3, 26, SUNDAY };
+
+	RTC_SetDateTime(&rtc, &time, &date);
+
+	if(pPart->Type == RTC_TYPE_DS1307)
+	{
+		SIM_CHECK(RTC_SetAlarm(&rtc, 0, &alarm) == RTC_ERR_NOTSUP);
+		SIM_CHECK(RTC_CheckAlarm(&rtc, 0) == 0);
+		return;
+	}
+
+	if(pPart->Type == RTC_TYPE_DS3231)
+	{
+		// alarm 1 at 00:00:30 every day, alarm 2 at 00:02 on the 1st
+		SIM_CHECK(RTC_SetAlarm(&rtc, 0, &alarm) == RTC_OK);
+		SIM_CHECK(RTC_SetAlarm(&rtc, 1, &alarm) == RTC_ERR_PARAM);
+		alarm.seconds = 0;
+		alarm.minutes = 2;
+		alarm.date = 1;
+		SIM_CHECK(RTC_SetAlarm(&rtc, 1, &alarm) == RTC_OK);
+		SIM_CHECK(RTC_SetAlarm(&rtc, 2, &alarm) == RTC_ERR_PARAM);
+
+		SIM_CHECK(RT_RunToAlarm(0, 60) == 30);
+		SIM_CHECK(RTC_CheckAlarm(&rtc, 0) == 0);				/* cleared by the first check */
+		SIM_CHECK(RT_RunToAlarm(1, 200) == 90);					/* 00:02:00 */
+		SIM_CHECK((part.Regs[0x0F] & 0x03) == 0);
+
+		// one day later alarm 1 fires again, alarm 2 waits for the next 1st
+		SIM_CHECK(RT_RunToAlarm(0, 86400) == 86400 - 120 + 30);
+		SIM_CHECK(RTC_CheckAlarm(&rtc, 1) == 0);
+		return;
+	}
+
+	// PCF8563: minute resolution, TF must survive clearing AF
+	SIM_CHECK(RTC_SetAlarm(&rtc, 0, &alarm) == RTC_ERR_PARAM);
+	SIM_CHECK(RTC_SetAlarm(&rtc, 1, &alarm) == RTC_ERR_PARAM);
+	alarm.seconds = 0;
+	alarm.minutes = 2;
+	SIM_CHECK(RTC_SetAlarm(&rtc, 0, &alarm) == RTC_OK);
+	part.Regs[0x01] |= 0x04;
+	SIM_CHECK(RT_RunToAlarm(0, 200) == 120);
+	SIM_CHECK(RTC_CheckAlarm(&rtc, 0) == 0);
+	SIM_CHECK((part.Regs[0x01] & 0x0C) == 0x04);
+	SIM_CHECK(RT_RunToAlarm(0, 86400) == 86400);
+}
+
+static void RT_SquareWave(const RT_Part_t *pPart)
+{
+	for(uint8_t rate = RTC_SQW_OFF; rate <= RTC_SQW_32768HZ; rate++)
+	{
+		uint8_t before = part.Regs[pPart->SqwReg];
+		uint8_t status = RTC_SetSquareWave(&rtc, rate);
+
+		if(pPart->Sqw[rate] == 0xFF)
+		{
+			SIM_CHECK(status == RTC_ERR_NOTSUP);
+			SIM_CHECK(part.Regs[pPart->SqwReg] == before);
+		}
+		else
+		{
+			SIM_CHECK(status == RTC_OK);
+			SIM_CHECK((part.Regs[pPart->SqwReg] & pPart->SqwMask) == pPart->Sqw[rate]);
+		}
+	}
+}
+
+static void RT_NVRAMAndTemperature(const RT_Part_t *pPart)
+{
+	uint8_t out[RTC_DS1307_RAM_SIZE], in[RTC_DS1307_RAM_SIZE];
+	int16_t quarters = 0;
+
+	for(uint32_t i = 0; i < sizeof(out); i++)
+		out[i] = (uint8_t)(i * 7 + 1);
+
+	if(pPart->Type == RTC_TYPE_DS1307)
+	{
+		SIM_CHECK(RTC_WriteNVRAM(&rtc, 0, out, sizeof(out)) == RTC_OK);
+		SIM_CHECK(memcmp(&part.Regs[0x08], out, sizeof(out)) == 0);
+		memset(&part.Regs[0x08], 0, sizeof(out));
+		SIM_CHECK(RTC_ReadNVRAM(&rtc, 0, in, sizeof(in)) == RTC_OK);
+		SIM_CHECK(memcmp(in, out, sizeof(in)) == 0);			/* served from the register cache */
+		memcpy(&part.Regs[0x08], out, sizeof(out));
+		SIM_CHECK(RTC_ReadNVRAM(&rtc, sizeof(out), in, 1) == RTC_ERR_PARAM);
+		SIM_CHECK(RTC_GetTemperature(&rtc, &quarters) == RTC_ERR_NOTSUP);
+		return;
+	}
+
+	SIM_CHECK(RTC_WriteNVRAM(&rtc, 0, out, 1) == RTC_ERR_NOTSUP);
+	SIM_CHECK(RTC_ReadNVRAM(&rtc, 0, in, 1) == RTC_ERR_NOTSUP);
+
+	if(pPart->Type == RTC_TYPE_DS3231)
+	{
+		Sim_RTCSetTemperature(&part, 101);						/* 25.25C */
+		SIM_CHECK(RTC_GetTemperature(&rtc, &quarters) == RTC_OK && quarters == 101);
+		Sim_RTCSetTemperature(&part, -7);						/* -1.75C */
+		SIM_CHECK(RTC_GetTemperature(&rtc, &quarters) == RTC_OK && quarters == -7);
+	}
+	else
+	{
+		SIM_CHECK(RTC_GetTemperature(&rtc, &quarters) == RTC_ERR_NOTSUP);
+	}
+}
+
+static void RT_Part(const RT_Part_t *pPart)
+{
+	RTC_Handle_time_t time = { 50, 59, 23, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 31, 12, 25, WEDNESDAY };
+	uint32_t failuresBefore = Sim_Failures();
+
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	Sim_RTCPowerOn(&part, pPart->SimType, 0x5EED);
+	Sim_I2CAttach(&bus, &part.Dev);
+
+	// first power: found, time lost, clock started (and the DS1307 RAM byte used by the probe kept)
+	uint8_t probeByte = part.Regs[0x12];
+	SIM_CHECK(RT_Init() == RTC_OK);
+	SIM_CHECK(RTC_GetType(&rtc) == pPart->Type);
+	SIM_CHECK(RTC_IsTimeLost(&rtc) == 1);
+	SIM_CHECK(Sim_RTCIsRunning(&part));
+	if(pPart->Type == RTC_TYPE_DS1307)
+		SIM_CHECK(part.Regs[0x12] == probeByte);
+	if(pPart->Type == RTC_TYPE_DS3231)
+		SIM_CHECK((part.Regs[0x0E] & 0x80) == 0 && (part.Regs[0x0F] & 0x80) == 0);
+	if(pPart->Type == RTC_TYPE_PCF8563)
+		SIM_CHECK(part.Regs[0x00] == 0x00 && part.Regs[0x0D] == 0x00);
+
+	// the calendar lands in the registers of the part and rolls into the new year
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+	SIM_CHECK(part.Regs[pPart->SecReg] == 0x50);				/* CH / VL cleared */
+	SIM_CHECK(part.Regs[pPart->SecReg + 1] == 0x59);
+	SIM_CHECK(part.Regs[pPart->SecReg + 2] == 0x23);
+	Sim_RTCTick(&part, 15);
+	SIM_CHECK(RT_TimeIs(0, 0, 5, RTC_TIME_FORMAT_24HRS));
+	SIM_CHECK(RT_DateIs(1, 1, 26, THURSDAY));
+
+	// leap day
+	date.date = 28;
+	date.month = 2;
+	date.year = 28;
+	date.day = MONDAY;
+	RTC_SetDateTime(&rtc, &time, &date);
+	Sim_RTCTick(&part, 10);
+	SIM_CHECK(RT_DateIs(29, 2, 28, TUESDAY));
+
+	// 12 hour mode on the DS parts, the PCF8563 converts to 24 hours
+	time.seconds = 59;
+	time.minutes = 59;
+	time.hours = 11;
+	time.timeFormat = RTC_TIME_FORMAT_12HRS_PM;
+	RTC_SetDateTime(&rtc, &time, &date);
+	Sim_RTCTick(&part, 1);
+	if(pPart->Type == RTC_TYPE_PCF8563)
+		SIM_CHECK(RT_TimeIs(0, 0, 0, RTC_TIME_FORMAT_24HRS));
+	else
+		SIM_CHECK(RT_TimeIs(12, 0, 0, RTC_TIME_FORMAT_12HRS_AM));
+
+	RT_Alarms(pPart);
+	RT_SquareWave(pPart);
+	RT_NVRAMAndTemperature(pPart);
+
+	// MCU reset, the part ran on battery: nothing lost, the time is not touched
+	time.seconds = 0;
+	time.minutes = 30;
+	time.hours = 12;
+	time.timeFormat = RTC_TIME_FORMAT_24HRS;
+	RTC_SetDateTime(&rtc, &time, &date);
+	Sim_RTCTick(&part, 5);
+	SIM_CHECK(RT_Init() == RTC_OK);
+	SIM_CHECK(RTC_GetType(&rtc) == pPart->Type);
+	SIM_CHECK(RTC_IsTimeLost(&rtc) == 0);
+	SIM_CHECK(RT_TimeIs(12, 30, 5, RTC_TIME_FORMAT_24HRS));
+
+	// the oscillator stopped for a while (halted DS1307, flat battery on the others)
+	if(pPart->Type == RTC_TYPE_DS1307)
+		part.Regs[0x00] |= 0x80;
+	else
+		Sim_RTCOscFail(&part, 1);
+	Sim_RTCTick(&part, 100);
+	Sim_RTCOscFail(&part, 0);
+	SIM_CHECK(RT_Init() == RTC_OK);
+	SIM_CHECK(RTC_IsTimeLost(&rtc) == 1);
+	SIM_CHECK(RT_TimeIs(12, 30, 5, RTC_TIME_FORMAT_24HRS));
+	SIM_CHECK(Sim_RTCIsRunning(&part));
+
+	printf("%-8s %s\n", pPart->pName, (Sim_Failures() == failuresBefore) ? "ok" : "failed");
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	for(uint32_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+		RT_Part(&parts[i]);
+
+	// nothing on the bus
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	SIM_CHECK(RT_Init() == RTC_ERR_NODEV);
+	SIM_CHECK(RTC_GetType(&rtc) == RTC_TYPE_NONE);
+
+	return Sim_Report("rtc_backend");
+}
@@ -0,0 +1,233 @@
+/*
+ * rtc_bus_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the RTC bus traffic (BSP/rtc.h over the register cache, Inc/regmap.h) and of bus
+ * errors on a simulated I2C1 (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o rtc_bus_test
+ * 			   rtc_bus_test.c ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../BSP/rtc.c ../../BSP/ds1307.c
+ * 			   ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c ../../Src/trim.c ../../Src/timestamp.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	rtc_bus_test
+ *
+ * 	- Access count: one hour of the 1Hz application loop on a DS3231 (time and alarm flag every second,
+ * 	  temperature and a square wave refresh every minute, one alarm). Every I2C transfer is counted
+ * 	  and has to match the budget, unchanged control writes must cost nothing
+ * 	- Bus errors: a missing part, NACKed bytes and a dead bus (no SB) return RTC_ERR_BUS or
+ * 	  RTC_ERR_NODEV, nothing read in a failed transfer is cached, a failed write is forgotten by the
+ * 	  cache, and the trim engine counts the failed step and steps after the next edge
+ *
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "rtc.h"
+#include "trim.h"
+
+#define BT_SECONDS						3600
+#define BT_TIMER_HZ						16000000
+
+static Sim_I2CBus_t bus;
+static Sim_RTC_t part;
+static RTC_Handle_t rtc;
+
+static uint8_t BT_Init(I2C_RegDef_t *pI2Cx)
+{
+	memset(&rtc, 0, sizeof(rtc));
+	rtc.RTC_Config.pI2Cx = pI2Cx;
+	rtc.RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	rtc.RTC_Config.pSCLPort = GPIOB;
+	rtc.RTC_Config.SCLPin = GPIO_PIN_6;
+	rtc.RTC_Config.pSDAPort = GPIOB;
+	rtc.RTC_Config.SDAPin = GPIO_PIN_7;
+
+	return RTC_Init(&rtc);
+}
+
+static void BT_PowerOn(uint8_t SimType)
+{
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	Sim_RTCPowerOn(&part, SimType, 7);
+	Sim_I2CAttach(&bus, &part.Dev);
+}
+
+/*
+ * the 1Hz loop of the application on a DS3231
+ */
+static void BT_AccessCount(void)
+{
+	RTC_Handle_time_t time = { 0, 0, 0, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 1, 6, 26, MONDAY };
+	RTC_Alarm_t alarm = { 0, 30, 0, 0 };
+	uint32_t transfers, expected, fired = 0, sqwTransfers = 0;
+	int16_t quarters;
+
+	BT_PowerOn(SIM_RTC_DS3231);
+	SIM_CHECK(BT_Init(I2C1) == RTC_OK);
+	printf("init:     %u transfers, %u bytes written, %u read\n", bus.Transfers, bus.BytesWritten, bus.BytesRead);
+
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+	SIM_CHECK(RTC_SetAlarm(&rtc, 1, &alarm) == RTC_OK);
+	SIM_CHECK(RTC_SetSquareWave(&rtc, RTC_SQW_1HZ) == RTC_OK);
+	Sim_I2CClearCounters(&bus);
+	rtc.RegMap.Hits = 0;
+
+	for(uint32_t second = 1; second <= BT_SECONDS; second++)
+	{
+		Sim_RTCTick(&part, 1);
+		SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_OK);
+		fired += RTC_CheckAlarm(&rtc, 1);
+
+		if((second % 60) == 0)
+		{
+			SIM_CHECK(RTC_GetTemperature(&rtc, &quarters) == RTC_OK);
+
+			// the same rate again: control is cached, no read and no write
+			transfers = bus.Transfers;
+			SIM_CHECK(RTC_SetSquareWave(&rtc, RTC_SQW_1HZ) == RTC_OK);
+			sqwTransfers += bus.Transfers - transfers;
+		}
+	}
+
+	// every read is a pointer write and a read transfer. Time and status every second, temperature
+	// every minute, the flag is cleared once
+	expected = 2 * (2 * BT_SECONDS) + 2 * (BT_SECONDS / 60) + 1;
+	printf("1 hour:   %u transfers (%u expected), %u bytes written, %u read, %u cache hits\n",
+		   bus.Transfers, expected, bus.BytesWritten, bus.BytesRead, rtc.RegMap.Hits);
+
+	SIM_CHECK(fired == 1);
+	SIM_CHECK(sqwTransfers == 0);
+	SIM_CHECK(bus.Transfers == expected);
+	SIM_CHECK(bus.BytesRead == 7 * BT_SECONDS + BT_SECONDS + 2 * (BT_SECONDS / 60));
+	SIM_CHECK(bus.AddrNacks == 0);
+	SIM_CHECK(rtc.RegMap.Hits == 2 * (BT_SECONDS / 60));
+	SIM_CHECK(time.hours == 1 && time.minutes == 0 && time.seconds == 0);
+}
+
+static void BT_BusErrors(void)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	uint8_t nv[8] = "settings", in[8];
+	uint32_t busReads, afErrors;
+
+	BT_PowerOn(SIM_RTC_DS1307);
+	SIM_CHECK(BT_Init(I2C1) == RTC_OK);
+
+	// the part disappears: every operation reports it, the driver counts the NACKs
+	afErrors = rtc.I2C_Handle.ErrCount[I2C_ERRCNT_AF];
+	part.Dev.NackAddr = 1;
+	SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_ERR_BUS);
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_ERR_BUS);
+	SIM_CHECK(RTC_SetSquareWave(&rtc, RTC_SQW_1HZ) == RTC_ERR_BUS);
+	SIM_CHECK(rtc.Control == 0);
+
+	// a failed read fills nothing in the cache, the next read goes to the bus
+	SIM_CHECK(RTC_ReadNVRAM(&rtc, 0, in, sizeof(in)) == RTC_ERR_BUS);
+	SIM_CHECK(rtc.I2C_Handle.ErrCount[I2C_ERRCNT_AF] == afErrors + 4);
+	part.Dev.NackAddr = 0;
+	busReads = rtc.RegMap.BusReads;
+	SIM_CHECK(RTC_ReadNVRAM(&rtc, 0, in, sizeof(in)) == RTC_OK);
+	SIM_CHECK(rtc.RegMap.BusReads == busReads + 1);
+	SIM_CHECK(memcmp(in, &part.Regs[0x08], sizeof(in)) == 0);
+
+	// a NACKed write is dropped from the cache, the part keeps its old bytes and they are read back
+	part.Dev.NackData = 1;
+	SIM_CHECK(RTC_WriteNVRAM(&rtc, 0, nv, sizeof(nv)) == RTC_ERR_BUS);
+	part.Dev.NackData = 0;
+	busReads = rtc.RegMap.BusReads;
+	SIM_CHECK(RTC_ReadNVRAM(&rtc, 0, in, sizeof(in)) == RTC_OK);
+	SIM_CHECK(rtc.RegMap.BusReads == busReads + 1);
+	SIM_CHECK(memcmp(in, &part.Regs[0x08], sizeof(in)) == 0);
+	SIM_CHECK(memcmp(in, nv, sizeof(in)) != 0);
+
+	// the write again reaches the part, then the read costs nothing
+	SIM_CHECK(RTC_WriteNVRAM(&rtc, 0, nv, sizeof(nv)) == RTC_OK);
+	busReads = rtc.RegMap.BusReads;
+	SIM_CHECK(RTC_ReadNVRAM(&rtc, 0, in, sizeof(in)) == RTC_OK);
+	SIM_CHECK(rtc.RegMap.BusReads == busReads);
+	SIM_CHECK(memcmp(&part.Regs[0x08], nv, sizeof(nv)) == 0);
+
+	// no bus model on I2C2: SB never comes, the probe times out instead of hanging
+	SIM_CHECK(BT_Init(I2C2) == RTC_ERR_NODEV);
+	SIM_CHECK(rtc.I2C_Handle.ErrCount[I2C_ERRCNT_TIMEOUT] >= 1);
+}
+
+/*
+ * one SQW edge, a second of the timer clock after the last one
+ */
+static void BT_Edge(Timestamp_Handle_t *pTsHandle)
+{
+	TIM2->CNT += BT_TIMER_HZ;
+	Sim_RTCTick(&part, 1);
+	Timestamp_Edge(pTsHandle);
+}
+
+/*
+ * the trim engine steps a DS1307 which runs 10% fast (applied as InitialPPB): the step due while
+ * the part does not answer is counted and made after the next edge
+ */
+static void BT_TrimStep(void)
+{
+	static Timestamp_Handle_t ts;
+	static Trim_Handle_t trim;
+	RTC_Handle_time_t time = { 0, 0, 12, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 1, 6, 26, MONDAY };
+	int8_t step = 0;
+	uint32_t edges = 0;
+
+	BT_PowerOn(SIM_RTC_DS1307);
+	SIM_CHECK(BT_Init(I2C1) == RTC_OK);
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+
+	ts.Timestamp_Config.pTIMx = TIM2;
+	ts.Timestamp_Config.TimerClockHz = BT_TIMER_HZ;
+	Timestamp_Init(&ts);
+	memset(&trim, 0, sizeof(trim));
+	trim.Trim_Config.pTsHandle = &ts;
+	trim.Trim_Config.pRTCHandle = &rtc;
+	trim.Trim_Config.ReferenceHz = BT_TIMER_HZ;
+	trim.Trim_Config.Measure = DISABLE;
+	trim.Trim_Config.InitialPPB = 100000000;
+	Trim_Init(&trim);
+
+	// 100ms ahead per second, the step is due after 5 seconds
+	while(step == 0 && edges < 10)
+	{
+		BT_Edge(&ts);
+		edges++;
+		if(edges == 5)
+			part.Dev.NackAddr = 1;
+		step = Trim_Poll(&trim);
+	}
+	SIM_CHECK(step == 0 && edges == 10);
+	SIM_CHECK(trim.BusErrors == 6 && trim.Steps == 0);
+
+	part.Dev.NackAddr = 0;
+	BT_Edge(&ts);
+	SIM_CHECK(Trim_Poll(&trim) == -1);
+	SIM_CHECK(trim.Steps == 1);
+	SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_OK);
+	SIM_CHECK(time.hours == 12 && time.minutes == 0 && time.seconds == 10);
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	BT_AccessCount();
+	BT_BusErrors();
+	BT_TrimStep();
+
+	return Sim_Report("rtc_bus");
+}
@@ -0,0 +1,133 @@
+/*
+ * rtc_dual_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of two RTC instances (BSP/rtc.h) on two simulated buses at once: a DS1307 on I2C1
+ * (PB6/PB7) and one on I2C3 (PA8/PC9), as on the redundancy boards
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o rtc_dual_test
+ * 			   rtc_dual_test.c ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../BSP/rtc.c ../../BSP/ds1307.c
+ * 			   ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c ../../drivers/Src/stm32f407x_i2c.c
+ * 			   ../../drivers/Src/stm32f407xx_gpio_driver.c ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	rtc_dual_test
+ *
+ * The two clocks run apart (one simulated second against two), every read of one instance is
+ * interleaved with the other. Checks that each handle only ever talks to its own bus and part,
+ * that NVRAM and power loss of one part do not show on the other. Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "rtc.h"
+
+static Sim_I2CBus_t busA, busB;
+static Sim_RTC_t partA, partB;
+static RTC_Handle_t rtcA, rtcB;
+
+static void RT_Config(RTC_Handle_t *pRTCHandle, I2C_RegDef_t *pI2Cx, GPIO_RegDef_t *pSCLPort, uint8_t SCLPin,
+					  GPIO_RegDef_t *pSDAPort, uint8_t SDAPin)
+{
+	memset(pRTCHandle, 0, sizeof(*pRTCHandle));
+	pRTCHandle->RTC_Config.pI2Cx = pI2Cx;
+	pRTCHandle->RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	pRTCHandle->RTC_Config.pSCLPort = pSCLPort;
+	pRTCHandle->RTC_Config.SCLPin = SCLPin;
+	pRTCHandle->RTC_Config.pSDAPort = pSDAPort;
+	pRTCHandle->RTC_Config.SDAPin = SDAPin;
+}
+
+/*
+ * the handle reads what the part holds
+ */
+static uint8_t RT_Matches(RTC_Handle_t *pRTCHandle, Sim_RTC_t *pPart)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_GetDateTime(pRTCHandle, &time, &date);
+
+	return (RTC_BintoBCD(time.seconds) == (pPart->Regs[0] & 0x7F)) &&
+		   (RTC_BintoBCD(time.minutes) == pPart->Regs[1]) &&
+		   (RTC_BintoBCD(time.hours) == pPart->Regs[2]) &&
+		   (RTC_BintoBCD(date.date) == pPart->Regs[4]) &&
+		   (RTC_BintoBCD(date.month) == pPart->Regs[5]) &&
+		   (RTC_BintoBCD(date.year) == pPart->Regs[6]);
+}
+
+int main(void)
+{
+	RTC_Handle_time_t time = { 50, 59, 23, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 31, 12, 25, WEDNESDAY };
+	uint8_t nvA[8] = "clock A", nvB[8], before[56];
+	uint32_t transfersB, mismatches = 0;
+
+	Sim_Init();
+	Sim_I2CBusInit(&busA, I2C1);
+	Sim_I2CBusInit(&busB, I2C3);
+	Sim_RTCPowerOn(&partA, SIM_RTC_DS1307, 1);
+	Sim_RTCPowerOn(&partB, SIM_RTC_DS1307, 2);
+	Sim_I2CAttach(&busA, &partA.Dev);
+	Sim_I2CAttach(&busB, &partB.Dev);
+
+	RT_Config(&rtcA, I2C1, GPIOB, GPIO_PIN_6, GPIOB, GPIO_PIN_7);
+	RT_Config(&rtcB, I2C3, GPIOA, GPIO_PIN_8, GPIOC, GPIO_PIN_9);
+
+	// first power: both found, both halted before, both started
+	SIM_CHECK(RTC_Init(&rtcA) == RTC_OK);
+	SIM_CHECK(RTC_Init(&rtcB) == RTC_OK);
+	SIM_CHECK(RTC_GetType(&rtcA) == RTC_TYPE_DS1307 && RTC_GetType(&rtcB) == RTC_TYPE_DS1307);
+	SIM_CHECK(RTC_IsTimeLost(&rtcA) && RTC_IsTimeLost(&rtcB));
+	SIM_CHECK(Sim_RTCIsRunning(&partA) && Sim_RTCIsRunning(&partB));
+	SIM_CHECK(busA.AddrNacks == 1 && busB.AddrNacks == 1);		/* the PCF8563 probe */
+	Sim_I2CClearCounters(&busA);
+	Sim_I2CClearCounters(&busB);
+
+	// each set on its own bus
+	RTC_SetDateTime(&rtcA, &time, &date);
+	time.hours = 8;
+	date.date = 1;
+	RTC_SetDateTime(&rtcB, &time, &date);
+	SIM_CHECK(partA.Regs[2] == 0x23 && partB.Regs[2] == 0x08);
+	SIM_CHECK(partA.Regs[4] == 0x31 && partB.Regs[4] == 0x01);
+
+	// both read in parallel, the clocks run apart (A crosses the new year)
+	for(uint32_t i = 0; i < 100; i++)
+	{
+		Sim_RTCTick(&partA, 1);
+		Sim_RTCTick(&partB, 2);
+		mismatches += !RT_Matches(&rtcA, &partA);
+		mismatches += !RT_Matches(&rtcB, &partB);
+	}
+	SIM_CHECK(mismatches == 0);
+	SIM_CHECK(partA.Regs[6] == 0x26 && partA.Regs[5] == 0x01);
+	SIM_CHECK(busA.AddrNacks == 0 && busB.AddrNacks == 0);
+
+	// NVRAM of A does not reach B
+	memcpy(before, &partB.Regs[8], sizeof(before));
+	transfersB = busB.Transfers;
+	SIM_CHECK(RTC_WriteNVRAM(&rtcA, 0, nvA, sizeof(nvA)) == RTC_OK);
+	SIM_CHECK(busB.Transfers == transfersB);
+	SIM_CHECK(memcmp(&partA.Regs[8], nvA, sizeof(nvA)) == 0);
+	SIM_CHECK(memcmp(&partB.Regs[8], before, sizeof(before)) == 0);
+	RTC_ReadNVRAM(&rtcB, 0, nvB, sizeof(nvB));
+	SIM_CHECK(memcmp(nvB, before, sizeof(nvB)) == 0);
+
+	// B loses its battery and power: A kept running, B reports the lost time
+	Sim_RTCPowerOn(&partB, SIM_RTC_DS1307, 3);
+	SIM_CHECK(RTC_Init(&rtcA) == RTC_OK);
+	SIM_CHECK(RTC_Init(&rtcB) == RTC_OK);
+	SIM_CHECK(!RTC_IsTimeLost(&rtcA));
+	SIM_CHECK(RTC_IsTimeLost(&rtcB));
+	SIM_CHECK(RT_Matches(&rtcA, &partA) && RT_Matches(&rtcB, &partB));
+
+	printf("bus A: %u transfers, %u bytes; bus B: %u transfers, %u bytes\n", busA.Transfers,
+		   busA.BytesWritten + busA.BytesRead, busB.Transfers, busB.BytesWritten + busB.BytesRead);
+
+	return Sim_Report("rtc_dual");
+}
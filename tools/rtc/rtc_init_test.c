@@ -0,0 +1,172 @@
+/*
+ * rtc_init_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the DS1307 init paths (RTC_Init, RTC_IsTimeLost, BSP/ds1307.c) on a simulated DS1307
+ * behind I2C1 (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o rtc_init_test
+ * 			   rtc_init_test.c ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../BSP/rtc.c ../../BSP/ds1307.c
+ * 			   ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c ../../drivers/Src/stm32f407x_i2c.c
+ * 			   ../../drivers/Src/stm32f407xx_gpio_driver.c ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	rtc_init_test
+ *
+ * 	- Cold: first power, CH set. The time is lost, only CH is cleared (the seconds are kept), the
+ * 	  clock runs, nothing else of the part changes
+ * 	- Warm: IT_WARM_BOOTS MCU resets at random points while the part runs on battery. The time is
+ * 	  not lost and never moves: after every init it is the time the part kept. Nothing is written
+ * 	  but the probe byte (written and restored)
+ * 	- Halted: CH set while the MCU was off. The time is lost, the clock restarts from the seconds it
+ * 	  halted at
+ * Writes are the register bytes the part received, transfers the START conditions on the bus.
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "rtc.h"
+#include "ds1307.h"
+
+#define IT_WARM_BOOTS					256
+#define IT_PROBE_WRITES					2					/* the probe byte and its restore */
+
+static Sim_I2CBus_t bus;
+static Sim_RTC_t part;
+static RTC_Handle_t rtc;
+static uint32_t seed = 43;
+
+static uint32_t IT_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/*
+ * MCU reset and RTC_Init() on a fresh handle, the part keeps its registers. Counts the bus traffic
+ */
+static uint8_t IT_Boot(void)
+{
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	Sim_I2CAttach(&bus, &part.Dev);
+	part.Writes = 0;
+
+	memset(&rtc, 0, sizeof(rtc));
+	rtc.RTC_Config.pI2Cx = I2C1;
+	rtc.RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	rtc.RTC_Config.pSCLPort = GPIOB;
+	rtc.RTC_Config.SCLPin = GPIO_PIN_6;
+	rtc.RTC_Config.pSDAPort = GPIOB;
+	rtc.RTC_Config.SDAPin = GPIO_PIN_7;
+
+	return RTC_Init(&rtc);
+}
+
+static uint32_t IT_Epoch(void)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_OK);
+	return RTC_toEpoch(&time, &date);
+}
+
+static void IT_Cold(void)
+{
+	uint8_t regs[SIM_RTC_MAX_REGS];
+
+	// first power, the seconds register holds something other than 0
+	Sim_Init();
+	Sim_RTCPowerOn(&part, SIM_RTC_DS1307, 7);
+	part.Regs[RTC_DS1307_REG_SECONDS] = 0x80 | 0x37;
+	memcpy(regs, part.Regs, sizeof(regs));
+
+	SIM_CHECK(IT_Boot() == RTC_OK);
+	printf("cold:   %2u transfers, %u bytes written\n", bus.Transfers, part.Writes);
+	SIM_CHECK(RTC_GetType(&rtc) == RTC_TYPE_DS1307);
+	SIM_CHECK(RTC_IsTimeLost(&rtc) == 1);
+	SIM_CHECK(Sim_RTCIsRunning(&part));
+	SIM_CHECK(part.Regs[RTC_DS1307_REG_SECONDS] == 0x37);
+	SIM_CHECK(part.Writes == IT_PROBE_WRITES + 1);
+
+	// CH was the only change
+	regs[RTC_DS1307_REG_SECONDS] &= ~(1 << RTC_DS1307_REG_SECONDS_CH);
+	SIM_CHECK(memcmp(regs, part.Regs, sizeof(regs)) == 0);
+}
+
+/*
+ * continues after IT_Cold(), the clock runs
+ */
+static void IT_Warm(void)
+{
+	RTC_Handle_time_t time = { 0, 0, 12, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 1, 6, 26, MONDAY };
+	uint32_t epoch, lost = 0, moved = 0, writes = 0, transfers = 0;
+
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+	epoch = RTC_toEpoch(&time, &date);
+
+	for(uint32_t boot = 0; boot < IT_WARM_BOOTS; boot++)
+	{
+		// off (or running) for up to two hours, the part keeps the time
+		uint32_t seconds = IT_Random() % 7200;
+
+		Sim_RTCTick(&part, seconds);
+		epoch += seconds;
+
+		SIM_CHECK(IT_Boot() == RTC_OK);
+		lost += RTC_IsTimeLost(&rtc);
+		writes += part.Writes;
+		transfers += bus.Transfers;
+		moved += (IT_Epoch() != epoch);
+	}
+
+	printf("warm:   %2u transfers, %u bytes written per boot, %u boots\n", transfers / IT_WARM_BOOTS,
+		   writes / IT_WARM_BOOTS, IT_WARM_BOOTS);
+	SIM_CHECK(lost == 0 && moved == 0);
+	SIM_CHECK(writes == IT_WARM_BOOTS * IT_PROBE_WRITES);
+}
+
+/*
+ * continues after IT_Warm()
+ */
+static void IT_Halted(void)
+{
+	uint32_t epoch;
+
+	// halted with CH, the time stands still while the MCU is off
+	epoch = IT_Epoch();
+	part.Regs[RTC_DS1307_REG_SECONDS] |= (1 << RTC_DS1307_REG_SECONDS_CH);
+	Sim_RTCTick(&part, 100);
+
+	SIM_CHECK(IT_Boot() == RTC_OK);
+	printf("halted: %2u transfers, %u bytes written\n", bus.Transfers, part.Writes);
+	SIM_CHECK(RTC_IsTimeLost(&rtc) == 1);
+	SIM_CHECK(part.Writes == IT_PROBE_WRITES + 1);
+	SIM_CHECK(Sim_RTCIsRunning(&part));
+	SIM_CHECK(IT_Epoch() == epoch);
+
+	// running again from where it stopped
+	Sim_RTCTick(&part, 5);
+	SIM_CHECK(IT_Epoch() == epoch + 5);
+
+	// the next reset is a warm one again
+	SIM_CHECK(IT_Boot() == RTC_OK);
+	SIM_CHECK(RTC_IsTimeLost(&rtc) == 0 && part.Writes == IT_PROBE_WRITES);
+	SIM_CHECK(IT_Epoch() == epoch + 5);
+}
+
+int main(void)
+{
+	IT_Cold();
+	IT_Warm();
+	IT_Halted();
+
+	return Sim_Report("rtc_init");
+}
@@ -0,0 +1,181 @@
+/*
+ * sched_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host benchmark of the scheduler timer wheel (Inc/sched.h): cost per Sched_TimerStart(),
+ * Sched_TimerCancel() and tick with 10, 100 and 1000 armed timers, on tools/sim
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o sched_bench sched_bench.c
+ * 			   ../sim/sim.c ../../Src/sched.c ../../Src/ringbuf.c
+ * Usage:	sched_bench [ticks]
+ *
+ * The timers are spread evenly across the SCHED_WHEEL_LEVELS levels, each with a random delay inside
+ * its level and the same period
+ * 	- Start / cancel: ns per call, every timer started then cancelled SB_REPEATS times, the best run.
+ * 	  Both are O(1), so the cost with 1000 timers has to stay within SB_FLAT times the cost with 10
+ * 	- Tick: Sched_Tick() and Sched_RunOnce() for every tick, ns per tick and ns per tick plus expiry
+ * 	  (the cascades are amortized in there). The second has to stay flat the same way. Every
+ * 	  expiry has to be on its tick
+ * 	- Host times, for the relative cost of the timer counts, not the cycles on the target
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sim.h"
+#include "sched.h"
+
+#define SB_MAX_TIMERS					1000
+#define SB_REPEATS						20
+#define SB_TICKS						(1UL << (SCHED_WHEEL_BITS * SCHED_WHEEL_LEVELS))
+#define SB_FLAT							4.0				/* Host cache misses, not the algorithm */
+
+typedef struct
+{
+	uint32_t		Timers;
+	double			StartNs;
+	double			CancelNs;
+	double			TickNs;
+	double			EventNs;				/* Per tick plus expiry */
+}SB_Result_t;
+
+static const uint32_t counts[] = { 10, 100, SB_MAX_TIMERS };
+
+static Sched_Handle_t sched;
+static Sched_Timer_t timers[SB_MAX_TIMERS];
+static uint32_t delays[SB_MAX_TIMERS];
+static uint32_t noOfExpiries, lateExpiries;
+static uint32_t seed = 28;
+
+static uint32_t SB_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint64_t SB_Nanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * the timer was just re-armed, its last expiry is one period back and has to be the tick just processed
+ */
+static void SB_Expired(void *pArg)
+{
+	Sched_Timer_t *pTimer = (Sched_Timer_t*)pArg;
+
+	lateExpiries += (pTimer->Expires - pTimer->Period != sched.Now - 1);
+	noOfExpiries++;
+}
+
+/*
+ * timer i goes to level i % SCHED_WHEEL_LEVELS, somewhere inside that level's span
+ */
+static void SB_Delays(uint32_t Timers)
+{
+	for(uint32_t i = 0; i < Timers; i++)
+	{
+		uint32_t level = i % SCHED_WHEEL_LEVELS;
+		uint32_t low = level ? (1UL << (SCHED_WHEEL_BITS * level)) : 1;
+		uint32_t high = 1UL << (SCHED_WHEEL_BITS * (level + 1));
+
+		delays[i] = low + SB_Random() % (high - low);
+	}
+}
+
+static void SB_StartAll(uint32_t Timers)
+{
+	for(uint32_t i = 0; i < Timers; i++)
+		Sched_TimerStart(&sched, &timers[i], delays[i], delays[i], SB_Expired, &timers[i]);
+}
+
+static void SB_Run(uint32_t Timers, uint32_t Ticks, SB_Result_t *pResult)
+{
+	uint32_t expected = 0;
+	double best;
+	uint64_t t0;
+
+	Sched_Init(&sched);
+	SB_Delays(Timers);
+	pResult->Timers = Timers;
+
+	// 1. start and cancel, the best of SB_REPEATS to leave the host noise out
+	pResult->StartNs = pResult->CancelNs = 1e9;
+	for(uint32_t r = 0; r < SB_REPEATS; r++)
+	{
+		t0 = SB_Nanos();
+		SB_StartAll(Timers);
+		best = (double)(SB_Nanos() - t0) / Timers;
+		if(best < pResult->StartNs)
+			pResult->StartNs = best;
+
+		for(uint32_t i = 0; i < Timers; i++)
+			SIM_CHECK(Sched_TimerIsActive(&timers[i]));
+
+		t0 = SB_Nanos();
+		for(uint32_t i = 0; i < Timers; i++)
+			Sched_TimerCancel(&timers[i]);
+		best = (double)(SB_Nanos() - t0) / Timers;
+		if(best < pResult->CancelNs)
+			pResult->CancelNs = best;
+
+		for(uint32_t i = 0; i < Timers; i++)
+			SIM_CHECK(!Sched_TimerIsActive(&timers[i]));
+	}
+
+	// 2. ticks with every timer armed
+	noOfExpiries = 0;
+	lateExpiries = 0;
+	SB_StartAll(Timers);
+	t0 = SB_Nanos();
+	for(uint32_t t = 0; t < Ticks; t++)
+	{
+		Sched_Tick(&sched);
+		Sched_RunOnce(&sched);
+	}
+	t0 = SB_Nanos() - t0;
+	pResult->TickNs = (double)t0 / Ticks;
+	pResult->EventNs = (double)t0 / (Ticks + noOfExpiries);
+
+	// every timer fired on each of its periods within the run
+	for(uint32_t i = 0; i < Timers; i++)
+		expected += Ticks / delays[i];
+	SIM_CHECK(noOfExpiries == expected);
+	SIM_CHECK(lateExpiries == 0);
+	SIM_CHECK(sched.Now == Ticks);
+
+	printf("%7u %10.1f %10.1f %10.1f %12.1f %10u\n", Timers, pResult->StartNs, pResult->CancelNs,
+		   pResult->TickNs, pResult->EventNs, noOfExpiries);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t ticks = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : SB_TICKS;
+	SB_Result_t results[sizeof(counts) / sizeof(counts[0])];
+	const uint32_t last = sizeof(counts) / sizeof(counts[0]) - 1;
+
+	Sim_Init();
+	if(ticks == 0)
+		ticks = SB_TICKS;
+
+	printf("%7s %10s %10s %10s %12s %10s\n", "timers", "start ns", "cancel ns", "tick ns", "tick+exp ns",
+		   "expiries");
+	for(uint32_t c = 0; c <= last; c++)
+		SB_Run(counts[c], ticks, &results[c]);
+
+	// O(1): no growth with the number of armed timers
+	SIM_CHECK(results[last].StartNs < SB_FLAT * results[0].StartNs);
+	SIM_CHECK(results[last].CancelNs < SB_FLAT * results[0].CancelNs);
+	SIM_CHECK(results[last].EventNs < SB_FLAT * results[0].EventNs);
+
+	return Sim_Report("sched");
+}
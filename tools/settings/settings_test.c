@@ -0,0 +1,285 @@
+/*
+ * settings_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the settings block in the RTC NVRAM (Inc/settings.h) on a simulated DS1307 behind
+ * I2C1 (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o settings_test
+ * 			   settings_test.c ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../Src/settings.c ../../Src/crc.c
+ * 			   ../../BSP/rtc.c ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c ../../drivers/Src/stm32f407xx_crc.c
+ * Usage:	settings_test
+ *
+ * 	- Boot to first display: the I2C part of the boot of main() (RTC_Init, Settings_Load, the
+ * 	  defaults and the clock written on a cold boot, the first time read). The bus time is counted
+ * 	  from the transfers at 100kHz, 9 clocks per byte and 2 for START and STOP, and is the boot
+ * 	  latency as far as the RTC goes. A warm boot writes nothing but the probe byte (written and
+ * 	  restored, outside the block) and stays within TS_WARM_BUDGET_US
+ * 	- Corruption: every single bit flip of the block, TS_RANDOM_TRIALS random multi byte corruptions,
+ * 	  an erased and a zeroed NVRAM and a save cut short at every byte. Each must load either a
+ * 	  complete block or the defaults with an error, never a mix
+ * 	- A shorter block of older firmware loads the fields it has, a dead bus gives the defaults
+ *
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "settings.h"
+#include "ds1307.h"
+#include "crc.h"
+
+#define TS_OFFSET						11					/* As main(), behind RTC_DS1307_PROBE_NVRAM */
+#define TS_SCL_HZ						100000
+#define TS_WARM_BUDGET_US				5000
+#define TS_RANDOM_TRIALS				4096
+
+static Sim_I2CBus_t bus;
+static Sim_RTC_t part;
+static RTC_Handle_t rtc;
+static Settings_Handle_t set;
+static uint32_t seed = 42;
+
+static const Settings_t custom = { -330, RTC_TIME_FORMAT_24HRS, -12345, SETTINGS_DISPLAY_DATE, 5 };
+
+static uint32_t TS_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint8_t TS_Equal(const Settings_t *pA, const Settings_t *pB)
+{
+	return (pA->TimezoneMin == pB->TimezoneMin) && (pA->TimeFormat == pB->TimeFormat) &&
+		   (pA->DriftPPB == pB->DriftPPB) && (pA->DisplayFlags == pB->DisplayFlags) &&
+		   (pA->RefreshSeconds == pB->RefreshSeconds);
+}
+
+static uint8_t TS_IsDefault(const Settings_t *pSettings)
+{
+	Settings_t def;
+
+	Settings_Default(&def);
+	return TS_Equal(pSettings, &def);
+}
+
+/*
+ * MCU reset, the DS1307 keeps its registers (battery)
+ */
+static void TS_Reset(void)
+{
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	Sim_I2CAttach(&bus, &part.Dev);
+}
+
+static uint8_t TS_Init(void)
+{
+	memset(&rtc, 0, sizeof(rtc));
+	rtc.RTC_Config.pI2Cx = I2C1;
+	rtc.RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	rtc.RTC_Config.pSCLPort = GPIOB;
+	rtc.RTC_Config.SCLPin = GPIO_PIN_6;
+	rtc.RTC_Config.pSDAPort = GPIOB;
+	rtc.RTC_Config.SDAPin = GPIO_PIN_7;
+	set.Settings_Config.pRTCHandle = &rtc;
+	set.Settings_Config.Offset = TS_OFFSET;
+
+	return RTC_Init(&rtc);
+}
+
+/*
+ * the load of the next boot, the register cache is dropped so the block comes from the part
+ */
+static uint8_t TS_Load(void)
+{
+	RegMap_Invalidate(&rtc.RegMap);
+	return Settings_Load(&set);
+}
+
+/*
+ * the RTC part of the boot in main() up to the first display, returns the bus time in microseconds
+ */
+static uint32_t TS_Boot(uint8_t *pLoadStatus)
+{
+	RTC_Handle_time_t time = { 0, 13, 11, RTC_TIME_FORMAT_24HRS };
+	RTC_Handle_date_t date = { 21, 11, 24, THURSDAY };
+	uint32_t clocks;
+
+	TS_Reset();
+	Sim_I2CClearCounters(&bus);
+	part.Writes = 0;
+
+	SIM_CHECK(TS_Init() == RTC_OK);
+	*pLoadStatus = Settings_Load(&set);
+	if(*pLoadStatus != SETTINGS_OK)
+		SIM_CHECK(Settings_Save(&set) == SETTINGS_OK);
+	if(RTC_IsTimeLost(&rtc))
+	{
+		time.timeFormat = set.Settings.TimeFormat;
+		SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+	}
+	SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_OK);
+
+	clocks = (bus.Transfers + bus.BytesWritten + bus.BytesRead) * 9 + bus.Transfers * 2;
+	return (uint32_t)((uint64_t)clocks * 1000000UL / TS_SCL_HZ);
+}
+
+static void TS_BootLatency(void)
+{
+	uint8_t block[RTC_DS1307_RAM_SIZE], status;
+	uint32_t cold, warm, transfers;
+
+	// first power: random RAM, the oscillator halted
+	Sim_Init();
+	Sim_RTCPowerOn(&part, SIM_RTC_DS1307, 3);
+	cold = TS_Boot(&status);
+	printf("cold boot: %5u us on the bus, %3u transfers, %3u bytes written to the part\n", cold, bus.Transfers, part.Writes);
+	SIM_CHECK(status != SETTINGS_OK);
+	SIM_CHECK(TS_IsDefault(&set.Settings));
+	SIM_CHECK(Sim_RTCIsRunning(&part));
+
+	set.Settings = custom;
+	SIM_CHECK(Settings_Save(&set) == SETTINGS_OK);
+
+	// warm boot: one burst for the settings, only the probe writes (and restores) its byte
+	memcpy(block, &part.Regs[RTC_DS1307_RAM_START], sizeof(block));
+	warm = TS_Boot(&status);
+	transfers = bus.Transfers;
+	printf("warm boot: %5u us on the bus, %3u transfers, %3u bytes written to the part\n", warm, transfers, part.Writes);
+	SIM_CHECK(status == SETTINGS_OK);
+	SIM_CHECK(TS_Equal(&set.Settings, &custom));
+	SIM_CHECK(part.Writes == 2);
+	SIM_CHECK(memcmp(block, &part.Regs[RTC_DS1307_RAM_START], sizeof(block)) == 0);
+	SIM_CHECK((TS_OFFSET > RTC_DS1307_PROBE_NVRAM) || (TS_OFFSET + SETTINGS_BLOCK_LEN <= RTC_DS1307_PROBE_NVRAM));
+	SIM_CHECK(warm < cold && warm <= TS_WARM_BUDGET_US);
+
+	// the settings cost one read (pointer write and read transfer) of the whole block
+	Sim_I2CClearCounters(&bus);
+	SIM_CHECK(TS_Load() == SETTINGS_OK);
+	SIM_CHECK(bus.Transfers == 2 && bus.BytesRead == SETTINGS_BLOCK_LEN);
+}
+
+/*
+ * the block as saved with custom settings is in the part, corrupt it in place
+ */
+static void TS_Corruption(void)
+{
+	uint8_t *pBlock = &part.Regs[RTC_DS1307_RAM_START + TS_OFFSET];
+	uint8_t good[SETTINGS_BLOCK_LEN], status;
+	uint32_t accepted = 0, wrongError = 0;
+
+	memcpy(good, pBlock, sizeof(good));
+
+	// every single bit
+	for(uint32_t bit = 0; bit < SETTINGS_BLOCK_LEN * 8; bit++)
+	{
+		pBlock[bit / 8] ^= (1 << (bit % 8));
+		status = TS_Load();
+		accepted += (status == SETTINGS_OK) || !TS_IsDefault(&set.Settings);
+		if(bit < 16)
+			wrongError += (status != SETTINGS_ERR_MAGIC);
+		else
+			wrongError += (status != SETTINGS_ERR_MAGIC) && (status != SETTINGS_ERR_CRC);
+		memcpy(pBlock, good, sizeof(good));
+	}
+	printf("bit flips: %u of %u accepted\n", accepted, SETTINGS_BLOCK_LEN * 8);
+	SIM_CHECK(accepted == 0 && wrongError == 0);
+
+	// 1 to 4 random bytes, the block read must never be a mix
+	for(uint32_t trial = 0; trial < TS_RANDOM_TRIALS; trial++)
+	{
+		for(uint32_t n = 1 + TS_Random() % 4; n; n--)
+			pBlock[TS_Random() % SETTINGS_BLOCK_LEN] ^= 1 + (TS_Random() % 255);
+
+		status = TS_Load();
+		if(memcmp(pBlock, good, sizeof(good)) == 0)
+			SIM_CHECK(status == SETTINGS_OK && TS_Equal(&set.Settings, &custom));
+		else
+			accepted += (status == SETTINGS_OK) || !TS_IsDefault(&set.Settings);
+		memcpy(pBlock, good, sizeof(good));
+	}
+	printf("random:    %u of %u accepted\n", accepted, TS_RANDOM_TRIALS);
+	SIM_CHECK(accepted == 0);
+
+	// erased and zeroed NVRAM
+	memset(pBlock, 0xFF, sizeof(good));
+	SIM_CHECK(TS_Load() == SETTINGS_ERR_MAGIC && TS_IsDefault(&set.Settings));
+	memset(pBlock, 0x00, sizeof(good));
+	SIM_CHECK(TS_Load() == SETTINGS_ERR_MAGIC && TS_IsDefault(&set.Settings));
+	memcpy(pBlock, good, sizeof(good));
+	SIM_CHECK(TS_Load() == SETTINGS_OK && TS_Equal(&set.Settings, &custom));
+}
+
+/*
+ * a save of other settings over the custom ones, cut short after every byte
+ */
+static void TS_TornSave(void)
+{
+	uint8_t *pBlock = &part.Regs[RTC_DS1307_RAM_START + TS_OFFSET];
+	uint8_t old[SETTINGS_BLOCK_LEN], new[SETTINGS_BLOCK_LEN], status;
+	Settings_t other = custom;
+
+	memcpy(old, pBlock, sizeof(old));
+	other.TimezoneMin = 60;
+	other.DriftPPB = 777;
+	SIM_CHECK(TS_Init() == RTC_OK);
+	set.Settings = other;
+	SIM_CHECK(Settings_Save(&set) == SETTINGS_OK);
+	memcpy(new, pBlock, sizeof(new));
+
+	for(uint32_t written = 0; written <= SETTINGS_BLOCK_LEN; written++)
+	{
+		memcpy(pBlock, old, sizeof(old));
+		memcpy(pBlock, new, written);
+
+		status = TS_Load();
+		if(status != SETTINGS_OK)
+			SIM_CHECK(TS_IsDefault(&set.Settings));
+		else
+			SIM_CHECK(TS_Equal(&set.Settings, &custom) || TS_Equal(&set.Settings, &other));
+	}
+	SIM_CHECK(status == SETTINGS_OK && TS_Equal(&set.Settings, &other));
+}
+
+static void TS_OlderBlock(void)
+{
+	uint8_t *pBlock = &part.Regs[RTC_DS1307_RAM_START + TS_OFFSET];
+	uint8_t len = SETTINGS_PAYLOAD_LEN - 2;
+	uint32_t crc;
+
+	// no display flags and refresh period yet
+	pBlock[2] = len;
+	crc = Crc_CRC32Soft(pBlock, SETTINGS_HEADER_LEN + len);
+	for(uint8_t i = 0; i < 4; i++)
+		pBlock[SETTINGS_HEADER_LEN + len + i] = (uint8_t)(crc >> (8 * i));
+
+	SIM_CHECK(TS_Load() == SETTINGS_OK);
+	SIM_CHECK(set.Settings.TimezoneMin == 60 && set.Settings.TimeFormat == custom.TimeFormat && set.Settings.DriftPPB == 777);
+	SIM_CHECK(set.Settings.DisplayFlags == SETTINGS_DEFAULT_DISPLAY && set.Settings.RefreshSeconds == SETTINGS_DEFAULT_REFRESH);
+
+	// the part stops answering after the probe
+	TS_Reset();
+	SIM_CHECK(TS_Init() == RTC_OK);
+	part.Dev.NackAddr = 1;
+	SIM_CHECK(Settings_Load(&set) == SETTINGS_ERR_BUS && TS_IsDefault(&set.Settings));
+	part.Dev.NackAddr = 0;
+}
+
+int main(void)
+{
+	TS_BootLatency();
+	TS_Corruption();
+	TS_TornSave();
+	TS_OlderBlock();
+
+	return Sim_Report("settings");
+}
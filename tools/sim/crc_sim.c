@@ -0,0 +1,126 @@
+/*
+ * crc_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated CRC unit and DMA2 stream 0 (see crc_sim.h)
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include "crc_sim.h"
+
+#define CRC_SIM_POLY					0x04C11DB7UL
+#define CRC_SIM_INIT					0xFFFFFFFFUL
+#define CRC_SIM_OFFSET(reg)				((uint32_t)offsetof(CRC_RegDef_t, reg))
+#define CRC_SIM_DMA_OFFSET(reg)			((uint32_t)offsetof(DMA_RegDef_t, reg))
+#define CRC_SIM_RCC_AHB1ENR				(*(volatile uint32_t*)Sim_Shadow((uint32_t)(uintptr_t)&RCC->AHB1ENR))
+
+/*
+ * the configuration CRC_DMAStart() writes, EN aside
+ */
+#define CRC_SIM_DMA_CR					((2 << DMA_SXCR_DIR) | (1 << DMA_SXCR_PINC) | (2 << DMA_SXCR_PSIZE) |\
+										 (2 << DMA_SXCR_MSIZE))
+#define CRC_SIM_DMA_CR_MASK				((3 << DMA_SXCR_DIR) | (1 << DMA_SXCR_PINC) | (1 << DMA_SXCR_MINC) |\
+										 (3 << DMA_SXCR_PSIZE) | (3 << DMA_SXCR_MSIZE) | (1 << DMA_SXCR_CIRC) |\
+										 (1 << DMA_SXCR_DBM))
+
+/*
+ * one word through the unit, bit 31 first
+ */
+uint32_t Sim_CRCUnit(uint32_t Crc, uint32_t Word)
+{
+	Crc ^= Word;
+	for(uint8_t bit = 0; bit < 32; bit++)
+		Crc = (Crc & 0x80000000UL) ? ((Crc << 1) ^ CRC_SIM_POLY) : (Crc << 1);
+
+	return Crc;
+}
+
+static void CRC_Sim_Write(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_CRC_t *pCrc = (Sim_CRC_t*)pContext;
+	CRC_RegDef_t *pRegs = (CRC_RegDef_t*)Sim_Shadow(CRC_BASEADDR);
+
+	if(Offset == CRC_SIM_OFFSET(DR))
+	{
+		if(!(CRC_SIM_RCC_AHB1ENR & (1 << 12)))
+		{
+			pCrc->Unclocked++;
+			pRegs->DR = OldValue;
+			return;
+		}
+		pCrc->Words++;
+		pRegs->DR = Sim_CRCUnit(OldValue, pRegs->DR);
+	}
+	else if(Offset == CRC_SIM_OFFSET(CR))
+	{
+		if(pRegs->CR & (1 << CRC_CR_RESET))
+		{
+			pCrc->Resets++;
+			pRegs->DR = CRC_SIM_INIT;
+		}
+		pRegs->CR = 0;
+	}
+}
+
+/*
+ * EN set on stream 0: the whole transfer at once
+ */
+static void CRC_Sim_DMAStart(Sim_CRC_t *pCrc, DMA_RegDef_t *pDMA)
+{
+	DMA_Stream_RegDef_t *pStream = &pDMA->Stream[0];
+	CRC_RegDef_t *pUnit = (CRC_RegDef_t*)Sim_Shadow(CRC_BASEADDR);
+
+	pCrc->DMAStarts++;
+	if(((pStream->CR & CRC_SIM_DMA_CR_MASK) != CRC_SIM_DMA_CR) || !(pStream->FCR & (1 << DMA_SXFCR_DMDIS)) ||
+	   (pStream->M0AR != (uint32_t)(uintptr_t)&CRC->DR) || !(CRC_SIM_RCC_AHB1ENR & (1 << 22)) || pCrc->FailDMA)
+	{
+		if(!pCrc->FailDMA)
+			pCrc->ConfigErrors++;
+		pCrc->FailDMA = 0;
+		pStream->CR &= ~(1UL << DMA_SXCR_EN);
+		pDMA->LISR |= (1 << DMA_ISR_TEIF);
+		return;
+	}
+
+	for(; pStream->NDTR; pStream->NDTR--, pStream->PAR += 4)
+	{
+		pUnit->DR = Sim_CRCUnit(pUnit->DR, SIM_REG(pStream->PAR));
+		pCrc->DMAWords++;
+	}
+
+	pStream->CR &= ~(1UL << DMA_SXCR_EN);
+	pDMA->LISR |= (1 << DMA_ISR_HTIF) | (1 << DMA_ISR_TCIF);
+}
+
+static void CRC_Sim_DMAWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_CRC_t *pCrc = (Sim_CRC_t*)pContext;
+	DMA_RegDef_t *pDMA = (DMA_RegDef_t*)Sim_Shadow(DMA2_BASEADDR);
+
+	if(Offset == CRC_SIM_DMA_OFFSET(LIFCR))
+	{
+		pDMA->LISR &= ~pDMA->LIFCR;
+		pDMA->LIFCR = 0;
+	}
+	else if(Offset == CRC_SIM_DMA_OFFSET(Stream[0].CR))
+	{
+		if((pDMA->Stream[0].CR & (1 << DMA_SXCR_EN)) && !(OldValue & (1 << DMA_SXCR_EN)))
+			CRC_Sim_DMAStart(pCrc, pDMA);
+	}
+}
+
+/*
+ * attaches the CRC unit and DMA2 models, DR starts at 0xFFFFFFFF
+ */
+void Sim_CRCInit(Sim_CRC_t *pCrc)
+{
+	memset(pCrc, 0, sizeof(*pCrc));
+	Sim_AddModel(CRC_BASEADDR, sizeof(CRC_RegDef_t), NULL, CRC_Sim_Write, pCrc);
+	Sim_AddModel(DMA2_BASEADDR, sizeof(DMA_RegDef_t), NULL, CRC_Sim_DMAWrite, pCrc);
+	SIM_REG(&CRC->DR) = CRC_SIM_INIT;
+}
@@ -0,0 +1,47 @@
+/*
+ * crc_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated CRC unit and DMA2 stream 0 of the simulated memory map (sim.h), as stm32f407xx_crc.c
+ * uses them
+ *
+ * 	- The CRC unit is a bitwise model of the hardware (Sim_CRCUnit): a word written to DR is taken
+ * 	  bit 31 first, poly 0x04C11DB7. RESET in CR sets DR to 0xFFFFFFFF and reads back 0. Writes while
+ * 	  the CRC clock is off (RCC AHB1ENR) are lost and counted
+ * 	- DMA2 stream 0: setting EN runs the whole transfer at once (memory to memory, PAR to M0AR, NDTR
+ * 	  words) and sets TCIF and HTIF. The configuration crc uses is checked (M2M, words, PINC, no
+ * 	  MINC, FIFO on, M0AR is the CRC DR, DMA2 clocked), anything else ends with TEIF and is counted.
+ * 	  FailDMA makes the next transfer end with TEIF. LIFCR clears the flags written to it
+ * 	- Counters: DR writes by the CPU, words moved by the DMA, resets
+ */
+
+#ifndef CRC_SIM_H_
+#define CRC_SIM_H_
+
+#include "sim.h"
+#include "stm32f407xx.h"
+
+typedef struct
+{
+	uint32_t	Words;									/* DR writes by the CPU */
+	uint32_t	DMAWords;								/* words the DMA moved into DR */
+	uint32_t	DMAStarts;
+	uint32_t	Resets;
+	uint32_t	Unclocked;								/* DR writes with the CRC clock off */
+	uint32_t	ConfigErrors;							/* DMA starts with a configuration crc does not use */
+	uint8_t		FailDMA;								/* 1 -> the next transfer ends with TEIF */
+}Sim_CRC_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_CRCInit(Sim_CRC_t *pCrc);
+uint32_t Sim_CRCUnit(uint32_t Crc, uint32_t Word);
+
+#endif /* CRC_SIM_H_ */
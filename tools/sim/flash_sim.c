@@ -0,0 +1,176 @@
+/*
+ * flash_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated internal flash (see flash_sim.h)
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include "flash_sim.h"
+
+#define FLASH_SIM_OFFSET(reg)			((uint32_t)offsetof(FLASH_RegDef_t, reg))
+#define FLASH_SIM_SR_RC_W1				(FLASH_SR_ERRORS | (1 << FLASH_SR_EOP))
+
+/*
+ * counts an operation, 1 -> this one is cut short
+ */
+static uint8_t Flash_Sim_Tear(Sim_Flash_t *pFlash)
+{
+	if(pFlash->FailAfter == 0 || --pFlash->FailAfter != 0)
+		return 0;
+
+	pFlash->Tears++;
+	return 1;
+}
+
+static void Flash_Sim_Erase(Sim_Flash_t *pFlash, uint8_t Sector)
+{
+	FLASH_RegDef_t *pRegs = (FLASH_RegDef_t*)Sim_Shadow(FLASHINTERFACE_BASEADDR);
+	uint8_t *pArray = (uint8_t*)Sim_Shadow(FLASH_GetSectorAddr(Sector));
+	uint32_t size = FLASH_GetSectorSize(Sector);
+
+	if(pFlash->WriteProtect & (1U << Sector))
+	{
+		pRegs->SR |= (1 << FLASH_SR_WRPERR);
+		return;
+	}
+
+	pFlash->EraseCount[Sector]++;
+	if(Flash_Sim_Tear(pFlash))
+	{
+		memset(pArray, 0xFF, size / 2);
+		Sim_PowerFail();
+	}
+	memset(pArray, 0xFF, size);
+}
+
+static void Flash_Sim_RegWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_Flash_t *pFlash = (Sim_Flash_t*)pContext;
+	FLASH_RegDef_t *pRegs = (FLASH_RegDef_t*)Sim_Shadow(FLASHINTERFACE_BASEADDR);
+
+	if(Offset == FLASH_SIM_OFFSET(KEYR))
+	{
+		if(!pFlash->KeyLocked && (pFlash->KeyStage == 0) && (pRegs->KEYR == FLASH_KEY1))
+			pFlash->KeyStage = 1;
+		else if(!pFlash->KeyLocked && (pFlash->KeyStage == 1) && (pRegs->KEYR == FLASH_KEY2))
+		{
+			pFlash->KeyStage = 0;
+			pRegs->CR &= ~(1UL << FLASH_CR_LOCK);
+		}
+		else
+			pFlash->KeyLocked = 1;
+		pRegs->KEYR = 0;
+	}
+	else if(Offset == FLASH_SIM_OFFSET(CR))
+	{
+		// locked: only LOCK itself can be written (it already is set)
+		if(OldValue & (1UL << FLASH_CR_LOCK))
+		{
+			pRegs->CR = OldValue;
+			return;
+		}
+		if(pRegs->CR & (1UL << FLASH_CR_LOCK))
+			pFlash->KeyStage = 0;
+
+		if(pRegs->CR & (1UL << FLASH_CR_STRT))
+		{
+			pRegs->CR &= ~(1UL << FLASH_CR_STRT);
+			if(pRegs->CR & (1UL << FLASH_CR_MER))
+			{
+				for(uint8_t sector = 0; sector < FLASH_NO_OF_SECTORS; sector++)
+					Flash_Sim_Erase(pFlash, sector);
+			}
+			else if(pRegs->CR & (1UL << FLASH_CR_SER))
+			{
+				Flash_Sim_Erase(pFlash, (pRegs->CR >> FLASH_CR_SNB) & 0xF);
+			}
+			else
+			{
+				pRegs->SR |= (1 << FLASH_SR_PGSERR);
+			}
+		}
+	}
+	else if(Offset == FLASH_SIM_OFFSET(SR))
+	{
+		pRegs->SR = OldValue & ~(pRegs->SR & FLASH_SIM_SR_RC_W1);
+	}
+}
+
+/*
+ * a write to the array: program with 1 -> 0 only
+ */
+static void Flash_Sim_ArrayWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_Flash_t *pFlash = (Sim_Flash_t*)pContext;
+	FLASH_RegDef_t *pRegs = (FLASH_RegDef_t*)Sim_Shadow(FLASHINTERFACE_BASEADDR);
+	uint32_t addr = FLASH_BASEADDR + Offset;
+	uint32_t written = SIM_REG(addr);
+	uint32_t changed = 0;
+	uint8_t sector = FLASH_GetSector(addr);
+
+	if((pRegs->CR & ((1UL << FLASH_CR_LOCK) | (1UL << FLASH_CR_PG))) != (1UL << FLASH_CR_PG))
+	{
+		pFlash->SeqErrors++;
+		pRegs->SR |= (1 << FLASH_SR_PGSERR);
+		SIM_REG(addr) = OldValue;
+		return;
+	}
+	if(pFlash->WriteProtect & (1U << sector))
+	{
+		pRegs->SR |= (1 << FLASH_SR_WRPERR);
+		SIM_REG(addr) = OldValue;
+		return;
+	}
+
+	// the bytes the access wrote, as far as a word compare can tell
+	for(uint32_t shift = 0; shift < 32; shift += 8)
+	{
+		if(((written ^ OldValue) >> shift) & 0xFF)
+			changed |= 0xFFUL << shift;
+	}
+
+	pFlash->ProgramCount[sector]++;
+	if((OldValue & changed) != changed)
+		pFlash->Overwrites++;
+	if(written & ~OldValue)
+		pFlash->ZeroToOne++;
+
+	if(Flash_Sim_Tear(pFlash))
+	{
+		SIM_REG(addr) = OldValue & (written | 0xFFFF0000UL);
+		Sim_PowerFail();
+	}
+	SIM_REG(addr) = OldValue & written;
+}
+
+/*
+ * attaches the flash interface and array models, the array is not erased here (Sim_Reset does)
+ */
+void Sim_FlashInit(Sim_Flash_t *pFlash)
+{
+	memset(pFlash, 0, sizeof(*pFlash));
+	Sim_AddModel(FLASHINTERFACE_BASEADDR, sizeof(FLASH_RegDef_t), NULL, Flash_Sim_RegWrite, pFlash);
+	Sim_AddModel(FLASH_BASEADDR, FLASH_END_ADDR - FLASH_BASEADDR, NULL, Flash_Sim_ArrayWrite, pFlash);
+	Sim_FlashPowerOn(pFlash);
+}
+
+/*
+ * power on reset of the flash interface, the array and the counters are kept
+ */
+void Sim_FlashPowerOn(Sim_Flash_t *pFlash)
+{
+	FLASH_RegDef_t *pRegs = (FLASH_RegDef_t*)Sim_Shadow(FLASHINTERFACE_BASEADDR);
+
+	pFlash->KeyStage = 0;
+	pFlash->KeyLocked = 0;
+	pFlash->FailAfter = 0;
+	pRegs->CR = (1UL << FLASH_CR_LOCK);
+	pRegs->SR = 0;
+	pRegs->KEYR = 0;
+}
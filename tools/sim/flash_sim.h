@@ -0,0 +1,55 @@
+/*
+ * flash_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated internal flash of the simulated memory map (sim.h), the flash interface registers and
+ * the array behind them as stm32f407xx_flash.c uses them
+ *
+ * 	- CR is locked at power on. KEY1 then KEY2 in KEYR unlocks it, a wrong sequence keeps it locked
+ * 	  till the next power on. A locked CR ignores writes, except for setting LOCK
+ * 	- STRT with SER erases sector SNB at once (BSY never shows), MER the whole array
+ * 	- A write to the array programs it only with PG set, else PGSERR and the array keeps its value.
+ * 	  Programming can only take bits from 1 to 0: the array keeps old AND new. Writes to a location
+ * 	  which was not erased and writes asking for a 0 to become 1 are counted, both are firmware bugs
+ * 	- WriteProtect has one bit per sector (nWRP cleared), erase and program there give WRPERR
+ * 	- SR error flags and EOP are write 1 to clear. PGPERR and PGAERR (parallelism and alignment
+ * 	  against PSIZE) are not modelled, the hooks see whole words
+ * 	- Wear: erases per sector and program accesses per sector
+ * 	- Torn writes: with FailAfter = n the n-th program access or erase from now is cut short and the
+ * 	  power fails (Sim_PowerFail). The torn word gets only its low half word programmed, a torn erase
+ * 	  only erases the first half of the sector. Sim_FlashPowerOn() after the power cycle
+ */
+
+#ifndef FLASH_SIM_H_
+#define FLASH_SIM_H_
+
+#include "sim.h"
+#include "stm32f407xx.h"
+
+typedef struct
+{
+	uint8_t		KeyStage;								/* KEY1 written, KEY2 expected next */
+	uint8_t		KeyLocked;								/* wrong key sequence, locked till power on */
+	uint16_t	WriteProtect;							/* 1 -> the sector is write protected */
+	uint32_t	FailAfter;								/* 0 never, else the power fails on the n-th operation */
+	uint32_t	EraseCount[FLASH_NO_OF_SECTORS];
+	uint32_t	ProgramCount[FLASH_NO_OF_SECTORS];		/* program accesses */
+	uint32_t	Overwrites;								/* programs of locations which were not erased */
+	uint32_t	ZeroToOne;								/* programs asking for a 0 bit to become 1 */
+	uint32_t	SeqErrors;								/* writes to the array without PG */
+	uint32_t	Tears;									/* operations cut short by FailAfter */
+}Sim_Flash_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_FlashInit(Sim_Flash_t *pFlash);
+void Sim_FlashPowerOn(Sim_Flash_t *pFlash);
+
+#endif /* FLASH_SIM_H_ */
@@ -0,0 +1,272 @@
+/*
+ * i2c_master_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated I2C master for a slave peripheral (see i2c_master_sim.h)
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include "i2c_master_sim.h"
+
+#define I2C_MASTER_SIM_SR1_RC_W0		((1 << I2C_SR1_BERR) | (1 << I2C_SR1_ARLO) | (1 << I2C_SR1_AF) | \
+										 (1 << I2C_SR1_OVR) | (1 << I2C_SR1_PECERR) | (1 << I2C_SR1_TIMEOUT) | \
+										 (1 << I2C_SR1_SMBALERT))
+#define I2C_MASTER_SIM_SR1_EVENT		((1 << I2C_SR1_ADDR) | (1 << I2C_SR1_STOPF) | (1 << I2C_SR1_BTF))
+#define I2C_MASTER_SIM_SR1_BUF			((1 << I2C_SR1_TxE) | (1 << I2C_SR1_RxNE))
+
+#define I2C_MASTER_SIM_OFFSET(reg)		((uint32_t)offsetof(I2C_RegDef_t, reg))
+
+static I2C_RegDef_t* I2C_Master_Sim_Regs(Sim_I2CMaster_t *pMaster)
+{
+	return (I2C_RegDef_t*)Sim_Shadow((uint32_t)(uintptr_t)pMaster->pI2Cx);
+}
+
+static uint8_t I2C_Master_Sim_EventPending(I2C_RegDef_t *pRegs)
+{
+	if(!(pRegs->CR2 & (1 << I2C_CR2_ITEVTEN)))
+		return 0;
+	if(pRegs->SR1 & I2C_MASTER_SIM_SR1_EVENT)
+		return 1;
+	return (pRegs->CR2 & (1 << I2C_CR2_ITBUFEN)) && (pRegs->SR1 & I2C_MASTER_SIM_SR1_BUF);
+}
+
+static uint8_t I2C_Master_Sim_ErrorPending(I2C_RegDef_t *pRegs)
+{
+	return (pRegs->CR2 & (1 << I2C_CR2_ITERREN)) && (pRegs->SR1 & I2C_MASTER_SIM_SR1_RC_W0);
+}
+
+/*
+ * one pending ISR, returns 0 if none was pending
+ */
+static uint8_t I2C_Master_Sim_ISR(Sim_I2CMaster_t *pMaster)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+	uint8_t event = I2C_Master_Sim_EventPending(pRegs);
+	uint8_t error = I2C_Master_Sim_ErrorPending(pRegs);
+
+	if(error && (pMaster->ErrorFirst || !event))
+		pMaster->pfnErrorISR();
+	else if(event)
+		pMaster->pfnEventISR();
+	else
+		return 0;
+
+	return 1;
+}
+
+/*
+ * the ISRs run until nothing is pending
+ */
+static void I2C_Master_Sim_Service(Sim_I2CMaster_t *pMaster)
+{
+	for(uint32_t n = 0; n < SIM_I2C_MASTER_MAX_ISR; n++)
+	{
+		if(!I2C_Master_Sim_ISR(pMaster))
+			return;
+	}
+}
+
+/*
+ * SCL stretched until the slave has a byte in the shift register (transmitter) or took the received
+ * one (receiver). Returns 0 if the slave never does
+ */
+static uint8_t I2C_Master_Sim_Stretch(Sim_I2CMaster_t *pMaster, uint8_t Transmitter)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+	uint32_t n;
+
+	for(n = 0; n < SIM_I2C_MASTER_MAX_ISR; n++)
+	{
+		if(Transmitter ? pMaster->ShiftFull : !(pRegs->SR1 & ((1 << I2C_SR1_RxNE) | (1 << I2C_SR1_ADDR))))
+			break;
+		if(!I2C_Master_Sim_ISR(pMaster))
+			return 0;
+	}
+
+	if(n != 0)
+		pMaster->Stretches++;
+	return n < SIM_I2C_MASTER_MAX_ISR;
+}
+
+/*
+ * 1 -> the peripheral acknowledges SlaveAddr and the transfer starts, Read sets TRA
+ */
+static uint8_t I2C_Master_Sim_Start(Sim_I2CMaster_t *pMaster, uint8_t SlaveAddr, uint8_t Read)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+
+	if(!(pRegs->CR1 & (1 << I2C_CR1_PE)) || !(pRegs->CR1 & (1 << I2C_CR1_ACK)) ||
+	   (((pRegs->OAR1 >> 1) & 0x7F) != SlaveAddr))
+		return 0;
+
+	pMaster->ShiftFull = 0;
+	pMaster->DRFull = 0;
+	pMaster->Nacked = 0;
+	pRegs->SR2 = (1 << I2C_SR2_BUSY) | (Read ? (1 << I2C_SR2_TRA) : 0);
+	pRegs->SR1 = (1 << I2C_SR1_ADDR) | (Read ? (1 << I2C_SR1_TxE) : 0);
+
+	return I2C_Master_Sim_Stretch(pMaster, 0);
+}
+
+static void I2C_Master_Sim_Stop(Sim_I2CMaster_t *pMaster)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+
+	// the STOP clears TxE and TRA, the ISR then sees STOPF (and a late AF) only
+	pRegs->SR1 = (pRegs->SR1 & ~(1 << I2C_SR1_TxE)) | (1 << I2C_SR1_STOPF);
+	pRegs->SR2 &= ~(1 << I2C_SR2_TRA);
+	I2C_Master_Sim_Service(pMaster);
+
+	if(pMaster->DRFull)
+		pMaster->Dropped++;
+	pMaster->ShiftFull = 0;
+	pMaster->DRFull = 0;
+	pRegs->SR1 = 0;
+	pRegs->SR2 = 0;
+}
+
+static void I2C_Master_Sim_Read(void *pContext, uint32_t Offset)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs((Sim_I2CMaster_t*)pContext);
+
+	if(Offset == I2C_MASTER_SIM_OFFSET(SR2))
+	{
+		// SR1 was read before, this read ends the address phase
+		pRegs->SR1 &= ~(1 << I2C_SR1_ADDR);
+	}
+	else if(Offset == I2C_MASTER_SIM_OFFSET(DR))
+	{
+		pRegs->SR1 &= ~(1 << I2C_SR1_RxNE);
+	}
+}
+
+static void I2C_Master_Sim_Write(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_I2CMaster_t *pMaster = (Sim_I2CMaster_t*)pContext;
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+
+	if(Offset == I2C_MASTER_SIM_OFFSET(DR))
+	{
+		if(!(pRegs->SR2 & (1 << I2C_SR2_TRA)))
+			return;
+
+		if(!pMaster->ShiftFull && !pMaster->Nacked)
+		{
+			pMaster->Shift = (uint8_t)pRegs->DR;
+			pMaster->ShiftFull = 1;
+			return;
+		}
+
+		if(pMaster->DRFull)
+			pMaster->Dropped++;
+		pMaster->DRFull = 1;
+		pRegs->SR1 &= ~(1 << I2C_SR1_TxE);
+	}
+	else if(Offset == I2C_MASTER_SIM_OFFSET(CR1))
+	{
+		// SR1 read then a CR1 write clears STOPF
+		pRegs->SR1 &= ~(1 << I2C_SR1_STOPF);
+	}
+	else if(Offset == I2C_MASTER_SIM_OFFSET(SR1))
+	{
+		// rc_w0 flags, everything else is read only
+		pRegs->SR1 = OldValue & (pRegs->SR1 | ~I2C_MASTER_SIM_SR1_RC_W0);
+	}
+	else if(Offset == I2C_MASTER_SIM_OFFSET(SR2))
+	{
+		pRegs->SR2 = OldValue;
+	}
+}
+
+/*
+ * attaches the master to an I2C peripheral of the simulated memory map
+ */
+void Sim_I2CMasterInit(Sim_I2CMaster_t *pMaster, I2C_RegDef_t *pI2Cx, void (*pfnEventISR)(void), void (*pfnErrorISR)(void))
+{
+	memset(pMaster, 0, sizeof(*pMaster));
+	pMaster->pI2Cx = pI2Cx;
+	pMaster->pfnEventISR = pfnEventISR;
+	pMaster->pfnErrorISR = pfnErrorISR;
+	Sim_AddModel((uint32_t)(uintptr_t)pI2Cx, sizeof(I2C_RegDef_t), I2C_Master_Sim_Read, I2C_Master_Sim_Write, pMaster);
+}
+
+/*
+ * START, address + W, Len bytes, STOP. Returns the bytes the slave took, 0 on an address NACK
+ */
+uint32_t Sim_I2CMasterWrite(Sim_I2CMaster_t *pMaster, uint8_t SlaveAddr, const uint8_t *pData, uint32_t Len)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+	uint32_t i;
+
+	if(!I2C_Master_Sim_Start(pMaster, SlaveAddr, 0))
+		return 0;
+
+	for(i = 0; i < Len; i++)
+	{
+		pRegs->DR = pData[i];
+		pRegs->SR1 |= (1 << I2C_SR1_RxNE);
+		if(!pMaster->LateISR)
+			I2C_Master_Sim_Service(pMaster);
+		if(!I2C_Master_Sim_Stretch(pMaster, 0))
+			break;
+	}
+
+	I2C_Master_Sim_Stop(pMaster);
+	return i;
+}
+
+/*
+ * START, address + R, Len bytes, the last one NACKed, STOP. Returns the bytes received, 0 on an
+ * address NACK
+ */
+uint32_t Sim_I2CMasterRead(Sim_I2CMaster_t *pMaster, uint8_t SlaveAddr, uint8_t *pData, uint32_t Len)
+{
+	I2C_RegDef_t *pRegs = I2C_Master_Sim_Regs(pMaster);
+	uint32_t i;
+
+	if(!I2C_Master_Sim_Start(pMaster, SlaveAddr, 1))
+		return 0;
+	if(!pMaster->LateISR)
+		I2C_Master_Sim_Service(pMaster);
+
+	for(i = 0; i < Len; i++)
+	{
+		if(!I2C_Master_Sim_Stretch(pMaster, 1))
+			break;
+
+		pData[i] = pMaster->Shift;
+		pMaster->ShiftFull = 0;
+
+		if(i + 1 < Len)
+		{
+			// ACK, the byte waiting in DR goes next
+			if(pMaster->DRFull)
+			{
+				pMaster->Shift = (uint8_t)pRegs->DR;
+				pMaster->ShiftFull = 1;
+				pMaster->DRFull = 0;
+			}
+			pRegs->SR1 |= (1 << I2C_SR1_TxE);
+		}
+		else
+		{
+			pMaster->Nacked = 1;
+			pMaster->Nacks++;
+			pRegs->SR1 |= (1 << I2C_SR1_AF);
+		}
+
+		if(!pMaster->LateISR)
+			I2C_Master_Sim_Service(pMaster);
+	}
+
+	// the STOP follows the NACK without a stretch, a late ISR only runs after it
+	if(!pMaster->LateISR)
+		I2C_Master_Sim_Service(pMaster);
+	I2C_Master_Sim_Stop(pMaster);
+	return i;
+}
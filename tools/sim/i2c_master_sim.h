@@ -0,0 +1,61 @@
+/*
+ * i2c_master_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated I2C master on the bus of an I2C peripheral in slave mode, on the simulated memory map
+ * (sim.h). The counterpart of i2c_sim.h, for firmware which is the slave
+ *
+ * 	- Models the slave side of the I2C registers as the interrupt driven driver uses them: own address
+ * 	  (OAR1) -> ADDR with TRA, SR1 then SR2 clears ADDR, RxNE until DR is read, STOPF until CR1 is
+ * 	  written, AF is cleared by writing 0 to it
+ * 	- Slave transmitter with the data register and the shift register: a DR write goes to the shift
+ * 	  register when it is empty (TxE stays set), else it waits in DR (TxE clear). An acknowledged byte
+ * 	  takes the next one from DR. A NACK sets AF and leaves DR as it is, DR writes after it are never
+ * 	  sent. STOP clears TxE and TRA and drops what is left in DR
+ * 	- The ISRs are the callbacks pfnEventISR and pfnErrorISR, called from the master functions (thread
+ * 	  context, not from the hooks). They run while an enabled flag is pending. SCL is stretched (the
+ * 	  ISR runs) when the slave has no byte to shift out or has not taken the received one
+ * 	- LateISR: the ISRs only run when SCL is stretched, TxE is still pending when the master NACKs and
+ * 	  the AF is seen with the STOP. ErrorFirst: of the event and the error ISR pending together the
+ * 	  error ISR runs first
+ * 	- The bus is instant. Stretches and NACKed bytes are counted
+ */
+
+#ifndef I2C_MASTER_SIM_H_
+#define I2C_MASTER_SIM_H_
+
+#include "sim.h"
+#include "stm32f407xx.h"
+
+#define SIM_I2C_MASTER_MAX_ISR			16			/* ISR calls per stretch before the slave is given up */
+
+typedef struct
+{
+	I2C_RegDef_t		*pI2Cx;
+	void				(*pfnEventISR)(void);
+	void				(*pfnErrorISR)(void);
+	uint8_t				LateISR;				/* 1 -> the event ISR only runs on a stretch */
+	uint8_t				ErrorFirst;				/* 1 -> the error ISR runs before the event ISR */
+	uint8_t				Shift;					/* byte in the shift register */
+	uint8_t				ShiftFull;
+	uint8_t				DRFull;					/* written byte waiting in DR */
+	uint8_t				Nacked;					/* the master NACKed, the transfer is over */
+	uint32_t			Stretches;				/* bytes the master waited for the ISR */
+	uint32_t			Nacks;					/* bytes not acknowledged by the master */
+	uint32_t			Dropped;				/* bytes written to DR and never sent */
+}Sim_I2CMaster_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_I2CMasterInit(Sim_I2CMaster_t *pMaster, I2C_RegDef_t *pI2Cx, void (*pfnEventISR)(void), void (*pfnErrorISR)(void));
+uint32_t Sim_I2CMasterWrite(Sim_I2CMaster_t *pMaster, uint8_t SlaveAddr, const uint8_t *pData, uint32_t Len);
+uint32_t Sim_I2CMasterRead(Sim_I2CMaster_t *pMaster, uint8_t SlaveAddr, uint8_t *pData, uint32_t Len);
+
+#endif /* I2C_MASTER_SIM_H_ */
@@ -0,0 +1,217 @@
+/*
+ * i2c_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated I2C bus (see i2c_sim.h)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "i2c_sim.h"
+
+#define I2C_SIM_IDLE					0
+#define I2C_SIM_ADDRESS					1		/* START sent, waiting for the address */
+#define I2C_SIM_TX						2
+#define I2C_SIM_RX						3
+#define I2C_SIM_RX_LAST					4		/* last byte (NACK) is in DR, waiting for STOP */
+#define I2C_SIM_NACKED					5
+
+#define I2C_SIM_SR1_RC_W0				((1 << I2C_SR1_BERR) | (1 << I2C_SR1_ARLO) | (1 << I2C_SR1_AF) | \
+										 (1 << I2C_SR1_OVR) | (1 << I2C_SR1_PECERR) | (1 << I2C_SR1_TIMEOUT) | \
+										 (1 << I2C_SR1_SMBALERT))
+
+#define I2C_SIM_OFFSET(reg)				((uint32_t)offsetof(I2C_RegDef_t, reg))
+
+static void I2C_Sim_Stop(Sim_I2CBus_t *pBus, I2C_RegDef_t *pRegs)
+{
+	if(pBus->pActive != NULL && pBus->pActive->pfnStop != NULL)
+		pBus->pActive->pfnStop(pBus->pActive);
+
+	pBus->pActive = NULL;
+	pBus->State = I2C_SIM_IDLE;
+	pBus->StopPending = 0;
+	pRegs->SR1 &= ~((1 << I2C_SR1_TxE) | (1 << I2C_SR1_BTF) | (1 << I2C_SR1_ADDR) | (1 << I2C_SR1_SB));
+	pRegs->SR2 = 0;
+}
+
+static void I2C_Sim_Address(Sim_I2CBus_t *pBus, I2C_RegDef_t *pRegs, uint8_t addrByte)
+{
+	uint8_t read = addrByte & 1;
+
+	pRegs->SR1 &= ~(1 << I2C_SR1_SB);
+	pBus->pActive = NULL;
+
+	for(uint32_t i = 0; i < SIM_I2C_MAX_DEVICES; i++)
+	{
+		Sim_I2CDevice_t *pDev = pBus->pDevices[i];
+		if(pDev != NULL && pDev->SlaveAddr == (addrByte >> 1) && !pDev->NackAddr)
+			pBus->pActive = pDev;
+	}
+
+	if(pBus->pActive == NULL)
+	{
+		pBus->AddrNacks++;
+		pBus->State = I2C_SIM_NACKED;
+		pRegs->SR1 |= (1 << I2C_SR1_AF);
+		return;
+	}
+
+	if(pBus->pActive->pfnStart != NULL)
+		pBus->pActive->pfnStart(pBus->pActive, read);
+
+	pBus->State = read ? I2C_SIM_RX : I2C_SIM_TX;
+	pRegs->SR1 |= (1 << I2C_SR1_ADDR);
+	if(read)
+		pRegs->SR2 &= ~(1 << I2C_SR2_TRA);
+	else
+		pRegs->SR2 |= (1 << I2C_SR2_TRA);
+}
+
+/*
+ * the slave sends the next byte when the master polls for it
+ */
+static void I2C_Sim_Receive(Sim_I2CBus_t *pBus, I2C_RegDef_t *pRegs)
+{
+	uint8_t last;
+
+	if(pBus->State != I2C_SIM_RX || (pRegs->SR1 & ((1 << I2C_SR1_RxNE) | (1 << I2C_SR1_ADDR))))
+		return;
+
+	// ACK cleared or STOP requested before the byte arrives -> the master NACKs it
+	last = !(pRegs->CR1 & (1 << I2C_CR1_ACK)) || pBus->StopPending;
+
+	pRegs->DR = pBus->pActive->pfnRead ? pBus->pActive->pfnRead(pBus->pActive) : 0xFF;
+	pRegs->SR1 |= (1 << I2C_SR1_RxNE);
+	pBus->BytesRead++;
+
+	if(last)
+	{
+		if(pBus->StopPending)
+			I2C_Sim_Stop(pBus, pRegs);
+		else
+			pBus->State = I2C_SIM_RX_LAST;
+	}
+}
+
+static void I2C_Sim_Read(void *pContext, uint32_t Offset)
+{
+	Sim_I2CBus_t *pBus = (Sim_I2CBus_t*)pContext;
+	I2C_RegDef_t *pRegs = (I2C_RegDef_t*)Sim_Shadow((uint32_t)(uintptr_t)pBus->pI2Cx);
+
+	if(Offset == I2C_SIM_OFFSET(SR1))
+	{
+		I2C_Sim_Receive(pBus, pRegs);
+	}
+	else if(Offset == I2C_SIM_OFFSET(SR2))
+	{
+		// SR1 was read before, this read ends the address phase
+		if(pRegs->SR1 & (1 << I2C_SR1_ADDR))
+		{
+			pRegs->SR1 &= ~(1 << I2C_SR1_ADDR);
+			if(pBus->State == I2C_SIM_TX)
+				pRegs->SR1 |= (1 << I2C_SR1_TxE);
+		}
+	}
+	else if(Offset == I2C_SIM_OFFSET(DR))
+	{
+		pRegs->SR1 &= ~((1 << I2C_SR1_RxNE) | (1 << I2C_SR1_BTF));
+	}
+}
+
+static void I2C_Sim_Write(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_I2CBus_t *pBus = (Sim_I2CBus_t*)pContext;
+	I2C_RegDef_t *pRegs = (I2C_RegDef_t*)Sim_Shadow((uint32_t)(uintptr_t)pBus->pI2Cx);
+
+	if(Offset == I2C_SIM_OFFSET(CR1))
+	{
+		if(pRegs->CR1 & (1 << I2C_CR1_START))
+		{
+			// repeated start: the slave sees the end of the previous transfer
+			if(pBus->pActive != NULL && pBus->pActive->pfnStop != NULL)
+				pBus->pActive->pfnStop(pBus->pActive);
+			pBus->pActive = NULL;
+			pBus->StopPending = 0;
+
+			pRegs->CR1 &= ~(1 << I2C_CR1_START);
+			pRegs->SR1 = (1 << I2C_SR1_SB);
+			pRegs->SR2 = (1 << I2C_SR2_MSL) | (1 << I2C_SR2_BUSY);
+			pBus->State = I2C_SIM_ADDRESS;
+			pBus->Transfers++;
+		}
+		if(pRegs->CR1 & (1 << I2C_CR1_STOP))
+		{
+			pRegs->CR1 &= ~(1 << I2C_CR1_STOP);
+			if(pBus->State == I2C_SIM_RX)
+				pBus->StopPending = 1;
+			else
+				I2C_Sim_Stop(pBus, pRegs);
+		}
+	}
+	else if(Offset == I2C_SIM_OFFSET(DR))
+	{
+		if(pBus->State == I2C_SIM_ADDRESS)
+		{
+			I2C_Sim_Address(pBus, pRegs, (uint8_t)pRegs->DR);
+		}
+		else if(pBus->State == I2C_SIM_TX)
+		{
+			uint8_t ack = 1;
+
+			pBus->BytesWritten++;
+			if(pBus->pActive->NackData)
+				ack = 0;
+			else if(pBus->pActive->pfnWrite != NULL)
+				ack = pBus->pActive->pfnWrite(pBus->pActive, (uint8_t)pRegs->DR);
+
+			pRegs->SR1 |= (1 << I2C_SR1_TxE) | (1 << I2C_SR1_BTF);
+			if(!ack)
+				pRegs->SR1 |= (1 << I2C_SR1_AF);
+		}
+	}
+	else if(Offset == I2C_SIM_OFFSET(SR1))
+	{
+		// rc_w0 flags, everything else is read only
+		pRegs->SR1 = OldValue & (pRegs->SR1 | ~I2C_SIM_SR1_RC_W0);
+	}
+	else if(Offset == I2C_SIM_OFFSET(SR2))
+	{
+		pRegs->SR2 = OldValue;
+	}
+}
+
+/*
+ * attaches the bus model to an I2C peripheral of the simulated memory map
+ */
+void Sim_I2CBusInit(Sim_I2CBus_t *pBus, I2C_RegDef_t *pI2Cx)
+{
+	memset(pBus, 0, sizeof(*pBus));
+	pBus->pI2Cx = pI2Cx;
+	Sim_AddModel((uint32_t)(uintptr_t)pI2Cx, sizeof(I2C_RegDef_t), I2C_Sim_Read, I2C_Sim_Write, pBus);
+}
+
+void Sim_I2CAttach(Sim_I2CBus_t *pBus, Sim_I2CDevice_t *pDev)
+{
+	for(uint32_t i = 0; i < SIM_I2C_MAX_DEVICES; i++)
+	{
+		if(pBus->pDevices[i] == NULL)
+		{
+			pBus->pDevices[i] = pDev;
+			return;
+		}
+	}
+	fprintf(stderr, "sim: too many devices on one bus\n");
+}
+
+void Sim_I2CClearCounters(Sim_I2CBus_t *pBus)
+{
+	pBus->Transfers = 0;
+	pBus->AddrNacks = 0;
+	pBus->BytesWritten = 0;
+	pBus->BytesRead = 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * i2c_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated I2C bus behind an I2C peripheral of the simulated memory map (sim.h)
+ *
+ * 	- Models the master side of the I2C registers as the blocking driver uses them: START -> SB,
+ * 	  address in DR -> ADDR (slave acknowledged) or AF, SR1 then SR2 clears ADDR, every DR write is
+ * 	  one byte to the slave with TxE and BTF set straight away, RxNE is set when SR1 is polled and
+ * 	  the slave has a byte to send, AF is cleared by writing 0 to it
+ * 	- The bus is instant, no clock stretching and no arbitration
+ * 	- Slaves are Sim_I2CDevice_t, a set of callbacks per address. NackAddr makes a slave disappear,
+ * 	  NackData makes it refuse written bytes (bus errors)
+ * 	- Every bus keeps its own counters, the tests use them to count bus accesses
+ */
+
+#ifndef I2C_SIM_H_
+#define I2C_SIM_H_
+
+#include "sim.h"
+#include "stm32f407xx.h"
+
+#define SIM_I2C_MAX_DEVICES				4
+
+typedef struct Sim_I2CDevice
+{
+	uint8_t		SlaveAddr;
+	uint8_t		NackAddr;				/* 1 -> the address is not acknowledged */
+	uint8_t		NackData;				/* 1 -> written bytes are not acknowledged */
+	void		(*pfnStart)(struct Sim_I2CDevice *pDev, uint8_t Read);
+	uint8_t		(*pfnWrite)(struct Sim_I2CDevice *pDev, uint8_t Data);
+	uint8_t		(*pfnRead)(struct Sim_I2CDevice *pDev);
+	void		(*pfnStop)(struct Sim_I2CDevice *pDev);
+}Sim_I2CDevice_t;
+
+typedef struct
+{
+	I2C_RegDef_t		*pI2Cx;
+	Sim_I2CDevice_t		*pDevices[SIM_I2C_MAX_DEVICES];
+	Sim_I2CDevice_t		*pActive;		/* slave addressed in the current transfer */
+	uint8_t				State;
+	uint8_t				StopPending;	/* STOP requested while receiving, ends after the next byte */
+	uint32_t			Transfers;		/* START conditions (repeated ones included) */
+	uint32_t			AddrNacks;
+	uint32_t			BytesWritten;
+	uint32_t			BytesRead;
+}Sim_I2CBus_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_I2CBusInit(Sim_I2CBus_t *pBus, I2C_RegDef_t *pI2Cx);
+void Sim_I2CAttach(Sim_I2CBus_t *pBus, Sim_I2CDevice_t *pDev);
+void Sim_I2CClearCounters(Sim_I2CBus_t *pBus);
+
+#endif /* I2C_SIM_H_ */
@@ -0,0 +1,225 @@
+/*
+ * irtc_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated backup domain (see irtc_sim.h)
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include "irtc_sim.h"
+
+#define IRTC_SIM_OFFSET(reg)			((uint32_t)offsetof(IRTC_RegDef_t, reg))
+#define IRTC_SIM_RCC_OFFSET(reg)		((uint32_t)offsetof(RCC_RegDef_t, reg))
+#define IRTC_SIM_DBP()					(SIM_REG(&PWR->CR) & (1 << PWR_CR_DBP))
+#define IRTC_SIM_ISR_RC_W0				((1UL << IRTC_ISR_RSF) | 0x3F00UL)		/* RSF and bits 13:8 */
+#define IRTC_SIM_ISR_RESET				0x00000007UL
+#define IRTC_SIM_DR_RESET				0x00002101UL
+#define IRTC_SIM_PRER_RESET				0x007F00FFUL
+#define IRTC_SIM_SEL_LSE				1
+#define IRTC_SIM_SEL_LSI				2
+
+static void IRTC_Sim_DomainReset(Sim_IRTC_t *pIRTC)
+{
+	IRTC_RegDef_t *pRegs = (IRTC_RegDef_t*)Sim_Shadow(RTC_BKP_BASEADDR);
+
+	memset(pRegs, 0, sizeof(*pRegs));
+	pRegs->ISR = IRTC_SIM_ISR_RESET;
+	pRegs->DR = IRTC_SIM_DR_RESET;
+	pRegs->PRER = IRTC_SIM_PRER_RESET;
+	SIM_REG(&RCC->BDCR) = 0;
+	pIRTC->KeyStage = 0;
+	pIRTC->Unlocked = 0;
+}
+
+/*
+ * the flags which follow the clock and the calendar
+ */
+static void IRTC_Sim_Update(void)
+{
+	IRTC_RegDef_t *pRegs = (IRTC_RegDef_t*)Sim_Shadow(RTC_BKP_BASEADDR);
+	uint32_t isr = pRegs->ISR & ~((1UL << IRTC_ISR_INITF) | (1UL << IRTC_ISR_INITS));
+	uint8_t running = Sim_IRTCIsRunning();
+
+	if(running && (isr & (1UL << IRTC_ISR_INIT)))
+		isr |= (1UL << IRTC_ISR_INITF);
+	if(running && !(isr & (1UL << IRTC_ISR_INIT)))
+		isr |= (1UL << IRTC_ISR_RSF);
+	if(pRegs->DR & (0xFFUL << IRTC_DR_YU))
+		isr |= (1UL << IRTC_ISR_INITS);
+	pRegs->ISR = isr;
+}
+
+static void IRTC_Sim_RCCWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_IRTC_t *pIRTC = (Sim_IRTC_t*)pContext;
+	RCC_RegDef_t *pRCC = (RCC_RegDef_t*)Sim_Shadow(RCC_BASEADDR);
+
+	if(Offset == IRTC_SIM_RCC_OFFSET(BDCR))
+	{
+		uint32_t bdcr = pRCC->BDCR;
+		uint32_t oldSel = (OldValue >> RCC_BDCR_RTCSEL) & 0x3;
+
+		if(!IRTC_SIM_DBP())
+		{
+			pIRTC->Dropped++;
+			pRCC->BDCR = OldValue;
+			return;
+		}
+
+		// held in reset while BDRST is set
+		if(bdcr & (1UL << RCC_BDCR_BDRST))
+		{
+			if(!(OldValue & (1UL << RCC_BDCR_BDRST)))
+			{
+				pIRTC->Resets++;
+				IRTC_Sim_DomainReset(pIRTC);
+			}
+			pRCC->BDCR = (1UL << RCC_BDCR_BDRST);
+			IRTC_Sim_Update();
+			return;
+		}
+
+		if((oldSel != 0) && (((bdcr >> RCC_BDCR_RTCSEL) & 0x3) != oldSel))
+		{
+			pIRTC->SelRefused++;
+			bdcr = (bdcr & ~(0x3UL << RCC_BDCR_RTCSEL)) | (oldSel << RCC_BDCR_RTCSEL);
+		}
+
+		bdcr &= ~(1UL << RCC_BDCR_LSERDY);
+		if((bdcr & (1UL << RCC_BDCR_LSEON)) && pIRTC->LSEFitted)
+			bdcr |= (1UL << RCC_BDCR_LSERDY);
+		pRCC->BDCR = bdcr;
+		IRTC_Sim_Update();
+	}
+	else if(Offset == IRTC_SIM_RCC_OFFSET(CSR))
+	{
+		pRCC->CSR &= ~(1UL << RCC_CSR_LSIRDY);
+		if(pRCC->CSR & (1UL << RCC_CSR_LSION))
+			pRCC->CSR |= (1UL << RCC_CSR_LSIRDY);
+		IRTC_Sim_Update();
+	}
+}
+
+static void IRTC_Sim_Write(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	Sim_IRTC_t *pIRTC = (Sim_IRTC_t*)pContext;
+	IRTC_RegDef_t *pRegs = (IRTC_RegDef_t*)Sim_Shadow(RTC_BKP_BASEADDR);
+	uint32_t *pReg = (uint32_t*)((uint8_t*)pRegs + Offset);
+	uint32_t written = *pReg;
+
+	if(!IRTC_SIM_DBP())
+	{
+		pIRTC->Dropped++;
+		*pReg = OldValue;
+		return;
+	}
+
+	if(Offset >= IRTC_SIM_OFFSET(BKPR))
+		return;
+
+	if(Offset == IRTC_SIM_OFFSET(WPR))
+	{
+		if((pIRTC->KeyStage == 0) && (written == IRTC_WPR_KEY1))
+			pIRTC->KeyStage = 1;
+		else if((pIRTC->KeyStage == 1) && (written == IRTC_WPR_KEY2))
+		{
+			pIRTC->KeyStage = 0;
+			pIRTC->Unlocked = 1;
+		}
+		else
+		{
+			pIRTC->KeyStage = 0;
+			pIRTC->Unlocked = 0;
+		}
+		*pReg = 0;
+		return;
+	}
+
+	if(Offset == IRTC_SIM_OFFSET(ISR))
+	{
+		uint32_t rcw0 = IRTC_SIM_ISR_RC_W0;
+		uint32_t init = OldValue & (1UL << IRTC_ISR_INIT);
+
+		// bits 7:0 are behind the key lock, 13:8 are not
+		if(pIRTC->Unlocked)
+			init = written & (1UL << IRTC_ISR_INIT);
+		else
+		{
+			rcw0 &= ~(1UL << IRTC_ISR_RSF);
+			if((written ^ OldValue) & (1UL << IRTC_ISR_INIT))
+				pIRTC->Locked++;
+		}
+
+		*pReg = (OldValue & ~(rcw0 | (1UL << IRTC_ISR_INIT))) | (OldValue & written & rcw0) | init;
+		IRTC_Sim_Update();
+		return;
+	}
+
+	if(!pIRTC->Unlocked ||
+	   (((Offset == IRTC_SIM_OFFSET(TR)) || (Offset == IRTC_SIM_OFFSET(DR)) || (Offset == IRTC_SIM_OFFSET(PRER))) &&
+		!(pRegs->ISR & (1UL << IRTC_ISR_INITF))))
+	{
+		pIRTC->Locked++;
+		*pReg = OldValue;
+		return;
+	}
+
+	IRTC_Sim_Update();
+}
+
+/*
+ * 1 -> RTCEN and the selected clock is ready
+ */
+uint8_t Sim_IRTCIsRunning(void)
+{
+	uint32_t bdcr = SIM_REG(&RCC->BDCR);
+	uint32_t rtcSel = (bdcr >> RCC_BDCR_RTCSEL) & 0x3;
+
+	if(!(bdcr & (1UL << RCC_BDCR_RTCEN)))
+		return 0;
+	if(rtcSel == IRTC_SIM_SEL_LSE)
+		return (bdcr >> RCC_BDCR_LSERDY) & 1;
+	if(rtcSel == IRTC_SIM_SEL_LSI)
+		return (SIM_REG(&RCC->CSR) >> RCC_CSR_LSIRDY) & 1;
+	return 0;
+}
+
+/*
+ * attaches the RCC and RTC models and powers the part on without a battery
+ */
+void Sim_IRTCInit(Sim_IRTC_t *pIRTC, uint8_t LSEFitted)
+{
+	memset(pIRTC, 0, sizeof(*pIRTC));
+	pIRTC->LSEFitted = LSEFitted;
+	Sim_AddModel(RCC_BASEADDR, sizeof(RCC_RegDef_t), NULL, IRTC_Sim_RCCWrite, pIRTC);
+	Sim_AddModel(RTC_BKP_BASEADDR, sizeof(IRTC_RegDef_t), NULL, IRTC_Sim_Write, pIRTC);
+	Sim_IRTCPowerOn(pIRTC);
+}
+
+/*
+ * power on without VBAT: the backup domain starts from its reset values
+ */
+void Sim_IRTCPowerOn(Sim_IRTC_t *pIRTC)
+{
+	IRTC_Sim_DomainReset(pIRTC);
+	Sim_IRTCReset(pIRTC);
+}
+
+/*
+ * MCU reset, the backup domain keeps its state
+ */
+void Sim_IRTCReset(Sim_IRTC_t *pIRTC)
+{
+	IRTC_RegDef_t *pRegs = (IRTC_RegDef_t*)Sim_Shadow(RTC_BKP_BASEADDR);
+
+	SIM_REG(&RCC->CSR) &= ~((1UL << RCC_CSR_LSION) | (1UL << RCC_CSR_LSIRDY));
+	SIM_REG(&PWR->CR) &= ~(1UL << PWR_CR_DBP);
+	pRegs->ISR &= ~((1UL << IRTC_ISR_INIT) | (1UL << IRTC_ISR_INITF) | (1UL << IRTC_ISR_RSF));
+	pIRTC->KeyStage = 0;
+	pIRTC->Unlocked = 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * irtc_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated backup domain of the simulated memory map (sim.h): RCC_BDCR, the LSI in RCC_CSR, the on-chip
+ * RTC and its backup registers, as stm32f407xx_irtc.c uses them
+ *
+ * 	- DBP: writes to RCC_BDCR, the RTC and the backup registers while PWR_CR DBP is clear are lost
+ * 	  and counted. DBP is cleared by an MCU reset
+ * 	- RTC_WPR: 0xCA then 0x53 unlocks, any other value locks again. Locked writes to the RTC registers
+ * 	  (ISR bits 7:0 included) are lost and counted. ISR bits 13:8 and the backup registers are not
+ * 	  behind the key lock
+ * 	- BDRST resets the backup domain: BDCR, the RTC registers to their reset values, the backup
+ * 	  registers to 0. LSE stops. Resets are counted
+ * 	- RTCSEL can only be written while it is 0, a write of another source is refused and counted
+ * 	- LSERDY follows LSEON when LSEFitted, else it never sets. LSIRDY follows LSION at once. The
+ * 	  calendar runs with RTCEN and the selected clock ready
+ * 	- INITF follows INIT when the calendar runs. TR, DR and PRER only take writes in init mode. INITS
+ * 	  is set while the year is not 0. The shadow registers are copied at once: RSF is set while the
+ * 	  calendar runs out of init mode, clearing it sets it again. The calendar does not advance, the
+ * 	  wakeup timer and the alarms are not modelled
+ * 	- Sim_IRTCReset() is an MCU reset (LSI off, DBP clear, RSF clear), the backup domain keeps running
+ * 	  on VBAT. Sim_IRTCPowerOn() is a power on without a battery
+ */
+
+#ifndef IRTC_SIM_H_
+#define IRTC_SIM_H_
+
+#include "sim.h"
+#include "stm32f407xx.h"
+
+typedef struct
+{
+	uint8_t		LSEFitted;								/* 1 -> the 32.768kHz crystal starts */
+	uint8_t		KeyStage;								/* 0xCA written, 0x53 expected next */
+	uint8_t		Unlocked;								/* RTC_WPR keys written */
+	uint32_t	Dropped;								/* writes lost with DBP clear */
+	uint32_t	Locked;									/* writes lost behind the RTC_WPR lock */
+	uint32_t	Resets;									/* backup domain resets (BDRST) */
+	uint32_t	SelRefused;								/* RTCSEL writes refused */
+}Sim_IRTC_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_IRTCInit(Sim_IRTC_t *pIRTC, uint8_t LSEFitted);
+void Sim_IRTCPowerOn(Sim_IRTC_t *pIRTC);
+void Sim_IRTCReset(Sim_IRTC_t *pIRTC);
+uint8_t Sim_IRTCIsRunning(void);
+
+#endif /* IRTC_SIM_H_ */
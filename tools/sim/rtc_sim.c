@@ -0,0 +1,408 @@
+/*
+ * rtc_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated I2C RTC parts (see rtc_sim.h)
+ */
+
+#include <string.h>
+#include "rtc_sim.h"
+
+/*
+ * where a part keeps its calendar and which bits can be written
+ */
+typedef struct
+{
+	uint8_t		SlaveAddr;
+	uint8_t		NumRegs;
+	uint8_t		Sec, Min, Hour, Day, Date, Month, Year;
+	uint8_t		FirstDay;				/* day of week of the first day, 1 (DS1307/DS3231) or 0 (PCF8563) */
+	uint8_t		FlagReg;				/* register with write-0-to-clear flags, 0xFF -> none */
+	uint8_t		FlagMask;
+	uint8_t		Mask[SIM_RTC_MAX_REGS];	/* bits which can be written */
+}Sim_RTCLayout_t;
+
+static const Sim_RTCLayout_t ds1307Layout =
+{
+	.SlaveAddr = 0x68, .NumRegs = 64,
+	.Sec = 0, .Min = 1, .Hour = 2, .Day = 3, .Date = 4, .Month = 5, .Year = 6, .FirstDay = 1,
+	.FlagReg = 0xFF, .FlagMask = 0,
+	.Mask = { 0xFF, 0x7F, 0x7F, 0x07, 0x3F, 0x1F, 0xFF, 0x93,
+			  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+};
+
+/*
+ * 0Fh: OSF, A2F, A1F are write-0-to-clear, BSY is read only. 11h-12h temperature is read only
+ */
+static const Sim_RTCLayout_t ds3231Layout =
+{
+	.SlaveAddr = 0x68, .NumRegs = 0x13,
+	.Sec = 0, .Min = 1, .Hour = 2, .Day = 3, .Date = 4, .Month = 5, .Year = 6, .FirstDay = 1,
+	.FlagReg = 0x0F, .FlagMask = 0x83,
+	.Mask = { 0x7F, 0x7F, 0x7F, 0x07, 0x3F, 0x9F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			  0xFF, 0x08, 0xFF, 0x00, 0x00 },
+};
+
+/*
+ * 01h: AF and TF are write-0-to-clear
+ */
+static const Sim_RTCLayout_t pcf8563Layout =
+{
+	.SlaveAddr = 0x51, .NumRegs = 0x10,
+	.Sec = 2, .Min = 3, .Hour = 4, .Day = 6, .Date = 5, .Month = 7, .Year = 8, .FirstDay = 0,
+	.FlagReg = 0x01, .FlagMask = 0x0C,
+	.Mask = { 0xA8, 0x13, 0xFF, 0x7F, 0x3F, 0x3F, 0x07, 0x9F, 0xFF, 0xFF, 0xBF, 0xBF, 0x87, 0x83,
+			  0x83, 0xFF },
+};
+
+/*
+ * calendar in binary while the part is ticked
+ */
+typedef struct
+{
+	uint32_t	Sec, Min, Hour, Day, Date, Month, Year;
+}Sim_RTCTime_t;
+
+static const Sim_RTCLayout_t* Sim_RTCGetLayout(Sim_RTC_t *pRtc)
+{
+	switch(pRtc->Type)
+	{
+	case SIM_RTC_DS1307:	return &ds1307Layout;
+	case SIM_RTC_DS3231:	return &ds3231Layout;
+	default:				return &pcf8563Layout;
+	}
+}
+
+static uint8_t Sim_BCDtoBin(uint8_t bcd)
+{
+	return (uint8_t)((bcd >> 4) * 10 + (bcd & 0x0F));
+}
+
+static uint8_t Sim_BintoBCD(uint8_t bin)
+{
+	return (uint8_t)(((bin / 10) << 4) | (bin % 10));
+}
+
+static uint8_t Sim_DaysInMonth(uint32_t month, uint32_t year)
+{
+	static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	if(month == 2 && (year % 4) == 0)
+		return 29;
+	return days[(month - 1) % 12];
+}
+
+/*
+ * the part latches the time registers at START of a read
+ */
+static void Sim_RTCStart(Sim_I2CDevice_t *pDev, uint8_t Read)
+{
+	Sim_RTC_t *pRtc = (Sim_RTC_t*)pDev;
+
+	pRtc->PointerNext = !Read;
+	if(Read)
+		memcpy(pRtc->Latch, pRtc->Regs, sizeof(pRtc->Latch));
+}
+
+static uint8_t Sim_RTCWrite(Sim_I2CDevice_t *pDev, uint8_t Data)
+{
+	Sim_RTC_t *pRtc = (Sim_RTC_t*)pDev;
+	const Sim_RTCLayout_t *pLayout = Sim_RTCGetLayout(pRtc);
+	uint8_t reg = pRtc->Pointer;
+	uint8_t mask = pLayout->Mask[reg];
+
+	if(pRtc->PointerNext)
+	{
+		pRtc->PointerNext = 0;
+		if(Data >= pRtc->NumRegs)
+			return 0;
+		pRtc->Pointer = Data;
+		return 1;
+	}
+
+	if(reg == pLayout->FlagReg)
+	{
+		// writing 1 to a flag leaves it as it is
+		pRtc->Regs[reg] = (pRtc->Regs[reg] & ~(mask | pLayout->FlagMask)) | (Data & mask) |
+						  (pRtc->Regs[reg] & Data & pLayout->FlagMask);
+	}
+	else
+	{
+		pRtc->Regs[reg] = (pRtc->Regs[reg] & ~mask) | (Data & mask);
+	}
+
+	pRtc->Writes++;
+	pRtc->Pointer = (uint8_t)((reg + 1) % pRtc->NumRegs);
+
+	return 1;
+}
+
+static uint8_t Sim_RTCRead(Sim_I2CDevice_t *pDev)
+{
+	Sim_RTC_t *pRtc = (Sim_RTC_t*)pDev;
+	uint8_t value = pRtc->Latch[pRtc->Pointer];
+
+	pRtc->Reads++;
+	pRtc->Pointer = (uint8_t)((pRtc->Pointer + 1) % pRtc->NumRegs);
+
+	return value;
+}
+
+static void Sim_RTCDecode(Sim_RTC_t *pRtc, const Sim_RTCLayout_t *pLayout, Sim_RTCTime_t *pTime)
+{
+	uint8_t *pRegs = pRtc->Regs;
+	uint8_t hourReg = pRegs[pLayout->Hour];
+
+	pTime->Sec = Sim_BCDtoBin(pRegs[pLayout->Sec] & 0x7F);
+	pTime->Min = Sim_BCDtoBin(pRegs[pLayout->Min] & 0x7F);
+	if(hourReg & 0x40)
+		pTime->Hour = Sim_BCDtoBin(hourReg & 0x1F) % 12 + ((hourReg & 0x20) ? 12 : 0);
+	else
+		pTime->Hour = Sim_BCDtoBin(hourReg & 0x3F);
+	pTime->Day = pRegs[pLayout->Day] & 0x07;
+	pTime->Date = Sim_BCDtoBin(pRegs[pLayout->Date] & 0x3F);
+	pTime->Month = Sim_BCDtoBin(pRegs[pLayout->Month] & 0x1F);
+	pTime->Year = Sim_BCDtoBin(pRegs[pLayout->Year]);
+}
+
+/*
+ * flag bits (CH, VL, century) and the 12/24 hour mode are kept
+ */
+static void Sim_RTCEncode(Sim_RTC_t *pRtc, const Sim_RTCLayout_t *pLayout, const Sim_RTCTime_t *pTime)
+{
+	uint8_t *pRegs = pRtc->Regs;
+	uint8_t hour12 = (uint8_t)((pTime->Hour % 12) ? (pTime->Hour % 12) : 12);
+
+	pRegs[pLayout->Sec] = (pRegs[pLayout->Sec] & 0x80) | Sim_BintoBCD((uint8_t)pTime->Sec);
+	pRegs[pLayout->Min] = Sim_BintoBCD((uint8_t)pTime->Min);
+	if(pRegs[pLayout->Hour] & 0x40)
+		pRegs[pLayout->Hour] = 0x40 | ((pTime->Hour >= 12) ? 0x20 : 0) | Sim_BintoBCD(hour12);
+	else
+		pRegs[pLayout->Hour] = Sim_BintoBCD((uint8_t)pTime->Hour);
+	pRegs[pLayout->Day] = (uint8_t)pTime->Day;
+	pRegs[pLayout->Date] = Sim_BintoBCD((uint8_t)pTime->Date);
+	pRegs[pLayout->Month] = (pRegs[pLayout->Month] & 0x80) | Sim_BintoBCD((uint8_t)pTime->Month);
+	pRegs[pLayout->Year] = Sim_BintoBCD((uint8_t)pTime->Year);
+}
+
+/*
+ * one alarm field: masked, or equal to the current value (hours in the 02h layout)
+ */
+static uint8_t Sim_RTCFieldMatch(uint8_t reg, uint8_t maskBit, uint32_t value, uint8_t isHour)
+{
+	uint32_t alarm;
+
+	if(reg & maskBit)
+		return 1;
+	if(isHour && (reg & 0x40))
+		alarm = Sim_BCDtoBin(reg & 0x1F) % 12 + ((reg & 0x20) ? 12 : 0);
+	else
+		alarm = Sim_BCDtoBin(reg & 0x3F);
+	return alarm == value;
+}
+
+static void Sim_RTCCheckAlarms(Sim_RTC_t *pRtc, const Sim_RTCTime_t *pTime)
+{
+	uint8_t *pRegs = pRtc->Regs;
+
+	if(pRtc->Type == SIM_RTC_DS3231)
+	{
+		// DY/DT (bit 6) selects the day of week instead of the date
+		uint32_t a1Day = (pRegs[0x0A] & 0x40) ? pTime->Day : pTime->Date;
+		uint32_t a2Day = (pRegs[0x0D] & 0x40) ? pTime->Day : pTime->Date;
+
+		if(Sim_RTCFieldMatch(pRegs[0x07], 0x80, pTime->Sec, 0) && Sim_RTCFieldMatch(pRegs[0x08], 0x80, pTime->Min, 0) &&
+		   Sim_RTCFieldMatch(pRegs[0x09], 0x80, pTime->Hour, 1) && Sim_RTCFieldMatch(pRegs[0x0A] & ~0x40, 0x80, a1Day, 0))
+			pRegs[0x0F] |= 0x01;
+
+		if(pTime->Sec == 0 && Sim_RTCFieldMatch(pRegs[0x0B], 0x80, pTime->Min, 0) &&
+		   Sim_RTCFieldMatch(pRegs[0x0C], 0x80, pTime->Hour, 1) && Sim_RTCFieldMatch(pRegs[0x0D] & ~0x40, 0x80, a2Day, 0))
+			pRegs[0x0F] |= 0x02;
+	}
+	else if(pRtc->Type == SIM_RTC_PCF8563)
+	{
+		// AE (bit 7) = 1 leaves a field out, an alarm with every field left out never fires
+		if(pTime->Sec == 0 && ((pRegs[0x09] & pRegs[0x0A] & pRegs[0x0B] & pRegs[0x0C] & 0x80) == 0) &&
+		   Sim_RTCFieldMatch(pRegs[0x09], 0x80, pTime->Min, 0) && Sim_RTCFieldMatch(pRegs[0x0A], 0x80, pTime->Hour, 0) &&
+		   Sim_RTCFieldMatch(pRegs[0x0B], 0x80, pTime->Date, 0) && Sim_RTCFieldMatch(pRegs[0x0C], 0x80, pTime->Day, 0))
+			pRegs[0x01] |= 0x08;
+	}
+}
+
+/*
+ * first application of power: no battery kept the part, the RAM and alarms hold noise
+ */
+void Sim_RTCPowerOn(Sim_RTC_t *pRtc, uint8_t Type, uint32_t Seed)
+{
+	const Sim_RTCLayout_t *pLayout;
+
+	memset(pRtc, 0, sizeof(*pRtc));
+	pRtc->Type = Type;
+	pLayout = Sim_RTCGetLayout(pRtc);
+
+	pRtc->NumRegs = pLayout->NumRegs;
+	pRtc->Dev.SlaveAddr = pLayout->SlaveAddr;
+	pRtc->Dev.pfnStart = Sim_RTCStart;
+	pRtc->Dev.pfnWrite = Sim_RTCWrite;
+	pRtc->Dev.pfnRead = Sim_RTCRead;
+
+	for(uint32_t i = 0; i < pRtc->NumRegs; i++)
+	{
+		Seed = Seed * 1103515245 + 12345;
+		pRtc->Regs[i] = (uint8_t)(Seed >> 16) & pLayout->Mask[i];
+	}
+
+	switch(Type)
+	{
+	case SIM_RTC_DS1307:
+		// 01/01/00 01 00:00:00, CH set, SQW output off with RS1 RS0 = 11
+		memset(pRtc->Regs, 0, 8);
+		pRtc->Regs[0] = 0x80;
+		pRtc->Regs[3] = 0x01;
+		pRtc->Regs[4] = 0x01;
+		pRtc->Regs[5] = 0x01;
+		pRtc->Regs[7] = 0x03;
+		break;
+	case SIM_RTC_DS3231:
+		// 01/01/00 01 00:00:00, INTCN and RS2:1 set, OSF and EN32kHz set, 25.00C
+		memset(pRtc->Regs, 0, 7);
+		pRtc->Regs[3] = 0x01;
+		pRtc->Regs[4] = 0x01;
+		pRtc->Regs[5] = 0x01;
+		pRtc->Regs[0x0E] = 0x1C;
+		pRtc->Regs[0x0F] = 0x88;
+		pRtc->Regs[0x10] = 0x00;
+		Sim_RTCSetTemperature(pRtc, 25 * 4);
+		break;
+	default:
+		// the time is undefined, VL set. TESTC set, CLKOUT on at 32768Hz
+		pRtc->Regs[0x00] = 0x08;
+		pRtc->Regs[0x01] = 0x00;
+		pRtc->Regs[0x0D] = 0x80;
+		pRtc->Regs[0x0E] = 0x03;
+		// keep the noise a valid calendar
+		pRtc->Regs[0x02] = 0x80 | Sim_BintoBCD(Sim_BCDtoBin(pRtc->Regs[0x02] & 0x7F) % 60);
+		pRtc->Regs[0x03] = Sim_BintoBCD(Sim_BCDtoBin(pRtc->Regs[0x03]) % 60);
+		pRtc->Regs[0x04] = Sim_BintoBCD(Sim_BCDtoBin(pRtc->Regs[0x04]) % 24);
+		pRtc->Regs[0x05] = Sim_BintoBCD(Sim_BCDtoBin(pRtc->Regs[0x05]) % 28 + 1);
+		pRtc->Regs[0x07] = Sim_BintoBCD(Sim_BCDtoBin(pRtc->Regs[0x07] & 0x1F) % 12 + 1);
+		pRtc->Regs[0x08] = Sim_BintoBCD(Sim_BCDtoBin(pRtc->Regs[0x08]) % 100);
+		break;
+	}
+}
+
+/*
+ * DS1307 CH, PCF8563 STOP. OscFail is a dead crystal (or a stop on battery) on any part
+ */
+uint8_t Sim_RTCIsRunning(Sim_RTC_t *pRtc)
+{
+	if(pRtc->OscFail)
+		return 0;
+
+	switch(pRtc->Type)
+	{
+	case SIM_RTC_DS1307:	return !(pRtc->Regs[0] & 0x80);
+	case SIM_RTC_DS3231:	return 1;
+	default:				return !(pRtc->Regs[0] & 0x20);
+	}
+}
+
+/*
+ * the crystal stops (or starts again). The DS3231 sets OSF, the PCF8563 sets VL
+ */
+void Sim_RTCOscFail(Sim_RTC_t *pRtc, uint8_t Fail)
+{
+	pRtc->OscFail = Fail;
+	if(!Fail)
+		return;
+
+	if(pRtc->Type == SIM_RTC_DS3231)
+		pRtc->Regs[0x0F] |= 0x80;
+	else if(pRtc->Type == SIM_RTC_PCF8563)
+		pRtc->Regs[0x02] |= 0x80;
+}
+
+/*
+ * advances the calendar by Seconds if the oscillator runs, alarms are matched every second
+ */
+void Sim_RTCTick(Sim_RTC_t *pRtc, uint32_t Seconds)
+{
+	const Sim_RTCLayout_t *pLayout = Sim_RTCGetLayout(pRtc);
+	Sim_RTCTime_t time;
+
+	if(!Sim_RTCIsRunning(pRtc))
+		return;
+
+	Sim_RTCDecode(pRtc, pLayout, &time);
+
+	while(Seconds--)
+	{
+		if(++time.Sec == 60)
+		{
+			time.Sec = 0;
+			if(++time.Min == 60)
+			{
+				time.Min = 0;
+				if(++time.Hour == 24)
+				{
+					time.Hour = 0;
+					time.Day = (time.Day + 1 - pLayout->FirstDay) % 7 + pLayout->FirstDay;
+					if(++time.Date > Sim_DaysInMonth(time.Month, time.Year))
+					{
+						time.Date = 1;
+						if(++time.Month > 12)
+						{
+							time.Month = 1;
+							time.Year = (time.Year + 1) % 100;
+						}
+					}
+				}
+			}
+		}
+
+		Sim_RTCCheckAlarms(pRtc, &time);
+	}
+
+	Sim_RTCEncode(pRtc, pLayout, &time);
+}
+
+/*
+ * sets the calendar behind the firmware's back (24 hour mode), the flag bits are kept
+ */
+void Sim_RTCSetTime(Sim_RTC_t *pRtc, uint8_t Hours, uint8_t Minutes, uint8_t Seconds)
+{
+	const Sim_RTCLayout_t *pLayout = Sim_RTCGetLayout(pRtc);
+
+	pRtc->Regs[pLayout->Sec] = (pRtc->Regs[pLayout->Sec] & 0x80) | Sim_BintoBCD(Seconds);
+	pRtc->Regs[pLayout->Min] = Sim_BintoBCD(Minutes);
+	pRtc->Regs[pLayout->Hour] = Sim_BintoBCD(Hours);
+}
+
+void Sim_RTCSetDate(Sim_RTC_t *pRtc, uint8_t Date, uint8_t Month, uint8_t Year)
+{
+	const Sim_RTCLayout_t *pLayout = Sim_RTCGetLayout(pRtc);
+
+	pRtc->Regs[pLayout->Date] = Sim_BintoBCD(Date);
+	pRtc->Regs[pLayout->Month] = (pRtc->Regs[pLayout->Month] & 0x80) | Sim_BintoBCD(Month);
+	pRtc->Regs[pLayout->Year] = Sim_BintoBCD(Year);
+}
+
+/*
+ * DS3231 temperature registers, 0.25C steps
+ */
+void Sim_RTCSetTemperature(Sim_RTC_t *pRtc, int16_t QuarterDegC)
+{
+	if(pRtc->Type != SIM_RTC_DS3231)
+		return;
+
+	// two's complement 10 bit value, MSB integer part, LSB bits 7:6 quarters
+	pRtc->Regs[0x11] = (uint8_t)((uint16_t)QuarterDegC >> 2);
+	pRtc->Regs[0x12] = (uint8_t)((QuarterDegC & 3) << 6);
+}
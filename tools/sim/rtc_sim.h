@@ -0,0 +1,62 @@
+/*
+ * rtc_sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Simulated I2C RTC parts for the simulated bus (i2c_sim.h)
+ *
+ * 	- Register file with the auto incrementing register pointer of the part. The first byte of a write
+ * 	  transfer sets the pointer, reads and writes then advance it and wrap at the end of the map
+ * 	- Bits which always read 0 are masked on write, the time registers are latched at START of a read
+ * 	  transfer as the parts do, so a burst read can not tear
+ * 	- Writing 1 to a write-0-to-clear flag (DS3231 OSF/A2F/A1F, PCF8563 AF/TF) leaves it unchanged
+ * 	- Sim_RTCTick() advances the calendar second by second when the oscillator runs and matches the
+ * 	  alarms of the part (DS3231 alarm 1 and 2 with their mask bits, PCF8563 with AE)
+ * 	- Sim_RTCPowerOn() is the first application of power (DS1307 CH, DS3231 OSF, PCF8563 VL, random
+ * 	  RAM and alarms). A power cycle on battery keeps everything, so it needs no call at all.
+ * 	  Sim_RTCOscFail() stops the crystal, the part raises its flag
+ * 	- Reads and Writes count register bytes moved over the bus
+ */
+
+#ifndef RTC_SIM_H_
+#define RTC_SIM_H_
+
+#include "i2c_sim.h"
+
+#define SIM_RTC_DS1307					1
+#define SIM_RTC_DS3231					2
+#define SIM_RTC_PCF8563					3
+
+#define SIM_RTC_MAX_REGS				64
+
+typedef struct
+{
+	Sim_I2CDevice_t		Dev;					/* must be first */
+	uint8_t				Type;					/* SIM_RTC_xxx */
+	uint8_t				NumRegs;
+	uint8_t				Regs[SIM_RTC_MAX_REGS];
+	uint8_t				Latch[SIM_RTC_MAX_REGS];
+	uint8_t				Pointer;
+	uint8_t				PointerNext;			/* 1 -> the next byte written is the register pointer */
+	uint8_t				OscFail;				/* 1 -> the crystal does not run */
+	uint32_t			Reads;
+	uint32_t			Writes;
+}Sim_RTC_t;
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_RTCPowerOn(Sim_RTC_t *pRtc, uint8_t Type, uint32_t Seed);
+void Sim_RTCTick(Sim_RTC_t *pRtc, uint32_t Seconds);
+uint8_t Sim_RTCIsRunning(Sim_RTC_t *pRtc);
+void Sim_RTCSetTime(Sim_RTC_t *pRtc, uint8_t Hours, uint8_t Minutes, uint8_t Seconds);
+void Sim_RTCSetDate(Sim_RTC_t *pRtc, uint8_t Date, uint8_t Month, uint8_t Year);
+void Sim_RTCSetTemperature(Sim_RTC_t *pRtc, int16_t QuarterDegC);
+void Sim_RTCOscFail(Sim_RTC_t *pRtc, uint8_t Fail);
+
+#endif /* RTC_SIM_H_ */
@@ -0,0 +1,351 @@
+/*
+ * sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host simulation of the STM32F407 memory map (see sim.h)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "sim.h"
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "the simulated memory map needs Linux on x86-64 (page faults and the trap flag)"
+#endif
+
+#define SIM_PAGE_SIZE					4096UL
+#define SIM_EFLAGS_TF					0x100
+#define SIM_PF_WRITE					0x2
+#define SIM_MAX_PENDING					4
+
+typedef struct
+{
+	const char	*pName;
+	uint32_t	Base;
+	uint32_t	Size;
+	uint8_t		Fill;				/* reset content, flash is erased */
+	uint8_t		*pShadow;
+}Sim_Region_t;
+
+typedef struct
+{
+	uint32_t		Base;
+	uint32_t		Size;
+	Sim_ReadHook_t	pfnRead;
+	Sim_WriteHook_t	pfnWrite;
+	void			*pContext;
+}Sim_Model_t;
+
+typedef struct
+{
+	uintptr_t		Page;
+	Sim_Model_t		*pModel;		/* NULL for a read or an address no model covers */
+	uint32_t		Offset;
+	uint32_t		OldValue[2];	/* the word written and the next one (unaligned and 8 byte stores) */
+}Sim_Pending_t;
+
+static Sim_Region_t regions[] = {
+	{ "FLASH", 0x08000000, SIM_FLASH_SIZE, 0xFF, NULL },
+	{ "CCM",   0x10000000,   64 * 1024,    0x00, NULL },
+	{ "SRAM",  0x20000000,  128 * 1024,    0x00, NULL },
+	{ "APB/AHB1", 0x40000000, 0x80000,     0x00, NULL },
+	{ "AHB2",  0x50000000,   0x61000,      0x00, NULL },
+	{ "PPB",   0xE0000000,  0x100000,      0x00, NULL },
+};
+
+#define NUM_REGIONS		(sizeof(regions) / sizeof(regions[0]))
+
+static Sim_Model_t models[SIM_MAX_MODELS];
+static uint32_t noOfModels;
+static Sim_Pending_t pending[SIM_MAX_PENDING];
+static uint32_t noOfPending;
+static uint32_t checks, failures;
+
+sigjmp_buf Sim_PowerJmp;
+
+static Sim_Region_t* Sim_FindRegion(uintptr_t addr)
+{
+	for(size_t i = 0; i < NUM_REGIONS; i++)
+	{
+		if(addr >= regions[i].Base && addr - regions[i].Base < regions[i].Size)
+			return &regions[i];
+	}
+	return NULL;
+}
+
+static Sim_Model_t* Sim_FindModel(uintptr_t addr)
+{
+	for(uint32_t i = 0; i < noOfModels; i++)
+	{
+		if(addr >= models[i].Base && addr - models[i].Base < models[i].Size)
+			return &models[i];
+	}
+	return NULL;
+}
+
+static uint32_t* Sim_ShadowWord(uintptr_t addr)
+{
+	Sim_Region_t *pRegion = Sim_FindRegion(addr);
+
+	if(pRegion == NULL || addr - pRegion->Base + 4 > pRegion->Size)
+		return NULL;
+	return (uint32_t*)(pRegion->pShadow + (addr - pRegion->Base));
+}
+
+static void Sim_Protect(uintptr_t page, int prot)
+{
+	if(mprotect((void*)page, SIM_PAGE_SIZE, prot) != 0)
+	{
+		perror("sim: mprotect");
+		abort();
+	}
+}
+
+/*
+ * pages of models without a read hook only trap writes, reads go straight to the memory
+ */
+static int Sim_PageProt(uintptr_t page)
+{
+	for(uint32_t i = 0; i < noOfModels; i++)
+	{
+		if(models[i].pfnRead != NULL && page < (uintptr_t)models[i].Base + models[i].Size &&
+		   page + SIM_PAGE_SIZE > models[i].Base)
+			return PROT_NONE;
+	}
+	return PROT_READ;
+}
+
+static void Sim_ClosePending(void)
+{
+	for(uint32_t i = 0; i < noOfPending; i++)
+		Sim_Protect(pending[i].Page, Sim_PageProt(pending[i].Page));
+	noOfPending = 0;
+}
+
+/*
+ * fault on a modeled page: run the read hook (or snapshot for the write hook), open the page and
+ * single step the faulting instruction
+ */
+static void Sim_SegvHandler(int sig, siginfo_t *pInfo, void *pUcontext)
+{
+	ucontext_t *pCtx = (ucontext_t*)pUcontext;
+	uintptr_t addr = (uintptr_t)pInfo->si_addr;
+	Sim_Pending_t *pPending;
+	Sim_Model_t *pModel;
+	uint32_t *pWord;
+	(void)sig;
+
+	if(Sim_FindRegion(addr) == NULL || noOfPending == SIM_MAX_PENDING)
+	{
+		// a real crash
+		signal(SIGSEGV, SIG_DFL);
+		return;
+	}
+
+	pModel = Sim_FindModel(addr);
+	pPending = &pending[noOfPending++];
+	pPending->Page = addr & ~(SIM_PAGE_SIZE - 1);
+	pPending->pModel = NULL;
+
+	if(pModel != NULL)
+	{
+		pPending->Offset = (uint32_t)(addr - pModel->Base) & ~3U;
+		if(pCtx->uc_mcontext.gregs[REG_ERR] & SIM_PF_WRITE)
+		{
+			pWord = Sim_ShadowWord(pModel->Base + pPending->Offset);
+			pPending->pModel = pModel;
+			pPending->OldValue[0] = pWord[0];
+			pPending->OldValue[1] = (pPending->Offset + 4 < pModel->Size) ? pWord[1] : 0;
+		}
+		else if(pModel->pfnRead != NULL)
+		{
+			pModel->pfnRead(pModel->pContext, pPending->Offset);
+		}
+	}
+
+	Sim_Protect(pPending->Page, PROT_READ | PROT_WRITE);
+	pCtx->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+}
+
+/*
+ * the instruction completed: close the pages again and report the writes
+ */
+static void Sim_TrapHandler(int sig, siginfo_t *pInfo, void *pUcontext)
+{
+	ucontext_t *pCtx = (ucontext_t*)pUcontext;
+	Sim_Pending_t done[SIM_MAX_PENDING];
+	uint32_t noOfDone = noOfPending;
+	(void)sig;
+	(void)pInfo;
+
+	pCtx->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+	memcpy(done, pending, sizeof(done));
+	Sim_ClosePending();
+
+	for(uint32_t i = 0; i < noOfDone; i++)
+	{
+		Sim_Model_t *pModel = done[i].pModel;
+		uint8_t nextWritten;
+
+		if(pModel == NULL || pModel->pfnWrite == NULL)
+			continue;
+
+		// decided before the first hook runs, the model may change the next word itself
+		nextWritten = (done[i].Offset + 4 < pModel->Size) &&
+					  (Sim_ShadowWord(pModel->Base + done[i].Offset)[1] != done[i].OldValue[1]);
+
+		pModel->pfnWrite(pModel->pContext, done[i].Offset, done[i].OldValue[0]);
+		if(nextWritten)
+			pModel->pfnWrite(pModel->pContext, done[i].Offset + 4, done[i].OldValue[1]);
+	}
+}
+
+/*
+ * maps every region (once) and installs the fault handlers
+ */
+void Sim_Init(void)
+{
+	static uint8_t initDone;
+	struct sigaction sa;
+
+	if(initDone)
+		return;
+
+	for(size_t i = 0; i < NUM_REGIONS; i++)
+	{
+		int fd = memfd_create(regions[i].pName, 0);
+		void *pFixed;
+
+		if(fd < 0 || ftruncate(fd, regions[i].Size) != 0)
+		{
+			perror("sim: memfd");
+			exit(2);
+		}
+
+		pFixed = mmap((void*)(uintptr_t)regions[i].Base, regions[i].Size, PROT_READ | PROT_WRITE,
+					  MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+		regions[i].pShadow = mmap(NULL, regions[i].Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+
+		if(pFixed != (void*)(uintptr_t)regions[i].Base || regions[i].pShadow == MAP_FAILED)
+		{
+			fprintf(stderr, "sim: can not map %s at 0x%08x\n", regions[i].pName, regions[i].Base);
+			exit(2);
+		}
+	}
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+	sa.sa_sigaction = Sim_SegvHandler;
+	sigaction(SIGSEGV, &sa, NULL);
+	sa.sa_sigaction = Sim_TrapHandler;
+	sigaction(SIGTRAP, &sa, NULL);
+
+	initDone = 1;
+	Sim_Reset();
+}
+
+/*
+ * power on reset of the whole map: registers 0, RAM 0, flash erased, no models
+ */
+void Sim_Reset(void)
+{
+	Sim_Init();
+	Sim_ClosePending();
+
+	for(uint32_t i = 0; i < noOfModels; i++)
+	{
+		uintptr_t first = models[i].Base & ~(SIM_PAGE_SIZE - 1);
+		for(uintptr_t page = first; page < models[i].Base + models[i].Size; page += SIM_PAGE_SIZE)
+			Sim_Protect(page, PROT_READ | PROT_WRITE);
+	}
+	noOfModels = 0;
+
+	for(size_t i = 0; i < NUM_REGIONS; i++)
+		memset(regions[i].pShadow, regions[i].Fill, regions[i].Size);
+}
+
+/*
+ * attaches a peripheral model to [BaseAddr, BaseAddr + Size). Other addresses on the same pages
+ * trap too but behave as plain memory. Without a read hook only writes trap
+ */
+void Sim_AddModel(uint32_t BaseAddr, uint32_t Size, Sim_ReadHook_t pfnRead, Sim_WriteHook_t pfnWrite, void *pContext)
+{
+	Sim_Model_t *pModel;
+	uintptr_t first = BaseAddr & ~(SIM_PAGE_SIZE - 1);
+
+	Sim_Init();
+	if(noOfModels == SIM_MAX_MODELS || Sim_FindRegion(BaseAddr) == NULL)
+	{
+		fprintf(stderr, "sim: can not add a model at 0x%08x\n", BaseAddr);
+		exit(2);
+	}
+
+	pModel = &models[noOfModels++];
+	pModel->Base = BaseAddr;
+	pModel->Size = Size;
+	pModel->pfnRead = pfnRead;
+	pModel->pfnWrite = pfnWrite;
+	pModel->pContext = pContext;
+
+	for(uintptr_t page = first; page < (uintptr_t)BaseAddr + Size; page += SIM_PAGE_SIZE)
+		Sim_Protect(page, Sim_PageProt(page));
+}
+
+/*
+ * hook free view of a simulated address, for the test and the models
+ */
+void* Sim_Shadow(uint32_t Addr)
+{
+	Sim_Region_t *pRegion = Sim_FindRegion(Addr);
+
+	if(pRegion == NULL)
+	{
+		fprintf(stderr, "sim: 0x%08x is not simulated\n", Addr);
+		exit(2);
+	}
+	return pRegion->pShadow + (Addr - pRegion->Base);
+}
+
+/*
+ * called from a hook: the power goes away in the middle of the access
+ */
+void Sim_PowerFail(void)
+{
+	Sim_ClosePending();
+	siglongjmp(Sim_PowerJmp, 1);
+}
+
+void Sim_Check(int Cond, const char *pExpr, const char *pFile, int Line)
+{
+	checks++;
+	if(!Cond)
+	{
+		failures++;
+		printf("%s:%d: check failed: %s\n", pFile, Line, pExpr);
+	}
+}
+
+uint32_t Sim_Failures(void)
+{
+	return failures;
+}
+
+/*
+ * prints the verdict, returns the exit code
+ */
+int Sim_Report(const char *pName)
+{
+	printf("%s: %u checks, %u failed\n%s\n", pName, checks, failures, failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host simulation of the STM32F407 memory map, for running the firmware sources unmodified on a
+ * Linux x86-64 host (the host tests under tools/ link it)
+ *
+ * 	- Sim_Init() maps flash, CCM RAM, SRAM, the peripherals and the Cortex-M private peripheral bus
+ * 	  at their real addresses, so the register macros of stm32f407xx.h work as they are. Every region
+ * 	  is a memfd mapped twice: at the fixed address for the firmware, and at a shadow address for the
+ * 	  test and the device models (Sim_Shadow), whose accesses never trap
+ * 	- Plain memory is enough for most registers. A peripheral which has to react to accesses
+ * 	  (status flags, write-1-to-clear, write protection, flash programming) gets a model with
+ * 	  Sim_AddModel(). Its pages are made no access. A firmware access faults, the read hook runs
+ * 	  before the instruction, the instruction is single stepped (TF) with the page opened, and the
+ * 	  write hook runs after it with the old value. Hooks see 32 bit words at word aligned offsets
+ * 	- Models keep their registers current in the shadow memory. A read hook is only for values which
+ * 	  depend on time or for read side effects (e.g. SR1 then SR2 clearing ADDR). The pages of a model
+ * 	  without one stay readable and only writes trap (flash is read at full speed)
+ * 	- Sim_PowerFail() from a hook abandons the running firmware code and returns to the last
+ * 	  SIM_POWER_CYCLE() with 1 (torn writes, brown outs). Register and memory contents stay as they are
+ * 	- The intrinsics are no-ops on the host (stm32f407xx.h), __DISABLE_IRQ does not stop anything.
+ * 	  ISRs are simulated by calling the handlers from the test
+ * 	- Build the tests with -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc (not -I, Inc/sched.h
+ * 	  would shadow the system <sched.h>)
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <setjmp.h>
+
+#define SIM_MAX_MODELS					16
+#define SIM_FLASH_SIZE					(1024 * 1024)		/* The whole part, sectors 10 and 11 included */
+
+/*
+ * Model hooks. Offset is the word aligned byte offset from the model base address
+ */
+typedef void (*Sim_ReadHook_t)(void *pContext, uint32_t Offset);
+typedef void (*Sim_WriteHook_t)(void *pContext, uint32_t Offset, uint32_t OldValue);
+
+/*
+ * Power cycle point. Returns 0 when called, 1 when a model called Sim_PowerFail()
+ */
+extern sigjmp_buf Sim_PowerJmp;
+#define SIM_POWER_CYCLE()				sigsetjmp(Sim_PowerJmp, 1)
+
+
+/**************************************************************************************************************************************
+ * 														APIs supported by this module
+ * 									For more information about the APIs check the function definitions
+ **************************************************************************************************************************************/
+void Sim_Init(void);
+void Sim_Reset(void);
+void Sim_AddModel(uint32_t BaseAddr, uint32_t Size, Sim_ReadHook_t pfnRead, Sim_WriteHook_t pfnWrite, void *pContext);
+void* Sim_Shadow(uint32_t Addr);
+void Sim_PowerFail(void);
+
+/*
+ * Test reporting
+ */
+void Sim_Check(int Cond, const char *pExpr, const char *pFile, int Line);
+uint32_t Sim_Failures(void);
+int Sim_Report(const char *pName);
+
+#define SIM_CHECK(cond)					Sim_Check((cond), #cond, __FILE__, __LINE__)
+#define SIM_REG(addr)					(*(volatile uint32_t*)Sim_Shadow((uint32_t)(uintptr_t)(addr)))
+
+#endif /* SIM_H_ */
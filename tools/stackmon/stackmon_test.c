@@ -0,0 +1,143 @@
+/*
+ * stackmon_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the stack monitor (Inc/stackmon.h) on the simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o stackmon_test stackmon_test.c
+ * 			   ../sim/sim.c ../../Src/stackmon.c ../../Src/mempool.c
+ * Usage:	stackmon_test
+ *
+ * The stack sits where the linker script puts it, at the top of CCM RAM. Checks the MPU guard
+ * registers, that a write below the stack bottom hits the guard, the incremental scan and the
+ * stack and heap high-water marks. Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "stackmon.h"
+#include "mempool.h"
+
+#define ST_STACK_TOP			(CCMRAM_BASEADDR + CCMRAM_SIZE)
+#define ST_STACK_WORDS			512			/* _Min_Stack_Size 0x800 */
+
+static StackMon_Handle_t stackMon;
+static uint32_t guardHits;
+
+/*
+ * MPU model: the guard region configured in MPU_RBAR/MPU_RASR is no access. A hit is a HardFault,
+ * the faulting code is abandoned
+ */
+static void ST_GuardHit(void *pContext, uint32_t Offset)
+{
+	(void)pContext;
+	(void)Offset;
+	guardHits++;
+	Sim_PowerFail();
+}
+
+static void ST_GuardWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	(void)OldValue;
+	ST_GuardHit(pContext, Offset);
+}
+
+/*
+ * scans until a pass completes, returns the number of calls
+ */
+static uint32_t ST_ScanPass(uint32_t maxWords)
+{
+	uint32_t calls = 1;
+
+	while(!StackMon_Scan(&stackMon, maxWords))
+		calls++;
+	return calls;
+}
+
+int main(void)
+{
+	uint32_t *pTop = (uint32_t*)(uintptr_t)ST_STACK_TOP;
+	uint32_t *pBottom = pTop - ST_STACK_WORDS;
+	__vo uint32_t *pBelow = pBottom - 1;
+	uint32_t rasr, guardBase, guardSize;
+	void *pBlocks[3];
+
+	Sim_Init();
+
+	stackMon.StackMon_Config.pBottom = pBottom;
+	stackMon.StackMon_Config.pTop = pTop;
+	stackMon.StackMon_Config.Guard = ENABLE;
+	StackMon_Paint(&stackMon);
+	StackMon_Init(&stackMon);
+
+	// guard registers: region 7, aligned to its size, right below the stack, no access, never execute
+	rasr = SIM_REG(MPU_RASR);
+	guardBase = SIM_REG(MPU_RBAR);
+	guardSize = 2UL << ((rasr >> MPU_RASR_SIZE) & 0x1F);
+	SIM_CHECK(SIM_REG(MPU_RNR) == STACKMON_GUARD_REGION);
+	SIM_CHECK(guardSize == STACKMON_GUARD_SIZE);
+	SIM_CHECK((guardBase & (guardSize - 1)) == 0);
+	SIM_CHECK(guardBase + guardSize == (uint32_t)(uintptr_t)pBottom);
+	SIM_CHECK(((rasr >> MPU_RASR_AP) & 7) == 0);
+	SIM_CHECK(rasr & (1 << MPU_RASR_XN));
+	SIM_CHECK(rasr & (1 << MPU_RASR_ENABLE));
+	SIM_CHECK(SIM_REG(MPU_CTRL) == ((1 << MPU_CTRL_PRIVDEFENA) | (1 << MPU_CTRL_ENABLE)));
+
+	// an overflow by one word faults, the stack itself does not
+	Sim_AddModel(guardBase, guardSize, ST_GuardHit, ST_GuardWrite, NULL);
+	if(SIM_POWER_CYCLE() == 0)
+	{
+		pTop[-1] = STACKMON_PAINT;
+		*pBelow = 0;
+	}
+	SIM_CHECK(guardHits == 1);
+
+	// untouched stack: no mark, a pass is bounded by the stack size
+	SIM_CHECK(ST_ScanPass(16) == ST_STACK_WORDS / 16 + 1);
+	SIM_CHECK(StackMon_GetHighWater(&stackMon) == 0);
+	SIM_CHECK(StackMon_GetSize(&stackMon) == ST_STACK_WORDS * 4);
+
+	// 100 words deep
+	pTop[-100] = 0x12345678;
+	ST_ScanPass(16);
+	SIM_CHECK(StackMon_GetHighWater(&stackMon) == 100 * 4);
+
+	// shallower use does not move the mark, and a pass only covers the words below it
+	pTop[-50] = 0;
+	SIM_CHECK(ST_ScanPass(4) == (ST_STACK_WORDS - 100) / 4 + 1);
+	SIM_CHECK(StackMon_GetHighWater(&stackMon) == 100 * 4);
+
+	// deeper again, found in the middle of a pass
+	StackMon_Scan(&stackMon, 8);
+	pTop[-200] = 0;
+	ST_ScanPass(8);
+	SIM_CHECK(StackMon_GetHighWater(&stackMon) == 200 * 4);
+
+	// paint gone completely
+	pBottom[0] = 0;
+	ST_ScanPass(1);
+	SIM_CHECK(StackMon_GetHighWater(&stackMon) == StackMon_GetSize(&stackMon));
+
+	// repaint resets the mark
+	StackMon_Paint(&stackMon);
+	ST_ScanPass(64);
+	SIM_CHECK(StackMon_GetHighWater(&stackMon) == 0);
+
+	// heap: whole blocks, the mark survives the frees
+	Mempool_Init();
+	pBlocks[0] = Mempool_Alloc(10);
+	pBlocks[1] = Mempool_Alloc(100);
+	pBlocks[2] = Mempool_Alloc(1000);
+	SIM_CHECK(pBlocks[0] && pBlocks[1] && pBlocks[2]);
+	SIM_CHECK(Mempool_GetBytesInUse() == MEMPOOL_CLASS0_SIZE + MEMPOOL_CLASS3_SIZE + MEMPOOL_CLASS5_SIZE);
+	for(int i = 0; i < 3; i++)
+		Mempool_Free(pBlocks[i]);
+	SIM_CHECK(Mempool_GetBytesInUse() == 0);
+	SIM_CHECK(StackMon_GetHeapHighWater() == MEMPOOL_CLASS0_SIZE + MEMPOOL_CLASS3_SIZE + MEMPOOL_CLASS5_SIZE);
+
+	return Sim_Report("stackmon");
+}
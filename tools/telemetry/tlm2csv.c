@@ -0,0 +1,41 @@
+/*
+ * tlm2csv.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Converts a captured telemetry stream (USART or SWO capture) to CSV
+ *
+ * Build:	cc -O2 -o tlm2csv tlm2csv.c tlm_decode.c
+ * Usage:	tlm2csv < capture.bin > capture.csv
+ *
+ * Frame statistics are printed to stderr at the end
+ */
+
+#include "tlm_decode.h"
+
+static void PrintRecord(void *pCtx, const TLM_Record_t *pRecord)
+{
+	TLM_PrintCSV((FILE*)pCtx, pRecord);
+}
+
+int main(void)
+{
+	static TLM_Decoder_t decoder;
+	uint8_t buf[4096];
+	size_t len;
+
+	TLM_DecoderInit(&decoder, PrintRecord, stdout);
+	TLM_PrintCSVHeader(stdout);
+
+	while((len = fread(buf, 1, sizeof(buf), stdin)) > 0)
+		TLM_Feed(&decoder, buf, (uint32_t)len);
+
+	fprintf(stderr, "frames ok %u, bad crc %u, bad encoding %u, bad payload %u, lost %u\n",
+			decoder.framesOk, decoder.framesBadCRC, decoder.framesBadCOBS, decoder.framesBadPayload,
+			decoder.framesLost);
+
+	return 0;
+}
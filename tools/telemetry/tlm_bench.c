@@ -0,0 +1,238 @@
+/*
+ * tlm_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host benchmark of the telemetry stream (Inc/telemetry.h): encoding cost per frame and bytes per record,
+ * the frames decoded back with tlm_decode.c
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o tlm_bench tlm_bench.c tlm_decode.c
+ * 			   ../sim/sim.c ../../Src/telemetry.c ../../Src/crc.c ../../Src/syscalls.c ../../Src/xprintf.c
+ * 			   ../../Src/ringbuf.c ../../drivers/Src/stm32f407xx_usart.c ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	tlm_bench [records per run]
+ *
+ * 	- Timestamp runs through Telemetry_PutTimestamp() (Telemetry_PutRecord()): every second, every
+ * 	  APP_TELEMETRY_PERIOD of main.c, random small steps back and forth, and jumps which only fit the
+ * 	  longest varints. Each run is decoded and every timestamp has to come back
+ * 	- The other records main.c sends per snapshot: the I2C error counters, the residency and wake up
+ * 	  histograms, and a full TLM_REC_EVENTS batch
+ * 	- ns per frame to encode (CRC and COBS included, the sink only copies) and to decode, bytes per
+ * 	  record on the wire. Host times with the table CRC, for the relative cost of the records
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "telemetry.h"
+#include "tlm_decode.h"
+
+#define TB_RECORDS						100000
+#define TB_STREAM_SIZE					(64 * 1024 * 1024)
+#define TB_EPOCH						850000000UL			/* Some time in 2026 */
+
+#define TB_STEP_FIXED					0
+#define TB_STEP_RANDOM					1
+#define TB_STEP_JUMP					2
+
+typedef struct
+{
+	const char		*pName;
+	int32_t			Step;				/* Seconds between two timestamps */
+	uint8_t			Kind;				/* TB_STEP_FIXED, TB_STEP_RANDOM (+-Step) or TB_STEP_JUMP */
+}TB_Run_t;
+
+static const TB_Run_t runs[] =
+{
+	{ "1s",			1,		TB_STEP_FIXED },
+	{ "10s",		10,		TB_STEP_FIXED },
+	{ "+-60s",		60,		TB_STEP_RANDOM },
+	{ "jumps",		0,		TB_STEP_JUMP },
+};
+
+typedef struct
+{
+	uint8_t			*pData;
+	uint32_t		Len;
+}TB_Stream_t;
+
+static TB_Stream_t stream;
+static Telemetry_Handle_t tlm;
+static TLM_Decoder_t decoder;
+static uint32_t *pSent;
+static uint32_t noOfDecoded, decodedBad;
+static uint32_t seed = 26;
+
+static uint32_t TB_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint64_t TB_Nanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * the encoded frames end up in memory, as the ITM or USART sink would send them
+ */
+static void TB_Sink(void *pCtx, const uint8_t *pData, uint32_t len)
+{
+	TB_Stream_t *pStream = (TB_Stream_t*)pCtx;
+
+	if(pStream->Len + len > TB_STREAM_SIZE)
+		return;
+	memcpy(&pStream->pData[pStream->Len], pData, len);
+	pStream->Len += len;
+}
+
+static void TB_Record(void *pCtx, const TLM_Record_t *pRecord)
+{
+	(void)pCtx;
+
+	if(pRecord->type == TLM_REC_TIMESTAMP)
+		decodedBad += !pRecord->timestampValid || (pRecord->timestamp != pSent[noOfDecoded]);
+	noOfDecoded++;
+}
+
+static void TB_Start(void)
+{
+	stream.Len = 0;
+	noOfDecoded = 0;
+	decodedBad = 0;
+	Telemetry_Init(&tlm, TB_Sink, &stream);
+	TLM_DecoderInit(&decoder, TB_Record, NULL);
+}
+
+/*
+ * decodes the stream, returns ns per frame
+ */
+static double TB_Decode(uint32_t Frames)
+{
+	uint64_t t0 = TB_Nanos();
+
+	TLM_Feed(&decoder, stream.pData, stream.Len);
+	t0 = TB_Nanos() - t0;
+
+	SIM_CHECK(decoder.framesOk == Frames);
+	SIM_CHECK(decoder.framesBadCRC + decoder.framesBadCOBS + decoder.framesBadPayload + decoder.framesLost == 0);
+	SIM_CHECK(noOfDecoded == Frames);
+	return (double)t0 / Frames;
+}
+
+static void TB_Print(const char *pName, uint32_t Frames, double EncodeNs, double DecodeNs)
+{
+	printf("%-10s %8u %10.2f %10.1f %10.1f\n", pName, Frames, (double)tlm.BytesSent / tlm.FramesSent, EncodeNs,
+		   DecodeNs);
+}
+
+static void TB_Timestamps(const TB_Run_t *pRun, uint32_t Records)
+{
+	uint32_t now = TB_EPOCH;
+	uint64_t t0;
+	double encodeNs;
+
+	for(uint32_t i = 0; i < Records; i++)
+	{
+		pSent[i] = now;
+		if(pRun->Kind == TB_STEP_RANDOM)
+			now += (uint32_t)((int32_t)(TB_Random() % (2 * pRun->Step + 1)) - pRun->Step);
+		else if(pRun->Kind == TB_STEP_JUMP)
+			now = TB_Random() ^ (TB_Random() << 8);
+		else
+			now += (uint32_t)pRun->Step;
+	}
+
+	TB_Start();
+	t0 = TB_Nanos();
+	for(uint32_t i = 0; i < Records; i++)
+		SIM_CHECK(Telemetry_PutTimestamp(&tlm, pSent[i]) == TLM_OK);
+	encodeNs = (double)(TB_Nanos() - t0) / Records;
+
+	TB_Print(pRun->pName, Records, encodeNs, TB_Decode(Records));
+	SIM_CHECK(decodedBad == 0);
+}
+
+static void TB_Snapshot(uint32_t Records)
+{
+	static const char *names[] = { "i2c", "residency", "wakeups", "events" };
+	I2C_Handle_t i2c;
+	uint32_t residency[3], wakeups[3];
+	uint8_t payload[TLM_MAX_PAYLOAD];
+	uint32_t len;
+	uint64_t t0;
+	double encodeNs;
+
+	memset(&i2c, 0, sizeof(i2c));
+	i2c.pI2Cx = I2C1;
+	// a day up: ms per mode, wake ups and bus errors of that size
+	residency[0] = 3100000;
+	residency[1] = 83300000;
+	residency[2] = 0;
+	wakeups[0] = 86400;
+	wakeups[1] = 1200;
+	wakeups[2] = 3;
+	for(uint32_t i = 0; i < I2C_ERRCNT_NUM; i++)
+		i2c.ErrCount[i] = TB_Random() % 300;
+
+	// a full batch of events 100ms apart, the payload EventRec_SinkTelemetry() builds
+	len = Telemetry_PutVarint(payload, 0);
+	len += Telemetry_PutVarint(&payload[len], TB_EPOCH);
+	payload[len++] = TLM_EVENTS_MAX;
+	for(uint32_t i = 0; i < TLM_EVENTS_MAX; i++)
+	{
+		payload[len++] = (uint8_t)(i & 1 ? TLM_EVENT_LEVEL : 0);
+		len += Telemetry_PutVarint(&payload[len], 0);
+		len += Telemetry_PutVarint(&payload[len], i * 100000 + TB_Random() % 1000);
+	}
+
+	for(uint32_t r = 0; r < 4; r++)
+	{
+		TB_Start();
+		t0 = TB_Nanos();
+		for(uint32_t i = 0; i < Records; i++)
+		{
+			if(r == 0)
+				SIM_CHECK(Telemetry_PutI2CErrors(&tlm, &i2c) == TLM_OK);
+			else if(r == 1)
+				SIM_CHECK(Telemetry_PutHistogram(&tlm, 0, residency, 3) == TLM_OK);
+			else if(r == 2)
+				SIM_CHECK(Telemetry_PutHistogram(&tlm, 1, wakeups, 3) == TLM_OK);
+			else
+				SIM_CHECK(Telemetry_PutRecord(&tlm, TLM_REC_EVENTS, payload, len) == TLM_OK);
+		}
+		encodeNs = (double)(TB_Nanos() - t0) / Records;
+		TB_Print(names[r], Records, encodeNs, TB_Decode(Records));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t records = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : TB_RECORDS;
+
+	Sim_Init();
+	if((records == 0) || (records > TB_STREAM_SIZE / TLM_MAX_ENCODED_FRAME))
+		records = TB_RECORDS;
+	stream.pData = malloc(TB_STREAM_SIZE);
+	pSent = malloc(records * sizeof(pSent[0]));
+	if((stream.pData == NULL) || (pSent == NULL))
+		return 1;
+
+	printf("%-10s %8s %10s %10s %10s\n", "record", "frames", "bytes", "encode ns", "decode ns");
+	for(uint32_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++)
+		TB_Timestamps(&runs[r], records);
+	TB_Snapshot(records);
+
+	free(pSent);
+	free(stream.pData);
+	return Sim_Report("tlm");
+}
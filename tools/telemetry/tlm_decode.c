@@ -0,0 +1,293 @@
+/*
+ * tlm_decode.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+#include "tlm_decode.h"
+#include <string.h>
+
+/*
+ * same CRC-32 as the firmware (Inc/crc.h): poly 0x04C11DB7, init 0xFFFFFFFF, fed as little endian
+ * 32 bit words MSB first, the last word zero padded
+ */
+static uint32_t TLM_CRC32(const uint8_t *pData, uint32_t len)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	while(len)
+	{
+		uint32_t n = (len >= 4) ? 4 : len;
+		uint32_t word = 0;
+
+		for(uint32_t i = 0; i < n; i++)
+			word |= (uint32_t)pData[i] << (8 * i);
+
+		crc ^= word;
+		for(int i = 0; i < 32; i++)
+			crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+
+		pData += n;
+		len -= n;
+	}
+	return crc;
+}
+
+/*
+ * returns decoded length, or -1 if the encoding is invalid
+ */
+static int32_t TLM_COBSDecode(const uint8_t *pIn, uint32_t len, uint8_t *pOut)
+{
+	uint32_t readIdx = 0, writeIdx = 0;
+
+	while(readIdx < len)
+	{
+		uint8_t code = pIn[readIdx++];
+
+		if(code == 0 || (readIdx + code - 1) > len)
+			return -1;
+
+		for(uint8_t i = 1; i < code; i++)
+			pOut[writeIdx++] = pIn[readIdx++];
+
+		if(code != 0xFF && readIdx < len)
+			pOut[writeIdx++] = 0;
+	}
+	return (int32_t)writeIdx;
+}
+
+/*
+ * returns bytes consumed, or 0 if the varint runs past the end
+ */
+static uint32_t TLM_GetVarint(const uint8_t *pBuf, uint32_t len, uint32_t *pValue)
+{
+	uint32_t value = 0;
+
+	for(uint32_t i = 0; i < len && i < 5; i++)
+	{
+		value |= (uint32_t)(pBuf[i] & 0x7F) << (7 * i);
+		if(!(pBuf[i] & 0x80))
+		{
+			*pValue = value;
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+static void TLM_HandleFrame(TLM_Decoder_t *pDec, const uint8_t *pEncoded, uint32_t encodedLen)
+{
+	uint8_t raw[TLM_MAX_FRAME];
+	TLM_Record_t rec;
+	int32_t rawLen;
+	uint32_t pos, used, value;
+
+	rawLen = TLM_COBSDecode(pEncoded, encodedLen, raw);
+	if(rawLen < 6)
+	{
+		pDec->framesBadCOBS++;
+		return;
+	}
+
+	if(TLM_CRC32(raw, rawLen - 4) != ((uint32_t)raw[rawLen - 4] | ((uint32_t)raw[rawLen - 3] << 8) |
+									  ((uint32_t)raw[rawLen - 2] << 16) | ((uint32_t)raw[rawLen - 1] << 24)))
+	{
+		pDec->framesBadCRC++;
+		return;
+	}
+
+	memset(&rec, 0, sizeof(rec));
+	rec.type = raw[0];
+	rec.seq = raw[1];
+
+	if(pDec->haveSeq && rec.seq != pDec->nextSeq)
+	{
+		pDec->framesLost += (uint8_t)(rec.seq - pDec->nextSeq);
+		// a delta on top of a lost timestamp would be wrong, wait for the next absolute one
+		pDec->haveTimestamp = 0;
+	}
+	pDec->haveSeq = 1;
+	pDec->nextSeq = rec.seq + 1;
+
+	pos = 2;
+	rawLen -= 4;
+
+	switch(rec.type)
+	{
+	case TLM_REC_TIMESTAMP:
+		if(pos >= (uint32_t)rawLen)
+			goto bad;
+		{
+			uint8_t flags = raw[pos++];
+			used = TLM_GetVarint(&raw[pos], rawLen - pos, &value);
+			if(!used)
+				goto bad;
+			if(flags & TLM_TIMESTAMP_FLAG_ABS)
+			{
+				pDec->lastTimestamp = value;
+				pDec->haveTimestamp = 1;
+			}
+			else
+			{
+				// zigzag decode
+				pDec->lastTimestamp += (uint32_t)((value >> 1) ^ (0u - (value & 1)));
+			}
+			rec.timestamp = pDec->lastTimestamp;
+			rec.timestampValid = pDec->haveTimestamp;
+		}
+		break;
+
+	case TLM_REC_I2C_ERRORS:
+		if(pos >= (uint32_t)rawLen)
+			goto bad;
+		rec.bus = raw[pos++];
+		for(int i = 0; i < TLM_I2C_NO_OF_ERRORS; i++)
+		{
+			used = TLM_GetVarint(&raw[pos], rawLen - pos, &rec.i2cErrors[i]);
+			if(!used)
+				goto bad;
+			pos += used;
+		}
+		break;
+
+	case TLM_REC_HISTOGRAM:
+		if(pos + 2 > (uint32_t)rawLen)
+			goto bad;
+		rec.histId = raw[pos++];
+		rec.noOfBins = raw[pos++];
+		if(rec.noOfBins > TLM_HIST_MAX_BINS)
+			goto bad;
+		for(int i = 0; i < rec.noOfBins; i++)
+		{
+			used = TLM_GetVarint(&raw[pos], rawLen - pos, &rec.bins[i]);
+			if(!used)
+				goto bad;
+			pos += used;
+		}
+		break;
+
+	case TLM_REC_EVENTS:
+		{
+			uint32_t seconds, delta;
+
+			used = TLM_GetVarint(&raw[pos], rawLen - pos, &rec.dropped);
+			if(!used)
+				goto bad;
+			pos += used;
+			used = TLM_GetVarint(&raw[pos], rawLen - pos, &seconds);
+			if(!used)
+				goto bad;
+			pos += used;
+			if(pos >= (uint32_t)rawLen)
+				goto bad;
+			rec.noOfEvents = raw[pos++];
+			if(rec.noOfEvents > TLM_EVENTS_MAX)
+				goto bad;
+			for(int i = 0; i < rec.noOfEvents; i++)
+			{
+				if(pos >= (uint32_t)rawLen)
+					goto bad;
+				rec.eventLine[i] = raw[pos] & 0x0F;
+				rec.eventLevel[i] = (raw[pos++] & TLM_EVENT_LEVEL) ? 1 : 0;
+				used = TLM_GetVarint(&raw[pos], rawLen - pos, &delta);
+				if(!used)
+					goto bad;
+				pos += used;
+				rec.eventSeconds[i] = seconds + delta;
+				used = TLM_GetVarint(&raw[pos], rawLen - pos, &rec.eventMicros[i]);
+				if(!used)
+					goto bad;
+				pos += used;
+			}
+		}
+		break;
+
+	default:
+		// unknown record types are passed through so newer firmware doesn't break the collector
+		break;
+	}
+
+	pDec->framesOk++;
+	if(pDec->pfnRecord)
+		pDec->pfnRecord(pDec->pCtx, &rec);
+	return;
+
+bad:
+	// CRC good but the record does not parse: an encoder bug or a version mismatch, not the link
+	pDec->framesBadPayload++;
+}
+
+void TLM_DecoderInit(TLM_Decoder_t *pDec, TLM_RecordCallback_t pfnRecord, void *pCtx)
+{
+	memset(pDec, 0, sizeof(*pDec));
+	pDec->pfnRecord = pfnRecord;
+	pDec->pCtx = pCtx;
+}
+
+void TLM_Feed(TLM_Decoder_t *pDec, const uint8_t *pData, uint32_t len)
+{
+	for(uint32_t i = 0; i < len; i++)
+	{
+		if(pData[i] == 0x00)
+		{
+			if(pDec->overflow)
+				pDec->framesBadCOBS++;
+			else if(pDec->frameLen)
+				TLM_HandleFrame(pDec, pDec->frame, pDec->frameLen);
+			pDec->frameLen = 0;
+			pDec->overflow = 0;
+		}
+		else if(pDec->frameLen < TLM_MAX_FRAME)
+		{
+			pDec->frame[pDec->frameLen++] = pData[i];
+		}
+		else
+		{
+			pDec->overflow = 1;
+		}
+	}
+}
+
+void TLM_PrintCSVHeader(FILE *pOut)
+{
+	fprintf(pOut, "seq,type,values\n");
+}
+
+void TLM_PrintCSV(FILE *pOut, const TLM_Record_t *pRecord)
+{
+	switch(pRecord->type)
+	{
+	case TLM_REC_TIMESTAMP:
+		if(pRecord->timestampValid)
+			fprintf(pOut, "%u,timestamp,%u\n", pRecord->seq, pRecord->timestamp);
+		else
+			fprintf(pOut, "%u,timestamp,\n", pRecord->seq);
+		break;
+
+	case TLM_REC_I2C_ERRORS:
+		fprintf(pOut, "%u,i2c_errors,%u,%u,%u,%u,%u,%u\n", pRecord->seq, pRecord->bus,
+				pRecord->i2cErrors[0], pRecord->i2cErrors[1], pRecord->i2cErrors[2],
+				pRecord->i2cErrors[3], pRecord->i2cErrors[4]);
+		break;
+
+	case TLM_REC_HISTOGRAM:
+		fprintf(pOut, "%u,histogram,%u", pRecord->seq, pRecord->histId);
+		for(int i = 0; i < pRecord->noOfBins; i++)
+			fprintf(pOut, ",%u", pRecord->bins[i]);
+		fprintf(pOut, "\n");
+		break;
+
+	case TLM_REC_EVENTS:
+		if(pRecord->dropped)
+			fprintf(pOut, "%u,events_dropped,%u\n", pRecord->seq, pRecord->dropped);
+		for(int i = 0; i < pRecord->noOfEvents; i++)
+			fprintf(pOut, "%u,event,%u,%u,%u.%06u\n", pRecord->seq, pRecord->eventLine[i],
+					pRecord->eventLevel[i], pRecord->eventSeconds[i], pRecord->eventMicros[i]);
+		break;
+
+	default:
+		fprintf(pOut, "%u,unknown_%u,\n", pRecord->seq, pRecord->type);
+		break;
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * tlm_decode.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host side decoder for the firmware telemetry stream (see Inc/telemetry.h for the frame format)
+ * Feed raw bytes with TLM_Feed(). Every valid frame is decoded into a TLM_Record_t and passed to
+ * the record callback. Frames with a bad CRC, a bad COBS encoding or a malformed record are counted
+ * separately and dropped.
+ */
+
+#ifndef TLM_DECODE_H_
+#define TLM_DECODE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define TLM_REC_TIMESTAMP				0x01
+#define TLM_REC_I2C_ERRORS				0x02
+#define TLM_REC_HISTOGRAM				0x03
+#define TLM_REC_EVENTS					0x04
+
+#define TLM_TIMESTAMP_FLAG_ABS			(1 << 0)
+#define TLM_HIST_MAX_BINS				16
+#define TLM_EVENTS_MAX					9
+#define TLM_EVENT_LEVEL					(1 << 7)
+#define TLM_I2C_NO_OF_ERRORS			5
+#define TLM_MAX_FRAME					512
+
+typedef struct
+{
+	uint8_t		type;
+	uint8_t		seq;
+	uint8_t		timestampValid;		/* 0 if a delta arrived before any absolute timestamp */
+	uint32_t	timestamp;			/* TLM_REC_TIMESTAMP: seconds since 01/01/00 00:00:00 */
+	uint8_t		bus;				/* TLM_REC_I2C_ERRORS */
+	uint32_t	i2cErrors[TLM_I2C_NO_OF_ERRORS];
+	uint8_t		histId;				/* TLM_REC_HISTOGRAM */
+	uint8_t		noOfBins;
+	uint32_t	bins[TLM_HIST_MAX_BINS];
+	uint32_t	dropped;			/* TLM_REC_EVENTS */
+	uint8_t		noOfEvents;
+	uint8_t		eventLine[TLM_EVENTS_MAX];
+	uint8_t		eventLevel[TLM_EVENTS_MAX];
+	uint32_t	eventSeconds[TLM_EVENTS_MAX];
+	uint32_t	eventMicros[TLM_EVENTS_MAX];
+}TLM_Record_t;
+
+typedef void (*TLM_RecordCallback_t)(void *pCtx, const TLM_Record_t *pRecord);
+
+typedef struct
+{
+	uint8_t					frame[TLM_MAX_FRAME];
+	uint32_t				frameLen;
+	uint8_t					overflow;
+	uint8_t					haveTimestamp;
+	uint32_t				lastTimestamp;
+	uint8_t					haveSeq;
+	uint8_t					nextSeq;
+	TLM_RecordCallback_t	pfnRecord;
+	void					*pCtx;
+	/* statistics */
+	uint32_t				framesOk;
+	uint32_t				framesBadCRC;
+	uint32_t				framesBadCOBS;
+	uint32_t				framesBadPayload;	/* CRC ok, record malformed */
+	uint32_t				framesLost;		/* from gaps in the sequence number */
+}TLM_Decoder_t;
+
+void TLM_DecoderInit(TLM_Decoder_t *pDec, TLM_RecordCallback_t pfnRecord, void *pCtx);
+void TLM_Feed(TLM_Decoder_t *pDec, const uint8_t *pData, uint32_t len);
+void TLM_PrintCSVHeader(FILE *pOut);
+void TLM_PrintCSV(FILE *pOut, const TLM_Record_t *pRecord);
+
+#endif /* TLM_DECODE_H_ */
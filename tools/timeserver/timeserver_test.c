@@ -0,0 +1,208 @@
+/*
+ * timeserver_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the DS1307 compatible I2C slave (Inc/timeserver.h) against a simulated master, I2C2 and
+ * TIM2 on the simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o timeserver_test
+ * 			   timeserver_test.c ../sim/sim.c ../sim/i2c_master_sim.c ../../Src/timeserver.c ../../Src/timestamp.c
+ * 			   ../../BSP/rtc.c ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c
+ * Usage:	timeserver_test
+ *
+ * Runs every ISR timing of i2c_master_sim.h: the ISR loading the next byte ahead (a byte is in DR at
+ * the NACK) or only when SCL is stretched (the NACK seen with the STOP), and the error ISR before or
+ * after the event ISR
+ * 	- Pointer: SV_READS reads of random length from a random pointer set by a write, each followed
+ * 	  by a one byte read. Every byte has to be the register the DS1307 would send, the one byte read
+ * 	  the register after the last one read, across the wrap from 0x3F to 0x00
+ * 	- Writes: the RAM and the control register take writes, the time registers refuse and count them
+ * 	- Time: halted until the first publish, then the published second, the next one once the
+ * 	  software clock passed the second boundary
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "i2c_master_sim.h"
+#include "timeserver.h"
+#include "rtc.h"
+
+#define SV_TIMER_HZ						16000000UL
+#define SV_READS						256
+#define SV_MAX_READ						20
+#define SV_EPOCH						850000000UL			/* Some time in 2026 */
+
+static Sim_I2CMaster_t master;
+static TimeServer_Handle_t server;
+static Timestamp_Handle_t ts;
+static uint8_t expected[TIMESERVER_NO_OF_REGS];
+static uint32_t seed = 48;
+
+static uint32_t SV_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static void SV_EventISR(void)
+{
+	I2C_EV_IRQHandling(&server.I2CHandle);
+}
+
+static void SV_ErrorISR(void)
+{
+	I2C_ER_IRQHandling(&server.I2CHandle);
+}
+
+/*
+ * the driver callback, routed as main.c does
+ */
+void I2C_ApplicationEventCallback(I2C_Handle_t *pI2CHandle, uint8_t AppEv)
+{
+	if(pI2CHandle == &server.I2CHandle)
+		TimeServer_EventHandling(&server, AppEv);
+}
+
+static void SV_Start(void)
+{
+	Sim_Reset();
+	Sim_I2CMasterInit(&master, I2C2, SV_EventISR, SV_ErrorISR);
+
+	memset(&ts, 0, sizeof(ts));
+	ts.Timestamp_Config.pTIMx = TIM2;
+	ts.Timestamp_Config.TimerClockHz = SV_TIMER_HZ;
+	Timestamp_Init(&ts);
+	Timestamp_Sync(&ts, SV_EPOCH);
+
+	memset(&server, 0, sizeof(server));
+	server.TimeServer_Config.pI2Cx = I2C2;
+	server.TimeServer_Config.pSCLPort = GPIOB;
+	server.TimeServer_Config.SCLPin = GPIO_PIN_10;
+	server.TimeServer_Config.pSDAPort = GPIOB;
+	server.TimeServer_Config.SDAPin = GPIO_PIN_11;
+	server.TimeServer_Config.EVIRQNumber = IRQ_I2C2_EV;
+	server.TimeServer_Config.ERIRQNumber = IRQ_I2C2_ER;
+	server.TimeServer_Config.pTsHandle = &ts;
+	TimeServer_Init(&server);
+}
+
+static void SV_Encode(uint32_t Epoch, uint8_t *pRegs)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	RTC_fromEpoch(Epoch, &time, &date);
+	pRegs[0] = RTC_BintoBCD(time.seconds);
+	pRegs[1] = RTC_BintoBCD(time.minutes);
+	pRegs[2] = RTC_BintoBCD(time.hours);
+	pRegs[3] = date.day;
+	pRegs[4] = RTC_BintoBCD(date.date);
+	pRegs[5] = RTC_BintoBCD(date.month);
+	pRegs[6] = RTC_BintoBCD(date.year);
+}
+
+static void SV_Writes(void)
+{
+	uint8_t buf[1 + TIMESERVER_NO_OF_REGS];
+
+	// RAM and control in one burst
+	buf[0] = TIMESERVER_REG_CONTROL;
+	for(uint32_t i = TIMESERVER_REG_CONTROL; i < TIMESERVER_NO_OF_REGS; i++)
+		buf[1 + i - TIMESERVER_REG_CONTROL] = expected[i] = (uint8_t)SV_Random();
+	SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS, buf,
+								 1 + TIMESERVER_NO_OF_REGS - TIMESERVER_REG_CONTROL) ==
+			  1 + TIMESERVER_NO_OF_REGS - TIMESERVER_REG_CONTROL);
+	SIM_CHECK(memcmp(&server.Regs[TIMESERVER_REG_CONTROL], &expected[TIMESERVER_REG_CONTROL],
+					 TIMESERVER_NO_OF_REGS - TIMESERVER_REG_CONTROL) == 0);
+
+	// the time registers refuse
+	buf[0] = 0x00;
+	memset(&buf[1], 0x11, TIMESERVER_NO_OF_TIME_REGS);
+	SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS, buf, 1 + TIMESERVER_NO_OF_TIME_REGS) ==
+			  1 + TIMESERVER_NO_OF_TIME_REGS);
+	SIM_CHECK(server.RejectedWrites == TIMESERVER_NO_OF_TIME_REGS);
+
+	// another address is not acknowledged
+	SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS + 1, buf, 1) == 0);
+}
+
+static void SV_Time(void)
+{
+	uint8_t regs[TIMESERVER_NO_OF_TIME_REGS], pointer = 0x00;
+	Timestamp_t now = { SV_EPOCH, 200000 };
+
+	// halted until the first publish
+	SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS, &pointer, 1) == 1);
+	SIM_CHECK(Sim_I2CMasterRead(&master, TIMESERVER_DEFAULT_ADDRESS, regs, 1) == 1);
+	SIM_CHECK(regs[0] & (1 << TIMESERVER_REG_SECONDS_CH));
+
+	TimeServer_Publish(&server, &now);
+	SV_Encode(SV_EPOCH, expected);
+	SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS, &pointer, 1) == 1);
+	SIM_CHECK(Sim_I2CMasterRead(&master, TIMESERVER_DEFAULT_ADDRESS, regs, sizeof(regs)) == sizeof(regs));
+	SIM_CHECK(memcmp(regs, expected, sizeof(regs)) == 0);
+
+	// 0.9s later the software clock is in the next second, without a new publish
+	TIM2->CNT += SV_TIMER_HZ / 10 * 9;
+	SV_Encode(SV_EPOCH + 1, expected);
+	SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS, &pointer, 1) == 1);
+	SIM_CHECK(Sim_I2CMasterRead(&master, TIMESERVER_DEFAULT_ADDRESS, regs, sizeof(regs)) == sizeof(regs));
+	SIM_CHECK(memcmp(regs, expected, sizeof(regs)) == 0);
+}
+
+static void SV_Pointer(uint8_t LateISR, uint8_t ErrorFirst)
+{
+	uint8_t buf[SV_MAX_READ], next;
+	uint32_t bad = 0;
+
+	SV_Start();
+	master.LateISR = LateISR;
+	master.ErrorFirst = ErrorFirst;
+
+	SV_Time();
+	SV_Writes();
+
+	master.Stretches = 0;
+	master.Dropped = 0;
+	for(uint32_t n = 0; n < SV_READS; n++)
+	{
+		uint8_t pointer = (uint8_t)(SV_Random() % TIMESERVER_NO_OF_REGS);
+		uint32_t len = 1 + SV_Random() % SV_MAX_READ;
+
+		SIM_CHECK(Sim_I2CMasterWrite(&master, TIMESERVER_DEFAULT_ADDRESS, &pointer, 1) == 1);
+		SIM_CHECK(Sim_I2CMasterRead(&master, TIMESERVER_DEFAULT_ADDRESS, buf, len) == len);
+		SIM_CHECK(Sim_I2CMasterRead(&master, TIMESERVER_DEFAULT_ADDRESS, &next, 1) == 1);
+
+		for(uint32_t i = 0; i < len; i++)
+			bad += (buf[i] != expected[(pointer + i) % TIMESERVER_NO_OF_REGS]);
+		bad += (next != expected[(pointer + len) % TIMESERVER_NO_OF_REGS]);
+	}
+
+	printf("%-8s %-12s %5u reads, %5u stretches, %4u bytes never sent, %u wrong bytes\n",
+		   LateISR ? "late" : "ahead", ErrorFirst ? "error first" : "event first", SV_READS, master.Stretches,
+		   master.Dropped, bad);
+	SIM_CHECK(bad == 0);
+	SIM_CHECK(server.I2CHandle.ErrCount[I2C_ERRCNT_AF] == master.Nacks);
+	SIM_CHECK(server.Reads == master.Nacks);
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	for(uint8_t late = 0; late < 2; late++)
+	{
+		SV_Pointer(late, 0);
+		SV_Pointer(late, 1);
+	}
+
+	return Sim_Report("timeserver");
+}
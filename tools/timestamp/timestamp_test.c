@@ -0,0 +1,174 @@
+/*
+ * timestamp_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the sub-second timestamps (Inc/timestamp.h) against a simulated drifting timer
+ * oscillator, TIM2 on the simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../drivers/Inc -o timestamp_test timestamp_test.c
+ * 			   ../sim/sim.c ../../Src/timestamp.c -lm
+ * Usage:	timestamp_test
+ *
+ * The RTC seconds are the true time. The timer clock is 16MHz nominal and runs TT_FAST_PPM fast
+ * (HSI at its trim limit), in the second run it also wanders +-TT_WANDER_PPM over TT_WANDER_PERIOD
+ * seconds and the edge ISR latches TT_LATENCY_NS late at most. The 32 bit counter wraps every 265s.
+ * TT_STAMPS stamps at random instants of every second are compared with the true time. After
+ * TT_SETTLE seconds of filtering every stamp must be within TT_BOUND_US. Also checks the drift
+ * estimate, Timestamp_FromCount(), the hold of late stamps and the rejection of a missed edge.
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "sim.h"
+#include "timestamp.h"
+
+#define TT_TIMER_HZ						16000000.0
+#define TT_FAST_PPM						12300.0				/* 1.23% */
+#define TT_WANDER_PPM					20.0
+#define TT_WANDER_PERIOD				3600.0
+#define TT_LATENCY_NS					500
+#define TT_SECONDS						1200
+#define TT_SETTLE						120
+#define TT_STAMPS						16
+#define TT_BOUND_US						3.0
+#define TT_EPOCH						850000000UL			/* Some time in 2026 */
+
+static Timestamp_Handle_t ts;
+static double wanderPPM;
+static uint32_t seed = 1;
+
+static double TT_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (double)(seed >> 8) / (double)(1 << 24);
+}
+
+/*
+ * timer ticks since power on at true time t (seconds): the integral of the oscillator frequency
+ */
+static double TT_Ticks(double t)
+{
+	double ticks = TT_TIMER_HZ * (1.0 + TT_FAST_PPM * 1e-6) * t;
+
+	ticks += TT_TIMER_HZ * wanderPPM * 1e-6 * TT_WANDER_PERIOD / (2 * M_PI) * (1.0 - cos(2 * M_PI * t / TT_WANDER_PERIOD));
+	return ticks;
+}
+
+static void TT_SetTimer(double t)
+{
+	TIM2->CNT = (uint32_t)fmod(floor(TT_Ticks(t)), 4294967296.0);
+}
+
+/*
+ * error of a stamp taken at true time t, microseconds
+ */
+static double TT_StampError(double t)
+{
+	Timestamp_t stamp;
+	double truth;
+
+	TT_SetTimer(t);
+	Timestamp_Get(&ts, &stamp);
+	truth = (double)TT_EPOCH + t;
+	return ((double)stamp.Seconds - floor(truth)) * 1e6 + (double)stamp.Micros - (truth - floor(truth)) * 1e6;
+}
+
+/*
+ * runs the edges and stamps, returns the worst error after TT_SETTLE
+ */
+static double TT_Run(double Wander, uint32_t LatencyNs)
+{
+	double worst = 0, err, t;
+
+	wanderPPM = Wander;
+	TT_SetTimer(0);
+	ts.Timestamp_Config.pTIMx = TIM2;
+	ts.Timestamp_Config.TimerClockHz = (uint32_t)TT_TIMER_HZ;
+	Timestamp_Init(&ts);
+
+	for(uint32_t s = 1; s <= TT_SECONDS; s++)
+	{
+		if(s > TT_SETTLE)
+		{
+			for(uint32_t i = 0; i < TT_STAMPS; i++)
+			{
+				t = (s - 1) + (LatencyNs * 1e-9) + TT_Random() * (1.0 - 2 * LatencyNs * 1e-9);
+				err = fabs(TT_StampError(t));
+				if(err > worst)
+					worst = err;
+			}
+		}
+
+		// the SQW edge, latched after the ISR latency
+		TT_SetTimer(s + (LatencyNs ? TT_Random() * LatencyNs * 1e-9 : 0));
+		Timestamp_Edge(&ts);
+		if(s == 1)
+			Timestamp_Sync(&ts, TT_EPOCH + 1);
+	}
+
+	return worst;
+}
+
+static void TT_Accuracy(void)
+{
+	double worst;
+	int32_t ppb;
+
+	worst = TT_Run(0, 0);
+	ppb = Timestamp_GetDriftPPB(&ts);
+	printf("1.23%% fast:                     worst %.3f us, drift %d ppb, %u rejected\n", worst, ppb, ts.Rejected);
+	SIM_CHECK(worst <= TT_BOUND_US);
+	SIM_CHECK(fabs(ppb - TT_FAST_PPM * 1000) < 100);
+	SIM_CHECK(ts.Rejected == 0);
+
+	worst = TT_Run(TT_WANDER_PPM, TT_LATENCY_NS);
+	printf("1.23%% fast, wander, ISR latency: worst %.3f us, drift %d ppb, %u rejected\n", worst, Timestamp_GetDriftPPB(&ts), ts.Rejected);
+	SIM_CHECK(worst <= TT_BOUND_US);
+	SIM_CHECK(ts.Rejected == 0);
+}
+
+/*
+ * continues after TT_Run(0, 0), the last edge was at TT_SECONDS
+ */
+static void TT_Corners(void)
+{
+	double t = TT_SECONDS;
+	uint32_t count;
+	Timestamp_t stamp;
+
+	// a count latched in an ISR half a second before the last edge, converted later
+	TT_SetTimer(t - 0.5);
+	count = Timestamp_GetCount(&ts);
+	TT_SetTimer(t + 0.25);
+	Timestamp_FromCount(&ts, count, &stamp);
+	SIM_CHECK(stamp.Seconds == TT_EPOCH + TT_SECONDS - 1);
+	SIM_CHECK(fabs((double)stamp.Micros - 500000.0) <= TT_BOUND_US);
+
+	// the next edge came but its ISR has not run: held at the end of the second, never backwards
+	TT_SetTimer(t + 1.0005);
+	Timestamp_Get(&ts, &stamp);
+	SIM_CHECK(stamp.Seconds == TT_EPOCH + TT_SECONDS && stamp.Micros == 999999);
+
+	// two edges missed: the phase is re-latched, the period kept
+	TT_SetTimer(t + 3);
+	Timestamp_Edge(&ts);
+	SIM_CHECK(ts.Rejected == 1);
+	Timestamp_Sync(&ts, TT_EPOCH + TT_SECONDS + 3);
+	SIM_CHECK(fabs(TT_StampError(t + 3.5)) <= TT_BOUND_US);
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	TT_Accuracy();
+	TT_Run(0, 0);
+	TT_Corners();
+
+	return Sim_Report("timestamp");
+}
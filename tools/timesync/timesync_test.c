@@ -0,0 +1,424 @@
+/*
+ * timesync_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the time sync client (Inc/timesync.h) against a stand-in of ts_server.c over a simulated
+ * jittery link: the DS1307 on the simulated I2C bus, TIM2 and USART2 on the simulated memory map
+ * (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o timesync_test
+ * 			   timesync_test.c ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../Src/timesync.c
+ * 			   ../../Src/timestamp.c ../../Src/telemetry.c ../../Src/crc.c ../../Src/syscalls.c ../../Src/xprintf.c
+ * 			   ../../Src/ringbuf.c ../../BSP/rtc.c ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c ../../drivers/Src/stm32f407xx_usart.c -lm
+ * Usage:	timesync_test
+ *
+ * The host clock is the true time. The DS1307 runs SY_RTC_PPM fast and starts the case offset off,
+ * TIM2 runs from an 8MHz HSE SY_TIMER_PPM off. Every TIM2 read is SY_READ_NS after the one before,
+ * a busy wait is coarsened to SY_SPIN_US per read. USART2 sends at SY_BAUD, a DR write takes a byte
+ * time. The link adds SY_LATENCY_US each way plus exponential queueing (mean SY_QUEUE_UP_US on the
+ * host receive side, SY_QUEUE_DOWN_US on its send side) and now and then a spike of up to
+ * SY_SPIKE_US. SY_LOSS_PCT of the frames are lost each way, SY_CORRUPT_PCT of the replies have a
+ * byte changed. A DS1307 write restarts its divider SY_BUS_US after the busy wait ended
+ * 	- Offset: TimeSync_Get() against the true time at a random instant of every second. After the
+ * 	  first RTC write plus SY_SETTLE seconds it has to stay within SY_BOUND_US, and the DS1307 edges
+ * 	  within SY_BOUND_US plus TIMESYNC_COMMIT_MIN_US of the true second
+ * 	- TimeSync_Get() never goes back, except once for the case far ahead (stepped back)
+ * 	- Offsets forward of the step threshold and far back are stepped, the others slewed
+ * 	- Bus error: the first RTC write of the case fails on a NACK. It is counted in BusErrors and
+ * 	  done again at the next poll
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "timesync.h"
+#include "telemetry.h"
+
+#define SY_TIMER_HZ						8000000.0
+#define SY_TIMER_PPM					35.0
+#define SY_RTC_PPM						5.0
+#define SY_READ_NS						1000
+#define SY_SPIN_READS					32				/* Reads before a busy wait is assumed */
+#define SY_SPIN_US						50
+#define SY_EDGE_LATENCY_NS				2000
+#define SY_BAUD							115200.0
+#define SY_LATENCY_US					150
+#define SY_QUEUE_UP_US					800.0
+#define SY_QUEUE_DOWN_US				300.0
+#define SY_SPIKE_PCT					3
+#define SY_SPIKE_US						80000.0
+#define SY_LOSS_PCT						4
+#define SY_CORRUPT_PCT					2
+#define SY_BUS_US						280
+#define SY_SYNC_PERIOD					32
+#define SY_SECONDS						1200
+#define SY_SETTLE						120
+#define SY_BOUND_US						1500.0				/* The fastest exchange of a burst still queued a little */
+#define SY_EPOCH						850000000UL			/* Some time in 2026 */
+
+typedef struct
+{
+	const char		*pName;
+	double			OffsetS;						/* Device clock - true time at the start */
+	uint32_t		Steps;							/* Offsets expected to be stepped */
+	uint8_t			StepBack;						/* 1 -> TimeSync_Get() goes back once */
+	uint8_t			BusError;						/* 1 -> the first RTC write fails */
+}SY_Case_t;
+
+static const SY_Case_t cases[] =
+{
+	{ "behind 3.7s",	-3.7,	1,	0,	0 },
+	{ "behind 0.2s",	-0.2,	0,	0,	0 },
+	{ "ahead 0.42s",	0.42,	0,	0,	0 },
+	{ "ahead 90s",		90.3,	1,	1,	0 },
+	{ "bus error",		-1.3,	1,	0,	1 },
+};
+
+static Sim_I2CBus_t bus;
+static Sim_RTC_t part;
+static RTC_Handle_t rtc;
+static Timestamp_Handle_t ts;
+static USART_Handle_t usart;
+static TimeSync_Handle_t sync;
+static uint32_t seed = 47;
+
+/*
+ * the simulated time, written by the hooks
+ */
+static double now;
+static uint32_t reads;
+
+/*
+ * last frame sent by the device and the true time its delimiter was out
+ */
+static uint8_t txBuf[64];
+static uint32_t txLen;
+static double txEnd;
+
+/*
+ * reply on its way to the device
+ */
+static uint8_t rxBuf[64];
+static uint32_t rxLen;
+static double rxAt = -1;
+
+static double SY_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (double)(seed >> 8) / (double)(1 << 24);
+}
+
+static uint8_t SY_Percent(uint32_t Pct)
+{
+	return SY_Random() * 100.0 < Pct;
+}
+
+static double SY_Queue(double MeanUs)
+{
+	double us = -MeanUs * log(1.0 - SY_Random());
+
+	if(SY_Percent(SY_SPIKE_PCT))
+		us += SY_Random() * SY_SPIKE_US;
+	return us * 1e-6;
+}
+
+static void SY_TimerRead(void *pContext, uint32_t Offset)
+{
+	(void)pContext;
+
+	if(Offset != (uint32_t)((uintptr_t)&TIM2->CNT - TIM2_BASEADDR))
+		return;
+
+	SIM_REG(&TIM2->CNT) = (uint32_t)fmod(floor(now * SY_TIMER_HZ * (1.0 + SY_TIMER_PPM * 1e-6)), 4294967296.0);
+	now += (++reads < SY_SPIN_READS) ? SY_READ_NS * 1e-9 : SY_SPIN_US * 1e-6;
+}
+
+static void SY_USARTWrite(void *pContext, uint32_t Offset, uint32_t OldValue)
+{
+	(void)pContext;
+	(void)OldValue;
+
+	if(Offset != (uint32_t)((uintptr_t)&USART2->DR - USART2_BASEADDR))
+		return;
+
+	if(txLen < sizeof(txBuf))
+		txBuf[txLen++] = (uint8_t)SIM_REG(&USART2->DR);
+	// blocking send, the next byte goes once this one is out
+	now += 10.0 / SY_BAUD;
+	txEnd = now;
+}
+
+/*
+ * the firmware runs from true time t on
+ */
+static void SY_At(double t)
+{
+	if(t > now)
+		now = t;
+	reads = 0;
+}
+
+static int32_t SY_COBSDecode(const uint8_t *pIn, uint32_t len, uint8_t *pOut)
+{
+	uint32_t readIdx = 0, writeIdx = 0;
+
+	while(readIdx < len)
+	{
+		uint8_t code = pIn[readIdx++];
+
+		if(code == 0 || (readIdx + code - 1) > len)
+			return -1;
+
+		for(uint8_t i = 1; i < code; i++)
+			pOut[writeIdx++] = pIn[readIdx++];
+
+		if(code != 0xFF && readIdx < len)
+			pOut[writeIdx++] = 0;
+	}
+	return (int32_t)writeIdx;
+}
+
+static void SY_PutTime(uint8_t *pBuf, double t)
+{
+	int64_t us = (int64_t)SY_EPOCH * 1000000 + (int64_t)floor(t * 1e6);
+	uint32_t seconds = (uint32_t)(us / 1000000);
+	uint32_t micros = (uint32_t)(us % 1000000);
+
+	for(uint8_t i = 0; i < 4; i++)
+	{
+		pBuf[i] = (uint8_t)(seconds >> (8 * i));
+		pBuf[4 + i] = (uint8_t)(micros >> (8 * i));
+	}
+}
+
+/*
+ * ts_server.c on the far end of the link: the request sent in the last poll, the reply is queued
+ */
+static void SY_Host(void)
+{
+	uint8_t raw[64], reply[TIMESYNC_RAW_FRAME];
+	double t2, t3;
+	uint32_t crc;
+
+	// the hook filled the buffer in the signal handler
+	__asm__ volatile("" ::: "memory");
+	if(txLen == 0)
+		return;
+
+	SIM_CHECK(txBuf[txLen - 1] == 0x00);
+	SIM_CHECK(SY_COBSDecode(txBuf, txLen - 1, raw) == TIMESYNC_RAW_FRAME);
+	SIM_CHECK(raw[0] == TIMESYNC_MSG_REQUEST);
+	txLen = 0;
+	if(SY_Percent(SY_LOSS_PCT))
+		return;
+
+	t2 = txEnd + SY_LATENCY_US * 1e-6 + SY_Queue(SY_QUEUE_UP_US);
+	t3 = t2 + 20e-6;
+
+	reply[0] = TIMESYNC_MSG_REPLY;
+	reply[1] = raw[1];
+	memcpy(&reply[2], &raw[2], TIMESYNC_TIME_LEN);
+	SY_PutTime(&reply[2 + TIMESYNC_TIME_LEN], t2);
+	SY_PutTime(&reply[2 + 2 * TIMESYNC_TIME_LEN], t3);
+	crc = Telemetry_CRC32(reply, 2 + TIMESYNC_PAYLOAD_LEN);
+	for(uint8_t i = 0; i < 4; i++)
+		reply[2 + TIMESYNC_PAYLOAD_LEN + i] = (uint8_t)(crc >> (8 * i));
+
+	rxLen = Telemetry_COBSEncode(reply, sizeof(reply), rxBuf);
+	rxBuf[rxLen++] = 0x00;
+	if(SY_Percent(SY_CORRUPT_PCT))
+		rxBuf[1 + (uint32_t)(SY_Random() * (rxLen - 2))] ^= 0x40;
+	if(SY_Percent(SY_LOSS_PCT))
+		return;
+
+	rxAt = t3 + rxLen * 10.0 / SY_BAUD + SY_LATENCY_US * 1e-6 + SY_Queue(SY_QUEUE_DOWN_US);
+}
+
+/*
+ * the reply arrives if it is due by true time t, one RX interrupt per byte
+ */
+static void SY_Deliver(double t)
+{
+	if((rxAt < 0) || (rxAt > t))
+		return;
+
+	for(uint32_t i = 0; i < rxLen; i++)
+	{
+		SY_At(rxAt - (rxLen - 1 - i) * 10.0 / SY_BAUD);
+		SIM_REG(&USART2->SR) |= (1 << USART_SR_RXNE);
+		SIM_REG(&USART2->DR) = rxBuf[i];
+		TimeSync_IRQHandling(&sync);
+	}
+	SIM_REG(&USART2->SR) &= ~(1UL << USART_SR_RXNE);
+	rxAt = -1;
+}
+
+static void SY_Start(const SY_Case_t *pCase, double *pFirstEdge)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+	double whole = floor(pCase->OffsetS);
+
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	Sim_I2CAttach(&bus, &part.Dev);
+	Sim_RTCPowerOn(&part, SIM_RTC_DS1307, 7);
+	Sim_AddModel(TIM2_BASEADDR, sizeof(TIM_RegDef_t), SY_TimerRead, NULL, NULL);
+	Sim_AddModel(USART2_BASEADDR, sizeof(USART_RegDef_t), NULL, SY_USARTWrite, NULL);
+	SIM_REG(&USART2->SR) = (1 << USART_SR_TXE) | (1 << USART_SR_TC);
+	now = 0;
+	reads = 0;
+	txLen = 0;
+	rxAt = -1;
+
+	memset(&rtc, 0, sizeof(rtc));
+	rtc.RTC_Config.pI2Cx = I2C1;
+	rtc.RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	rtc.RTC_Config.pSCLPort = GPIOB;
+	rtc.RTC_Config.SCLPin = GPIO_PIN_6;
+	rtc.RTC_Config.pSDAPort = GPIOB;
+	rtc.RTC_Config.SDAPin = GPIO_PIN_7;
+	SIM_CHECK(RTC_Init(&rtc) == RTC_OK);
+
+	// the device clock is OffsetS off: whole seconds in the registers, the rest in the divider phase
+	RTC_fromEpoch(SY_EPOCH + (int32_t)whole, &time, &date);
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+	*pFirstEdge = 1.0 - (pCase->OffsetS - whole);
+
+	memset(&ts, 0, sizeof(ts));
+	ts.Timestamp_Config.pTIMx = TIM2;
+	ts.Timestamp_Config.TimerClockHz = (uint32_t)SY_TIMER_HZ;
+	Timestamp_Init(&ts);
+
+	memset(&usart, 0, sizeof(usart));
+	usart.pUSARTx = USART2;
+	usart.USART_Config.USART_WordLength = USART_WORDLEN_8BITS;
+
+	memset(&sync, 0, sizeof(sync));
+	sync.TimeSync_Config.pUSARTHandle = &usart;
+	sync.TimeSync_Config.IRQNumber = IRQ_USART2;
+	sync.TimeSync_Config.pTsHandle = &ts;
+	sync.TimeSync_Config.pRTCHandle = &rtc;
+	sync.TimeSync_Config.TimeFormat = RTC_TIME_FORMAT_24HRS;
+	sync.TimeSync_Config.SyncPeriod = SY_SYNC_PERIOD;
+	TimeSync_Init(&sync);
+}
+
+static uint32_t SY_ReadEpoch(void)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_OK);
+	return RTC_toEpoch(&time, &date);
+}
+
+/*
+ * DS1307 time - true time at the edge at true time t, microseconds
+ */
+static double SY_EdgeError(double t)
+{
+	return ((double)(SY_ReadEpoch() - SY_EPOCH) - t) * 1e6;
+}
+
+static void SY_Run(const SY_Case_t *pCase)
+{
+	double edge, next, period = 1.0 / (1.0 + SY_RTC_PPM * 1e-6);
+	double t, err, settled = -1, worst = 0, worstEdge = 0;
+	int64_t us, lastUs = INT64_MIN;
+	uint32_t commits = 0, backs = 0;
+	uint8_t pending;
+	Timestamp_t stamp;
+
+	SY_Start(pCase, &next);
+
+	for(uint32_t s = 0; s < SY_SECONDS; s++)
+	{
+		edge = next;
+		next = edge + period;
+		SY_Deliver(edge);
+
+		// SQW interrupt, then the scheduler task
+		SY_At(edge + SY_Random() * SY_EDGE_LATENCY_NS * 1e-9);
+		Timestamp_Edge(&ts);
+		Sim_RTCTick(&part, 1);
+		if(s == 0)
+			Timestamp_Sync(&ts, SY_ReadEpoch());
+
+		if((settled >= 0) && (edge >= settled) && !sync.CommitPending)
+		{
+			err = fabs(SY_EdgeError(edge));
+			if(err > worstEdge)
+				worstEdge = err;
+		}
+
+		// the first RTC write of the case is refused on the bus, the polls do no other I2C traffic
+		part.Dev.NackData = pCase->BusError && (sync.BusErrors == 0);
+
+		pending = sync.CommitPending;
+		SY_At(now);
+		if(TimeSync_Poll(&sync) & TIMESYNC_EV_COMMITTED)
+			commits++;
+		SY_Host();
+
+		if(part.Dev.NackData && sync.BusErrors)
+			SIM_CHECK(sync.CommitDue && !sync.CommitPending);
+		part.Dev.NackData = 0;
+
+		// RTC written, the divider restarts with the seconds register
+		if(!pending && sync.CommitPending)
+		{
+			SIM_CHECK(now < next);
+			next = now + SY_BUS_US * 1e-6 + period;
+			if(settled < 0)
+				settled = now + SY_SETTLE;
+		}
+
+		t = now + 0.1 + SY_Random() * 0.5;
+		SY_Deliver(t);
+		SY_At(t);
+		TimeSync_Get(&sync, &stamp);
+		us = (int64_t)(stamp.Seconds - SY_EPOCH) * 1000000 + stamp.Micros;
+		if(us < lastUs)
+			backs++;
+		lastUs = us;
+
+		err = fabs((double)us - now * 1e6);
+		if((settled >= 0) && (now >= settled) && (err > worst))
+			worst = err;
+	}
+
+	printf("%-12s %5u %5u %5u %5u %5u %5u %5u %9.0f %9.0f\n", pCase->pName, sync.Syncs, sync.Steps, commits,
+		   sync.Timeouts, sync.BadFrames, sync.BusErrors, backs, worst, worstEdge);
+
+	SIM_CHECK(settled >= 0 && settled < SY_SECONDS / 2);
+	SIM_CHECK(worst <= SY_BOUND_US);
+	SIM_CHECK(worstEdge <= SY_BOUND_US + TIMESYNC_COMMIT_MIN_US);
+	SIM_CHECK(sync.Steps == pCase->Steps);
+	SIM_CHECK(backs == pCase->StepBack);
+	SIM_CHECK(sync.BusErrors == pCase->BusError);
+	SIM_CHECK(sync.Syncs >= SY_SECONDS / (SY_SYNC_PERIOD + 2 * TIMESYNC_BURST));
+	SIM_CHECK(sync.Overruns == 0);
+	SIM_CHECK(commits >= 1);
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	printf("%-12s %5s %5s %5s %5s %5s %5s %5s %9s %9s\n", "case", "syncs", "steps", "rtc", "lost", "bad", "bus",
+		   "back", "worst us", "edge us");
+	for(uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+		SY_Run(&cases[c]);
+
+	return Sim_Report("timesync");
+}
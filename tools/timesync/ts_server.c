@@ -0,0 +1,312 @@
+/*
+ * ts_server.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Answers the time sync requests of the firmware (see Inc/timesync.h for the exchange and the frames)
+ *
+ * Build:	cc -O2 -o ts_server ts_server.c
+ * Usage:	ts_server [-u] [-b baud] /dev/ttyUSB0
+ *
+ * Serves local time by default, -u serves UTC. Every exchange is printed with the offset of the
+ * device clock T1 it carried (informational, the device computes the real offset from T4).
+ * USB serial adapters add their buffering to the receive side only, set them to low latency
+ * (setserial /dev/ttyUSB0 low_latency, or the FTDI latency_timer to 1)
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+#define TS_MSG_REQUEST			0x10
+#define TS_MSG_REPLY			0x11
+#define TS_TIME_LEN				8
+#define TS_PAYLOAD_LEN			(3 * TS_TIME_LEN)
+#define TS_RAW_FRAME			(2 + TS_PAYLOAD_LEN + 4)
+#define TS_MAX_FRAME			64
+#define TS_EPOCH_OFFSET			946684800LL		/* 01/01/00 00:00:00 in unix time */
+
+/*
+ * same CRC-32 as the firmware (Inc/crc.h), see tools/telemetry/tlm_decode.c
+ */
+static uint32_t TS_CRC32(const uint8_t *pData, uint32_t len)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	while(len)
+	{
+		uint32_t n = (len >= 4) ? 4 : len;
+		uint32_t word = 0;
+
+		for(uint32_t i = 0; i < n; i++)
+			word |= (uint32_t)pData[i] << (8 * i);
+
+		crc ^= word;
+		for(int i = 0; i < 32; i++)
+			crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+
+		pData += n;
+		len -= n;
+	}
+	return crc;
+}
+
+/*
+ * returns decoded length, or -1 if the encoding is invalid
+ */
+static int32_t TS_COBSDecode(const uint8_t *pIn, uint32_t len, uint8_t *pOut)
+{
+	uint32_t readIdx = 0, writeIdx = 0;
+
+	while(readIdx < len)
+	{
+		uint8_t code = pIn[readIdx++];
+
+		if(code == 0 || (readIdx + code - 1) > len)
+			return -1;
+
+		for(uint8_t i = 1; i < code; i++)
+			pOut[writeIdx++] = pIn[readIdx++];
+
+		if(code != 0xFF && readIdx < len)
+			pOut[writeIdx++] = 0;
+	}
+	return (int32_t)writeIdx;
+}
+
+static uint32_t TS_COBSEncode(const uint8_t *pIn, uint32_t len, uint8_t *pOut)
+{
+	uint32_t codeIdx = 0, writeIdx = 1;
+	uint8_t code = 1;
+
+	for(uint32_t readIdx = 0; readIdx < len; readIdx++)
+	{
+		if(pIn[readIdx] == 0)
+		{
+			pOut[codeIdx] = code;
+			codeIdx = writeIdx++;
+			code = 1;
+		}
+		else
+		{
+			pOut[writeIdx++] = pIn[readIdx];
+			if(++code == 0xFF)
+			{
+				pOut[codeIdx] = code;
+				codeIdx = writeIdx++;
+				code = 1;
+			}
+		}
+	}
+	pOut[codeIdx] = code;
+
+	return writeIdx;
+}
+
+/*
+ * microseconds since 01/01/00 00:00:00 in the served time zone
+ */
+static int64_t TS_Now(int utc)
+{
+	struct timespec ts;
+	struct tm local;
+	int64_t seconds;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	seconds = (int64_t)ts.tv_sec - TS_EPOCH_OFFSET;
+	if(!utc)
+	{
+		localtime_r(&ts.tv_sec, &local);
+		seconds += local.tm_gmtoff;
+	}
+	return seconds * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void TS_PutTime(uint8_t *pBuf, int64_t us)
+{
+	uint32_t seconds = (uint32_t)(us / 1000000);
+	uint32_t micros = (uint32_t)(us % 1000000);
+
+	for(int i = 0; i < 4; i++)
+	{
+		pBuf[i] = (uint8_t)(seconds >> (8 * i));
+		pBuf[4 + i] = (uint8_t)(micros >> (8 * i));
+	}
+}
+
+static int64_t TS_GetTime(const uint8_t *pBuf)
+{
+	uint32_t seconds = 0, micros = 0;
+
+	for(int i = 0; i < 4; i++)
+	{
+		seconds |= (uint32_t)pBuf[i] << (8 * i);
+		micros |= (uint32_t)pBuf[4 + i] << (8 * i);
+	}
+	return (int64_t)seconds * 1000000 + micros;
+}
+
+static speed_t TS_Baud(long baud)
+{
+	switch(baud)
+	{
+	case 9600:		return B9600;
+	case 19200:		return B19200;
+	case 38400:		return B38400;
+	case 57600:		return B57600;
+	case 115200:	return B115200;
+	case 230400:	return B230400;
+	case 460800:	return B460800;
+	default:		return 0;
+	}
+}
+
+static int TS_Open(const char *pPath, speed_t speed)
+{
+	struct termios tio;
+	int fd = open(pPath, O_RDWR | O_NOCTTY);
+
+	if(fd < 0)
+		return -1;
+
+	if(tcgetattr(fd, &tio) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	cfmakeraw(&tio);
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+	tio.c_cc[VMIN] = 1;
+	tio.c_cc[VTIME] = 0;
+	if(tcsetattr(fd, TCSANOW, &tio) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	tcflush(fd, TCIOFLUSH);
+
+	return fd;
+}
+
+static void TS_HandleFrame(int fd, const uint8_t *pEncoded, uint32_t encodedLen, int64_t t2, int utc)
+{
+	uint8_t raw[TS_MAX_FRAME];
+	uint8_t reply[TS_RAW_FRAME];
+	uint8_t encoded[TS_MAX_FRAME];
+	int32_t rawLen = TS_COBSDecode(pEncoded, encodedLen, raw);
+	uint32_t crc, len;
+	int64_t t1, t3;
+
+	if(rawLen != TS_RAW_FRAME)
+		return;
+
+	crc = (uint32_t)raw[rawLen - 4] | ((uint32_t)raw[rawLen - 3] << 8) |
+		  ((uint32_t)raw[rawLen - 2] << 16) | ((uint32_t)raw[rawLen - 1] << 24);
+	if(crc != TS_CRC32(raw, (uint32_t)rawLen - 4) || raw[0] != TS_MSG_REQUEST)
+	{
+		fprintf(stderr, "bad frame\n");
+		return;
+	}
+
+	t1 = TS_GetTime(&raw[2]);
+
+	reply[0] = TS_MSG_REPLY;
+	reply[1] = raw[1];
+	memcpy(&reply[2], &raw[2], TS_TIME_LEN);
+	TS_PutTime(&reply[2 + TS_TIME_LEN], t2);
+
+	// T3 as late as possible, the CRC and the encoding are only a few us
+	t3 = TS_Now(utc);
+	TS_PutTime(&reply[2 + 2 * TS_TIME_LEN], t3);
+	crc = TS_CRC32(reply, 2 + TS_PAYLOAD_LEN);
+	for(int i = 0; i < 4; i++)
+		reply[2 + TS_PAYLOAD_LEN + i] = (uint8_t)(crc >> (8 * i));
+
+	len = TS_COBSEncode(reply, sizeof(reply), encoded);
+	encoded[len++] = 0x00;
+	if(write(fd, encoded, len) != (ssize_t)len)
+		perror("write");
+
+	printf("seq %3u  device %lld.%06lld  host %lld.%06lld  ~offset %+lld us\n", raw[1],
+		   (long long)(t1 / 1000000), (long long)(t1 % 1000000),
+		   (long long)(t2 / 1000000), (long long)(t2 % 1000000), (long long)(t2 - t1));
+	fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+	uint8_t frame[TS_MAX_FRAME];
+	uint8_t buf[256];
+	uint32_t frameLen = 0;
+	int overflow = 0;
+	long baud = 115200;
+	int utc = 0;
+	int opt, fd;
+	speed_t speed;
+	ssize_t n;
+
+	while((opt = getopt(argc, argv, "ub:")) != -1)
+	{
+		if(opt == 'u')
+			utc = 1;
+		else if(opt == 'b')
+			baud = strtol(optarg, NULL, 10);
+		else
+			break;
+	}
+
+	speed = TS_Baud(baud);
+	if(optind >= argc || speed == 0)
+	{
+		fprintf(stderr, "usage: %s [-u] [-b baud] device\n", argv[0]);
+		return 1;
+	}
+
+	fd = TS_Open(argv[optind], speed);
+	if(fd < 0)
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+
+	while((n = read(fd, buf, sizeof(buf))) > 0)
+	{
+		// T2 at the delimiter, the device latches T4 at the delimiter too
+		int64_t t2 = TS_Now(utc);
+
+		for(ssize_t i = 0; i < n; i++)
+		{
+			if(buf[i] == 0x00)
+			{
+				if(!overflow && frameLen)
+					TS_HandleFrame(fd, frame, frameLen, t2, utc);
+				frameLen = 0;
+				overflow = 0;
+			}
+			else if(frameLen < TS_MAX_FRAME)
+			{
+				frame[frameLen++] = buf[i];
+			}
+			else
+			{
+				overflow = 1;
+			}
+		}
+	}
+
+	close(fd);
+
+	return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * trim_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host test of the DS1307 software trim (Inc/trim.h) against simulated crystals at several ppm and
+ * temperatures: the DS1307 on the simulated I2C bus and TIM2 on the simulated memory map (tools/sim)
+ *
+ * Build:	cc -O2 -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o trim_test trim_test.c
+ * 			   ../sim/sim.c ../sim/i2c_sim.c ../sim/rtc_sim.c ../../Src/trim.c ../../Src/timestamp.c ../../BSP/rtc.c
+ * 			   ../../BSP/ds1307.c ../../BSP/ds3231.c ../../BSP/pcf8563.c ../../Src/regmap.c
+ * 			   ../../drivers/Src/stm32f407x_i2c.c ../../drivers/Src/stm32f407xx_gpio_driver.c
+ * 			   ../../drivers/Src/stm32f407xx_RCC.c -lm
+ * Usage:	trim_test
+ *
+ * TIM2 runs from the 8MHz HSE, which is taken as exact. The DS1307 crystal is a 32.768kHz tuning fork:
+ * its error is the ppm of the case at 25C, minus TR_TEMPCO ppm/C^2 away from it. Every SQW edge is
+ * latched up to TR_LATENCY_NS late, then Trim_Poll() runs as the main.c task does. A step write
+ * restarts the DS1307 divider TR_WRITE_US after the edge. Each case runs TR_DAYS days
+ * 	- Converged: the first edge with Trim_IsConverged()
+ * 	- Tracked: the first fit point within TR_TRACK_PPB of the true drift, and the worst fit error
+ * 	  after TR_SETTLE seconds (after the last temperature change for the step case)
+ * 	- Time: the worst error of the DS1307 time against the true time, read every TR_READ_PERIOD, next
+ * 	  to the error the untrimmed crystal would have at the end
+ * Every case has to converge within TR_CONVERGE_LIMIT, track within its bound and keep the time within
+ * TR_TIME_BOUND. A start with the drift kept in the NVRAM (InitialPPB) has to keep the time from the
+ * first edge on. Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+#include "rtc_sim.h"
+#include "trim.h"
+
+#define TR_REF_HZ						8000000.0
+#define TR_TEMPCO						0.034				/* ppm/C^2, parabola around 25C */
+#define TR_TURNOVER						25.0
+#define TR_LATENCY_NS					2000
+#define TR_WRITE_US						1000
+#define TR_DAYS							2
+#define TR_READ_PERIOD					600
+#define TR_SETTLE						7200
+#define TR_CONVERGE_LIMIT				3600
+#define TR_TRACK_PPB					100
+#define TR_TIME_BOUND					1.5					/* Seconds, the half second threshold plus a fit lag */
+#define TR_EPOCH						850000000UL			/* Some time in 2026 */
+
+typedef struct
+{
+	const char		*pName;
+	double			PPM;							/* At the turnover temperature */
+	double			(*pfnTemp)(double t);			/* Degrees C at true time t */
+	double			TrackBoundPPB;					/* Worst fit error after TR_SETTLE */
+	uint8_t			WarmStart;						/* 1 -> InitialPPB is the true drift at t = 0 */
+}TR_Case_t;
+
+static double TR_Room(double t)
+{
+	(void)t;
+	return TR_TURNOVER;
+}
+
+static double TR_Cold(double t)
+{
+	(void)t;
+	return 0.0;
+}
+
+/*
+ * 10C to 40C over the day
+ */
+static double TR_Daily(double t)
+{
+	return TR_TURNOVER + 15.0 * sin(2 * M_PI * t / 86400.0);
+}
+
+/*
+ * carried into a 5C room after a day, 30 min thermal time constant
+ */
+static double TR_Drop(double t)
+{
+	if(t < 86400.0)
+		return TR_TURNOVER;
+	return 5.0 + (TR_TURNOVER - 5.0) * exp(-(t - 86400.0) / 1800.0);
+}
+
+static const TR_Case_t cases[] =
+{
+	{ "+50ppm 25C",		50.0,	TR_Room,	50,		0 },
+	{ "-30ppm 25C",		-30.0,	TR_Room,	50,		0 },
+	{ "+20ppm 0C",		20.0,	TR_Cold,	50,		0 },
+	{ "+10ppm 10-40C",	10.0,	TR_Daily,	1000,	0 },
+	{ "0ppm 25C->5C",	0.0,	TR_Drop,	1000,	0 },
+	{ "+50ppm warm",	50.0,	TR_Room,	50,		1 },
+};
+
+static Sim_I2CBus_t bus;
+static Sim_RTC_t part;
+static RTC_Handle_t rtc;
+static Timestamp_Handle_t ts;
+static Trim_Handle_t trim;
+static uint32_t seed = 46;
+
+static double TR_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (double)(seed >> 8) / (double)(1 << 24);
+}
+
+static double TR_PPM(const TR_Case_t *pCase, double t)
+{
+	double dt = pCase->pfnTemp(t) - TR_TURNOVER;
+
+	return pCase->PPM - TR_TEMPCO * dt * dt;
+}
+
+/*
+ * TIM2 at true time t
+ */
+static void TR_SetTimer(double t)
+{
+	TIM2->CNT = (uint32_t)fmod(floor(t * TR_REF_HZ), 4294967296.0);
+}
+
+/*
+ * DS1307 time - true time, seconds. Right after an edge the RTC second is whole
+ */
+static double TR_TimeError(double t)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	SIM_CHECK(RTC_GetDateTime(&rtc, &time, &date) == RTC_OK);
+	return (double)RTC_toEpoch(&time, &date) - ((double)TR_EPOCH + t);
+}
+
+static void TR_Start(const TR_Case_t *pCase)
+{
+	RTC_Handle_time_t time;
+	RTC_Handle_date_t date;
+
+	Sim_Reset();
+	Sim_I2CBusInit(&bus, I2C1);
+	Sim_I2CAttach(&bus, &part.Dev);
+	Sim_RTCPowerOn(&part, SIM_RTC_DS1307, 7);
+
+	memset(&rtc, 0, sizeof(rtc));
+	rtc.RTC_Config.pI2Cx = I2C1;
+	rtc.RTC_Config.I2C_SCLSpeed = I2C_SCL_SPEED_SM_KHZ;
+	rtc.RTC_Config.pSCLPort = GPIOB;
+	rtc.RTC_Config.SCLPin = GPIO_PIN_6;
+	rtc.RTC_Config.pSDAPort = GPIOB;
+	rtc.RTC_Config.SDAPin = GPIO_PIN_7;
+	SIM_CHECK(RTC_Init(&rtc) == RTC_OK);
+
+	// set at true time 0, the divider starts there
+	RTC_fromEpoch(TR_EPOCH, &time, &date);
+	SIM_CHECK(RTC_SetDateTime(&rtc, &time, &date) == RTC_OK);
+
+	TR_SetTimer(0);
+	memset(&ts, 0, sizeof(ts));
+	ts.Timestamp_Config.pTIMx = TIM2;
+	ts.Timestamp_Config.TimerClockHz = (uint32_t)TR_REF_HZ;
+	Timestamp_Init(&ts);
+
+	memset(&trim, 0, sizeof(trim));
+	trim.Trim_Config.pTsHandle = &ts;
+	trim.Trim_Config.pRTCHandle = &rtc;
+	trim.Trim_Config.ReferenceHz = (uint32_t)TR_REF_HZ;
+	trim.Trim_Config.WindowSeconds = TRIM_DEFAULT_WINDOW;
+	trim.Trim_Config.Measure = ENABLE;
+	trim.Trim_Config.InitialPPB = pCase->WarmStart ? (int32_t)lround(TR_PPM(pCase, 0) * 1000.0) : 0;
+	Trim_Init(&trim);
+}
+
+static void TR_Run(const TR_Case_t *pCase)
+{
+	double t = 0, edgeAt, ppm, err, worstTime = 0, worstTrack = 0, settleFrom = TR_SETTLE;
+	double untrimmed = 0, converged = -1, tracked = -1;
+	uint32_t points = 0, nextRead = TR_READ_PERIOD;
+	int8_t step;
+
+	TR_Start(pCase);
+	if(pCase->pfnTemp == TR_Drop)
+		settleFrom = 86400.0 + TR_SETTLE;
+
+	for(uint32_t s = 1; s <= TR_DAYS * 86400U; s++)
+	{
+		// the next RTC second, at the crystal frequency of its start
+		ppm = TR_PPM(pCase, t);
+		t += 1.0 / (1.0 + ppm * 1e-6);
+		untrimmed += 1.0 - 1.0 / (1.0 + ppm * 1e-6);
+		edgeAt = t;
+
+		TR_SetTimer(edgeAt + TR_Random() * TR_LATENCY_NS * 1e-9);
+		Timestamp_Edge(&ts);
+		Sim_RTCTick(&part, 1);
+
+		step = Trim_Poll(&trim);
+		if(step != 0)
+			t += TR_WRITE_US * 1e-6;
+
+		if((converged < 0) && Trim_IsConverged(&trim))
+			converged = edgeAt;
+
+		// a new fit point
+		if(trim.Points != points)
+		{
+			points = trim.Points;
+			err = fabs(trim.FitPPB - TR_PPM(pCase, edgeAt) * 1000.0);
+			if((tracked < 0) && (err <= TR_TRACK_PPB))
+				tracked = edgeAt;
+			if((edgeAt >= settleFrom) && (err > worstTrack))
+				worstTrack = err;
+		}
+
+		if((s >= nextRead) && ((converged >= 0) || pCase->WarmStart))
+		{
+			nextRead += TR_READ_PERIOD;
+			err = fabs(TR_TimeError(edgeAt));
+			if(err > worstTime)
+				worstTime = err;
+		}
+	}
+
+	printf("%-14s %9.1f %9.1f %9.0f %8.2f %8.2f %6u %6u\n", pCase->pName, converged / 60.0, tracked / 60.0,
+		   worstTrack, worstTime, untrimmed, trim.Steps, trim.Bridged);
+
+	SIM_CHECK(converged >= 0 && converged <= TR_CONVERGE_LIMIT);
+	SIM_CHECK(tracked >= 0);
+	SIM_CHECK(worstTrack <= pCase->TrackBoundPPB);
+	SIM_CHECK(worstTime <= TR_TIME_BOUND);
+	SIM_CHECK(trim.BusErrors == 0);
+	// one step per second of drift, give or take the one in progress
+	SIM_CHECK(fabs(fabs(untrimmed) - trim.Steps) <= TR_TIME_BOUND);
+}
+
+int main(void)
+{
+	Sim_Init();
+
+	printf("%-14s %9s %9s %9s %8s %8s %6s %6s\n", "case", "conv min", "track min", "worst ppb", "time s",
+		   "free s", "steps", "bridge");
+	for(uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+		TR_Run(&cases[c]);
+
+	return Sim_Report("trim");
+}
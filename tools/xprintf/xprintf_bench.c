@@ -0,0 +1,498 @@
+/*
+ * xprintf_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Vishal Turaga
+ */
+
+/*
+ * Host check and benchmark of the formatted output engine (Inc/xprintf.h) against the C library
+ * printf, on typical RTC log lines, and its code size against newlib-nano from the linker map files
+ *
+ * Build:	cc -O2 -Wformat -iquote ../sim -iquote ../../Inc -iquote ../../BSP -iquote ../../drivers/Inc -o xprintf_bench
+ * 			   xprintf_bench.c ../sim/sim.c ../../Src/xprintf.c ../../Src/ringbuf.c ../../Src/syscalls.c
+ * Usage:	xprintf_bench [calls per line] [firmware .map ...]
+ *
+ * 	- Format: XPrintf_Buffer() gives the text and the length snprintf() of the C library gives, for
+ * 	  XB_FUZZ random conversions (flags, width, precision, length modifiers) and for every log line
+ * 	  with random arguments. Every buffer size from 0 up cuts the text like snprintf
+ * 	- Cycles: ns per call of XPrintf_Buffer() and snprintf() for each log line. Host times against the
+ * 	  host C library (glibc), for the relative cost of the lines and the two engines, not newlib-nano
+ * 	  cycles: confirm them with DWT_CYCCNT on the board
+ * 	- Code size: for each GNU ld map (default ../../Debug/RTC_LED_PROJECT.map, the newlib-nano printf
+ * 	  build) the flash and RAM taken by the C library members, by xprintf.o and by the application,
+ * 	  the heap reserved and the members over XB_MEMBER_MIN bytes. Compare the map of a build with
+ * 	  xprintf.c against it
+ * Exits 1 on any error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "xprintf.h"
+
+#define XB_CALLS						200000
+#define XB_FUZZ							100000
+#define XB_ARGS							256				/* Random argument sets checked per log line */
+#define XB_BUF							160
+#define XB_MEMBER_MIN					64
+#define XB_MAX_OBJECTS					256
+#define XB_DEFAULT_MAP					"../../Debug/RTC_LED_PROJECT.map"
+
+typedef struct
+{
+	char			Name[96];
+	uint32_t		Flash;
+	uint32_t		RAM;
+}XB_Object_t;
+
+static XB_Object_t objects[XB_MAX_OBJECTS];
+static uint32_t noOfObjects;
+static uint32_t seed = 49;
+
+static uint32_t XB_Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint64_t XB_Nanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static long XB_Signed(void)
+{
+	long v = (long)(XB_Random() ^ (XB_Random() << 16));
+
+	// mostly the small values of the log lines
+	return (XB_Random() & 1) ? v % 100000 : v;
+}
+
+/*
+ * both engines through the same arguments, Engine 0 -> snprintf, 1 -> XPrintf_Buffer
+ */
+#define XB_FORMAT(Engine, pBuf, Size, ...)	((Engine) ? XPrintf_Buffer((pBuf), (Size), __VA_ARGS__) : \
+																	snprintf((pBuf), (Size), __VA_ARGS__))
+
+/*
+ * Typical log lines of main.c and the RTC modules, the arguments drawn by the line itself
+ */
+typedef struct
+{
+	long		a, b, c;
+	uint32_t	u;
+	const char	*s1, *s2;
+}XB_Args_t;
+
+static const char *days[] = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+
+static int XB_Line(uint8_t Line, uint8_t Engine, char *pBuf, uint32_t Size, const XB_Args_t *p)
+{
+	switch(Line)
+	{
+	case 0:
+		return XB_FORMAT(Engine, pBuf, Size, "Current Time: %s %s\n", p->s1, p->s2);
+	case 1:
+		return XB_FORMAT(Engine, pBuf, Size, "Current Date: %s <%s> \n", p->s1, p->s2);
+	case 2:
+		return XB_FORMAT(Engine, pBuf, Size, "Time sync: offset %ld s %ld us, delay %ld us\n", p->a, p->b, p->c);
+	case 3:
+		return XB_FORMAT(Engine, pBuf, Size, "Clocks %ld s apart, resync\n", p->a);
+	case 4:
+		return XB_FORMAT(Engine, pBuf, Size, "drift %s%lu.%03lu ppm\n", XPRINTF_FIXED(p->a, 1000));
+	case 5:
+		return XB_FORMAT(Engine, pBuf, Size, "20%02u-%02u-%02u %02u:%02u:%02u.%06lu\n", p->u % 100,
+						 p->u % 12 + 1, p->u % 28 + 1, p->u % 24, p->u % 60, (p->u / 60) % 60,
+						 (unsigned long)(p->u % 1000000));
+	default:
+		return XB_FORMAT(Engine, pBuf, Size, "ev %08lX src %-6s n=%5u\n", (unsigned long)p->u, p->s1,
+						 (unsigned)(p->u & 0xFFFF));
+	}
+}
+
+#define XB_NO_OF_LINES					7
+
+static const char *lineNames[XB_NO_OF_LINES] =
+{
+	"time", "date", "sync", "dual", "drift", "stamp", "event"
+};
+
+static void XB_Draw(uint8_t Line, XB_Args_t *p)
+{
+	static char t[16], d[16];
+
+	p->a = XB_Signed();
+	p->b = XB_Signed() % 1000000;
+	p->c = labs(XB_Signed()) % 100000;
+	p->u = XB_Random() ^ (XB_Random() << 8);
+	snprintf(t, sizeof(t), "%02u:%02u:%02u", (unsigned)(p->u % 24), (unsigned)(p->u % 60), (unsigned)(p->u % 59));
+	snprintf(d, sizeof(d), "%02u/%02u/%02u", (unsigned)(p->u % 28 + 1), (unsigned)(p->u % 12 + 1),
+			 (unsigned)(p->u % 100));
+	p->s1 = (Line == 1) ? d : (Line == 6) ? "RTC" : t;
+	p->s2 = (Line == 1) ? days[p->u % 7] : (p->u & 1) ? "PM" : "AM";
+}
+
+/*
+ * both texts and lengths, and every shorter buffer cut like snprintf
+ */
+static uint32_t XB_Compare(uint8_t Line, const XB_Args_t *p)
+{
+	char ref[XB_BUF], out[XB_BUF];
+	int refLen = XB_Line(Line, 0, ref, sizeof(ref), p);
+	uint32_t bad = 0;
+
+	bad += (XB_Line(Line, 1, out, sizeof(out), p) != refLen) || strcmp(out, ref);
+	for(uint32_t size = 0; size <= (uint32_t)refLen; size++)
+	{
+		memset(out, 0x55, sizeof(out));
+		bad += (XB_Line(Line, 1, out, size, p) != refLen);
+		bad += (size != 0) && ((strncmp(out, ref, size - 1) != 0) || (out[size - 1] != '\0'));
+		bad += (out[size] != 0x55);
+	}
+	return bad;
+}
+
+/*
+ * a random conversion: flags, width, precision (also *), length modifier
+ */
+static uint32_t XB_Fuzz(void)
+{
+	static const char convs[] = "diuxXoc";
+	static const char flagChars[] = "-0+ #";
+	char fmt[32], ref[XB_BUF], out[XB_BUF];
+	char conv = convs[XB_Random() % (sizeof(convs) - 1)];
+	uint32_t n = 0, r = XB_Random();
+	long long v = (long long)((uint64_t)XB_Random() << 40 ^ (uint64_t)XB_Random() << 16 ^ XB_Random());
+	int refLen, len, star = 0;
+	uint8_t hasStar = 0;
+
+	fmt[n++] = '<';
+	fmt[n++] = '%';
+	for(uint32_t f = 0; f < 5; f++)
+	{
+		// # only where C defines it
+		if(((r >> f) & 1) && ((flagChars[f] != '#') || (conv == 'x') || (conv == 'X') || (conv == 'o')))
+			fmt[n++] = flagChars[f];
+	}
+	if(r & (1 << 5))
+		n += sprintf(&fmt[n], "%u", (unsigned)(XB_Random() % 24));
+	else if(r & (1 << 6))
+	{
+		// a negative width is the - flag
+		fmt[n++] = '*';
+		star = (int)(XB_Random() % 24) - 4;
+		hasStar = 1;
+	}
+	if((r & (1 << 7)) && (conv != 'c'))
+		n += sprintf(&fmt[n], ".%u", (unsigned)(XB_Random() % 12));
+
+	if(conv == 'c')
+	{
+		v = 'A' + (v & 31);
+		n += sprintf(&fmt[n], "%c>", conv);
+		refLen = hasStar ? snprintf(ref, sizeof(ref), fmt, star, (int)v) : snprintf(ref, sizeof(ref), fmt, (int)v);
+		len = hasStar ? XPrintf_Buffer(out, sizeof(out), fmt, star, (int)v) : XPrintf_Buffer(out, sizeof(out), fmt, (int)v);
+		return (refLen != len) || strcmp(ref, out);
+	}
+
+	switch((r >> 8) % 6)
+	{
+	case 0:
+		n += sprintf(&fmt[n], "hh%c>", conv);
+		v = (signed char)v;
+		break;
+	case 1:
+		n += sprintf(&fmt[n], "h%c>", conv);
+		v = (short)v;
+		break;
+	case 2:
+		n += sprintf(&fmt[n], "l%c>", conv);
+		v = (long)v;
+		break;
+	case 3:
+		n += sprintf(&fmt[n], "ll%c>", conv);
+		break;
+	case 4:
+		n += sprintf(&fmt[n], "z%c>", conv);
+		v = (long)(size_t)v;
+		break;
+	default:
+		n += sprintf(&fmt[n], "%c>", conv);
+		v = (int)v;
+		break;
+	}
+
+	// the C library and the engine read the same promoted argument
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat"
+	if((r >> 8) % 6 == 3)
+	{
+		refLen = hasStar ? snprintf(ref, sizeof(ref), fmt, star, v) : snprintf(ref, sizeof(ref), fmt, v);
+		len = hasStar ? XPrintf_Buffer(out, sizeof(out), fmt, star, v) : XPrintf_Buffer(out, sizeof(out), fmt, v);
+	}
+	else if(((r >> 8) % 6 == 2) || ((r >> 8) % 6 == 4))
+	{
+		refLen = hasStar ? snprintf(ref, sizeof(ref), fmt, star, (long)v) : snprintf(ref, sizeof(ref), fmt, (long)v);
+		len = hasStar ? XPrintf_Buffer(out, sizeof(out), fmt, star, (long)v) :
+							XPrintf_Buffer(out, sizeof(out), fmt, (long)v);
+	}
+	else
+	{
+		refLen = hasStar ? snprintf(ref, sizeof(ref), fmt, star, (int)v) : snprintf(ref, sizeof(ref), fmt, (int)v);
+		len = hasStar ? XPrintf_Buffer(out, sizeof(out), fmt, star, (int)v) : XPrintf_Buffer(out, sizeof(out), fmt, (int)v);
+	}
+#pragma GCC diagnostic pop
+
+	if((refLen != len) || strcmp(ref, out))
+	{
+		printf("  %-16s \"%s\" != \"%s\"\n", fmt, out, ref);
+		return 1;
+	}
+	return 0;
+}
+
+static void XB_Format_Check(void)
+{
+	XB_Args_t args;
+	uint32_t bad = 0, fuzzBad = 0;
+	char out[8];
+
+	for(uint32_t n = 0; n < XB_FUZZ; n++)
+		fuzzBad += XB_Fuzz();
+
+	for(uint8_t line = 0; line < XB_NO_OF_LINES; line++)
+	{
+		for(uint32_t n = 0; n < XB_ARGS; n++)
+		{
+			XB_Draw(line, &args);
+			bad += XB_Compare(line, &args);
+		}
+	}
+
+	// strings and the fixed point edges
+	SIM_CHECK(XPrintf_Buffer(out, sizeof(out), "%.3s|%-4s|", "abcdef", "x") == 9);
+	SIM_CHECK(strcmp(out, "abc|x  ") == 0);
+	SIM_CHECK(XPrintf_Buffer(out, sizeof(out), "%s%lu.%03lu", XPRINTF_FIXED(-5L, 1000)) == 6);
+	SIM_CHECK(strcmp(out, "-0.005") == 0);
+	SIM_CHECK(XPrintf_Buffer(out, sizeof(out), "%%%c", 'z') == 2);
+	SIM_CHECK(strcmp(out, "%z") == 0);
+
+	printf("format: %u random conversions, %u differ; %u log lines x %u argument sets, %u differ\n", XB_FUZZ,
+		   fuzzBad, XB_NO_OF_LINES, XB_ARGS, bad);
+	SIM_CHECK(fuzzBad == 0);
+	SIM_CHECK(bad == 0);
+}
+
+static void XB_Bench(uint32_t Calls)
+{
+	static XB_Args_t args[XB_ARGS];
+	char out[XB_BUF];
+	uint64_t t0, ns[2];
+	volatile int sink = 0;
+
+	printf("\n%-6s %6s %12s %12s %7s\n", "line", "chars", "xprintf ns", "libc ns", "ratio");
+	for(uint8_t line = 0; line < XB_NO_OF_LINES; line++)
+	{
+		for(uint32_t n = 0; n < XB_ARGS; n++)
+			XB_Draw(line, &args[n]);
+
+		for(uint8_t engine = 0; engine < 2; engine++)
+		{
+			t0 = XB_Nanos();
+			for(uint32_t n = 0; n < Calls; n++)
+				sink += XB_Line(line, engine, out, sizeof(out), &args[n % XB_ARGS]);
+			ns[engine] = XB_Nanos() - t0;
+		}
+
+		printf("%-6s %6d %12.1f %12.1f %7.2f\n", lineNames[line], XB_Line(line, 1, out, sizeof(out), &args[0]),
+			   (double)ns[1] / Calls, (double)ns[0] / Calls, (double)ns[1] / (double)ns[0]);
+	}
+	(void)sink;
+}
+
+/*
+ * object of an input section line, "libc_nano.a(libc_a-printf.o)" kept as such, paths dropped
+ */
+static XB_Object_t* XB_Object(const char *pPath)
+{
+	const char *pEnd = strchr(pPath, '(');
+	const char *pName = pPath, *p;
+	uint32_t i;
+
+	// the archive member may hold no path, the archive does
+	for(p = pPath; *p && (p != pEnd); p++)
+	{
+		if((*p == '/') || (*p == '\\'))
+			pName = p + 1;
+	}
+
+	for(i = 0; i < noOfObjects; i++)
+	{
+		if(strcmp(objects[i].Name, pName) == 0)
+			return &objects[i];
+	}
+	if(noOfObjects == XB_MAX_OBJECTS)
+		return NULL;
+
+	memset(&objects[i], 0, sizeof(objects[i]));
+	snprintf(objects[i].Name, sizeof(objects[i].Name), "%.*s", (int)sizeof(objects[i].Name) - 1, pName);
+	noOfObjects++;
+	return &objects[i];
+}
+
+static uint8_t XB_IsLibc(const XB_Object_t *pObject)
+{
+	return (strstr(pObject->Name, "libc_nano.a(") != NULL) || (strstr(pObject->Name, "libc.a(") != NULL) ||
+		   (strstr(pObject->Name, "libnosys.a(") != NULL) || (strcmp(pObject->Name, "sysmem.o") == 0);
+}
+
+static int XB_BySize(const void *pA, const void *pB)
+{
+	const XB_Object_t *a = pA, *b = pB;
+
+	return (int)(b->Flash + b->RAM) - (int)(a->Flash + a->RAM);
+}
+
+/*
+ * input sections of the allocated output sections: .data counts for flash (its load image) and RAM,
+ * .bss for RAM. Returns 0 if the file is not a map
+ */
+static uint8_t XB_ReadMap(const char *pPath, unsigned long *pHeap)
+{
+	FILE *f = fopen(pPath, "r");
+	char line[1024], section[64] = "", name[256] = "", path[768];
+	unsigned long addr, size;
+	uint8_t inMap = 0, flash = 0, ram = 0;
+	XB_Object_t *pObject;
+
+	if(f == NULL)
+		return 0;
+
+	noOfObjects = 0;
+	*pHeap = 0;
+	while(fgets(line, sizeof(line), f))
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+		if(strncmp(line, "Linker script and memory map", 28) == 0)
+		{
+			inMap = 1;
+			continue;
+		}
+		if(!inMap)
+			continue;
+
+		if(sscanf(line, " 0x%lx _Min_Heap_Size = 0x%lx", &addr, pHeap) == 2)
+			continue;
+
+		// an output section, its name starts the line
+		if(line[0] == '.')
+		{
+			sscanf(line, "%63s", section);
+			flash = (strcmp(section, ".isr_vector") == 0) || (strncmp(section, ".text", 5) == 0) ||
+					(strncmp(section, ".rodata", 7) == 0) || (strncmp(section, ".ARM", 4) == 0) ||
+					(strstr(section, "_array") != NULL) || (strcmp(section, ".data") == 0);
+			ram = (strcmp(section, ".data") == 0) || (strcmp(section, ".bss") == 0);
+			continue;
+		}
+		if(line[0] != ' ' || (!flash && !ram))
+			continue;
+
+		// an input section, long names put the address on the next line
+		if(line[1] == '.')
+		{
+			if(sscanf(line, " %255s 0x%lx 0x%lx %767[^\n]", name, &addr, &size, path) == 4)
+				name[0] = '\0';
+			else
+				continue;
+		}
+		else if((name[0] != '\0') && (sscanf(line, " 0x%lx 0x%lx %767[^\n]", &addr, &size, path) == 3))
+			name[0] = '\0';
+		else
+			continue;
+
+		if((size == 0) || (addr == 0) || ((pObject = XB_Object(path)) == NULL))
+			continue;
+		if(flash)
+			pObject->Flash += size;
+		if(ram)
+			pObject->RAM += size;
+	}
+	fclose(f);
+	return 1;
+}
+
+static void XB_Size(const char *pPath)
+{
+	unsigned long heap;
+	uint32_t libcFlash = 0, libcRAM = 0, appFlash = 0, appRAM = 0, xFlash = 0, xRAM = 0, other = 0;
+
+	if(!XB_ReadMap(pPath, &heap))
+	{
+		printf("\n%s: can not be read\n", pPath);
+		SIM_CHECK(0);
+		return;
+	}
+
+	qsort(objects, noOfObjects, sizeof(objects[0]), XB_BySize);
+	printf("\n%s\n", pPath);
+	for(uint32_t i = 0; i < noOfObjects; i++)
+	{
+		XB_Object_t *pObject = &objects[i];
+
+		if(XB_IsLibc(pObject))
+		{
+			libcFlash += pObject->Flash;
+			libcRAM += pObject->RAM;
+			if(pObject->Flash + pObject->RAM >= XB_MEMBER_MIN)
+				printf("  %-40s %6u flash %5u RAM\n", pObject->Name, pObject->Flash, pObject->RAM);
+		}
+		else if(strcmp(pObject->Name, "xprintf.o") == 0)
+		{
+			xFlash += pObject->Flash;
+			xRAM += pObject->RAM;
+		}
+		else if(strncmp(pObject->Name, "crt", 3) == 0 || strstr(pObject->Name, "libgcc") != NULL)
+			other += pObject->Flash;
+		else
+		{
+			appFlash += pObject->Flash;
+			appRAM += pObject->RAM;
+		}
+	}
+
+	printf("  %-40s %6u flash %5u RAM\n", "C library and _sbrk (sysmem.o)", libcFlash, libcRAM);
+	printf("  %-40s %6u flash %5u RAM\n", "xprintf.o", xFlash, xRAM);
+	printf("  %-40s %6u flash %5u RAM\n", "application", appFlash, appRAM);
+	printf("  %-40s %6u flash\n", "crt, libgcc", other);
+	printf("  %-40s %6lu RAM\n", "heap reserved (_Min_Heap_Size)", heap);
+	SIM_CHECK(libcFlash + appFlash != 0);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : XB_CALLS;
+
+	Sim_Init();
+	if(calls == 0)
+		calls = XB_CALLS;
+
+	XB_Format_Check();
+	XB_Bench(calls);
+
+	if(argc > 2)
+	{
+		for(int i = 2; i < argc; i++)
+			XB_Size(argv[i]);
+	}
+	else
+		XB_Size(XB_DEFAULT_MAP);
+
+	return Sim_Report("xprintf");
+}